@@ -22,15 +22,16 @@
 /* Main - your program starts with a call to MainLoop() and all 
  *        global objects should be owned by this class
  * 
- *        WARNING: Do NOT declare class variables on the heap (ie outside of a class)! 
- *        The constructor will NOT be run when the object is created and member variables
- *        will NOT be initialized.
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
  * 
  *        Instantiate all classes inside some other class. If a class is instantiated
- *        at runtime (as opposed to compile time) then the constructor will run.
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
  * 
- *        You might wish to review the "03_Danger" sample code to see the bad 
- *        things that happen if you create classes with constructors on the heap.
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
  *       
  * */
 class Main // you can inherit from other classes if you wish. See the 02_BetterBlinky example
@@ -17,8 +17,8 @@
 #ifndef LEDADDRESS_H
 #define LEDADDRESS_H
 
-/* LEDAddress - a simple contrived class we used to demonstrate the dangers of 
- *        instantiating a class variable on the heap. 
+/* LEDAddress - a simple contrived class we used to demonstrate what happens when
+ *        you instantiate a class variable on the heap. 
  * 
  *        Other than the above, this class has no real use.
  *       
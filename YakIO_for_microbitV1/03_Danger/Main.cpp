@@ -18,9 +18,24 @@
 #include "YakIO_LEDARRAY.h"
 
 // EXAMPLE code to instantiate an example class on the heap, on the 
-// stack and as a member variable in order to demonstrate unequivocally
-// that if you instantiate a class on the heap, the constructor does not 
-// run and member variables are not initialized.
+// stack and as a member variable in order to demonstrate that the 
+// constructor runs in all three cases.
+//
+// This example used to be all about the opposite. Earlier versions of 
+// the YakIO startup code did not run the constructors of classes 
+// instantiated on the heap (global objects) so they were left with 
+// whatever was in the RAM. The startup code now runs them - see the 
+// RunStaticConstructors() function in YakIO.cpp - but there are still
+// two dangers to be aware of:
+//
+//    1) C++ does not define the order in which global objects in 
+//       different .cpp files are created. If the constructor of one 
+//       uses another, the other might not have been created yet.
+//    2) They are all created before CreateMainObject() is called, long
+//       before the Main object or anything in it exists.
+//
+// Creating your objects as member variables of the Main class avoids 
+// both problems.
 
 // A pattern for the LED arrays. See 02_BetterBlinky for a full discussion
 // Variables such as this on the heap do get initialized
@@ -33,6 +48,7 @@ unsigned char allLEDs[] =
 
 // instantiate a class on the heap to illustrate the execution of the 
 // constructor. Note it is set to (row=3,col=3), the default value is (row=1,col=1)
+// The constructor is run by the startup code before CreateMainObject() is called
 LEDAddress laObjectOnHeap{3,3};
 
 /* MainLoop. This is where the user program starts. This function should
@@ -95,8 +111,8 @@ void Main::MainLoop(void)
     {
         // because the addresses (row, col) of LEDS we activate were 
         // activated from the values stored in instantiated classes, we  
-        // would expect to see the LED array in the state as shown 
-        // below where LEDS (2,2) and (3,3) and (4,4) are lit up.
+        // see the LED array in the state as shown below where LEDS (2,2) 
+        // and (3,3) and (4,4) are lit up.
         
 //      0,0,0,0,0,
 //      0,1,0,0,0,
@@ -104,7 +120,12 @@ void Main::MainLoop(void)
 //      0,0,0,1,0,
 //      0,0,0,0,0, 
 
-        // instead we see the following...
+        // LED (3,3) comes from the object that was created on the heap.
+        // Its constructor was run by the startup code before the Main 
+        // object was even created.
+
+        // Earlier versions of YakIO did not run that constructor and you 
+        // would have seen the following instead...
  
 //      0,0,0,0,0,
 //      0,1,0,0,0,
@@ -112,37 +133,12 @@ void Main::MainLoop(void)
 //      0,0,0,1,0,
 //      0,0,0,0,0, 
  
-        // note that LED (3,3) is not activated. These are the values used
-        // in the object that was created on the heap. 
-        
-        // The constructor DOES NOT run!!!
-        
-        // Actually, it is even worse. The default values are (1,1) so the 
-        // initialization of the member variables inside of the LEDAddress  
-        // class did not even work. If it had, we would see something like
-        
-//      1,0,0,0,0,
-//      0,1,0,0,0,
-//      0,0,0,0,0,
-//      0,0,0,1,0,
-//      0,0,0,0,0, 
-        
-        // with LED (1,1) lit up as shown. But we do not - this means the 
-        // member varibles did not even properly initialize either
-        
-        // WARNING!
-        // WARNING!
-        // WARNING!
-
-        // YOU MUST NOT INSTANTIATE CLASSES ON THE HEAP USING THE YAKIO LIBRARY!
-        
-        // If you do, the constructor will NOT run and your member variables will 
-        // not be initialized. Declaring them as member variables in a class 
-        // or in a member function is OK. Everything works as expected.
+        // ... with not even the default (1,1) values set since the member
+        // variable initializers are also part of the constructor.
         
-        // NOTE this does not seem to apply to non-class variables declared on the 
-        // heap. As can be seen above, the allLEDs[] array initialized just fine.
-        // Only classes are the problem.
+        // NOTE non-class variables declared on the heap, such as the allLEDs[]
+        // array above, have always worked. Their values are simply copied 
+        // from the FLASH into the RAM by the startup code.
         
  
     } // bottom of while(1)
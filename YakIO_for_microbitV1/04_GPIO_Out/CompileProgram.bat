@@ -61,7 +61,7 @@ set YAKIO_OBJECT_DIR=..\YakIO\Objects
 
 REM These are the compile and link flags. They have been carefully selected (admittedly, mostly
 REM by trial and error) and they all seem to be necessary
-set YAKIO_COMPILE_FLAGS= -O -g -mcpu=cortex-m0 -std=c++11 -mthumb -Wall --specs=nosys.specs -fno-exceptions -fno-rtti
+set YAKIO_COMPILE_FLAGS= -O -g -mcpu=cortex-m0 -std=c++20 -fcoroutines -mthumb -Wall --specs=nosys.specs -fno-exceptions -fno-rtti -fno-tree-loop-distribute-patterns
 set YAKIO_LINK_FLAGS= -mcpu=cortex-m0 -mthumb -O -g -Wall -ffreestanding -fno-builtin -nostdlib
 
 REM make sure our directories exist
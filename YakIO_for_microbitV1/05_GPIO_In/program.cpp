@@ -34,15 +34,14 @@
 // You can see this being done below. The Main class is defined in the users Main.h file and the code for the MainLoop() member 
 // function is defined in the users Main.cpp file. The Main class is instantiated and the MainLoop function is called.
 
-// WARNING!!!
-// WARNING!!!
-// WARNING!!!
+// A NOTE ON GLOBAL OBJECTS!!!
 
-// Whatever you do, do NOT instantiate a class on the heap if that class has a constructor - even a default one. Constructors will
-// NOT be run under those circumstances. Instantiating a class, in another class, at runtime as part of code execution is perfectly OK, 
-// the constructors will be run as expected. 
+// Classes instantiated on the heap (i.e. outside of any class or function) do have their constructors run. The YakIO startup code 
+// runs them before it calls CreateMainObject(). However, C++ does not say in which order objects in different .cpp files are created
+// and they are all created before any of your code has run. Instantiating a class, in another class, at runtime as part of code 
+// execution is much more predictable - the constructors run in the order the objects are declared. Do that if you can.
 //
-// Review the "03_Danger" sample code to see the bad things that happen if you create classes with constructors on the heap.
+// Review the "03_Danger" sample code to see what happens when you create classes with constructors on the heap.
 
 
 
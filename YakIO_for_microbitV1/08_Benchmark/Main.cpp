@@ -0,0 +1,327 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to measure how long things take. TIMER0 is set up as a free
+// running counter which counts every single cycle of the 16MHz CPU clock. We 
+// read it before and after running an operation many times and the difference, 
+// divided by the number of times we ran it, is the cost of the operation in 
+// CPU cycles.
+
+// The first benchmarks compare two ways of reading and writing a three word 
+// structure that an interrupt handler (the Heartbeat) is also updating:
+//
+//    1) a YakIO_SEQLOCK - the interrupt is never disabled. The reader just
+//       tries again if its copy was torn. See YakIO_SEQLOCK.h
+//    2) a critical section - the interrupts are disabled with PRIMASK 
+//       while the copy is made. See the notes in YakIO_Utils.h
+//
+// The next benchmarks compare the YakIO memcpy() and memset() (see 
+// YakIO_MEMORY.h) with plain byte at a time loops. The unaligned memcpy()
+// has to fall back to a byte at a time so it should cost about the same 
+// as the byte loop.
+//
+// The results are shown on the 5x5 LED array. The top row shows the 
+// BENCHMARK_ID (see Main.h) of the result being displayed as a binary number
+// (leftmost LED is the most significant bit). The bottom four rows show the 
+// result itself as a 20 bit binary number reading left to right, top to
+// bottom. Press ButtonA to step to the next result.
+//
+// The results are also left in the benchmarkResults[] array so you can read
+// them with a debugger if you have one.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    // clear the results down
+    for(int i=0; i<BENCH_NUM_RESULTS; i++) benchmarkResults[i]=0;
+
+    // Set our heartbeat going, the display is refreshed from here and 
+    // it also keeps changing the shared data we read in the benchmarks
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // start our stopwatch
+    StartCycleCounter();
+
+    // #
+    // # Run the benchmarks
+    // #
+
+    benchmarkResults[BENCH_LOOP_OVERHEAD] = MeasureLoopOverhead();
+    RunSeqLockBenchmarks();
+    RunCriticalBenchmarks();
+    RunMemoryBenchmarks();
+
+    // the startup code times itself. See the BOOT TIME notes in YakIO.cpp
+    benchmarkResults[BENCH_BOOT_CYCLES] = GetBootCycles();
+
+    // show the first result
+    ShowResult(displayedResult);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        // all we do now is step through the results each 
+        // time ButtonA is pressed and released
+        if (buttonAHasBeenPressed!=0)
+        {
+            displayedResult++;
+            if(displayedResult>=BENCH_NUM_RESULTS) displayedResult=0;
+            ShowResult(displayedResult);
+            // we must reset this
+            buttonAHasBeenPressed=0;
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* StartCycleCounter - sets up TIMER0 as a free running 32 bit counter
+ *    which counts at the full 16MHz. No interrupts are used, we just
+ *    read the count when we need it.
+ *
+ *    At 16MHz a 32 bit counter wraps about every 268 seconds. Since we 
+ *    subtract unsigned values the wrap does not matter as long as the 
+ *    thing being timed takes less than that.
+ * */
+void Main::StartCycleCounter(void)
+{
+    cycleCounterObj.TimerStop();
+    cycleCounterObj.SetMode(TIMER_MODE_Timer);
+    cycleCounterObj.SetBitMode(TIMER_BITMODE_32Bit);
+    // a prescaler of 0 means 16MHz/(2^0) - every clock cycle is counted
+    cycleCounterObj.SetPrescaler(0);
+    cycleCounterObj.TimerClear();
+    cycleCounterObj.TimerStart();
+}
+
+/* MeasureLoopOverhead - measures the total cost of a timing loop that 
+ *    does nothing. This is subtracted from the other results so we only
+ *    see the cost of the thing being measured.
+ *
+ * returns:
+ *    the total cycles consumed by BENCHMARK_ITERATIONS empty loops
+ * */
+unsigned int Main::MeasureLoopOverhead(void)
+{
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        // stops the compiler throwing the loop away
+        COMPILER_BARRIER();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    return endCount-startCount;
+}
+
+/* RunSeqLockBenchmarks - measures reading and writing the shared data 
+ *    via a YakIO_SEQLOCK
+ * */
+void Main::RunSeqLockBenchmarks(void)
+{
+    LedRowWords rowCopy;
+    unsigned int retryCount = 0;
+
+    // the read. This is exactly what YakIO_SEQLOCK::Read() does except
+    // we count the retries as we go
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        while(seqLockedRows.TryRead(rowCopy)==0) retryCount++;
+        benchmarkSink = rowCopy.row[0];
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_SEQLOCK_READ] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+    benchmarkResults[BENCH_SEQLOCK_RETRIES] = retryCount;
+
+    // the write. We must not write to seqLockedRows from here. The Heartbeat 
+    // is already writing it and a seqlock can only have one writer. So we 
+    // use a private one. It costs exactly the same.
+    YakIO_SEQLOCK<LedRowWords> scratchLock {};
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        rowCopy.row[0] = i;
+        scratchLock.Write(rowCopy);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_SEQLOCK_WRITE] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+    benchmarkSink = scratchLock.GetSequence();
+}
+
+/* RunCriticalBenchmarks - measures reading and writing the shared data 
+ *    with the interrupts disabled via PRIMASK
+ * */
+void Main::RunCriticalBenchmarks(void)
+{
+    LedRowWords rowCopy;
+
+    // the read
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        unsigned int primaskState = EnterCritical();
+        rowCopy = criticalRows;
+        ExitCritical(primaskState);
+        benchmarkSink = rowCopy.row[0];
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_CRITICAL_READ] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+
+    // the write. Unlike the seqlock, it is fine to have more than one
+    // writer here. The Heartbeat cannot interrupt us while PRIMASK is set
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        rowCopy.row[0] = i;
+        unsigned int primaskState = EnterCritical();
+        criticalRows = rowCopy;
+        ExitCritical(primaskState);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_CRITICAL_WRITE] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+    benchmarkSink = criticalRows.row[0];
+}
+
+/* ShowResult - shows a result on the 5x5 LED array. The top row is the 
+ *    resultID, the bottom 4 rows are the value. Both are in binary with 
+ *    the most significant bit first.
+ *
+ * inputs:
+ *    resultID - the result to show
+ * */
+void Main::ShowResult(unsigned int resultID)
+{
+    unsigned char ledImage[NUM_LEDS_IN_ARRAY];
+    unsigned int resultValue = benchmarkResults[resultID];
+
+    // if it will not fit in 20 bits, just light them all
+    if(resultValue > 0xFFFFF) resultValue = 0xFFFFF;
+
+    // the top row, 5 bits of resultID
+    for(int i=0; i<5; i++) ledImage[i] = (resultID >> (4-i)) & 0x01;
+    // the other 4 rows, 20 bits of the value
+    for(int i=0; i<20; i++) ledImage[5+i] = (resultValue >> (19-i)) & 0x01;
+
+    ledArray.SetBinaryImage(ledImage);
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    // publish new values to both copies of the shared data. The MainLoop()
+    // cannot interrupt us so we can write criticalRows directly
+    heartbeatCount++;
+    LedRowWords newRows;
+    for(int i=0; i<NUM_GPIOROWS_IN_LED_IMAGE; i++) newRows.row[i] = heartbeatCount;
+    seqLockedRows.Write(newRows);
+    criticalRows = newRows;
+
+    // debounce ButtonA. See the 06_deBounce example for a full discussion
+    if(gpioButtonA.GetGPIOState() == 0)
+    {
+        // button pressed, count this
+        buttonACounter++;
+    }
+    else
+    {
+        // button not pressed, but were we pressed long enough and now let up?
+        if(buttonACounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS) buttonAHasBeenPressed=1;
+        buttonACounter=0;
+    }
+}
+
+/* RunMemoryBenchmarks - measures memcpy() and memset() against plain byte
+ *    at a time loops
+ * */
+void Main::RunMemoryBenchmarks(void)
+{
+    unsigned char *srcPtr = (unsigned char *)memorySource;
+    unsigned char *destPtr = (unsigned char *)memoryDest;
+    for(unsigned int i=0; i<MEMORY_BENCH_BYTES; i++) srcPtr[i] = (unsigned char)i;
+
+    // a byte at a time copy. The -fno-tree-loop-distribute-patterns compile 
+    // flag stops the compiler turning this into a call to memcpy()
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        for(unsigned int j=0; j<MEMORY_BENCH_BYTES; j++) destPtr[j] = srcPtr[j];
+        COMPILER_BARRIER();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_BYTELOOP_COPY] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        memcpy(destPtr, srcPtr, MEMORY_BENCH_BYTES);
+        COMPILER_BARRIER();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_MEMCPY_ALIGNED] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+
+    // one byte in on the source and two on the destination. These can 
+    // never both be word aligned at the same time
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        memcpy(destPtr+2, srcPtr+1, MEMORY_BENCH_BYTES);
+        COMPILER_BARRIER();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_MEMCPY_UNALIGNED] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        for(unsigned int j=0; j<MEMORY_BENCH_BYTES; j++) destPtr[j] = 0;
+        COMPILER_BARRIER();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_BYTELOOP_CLEAR] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        memset(destPtr, 0, MEMORY_BENCH_BYTES);
+        COMPILER_BARRIER();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_MEMSET] = ((endCount-startCount)-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+
+    benchmarkSink = memoryDest[0];
+}
@@ -0,0 +1,139 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_SEQLOCK.h"
+#include "YakIO_MEMORY.h"
+
+// the number of times we repeat each benchmarked operation. This is
+// a power of two so we can divide by it with a shift (the Cortex-M0
+// has no divide instruction)
+#define BENCHMARK_ITERATIONS_SHL 10
+#define BENCHMARK_ITERATIONS (1<<BENCHMARK_ITERATIONS_SHL)
+
+// the size of the buffers used in the memcpy() and memset() benchmarks
+#define MEMORY_BENCH_BYTES 256
+
+// the debouncing of ButtonA is done out of the Heartbeat. See the 
+// 06_deBounce example for how this works
+#define MIN_HEARTBEATS_FOR_A_BUTTONPRESS 10
+
+// Each benchmark stores its result in the benchmarkResults[] array at 
+// the position given by its ID. The ID is also what gets shown on the top 
+// row of the LED array so you know which result you are looking at
+enum BENCHMARK_ID {
+    BENCH_LOOP_OVERHEAD=0,     // the cost of the empty timing loop itself (total cycles)
+    BENCH_SEQLOCK_READ,        // YakIO_SEQLOCK::Read() of 3 words (cycles per call)
+    BENCH_CRITICAL_READ,       // EnterCritical()/copy/ExitCritical() of 3 words (cycles per call)
+    BENCH_SEQLOCK_WRITE,       // YakIO_SEQLOCK::Write() of 3 words (cycles per call)
+    BENCH_CRITICAL_WRITE,      // EnterCritical()/copy/ExitCritical() of 3 words (cycles per call)
+    BENCH_SEQLOCK_RETRIES,     // Read() calls that had to retry during BENCH_SEQLOCK_READ (count)
+    BENCH_BOOT_CYCLES,         // the time the startup code took, see GetBootCycles() (total cycles)
+    BENCH_BYTELOOP_COPY,       // a byte at a time copy of MEMORY_BENCH_BYTES (cycles per call)
+    BENCH_MEMCPY_ALIGNED,      // memcpy() of MEMORY_BENCH_BYTES, both word aligned (cycles per call)
+    BENCH_MEMCPY_UNALIGNED,    // memcpy() of MEMORY_BENCH_BYTES, never both aligned (cycles per call)
+    BENCH_BYTELOOP_CLEAR,      // a byte at a time clear of MEMORY_BENCH_BYTES (cycles per call)
+    BENCH_MEMSET,              // memset() of MEMORY_BENCH_BYTES (cycles per call)
+    BENCH_NUM_RESULTS          // not a benchmark, just the number of them
+};
+
+// the thing we are protecting. This is the same size as the three row
+// words the YakIO_LEDARRAY class builds for the LED display
+struct LedRowWords 
+{
+    unsigned int row[NUM_GPIOROWS_IN_LED_IMAGE];
+};
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+
+        // ButtonA steps through the results
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        unsigned buttonAHasBeenPressed = 0; // this latches until reset 
+        unsigned buttonACounter = 0;        // for debouncing
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // TIMER0 is our stopwatch. It is set to count every cycle of the 
+        // 16MHz clock and never triggers an interrupt. We just read it
+        YakIO_TIMER cycleCounterObj {Timer0};
+
+        // the shared data. The Heartbeat writes both of these every tick
+        // and the MainLoop() reads them. One is protected by a seqlock
+        // the other by disabling interrupts
+        YakIO_SEQLOCK<LedRowWords> seqLockedRows {};
+        LedRowWords criticalRows {};
+        // the Heartbeat changes this every tick so the data keeps changing
+        unsigned int heartbeatCount = 0;
+
+        // the memcpy() and memset() benchmarks copy between these. They are
+        // unsigned int so they are word aligned. The extra word is so we can
+        // start a few bytes in for the unaligned test
+        unsigned int memorySource[(MEMORY_BENCH_BYTES/4)+1];
+        unsigned int memoryDest[(MEMORY_BENCH_BYTES/4)+1];
+
+        // the results
+        unsigned int benchmarkResults[BENCH_NUM_RESULTS];
+        // results of the benchmarked operations are written here so 
+        // the compiler cannot decide they are unused and throw them away
+        volatile unsigned int benchmarkSink = 0;
+        // the result currently on the display
+        unsigned int displayedResult = 0;
+
+        void StartCycleCounter(void);
+        unsigned int MeasureLoopOverhead(void);
+        void RunSeqLockBenchmarks(void);
+        void RunCriticalBenchmarks(void);
+        void RunMemoryBenchmarks(void);
+        void ShowResult(unsigned int resultID);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+
+};
+
+#endif
@@ -0,0 +1,144 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the YakIO_EVENTLOOP. This does much the same 
+// thing as the 06_deBounce example - button presses light up successive 
+// LEDs on the 5x5 array - but the structure is quite different.
+
+// In 06_deBounce the Heartbeat sets flags and the MainLoop() spins around
+// checking them as fast as it can. Here the Heartbeat posts an event when 
+// it sees a debounced button release and the MainLoop() just hands over to
+// the event loop, which calls EventCallback() for each event and puts the
+// CPU to sleep when there is nothing to do.
+
+// ButtonA adds one to the count. ButtonB clears the count. ButtonB events 
+// are registered with a higher priority than ButtonA events so if both 
+// are waiting in the queue at the same time ButtonB is handled first.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{
+    // #
+    // # We do setup now
+    // #
+
+    // set up the LEDs
+    ledArray.ClearImage();
+    ClearCountMap();
+
+    // tell the event loop who handles what. We handle both events 
+    // ourselves but they could just as easily go to different objects 
+    eventLoop.RegisterHandler(EVENT_BUTTONA_RELEASED, EVENT_PRIORITY_NORMAL, this);
+    eventLoop.RegisterHandler(EVENT_BUTTONB_RELEASED, EVENT_PRIORITY_HIGH, this);
+
+    // set our Heartbeat going. We do this after registering the handlers
+    // because the Heartbeat may start posting events immediately
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # Hand over to the event loop
+    // #
+
+    // this never returns. It is our while(1) loop now. All the work 
+    // from here on is done in EventCallback()
+    eventLoop.Run();
+
+} // bottom of Main::MainLoop()
+
+/* EventCallback - this is called by the event loop each time it takes
+ *    an event out of its queue. 
+ *
+ *    Unlike the Heartbeat, this is NOT an interrupt. It is called from 
+ *    eventLoop.Run() in the MainLoop(). You can take your time in here 
+ *    (within reason - other events are waiting while you do)
+ *
+ * inputs:
+ *    eventType - the event, one of the APP_EVENT values
+ *    eventData - whatever the poster sent with it. Here it is the number 
+ *        of heartbeats the button was held down for
+ * */
+void Main::EventCallback(unsigned int eventType, unsigned int eventData)
+{
+    if(eventType==EVENT_BUTTONA_RELEASED) AddOneToCountMap();
+    else if(eventType==EVENT_BUTTONB_RELEASED) ClearCountMap();
+
+    // always show the image
+    ledArray.SetBinaryImage(countMap);
+}
+
+/* AddOneToCountMap - lights the next LED in our graphical count. If they 
+ *    are all lit already, clears them all
+ * */
+void Main::AddOneToCountMap(void)
+{
+    // run through each LED
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++)
+    {
+        // found one we have not updated yet?
+        if(countMap[i]==0)
+        {
+            // yes, leave now
+            countMap[i]=1;
+            return;
+        }
+    }
+    // we have filled the graphical display, just reset
+    ClearCountMap();
+}
+
+/* ClearCountMap - clears down our graphical map of the counts we have
+ *    received
+ * */
+void Main::ClearCountMap(void)
+{
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++) countMap[i]=0;
+}
+
+/* Heartbeat - this is the Heartbeat callback function
+ *
+ *    See the 02_BetterBlinky sample code for a full explanation of
+ *    how this works.
+ *
+ *    NOTE: You are in an INTERRUPT in here! Be Quick! Posting an event
+ *    is quick - it just copies two words into a queue.
+ *
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();
+
+    // debounce both buttons. See the 06_deBounce example for a full
+    // discussion of how this works. The difference is that on a good
+    // release we post an event rather than set a flag.
+    if(gpioButtonA.GetGPIOState() == 0) buttonACounter++;
+    else
+    {
+        if(buttonACounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS) eventLoop.PostEvent(EVENT_BUTTONA_RELEASED, buttonACounter);
+        buttonACounter=0;
+    }
+
+    if(gpioButtonB.GetGPIOState() == 0) buttonBCounter++;
+    else
+    {
+        if(buttonBCounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS) eventLoop.PostEvent(EVENT_BUTTONB_RELEASED, buttonBCounter);
+        buttonBCounter=0;
+    }
+}
@@ -0,0 +1,164 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the YakIO_KERNEL. This does much the same 
+// thing as the 07_Random example - every two seconds a random number 
+// is shown on the LED array as a bar of lit LEDs - but it is done with 
+// two threads.
+
+// The first thread (Callback1()) starts the random number generator and 
+// then waits on a semaphore. It uses no CPU at all while it waits. The 
+// RNG interrupt (Callback0()) reads the value and gives the semaphore 
+// which wakes the thread up. Compare this with 07_Random where 
+// GetRngValue() spins in a loop until the value is ready.
+
+// The second thread (Callback2()) just flashes the bottom right LED 
+// on and off. It does not know or care about the first thread. It has 
+// a lower priority so if both are ready at once the RNG thread runs 
+// first.
+
+// Notice that both threads call kernelObj.Sleep() rather than the
+// DELAY_MILLI_SEC() macro. DELAY_MILLI_SEC() spins, using all the CPU, 
+// so nothing of lower priority could run. Sleep() hands the CPU over
+// to another thread - or puts it to sleep if there is nothing to do.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++) ledValues[i]=0;
+    ledArray.ClearImage();
+
+    // Set our heartbeat going, the display is refreshed from here.
+    // See the 02_BetterBlinky example for detailed comments.    
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // the RNG will call Callback0() each time it has a value. We
+    // do not start it here. The RNG thread does that when it wants
+    // a number
+    rngObj.SetCallback(CALLBACK_0, this);
+
+    // create our threads. They do not run until we call Start()
+    kernelObj.CreateThread(RNG_THREAD_PRIORITY, rngThreadStack, RNG_THREAD_STACK_WORDS, CALLBACK_1, this);
+    kernelObj.CreateThread(BLINK_THREAD_PRIORITY, blinkThreadStack, BLINK_THREAD_STACK_WORDS, CALLBACK_2, this);
+
+    // #
+    // # Hand over to the threads
+    // #
+
+    // this never returns. The MainLoop() is finished and the threads
+    // take over. All the work from here on is done in Callback1() and 
+    // Callback2()
+    kernelObj.Start();
+
+} // bottom of Main::MainLoop()
+
+/* Callback1 - this is the RNG thread. It was created with CALLBACK_1 
+ *    so it MUST be named Callback1().
+ *
+ *    This is NOT an interrupt. It is a thread with its own stack and 
+ *    it can take as long as it likes - the kernel will make sure higher
+ *    priority threads and all the interrupts still get their turn.
+ *
+ *    Like the MainLoop() a thread function usually never returns. If it
+ *    does the kernel just deletes the thread.
+ * */
+void Main::Callback1(void)
+{
+    while(1)
+    {
+        // ask for a random number and wait for it. The CPU does 
+        // other things (or sleeps) until Callback0() gives the 
+        // semaphore
+        rngObj.RngStart();
+        rngReadySemaphore.Take(KERNEL_WAIT_FOREVER);
+
+        // the value is always in the range 0-255, dividing by 10 gives
+        // an approximate range of 0-25 which is the number of LEDs we have.
+        // The last LED belongs to the blink thread so we leave it alone
+        unsigned int loopCount = rngVal/10;
+        for(int i=0; i<BLINK_LED_INDEX; i++)
+        {
+            if(loopCount>0) 
+            {
+                ledValues[i]=1;
+                loopCount=loopCount-1;
+            }
+            else ledValues[i]=0;
+        }
+        ledArray.SetBinaryImage(ledValues);
+
+        // wait 2 seconds. This does NOT spin - the blink thread runs
+        kernelObj.Sleep(2000);
+    }
+}
+
+/* Callback2 - this is the blink thread. It was created with CALLBACK_2 
+ *    so it MUST be named Callback2().
+ *
+ * */
+void Main::Callback2(void)
+{
+    while(1)
+    {
+        ledValues[BLINK_LED_INDEX] = (ledValues[BLINK_LED_INDEX]==0) ? 1 : 0;
+        ledArray.SetBinaryImage(ledValues);
+        kernelObj.Sleep(500);
+    }
+}
+
+/* Callback0 - this is a callback function which gets called when the 
+ *    random number generator triggers. We used enum CALLBACK_ID.CALLBACK_0 
+ *    when we set the callback, therefore, this function MUST be named Callback0(). 
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Be Quick! Giving a 
+ *    semaphore is quick and it is safe to do it in here. You must 
+ *    never Take() one with a timeout in an interrupt.
+ *
+ * */
+void Main::Callback0(void)
+{
+    // a value is ready so this will not spin
+    rngVal = rngObj.GetRngValue();
+    // we only wanted one
+    rngObj.RngStop();
+    // wake up the RNG thread. If it has a higher priority than 
+    // whatever thread was running when this interrupt happened it 
+    // runs as soon as we return
+    rngReadySemaphore.Give();
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+}
@@ -0,0 +1,100 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_RNG.h"
+#include "YakIO_KERNEL.h"
+#include "YakIO_SEMAPHORE.h"
+
+// the stack sizes of our threads in 32 bit words. These are generous,
+// neither thread function calls anything very deep
+#define RNG_THREAD_STACK_WORDS 96
+#define BLINK_THREAD_STACK_WORDS 64
+
+// the thread priorities. Bigger is more important
+#define RNG_THREAD_PRIORITY 2
+#define BLINK_THREAD_PRIORITY 1
+
+// the LED the blink thread flashes. The bottom right corner.
+#define BLINK_LED_INDEX (NUM_LEDS_IN_ARRAY-1)
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+    
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // the kernel. It takes TIMER1 for its own tick. Do not use 
+        // TIMER1 for anything else in this program
+        YakIO_KERNEL kernelObj {Timer1};
+
+        // the random number generator
+        YakIO_RNG rngObj {};
+
+        // the RNG interrupt gives this when it has a new value. 
+        // It starts at 0 (nothing ready) and can never go above 1.
+        YakIO_SEMAPHORE rngReadySemaphore {0, 1};
+        volatile unsigned int rngVal = 0;
+
+        // the stacks of our threads
+        unsigned int rngThreadStack[RNG_THREAD_STACK_WORDS];
+        unsigned int blinkThreadStack[BLINK_THREAD_STACK_WORDS];
+
+        // the image on the display. Both threads write to it
+        unsigned char ledValues[NUM_LEDS_IN_ARRAY];
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+        // the RNG interrupt calls this
+        void Callback0(void) override;
+        // the RNG display thread
+        void Callback1(void) override;
+        // the blink thread
+        void Callback2(void) override;
+
+};
+
+#endif
@@ -0,0 +1,186 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate YakIO_TASK coroutines. There are three 
+// tasks, each written as a simple loop from top to bottom, and they all 
+// run at the same time without any threads, flags or state variables.
+
+//  BlinkTask()     - flashes the bottom right LED twice a second
+//  RandomBarTask() - waits for ButtonA, gets a random number and shows it 
+//                    as a bar of lit LEDs (like 07_Random)
+//  StatsTask()     - waits for ButtonB and shows the size, in bytes, of 
+//                    the largest task frame on the display for 3 seconds.
+//                    This is the RAM cost of a task. Compare it with the 
+//                    stacks each thread needs in 10_Threads.
+
+// Every "co_await" is a point where the task stops and lets the others
+// run. Look at RandomBarTask() and imagine writing it with callbacks.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++) ledValues[i]=0;
+    ledArray.ClearImage();
+
+    // Set our heartbeat going, the display is refreshed from here.
+    // See the 02_BetterBlinky example for detailed comments.    
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // the echo task sends back whatever is typed on the serial port
+    uart.Start(UART_BAUDRATE_115200);
+
+    // the scheduler registers itself with the event loop and starts 
+    // its tick. Nothing else in this program posts events so the
+    // priority does not really matter
+    taskScheduler.Start(EVENT_PRIORITY_HIGH);
+
+    // calling a task function does not run it. It just creates it. 
+    // Spawn() starts it running - but not until the event loop runs
+    taskScheduler.Spawn(BlinkTask());
+    taskScheduler.Spawn(RandomBarTask());
+    taskScheduler.Spawn(StatsTask());
+    taskScheduler.Spawn(EchoTask());
+
+    // #
+    // # Hand over to the event loop
+    // #
+
+    // this never returns. All the work from here on is done in the tasks
+    eventLoop.Run();
+
+} // bottom of Main::MainLoop()
+
+/* BlinkTask - flashes the bottom right LED. 
+ *
+ *    This is a coroutine. It is NOT an interrupt and it is NOT a thread.
+ *    It runs from the event loop until it reaches a co_await and then it
+ *    stops until the thing it is waiting for happens.
+ * */
+YakIO_TASK Main::BlinkTask(void)
+{
+    while(1)
+    {
+        ledValues[BLINK_LED_INDEX] = (ledValues[BLINK_LED_INDEX]==0) ? 1 : 0;
+        if(showingStats==0) ledArray.SetBinaryImage(ledValues);
+        co_await taskScheduler.Delay(500);
+    }
+}
+
+/* RandomBarTask - shows a random bar each time ButtonA is pressed
+ * */
+YakIO_TASK Main::RandomBarTask(void)
+{
+    while(1)
+    {
+        // wait for the button to go down and make sure it stays 
+        // down. See 06_deBounce for why this is needed
+        co_await taskScheduler.WaitForEdge(&gpioButtonA, TASK_EDGE_FALLING);
+        co_await taskScheduler.Delay(BUTTON_DEBOUNCE_TICKS);
+        if(gpioButtonA.GetGPIOState()!=0) continue;
+
+        // get a random number. The RNG interrupt wakes us up
+        unsigned int rngVal = co_await taskScheduler.GetRandom(&rngObj);
+
+        // the value is always in the range 0-255, dividing by 10 gives
+        // an approximate range of 0-25 which is the number of LEDs we have.
+        // The last LED belongs to the blink task so we leave it alone
+        unsigned int loopCount = rngVal/10;
+        for(int i=0; i<BLINK_LED_INDEX; i++)
+        {
+            if(loopCount>0) 
+            {
+                ledValues[i]=1;
+                loopCount=loopCount-1;
+            }
+            else ledValues[i]=0;
+        }
+        if(showingStats==0) ledArray.SetBinaryImage(ledValues);
+    }
+}
+
+/* StatsTask - shows the largest task frame size each time ButtonB is 
+ *    pressed
+ * */
+YakIO_TASK Main::StatsTask(void)
+{
+    while(1)
+    {
+        co_await taskScheduler.WaitForEdge(&gpioButtonB, TASK_EDGE_FALLING);
+        co_await taskScheduler.Delay(BUTTON_DEBOUNCE_TICKS);
+        if(gpioButtonB.GetGPIOState()!=0) continue;
+
+        showingStats = 1;
+        ShowNumber(taskScheduler.GetLargestFrameBytes());
+        co_await taskScheduler.Delay(STATS_DISPLAY_TICKS);
+        showingStats = 0;
+        ledArray.SetBinaryImage(ledValues);
+    }
+}
+
+/* EchoTask - sends back every byte typed on the serial port. A carriage
+ *    return also gets a line feed so the terminal starts a new line
+ * */
+YakIO_TASK Main::EchoTask(void)
+{
+    while(1)
+    {
+        // the UART receive interrupt wakes us up
+        unsigned int byteValue = co_await taskScheduler.ReadByte(&uart);
+        uart.WriteByte((unsigned char)byteValue);
+        if(byteValue=='\r') uart.WriteByte('\n');
+    }
+}
+
+/* ShowNumber - shows a number on the 5x5 LED array in binary, most
+ *    significant bit first, starting at the top left. 
+ *
+ * inputs:
+ *    numberToShow - the number. Only the bottom 25 bits are shown
+ * */
+void Main::ShowNumber(unsigned int numberToShow)
+{
+    unsigned char ledImage[NUM_LEDS_IN_ARRAY];
+
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++)
+    {
+        unsigned int bitIndex = (NUM_LEDS_IN_ARRAY-1)-i;
+        ledImage[i] = ((numberToShow>>bitIndex) & 0x01) ? 1 : 0;
+    }
+    ledArray.SetBinaryImage(ledImage);
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+}
@@ -0,0 +1,109 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_RNG.h"
+#include "YakIO_EVENTLOOP.h"
+#include "YakIO_TASK.h"
+#include "YakIO_UART.h"
+
+// the events in this program. The task scheduler needs one for itself
+enum APP_EVENT {
+    EVENT_TASK_RESUME=0     // the task scheduler resumes tasks with this
+};
+
+// the LED the blink task flashes. The bottom right corner.
+#define BLINK_LED_INDEX (NUM_LEDS_IN_ARRAY-1)
+// how long a button must stay down to count as a press
+#define BUTTON_DEBOUNCE_TICKS 20
+// how long the statistics are shown for
+#define STATS_DISPLAY_TICKS 3000
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+    
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // create input GPIOs so we can read the buttons
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        YakIO_GPIO gpioButtonB {ButtonB, PinDirInput};
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // the random number generator
+        YakIO_RNG rngObj {};
+
+        // the serial port. The echo task reads from it
+        YakIO_UART uart {};
+
+        // the event loop. The tasks run from here. It MUST be declared 
+        // before the taskScheduler because the taskScheduler uses it
+        YakIO_EVENTLOOP eventLoop {};
+
+        // the task scheduler. It takes TIMER1 for its own tick. Do not 
+        // use TIMER1 for anything else in this program
+        YakIO_TASKSCHEDULER taskScheduler {&eventLoop, EVENT_TASK_RESUME, Timer1};
+
+        // the image on the display. The tasks all write to it. They run
+        // one at a time from the event loop so they never clash
+        unsigned char ledValues[NUM_LEDS_IN_ARRAY];
+        // nz while the statistics are on the display
+        unsigned int showingStats = 0;
+
+        // the tasks. Each of these is a coroutine
+        YakIO_TASK BlinkTask(void);
+        YakIO_TASK RandomBarTask(void);
+        YakIO_TASK StatsTask(void);
+        YakIO_TASK EchoTask(void);
+
+        void ShowNumber(unsigned int numberToShow);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+
+};
+
+#endif
@@ -0,0 +1,221 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the YakIO_HSM hierarchical state machine. 
+// This does the same thing as the 06_deBounce example - each press of 
+// ButtonA lights the next LED on the array and ButtonB clears them - 
+// but the debouncing is done with explicit states instead of counters 
+// and flags.
+//
+//   STATE_ROOT                  ButtonB: clear the LEDs (from any state)
+//     STATE_IDLE                ButtonA down: go to STATE_DEBOUNCING
+//     STATE_DOWN                ButtonA up: go to STATE_IDLE (it was a bounce)
+//       STATE_DEBOUNCING        entry: start the debounce timer
+//                               exit: stop the debounce timer
+//                               timer runs out: go to STATE_HELD
+//       STATE_HELD              ButtonA up: add one LED, go to STATE_IDLE
+//
+// STATE_HELD handles a ButtonA release itself so STATE_DOWN never sees it.
+// In STATE_DEBOUNCING a release is not handled so STATE_DOWN gets it. 
+// STATE_ROOT handles ButtonB for everybody.
+//
+// The Heartbeat only watches for the buttons changing. The debounce 
+// timer feeds EVENT_DEBOUNCED straight into the state machine through 
+// Callback0(). Everything ends up in the event loop, which calls the 
+// state machine one event at a time.
+
+// #
+// # The state machine tables. Because they are const, and only hold 
+// # numbers and the addresses of member functions, they go in flash.
+// #
+
+// the state table. Each state: its parent, entry function, exit function
+const Main::HSM_STATE Main::stateTable[NUM_STATES] = 
+{
+    /* STATE_ROOT       */ { HSM_NO_STATE,     NULL,                     NULL },
+    /* STATE_IDLE       */ { STATE_ROOT,       NULL,                     NULL },
+    /* STATE_DOWN       */ { STATE_ROOT,       NULL,                     NULL },
+    /* STATE_DEBOUNCING */ { STATE_DOWN,       &Main::StartDebounceTimer, &Main::StopDebounceTimer },
+    /* STATE_HELD       */ { STATE_DOWN,       NULL,                     NULL }
+};
+
+// the transition table. One row per state, one column per event. Each 
+// entry: the state to go to, the function to call on the way
+const Main::HSM_TRANSITION Main::transitionTable[NUM_STATES][NUM_EVENTS] = 
+{
+    /* STATE_ROOT */ {
+        /* EVENT_BUTTONA_DOWN */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONA_UP   */ { HSM_NO_STATE,     NULL },
+        /* EVENT_DEBOUNCED    */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONB_DOWN */ { HSM_INTERNAL,     &Main::ClearCountMap } },
+    /* STATE_IDLE */ {
+        /* EVENT_BUTTONA_DOWN */ { STATE_DEBOUNCING, NULL },
+        /* EVENT_BUTTONA_UP   */ { HSM_NO_STATE,     NULL },
+        /* EVENT_DEBOUNCED    */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONB_DOWN */ { HSM_NO_STATE,     NULL } },
+    /* STATE_DOWN */ {
+        /* EVENT_BUTTONA_DOWN */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONA_UP   */ { STATE_IDLE,       NULL },
+        /* EVENT_DEBOUNCED    */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONB_DOWN */ { HSM_NO_STATE,     NULL } },
+    /* STATE_DEBOUNCING */ {
+        /* EVENT_BUTTONA_DOWN */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONA_UP   */ { HSM_NO_STATE,     NULL },
+        /* EVENT_DEBOUNCED    */ { STATE_HELD,       NULL },
+        /* EVENT_BUTTONB_DOWN */ { HSM_NO_STATE,     NULL } },
+    /* STATE_HELD */ {
+        /* EVENT_BUTTONA_DOWN */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONA_UP   */ { STATE_IDLE,       &Main::AddOneToCountMap },
+        /* EVENT_DEBOUNCED    */ { HSM_NO_STATE,     NULL },
+        /* EVENT_BUTTONB_DOWN */ { HSM_NO_STATE,     NULL } }
+};
+
+/* constructor - hands the tables and the event loop to the state machine
+ * */
+Main::Main() : YakIO_HSM<Main>(&stateTable[0], NUM_STATES, &transitionTable[0][0], NUM_EVENTS, &eventLoop)
+{
+}
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{
+    // #
+    // # We do setup now
+    // #
+
+    ledArray.ClearImage();
+    ClearCountMap(0);
+
+    // all of the events go to the state machine - which is us
+    for(unsigned int i=0; i<NUM_EVENTS; i++) eventLoop.RegisterHandler(i, EVENT_PRIORITY_NORMAL, this);
+
+    // the debounce timer calls our Callback0() which the state machine 
+    // turns into an EVENT_DEBOUNCED. We set it up but do not start it.
+    // A prescaler of 4 gives 1MHz so the count is in microseconds
+    SetCallbackEvent(CALLBACK_0, EVENT_DEBOUNCED);
+    debounceTimerObj.QuickSetup(4, DEBOUNCE_MICROSECONDS, CALLBACK_0, this, 0);
+
+    // into the first state
+    Start(STATE_IDLE);
+
+    // set our Heartbeat going. We do this last because it starts 
+    // feeding events in straight away
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # Hand over to the event loop
+    // #
+
+    // this never returns. All the work from here on is done by the 
+    // state machine
+    eventLoop.Run();
+
+} // bottom of Main::MainLoop()
+
+/* StartDebounceTimer - the entry function of STATE_DEBOUNCING
+ *
+ * inputs:
+ *    eventData - not used
+ * */
+void Main::StartDebounceTimer(unsigned int eventData)
+{
+    debounceTimerObj.TimerClear();
+    debounceTimerObj.TimerStart();
+}
+
+/* StopDebounceTimer - the exit function of STATE_DEBOUNCING. If we leave 
+ *    because of a bounce the timer must not run out later
+ *
+ * inputs:
+ *    eventData - not used
+ * */
+void Main::StopDebounceTimer(unsigned int eventData)
+{
+    debounceTimerObj.TimerStop();
+}
+
+/* AddOneToCountMap - lights the next LED in our graphical count. If they 
+ *    are all lit already, clears them all. The transition function from
+ *    STATE_HELD to STATE_IDLE.
+ *
+ * inputs:
+ *    eventData - not used
+ * */
+void Main::AddOneToCountMap(unsigned int eventData)
+{
+    // run through each LED
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++)
+    {
+        // found one we have not updated yet?
+        if(countMap[i]==0)
+        {
+            // yes, leave now
+            countMap[i]=1;
+            ledArray.SetBinaryImage(countMap);
+            return;
+        }
+    }
+    // we have filled the graphical display, just reset
+    ClearCountMap(0);
+}
+
+/* ClearCountMap - clears down our graphical map of the counts we have
+ *    received. The internal transition function for ButtonB in STATE_ROOT.
+ *
+ * inputs:
+ *    eventData - not used
+ * */
+void Main::ClearCountMap(unsigned int eventData)
+{
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++) countMap[i]=0;
+    ledArray.SetBinaryImage(countMap);
+}
+
+/* Heartbeat - this is the Heartbeat callback function
+ *
+ *    See the 02_BetterBlinky sample code for a full explanation of
+ *    how this works.
+ *
+ *    NOTE: You are in an INTERRUPT in here! Be Quick! We only look for
+ *    the buttons changing. Working out what a change means is left to 
+ *    the state machine.
+ *
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();
+
+    // the buttons read 0 when they are pressed
+    unsigned int buttonAState = gpioButtonA.GetGPIOState();
+    if(buttonAState != lastButtonAState)
+    {
+        if(buttonAState==0) FeedEvent(EVENT_BUTTONA_DOWN, 0);
+        else FeedEvent(EVENT_BUTTONA_UP, 0);
+        lastButtonAState = buttonAState;
+    }
+
+    unsigned int buttonBState = gpioButtonB.GetGPIOState();
+    if(buttonBState != lastButtonBState)
+    {
+        if(buttonBState==0) FeedEvent(EVENT_BUTTONB_DOWN, 0);
+        lastButtonBState = buttonBState;
+    }
+}
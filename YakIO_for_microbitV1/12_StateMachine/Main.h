@@ -0,0 +1,113 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_EVENTLOOP.h"
+#include "YakIO_HSM.h"
+
+// the states of the ButtonA state machine. The indentation shows the hierarchy
+enum APP_STATE {
+    STATE_ROOT=0,           // everything is inside this. Handles ButtonB
+    STATE_IDLE,             //   ButtonA is up
+    STATE_DOWN,             //   ButtonA is down. Handles a release during the bounce
+    STATE_DEBOUNCING,       //     ButtonA has only just gone down
+    STATE_HELD,             //     ButtonA has been down long enough to count
+    NUM_STATES
+};
+
+// the events. These are also the eventTypes in the event loop
+enum APP_EVENT {
+    EVENT_BUTTONA_DOWN=0,   // ButtonA has gone down (it may be bouncing)
+    EVENT_BUTTONA_UP,       // ButtonA has come up (it may be bouncing)
+    EVENT_DEBOUNCED,        // the debounce timer has run out
+    EVENT_BUTTONB_DOWN,     // ButtonB has gone down
+    NUM_EVENTS
+};
+
+// the debounce time in microseconds. The debounce timer counts at 1MHz
+#define DEBOUNCE_MICROSECONDS 10000
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_HSM<Main> // the state machine. It inherits from YakIO_CALLBACK for us
+{ 
+    private:
+    
+        // the state machine tables. These are in flash, see Main.cpp
+        static const HSM_STATE stateTable[NUM_STATES];
+        static const HSM_TRANSITION transitionTable[NUM_STATES][NUM_EVENTS];
+
+        // a 25 slot array to record button presses
+        unsigned char countMap[NUM_LEDS_IN_ARRAY]; 
+    
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // create input GPIOs so we can read the buttons
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        YakIO_GPIO gpioButtonB {ButtonB, PinDirInput};
+        // the last state we saw each button in, so we can spot changes
+        unsigned int lastButtonAState = 1;
+        unsigned int lastButtonBState = 1;
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // the debounce timer. It only runs in STATE_DEBOUNCING
+        YakIO_TIMER debounceTimerObj {Timer1};
+
+        // the event loop. The state machine is run from here
+        YakIO_EVENTLOOP eventLoop {};
+
+        // the entry, exit and transition functions
+        void StartDebounceTimer(unsigned int eventData);
+        void StopDebounceTimer(unsigned int eventData);
+        void AddOneToCountMap(unsigned int eventData);
+        void ClearCountMap(unsigned int eventData);
+        
+    public:
+        // the constructor hands the tables to the state machine
+        Main();
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+
+};
+
+#endif
@@ -0,0 +1,165 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate memory pools. 
+//
+// Each press of ButtonA creates a ButtonPressMessage from a 
+// YakIO_POOL in the Heartbeat (an interrupt handler) and posts its 
+// address to the event loop. The event loop shows how long the button 
+// was held as a bar of LEDs and then destroys the message, giving its 
+// block back to the pool. 
+//
+// Each press of ButtonB uses "new" to create an LedImage, fills it 
+// with the high water marks of the pools and shows it for a while 
+// before using "delete" to get rid of it. new and delete work because
+// there is a YakIO_POOLSET in the Main class. An LedImage is 25 bytes
+// so it comes from the 32 byte size class.
+//
+// The high water display has one row per pool, each a binary number
+// with the most significant bit on the left:
+//     row 0 - the ButtonPressMessage pool
+//     row 1 to 4 - the 8, 16, 32 and 64 byte size classes
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{
+    // #
+    // # We do setup now
+    // #
+
+    ledArray.ClearImage();
+
+    eventLoop.RegisterHandler(EVENT_BUTTONA_MESSAGE, EVENT_PRIORITY_NORMAL, this);
+    eventLoop.RegisterHandler(EVENT_BUTTONB_RELEASED, EVENT_PRIORITY_NORMAL, this);
+
+    // set our Heartbeat going. See 02_BetterBlinky
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # Hand over to the event loop
+    // #
+
+    // this never returns
+    eventLoop.Run();
+
+} // bottom of Main::MainLoop()
+
+/* EventCallback - this is called by the event loop each time it takes
+ *    an event out of its queue. This is NOT an interrupt.
+ *
+ * inputs:
+ *    eventType - the event, one of the APP_EVENT values
+ *    eventData - for EVENT_BUTTONA_MESSAGE, the address of the message
+ * */
+void Main::EventCallback(unsigned int eventType, unsigned int eventData)
+{
+    if(eventType==EVENT_BUTTONA_MESSAGE)
+    {
+        // this only works because pointers are 32 bits on the nRF51822
+        ButtonPressMessage *messagePtr = (ButtonPressMessage *)eventData;
+        ShowPress(messagePtr);
+        // finished with it, the block goes back in the pool
+        messagePool.Destroy(messagePtr);
+    }
+    else if(eventType==EVENT_BUTTONB_RELEASED) ShowHighWaterMarks();
+}
+
+/* ShowPress - shows how long the button was held as a bar of LEDs. One
+ *    LED per 100 milliseconds
+ *
+ * inputs:
+ *    messagePtr - the message
+ * */
+void Main::ShowPress(ButtonPressMessage *messagePtr)
+{
+    // the image comes from the pool set via new
+    LedImage *imagePtr = new LedImage;
+
+    unsigned int ledCount = messagePtr->heldForHeartbeats/100;
+    for(unsigned int i=0; i<NUM_LEDS_IN_ARRAY; i++) imagePtr->leds[i] = (i<ledCount) ? 1 : 0;
+    ledArray.SetBinaryImage(imagePtr->leds);
+
+    // and back it goes
+    delete imagePtr;
+}
+
+/* ShowHighWaterMarks - shows the high water marks of all the pools, one
+ *    per row, in binary
+ * */
+void Main::ShowHighWaterMarks(void)
+{
+    LedImage *imagePtr = new LedImage;
+
+    unsigned int highWaterCounts[5];
+    highWaterCounts[0] = messagePool.GetHighWaterCount();
+    for(unsigned int i=0; i<POOL_NUM_SIZE_CLASSES; i++) highWaterCounts[i+1] = poolSet.GetSizeClassPool(i)->GetHighWaterCount();
+
+    for(unsigned int row=0; row<5; row++)
+    {
+        for(unsigned int column=0; column<5; column++)
+        {
+            imagePtr->leds[(row*5)+column] = ((highWaterCounts[row]>>(4-column)) & 0x01) ? 1 : 0;
+        }
+    }
+    ledArray.SetBinaryImage(imagePtr->leds);
+
+    delete imagePtr;
+}
+
+/* Heartbeat - this is the Heartbeat callback function
+ *
+ *    See the 02_BetterBlinky sample code for a full explanation of
+ *    how this works.
+ *
+ *    NOTE: You are in an INTERRUPT in here! Be Quick! Creating a message
+ *    from a pool is quick - it takes the first block off a list.
+ *
+ * */
+void Main::Heartbeat(void)
+{
+    heartbeatCount++;
+
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();
+
+    // debounce both buttons. See the 06_deBounce example
+    if(gpioButtonA.GetGPIOState() == 0) buttonACounter++;
+    else
+    {
+        if(buttonACounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS)
+        {
+            ButtonPressMessage *messagePtr = messagePool.Create(heartbeatCount-buttonACounter, buttonACounter);
+            // if the pool is empty we lose this press. The pool counts these
+            if(messagePtr!=NULL) 
+            {
+                // if the queue is full the message must go back to the pool
+                if(eventLoop.PostEvent(EVENT_BUTTONA_MESSAGE, (unsigned int)messagePtr)==0) messagePool.Destroy(messagePtr);
+            }
+        }
+        buttonACounter=0;
+    }
+
+    if(gpioButtonB.GetGPIOState() == 0) buttonBCounter++;
+    else
+    {
+        if(buttonBCounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS) eventLoop.PostEvent(EVENT_BUTTONB_RELEASED, 0);
+        buttonBCounter=0;
+    }
+}
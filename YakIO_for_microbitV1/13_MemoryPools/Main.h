@@ -0,0 +1,122 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_EVENTLOOP.h"
+#include "YakIO_POOL.h"
+
+// the events in this program
+enum APP_EVENT {
+    EVENT_BUTTONA_MESSAGE=0,   // the eventData is a ButtonPressMessage*
+    EVENT_BUTTONB_RELEASED=1   // ButtonB was pressed and released
+};
+
+// the debouncing is done out of the Heartbeat
+#define MIN_HEARTBEATS_FOR_A_BUTTONPRESS 10
+// the number of messages that can be in flight at once
+#define NUM_PRESS_MESSAGES 4
+
+/* ButtonPressMessage - created in the Heartbeat (an interrupt) each time 
+ *    ButtonA is released and destroyed by the event loop once it has 
+ *    been dealt with
+ * */
+struct ButtonPressMessage
+{
+    unsigned int pressedAtHeartbeat;    // when it was pressed
+    unsigned int heldForHeartbeats;     // how long it was held down
+
+    ButtonPressMessage(unsigned int pressedAtHeartbeatIn, unsigned int heldForHeartbeatsIn)
+    {
+        pressedAtHeartbeat = pressedAtHeartbeatIn;
+        heldForHeartbeats = heldForHeartbeatsIn;
+    }
+};
+
+/* LedImage - an image for the 5x5 display. These are created with "new"
+ *    so they come from the YakIO_POOLSET
+ * */
+struct LedImage
+{
+    unsigned char leds[NUM_LEDS_IN_ARRAY];
+};
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+    
+        // the pools used by new and delete. Until this object exists
+        // new and delete will not work
+        YakIO_POOLSET poolSet {};
+
+        // the pool the button press messages come from
+        YakIO_POOL<ButtonPressMessage, NUM_PRESS_MESSAGES> messagePool {};
+
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // create input GPIOs so we can read the buttons
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        YakIO_GPIO gpioButtonB {ButtonB, PinDirInput};
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // the event loop
+        YakIO_EVENTLOOP eventLoop {};
+        
+        // for debouncing. See 06_deBounce
+        unsigned int buttonACounter = 0;
+        unsigned int buttonBCounter = 0;
+        unsigned int heartbeatCount = 0;
+
+        void ShowPress(ButtonPressMessage *messagePtr);
+        void ShowHighWaterMarks(void);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+        // the event loop calls this to deliver the events
+        void EventCallback(unsigned int eventType, unsigned int eventData) override;
+
+};
+
+#endif
@@ -0,0 +1,209 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the YakIO_HEAP TLSF allocator. 
+//
+// Every HEARTBEATS_PER_CHURN milliseconds we pick one of 
+// NUM_ALLOCATION_SLOTS slots at random. If it holds a block we free
+// it, otherwise we allocate a new block of a random size between
+// MIN_ALLOCATION_BYTES and MAX_ALLOCATION_BYTES. This is a good way
+// to chop the heap up into lots of small pieces - which is the point.
+//
+// Each Allocate() and Free() is timed with a TIMER0 cycle counter (see
+// 08_Benchmark) and the worst times are kept. However fragmented the 
+// heap gets these should stay put - that is what TLSF is for.
+//
+// ButtonA switches the LED array between two displays:
+//
+//    DISPLAY_FRAGMENTATION - a bar, one LED per 4 percent. 0 LEDs means
+//       all the free memory is in one block
+//    DISPLAY_WORST_CYCLES - rows 0 and 1 are the worst Allocate() cycle 
+//       count and rows 2 and 3 the worst Free() cycle count, each as a 10
+//       bit binary number, most significant bit top left. Row 4 is a bar 
+//       showing how much of the heap is in use
+//
+// The random numbers come from a simple xorshift rather than YakIO_RNG
+// so that each run churns the heap in exactly the same way.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    for(int i=0; i<NUM_ALLOCATION_SLOTS; i++) allocations[i]=NULL;
+    ledArray.ClearImage();
+
+    // start our stopwatch
+    StartCycleCounter();
+
+    // set our Heartbeat going. See 02_BetterBlinky
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        if(churnIsDue!=0)
+        {
+            ChurnTheHeap();
+            churnIsDue=0;
+        }
+        if(buttonAHasBeenPressed!=0)
+        {
+            if(displayMode==DISPLAY_FRAGMENTATION) displayMode=DISPLAY_WORST_CYCLES;
+            else displayMode=DISPLAY_FRAGMENTATION;
+            // show it straight away
+            displayIsDue=1;
+            // we must reset this
+            buttonAHasBeenPressed=0;
+        }
+        if(displayIsDue!=0)
+        {
+            if(displayMode==DISPLAY_FRAGMENTATION) ShowFragmentation();
+            else ShowWorstCycles();
+            displayIsDue=0;
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* StartCycleCounter - sets up TIMER0 as a free running 32 bit counter
+ *    which counts at the full 16MHz. See 08_Benchmark
+ * */
+void Main::StartCycleCounter(void)
+{
+    cycleCounterObj.TimerStop();
+    cycleCounterObj.SetMode(TIMER_MODE_Timer);
+    cycleCounterObj.SetBitMode(TIMER_BITMODE_32Bit);
+    cycleCounterObj.SetPrescaler(0);
+    cycleCounterObj.TimerClear();
+    cycleCounterObj.TimerStart();
+}
+
+/* ChurnTheHeap - frees or allocates one block at random and times it
+ * */
+void Main::ChurnTheHeap(void)
+{
+    unsigned int slot = GetNextRandom() % NUM_ALLOCATION_SLOTS;
+
+    if(allocations[slot]!=NULL)
+    {
+        unsigned int startCount = cycleCounterObj.GetCount();
+        heap.Free(allocations[slot]);
+        unsigned int elapsedCycles = cycleCounterObj.GetCount() - startCount;
+        if(elapsedCycles>worstFreeCycles) worstFreeCycles = elapsedCycles;
+        allocations[slot] = NULL;
+        return;
+    }
+
+    unsigned int bytesWanted = MIN_ALLOCATION_BYTES + (GetNextRandom() % (MAX_ALLOCATION_BYTES-MIN_ALLOCATION_BYTES+1));
+    unsigned int startCount = cycleCounterObj.GetCount();
+    allocations[slot] = heap.Allocate(bytesWanted);
+    unsigned int elapsedCycles = cycleCounterObj.GetCount() - startCount;
+    if(elapsedCycles>worstAllocateCycles) worstAllocateCycles = elapsedCycles;
+
+    // if it failed the slot stays empty. The heap counts these
+    if(allocations[slot]==NULL) return;
+
+    // use the memory so we can see it is really ours
+    unsigned char *bytePtr = (unsigned char *)allocations[slot];
+    for(unsigned int i=0; i<bytesWanted; i++) bytePtr[i] = (unsigned char)slot;
+}
+
+/* GetNextRandom - a xorshift32 pseudo random number generator. Not 
+ *    random at all really, but it is quick and always gives the same
+ *    sequence
+ *
+ * returns:
+ *    the next number in the sequence
+ * */
+unsigned int Main::GetNextRandom(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+/* ShowFragmentation - shows the fragmentation percentage as a bar of
+ *    LEDs, one LED per 4 percent
+ * */
+void Main::ShowFragmentation(void)
+{
+    YakIO_HEAPSTATS heapStats;
+    heap.GetStatistics(&heapStats);
+
+    unsigned int ledCount = heapStats.fragmentationPercent/4;
+    unsigned char leds[NUM_LEDS_IN_ARRAY];
+    for(unsigned int i=0; i<NUM_LEDS_IN_ARRAY; i++) leds[i] = (i<ledCount) ? 1 : 0;
+    ledArray.SetBinaryImage(leds);
+}
+
+/* ShowWorstCycles - shows the worst Allocate() and Free() cycle counts
+ *    as 10 bit binary numbers and a bar of the heap in use
+ * */
+void Main::ShowWorstCycles(void)
+{
+    unsigned char leds[NUM_LEDS_IN_ARRAY];
+
+    for(unsigned int i=0; i<10; i++)
+    {
+        leds[i] = ((worstAllocateCycles>>(9-i)) & 0x01) ? 1 : 0;
+        leds[10+i] = ((worstFreeCycles>>(9-i)) & 0x01) ? 1 : 0;
+    }
+
+    // one LED per fifth of the heap
+    unsigned int usedLeds = 0;
+    if(heap.GetTotalBytes()!=0) usedLeds = (heap.GetUsedBytes()*5)/heap.GetTotalBytes();
+    for(unsigned int i=0; i<5; i++) leds[20+i] = (i<usedLeds) ? 1 : 0;
+
+    ledArray.SetBinaryImage(leds);
+}
+
+/* Heartbeat - this is the Heartbeat callback function
+ *
+ *    See the 02_BetterBlinky sample code for a full explanation of
+ *    how this works.
+ *
+ *    NOTE: You are in an INTERRUPT in here! Be Quick! We only set 
+ *    flags here, the work is done in the MainLoop.
+ *
+ * */
+void Main::Heartbeat(void)
+{
+    heartbeatCount++;
+
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();
+
+    if((heartbeatCount%HEARTBEATS_PER_CHURN)==0) churnIsDue=1;
+    if((heartbeatCount%HEARTBEATS_PER_DISPLAY)==0) displayIsDue=1;
+
+    // debounce ButtonA. See the 06_deBounce example
+    if(gpioButtonA.GetGPIOState() == 0) buttonACounter++;
+    else
+    {
+        if(buttonACounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS) buttonAHasBeenPressed=1;
+        buttonACounter=0;
+    }
+}
@@ -0,0 +1,115 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_HEAP.h"
+
+// the debouncing is done out of the Heartbeat
+#define MIN_HEARTBEATS_FOR_A_BUTTONPRESS 10
+// the number of allocations we keep hold of at once
+#define NUM_ALLOCATION_SLOTS 16
+// the range of sizes we ask for
+#define MIN_ALLOCATION_BYTES 8
+#define MAX_ALLOCATION_BYTES 512
+// how often (in heartbeats) we free one block and allocate another
+#define HEARTBEATS_PER_CHURN 50
+// how often (in heartbeats) the display is updated
+#define HEARTBEATS_PER_DISPLAY 500
+
+// the things we can show on the LED array
+enum DISPLAY_MODE {
+    DISPLAY_FRAGMENTATION=0,   // a bar, one LED per 4 percent
+    DISPLAY_WORST_CYCLES=1     // the worst Allocate() and Free() cycle counts
+};
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+    
+        // the heap. It uses the RAM the linker script leaves between
+        // the .bss section and the stack reserve
+        YakIO_HEAP heap {};
+
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // create an input GPIO so we can read ButtonA
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // a free running counter of CPU cycles. See 08_Benchmark
+        YakIO_TIMER cycleCounterObj {Timer0};
+
+        // the blocks we are holding. NULL if the slot is empty
+        void *allocations[NUM_ALLOCATION_SLOTS];
+
+        // the worst times we have seen
+        unsigned int worstAllocateCycles = 0;
+        unsigned int worstFreeCycles = 0;
+
+        // set in the Heartbeat, cleared in the MainLoop
+        volatile unsigned int churnIsDue = 0;
+        volatile unsigned int displayIsDue = 0;
+        volatile unsigned int buttonAHasBeenPressed = 0;
+
+        enum DISPLAY_MODE displayMode = DISPLAY_FRAGMENTATION;
+        unsigned int randomState = 0x12345678;
+
+        // for debouncing. See 06_deBounce
+        unsigned int buttonACounter = 0;
+        unsigned int heartbeatCount = 0;
+
+        void StartCycleCounter(void);
+        void ChurnTheHeap(void);
+        unsigned int GetNextRandom(void);
+        void ShowFragmentation(void);
+        void ShowWorstCycles(void);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+
+};
+
+#endif
@@ -0,0 +1,138 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the stack monitoring.
+//
+// The startup code fills the stack reserve with a known pattern (see
+// the STACK notes in YakIO_Utils.h). GetStackHighWater() finds out how
+// much of it has been overwritten - in other words the most stack we 
+// have ever used. This is shown on the LED array as a bar. The whole 
+// 25 LEDs is the whole stack reserve.
+//
+// Each press of ButtonA calls a function which calls itself 
+// RECURSIONS_PER_PRESS more times than last time. Each call puts a 
+// 64 byte array on the stack so the bar creeps up. Eventually the stack
+// reaches the canary at the bottom of the reserve, the YakIO_STACKGUARD
+// notices and calls Callback3() which shows a big X. In a real program
+// you would want to do something more useful - like reset.
+//
+// NOTE: if you change the stack reserve (see __stackReserveSize__ in 
+// microbit.ld) it will take a different number of presses.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    ledArray.ClearImage();
+
+    // set our Heartbeat going. See 02_BetterBlinky
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // check the canary every STACK_CHECK_INTERVAL_MS milliseconds
+    stackGuard.Start(STACK_CHECK_INTERVAL_MS, CALLBACK_3, this);
+
+    ShowHighWater();
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        if((buttonAHasBeenPressed!=0) && (stackGuard.HasOverflowed()==0))
+        {
+            recursionDepth += RECURSIONS_PER_PRESS;
+            EatTheStack(recursionDepth);
+            ShowHighWater();
+            // we must reset this
+            buttonAHasBeenPressed=0;
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* EatTheStack - calls itself depthToGo times. Each call uses a bit
+ *    over 64 bytes of stack
+ *
+ * inputs:
+ *    depthToGo - the number of calls still to make
+ *
+ * returns:
+ *    a meaningless number. We need to use the array or the compiler
+ *    would throw it away
+ * */
+unsigned int Main::EatTheStack(unsigned int depthToGo)
+{
+    volatile unsigned char scratchArray[64];
+    for(unsigned int i=0; i<sizeof(scratchArray); i++) scratchArray[i] = (unsigned char)depthToGo;
+    if(depthToGo==0) return scratchArray[0];
+    return EatTheStack(depthToGo-1) + scratchArray[depthToGo%sizeof(scratchArray)];
+}
+
+/* ShowHighWater - shows the stack high water mark as a bar. All 25 
+ *    LEDs is the whole stack reserve
+ * */
+void Main::ShowHighWater(void)
+{
+    unsigned int ledCount = (GetStackHighWater()*NUM_LEDS_IN_ARRAY)/GetStackReserveSize();
+    unsigned char leds[NUM_LEDS_IN_ARRAY];
+    for(unsigned int i=0; i<NUM_LEDS_IN_ARRAY; i++) leds[i] = (i<ledCount) ? 1 : 0;
+    ledArray.SetBinaryImage(leds);
+}
+
+/* Callback3 - the stack guard calls this if the canary at the bottom of
+ *    the stack reserve has been overwritten. 
+ *
+ *    NOTE: You are in an INTERRUPT in here! 
+ * */
+void Main::Callback3(void)
+{
+    unsigned char bigX[NUM_LEDS_IN_ARRAY] = 
+         {1,0,0,0,1,
+          0,1,0,1,0,
+          0,0,1,0,0,
+          0,1,0,1,0,
+          1,0,0,0,1}; 
+    ledArray.SetBinaryImage(bigX);
+}
+
+/* Heartbeat - this is the Heartbeat callback function
+ *
+ *    See the 02_BetterBlinky sample code for a full explanation of
+ *    how this works.
+ *
+ *    NOTE: You are in an INTERRUPT in here! Be Quick!
+ *
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();
+
+    // debounce ButtonA. See the 06_deBounce example
+    if(gpioButtonA.GetGPIOState() == 0) buttonACounter++;
+    else
+    {
+        if(buttonACounter>=MIN_HEARTBEATS_FOR_A_BUTTONPRESS) buttonAHasBeenPressed=1;
+        buttonACounter=0;
+    }
+}
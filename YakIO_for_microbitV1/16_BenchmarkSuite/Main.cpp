@@ -0,0 +1,463 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which measures how many CPU cycles the commonly used YakIO 
+// functions take and prints the results on the serial port. It is the 
+// 08_Benchmark example turned into something you can run over and over 
+// again and compare - both on a real microbit and under the QEMU emulator
+// on a Linux box (see the RunQEMU.sh script in this directory).
+//
+// As in 08_Benchmark, TIMER0 counts every cycle of the 16MHz clock and is 
+// read before and after running an operation BENCHMARK_ITERATIONS times. 
+// The cost of the empty loop is subtracted and the rest is divided by the
+// number of iterations (with a shift, the Cortex-M0 has no divide).
+//
+// Unlike 08_Benchmark there is no heartbeat. Nothing interrupts the 
+// benchmarks so every run gives exactly the same numbers on the same 
+// hardware. That is what you want when you are looking to see if a change
+// made something slower.
+//
+// The results are printed on the serial port at 115200 baud, one per line 
+// in the form
+//
+//    BENCH <name> <value>
+//
+// followed by a line containing just BENCH_DONE. The microbit shows up as 
+// a serial port on the PC when it is plugged in (COMx on Windows, 
+// /dev/ttyACM0 on Linux). Any serial terminal will show the output. Press
+// ButtonA to print the results again.
+
+// the names printed for each result. These must be in BENCHMARK_ID order 
+// (see Main.h) and must not contain spaces - RunQEMU.sh splits on them
+static const char *benchmarkNames[BENCH_NUM_RESULTS] = {
+    "LOOP_OVERHEAD",
+    "GPIO_SET_HIGH",
+    "GPIO_SET_LOW",
+    "GPIO_SET_STATE",
+    "GPIO_TOGGLE",
+    "GPIO_GET_STATE",
+    "LED_REFRESH",
+    "LED_SET_IMAGE",
+    "LED_SET_STATE",
+    "CALLBACK_DISPATCH",
+    "RNG_VALUE",
+    "PRNG_XORSHIFT32",
+    "PRNG_XORSHIFT128",
+    "PRNG_PCG32",
+    "PRNG_RANGE",
+    "PRNG_FILL",
+    "IRQ_ENTRY",
+    "IRQ_ROUND_TRIP",
+    "CRITICAL_SECTION",
+    "BOOT_CYCLES"
+};
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    // clear the results down
+    for(int i=0; i<BENCH_NUM_RESULTS; i++) benchmarkResults[i]=0;
+
+    // get the serial port going
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteNewLine();
+    uart.WriteString("YAKIO BENCHMARK SUITE");
+    uart.WriteNewLine();
+
+    // the target of the CallCallback() benchmark. The timer itself is never started
+    callbackTimerObj.SetCallback(CALLBACK_0, this);
+
+    // start our stopwatch
+    StartCycleCounter();
+
+    // #
+    // # Run the benchmarks
+    // #
+
+    benchmarkResults[BENCH_LOOP_OVERHEAD] = MeasureLoopOverhead();
+    RunGPIOBenchmarks();
+    RunLEDArrayBenchmarks();
+    RunCallbackBenchmarks();
+    RunRngBenchmarks();
+    RunPrngBenchmarks();
+    RunIRQBenchmarks();
+
+    // the startup code times itself. See the BOOT TIME notes in YakIO.cpp
+    benchmarkResults[BENCH_BOOT_CYCLES] = GetBootCycles();
+
+    PrintResults();
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    unsigned int buttonWasDown = 0;
+    while(1)
+    {
+        // print the results again each time ButtonA is pressed. There is
+        // no heartbeat so we do a crude debounce by waiting for the 
+        // button to come back up before we look for the next press
+        if(gpioButtonA.GetGPIOState() == 0)
+        {
+            buttonWasDown = 1;
+        }
+        else if(buttonWasDown != 0)
+        {
+            buttonWasDown = 0;
+            PrintResults();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* StartCycleCounter - sets up TIMER0 as a free running 32 bit counter
+ *    which counts at the full 16MHz. See the 08_Benchmark example.
+ * */
+void Main::StartCycleCounter(void)
+{
+    cycleCounterObj.TimerStop();
+    cycleCounterObj.SetMode(TIMER_MODE_Timer);
+    cycleCounterObj.SetBitMode(TIMER_BITMODE_32Bit);
+    // a prescaler of 0 means 16MHz/(2^0) - every clock cycle is counted
+    cycleCounterObj.SetPrescaler(0);
+    cycleCounterObj.TimerClear();
+    cycleCounterObj.TimerStart();
+}
+
+/* MeasureLoopOverhead - measures the total cost of a timing loop that 
+ *    does nothing. This is subtracted from the other results so we only
+ *    see the cost of the thing being measured.
+ *
+ * returns:
+ *    the total cycles consumed by BENCHMARK_ITERATIONS empty loops
+ * */
+unsigned int Main::MeasureLoopOverhead(void)
+{
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        // stops the compiler throwing the loop away
+        COMPILER_BARRIER();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    return endCount-startCount;
+}
+
+/* CyclesPerCall - converts a start and end count taken around a 
+ *    BENCHMARK_ITERATIONS loop into the cost of one trip around it
+ *
+ * inputs:
+ *    startCount - the count before the loop
+ *    endCount - the count after the loop
+ *
+ * returns:
+ *    the cycles per iteration, less the loop overhead
+ * */
+unsigned int Main::CyclesPerCall(unsigned int startCount, unsigned int endCount)
+{
+    unsigned int loopCycles = endCount-startCount;
+    // the overhead might, very rarely, be a cycle or two more than a 
+    // loop which does something (the pipeline is a funny thing)
+    if(loopCycles<benchmarkResults[BENCH_LOOP_OVERHEAD]) return 0;
+    return (loopCycles-benchmarkResults[BENCH_LOOP_OVERHEAD]) >> BENCHMARK_ITERATIONS_SHL;
+}
+
+/* RunGPIOBenchmarks - measures the YakIO_GPIO set, get and toggle 
+ *    functions. Pin0 is the big ring on the edge connector. Nothing 
+ *    should be connected to it while this runs
+ * */
+void Main::RunGPIOBenchmarks(void)
+{
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        gpioOut.SetGPIOStateHigh();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_GPIO_SET_HIGH] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        gpioOut.SetGPIOStateLow();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_GPIO_SET_LOW] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        gpioOut.SetGPIOState(i & 0x01);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_GPIO_SET_STATE] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        gpioOut.ToggleGPIOState();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_GPIO_TOGGLE] = CyclesPerCall(startCount, endCount);
+
+    unsigned int stateSum = 0;
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        stateSum = stateSum + gpioButtonA.GetGPIOState();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_GPIO_GET_STATE] = CyclesPerCall(startCount, endCount);
+    benchmarkSink = stateSum;
+
+    gpioOut.SetGPIOStateLow();
+}
+
+/* RunLEDArrayBenchmarks - measures the YakIO_LEDARRAY functions. 
+ *    SetBinaryImage() and SetLEDState() both rebuild the backing store 
+ *    with ProcessBackingStore() so they show what that costs. 
+ *    RefreshLEDArray() is the one called from every heartbeat in most of 
+ *    the other examples
+ * */
+void Main::RunLEDArrayBenchmarks(void)
+{
+    unsigned char ledImage[NUM_LEDS_IN_ARRAY];
+    for(int i=0; i<NUM_LEDS_IN_ARRAY; i++) ledImage[i] = (i & 0x01);
+
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        ledArray.SetBinaryImage(ledImage);
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_LED_SET_IMAGE] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        ledArray.SetLEDState(2, 2, i & 0x01);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_LED_SET_STATE] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        ledArray.RefreshLEDArray();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_LED_REFRESH] = CyclesPerCall(startCount, endCount);
+
+    // leave the display dark
+    ledArray.ClearImage();
+    ledArray.RefreshLEDArray();
+}
+
+/* RunCallbackBenchmarks - measures the cost of dispatching a callback 
+ *    through YakIO_TIMER::CallCallback(). This is the path every timer 
+ *    interrupt takes to get to your code. Also measures an 
+ *    EnterCritical()/ExitCritical() pair
+ * */
+void Main::RunCallbackBenchmarks(void)
+{
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        callbackTimerObj.CallCallback();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_CALLBACK_DISPATCH] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        unsigned int primaskState = EnterCritical();
+        ExitCritical(primaskState);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_CRITICAL_SECTION] = CyclesPerCall(startCount, endCount);
+}
+
+/* RunRngBenchmarks - measures YakIO_RNG::GetRngValue(). This is mostly 
+ *    the time the hardware takes to make each value so it only gets 
+ *    BENCHMARK_SLOW_ITERATIONS runs. Bias correction is off - see the 
+ *    07_Random example
+ * */
+void Main::RunRngBenchmarks(void)
+{
+    unsigned int valueSum = 0;
+
+    rngObj.SetDerCen(RNG_DERCEN_DIS);
+    rngObj.RngStart();
+
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_SLOW_ITERATIONS; i++)
+    {
+        valueSum = valueSum + rngObj.GetRngValue();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    // the loop overhead is tiny next to the RNG so we do not bother with it
+    benchmarkResults[BENCH_RNG_VALUE] = (endCount-startCount) >> BENCHMARK_SLOW_ITERATIONS_SHL;
+    benchmarkSink = valueSum;
+
+    rngObj.RngStop();
+}
+
+/* RunPrngBenchmarks - measures the YakIO_PRNG generators. Compare these 
+ *    with BENCH_RNG_VALUE - the hardware gives us 8 bits for that, each 
+ *    of these gives us 32. The generators keep their fixed starting seeds
+ *    so they make the same numbers, and take the same time, every run
+ * */
+void Main::RunPrngBenchmarks(void)
+{
+    unsigned int valueSum = 0;
+
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        valueSum = valueSum + xorshift32Obj.GetNext();
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_PRNG_XORSHIFT32] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        valueSum = valueSum + xorshift128Obj.GetNext();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_PRNG_XORSHIFT128] = CyclesPerCall(startCount, endCount);
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        valueSum = valueSum + pcg32Obj.GetNext();
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_PRNG_PCG32] = CyclesPerCall(startCount, endCount);
+
+    // 100 needs a 127 mask so about a quarter of the values are thrown 
+    // away. That is a fair average case
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        valueSum = valueSum + xorshift128Obj.GetRange(100);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_PRNG_RANGE] = CyclesPerCall(startCount, endCount);
+
+    // this one is slow too
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_SLOW_ITERATIONS; i++)
+    {
+        xorshift128Obj.Fill(prngFillBuffer, BENCH_PRNG_FILL_BYTES);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_PRNG_FILL] = (endCount-startCount) >> BENCHMARK_SLOW_ITERATIONS_SHL;
+
+    benchmarkSink = valueSum + prngFillBuffer[0];
+}
+
+/* RunIRQBenchmarks - measures how long the CPU takes to get into an 
+ *    interrupt handler and back out again. 
+ *
+ *    We use the SWI0 software interrupt. Nothing in the hardware ever 
+ *    raises it, we do that ourselves by writing its bit to the NVIC 
+ *    Interrupt Set-Pending Register. The instant before we do that we 
+ *    capture the TIMER0 count into CC[3]. The first thing the handler does
+ *    (see IRQ_SWI0_handler() below) is capture the count into CC[2]. The 
+ *    difference is the interrupt entry time - the stacking of eight 
+ *    registers, the vector fetch and the few instructions it takes to get 
+ *    to the capture.
+ *
+ *    The round trip is timed around the whole thing in the usual way. It
+ *    includes the unstacking as well.
+ * */
+void Main::RunIRQBenchmarks(void)
+{
+    unsigned int entrySum = 0;
+
+    EnableIRQ(IRQ_SWI0);
+
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        YAKIO_REGISTER(REGISTER_TIMER0+BENCH_IRQ_START_CAPTURE)=1;
+        YAKIO_REGISTER(REGISTER_NVIC+NVICREG_OFFSET_ISPR)=(0x01<<IRQ_SWI0);
+        // the interrupt is taken here. The DSB makes sure the write has 
+        // reached the NVIC and the ISB makes sure the interrupt has been
+        // taken before we go on to read the capture registers
+        asm volatile ("dsb\n\tisb" : : : "memory");
+        entrySum = entrySum + (YAKIO_REGISTER(REGISTER_TIMER0+BENCH_IRQ_ENTRY_CC) - YAKIO_REGISTER(REGISTER_TIMER0+BENCH_IRQ_START_CC));
+    }
+    benchmarkResults[BENCH_IRQ_ENTRY] = entrySum >> BENCHMARK_ITERATIONS_SHL;
+
+    // now without the capture and the sum so we only see the interrupt
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<BENCHMARK_ITERATIONS; i++)
+    {
+        YAKIO_REGISTER(REGISTER_NVIC+NVICREG_OFFSET_ISPR)=(0x01<<IRQ_SWI0);
+        asm volatile ("dsb\n\tisb" : : : "memory");
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[BENCH_IRQ_ROUND_TRIP] = CyclesPerCall(startCount, endCount);
+
+    DisableIRQ(IRQ_SWI0);
+}
+
+/* PrintResults - prints the results on the serial port. See the notes 
+ *    at the top of this file for the format
+ * */
+void Main::PrintResults(void)
+{
+    for(int i=0; i<BENCH_NUM_RESULTS; i++)
+    {
+        uart.WriteString("BENCH ");
+        uart.WriteString(benchmarkNames[i]);
+        uart.WriteByte(' ');
+        uart.WriteUnsigned(benchmarkResults[i]);
+        uart.WriteNewLine();
+    }
+    uart.WriteString("BENCH_DONE");
+    uart.WriteNewLine();
+}
+
+/* Callback0 - the target of the CallCallback() benchmark. We used 
+ *    CALLBACK_0 when we set the callback on the timer so this function
+ *    MUST be named Callback0(). It does nothing, we only want to see 
+ *    what it costs to get here.
+ * */
+void Main::Callback0(void)
+{
+}
+
+/* IRQ_SWI0_handler - the handler for the SWI0 software interrupt. The 
+ *    name must be exactly this for it to replace the dummy handler in 
+ *    the vector table. See the notes in YakIO.cpp. 
+ *
+ *    The very first thing we do is capture the time we got here. See
+ *    RunIRQBenchmarks()
+ * */
+void IRQ_SWI0_handler(void)
+{
+    YAKIO_REGISTER(REGISTER_TIMER0+BENCH_IRQ_ENTRY_CAPTURE)=1;
+}
@@ -0,0 +1,141 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_RNG.h"
+#include "YakIO_PRNG.h"
+#include "YakIO_UART.h"
+
+// the number of times we repeat each benchmarked operation. This is
+// a power of two so we can divide by it with a shift (the Cortex-M0
+// has no divide instruction)
+#define BENCHMARK_ITERATIONS_SHL 10
+#define BENCHMARK_ITERATIONS (1<<BENCHMARK_ITERATIONS_SHL)
+// the RNG is slow (it has to wait for the hardware to make each value) so 
+// it gets far fewer
+#define BENCHMARK_SLOW_ITERATIONS_SHL 4
+#define BENCHMARK_SLOW_ITERATIONS (1<<BENCHMARK_SLOW_ITERATIONS_SHL)
+
+// the size of the buffer the YakIO_PRNG::Fill() benchmark fills
+#define BENCH_PRNG_FILL_BYTES 64
+
+// the TIMER0 CC registers the SWI0 interrupt benchmarks use. The YakIO_TIMER 
+// class uses CC_0 and CC_1 so we take the other two
+#define BENCH_IRQ_START_CAPTURE  TIMERREG_OFFSET_CAPTURE_3
+#define BENCH_IRQ_START_CC       TIMERREG_OFFSET_CC_3
+#define BENCH_IRQ_ENTRY_CAPTURE  TIMERREG_OFFSET_CAPTURE_2
+#define BENCH_IRQ_ENTRY_CC       TIMERREG_OFFSET_CC_2
+
+// Each benchmark stores its result in the benchmarkResults[] array at 
+// the position given by its ID. The names printed for each one are in
+// benchmarkNames[] in Main.cpp and must be kept in the same order
+enum BENCHMARK_ID {
+    BENCH_LOOP_OVERHEAD=0,     // the cost of the empty timing loop itself (total cycles)
+    BENCH_GPIO_SET_HIGH,       // YakIO_GPIO::SetGPIOStateHigh() (cycles per call)
+    BENCH_GPIO_SET_LOW,        // YakIO_GPIO::SetGPIOStateLow() (cycles per call)
+    BENCH_GPIO_SET_STATE,      // YakIO_GPIO::SetGPIOState() (cycles per call)
+    BENCH_GPIO_TOGGLE,         // YakIO_GPIO::ToggleGPIOState() (cycles per call)
+    BENCH_GPIO_GET_STATE,      // YakIO_GPIO::GetGPIOState() (cycles per call)
+    BENCH_LED_REFRESH,         // YakIO_LEDARRAY::RefreshLEDArray() (cycles per call)
+    BENCH_LED_SET_IMAGE,       // YakIO_LEDARRAY::SetBinaryImage(), includes ProcessBackingStore() (cycles per call)
+    BENCH_LED_SET_STATE,       // YakIO_LEDARRAY::SetLEDState(), includes ProcessBackingStore() (cycles per call)
+    BENCH_CALLBACK_DISPATCH,   // YakIO_TIMER::CallCallback() to an empty Callback0() (cycles per call)
+    BENCH_RNG_VALUE,           // YakIO_RNG::GetRngValue() with no bias correction (cycles per call, 8 bits)
+    BENCH_PRNG_XORSHIFT32,     // YakIO_PRNG::GetNext() with PRNG_XORSHIFT32 (cycles per call, 32 bits)
+    BENCH_PRNG_XORSHIFT128,    // YakIO_PRNG::GetNext() with PRNG_XORSHIFT128 (cycles per call, 32 bits)
+    BENCH_PRNG_PCG32,          // YakIO_PRNG::GetNext() with PRNG_PCG32 (cycles per call, 32 bits)
+    BENCH_PRNG_RANGE,          // YakIO_PRNG::GetRange(100) with PRNG_XORSHIFT128 (cycles per call)
+    BENCH_PRNG_FILL,           // YakIO_PRNG::Fill() of BENCH_PRNG_FILL_BYTES with PRNG_XORSHIFT128 (cycles per call)
+    BENCH_IRQ_ENTRY,           // from pending SWI0 to the first line of its handler (cycles per interrupt)
+    BENCH_IRQ_ROUND_TRIP,      // from pending SWI0 until we are back from the handler (cycles per interrupt)
+    BENCH_CRITICAL_SECTION,    // an EnterCritical()/ExitCritical() pair (cycles per call)
+    BENCH_BOOT_CYCLES,         // the time the startup code took, see GetBootCycles() (total cycles)
+    BENCH_NUM_RESULTS          // not a benchmark, just the number of them
+};
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+        // the things being benchmarked. Note there is NO heartbeat in this 
+        // example. Nothing interrupts the benchmarks so the results are the
+        // same every time. The LED display is not refreshed so it stays dark
+        YakIO_LEDARRAY ledArray {};
+        YakIO_GPIO gpioOut {Pin0, PinDirOutput};
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        YakIO_RNG rngObj {};
+        YakIO_PRNG xorshift32Obj {PRNG_XORSHIFT32};
+        YakIO_PRNG xorshift128Obj {PRNG_XORSHIFT128};
+        YakIO_PRNG pcg32Obj {PRNG_PCG32};
+        unsigned char prngFillBuffer[BENCH_PRNG_FILL_BYTES];
+        // this timer never runs. We only use it to call CallCallback()
+        YakIO_TIMER callbackTimerObj {Timer1};
+
+        // TIMER0 is our stopwatch. It is set to count every cycle of the 
+        // 16MHz clock and never triggers an interrupt. We just read it
+        YakIO_TIMER cycleCounterObj {Timer0};
+
+        // the results are printed on the serial port
+        YakIO_UART uart {};
+
+        // the results
+        unsigned int benchmarkResults[BENCH_NUM_RESULTS];
+        // results of the benchmarked operations are written here so 
+        // the compiler cannot decide they are unused and throw them away
+        volatile unsigned int benchmarkSink = 0;
+
+        void StartCycleCounter(void);
+        unsigned int MeasureLoopOverhead(void);
+        unsigned int CyclesPerCall(unsigned int startCount, unsigned int endCount);
+        void RunGPIOBenchmarks(void);
+        void RunLEDArrayBenchmarks(void);
+        void RunCallbackBenchmarks(void);
+        void RunRngBenchmarks(void);
+        void RunPrngBenchmarks(void);
+        void RunIRQBenchmarks(void);
+        void PrintResults(void);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // the target of the CallCallback() benchmark. It does nothing
+        void Callback0(void) override;
+
+};
+
+#endif
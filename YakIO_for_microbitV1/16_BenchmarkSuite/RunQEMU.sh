@@ -0,0 +1,115 @@
+#!/bin/bash
+# +------------------------------------------------------------------------------------------------------------------------------+
+# ¦                                                   TERMS OF USE: MIT License                                                  ¦
+# +------------------------------------------------------------------------------------------------------------------------------¦
+# ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+# ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+# ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+# ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+# ¦                                                                                                                              ¦
+# ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+# ¦                                                                                                                              ¦
+# ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+# ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+# ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+# ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+# +------------------------------------------------------------------------------------------------------------------------------+
+
+# RunQEMU.sh - builds the 16_BenchmarkSuite example and runs it under the QEMU emulator, which has a model of the BBC micro:bit,
+# then prints the results. This lets you get benchmark numbers on any Linux box without a microbit plugged in and, because
+# the emulator is run in its deterministic -icount mode, the numbers are exactly the same every time. That makes them very 
+# good at spotting a change that made something slower.
+#
+# Usage (from this directory):
+#
+#    ./RunQEMU.sh                        - build, run and print the results
+#    ./RunQEMU.sh baseline.txt           - as above, then compare the results against a previous run saved in baseline.txt
+#    ./RunQEMU.sh > baseline.txt         - save a run to compare against later. Only the BENCH lines are printed on stdout
+#
+# The script exits with 1 if any result is more than TOLERANCE percent worse than the baseline, 2 if the run itself 
+# failed and 0 otherwise. Some environment variables change what it does:
+#
+#    PROFILE=release    - build with the release profile (see the Makefile). The default is debug
+#    TOLERANCE=5        - the percentage by which a result may get worse before it counts as a regression. The default is 2
+#    TIMEOUT=60         - the number of seconds to wait for the benchmarks to finish. The default is 30
+#    QEMU=path          - the qemu-system-arm to use. The default is the one on the path
+#
+# NOTE: QEMU does not emulate the Cortex-M0 pipeline. With -icount shift=N every instruction is simply taken to last 2^N 
+# nanoseconds and the TIMERs count in that "virtual" time. The numbers are therefore NOT the real cycle counts you would
+# see on a microbit - they are instruction counts in disguise. They are perfectly good for comparing one build with another,
+# which is all this script is for. Use a real microbit and a serial terminal at 115200 baud for the true figures. It is the 
+# same Main.hex either way.
+#
+# You need qemu-system-arm version 4.2 or later (that is when the microbit machine was added), the arm-none-eabi-gcc tools
+# and GNU make.
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+EXAMPLE_NAME="$(basename "$SCRIPT_DIR")"
+YAKIO_DIR="$(dirname "$SCRIPT_DIR")"
+PROFILE="${PROFILE:-debug}"
+TOLERANCE="${TOLERANCE:-2}"
+TIMEOUT="${TIMEOUT:-30}"
+QEMU="${QEMU:-qemu-system-arm}"
+ELF_FILE="$YAKIO_DIR/_build/$PROFILE/$EXAMPLE_NAME/Main.elf"
+RESULTS_FILE="$YAKIO_DIR/_build/$PROFILE/$EXAMPLE_NAME/qemu_results.txt"
+BASELINE_FILE="$1"
+
+# build it. The make output goes to stderr so stdout only ever has the results on it
+make -C "$YAKIO_DIR" EXAMPLE="$EXAMPLE_NAME" PROFILE="$PROFILE" 1>&2 || exit 2
+
+# run it. The microbit UART is the first serial port so with -nographic it comes out on stdout. The
+# -icount shift=6 makes every instruction take 64ns (about one cycle at 16MHz) of virtual time
+rm -f "$RESULTS_FILE"
+"$QEMU" -M microbit -nographic -icount shift=6 -kernel "$ELF_FILE" < /dev/null > "$RESULTS_FILE" 2>&1 &
+QEMU_PID=$!
+
+# the firmware never exits so we wait for it to say it is done and then stop the emulator
+SECONDS_WAITED=0
+while ! grep -q "BENCH_DONE" "$RESULTS_FILE" 2>/dev/null
+do
+    if ! kill -0 $QEMU_PID 2>/dev/null
+    then
+        echo "RunQEMU.sh: qemu exited before the benchmarks finished" 1>&2
+        cat "$RESULTS_FILE" 1>&2
+        exit 2
+    fi
+    if [ $SECONDS_WAITED -ge $TIMEOUT ]
+    then
+        echo "RunQEMU.sh: timed out after $TIMEOUT seconds" 1>&2
+        kill $QEMU_PID 2>/dev/null
+        exit 2
+    fi
+    sleep 1
+    SECONDS_WAITED=$((SECONDS_WAITED+1))
+done
+kill $QEMU_PID 2>/dev/null
+wait $QEMU_PID 2>/dev/null
+
+# the serial output has carriage returns in it
+grep "^BENCH " "$RESULTS_FILE" | tr -d '\r'
+
+# no baseline, we are done
+if [ -z "$BASELINE_FILE" ]; then exit 0; fi
+
+# compare with the baseline. A result is a regression if it is more than TOLERANCE percent bigger
+# than it was. BOOT_CYCLES and LOOP_OVERHEAD are reported but a change in them is never a failure.
+# Results that were 0 are compared as if they were 1 so a small absolute change is not a huge percentage
+grep "^BENCH " "$RESULTS_FILE" | tr -d '\r' | awk -v tolerance="$TOLERANCE" -v baselineFile="$BASELINE_FILE" '
+    BEGIN {
+        while ((getline line < baselineFile) > 0) {
+            split(line, fields, " ")
+            if (fields[1] == "BENCH") baseline[fields[2]] = fields[3]
+        }
+        failCount = 0
+    }
+    {
+        name = $2; value = $3
+        if (!(name in baseline)) { printf "NEW       %-20s %10d\n", name, value > "/dev/stderr"; next }
+        old = baseline[name]; if (old < 1) old = 1
+        change = ((value - old) * 100.0) / old
+        status = "OK"
+        if (change > tolerance && name != "BOOT_CYCLES" && name != "LOOP_OVERHEAD") { status = "REGRESSED"; failCount++ }
+        else if (change < -tolerance) status = "IMPROVED"
+        printf "%-9s %-20s %10d %10d %+8.1f%%\n", status, name, baseline[name], value, change > "/dev/stderr"
+    }
+    END { exit (failCount > 0) ? 1 : 0 }'
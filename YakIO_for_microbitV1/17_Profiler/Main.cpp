@@ -0,0 +1,144 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the sampling profiler.
+//
+// The MainLoop() does three kinds of pretend work over and over: some 
+// divides, some multiplies and some memset() calls. The Cortex-M0 has no
+// divide instruction so every divide is a call to a library function 
+// (__aeabi_uidiv) and you will see that function near the top of the
+// profile. The Heartbeat keeps the LED display going as usual.
+//
+// A YakIO_PROFILER samples where the program is about 1000 times a 
+// second. Every SAMPLES_PER_DUMP samples it prints what it found on the 
+// serial port at 115200 baud and starts again. Capture that with a serial
+// terminal and run
+//
+//    python3 ProfileReport.py Main.elf capture.txt
+//
+// from the directory above this one to see it by function name. 
+//
+// NOTE that the Heartbeat timer interrupt is moved down to 
+// IRQ_PRIORITY_High. Without that the profiler could never interrupt it
+// and the time spent in the Heartbeat would be hidden. See the note on
+// the PROFILER in YakIO_PROFILER.h.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteString("YAKIO PROFILER");
+    uart.WriteNewLine();
+
+    ledArray.ClearImage();
+
+    // set our Heartbeat going. See 02_BetterBlinky. It is below the 
+    // profiler so the profiler can see inside it
+    SetIRQPriority(IRQ_TIMER2, IRQ_PRIORITY_High);
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // and start sampling. 0 means the default interval
+    profiler.Start(0);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        DoDivideWork();
+        DoMultiplyWork();
+        DoMemoryWork();
+
+        // time to print what we have? Printing takes a while so we 
+        // stop sampling or the profile would be mostly the printing
+        if((profiler.GetSampleCount()>=SAMPLES_PER_DUMP) || (profiler.IsFull()!=0))
+        {
+            profiler.Stop();
+            profiler.Dump(uart);
+            profiler.Clear();
+            profiler.Start(0);
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* DoDivideWork - pretend work which does a lot of divides
+ * */
+void Main::DoDivideWork(void)
+{
+    unsigned int workTotal = 0;
+    for(unsigned int i=1; i<=DIVIDE_WORK_LOOPS; i++)
+    {
+        workTotal = workTotal + (0xFFFFFFFF/i);
+    }
+    workSink = workTotal;
+}
+
+/* DoMultiplyWork - pretend work which does a lot of multiplies. The 
+ *    Cortex-M0 has a one cycle multiplier so this should be much 
+ *    quicker than the divides
+ * */
+void Main::DoMultiplyWork(void)
+{
+    unsigned int workTotal = 1;
+    for(unsigned int i=1; i<=MULTIPLY_WORK_LOOPS; i++)
+    {
+        workTotal = (workTotal*1664525) + i;
+    }
+    workSink = workTotal;
+}
+
+/* DoMemoryWork - pretend work which clears a buffer over and over. See
+ *    YakIO_MEMORY.h for the memset() being used
+ * */
+void Main::DoMemoryWork(void)
+{
+    for(unsigned int i=0; i<MEMORY_WORK_LOOPS; i++)
+    {
+        memset(memoryWorkBuffer, i, MEMORY_WORK_BYTES);
+    }
+    workSink = memoryWorkBuffer[0];
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    // blink the middle LED about twice a second so we can see we 
+    // are alive
+    heartbeatCount++;
+    if((heartbeatCount & 0xFF)==0) ledArray.ToggleLEDState(2, 2);
+}
@@ -0,0 +1,145 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code to demonstrate the trace buffer.
+//
+// The MainLoop() does a short piece of pretend work and a long one over 
+// and over, marking the start and end of each with MarkBegin() and 
+// MarkEnd(). Meanwhile the Heartbeat interrupt keeps the LED display 
+// going and the RNG interrupts with a new random value every 100 
+// microseconds or so. Callback0() marks each value with Mark().
+//
+// Press ButtonA and the trace is stopped and sent out of the serial port
+// at 115200 baud, then started again. The buffer only holds the last 
+// TRACE_BUFFER_ENTRIES entries so what you get is the few milliseconds
+// before the button was pressed. Save it and run
+//
+//    python3 TraceToJson.py trace.bin names.txt > trace.json
+//
+// from the directory above this one. Open trace.json in Perfetto or 
+// chrome://tracing and you can see the work bars with the Heartbeat 
+// and RNG interrupts cutting into them. 
+//
+// NOTE the interrupt and callback entries are only there if the library
+// was compiled with YAKIO_TRACE defined - "make EXAMPLE=18_Trace TRACE=1". 
+// Without it you only see the Mark() entries.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+
+    ledArray.ClearImage();
+
+    // set our Heartbeat going. See 02_BetterBlinky.
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // Callback0() will be called with each new random value. See 07_Random
+    rngObj.SetCallback(CALLBACK_0, this);
+    rngObj.RngStart(); 
+
+    // and start recording
+    trace.Start();
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    unsigned int buttonWasDown = 0;
+    while(1)
+    {
+        trace.MarkBegin(TRACE_ID_SHORT_WORK);
+        DoWork(SHORT_WORK_LOOPS);
+        trace.MarkEnd(TRACE_ID_SHORT_WORK);
+
+        trace.MarkBegin(TRACE_ID_LONG_WORK);
+        DoWork(LONG_WORK_LOOPS);
+        trace.MarkEnd(TRACE_ID_LONG_WORK);
+
+        // send the trace when ButtonA is pressed. The trace is stopped 
+        // while it is sent or the sending would push everything out of 
+        // the buffer. We wait for the button to come back up before we 
+        // look for the next press
+        if(gpioButtonA.GetGPIOState() == 0)
+        {
+            buttonWasDown = 1;
+        }
+        else if(buttonWasDown != 0)
+        {
+            buttonWasDown = 0;
+            trace.Stop();
+            trace.Drain(uart, 0);
+            trace.Clear();
+            trace.Start();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* DoWork - pretend work which takes a while. Some divides, which are 
+ *    slow on the Cortex-M0
+ *
+ * inputs:
+ *    workLoops - how much work to do
+ * */
+void Main::DoWork(unsigned int workLoops)
+{
+    unsigned int workTotal = 0;
+    for(unsigned int i=1; i<=workLoops; i++)
+    {
+        workTotal = workTotal + (0xFFFFFFFF/i);
+    }
+    workSink = workTotal;
+}
+
+/* Callback0 - this is called from the RNG interrupt each time a new 
+ *    random value is ready. We just put it in the trace.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Be Quick!
+ * */
+void Main::Callback0(void)
+{
+    trace.Mark(TRACE_ID_RANDOM_VALUE, rngObj.GetRngValue());
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    // blink the middle LED about twice a second so we can see we 
+    // are alive
+    heartbeatCount++;
+    if((heartbeatCount & 0xFF)==0) ledArray.ToggleLEDState(2, 2);
+}
@@ -0,0 +1,96 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_RNG.h"
+#include "YakIO_UART.h"
+#include "YakIO_TRACE.h"
+
+// our own trace event IDs. Put these, with names, in a names.txt file 
+// for TraceToJson.py and the timeline will show the names
+#define TRACE_ID_SHORT_WORK   (TRACE_USER_FIRST_ID+0)
+#define TRACE_ID_LONG_WORK    (TRACE_USER_FIRST_ID+1)
+#define TRACE_ID_RANDOM_VALUE (TRACE_USER_FIRST_ID+2)
+// the sizes of the pretend work
+#define SHORT_WORK_LOOPS 64
+#define LONG_WORK_LOOPS  512
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+    
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // the random number generator, it interrupts us with each new value
+        YakIO_RNG rngObj {};
+
+        // the trace. TIMER0 provides the timestamps
+        YakIO_TRACE trace {Timer0};
+
+        // the trace is sent on the serial port
+        YakIO_UART uart {};
+
+        // ButtonA stops the trace and sends it
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+
+        // the pretend work writes its results here so the compiler 
+        // cannot decide they are unused and throw the work away
+        volatile unsigned int workSink = 0;
+
+        // counts the heartbeats, the display is changed now and then
+        unsigned int heartbeatCount = 0;
+
+        void DoWork(unsigned int workLoops);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+        // called by the RNG interrupt with each new random value
+        void Callback0(void) override;
+
+};
+
+#endif
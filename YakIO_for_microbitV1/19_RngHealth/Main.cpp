@@ -0,0 +1,169 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which measures how fast the RNG is with each combination of
+// hardware bias correction (DERCEN) and software conditioning, and checks 
+// it passes the health tests while it does it. See the notes on the 
+// HEALTH TESTS and CONDITIONING in YakIO_RNG.h.
+//
+// Each configuration runs the RNG pool for MEASURE_MS milliseconds while
+// the MainLoop() takes the bytes out as fast as they come. The counts are
+// printed on the serial port at 115200 baud, one line each:
+//
+//    RNGSTAT DERCEN=<0|1> COND=<name> RAW=<values/sec> OUT=<bytes/sec> FAIL=<failures>
+//
+// RAW is the number of values the hardware made, OUT the number of bytes
+// that came out of the conditioning into the pool. Then the quickest 
+// configuration with no health test failures is printed
+//
+//    RNGSTAT_BEST DERCEN=<0|1> COND=<name> OUT=<bytes/sec>
+//
+// and the whole thing starts again. The results vary a little every time,
+// the RNG timing depends on the noise it is sampling.
+
+// the configurations we try
+static const struct RngConfig rngConfigs[NUM_RNG_CONFIGS] = {
+    {RNG_DERCEN_DIS, RNG_CONDITIONING_NONE, "NONE"},
+    {RNG_DERCEN_ENA, RNG_CONDITIONING_NONE, "NONE"},
+    {RNG_DERCEN_DIS, RNG_CONDITIONING_VONNEUMANN, "VONNEUMANN"},
+    {RNG_DERCEN_ENA, RNG_CONDITIONING_VONNEUMANN, "VONNEUMANN"},
+    {RNG_DERCEN_DIS, RNG_CONDITIONING_HASH, "HASH"},
+    {RNG_DERCEN_ENA, RNG_CONDITIONING_HASH, "HASH"},
+};
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteString("YAKIO RNG HEALTH");
+    uart.WriteNewLine();
+
+    ledArray.ClearImage();
+
+    // set our Heartbeat going. See 02_BetterBlinky.
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        unsigned int bestIndex = NUM_RNG_CONFIGS;
+        unsigned int bestOutPerSecond = 0;
+        for(unsigned int i=0; i<NUM_RNG_CONFIGS; i++)
+        {
+            MeasureConfig(rngConfigs[i]);
+            PrintConfig("RNGSTAT", rngConfigs[i]);
+            uart.WriteString(" RAW=");
+            uart.WriteUnsigned(rawPerSecond);
+            uart.WriteString(" OUT=");
+            uart.WriteUnsigned(outPerSecond);
+            uart.WriteString(" FAIL=");
+            uart.WriteUnsigned(failureCount);
+            uart.WriteNewLine();
+
+            if((failureCount==0) && (outPerSecond>bestOutPerSecond))
+            {
+                bestIndex = i;
+                bestOutPerSecond = outPerSecond;
+            }
+        }
+
+        if(bestIndex<NUM_RNG_CONFIGS)
+        {
+            PrintConfig("RNGSTAT_BEST", rngConfigs[bestIndex]);
+            uart.WriteString(" OUT=");
+            uart.WriteUnsigned(bestOutPerSecond);
+        }
+        else uart.WriteString("RNGSTAT_BEST NONE");
+        uart.WriteNewLine();
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* MeasureConfig - runs the RNG pool with one configuration for 
+ *    MEASURE_MS milliseconds and keeps the counts
+ *
+ * inputs:
+ *    rngConfig - the configuration
+ * */
+void Main::MeasureConfig(const struct RngConfig &rngConfig)
+{
+    // the DERCEN and conditioning must be set while the RNG is stopped.
+    // PoolStart() zeroes the counts and the health tests
+    rngObj.PoolStop();
+    rngObj.SetDerCen(rngConfig.derCen);
+    rngObj.SetConditioning(rngConfig.conditioning);
+    rngObj.PoolStart();
+
+    // keep the pool empty until the time is up
+    unsigned char readBytes[POOL_READ_BYTES];
+    unsigned int startCount = heartbeatCount;
+    while((heartbeatCount-startCount)<MEASURE_MS)
+    {
+        if(rngObj.TryGetBytes(readBytes, POOL_READ_BYTES)!=0) readSink = readBytes[0];
+    }
+
+    rawPerSecond = rngObj.GetRawSampleCount();
+    outPerSecond = rngObj.GetPoolOutputCount();
+    failureCount = rngObj.GetHealthFailureCount();
+    rngObj.PoolStop();
+}
+
+/* PrintConfig - prints the start of a line with the configuration in it
+ *
+ * inputs:
+ *    prefixString - the first thing on the line
+ *    rngConfig - the configuration
+ * */
+void Main::PrintConfig(const char *prefixString, const struct RngConfig &rngConfig)
+{
+    uart.WriteString(prefixString);
+    uart.WriteString(" DERCEN=");
+    uart.WriteUnsigned(rngConfig.derCen);
+    uart.WriteString(" COND=");
+    uart.WriteString(rngConfig.conditioningName);
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    // blink the middle LED about twice a second so we can see we 
+    // are alive
+    heartbeatCount = heartbeatCount + 1;
+    if((heartbeatCount & 0xFF)==0) ledArray.ToggleLEDState(2, 2);
+}
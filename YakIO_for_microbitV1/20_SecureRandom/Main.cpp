@@ -0,0 +1,159 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which measures how many random bytes a second the AES-128 
+// CTR_DRBG makes. See the note on the DRBG in YakIO_DRBG.h.
+//
+// First the RNG pool is measured on its own, the MainLoop() taking the 
+// bytes out as fast as they come for MEASURE_MS milliseconds. Then the
+// same is done with the DRBG, which is seeded from that same pool. The 
+// counts are printed on the serial port at 115200 baud:
+//
+//    RNGRATE OUT=<bytes/sec>
+//    DRBGSTAT OUT=<bytes/sec> BLOCKS=<n> ROTATIONS=<n> RESEEDS=<n> RESTARTS=<n> SAMPLE=<hex>
+//
+// BLOCKS, ROTATIONS and RESEEDS are the totals since the DRBG was started,
+// RESTARTS the number of times the ECB had to start a block again. SAMPLE
+// is 32 bits of the output, just so you can see it change. The whole 
+// thing then starts again.
+//
+// NOTE: the DRBG buffer fills in the ECB interrupt. The bytes a second we
+// measure here are limited by how quickly the MainLoop() can take them out
+// as much as by how quickly the ECB can make them.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteString("YAKIO SECURE RANDOM");
+    uart.WriteNewLine();
+
+    ledArray.ClearImage();
+
+    // set our Heartbeat going. See 02_BetterBlinky.
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // the RNG pool is started by the DRBG if it is not running. We
+    // want the bias correction on for anything cryptographic
+    rngObj.SetDerCen(RNG_DERCEN_ENA);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        uart.WriteString("RNGRATE OUT=");
+        uart.WriteUnsigned(MeasureRng());
+        uart.WriteNewLine();
+
+        unsigned int drbgPerSecond = MeasureDrbg();
+        unsigned int sampleValue = 0;
+        while(drbgObj.GetU32(&sampleValue)==0);
+        uart.WriteString("DRBGSTAT OUT=");
+        uart.WriteUnsigned(drbgPerSecond);
+        uart.WriteString(" BLOCKS=");
+        uart.WriteUnsigned(drbgObj.GetBlockCount());
+        uart.WriteString(" ROTATIONS=");
+        uart.WriteUnsigned(drbgObj.GetKeyRotationCount());
+        uart.WriteString(" RESEEDS=");
+        uart.WriteUnsigned(drbgObj.GetReseedCount());
+        uart.WriteString(" RESTARTS=");
+        uart.WriteUnsigned(ecbObj.GetRestartCount());
+        uart.WriteString(" SAMPLE=");
+        uart.WriteHex(sampleValue);
+        uart.WriteNewLine();
+
+        // the DRBG wipes its state when it stops
+        drbgObj.Stop();
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* MeasureRng - runs the RNG pool for MEASURE_MS milliseconds and counts
+ *    the bytes we get out of it
+ *
+ * returns:
+ *    the bytes a second
+ * */
+unsigned int Main::MeasureRng(void)
+{
+    rngObj.PoolStart();
+
+    unsigned char readBytes[READ_BYTES];
+    unsigned int byteCount = 0;
+    unsigned int startCount = heartbeatCount;
+    while((heartbeatCount-startCount)<MEASURE_MS)
+    {
+        if(rngObj.TryGetBytes(readBytes, READ_BYTES)==0) continue;
+        readSink = readBytes[0];
+        byteCount = byteCount + READ_BYTES;
+    }
+    return byteCount;
+}
+
+/* MeasureDrbg - runs the DRBG for MEASURE_MS milliseconds and counts
+ *    the bytes we get out of it. The time it takes to seed is not counted
+ *
+ * returns:
+ *    the bytes a second
+ * */
+unsigned int Main::MeasureDrbg(void)
+{
+    unsigned char readBytes[READ_BYTES];
+    drbgObj.Start(&ecbObj, &rngObj);
+    // TryGetBytes() also tries the seed again while it waits
+    while(drbgObj.IsSeeded()==0) drbgObj.TryGetBytes(readBytes, READ_BYTES);
+
+    unsigned int byteCount = 0;
+    unsigned int startCount = heartbeatCount;
+    while((heartbeatCount-startCount)<MEASURE_MS)
+    {
+        if(drbgObj.TryGetBytes(readBytes, READ_BYTES)==0) continue;
+        readSink = readBytes[0];
+        byteCount = byteCount + READ_BYTES;
+    }
+    return byteCount;
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    // blink the middle LED about twice a second so we can see we 
+    // are alive
+    heartbeatCount = heartbeatCount + 1;
+    if((heartbeatCount & 0xFF)==0) ledArray.ToggleLEDState(2, 2);
+}
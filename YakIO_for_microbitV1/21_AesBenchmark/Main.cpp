@@ -0,0 +1,232 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which compares AES-128 in software with the ECB hardware.
+// See the notes on SOFTAES in YakIO_SOFTAES.h and AES in YakIO_AES.h.
+//
+// The results are printed on the serial port at 115200 baud, one per line
+// in the form
+//
+//    AESBENCH <name> <value>
+//
+// followed by a line containing just AESBENCH_DONE. Press ButtonA to run
+// them again. 
+//
+// The key and counter are the ones from NIST SP 800-38A F.5.1 - the first
+// 64 bytes of ECB_CTR output for the clear text there would match the 
+// document. We do not need that here, we just check the software and the
+// hardware agree.
+
+// the names printed for each result. These must be in AESBENCH_ID order 
+// (see Main.h) and must not contain spaces
+static const char *benchmarkNames[AESBENCH_NUM_RESULTS] = {
+    "SOFT_SET_KEY",
+    "SOFT_BLOCK",
+    "ECB_BLOCK",
+    "SOFT_CTR",
+    "ECB_CTR",
+    "ECB_CTR_STALLS",
+    "ECB_CTR_READY",
+    "RESULTS_MATCH"
+};
+
+static const unsigned char benchKey[AES_KEY_BYTES] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const unsigned char benchCounter[AES_BLOCK_BYTES] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    for(int i=0; i<AESBENCH_CTR_BYTES; i++) clearBytes[i] = (unsigned char)i;
+
+    // get the serial port going
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteNewLine();
+    uart.WriteString("YAKIO AES BENCHMARK");
+    uart.WriteNewLine();
+
+    // start our stopwatch
+    StartCycleCounter();
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    unsigned int buttonWasDown = 1;
+    while(1)
+    {
+        // run the benchmarks at the start and each time ButtonA is 
+        // pressed. See 16_BenchmarkSuite for the crude debounce
+        if(gpioButtonA.GetGPIOState() == 0)
+        {
+            buttonWasDown = 1;
+        }
+        else if(buttonWasDown != 0)
+        {
+            buttonWasDown = 0;
+            for(int i=0; i<AESBENCH_NUM_RESULTS; i++) benchmarkResults[i]=0;
+            RunBlockBenchmarks();
+            RunCtrBenchmarks();
+            PrintResults();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* StartCycleCounter - sets up TIMER0 as a free running 32 bit counter
+ *    which counts at the full 16MHz. See the 08_Benchmark example.
+ * */
+void Main::StartCycleCounter(void)
+{
+    cycleCounterObj.TimerStop();
+    cycleCounterObj.SetMode(TIMER_MODE_Timer);
+    cycleCounterObj.SetBitMode(TIMER_BITMODE_32Bit);
+    cycleCounterObj.SetPrescaler(0);
+    cycleCounterObj.TimerClear();
+    cycleCounterObj.TimerStart();
+}
+
+/* RunBlockBenchmarks - measures one block at a time, in software and on
+ *    the ECB
+ * */
+void Main::RunBlockBenchmarks(void)
+{
+    unsigned char cipherBlock[AES_BLOCK_BYTES];
+
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<AESBENCH_ITERATIONS; i++)
+    {
+        softAesObj.SetKey(benchKey);
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[AESBENCH_SOFT_SET_KEY] = (endCount-startCount) >> AESBENCH_ITERATIONS_SHL;
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<AESBENCH_ITERATIONS; i++)
+    {
+        softAesObj.EncryptBlock(clearBytes, cipherBlock);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[AESBENCH_SOFT_BLOCK] = (endCount-startCount) >> AESBENCH_ITERATIONS_SHL;
+
+    ecbObj.SetKey(benchKey);
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<AESBENCH_ITERATIONS; i++)
+    {
+        ecbObj.EncryptBlock(clearBytes, cipherBlock);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[AESBENCH_ECB_BLOCK] = (endCount-startCount) >> AESBENCH_ITERATIONS_SHL;
+
+    benchmarkSink = cipherBlock[0];
+}
+
+/* RunCtrBenchmarks - measures CTR mode encryption of AESBENCH_CTR_BYTES, 
+ *    in software and with YakIO_AES, and checks they agree
+ * */
+void Main::RunCtrBenchmarks(void)
+{
+    // the software one. The key was set in RunBlockBenchmarks()
+    unsigned int startCount = cycleCounterObj.GetCount();
+    SoftCtrEncrypt(benchCounter, clearBytes, softCipherBytes, AESBENCH_CTR_BYTES);
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[AESBENCH_SOFT_CTR] = (endCount-startCount) >> AESBENCH_CTR_BYTES_SHL;
+
+    // the hardware one. We time it from Start() so none of the keystream
+    // is made before the clock starts
+    startCount = cycleCounterObj.GetCount();
+    aesObj.Start(&ecbObj, benchKey, benchCounter);
+    aesObj.Encrypt(clearBytes, ecbCipherBytes, AESBENCH_CTR_BYTES);
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[AESBENCH_ECB_CTR] = (endCount-startCount) >> AESBENCH_CTR_BYTES_SHL;
+    benchmarkResults[AESBENCH_ECB_CTR_STALLS] = aesObj.GetStallCount();
+
+    // now let it fill the keystream buffer and time just the xor
+    while(aesObj.GetKeystreamCount()<AES_KEYSTREAM_BYTES);
+    startCount = cycleCounterObj.GetCount();
+    aesObj.Encrypt(clearBytes, ecbCipherBytes, AES_KEYSTREAM_BYTES);
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[AESBENCH_ECB_CTR_READY] = (endCount-startCount) / AES_KEYSTREAM_BYTES;
+    aesObj.Stop();
+
+    // that last one overwrote the start of ecbCipherBytes so do it again
+    aesObj.Start(&ecbObj, benchKey, benchCounter);
+    aesObj.Encrypt(clearBytes, ecbCipherBytes, AESBENCH_CTR_BYTES);
+    aesObj.Stop();
+    benchmarkResults[AESBENCH_RESULTS_MATCH] = 1;
+    for(int i=0; i<AESBENCH_CTR_BYTES; i++)
+    {
+        if(softCipherBytes[i]!=ecbCipherBytes[i]) benchmarkResults[AESBENCH_RESULTS_MATCH] = 0;
+    }
+}
+
+/* SoftCtrEncrypt - CTR mode done the simple way with YakIO_SOFTAES. This 
+ *    is what YakIO_AES does, without the ECB and without making the 
+ *    keystream ahead
+ *
+ * inputs:
+ *    counterBlock - the first counter block
+ *    inBuffer - the bytes to encrypt
+ *    outBuffer - where to put them
+ *    byteCount - the number of bytes
+ * */
+void Main::SoftCtrEncrypt(const unsigned char *counterBlock, const unsigned char *inBuffer, unsigned char *outBuffer, unsigned int byteCount)
+{
+    unsigned char counterBytes[AES_BLOCK_BYTES];
+    unsigned char keystreamBytes[AES_BLOCK_BYTES];
+    for(int i=0; i<AES_BLOCK_BYTES; i++) counterBytes[i] = counterBlock[i];
+
+    for(unsigned int done=0; done<byteCount; done=done+AES_BLOCK_BYTES)
+    {
+        softAesObj.EncryptBlock(counterBytes, keystreamBytes);
+        for(unsigned int i=0; (i<AES_BLOCK_BYTES) && ((done+i)<byteCount); i++)
+        {
+            outBuffer[done+i] = inBuffer[done+i] ^ keystreamBytes[i];
+        }
+        // the counter is a 128 bit big endian number
+        for(int i=AES_BLOCK_BYTES-1; i>=0; i--)
+        {
+            counterBytes[i] = counterBytes[i] + 1;
+            if(counterBytes[i]!=0) break;
+        }
+    }
+}
+
+/* PrintResults - prints every result on the serial port
+ * */
+void Main::PrintResults(void)
+{
+    for(int i=0; i<AESBENCH_NUM_RESULTS; i++)
+    {
+        uart.WriteString("AESBENCH ");
+        uart.WriteString(benchmarkNames[i]);
+        uart.WriteByte(' ');
+        uart.WriteUnsigned(benchmarkResults[i]);
+        uart.WriteNewLine();
+    }
+    uart.WriteString("AESBENCH_DONE");
+    uart.WriteNewLine();
+}
@@ -0,0 +1,108 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_ECB.h"
+#include "YakIO_AES.h"
+#include "YakIO_SOFTAES.h"
+#include "YakIO_UART.h"
+
+// the number of times we repeat each benchmarked operation. This is
+// a power of two so we can divide by it with a shift (the Cortex-M0
+// has no divide instruction)
+#define AESBENCH_ITERATIONS_SHL 4
+#define AESBENCH_ITERATIONS (1<<AESBENCH_ITERATIONS_SHL)
+// the size of the buffer the CTR benchmarks encrypt. Also a power of two
+#define AESBENCH_CTR_BYTES_SHL 8
+#define AESBENCH_CTR_BYTES (1<<AESBENCH_CTR_BYTES_SHL)
+
+// Each benchmark stores its result in the benchmarkResults[] array at 
+// the position given by its ID. The names printed for each one are in
+// benchmarkNames[] in Main.cpp and must be kept in the same order
+enum AESBENCH_ID {
+    AESBENCH_SOFT_SET_KEY=0,   // YakIO_SOFTAES::SetKey() (cycles per call)
+    AESBENCH_SOFT_BLOCK,       // YakIO_SOFTAES::EncryptBlock() (cycles per block)
+    AESBENCH_ECB_BLOCK,        // YakIO_ECB::EncryptBlock(), start and wait (cycles per block)
+    AESBENCH_SOFT_CTR,         // CTR mode with YakIO_SOFTAES (cycles per byte)
+    AESBENCH_ECB_CTR,          // YakIO_AES::Encrypt() of AESBENCH_CTR_BYTES (cycles per byte)
+    AESBENCH_ECB_CTR_STALLS,   // the times YakIO_AES::Encrypt() waited for the ECB during AESBENCH_ECB_CTR (total)
+    AESBENCH_ECB_CTR_READY,    // YakIO_AES::Encrypt() of AES_KEYSTREAM_BYTES already made (cycles per byte)
+    AESBENCH_RESULTS_MATCH,    // 1 if the software and the hardware CTR gave the same bytes
+    AESBENCH_NUM_RESULTS       // not a benchmark, just the number of them
+};
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+        // Note there is NO heartbeat in this example. Only the ECB 
+        // interrupt happens while the benchmarks run
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        YakIO_SOFTAES softAesObj {};
+        YakIO_ECB ecbObj {};
+        YakIO_AES aesObj {};
+
+        // TIMER0 is our stopwatch. See 16_BenchmarkSuite
+        YakIO_TIMER cycleCounterObj {Timer0};
+
+        // the results are printed on the serial port
+        YakIO_UART uart {};
+
+        // the data. The clear text is the same every time
+        unsigned char clearBytes[AESBENCH_CTR_BYTES];
+        unsigned char softCipherBytes[AESBENCH_CTR_BYTES];
+        unsigned char ecbCipherBytes[AESBENCH_CTR_BYTES];
+
+        // the results
+        unsigned int benchmarkResults[AESBENCH_NUM_RESULTS];
+        // results of the benchmarked operations are written here so 
+        // the compiler cannot decide they are unused and throw them away
+        volatile unsigned int benchmarkSink = 0;
+
+        void StartCycleCounter(void);
+        void RunBlockBenchmarks(void);
+        void RunCtrBenchmarks(void);
+        void SoftCtrEncrypt(const unsigned char *counterBlock, const unsigned char *inBuffer, unsigned char *outBuffer, unsigned int byteCount);
+        void PrintResults(void);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+
+};
+
+#endif
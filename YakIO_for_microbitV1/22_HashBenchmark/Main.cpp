@@ -0,0 +1,231 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which measures SHA-256 and HMAC-SHA256 in software. See 
+// the notes on SHA256 in YakIO_SHA256.h and HMAC in YakIO_HMAC.h.
+//
+// The results are printed on the serial port at 115200 baud, one per line
+// in the form
+//
+//    HASHBENCH <name> <value>
+//
+// followed by a line containing just HASHBENCH_DONE. Press ButtonA to run
+// them again. 
+//
+// To see what the unrolled schedule buys, add -DSHA256_UNROLL_SCHEDULE=1 
+// to the compile flags of both this program and YakIO_SHA256.cpp (see
+// CompileYakIO.bat) and run it again.
+
+// the names printed for each result. These must be in HASHBENCH_ID order 
+// (see Main.h) and must not contain spaces
+static const char *benchmarkNames[HASHBENCH_NUM_RESULTS] = {
+    "UNROLLED",
+    "SHA256_BLOCK",
+    "SHA256_PAGE",
+    "SHA256_STREAM",
+    "HMAC_START",
+    "HMAC_SHORT",
+    "SHA256_KAT",
+    "HMAC_KAT"
+};
+
+// FIPS 180-4 example B.1, the hash of "abc"
+static const unsigned char shaKatHash[SHA256_HASH_BYTES] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+// RFC 4231 test case 2. The key is "Jefe"
+static const unsigned char hmacKatMac[HMAC_MAC_BYTES] = {
+    0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+    0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+};
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    for(int i=0; i<HASHBENCH_PAGE_BYTES; i++) pageBytes[i] = (unsigned char)i;
+
+    // get the serial port going
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteNewLine();
+    uart.WriteString("YAKIO HASH BENCHMARK");
+    uart.WriteNewLine();
+
+    // start our stopwatch
+    StartCycleCounter();
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    unsigned int buttonWasDown = 1;
+    while(1)
+    {
+        // run the benchmarks at the start and each time ButtonA is 
+        // pressed. See 16_BenchmarkSuite for the crude debounce
+        if(gpioButtonA.GetGPIOState() == 0)
+        {
+            buttonWasDown = 1;
+        }
+        else if(buttonWasDown != 0)
+        {
+            buttonWasDown = 0;
+            for(int i=0; i<HASHBENCH_NUM_RESULTS; i++) benchmarkResults[i]=0;
+            benchmarkResults[HASHBENCH_UNROLLED] = SHA256_UNROLL_SCHEDULE;
+            RunSha256Benchmarks();
+            RunHmacBenchmarks();
+            RunKnownAnswerTests();
+            PrintResults();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* StartCycleCounter - sets up TIMER0 as a free running 32 bit counter
+ *    which counts at the full 16MHz. See the 08_Benchmark example.
+ * */
+void Main::StartCycleCounter(void)
+{
+    cycleCounterObj.TimerStop();
+    cycleCounterObj.SetMode(TIMER_MODE_Timer);
+    cycleCounterObj.SetBitMode(TIMER_BITMODE_32Bit);
+    cycleCounterObj.SetPrescaler(0);
+    cycleCounterObj.TimerClear();
+    cycleCounterObj.TimerStart();
+}
+
+/* RunSha256Benchmarks - measures one block and then a whole page, in 
+ *    one go and in small pieces
+ * */
+void Main::RunSha256Benchmarks(void)
+{
+    unsigned char hashBytes[SHA256_HASH_BYTES];
+
+    // whole blocks go straight to the compression function
+    sha256Obj.Start();
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<HASHBENCH_ITERATIONS; i++)
+    {
+        sha256Obj.Update(pageBytes, SHA256_BLOCK_BYTES);
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[HASHBENCH_SHA256_BLOCK] = (endCount-startCount) >> HASHBENCH_ITERATIONS_SHL;
+
+    startCount = cycleCounterObj.GetCount();
+    sha256Obj.Hash(pageBytes, HASHBENCH_PAGE_BYTES, hashBytes);
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[HASHBENCH_SHA256_PAGE] = (endCount-startCount) >> HASHBENCH_PAGE_BYTES_SHL;
+
+    // the same hash as it might arrive, every block has to be copied
+    startCount = cycleCounterObj.GetCount();
+    sha256Obj.Start();
+    for(unsigned int done=0; done<HASHBENCH_PAGE_BYTES; done=done+HASHBENCH_STREAM_BYTES)
+    {
+        sha256Obj.Update(&pageBytes[done], HASHBENCH_STREAM_BYTES);
+    }
+    sha256Obj.Finish(hashBytes);
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[HASHBENCH_SHA256_STREAM] = (endCount-startCount) >> HASHBENCH_PAGE_BYTES_SHL;
+
+    benchmarkSink = hashBytes[0];
+}
+
+/* RunHmacBenchmarks - measures setting the key and the HMAC of a short
+ *    message, which is what checking a command costs
+ * */
+void Main::RunHmacBenchmarks(void)
+{
+    unsigned char macBytes[HMAC_MAC_BYTES];
+
+    unsigned int startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<HASHBENCH_ITERATIONS; i++)
+    {
+        hmacObj.Start(pageBytes, 32);
+    }
+    unsigned int endCount = cycleCounterObj.GetCount();
+    benchmarkResults[HASHBENCH_HMAC_START] = (endCount-startCount) >> HASHBENCH_ITERATIONS_SHL;
+
+    startCount = cycleCounterObj.GetCount();
+    for(unsigned int i=0; i<HASHBENCH_ITERATIONS; i++)
+    {
+        hmacObj.Update(&pageBytes[32], 32);
+        hmacObj.Finish(macBytes);
+    }
+    endCount = cycleCounterObj.GetCount();
+    benchmarkResults[HASHBENCH_HMAC_SHORT] = (endCount-startCount) >> HASHBENCH_ITERATIONS_SHL;
+
+    hmacObj.Stop();
+    benchmarkSink = macBytes[0];
+}
+
+/* RunKnownAnswerTests - checks the answers are right. A fast wrong hash 
+ *    is no use to anybody
+ * */
+void Main::RunKnownAnswerTests(void)
+{
+    unsigned char hashBytes[SHA256_HASH_BYTES];
+
+    sha256Obj.Hash((const unsigned char *)"abc", 3, hashBytes);
+    benchmarkResults[HASHBENCH_SHA256_KAT] = BytesMatch(hashBytes, shaKatHash, SHA256_HASH_BYTES);
+
+    hmacObj.Start((const unsigned char *)"Jefe", 4);
+    hmacObj.Update((const unsigned char *)"what do ya want ", 16);
+    hmacObj.Update((const unsigned char *)"for nothing?", 12);
+    benchmarkResults[HASHBENCH_HMAC_KAT] = hmacObj.FinishAndCheck(hmacKatMac, HMAC_MAC_BYTES);
+    hmacObj.Stop();
+}
+
+/* BytesMatch - compares two buffers
+ *
+ * inputs:
+ *    firstBytes - one buffer
+ *    secondBytes - the other
+ *    byteCount - the number of bytes to compare
+ * returns:
+ *    1 if they are the same, 0 if not
+ * */
+unsigned int Main::BytesMatch(const unsigned char *firstBytes, const unsigned char *secondBytes, unsigned int byteCount)
+{
+    for(unsigned int i=0; i<byteCount; i++)
+    {
+        if(firstBytes[i]!=secondBytes[i]) return 0;
+    }
+    return 1;
+}
+
+/* PrintResults - prints every result on the serial port
+ * */
+void Main::PrintResults(void)
+{
+    for(int i=0; i<HASHBENCH_NUM_RESULTS; i++)
+    {
+        uart.WriteString("HASHBENCH ");
+        uart.WriteString(benchmarkNames[i]);
+        uart.WriteByte(' ');
+        uart.WriteUnsigned(benchmarkResults[i]);
+        uart.WriteNewLine();
+    }
+    uart.WriteString("HASHBENCH_DONE");
+    uart.WriteNewLine();
+}
@@ -0,0 +1,109 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_SHA256.h"
+#include "YakIO_HMAC.h"
+#include "YakIO_UART.h"
+
+// the number of times we repeat each benchmarked operation. This is
+// a power of two so we can divide by it with a shift (the Cortex-M0
+// has no divide instruction)
+#define HASHBENCH_ITERATIONS_SHL 4
+#define HASHBENCH_ITERATIONS (1<<HASHBENCH_ITERATIONS_SHL)
+// the size of the buffer the page benchmarks hash. A flash page on the 
+// nRF51822 is 1024 bytes. Also a power of two
+#define HASHBENCH_PAGE_BYTES_SHL 10
+#define HASHBENCH_PAGE_BYTES (1<<HASHBENCH_PAGE_BYTES_SHL)
+// the piece size for the streaming benchmark, about what a UART command 
+// might arrive in
+#define HASHBENCH_STREAM_BYTES 16
+
+// Each benchmark stores its result in the benchmarkResults[] array at 
+// the position given by its ID. The names printed for each one are in
+// benchmarkNames[] in Main.cpp and must be kept in the same order
+enum HASHBENCH_ID {
+    HASHBENCH_UNROLLED=0,      // the SHA256_UNROLL_SCHEDULE it was built with (0 or 1)
+    HASHBENCH_SHA256_BLOCK,    // YakIO_SHA256::Update() of one 64 byte block (cycles per block)
+    HASHBENCH_SHA256_PAGE,     // a whole hash of HASHBENCH_PAGE_BYTES in one Update() (cycles per byte)
+    HASHBENCH_SHA256_STREAM,   // the same with Update() HASHBENCH_STREAM_BYTES at a time (cycles per byte)
+    HASHBENCH_HMAC_START,      // YakIO_HMAC::Start() with a 32 byte key (cycles per call)
+    HASHBENCH_HMAC_SHORT,      // the HMAC of a 32 byte message, key already set (cycles per message)
+    HASHBENCH_SHA256_KAT,      // 1 if the hash of "abc" is the one in FIPS 180-4
+    HASHBENCH_HMAC_KAT,        // 1 if RFC 4231 test case 2 gives the right HMAC
+    HASHBENCH_NUM_RESULTS      // not a benchmark, just the number of them
+};
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+        // Note there is NO heartbeat in this example. Nothing interrupts
+        // the benchmarks
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+        YakIO_SHA256 sha256Obj {};
+        YakIO_HMAC hmacObj {};
+
+        // TIMER0 is our stopwatch. See 16_BenchmarkSuite
+        YakIO_TIMER cycleCounterObj {Timer0};
+
+        // the results are printed on the serial port
+        YakIO_UART uart {};
+
+        // the data. It is the same every time
+        unsigned char pageBytes[HASHBENCH_PAGE_BYTES];
+
+        // the results
+        unsigned int benchmarkResults[HASHBENCH_NUM_RESULTS];
+        // results of the benchmarked operations are written here so 
+        // the compiler cannot decide they are unused and throw them away
+        volatile unsigned int benchmarkSink = 0;
+
+        void StartCycleCounter(void);
+        void RunSha256Benchmarks(void);
+        void RunHmacBenchmarks(void);
+        void RunKnownAnswerTests(void);
+        unsigned int BytesMatch(const unsigned char *firstBytes, const unsigned char *secondBytes, unsigned int byteCount);
+        void PrintResults(void);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+
+};
+
+#endif
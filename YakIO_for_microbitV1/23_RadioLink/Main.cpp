@@ -0,0 +1,183 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which sends packets between two micro:bits with the 2.4GHz
+// RADIO. See the note on the RADIO in YakIO_RADIO.h. Load the same program
+// onto both of them.
+//
+// Each one sends a LINK_PACKET_BYTES packet every BEACON_MS milliseconds,
+// the tag "YAK!" followed by a sequence number, and listens the rest of 
+// the time. Every packet heard with the tag on it is printed on the serial
+// port at 115200 baud
+//
+//    RADIOLINK RX SEQ=<sequence number> RSSI=-<dBm>
+//
+// and the bottom row of LEDs shows the low 5 bits of the sequence number. 
+// Once a second the counts are printed
+//
+//    RADIOLINK STATS RX=<good packets> TX=<sent> CRC=<bad CRC> DROP=<dropped>
+//
+// ButtonA sends BURST_PACKETS packets as fast as the RADIO will go. The 
+// other micro:bit should hear every one of them - DROP only goes up if it
+// is still printing one packet when the next two have arrived.
+
+// the tag on the front of every packet we send
+static const unsigned char linkTag[LINK_TAG_BYTES] = {'Y', 'A', 'K', '!'};
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteString("YAKIO RADIO LINK");
+    uart.WriteNewLine();
+
+    ledArray.ClearImage();
+
+    // the defaults are fine apart from the channel. That has to be set 
+    // before we start listening
+    radioObj.Start();
+    radioObj.SetFrequency(LINK_FREQUENCY);
+    radioObj.StartReceive();
+
+    // set our Heartbeat going. See 02_BetterBlinky.
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        // look at the packet in place and hand it straight back
+        struct YakIO_RADIOPACKET *packetPtr = radioObj.GetReceivedPacket();
+        if(packetPtr!=NULL)
+        {
+            HandlePacket(packetPtr);
+            radioObj.ReleasePacket();
+        }
+
+        if(beaconIsDue!=0)
+        {
+            beaconIsDue = 0;
+            SendPacket();
+        }
+
+        if(buttonAHasBeenPressed!=0)
+        {
+            buttonAHasBeenPressed = 0;
+            for(unsigned int i=0; i<BURST_PACKETS; i++)
+            {
+                // each one has to go before the next can start
+                while(radioObj.IsTransmitting()!=0);
+                SendPacket();
+            }
+        }
+
+        if(statsAreDue!=0)
+        {
+            statsAreDue = 0;
+            PrintStats();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* SendPacket - sends the tag and the next sequence number. If the last
+ *    packet has not gone yet this one is skipped
+ * */
+void Main::SendPacket(void)
+{
+    unsigned char packetBytes[LINK_PACKET_BYTES];
+    for(unsigned int i=0; i<LINK_TAG_BYTES; i++) packetBytes[i] = linkTag[i];
+    packetBytes[LINK_TAG_BYTES] = sequenceNumber;
+    if(radioObj.Transmit(packetBytes, LINK_PACKET_BYTES)!=0) sequenceNumber = sequenceNumber + 1;
+}
+
+/* HandlePacket - prints a packet and shows its sequence number, if it 
+ *    is one of ours
+ *
+ * inputs:
+ *    packetPtr - the packet, still in the RADIO receive buffer
+ * */
+void Main::HandlePacket(struct YakIO_RADIOPACKET *packetPtr)
+{
+    if(packetPtr->lengthByte!=LINK_PACKET_BYTES) return;
+    for(unsigned int i=0; i<LINK_TAG_BYTES; i++)
+    {
+        if(packetPtr->payloadBytes[i]!=linkTag[i]) return;
+    }
+
+    unsigned int packetSequence = packetPtr->payloadBytes[LINK_TAG_BYTES];
+    uart.WriteString("RADIOLINK RX SEQ=");
+    uart.WriteUnsigned(packetSequence);
+    uart.WriteString(" RSSI=-");
+    uart.WriteUnsigned(radioObj.GetPacketRssi());
+    uart.WriteNewLine();
+
+    // the bottom row, most significant bit on the left
+    for(unsigned int col=0; col<5; col++)
+    {
+        ledArray.SetLEDState(4, col, (packetSequence>>(4-col)) & 0x01);
+    }
+}
+
+/* PrintStats - prints the RADIO counts
+ * */
+void Main::PrintStats(void)
+{
+    uart.WriteString("RADIOLINK STATS RX=");
+    uart.WriteUnsigned(radioObj.GetRxPacketCount());
+    uart.WriteString(" TX=");
+    uart.WriteUnsigned(radioObj.GetTxPacketCount());
+    uart.WriteString(" CRC=");
+    uart.WriteUnsigned(radioObj.GetCrcErrorCount());
+    uart.WriteString(" DROP=");
+    uart.WriteUnsigned(radioObj.GetDroppedPacketCount());
+    uart.WriteNewLine();
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    msCount = msCount + 1;
+    if((msCount % BEACON_MS)==0) beaconIsDue = 1;
+    if((msCount % 1000)==0) statsAreDue = 1;
+
+    // ButtonA is active low. We act on the release, see 06_deBounce
+    unsigned int currentState = gpioButtonA.GetGPIOState();
+    if((currentState==1) && (buttonAState==0)) buttonAHasBeenPressed = 1;
+    buttonAState = currentState;
+}
@@ -0,0 +1,156 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which keeps micro:bits on one clock with RADIO beacons. See
+// the note on TIME SYNC in YakIO_TIMESYNC.h. Load the same program onto 
+// all of them.
+//
+// Every board starts as a follower. ButtonA makes a board the reference,
+// it then sends a beacon every BEACON_MS milliseconds. Only press it on 
+// one board! The top left LED flashes on every board when the network 
+// time passes a multiple of 2^20 microseconds - they should flash 
+// together. Once a second this is printed on the serial port at 115200
+// baud
+//
+//    TIMESYNC ROLE=<REF|FOLLOW> SYNC=<0|1> NET=<network time> SKEW=<ppb> ERR=<us> BEACONS=<count>
+//
+// SKEW is how much faster the reference's crystal runs than ours, ERR 
+// how far out our network time was when the last beacon came in.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteString("YAKIO TIME SYNC");
+    uart.WriteNewLine();
+
+    ledArray.ClearImage();
+
+    radioObj.Start();
+    radioObj.StartReceive();
+    timeSyncObj.Start(TIMESYNC_ROLE_FOLLOWER);
+
+    // set our Heartbeat going. See 02_BetterBlinky.
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        // every packet goes past the time sync, it takes the beacons
+        struct YakIO_RADIOPACKET *packetPtr = radioObj.GetReceivedPacket();
+        if(packetPtr!=NULL)
+        {
+            timeSyncObj.ProcessPacket(packetPtr);
+            radioObj.ReleasePacket();
+        }
+
+        if(buttonAHasBeenPressed!=0)
+        {
+            buttonAHasBeenPressed = 0;
+            if(timeSyncObj.GetRole()!=TIMESYNC_ROLE_REFERENCE) timeSyncObj.Start(TIMESYNC_ROLE_REFERENCE);
+        }
+
+        if(beaconIsDue!=0)
+        {
+            beaconIsDue = 0;
+            timeSyncObj.SendBeacon();
+        }
+
+        // the flash. Done here, not in the Heartbeat, because the network
+        // time must not be read from an interrupt
+        unsigned int ledState = 0;
+        if((timeSyncObj.IsSynchronized()!=0) && ((timeSyncObj.GetNetworkTime() & FLASH_PERIOD_MASK)<FLASH_ON_TICKS)) ledState = 1;
+        ledArray.SetLEDState(0, 0, ledState);
+
+        if(statsAreDue!=0)
+        {
+            statsAreDue = 0;
+            PrintStats();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* PrintSigned - prints a number which might be negative
+ *
+ * inputs:
+ *    numberValue - the number
+ * */
+void Main::PrintSigned(int numberValue)
+{
+    if(numberValue<0)
+    {
+        uart.WriteByte('-');
+        numberValue = -numberValue;
+    }
+    uart.WriteUnsigned(numberValue);
+}
+
+/* PrintStats - prints the time sync state
+ * */
+void Main::PrintStats(void)
+{
+    uart.WriteString("TIMESYNC ROLE=");
+    if(timeSyncObj.GetRole()==TIMESYNC_ROLE_REFERENCE) uart.WriteString("REF");
+    else uart.WriteString("FOLLOW");
+    uart.WriteString(" SYNC=");
+    uart.WriteUnsigned(timeSyncObj.IsSynchronized());
+    uart.WriteString(" NET=");
+    uart.WriteUnsigned(timeSyncObj.GetNetworkTime());
+    uart.WriteString(" SKEW=");
+    PrintSigned(timeSyncObj.GetSkewPpb());
+    uart.WriteString(" ERR=");
+    PrintSigned(timeSyncObj.GetLastSyncError());
+    uart.WriteString(" BEACONS=");
+    uart.WriteUnsigned(timeSyncObj.GetBeaconCount());
+    uart.WriteNewLine();
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    msCount = msCount + 1;
+    if((msCount % BEACON_MS)==0) beaconIsDue = 1;
+    if((msCount % 1000)==0) statsAreDue = 1;
+
+    // ButtonA is active low. We act on the release, see 06_deBounce
+    unsigned int currentState = gpioButtonA.GetGPIOState();
+    if((currentState==1) && (buttonAState==0)) buttonAHasBeenPressed = 1;
+    buttonAState = currentState;
+}
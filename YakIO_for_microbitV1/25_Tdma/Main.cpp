@@ -0,0 +1,160 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "Main.h"
+
+// EXAMPLE code which shares the RADIO between micro:bits with time slots.
+// See the note on TDMA in YakIO_TDMA.h. Load the same program onto all
+// of them.
+//
+// Every board starts as a node looking for a coordinator. ButtonA makes 
+// a board the coordinator. Only press it on one board! The nodes join and
+// each one sends a reading, a count of its own, every READING_MS 
+// milliseconds. The top left LED is on while a board has a slot (or is 
+// the coordinator). Once a second this is printed on the serial port at 
+// 115200 baud
+//
+//    TDMA ROLE=<COORD|NODE> STATE=<state> SLOT=<slot> NODES=<count> SUPERFRAME=<us> RX=<count> SENT=<count> MISSED=<count>
+//
+// RX is the readings the coordinator has received, SENT the ones a node
+// has sent. MISSED counts RADIO windows that could not be set up in time,
+// it should stay at zero.
+
+/* MainLoop. This is where the user program starts. This function should
+ *     contain a loop that never exits. We can NEVER return from here!
+ * */
+void Main::MainLoop(void)
+{    
+    // #
+    // # We do setup now
+    // #
+
+    uart.Start(UART_BAUDRATE_115200);
+    uart.WriteString("YAKIO TDMA");
+    uart.WriteNewLine();
+
+    ledArray.ClearImage();
+
+    // the TDMA drives the RADIO itself, we just start it
+    radioObj.Start();
+    unsigned int nodeId = YAKIO_REGISTER(REGISTER_FICR+FICR_OFFSET_DEVICEID0);
+    tdmaObj.Start(TDMA_ROLE_NODE, nodeId);
+
+    // set our Heartbeat going. See 02_BetterBlinky.
+    heartbeatObj.QuickSetup(4, 1000, HEARTBEAT, this);
+
+    // #
+    // # We enter the main control loop 
+    // #
+         
+    while(1)
+    {
+        // the beacons and joins are dealt with inside, we only 
+        // ever see the data
+        struct YakIO_RADIOPACKET *packetPtr = tdmaObj.GetReceivedData();
+        if(packetPtr!=NULL)
+        {
+            receivedCount = receivedCount + 1;
+            tdmaObj.ReleaseData();
+        }
+
+        if(buttonAHasBeenPressed!=0)
+        {
+            buttonAHasBeenPressed = 0;
+            if(tdmaObj.GetRole()!=TDMA_ROLE_COORDINATOR) tdmaObj.Start(TDMA_ROLE_COORDINATOR, nodeId);
+        }
+
+        if(readingIsDue!=0)
+        {
+            readingIsDue = 0;
+            // if the last one has not gone yet we just skip this one
+            if((tdmaObj.GetState()==TDMA_STATE_JOINED) && (tdmaObj.IsDataQueued()==0))
+            {
+                unsigned char readingBytes[4];
+                for(int i=0; i<4; i++) readingBytes[i] = (readingCount>>(8*i)) & 0xFF;
+                if(tdmaObj.QueueData(readingBytes, 4)!=0) readingCount = readingCount + 1;
+            }
+        }
+
+        unsigned int ledState = 0;
+        if((tdmaObj.GetState()==TDMA_STATE_JOINED) || (tdmaObj.GetState()==TDMA_STATE_COORDINATING)) ledState = 1;
+        ledArray.SetLEDState(0, 0, ledState);
+
+        if(statsAreDue!=0)
+        {
+            statsAreDue = 0;
+            PrintStats();
+        }
+    } // bottom of while(1)
+} // bottom of Main::MainLoop()
+
+/* PrintStats - prints the TDMA state
+ * */
+void Main::PrintStats(void)
+{
+    uart.WriteString("TDMA ROLE=");
+    if(tdmaObj.GetRole()==TDMA_ROLE_COORDINATOR) uart.WriteString("COORD");
+    else uart.WriteString("NODE");
+    uart.WriteString(" STATE=");
+    switch(tdmaObj.GetState())
+    {
+        case TDMA_STATE_SEARCHING: uart.WriteString("SEARCHING"); break;
+        case TDMA_STATE_JOINING: uart.WriteString("JOINING"); break;
+        case TDMA_STATE_JOINED: uart.WriteString("JOINED"); break;
+        case TDMA_STATE_COORDINATING: uart.WriteString("COORDINATING"); break;
+        default: uart.WriteString("STOPPED"); break;
+    }
+    uart.WriteString(" SLOT=");
+    if(tdmaObj.GetSlot()==TDMA_NO_SLOT) uart.WriteString("-");
+    else uart.WriteUnsigned(tdmaObj.GetSlot());
+    uart.WriteString(" NODES=");
+    uart.WriteUnsigned(tdmaObj.GetNodeCount());
+    uart.WriteString(" SUPERFRAME=");
+    uart.WriteUnsigned(tdmaObj.GetSuperframeTicks());
+    uart.WriteString(" RX=");
+    uart.WriteUnsigned(receivedCount);
+    uart.WriteString(" SENT=");
+    uart.WriteUnsigned(tdmaObj.GetSentDataCount());
+    uart.WriteString(" MISSED=");
+    uart.WriteUnsigned(tdmaObj.GetMissedWindowCount());
+    uart.WriteNewLine();
+}
+
+/* Heartbeat - this is a callback function which gets called when the timer 
+ *    triggers. We used enum CALLBACK_ID.HEARTBEAT when we created the 
+ *    timer therefore this function MUST be named Heartbeat(). 
+ * 
+ *    See the 02_BetterBlinky example for a complete discussion.
+ * 
+ *    NOTE: You are in an INTERRUPT in here! Remember that the mainloop() 
+ *    is stalled while this function is executing - do NOT call really 
+ *    long running things in here. Be Quick!
+ * 
+ * */
+void Main::Heartbeat(void)
+{
+    // keep the display going. See the 02_BetterBlinky example.
+    ledArray.RefreshLEDArray();    
+
+    msCount = msCount + 1;
+    if((msCount % READING_MS)==0) readingIsDue = 1;
+    if((msCount % 1000)==0) statsAreDue = 1;
+
+    // ButtonA is active low. We act on the release, see 06_deBounce
+    unsigned int currentState = gpioButtonA.GetGPIOState();
+    if((currentState==1) && (buttonAState==0)) buttonAHasBeenPressed = 1;
+    buttonAState = currentState;
+}
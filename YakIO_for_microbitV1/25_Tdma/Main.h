@@ -0,0 +1,94 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "YakIO.h"
+#include "YakIO_LEDARRAY.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_TIMESYNC.h"
+#include "YakIO_TDMA.h"
+#include "YakIO_UART.h"
+
+// how often a node queues a reading, in milliseconds
+#define READING_MS 250
+// the first word of the FICR DEVICEID. Every nRF51 is given a random 64
+// bit one at the factory, the first 32 bits make a good enough node id
+#define FICR_OFFSET_DEVICEID0 0x060
+
+/* Main - your program starts with a call to MainLoop() and all 
+ *        global objects should be owned by this class
+ * 
+ *        NOTE: Class variables declared on the heap (ie outside of a class) do have
+ *        their constructors run by the startup code, but the order in which that happens
+ *        across different .cpp files is not defined.
+ * 
+ *        Instantiate all classes inside some other class. If a class is instantiated
+ *        at runtime (as opposed to compile time) the constructors run in the order the
+ *        objects are declared.
+ * 
+ *        You might wish to review the "03_Danger" sample code to see what happens 
+ *        when you create classes with constructors on the heap.
+ *       
+ * */
+class Main : public YakIO_CALLBACK // we inherit from this class which functions as an interface
+{ 
+    private:
+    
+        // this class controls the 5x5 LED display
+        YakIO_LEDARRAY ledArray {};
+        
+        // the heartbeat is a 1 millisecond tick that enables us 
+        // to do periodic things. TIMER2 is typically used for the heartbeat.
+        // TIMER0 belongs to the timeSyncObj
+        YakIO_TIMER heartbeatObj {Timer2};
+
+        // create an input GPIO so we can read button A
+        YakIO_GPIO gpioButtonA {ButtonA, PinDirInput};
+
+        // the 2.4GHz radio, the time sync and the TDMA on top of them both
+        YakIO_RADIO radioObj {};
+        YakIO_TIMESYNC timeSyncObj {&radioObj};
+        YakIO_TDMA tdmaObj {&radioObj, &timeSyncObj};
+
+        // the results are printed on the serial port
+        YakIO_UART uart {};
+
+        // set in the Heartbeat, cleared in the MainLoop() so volatile
+        volatile unsigned int readingIsDue = 0;
+        volatile unsigned int statsAreDue = 0;
+        volatile unsigned int buttonAHasBeenPressed = 0;
+        unsigned int buttonAState = 1;
+        unsigned int msCount = 0;
+        unsigned int readingCount = 0;
+        unsigned int receivedCount = 0;
+
+        void PrintStats(void);
+        
+    public:
+        // this needs to be public because the CreateMainObject() function in program.cpp 
+        // calls it. See that code to better understand what is going on here.
+        void MainLoop(void);
+        // Our heartbeat. See 02_BetterBlinky for detailed comments
+        void Heartbeat(void) override;
+
+};
+
+#endif
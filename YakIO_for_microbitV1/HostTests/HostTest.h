@@ -0,0 +1,153 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef HOSTTEST_H
+#define HOSTTEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include "YakIO.h"
+#include "YakIO_HOSTREGISTERS.h"
+
+// A note on the HOST TESTS. Every .cpp file in this directory is a small program with its
+// own main(). "make host-test" builds each one against _build/host/libYakIO.a (see the note
+// on THE HOST BUILD in the Makefile) and runs it. A test returns 0 if everything passed and
+// 1 if anything failed, so make stops with an error and so will any CI job that runs it.
+// No microbit is needed. 
+//
+// There are two kinds of check in here:
+//
+//    Known answers - a published input and the output it must give (the FIPS 180-4 
+//       SHA-256 examples, the RFC 3610 CCM packets etc). If one of these fails the code
+//       is simply wrong.
+//    Costs - the number of register reads and writes a function makes. See the note on 
+//       the HOST REGISTER FILE in YakIO_HOSTREGISTERS.h. These are deliberately exact. If
+//       a change makes one bigger the test fails and you have to decide whether the 
+//       extra accesses are worth it - then change the number in the test.
+//
+// A test is just a list of HOSTTEST_CHECK()s followed by "return HostTestFinish(name);". A 
+// failed check prints the file, the line and the condition and the test carries on so you
+// see everything that is wrong at once.
+//
+// Example:
+//      int main(void)
+//      {
+//          hostRegisters.Reset();
+//          YakIO_LEDARRAY ledArray;
+//          hostRegisters.ResetCounters();
+//          ledArray.SetLEDState(1, 1, 1);
+//          HOSTTEST_CHECK(hostRegisters.GetWriteCount()==0);
+//          return HostTestFinish("LEDARRAY");
+//      }
+
+#define HOSTTEST_CHECK(testCondition) HostTestCheck((testCondition), #testCondition, __FILE__, __LINE__)
+#define HOSTTEST_CHECK_BYTES(actualBytes, expectedBytes, byteCount) HostTestCheckBytes((actualBytes), (expectedBytes), (byteCount), #actualBytes, __FILE__, __LINE__)
+
+// the number of checks made and how many of them failed
+inline unsigned int hostTestCheckCount = 0;
+inline unsigned int hostTestFailCount = 0;
+
+/* HostTestCheck - counts a check and prints it if it failed. Use the
+ *    HOSTTEST_CHECK() macro rather than calling this
+ *
+ * inputs:
+ *    conditionIsTrue - the result of the check
+ *    conditionText - the check as it was written
+ *    fileName - the file it is in
+ *    lineNumber - the line it is on
+ * */
+inline void HostTestCheck(bool conditionIsTrue, const char *conditionText, const char *fileName, int lineNumber)
+{
+    hostTestCheckCount++;
+    if(conditionIsTrue) return;
+    hostTestFailCount++;
+    printf("%s:%d: FAILED %s\n", fileName, lineNumber, conditionText);
+}
+
+/* HostTestCheckBytes - checks two blocks of bytes are the same and prints
+ *    both if they are not. Use the HOSTTEST_CHECK_BYTES() macro
+ *
+ * inputs:
+ *    actualBytes - what the code produced
+ *    expectedBytes - what it should have produced
+ *    byteCount - the number of bytes to compare
+ *    actualText - the name of the actualBytes as it was written
+ *    fileName - the file it is in
+ *    lineNumber - the line it is on
+ * */
+inline void HostTestCheckBytes(const unsigned char *actualBytes, const unsigned char *expectedBytes, unsigned int byteCount, const char *actualText, const char *fileName, int lineNumber)
+{
+    hostTestCheckCount++;
+    if(memcmp(actualBytes, expectedBytes, byteCount)==0) return;
+    hostTestFailCount++;
+    printf("%s:%d: FAILED %s\n   got      ", fileName, lineNumber, actualText);
+    for(unsigned int i=0; i<byteCount; i++) printf("%02x", actualBytes[i]);
+    printf("\n   expected ");
+    for(unsigned int i=0; i<byteCount; i++) printf("%02x", expectedBytes[i]);
+    printf("\n");
+}
+
+/* HostTestHex - turns a string of hex digits into bytes. The test vectors
+ *    in the standards are written this way. Spaces are skipped
+ *
+ * inputs:
+ *    hexString - the hex digits, two for each byte
+ *    bytesOut - the bytes are written here
+ * returns:
+ *    the number of bytes written
+ * */
+inline unsigned int HostTestHex(const char *hexString, unsigned char *bytesOut)
+{
+    unsigned int byteCount = 0;
+    unsigned int nibbleCount = 0;
+    unsigned int byteValue = 0;
+    for(const char *charPtr=hexString; *charPtr!=0; charPtr++)
+    {
+        unsigned int nibbleValue;
+        if((*charPtr>='0') && (*charPtr<='9')) nibbleValue = *charPtr-'0';
+        else if((*charPtr>='a') && (*charPtr<='f')) nibbleValue = *charPtr-'a'+10;
+        else if((*charPtr>='A') && (*charPtr<='F')) nibbleValue = *charPtr-'A'+10;
+        else continue;
+        byteValue = (byteValue<<4) | nibbleValue;
+        nibbleCount++;
+        if((nibbleCount & 0x01)==0)
+        {
+            bytesOut[byteCount++] = (unsigned char)byteValue;
+            byteValue = 0;
+        }
+    }
+    return byteCount;
+}
+
+/* HostTestFinish - prints the result. Return what this returns from main()
+ *
+ * inputs:
+ *    testName - the name to print
+ * returns:
+ *    0 if every check passed, 1 if any failed
+ * */
+inline int HostTestFinish(const char *testName)
+{
+    if(hostTestFailCount==0)
+    {
+        printf("PASS %s (%u checks)\n", testName, hostTestCheckCount);
+        return 0;
+    }
+    printf("FAIL %s (%u of %u checks failed)\n", testName, hostTestFailCount, hostTestCheckCount);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,103 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_AES.h"
+
+// The known answers are the CTR-AES128 examples from NIST SP 800-38A, 
+// appendix F.5.1 (encrypt) and F.5.2 (decrypt). The data goes through 
+// Encrypt() in odd sized pieces with the ECB interrupt running in between so
+// the keystream buffer wraps part way through a block and Callback0() has to
+// keep it topped up - the result must still be the same as one big call. It
+// is done again with no interrupts at all, which makes Encrypt() stall and 
+// poll the ECB for every block.
+
+// the F.5.1 data, four blocks
+#define AES_TEST_BYTES 64
+
+int main(void)
+{
+    hostRegisters.Reset();
+    YakIO_ECB ecbObj;
+    YakIO_AES aesObj;
+    unsigned char keyBytes[AES_KEY_BYTES];
+    unsigned char counterBlock[AES_BLOCK_BYTES];
+    unsigned char plainBytes[AES_TEST_BYTES];
+    unsigned char cipherBytes[AES_TEST_BYTES];
+    unsigned char outBytes[AES_TEST_BYTES];
+
+    HostTestHex("2b7e151628aed2a6abf7158809cf4f3c", keyBytes);
+    HostTestHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", counterBlock);
+    HostTestHex("6bc1bee22e409f96e93d7e117393172a ae2d8a571e03ac9c9eb76fac45af8e51"
+                "30c81c46a35ce411e5fbc1191a0a52ef f69f2445df4f9b17ad2b417be66c3710", plainBytes);
+    HostTestHex("874d6191b620e3261bef6864990db6ce 9806f66b7970fdff8617187bb9fffdff"
+                "5ae4df3edbd5d35e5b4f09020db03eab 1e031dda2fbe03d1792170a0f3009cee", cipherBytes);
+
+    // the interrupt fills the keystream buffer before any data turns up
+    aesObj.Start(&ecbObj, keyBytes, counterBlock);
+    hostRegisters.Advance(1000);
+    HOSTTEST_CHECK(aesObj.GetKeystreamCount()==AES_KEYSTREAM_BYTES);
+    HOSTTEST_CHECK(aesObj.GetBlockCount()==AES_KEYSTREAM_BYTES/AES_BLOCK_BYTES);
+
+    // odd sized pieces, the interrupt refilling the buffer in between
+    static const unsigned int pieceBytes[] = {1, 5, 7, 13, 3, 11, 17, 7};
+    unsigned int doneCount = 0;
+    memset(outBytes, 0, sizeof(outBytes));
+    for(unsigned int i=0; i<sizeof(pieceBytes)/sizeof(pieceBytes[0]); i++)
+    {
+        HOSTTEST_CHECK(aesObj.Encrypt(&plainBytes[doneCount], &outBytes[doneCount], pieceBytes[i])!=0);
+        doneCount = doneCount + pieceBytes[i];
+        hostRegisters.Advance(1000);
+    }
+    HOSTTEST_CHECK(doneCount==AES_TEST_BYTES);
+    HOSTTEST_CHECK_BYTES(outBytes, cipherBytes, AES_TEST_BYTES);
+    HOSTTEST_CHECK(aesObj.GetStallCount()==0);
+    // the blocks for the data plus a full buffer made ahead
+    HOSTTEST_CHECK(aesObj.GetBlockCount()==(AES_TEST_BYTES+AES_KEYSTREAM_BYTES)/AES_BLOCK_BYTES);
+    HOSTTEST_CHECK(aesObj.GetKeystreamCount()==AES_KEYSTREAM_BYTES);
+
+    // F.5.2, decrypting is the same thing
+    aesObj.Start(&ecbObj, keyBytes, counterBlock);
+    hostRegisters.Advance(1000);
+    doneCount = 0;
+    memset(outBytes, 0, sizeof(outBytes));
+    for(unsigned int i=0; i<sizeof(pieceBytes)/sizeof(pieceBytes[0]); i++)
+    {
+        HOSTTEST_CHECK(aesObj.Decrypt(&cipherBytes[doneCount], &outBytes[doneCount], pieceBytes[i])!=0);
+        doneCount = doneCount + pieceBytes[i];
+        hostRegisters.Advance(1000);
+    }
+    HOSTTEST_CHECK_BYTES(outBytes, plainBytes, AES_TEST_BYTES);
+
+    // no interrupts at all. Every block is a stall and Encrypt() polls the
+    // ECB for it, the answer is the same
+    aesObj.Start(&ecbObj, keyBytes, counterBlock);
+    memset(outBytes, 0, sizeof(outBytes));
+    doneCount = 0;
+    for(unsigned int i=0; i<sizeof(pieceBytes)/sizeof(pieceBytes[0]); i++)
+    {
+        HOSTTEST_CHECK(aesObj.Encrypt(&plainBytes[doneCount], &outBytes[doneCount], pieceBytes[i])!=0);
+        doneCount = doneCount + pieceBytes[i];
+    }
+    HOSTTEST_CHECK_BYTES(outBytes, cipherBytes, AES_TEST_BYTES);
+    HOSTTEST_CHECK(aesObj.GetStallCount()==AES_TEST_BYTES/AES_BLOCK_BYTES);
+
+    // stopped, it does nothing
+    aesObj.Stop();
+    HOSTTEST_CHECK(aesObj.Encrypt(plainBytes, outBytes, AES_BLOCK_BYTES)==0);
+
+    return HostTestFinish("AES");
+}
@@ -0,0 +1,127 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_CCM.h"
+
+// Known answers for the CCM:
+//
+//    The Bluetooth Core specification sample data (volume 6 part C, "Encrypted 
+//       data sample"). The LL_START_ENC_RSP packet both ways with the packet 
+//       counter at zero. This checks the whole packet - payload and MIC.
+//    RFC 3610 packet vector #1. The CCM here always makes a 4 byte MIC over 
+//       the one header byte, the RFC vector has an 8 byte MIC over 8 bytes 
+//       of header, so only the encrypted payload can be compared. The 13 
+//       byte RFC nonce goes in as the packet counter, direction and IV.
+//
+// Then a packet with one bit changed must fail the MIC, and must not move 
+// the packet counter on, while a change to the header bits the MIC does not
+// cover must not matter.
+
+int main(void)
+{
+    hostRegisters.Reset();
+    YakIO_CCM ccmObj;
+    unsigned char keyBytes[CCM_KEY_BYTES];
+    unsigned char ivBytes[CCM_IV_BYTES];
+    unsigned char expectedBytes[CCM_PACKET_BYTES];
+    unsigned char clearPacket[CCM_PACKET_BYTES];
+    unsigned char cipherPacket[CCM_PACKET_BYTES];
+    unsigned char decryptedPacket[CCM_PACKET_BYTES];
+
+    // the Bluetooth sample. SK goes in as it is written. The specification 
+    // writes the IV as the number 0xDEAFBABEBADCAB24 so its bytes are the 
+    // other way round here
+    HostTestHex("99AD1B5226A37E3E058E3B8E27C2C666", keyBytes);
+    HostTestHex("24ABDCBABEBAAFDE", ivBytes);
+    ccmObj.Start(keyBytes, ivBytes, CCM_DIRECTION_MASTER_TO_SLAVE);
+    HOSTTEST_CHECK(ccmObj.GetPacketCounter()==0);
+
+    // master to slave: 0F 01 06 encrypts to 0F 05 9F CDA7F448
+    memset(clearPacket, 0, sizeof(clearPacket));
+    clearPacket[CCM_PACKET_OFFSET_S0] = 0x0F;
+    clearPacket[CCM_PACKET_OFFSET_LENGTH] = 1;
+    clearPacket[CCM_PACKET_OFFSET_PAYLOAD] = 0x06;
+    HOSTTEST_CHECK(ccmObj.EncryptPacket(clearPacket, cipherPacket)!=0);
+    HOSTTEST_CHECK(cipherPacket[CCM_PACKET_OFFSET_S0]==0x0F);
+    HOSTTEST_CHECK(cipherPacket[CCM_PACKET_OFFSET_LENGTH]==1+CCM_MIC_BYTES);
+    HostTestHex("9FCDA7F448", expectedBytes);
+    HOSTTEST_CHECK_BYTES(&cipherPacket[CCM_PACKET_OFFSET_PAYLOAD], expectedBytes, 1+CCM_MIC_BYTES);
+    HOSTTEST_CHECK(ccmObj.GetPacketCounter()==1);
+
+    // and back again
+    ccmObj.SetPacketCounter(0, 0);
+    memset(decryptedPacket, 0, sizeof(decryptedPacket));
+    HOSTTEST_CHECK(ccmObj.DecryptPacket(cipherPacket, decryptedPacket)!=0);
+    HOSTTEST_CHECK(ccmObj.GetMicStatus()!=0);
+    HOSTTEST_CHECK(decryptedPacket[CCM_PACKET_OFFSET_LENGTH]==1);
+    HOSTTEST_CHECK(decryptedPacket[CCM_PACKET_OFFSET_PAYLOAD]==0x06);
+
+    // slave to master: 07 01 06 encrypts to 07 05 A3 4C13A415
+    ccmObj.SetDirection(CCM_DIRECTION_SLAVE_TO_MASTER);
+    ccmObj.SetPacketCounter(0, 0);
+    clearPacket[CCM_PACKET_OFFSET_S0] = 0x07;
+    HOSTTEST_CHECK(ccmObj.EncryptPacket(clearPacket, cipherPacket)!=0);
+    HostTestHex("A34C13A415", expectedBytes);
+    HOSTTEST_CHECK_BYTES(&cipherPacket[CCM_PACKET_OFFSET_PAYLOAD], expectedBytes, 1+CCM_MIC_BYTES);
+
+    // one bit changed in the payload fails the MIC. The counter stays 
+    // where it was so the real packet can still be received
+    ccmObj.SetPacketCounter(0, 0);
+    cipherPacket[CCM_PACKET_OFFSET_PAYLOAD] = cipherPacket[CCM_PACKET_OFFSET_PAYLOAD] ^ 0x01;
+    HOSTTEST_CHECK(ccmObj.DecryptPacket(cipherPacket, decryptedPacket)==0);
+    HOSTTEST_CHECK(ccmObj.GetMicStatus()==0);
+    HOSTTEST_CHECK(ccmObj.GetMicFailCount()==1);
+    HOSTTEST_CHECK(ccmObj.GetPacketCounter()==0);
+
+    // one bit changed in the MIC itself fails too
+    cipherPacket[CCM_PACKET_OFFSET_PAYLOAD] = cipherPacket[CCM_PACKET_OFFSET_PAYLOAD] ^ 0x01;
+    cipherPacket[CCM_PACKET_OFFSET_PAYLOAD+1] = cipherPacket[CCM_PACKET_OFFSET_PAYLOAD+1] ^ 0x80;
+    HOSTTEST_CHECK(ccmObj.DecryptPacket(cipherPacket, decryptedPacket)==0);
+    HOSTTEST_CHECK(ccmObj.GetMicFailCount()==2);
+
+    // the NESN, SN and MD bits (0x1C) of S0 are not covered by the MIC
+    cipherPacket[CCM_PACKET_OFFSET_PAYLOAD+1] = cipherPacket[CCM_PACKET_OFFSET_PAYLOAD+1] ^ 0x80;
+    cipherPacket[CCM_PACKET_OFFSET_S0] = cipherPacket[CCM_PACKET_OFFSET_S0] ^ 0x1C;
+    HOSTTEST_CHECK(ccmObj.DecryptPacket(cipherPacket, decryptedPacket)!=0);
+    HOSTTEST_CHECK(ccmObj.GetMicFailCount()==2);
+    HOSTTEST_CHECK(decryptedPacket[CCM_PACKET_OFFSET_PAYLOAD]==0x06);
+    HOSTTEST_CHECK(ccmObj.GetPacketCounter()==1);
+
+    // RFC 3610 packet vector #1. Key C0..CF, nonce 00000003 02 0100A0A1A2A3A4A5
+    // which is a counter of 0x0203000000 least significant byte first, the 
+    // direction bit clear (the top bit of the 02) and then the IV
+    HostTestHex("C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF", keyBytes);
+    HostTestHex("0100A0A1A2A3A4A5", ivBytes);
+    ccmObj.Start(keyBytes, ivBytes, CCM_DIRECTION_SLAVE_TO_MASTER);
+    ccmObj.SetPacketCounter(0x03000000, 0x02);
+    memset(clearPacket, 0, sizeof(clearPacket));
+    clearPacket[CCM_PACKET_OFFSET_LENGTH] = HostTestHex("08090A0B0C0D0E0F101112131415161718191A1B1C1D1E", &clearPacket[CCM_PACKET_OFFSET_PAYLOAD]);
+    HOSTTEST_CHECK(ccmObj.EncryptPacket(clearPacket, cipherPacket)!=0);
+    HOSTTEST_CHECK(cipherPacket[CCM_PACKET_OFFSET_LENGTH]==23+CCM_MIC_BYTES);
+    HostTestHex("588C979A61C663D2F066D0C2C0F989806D5F6B61DAC384", expectedBytes);
+    HOSTTEST_CHECK_BYTES(&cipherPacket[CCM_PACKET_OFFSET_PAYLOAD], expectedBytes, 23);
+
+    // which decrypts back to the RFC payload
+    ccmObj.SetPacketCounter(0x03000000, 0x02);
+    HOSTTEST_CHECK(ccmObj.DecryptPacket(cipherPacket, decryptedPacket)!=0);
+    HOSTTEST_CHECK_BYTES(&decryptedPacket[CCM_PACKET_OFFSET_PAYLOAD], &clearPacket[CCM_PACKET_OFFSET_PAYLOAD], 23);
+
+    ccmObj.Stop();
+    HOSTTEST_CHECK(ccmObj.EncryptPacket(clearPacket, cipherPacket)==0);
+
+    return HostTestFinish("CCM");
+}
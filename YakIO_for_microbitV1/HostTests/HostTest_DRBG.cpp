@@ -0,0 +1,80 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_DRBG.h"
+
+// The simulated RNG (see YakIO_HOSTREGISTERS.h) makes the same values 
+// every time so the DRBG output is known. The expected bytes come from a 
+// separate CTR_DRBG with Block_Cipher_df written straight from SP 800-90A,
+// which gives the CAVP "AES-128 use df" ReturnedBits for COUNT 0, fed 
+// with the same RNG values. With a key rotation every 4 blocks and a 
+// reseed every 2 rotations, block 8 is the first after a reseed.
+
+int main(void)
+{
+    hostRegisters.Reset();
+    YakIO_ECB ecbObj;
+    YakIO_RNG rngObj;
+    YakIO_DRBG drbgObj;
+    unsigned char expectedBytes[32];
+
+    drbgObj.SetKeyRotationInterval(4);
+    drbgObj.SetReseedInterval(2);
+    drbgObj.Start(&ecbObj, &rngObj);
+
+    // a full pool is not enough for the first seed. It takes what there
+    // is and waits for the rest
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*(RNG_POOL_BYTES+8));
+    unsigned char outBytes[256];
+    HOSTTEST_CHECK(drbgObj.TryGetBytes(outBytes, 16)==0);
+    HOSTTEST_CHECK(drbgObj.IsSeeded()==0);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()>=RNG_POOL_BYTES);
+
+    // the rest of the seed arrives and the output starts
+    unsigned int byteCount = 0;
+    for(unsigned int i=0; (i<10000) && (byteCount<sizeof(outBytes)); i++)
+    {
+        if(drbgObj.TryGetBytes(&outBytes[byteCount], 16)!=0) byteCount = byteCount + 16;
+        else hostRegisters.Advance(200);
+    }
+    HOSTTEST_CHECK(byteCount==sizeof(outBytes));
+    HOSTTEST_CHECK(drbgObj.IsSeeded()!=0);
+
+    // the first output, straight after the instantiate
+    HostTestHex("2c53446384a3958171de4eb664b2372a6f43fe956b9ee24d590c0ff12e20fd3a", expectedBytes);
+    HOSTTEST_CHECK_BYTES(&outBytes[0], expectedBytes, 32);
+
+    // straight after the first reseed
+    HostTestHex("68887ca682625627b56fbe1dcc9a7f6e67e3a0815513cc46d342a92c38cc75dc", expectedBytes);
+    HOSTTEST_CHECK_BYTES(&outBytes[128], expectedBytes, 32);
+
+    // 16 blocks is 4 rotations and at least the first seed and one reseed
+    HOSTTEST_CHECK(drbgObj.GetBlockCount()>=16);
+    HOSTTEST_CHECK(drbgObj.GetKeyRotationCount()>=4);
+    HOSTTEST_CHECK(drbgObj.GetReseedCount()>=2);
+
+    // every seed took DRBG_ENTROPY_BYTES from the pool and nothing else did
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()-rngObj.GetPoolCount()==(drbgObj.GetReseedCount()*DRBG_ENTROPY_BYTES));
+
+    // stopping wipes everything
+    drbgObj.Stop();
+    HOSTTEST_CHECK(drbgObj.IsSeeded()==0);
+    HOSTTEST_CHECK(drbgObj.GetCount()==0);
+    HOSTTEST_CHECK(drbgObj.TryGetBytes(outBytes, 16)==0);
+
+    return HostTestFinish("DRBG");
+}
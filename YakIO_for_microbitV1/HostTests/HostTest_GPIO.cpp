@@ -0,0 +1,88 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_GPIO.h"
+
+// The GPIO calls are the ones people put in tight loops to bit-bang a pin, so
+// each must stay a single register access. High, Low and SetGPIOState() are 
+// one write (to OUTSET or OUTCLR, never a read-modify-write of OUT), a read
+// is one read of IN and a toggle is one of each. The pins must also do what 
+// they say: an output drives OUT and an input sees what the outside world puts
+// on the pin.
+
+int main(void)
+{
+    hostRegisters.Reset();
+    YakIO_GPIO outPin(Pin0, PinDirOutput);
+    YakIO_GPIO inPin(ButtonA, PinDirInput);
+    unsigned int outBit = 0x01u<<Pin0;
+    unsigned int inBit = 0x01u<<ButtonA;
+
+    // the constructor sets the direction
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_DIR) & outBit)==outBit);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_DIR) & inBit)==0);
+    HOSTTEST_CHECK(outPin.GetGPIODir()==PinDirOutput);
+    HOSTTEST_CHECK(inPin.GetGPIODir()==PinDirInput);
+
+    // set and clear are one write each and no reads
+    hostRegisters.ResetCounters();
+    outPin.SetGPIOStateHigh();
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & outBit)==outBit);
+    hostRegisters.ResetCounters();
+    outPin.SetGPIOStateLow();
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & outBit)==0);
+    hostRegisters.ResetCounters();
+    outPin.SetGPIOState(1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & outBit)==outBit);
+    outPin.SetGPIOState(0);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & outBit)==0);
+
+    // the other pins are left alone
+    hostRegisters.Poke(REGISTER_GPIO+GPIOREG_OFFSET_OUT, ~outBit);
+    outPin.SetGPIOStateHigh();
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT)==0xFFFFFFFF);
+    outPin.SetGPIOStateLow();
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT)==~outBit);
+    hostRegisters.Poke(REGISTER_GPIO+GPIOREG_OFFSET_OUT, 0);
+
+    // a toggle is one read and one write and an output reads back what it drives
+    hostRegisters.ResetCounters();
+    outPin.ToggleGPIOState();
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetUnmappedCount()==0);
+    HOSTTEST_CHECK(outPin.GetGPIOState()==1);
+    outPin.ToggleGPIOState();
+    HOSTTEST_CHECK(outPin.GetGPIOState()==0);
+
+    // a read is one read and an input sees what is driven onto the pin
+    hostRegisters.SetInputPins(inBit);
+    hostRegisters.ResetCounters();
+    HOSTTEST_CHECK(inPin.GetGPIOState()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==0);
+    hostRegisters.SetInputPins(0);
+    HOSTTEST_CHECK(inPin.GetGPIOState()==0);
+
+    return HostTestFinish("GPIO");
+}
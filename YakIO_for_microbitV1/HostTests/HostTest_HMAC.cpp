@@ -0,0 +1,82 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_HMAC.h"
+
+// Known answers from RFC 4231 (HMAC-SHA-256): test case 1 (a short key), 
+// test case 2 (a key shorter than the output), test case 5 (the output 
+// truncated to 128 bits, checked with FinishAndCheck()) and test case 6 (a
+// key longer than a block, which has to be hashed first). Finish() must 
+// leave the key ready for the next message.
+
+int main(void)
+{
+    YakIO_HMAC hmacObj;
+    unsigned char keyBytes[131];
+    unsigned char macBytes[HMAC_MAC_BYTES];
+    unsigned char expectedBytes[HMAC_MAC_BYTES];
+
+    // test case 1. The data in two pieces
+    memset(keyBytes, 0x0b, 20);
+    hmacObj.Start(keyBytes, 20);
+    hmacObj.Update((const unsigned char *)"Hi ", 3);
+    hmacObj.Update((const unsigned char *)"There", 5);
+    hmacObj.Finish(macBytes);
+    HostTestHex("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7", expectedBytes);
+    HOSTTEST_CHECK_BYTES(macBytes, expectedBytes, HMAC_MAC_BYTES);
+
+    // the same again, Finish() started the next message for us
+    hmacObj.Update((const unsigned char *)"Hi There", 8);
+    HOSTTEST_CHECK(hmacObj.FinishAndCheck(expectedBytes, HMAC_MAC_BYTES)!=0);
+
+    // one bit wrong in the last byte is still wrong
+    expectedBytes[HMAC_MAC_BYTES-1] = expectedBytes[HMAC_MAC_BYTES-1] ^ 0x01;
+    hmacObj.Update((const unsigned char *)"Hi There", 8);
+    HOSTTEST_CHECK(hmacObj.FinishAndCheck(expectedBytes, HMAC_MAC_BYTES)==0);
+
+    // test case 2
+    hmacObj.Start((const unsigned char *)"Jefe", 4);
+    const char *caseTwoText = "what do ya want for nothing?";
+    hmacObj.Update((const unsigned char *)caseTwoText, strlen(caseTwoText));
+    hmacObj.Finish(macBytes);
+    HostTestHex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", expectedBytes);
+    HOSTTEST_CHECK_BYTES(macBytes, expectedBytes, HMAC_MAC_BYTES);
+
+    // test case 5, only the first 128 bits are given
+    memset(keyBytes, 0x0c, 20);
+    hmacObj.Start(keyBytes, 20);
+    const char *caseFiveText = "Test With Truncation";
+    hmacObj.Update((const unsigned char *)caseFiveText, strlen(caseFiveText));
+    HostTestHex("a3b6167473100ee06e0c796c2955552b", expectedBytes);
+    HOSTTEST_CHECK(hmacObj.FinishAndCheck(expectedBytes, 16)!=0);
+
+    // test case 6, a 131 byte key
+    memset(keyBytes, 0xaa, 131);
+    hmacObj.Start(keyBytes, 131);
+    const char *caseSixText = "Test Using Larger Than Block-Size Key - Hash Key First";
+    hmacObj.Update((const unsigned char *)caseSixText, strlen(caseSixText));
+    hmacObj.Finish(macBytes);
+    HostTestHex("60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", expectedBytes);
+    HOSTTEST_CHECK_BYTES(macBytes, expectedBytes, HMAC_MAC_BYTES);
+
+    // no key, no answer
+    hmacObj.Stop();
+    hmacObj.Update((const unsigned char *)caseSixText, strlen(caseSixText));
+    HOSTTEST_CHECK(hmacObj.FinishAndCheck(expectedBytes, HMAC_MAC_BYTES)==0);
+
+    return HostTestFinish("HMAC");
+}
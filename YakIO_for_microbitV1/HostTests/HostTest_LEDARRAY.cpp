@@ -0,0 +1,72 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_LEDARRAY.h"
+
+// The LED array is refreshed from the Heartbeat interrupt a thousand times a 
+// second so its register cost matters. Drawing on it (SetLEDState() and 
+// friends) only changes the backing store and must not touch a register at 
+// all. Each refresh must be exactly two writes, OUTCLR then OUTSET.
+
+int main(void)
+{
+    hostRegisters.Reset();
+    YakIO_LEDARRAY ledArray;
+
+    // the constructor makes the row and column pins outputs
+    unsigned int ledPins = LEDROW1 | LEDROW2 | LEDROW3;
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_DIR) & ledPins)==ledPins);
+
+    // drawing costs nothing
+    hostRegisters.ResetCounters();
+    ledArray.SetLEDState(1, 1, 1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==0);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    hostRegisters.ResetCounters();
+    ledArray.ToggleLEDState(5, 5);
+    ledArray.ToggleLEDState(5, 5);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==0);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(ledArray.GetLEDState(1, 1)==1);
+    HOSTTEST_CHECK(ledArray.GetLEDState(5, 5)==0);
+
+    // a refresh is two GPIO writes and no reads. The constructor did three 
+    // refreshes so this one is the first row again
+    hostRegisters.ResetCounters();
+    ledArray.RefreshLEDArray();
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==2);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount(REGISTER_GPIO)==2);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(hostRegisters.GetUnmappedCount()==0);
+    // row 1 high and column 1 low lights the top left LED
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & GPIO_LED_MASK)==(LEDROW1 ^ (1<<C1_SHL)));
+
+    // the other two rows have nothing lit
+    ledArray.RefreshLEDArray();
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & GPIO_LED_MASK)==LEDROW2);
+    ledArray.RefreshLEDArray();
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_GPIO+GPIOREG_OFFSET_OUT) & GPIO_LED_MASK)==LEDROW3);
+
+    // clearing the image refreshes all three rows
+    hostRegisters.ResetCounters();
+    ledArray.ClearImage();
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==6);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(ledArray.GetLEDState(1, 1)==0);
+
+    return HostTestFinish("LEDARRAY");
+}
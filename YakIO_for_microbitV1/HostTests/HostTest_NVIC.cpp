@@ -0,0 +1,67 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_Utils.h"
+
+// EnableIRQ(), DisableIRQ() and ClearPendingIRQ() are called from interrupt
+// handlers and from inside critical sections, so each must be one write to
+// the set or clear register and no read - the NVIC registers are write one to
+// change, there is nothing to read-modify-write. Only the named IRQ's bit may
+// change. SetIRQPriority() does have to read-modify-write the PRIn register 
+// because four IRQs share it, and must leave the other three alone.
+
+int main(void)
+{
+    hostRegisters.Reset();
+
+    // enable is one write to ISER
+    hostRegisters.ResetCounters();
+    EnableIRQ(IRQ_TIMER1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount(REGISTER_NVIC)==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_NVIC+NVICREG_OFFSET_ISER)==(0x01u<<IRQ_TIMER1));
+    EnableIRQ(IRQ_RNG);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_NVIC+NVICREG_OFFSET_ISER)==((0x01u<<IRQ_TIMER1) | (0x01u<<IRQ_RNG)));
+
+    // disable is one write to ICER and only clears its own bit
+    hostRegisters.ResetCounters();
+    DisableIRQ(IRQ_TIMER1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount(REGISTER_NVIC)==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_NVIC+NVICREG_OFFSET_ISER)==(0x01u<<IRQ_RNG));
+
+    // clearing a pending IRQ is one write to ICPR
+    hostRegisters.Poke(REGISTER_NVIC+NVICREG_OFFSET_ISPR, (0x01u<<IRQ_TIMER2) | (0x01u<<IRQ_ECB));
+    hostRegisters.ResetCounters();
+    ClearPendingIRQ(IRQ_TIMER2);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_NVIC+NVICREG_OFFSET_ISPR)==(0x01u<<IRQ_ECB));
+
+    // a priority is a read and a write of the shared PRIn register. TIMER0
+    // to TIMER2 and RTC0 (IRQs 8 to 11) are all in PRI2
+    hostRegisters.Poke(REGISTER_NVIC+NVICREG_OFFSET_PRI2, 0xFFFFFFFF);
+    hostRegisters.ResetCounters();
+    SetIRQPriority(IRQ_TIMER1, IRQ_PRIORITY_Highest);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount(REGISTER_NVIC)==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount(REGISTER_NVIC)==1);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_NVIC+NVICREG_OFFSET_PRI2)==0xFFFF3FFF);
+
+    return HostTestFinish("NVIC");
+}
@@ -0,0 +1,99 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_RNG.h"
+#include "YakIO_PRNG.h"
+
+// The generators are checked against the values their authors published. 
+// xorshift32 and xorshift128 from their default seeds are the first values 
+// in Marsaglia, "Xorshift RNGs" 2003. PCG32 seeded with initstate 42 and 
+// initseq 54 is the pcg32-demo program from https://www.pcg-random.org. 
+// After that GetRange(), GetBetween() and Fill() must stay inside their 
+// limits and must be made from GetNext() the way YakIO_PRNG.h says.
+
+int main(void)
+{
+    hostRegisters.Reset();
+
+    // xorshift32 with Marsaglia's seed 2463534242
+    YakIO_PRNG xorshift32Obj {PRNG_XORSHIFT32};
+    HOSTTEST_CHECK(xorshift32Obj.GetType()==PRNG_XORSHIFT32);
+    HOSTTEST_CHECK(xorshift32Obj.GetNext()==723471715u);
+
+    // xorshift128 with Marsaglia's seeds 123456789, 362436069, 521288629, 88675123
+    YakIO_PRNG xorshift128Obj {PRNG_XORSHIFT128};
+    HOSTTEST_CHECK(xorshift128Obj.GetNext()==3701687786u);
+
+    // pcg32-demo: pcg32_srandom_r(&rng, 42u, 54u) then six pcg32_random_r()
+    YakIO_PRNG pcg32Obj {PRNG_PCG32};
+    unsigned int pcgSeedWords[PRNG_SEED_WORDS] = {42, 0, 54, 0};
+    pcg32Obj.SetSeedWords(pcgSeedWords);
+    unsigned int pcgExpected[6] = {0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e};
+    for(unsigned int i=0; i<6; i++) HOSTTEST_CHECK(pcg32Obj.GetNext()==pcgExpected[i]);
+
+    // the same seed gives the same numbers, a different one does not
+    xorshift128Obj.SetSeed(1);
+    unsigned int firstValue = xorshift128Obj.GetNext();
+    xorshift128Obj.SetSeed(1);
+    HOSTTEST_CHECK(xorshift128Obj.GetNext()==firstValue);
+    xorshift128Obj.SetSeed(2);
+    HOSTTEST_CHECK(xorshift128Obj.GetNext()!=firstValue);
+
+    // Fill() is GetNext() a little endian word at a time, the odd 
+    // bytes at the end come from the low bits of one more value
+    YakIO_PRNG fillObj {PRNG_PCG32};
+    YakIO_PRNG matchObj {PRNG_PCG32};
+    fillObj.SetSeed(7);
+    matchObj.SetSeed(7);
+    unsigned char fillBytes[7];
+    unsigned char expectedBytes[7];
+    fillObj.Fill(fillBytes, 7);
+    unsigned int wordValue = matchObj.GetNext();
+    for(unsigned int i=0; i<4; i++) expectedBytes[i] = (unsigned char)(wordValue>>(i*8));
+    wordValue = matchObj.GetNext();
+    for(unsigned int i=0; i<3; i++) expectedBytes[4+i] = (unsigned char)(wordValue>>(i*8));
+    HOSTTEST_CHECK_BYTES(fillBytes, expectedBytes, 7);
+
+    // dice rolls stay between 1 and 6 and every face comes up about as 
+    // often as the others. 60000 rolls is 10000 a face give or take a few 
+    // hundred, a bias from using % would not show at this size but a 
+    // broken mask would
+    unsigned int faceCounts[6] = {0, 0, 0, 0, 0, 0};
+    unsigned int outOfRange = 0;
+    for(unsigned int i=0; i<60000; i++)
+    {
+        unsigned int diceRoll = pcg32Obj.GetBetween(1, 6);
+        if((diceRoll<1) || (diceRoll>6)) outOfRange++;
+        else faceCounts[diceRoll-1]++;
+    }
+    HOSTTEST_CHECK(outOfRange==0);
+    for(unsigned int i=0; i<6; i++) HOSTTEST_CHECK((faceCounts[i]>9500) && (faceCounts[i]<10500));
+    HOSTTEST_CHECK(pcg32Obj.GetRange(1)==0);
+    HOSTTEST_CHECK(pcg32Obj.GetBetween(5, 5)==5);
+
+    // reseeding from the RNG pool happens every 100 values once the pool 
+    // has something in it
+    YakIO_RNG rngObj;
+    rngObj.PoolStart();
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*70);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()>0);
+    xorshift32Obj.SetReseedRng(&rngObj, 100);
+    for(unsigned int i=0; i<1000; i++) xorshift32Obj.GetNext();
+    HOSTTEST_CHECK(xorshift32Obj.GetReseedCount()==10);
+
+    return HostTestFinish("PRNG");
+}
@@ -0,0 +1,171 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_RADIO.h"
+
+// The RADIO against the simulated one (see YakIO_HOSTREGISTERS.h). The test
+// is the other end of the air, it injects the packets we hear and looks at
+// the ones we send.
+//
+// Sending has to go ramp up -> START -> END -> DISABLE on the READY_START 
+// and END_DISABLE shortcuts, with just the one DISABLED interrupt at the 
+// end. Listening has to swap between the two receive buffers as packets 
+// arrive back to back, without ramping up again, while the program reads 
+// the packet before. When the program holds both buffers the next packet 
+// is dropped, and a bad CRC is never seen at all.
+
+// the cycles from the start of the preamble to the ADDRESS event, at 1Mbit
+#define TEST_ADDRESS_CYCLES  ((HOSTREG_RADIO_PREAMBLE_BYTES+RADIO_BASE_ADDRESS_BYTES+1)*HOSTREG_RADIO_BYTE_CYCLES_1MBIT)
+// the cycles for a whole packet with a 16 bit CRC on the air at 1Mbit
+#define TEST_PACKET_CYCLES(payloadLength) (TEST_ADDRESS_CYCLES+((1+(payloadLength)+2)*HOSTREG_RADIO_BYTE_CYCLES_1MBIT))
+
+int main(void)
+{
+    hostRegisters.Reset();
+    YakIO_RADIO radioObj;
+    radioObj.Start();
+    HOSTTEST_CHECK(radioObj.GetState()==RADIO_STATE_IDLE);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_FREQUENCY)==RADIO_DEFAULT_FREQUENCY);
+
+    // #
+    // # Sending
+    // #
+
+    unsigned char helloBytes[5] = {'h', 'e', 'l', 'l', 'o'};
+    HOSTTEST_CHECK(radioObj.Transmit(helloBytes, 5)!=0);
+    HOSTTEST_CHECK(radioObj.IsTransmitting()!=0);
+    HOSTTEST_CHECK(radioObj.Transmit(helloBytes, 5)==0);
+    unsigned int shortBits = RADIO_SHORT_READY_START | RADIO_SHORT_END_DISABLE;
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_SHORTS)==shortBits);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)==RADIO_HWSTATE_TXRU);
+
+    // the ramp up ends and READY_START starts the packet. No interrupt 
+    // and not one register write from us
+    hostRegisters.ResetCounters();
+    hostRegisters.Advance(HOSTREG_RADIO_RAMPUP_CYCLES);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)==RADIO_HWSTATE_TX);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount(REGISTER_RADIO)==0);
+    HOSTTEST_CHECK(hostRegisters.GetIRQCount()==0);
+
+    // the packet ends and END_DISABLE switches the RADIO off. DISABLED is
+    // the one and only interrupt
+    hostRegisters.Advance(TEST_PACKET_CYCLES(5));
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)==RADIO_HWSTATE_DISABLED);
+    HOSTTEST_CHECK(hostRegisters.GetIRQCount()==1);
+    HOSTTEST_CHECK(radioObj.IsTransmitting()==0);
+    HOSTTEST_CHECK(radioObj.GetState()==RADIO_STATE_IDLE);
+    HOSTTEST_CHECK(radioObj.GetTxPacketCount()==1);
+
+    // what went out on the air
+    unsigned char airBytes[HOSTREG_RADIO_PACKET_BYTES];
+    HOSTTEST_CHECK(hostRegisters.GetRadioTxCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetRadioTxFrequency()==RADIO_DEFAULT_FREQUENCY);
+    HOSTTEST_CHECK(hostRegisters.GetRadioTxPacket(airBytes)==6);
+    HOSTTEST_CHECK(airBytes[0]==5);
+    HOSTTEST_CHECK_BYTES(&airBytes[1], helloBytes, 5);
+
+    // #
+    // # Listening
+    // #
+
+    // READY_START again, it is listening as soon as it has ramped up
+    HOSTTEST_CHECK(radioObj.StartReceive()!=0);
+    hostRegisters.Advance(HOSTREG_RADIO_RAMPUP_CYCLES);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)==RADIO_HWSTATE_RX);
+    HOSTTEST_CHECK(radioObj.GetReceivedPacket()==NULL);
+
+    // packet A goes into one buffer
+    unsigned char packetA[4] = {3, 'a', 'b', 'c'};
+    unsigned char packetB[3] = {2, 'B', 'B'};
+    unsigned char packetC[6] = {5, 'c', 'c', 'c', 'c', 'c'};
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetA, 1)!=0);
+    hostRegisters.Advance(TEST_PACKET_CYCLES(3));
+    HOSTTEST_CHECK(radioObj.GetRxPacketCount()==1);
+
+    // B follows straight after. The RADIO is already listening again, 
+    // into the other buffer, with no ramp up in between
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)==RADIO_HWSTATE_RX);
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetB, 1)!=0);
+    unsigned long long addressCycleB = hostRegisters.GetCycleCount()+TEST_ADDRESS_CYCLES;
+
+    // the program reads A while B is arriving
+    hostRegisters.Advance(TEST_ADDRESS_CYCLES);
+    HOSTTEST_CHECK(hostRegisters.GetRadioAddressCycle()==addressCycleB);
+    struct YakIO_RADIOPACKET *packetPtrA = radioObj.GetReceivedPacket();
+    HOSTTEST_CHECK(packetPtrA!=NULL);
+    if(packetPtrA==NULL) return HostTestFinish("RADIO");
+    HOSTTEST_CHECK(packetPtrA->lengthByte==3);
+    HOSTTEST_CHECK_BYTES(packetPtrA->payloadBytes, &packetA[1], 3);
+    HOSTTEST_CHECK(radioObj.GetPacketRssi()==HOSTREG_RADIO_DEFAULT_RSSI);
+    radioObj.ReleasePacket();
+    HOSTTEST_CHECK(radioObj.GetReceivedPacket()==NULL);
+    hostRegisters.Advance(TEST_PACKET_CYCLES(2)-TEST_ADDRESS_CYCLES);
+    HOSTTEST_CHECK(radioObj.GetRxPacketCount()==2);
+
+    // and B while C is arriving. C goes back into A's buffer
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetC, 1)!=0);
+    hostRegisters.Advance(TEST_ADDRESS_CYCLES);
+    struct YakIO_RADIOPACKET *packetPtrB = radioObj.GetReceivedPacket();
+    HOSTTEST_CHECK(packetPtrB!=NULL);
+    if(packetPtrB==NULL) return HostTestFinish("RADIO");
+    HOSTTEST_CHECK(packetPtrB!=packetPtrA);
+    HOSTTEST_CHECK(packetPtrB->lengthByte==2);
+    HOSTTEST_CHECK_BYTES(packetPtrB->payloadBytes, &packetB[1], 2);
+    radioObj.ReleasePacket();
+    hostRegisters.Advance(TEST_PACKET_CYCLES(5)-TEST_ADDRESS_CYCLES);
+    struct YakIO_RADIOPACKET *packetPtrC = radioObj.GetReceivedPacket();
+    HOSTTEST_CHECK(packetPtrC==packetPtrA);
+    if(packetPtrC==NULL) return HostTestFinish("RADIO");
+    HOSTTEST_CHECK(packetPtrC->lengthByte==5);
+    HOSTTEST_CHECK_BYTES(packetPtrC->payloadBytes, &packetC[1], 5);
+    HOSTTEST_CHECK(radioObj.GetRxPacketCount()==3);
+    HOSTTEST_CHECK(radioObj.GetDroppedPacketCount()==0);
+
+    // now the program holds on to C. B's buffer takes the next packet and
+    // the one after that has nowhere to go
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetA, 1)!=0);
+    hostRegisters.Advance(TEST_PACKET_CYCLES(3));
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetB, 1)!=0);
+    hostRegisters.Advance(TEST_PACKET_CYCLES(2));
+    HOSTTEST_CHECK(radioObj.GetRxPacketCount()==4);
+    HOSTTEST_CHECK(radioObj.GetDroppedPacketCount()==1);
+
+    // a bad CRC is counted and thrown away
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetB, 0)!=0);
+    hostRegisters.Advance(TEST_PACKET_CYCLES(2));
+    HOSTTEST_CHECK(radioObj.GetCrcErrorCount()==1);
+    HOSTTEST_CHECK(radioObj.GetRxPacketCount()==4);
+
+    // nothing is heard on another frequency
+    HOSTTEST_CHECK(hostRegisters.InjectRadioPacket(RADIO_DEFAULT_FREQUENCY+1, RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX, packetB, 1)==0);
+
+    // C is still first in line, then the A sent after it
+    HOSTTEST_CHECK(radioObj.GetReceivedPacket()==packetPtrC);
+    radioObj.ReleasePacket();
+    HOSTTEST_CHECK(radioObj.GetReceivedPacket()==packetPtrB);
+    HOSTTEST_CHECK(packetPtrB->lengthByte==3);
+    radioObj.ReleasePacket();
+    HOSTTEST_CHECK(radioObj.GetReceivedPacket()==NULL);
+
+    // stopping switches the RADIO off
+    radioObj.StopReceive();
+    HOSTTEST_CHECK(radioObj.GetState()==RADIO_STATE_IDLE);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)==RADIO_HWSTATE_DISABLED);
+    HOSTTEST_CHECK(hostRegisters.GetUnmappedCount()==0);
+
+    return HostTestFinish("RADIO");
+}
@@ -0,0 +1,272 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_RNG.h"
+
+// GetRngValue() is the simple way to get a random number and it has to give
+// the value the peripheral made (not a stale one) at the cost of reading 
+// VALRDY, reading VALUE and clearing VALRDY. The host RNG model makes its
+// values with xorshift from a known seed so the exact values can be checked.
+//
+// In pool mode the RNG interrupt fills the pool, the RNG must stop when it is
+// full (it uses power) and start again once a reader takes it down to 
+// RNG_POOL_REFILL_LEVEL bytes. TryGetBytes() never waits - if there are not 
+// enough bytes it takes none at all - and when the pool is above the refill 
+// level it must not touch a register.
+//
+// The health tests are checked with a broken RNG (see SetRngStuckValue() in
+// the host model). Stuck on one value the Repetition Count Test must trip on
+// the RNG_HEALTH_RCT_CUTOFF'th value in a row. Stuck on every other value 
+// nothing repeats but the Adaptive Proportion Test must trip when the first 
+// value of the window has come up RNG_HEALTH_APT_CUTOFF times. After a failure
+// nothing more goes in the pool until ClearHealthFailures().
+//
+// The conditioning must account for every bit: von Neumann gives one bit for 
+// each 01 or 10 pair and the hash one byte for every RNG_HASH_INPUT_BYTES.
+
+/* NextModelValue - works out the next value the host RNG model will make
+ *
+ * inputs:
+ *    statePtr - the xorshift state, updated
+ * returns:
+ *    the 8 bit value
+ * */
+static unsigned int NextModelValue(unsigned int *statePtr)
+{
+    unsigned int rngState = *statePtr;
+    rngState = rngState ^ (rngState<<13);
+    rngState = rngState ^ (rngState>>17);
+    rngState = rngState ^ (rngState<<5);
+    *statePtr = rngState;
+    return rngState & 0xFF;
+}
+
+/* DrainPool - takes everything there is out of the pool
+ *
+ * inputs:
+ *    rngObj - the RNG
+ * */
+static void DrainPool(YakIO_RNG &rngObj)
+{
+    unsigned char drainByte;
+    while(rngObj.TryGetBytes(&drainByte, 1)!=0) {}
+}
+
+int main(void)
+{
+    hostRegisters.Reset();
+    hostRegisters.SetRngSeed(0x12345678);
+    unsigned int modelState = 0x12345678;
+    YakIO_RNG rngObj;
+
+    // each value is the next one the peripheral makes, for two reads and a write
+    rngObj.RngStart();
+    for(int i=0; i<8; i++)
+    {
+        unsigned int expectedValue = NextModelValue(&modelState);
+        hostRegisters.ResetCounters();
+        unsigned int rngValue = rngObj.GetRngValue();
+        HOSTTEST_CHECK(rngValue==expectedValue);
+        HOSTTEST_CHECK(hostRegisters.GetReadCount()==2);
+        HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+        HOSTTEST_CHECK(hostRegisters.GetReadCount(REGISTER_RNG)==2);
+        HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RNG+RNGREG_OFFSET_VALRDY)==0);
+    }
+
+    // a value made while nobody was reading is the one returned, not a new one
+    unsigned int expectedValue = NextModelValue(&modelState);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RNG+RNGREG_OFFSET_VALRDY)!=0);
+    HOSTTEST_CHECK(rngObj.GetRngValue()==expectedValue);
+    rngObj.RngStop();
+
+    // the pool fills one byte for every value the RNG makes
+    rngObj.PoolStart();
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*(RNG_POOL_BYTES-1));
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_POOL_BYTES-1);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_POOL_BYTES);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_POOL_BYTES);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()==RNG_POOL_BYTES);
+
+    // once it is full the RNG is stopped and makes nothing more
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*10);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_POOL_BYTES);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_RNG+RNGREG_OFFSET_VALRDY)==0);
+
+    // the bytes are the values the RNG made, in order. Above the refill
+    // level taking them costs no register accesses at all
+    unsigned char poolBytes[RNG_POOL_BYTES];
+    unsigned char expectedBytes[RNG_POOL_BYTES];
+    for(int i=0; i<RNG_POOL_BYTES; i++) expectedBytes[i] = (unsigned char)NextModelValue(&modelState);
+    hostRegisters.ResetCounters();
+    HOSTTEST_CHECK(rngObj.TryGetBytes(poolBytes, 16)!=0);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==0);
+    HOSTTEST_CHECK_BYTES(poolBytes, expectedBytes, 16);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_POOL_BYTES-16);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*10);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_POOL_BYTES);
+
+    // taking it down to the refill level starts the RNG again
+    HOSTTEST_CHECK(rngObj.TryGetBytes(poolBytes+16, RNG_POOL_BYTES-16-RNG_POOL_REFILL_LEVEL)!=0);
+    HOSTTEST_CHECK_BYTES(poolBytes+16, expectedBytes+16, RNG_POOL_BYTES-16-RNG_POOL_REFILL_LEVEL);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_POOL_REFILL_LEVEL);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_POOL_REFILL_LEVEL+1);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_POOL_BYTES+1);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*RNG_POOL_BYTES);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_POOL_BYTES);
+
+    // with too few bytes nothing is taken and the buffer is left alone
+    HOSTTEST_CHECK(rngObj.TryGetBytes(poolBytes, RNG_POOL_BYTES)!=0);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==0);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*3);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==3);
+    memset(poolBytes, 0xAA, sizeof(poolBytes));
+    HOSTTEST_CHECK(rngObj.TryGetBytes(poolBytes, 4)==0);
+    HOSTTEST_CHECK(poolBytes[0]==0xAA);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==3);
+    unsigned int randomValue = 0x12345678;
+    HOSTTEST_CHECK(rngObj.GetU32(&randomValue)==0);
+    HOSTTEST_CHECK(randomValue==0x12345678);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+    HOSTTEST_CHECK(rngObj.GetU32(&randomValue)!=0);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==0);
+
+    // stopping the pool stops the RNG and empties it
+    rngObj.PoolStop();
+    HOSTTEST_CHECK(rngObj.IsPoolRunning()==0);
+    HOSTTEST_CHECK(rngObj.TryGetBytes(poolBytes, 1)==0);
+
+    // stuck on one value. The values before the cutoff go in the pool, the
+    // one that trips the Repetition Count Test and everything after do not
+    hostRegisters.SetRngStuckValue(0x5A, 1);
+    rngObj.PoolStart();
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*(RNG_HEALTH_RCT_CUTOFF-1));
+    HOSTTEST_CHECK(rngObj.HasHealthFailed()==0);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_HEALTH_RCT_CUTOFF-1);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+    HOSTTEST_CHECK(rngObj.HasHealthFailed()!=0);
+    HOSTTEST_CHECK(rngObj.GetRepetitionFailureCount()==1);
+    HOSTTEST_CHECK(rngObj.GetProportionFailureCount()==0);
+    HOSTTEST_CHECK(rngObj.GetHealthFailureCount()==1);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_HEALTH_RCT_CUTOFF);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()==RNG_HEALTH_RCT_CUTOFF-1);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==RNG_HEALTH_RCT_CUTOFF-1);
+
+    // the failure stops the RNG and a reader emptying the pool does not 
+    // start it again
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*20);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_HEALTH_RCT_CUTOFF);
+    HOSTTEST_CHECK(rngObj.GetRepetitionFailureCount()==1);
+    DrainPool(rngObj);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*20);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_HEALTH_RCT_CUTOFF);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==0);
+
+    // mended and cleared the RNG starts and the pool fills again
+    hostRegisters.SetRngStuckValue(0, 0);
+    rngObj.ClearHealthFailures();
+    HOSTTEST_CHECK(rngObj.HasHealthFailed()==0);
+    HOSTTEST_CHECK(rngObj.GetHealthFailureCount()==0);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*5);
+    HOSTTEST_CHECK(rngObj.HasHealthFailed()==0);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==5);
+    rngObj.PoolStop();
+
+    // stuck on every other value. Work out where the first value of the 
+    // window comes up for the RNG_HEALTH_APT_CUTOFF'th time
+    hostRegisters.SetRngSeed(0x0BADF00D);
+    modelState = 0x0BADF00D;
+    hostRegisters.SetRngStuckValue(0x5A, 2);
+    unsigned int aptTripSample = 0;
+    unsigned int aptMatchCount = 0;
+    for(unsigned int i=0; i<RNG_HEALTH_APT_WINDOW; i++)
+    {
+        unsigned int modelValue = NextModelValue(&modelState);
+        if((i & 0x01)==0) modelValue = 0x5A;
+        if(modelValue==0x5A) aptMatchCount++;
+        if(aptMatchCount==RNG_HEALTH_APT_CUTOFF)
+        {
+            aptTripSample = i+1;
+            break;
+        }
+    }
+    HOSTTEST_CHECK(aptTripSample!=0);
+    rngObj.PoolStart();
+    for(unsigned int i=1; i<aptTripSample; i++)
+    {
+        hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+        DrainPool(rngObj);
+    }
+    HOSTTEST_CHECK(rngObj.HasHealthFailed()==0);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()==aptTripSample-1);
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE);
+    HOSTTEST_CHECK(rngObj.HasHealthFailed()!=0);
+    HOSTTEST_CHECK(rngObj.GetProportionFailureCount()==1);
+    HOSTTEST_CHECK(rngObj.GetRepetitionFailureCount()==0);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==aptTripSample);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()==aptTripSample-1);
+    rngObj.PoolStop();
+    hostRegisters.SetRngStuckValue(0, 0);
+
+    // von Neumann. Each 01 pair is a 0, each 10 pair a 1, the rest nothing
+    hostRegisters.SetRngSeed(0x600DCAFE);
+    modelState = 0x600DCAFE;
+    unsigned int vonNeumannBits = 0;
+    unsigned int vonNeumannCount = 0;
+    unsigned int vonNeumannBytes = 0;
+    for(int i=0; i<100; i++)
+    {
+        unsigned int modelValue = NextModelValue(&modelState);
+        for(int j=0; j<RNG_BITS_IN_BYTE; j=j+2)
+        {
+            unsigned int bitPair = (modelValue>>j) & 0x03;
+            if((bitPair!=0x01) && (bitPair!=0x02)) continue;
+            vonNeumannBits = (vonNeumannBits<<1) | (bitPair & 0x01);
+            vonNeumannCount++;
+            if(vonNeumannCount==RNG_BITS_IN_BYTE)
+            {
+                expectedBytes[vonNeumannBytes++] = (unsigned char)vonNeumannBits;
+                vonNeumannBits = 0;
+                vonNeumannCount = 0;
+            }
+        }
+    }
+    // about one bit for every two pairs
+    HOSTTEST_CHECK((vonNeumannBytes>15) && (vonNeumannBytes<35));
+    rngObj.SetConditioning(RNG_CONDITIONING_VONNEUMANN);
+    rngObj.PoolStart();
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*100);
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==100);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()==vonNeumannBytes);
+    HOSTTEST_CHECK(rngObj.GetPoolCount()==vonNeumannBytes);
+    HOSTTEST_CHECK(rngObj.TryGetBytes(poolBytes, vonNeumannBytes)!=0);
+    HOSTTEST_CHECK_BYTES(poolBytes, expectedBytes, vonNeumannBytes);
+    rngObj.PoolStop();
+
+    // the hash. One byte out for every RNG_HASH_INPUT_BYTES in
+    rngObj.SetConditioning(RNG_CONDITIONING_HASH);
+    rngObj.PoolStart();
+    hostRegisters.Advance(HOSTREG_RNG_CYCLES_PER_VALUE*(RNG_HASH_INPUT_BYTES*10+1));
+    HOSTTEST_CHECK(rngObj.GetRawSampleCount()==RNG_HASH_INPUT_BYTES*10+1);
+    HOSTTEST_CHECK(rngObj.GetPoolOutputCount()==10);
+    rngObj.PoolStop();
+
+    return HostTestFinish("RNG");
+}
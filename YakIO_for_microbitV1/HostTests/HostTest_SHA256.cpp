@@ -0,0 +1,69 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_SHA256.h"
+
+// Known answers from the FIPS 180-4 SHA-256 examples (and the NIST CSRC 
+// example values that go with it): "abc" which fits in one block, the 56 
+// byte message which needs a second block just for the padding, a million 
+// "a"s and the empty message. The long ones also go in through Update() in 
+// awkward sized pieces so the joins between the blocks get tested too.
+
+int main(void)
+{
+    YakIO_SHA256 shaObj;
+    unsigned char hashBytes[SHA256_HASH_BYTES];
+    unsigned char expectedBytes[SHA256_HASH_BYTES];
+
+    // "abc", all in one go
+    shaObj.Hash((const unsigned char *)"abc", 3, hashBytes);
+    HostTestHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", expectedBytes);
+    HOSTTEST_CHECK_BYTES(hashBytes, expectedBytes, SHA256_HASH_BYTES);
+
+    // the empty message is just the padding
+    shaObj.Hash((const unsigned char *)"", 0, hashBytes);
+    HostTestHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", expectedBytes);
+    HOSTTEST_CHECK_BYTES(hashBytes, expectedBytes, SHA256_HASH_BYTES);
+
+    // 56 bytes. The 0x80 and the length do not fit after it so the padding 
+    // takes a block of its own. One byte at a time and then in two pieces
+    const char *twoBlockText = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    HostTestHex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", expectedBytes);
+    shaObj.Start();
+    for(unsigned int i=0; i<56; i++) shaObj.Update((const unsigned char *)&twoBlockText[i], 1);
+    HOSTTEST_CHECK(shaObj.GetByteCount()==56);
+    shaObj.Finish(hashBytes);
+    HOSTTEST_CHECK_BYTES(hashBytes, expectedBytes, SHA256_HASH_BYTES);
+    shaObj.Start();
+    shaObj.Update((const unsigned char *)twoBlockText, 13);
+    shaObj.Update((const unsigned char *)&twoBlockText[13], 43);
+    shaObj.Finish(hashBytes);
+    HOSTTEST_CHECK_BYTES(hashBytes, expectedBytes, SHA256_HASH_BYTES);
+
+    // a million "a"s in pieces of 1000. That is 15625 blocks and none of 
+    // the pieces line up with them
+    unsigned char aBytes[1000];
+    memset(aBytes, 'a', sizeof(aBytes));
+    shaObj.Start();
+    for(unsigned int i=0; i<1000; i++) shaObj.Update(aBytes, sizeof(aBytes));
+    HOSTTEST_CHECK(shaObj.GetByteCount()==1000000);
+    shaObj.Finish(hashBytes);
+    HostTestHex("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", expectedBytes);
+    HOSTTEST_CHECK_BYTES(hashBytes, expectedBytes, SHA256_HASH_BYTES);
+
+    return HostTestFinish("SHA256");
+}
@@ -0,0 +1,209 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_HOSTMEDIUM.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_TIMESYNC.h"
+#include "YakIO_TDMA.h"
+
+// Two micro:bits on the simulated medium (see YakIO_HOSTMEDIUM.h), a 
+// coordinator and a node, each running the real YakIO_RADIO, YakIO_TIMESYNC 
+// and YakIO_TDMA on its own register file with its own crystal.
+//
+//    The node joins and is given data slot 0. The data it queues arrives at
+//       the coordinator, in order, from that slot.
+//    With a quarter of the beacons lost (SetPacketLoss()) the node keeps to 
+//       the superframes on the beacons it does hear - it stays joined and 
+//       nothing it sends goes missing.
+//    The node starts again as a second node id. Slot 0 is still held for the
+//       first so it is given slot 1.
+//    Nothing is heard from slot 0 for TDMA_SLOT_TIMEOUT superframes so it is
+//       freed. The node starts again as a third id and is given slot 0.
+//    Slot 1 then times out as well and the superframe shrinks to one slot.
+
+#define TEST_COORDINATOR_PPM   12
+#define TEST_NODE_PPM          -18
+#define TEST_STEP_CYCLES       4000      // one step of the MainLoop()s is 250us
+#define TEST_STEPS_PER_MS      4
+#define TEST_JOIN_MS           400       // the longest a join may take
+#define TEST_NODE_ID_A         0x1001
+#define TEST_NODE_ID_B         0x2002
+#define TEST_NODE_ID_C         0x3003
+
+// the medium holds a register file for the second micro:bit, it is too 
+// big for the stack. The YakIO objects for each node are created after 
+// that node is selected, so they are made in main()
+YakIO_HOSTMEDIUM medium;
+YakIO_TDMA *coordinatorPtr = NULL;
+YakIO_TDMA *nodePtr = NULL;
+
+// what the MainLoop()s see
+unsigned int nextSequence = 0;
+unsigned int receivedCount = 0;
+unsigned int sequenceErrorCount = 0;
+unsigned int lastDataSlot = TDMA_NO_SLOT;
+unsigned int stateLostCount = 0;
+
+/* RunNetwork - moves both micro:bits on and runs their MainLoop()s. The
+ *    node queues a numbered packet whenever the last one has gone and the
+ *    coordinator checks they arrive in order
+ *
+ * inputs:
+ *    msToRun - how long for, in milliseconds
+ *    stopWhenJoined - nz to stop early once the node has a slot
+ * */
+static void RunNetwork(unsigned int msToRun, unsigned int stopWhenJoined)
+{
+    for(unsigned int i=0; i<(msToRun*TEST_STEPS_PER_MS); i++)
+    {
+        medium.Advance(TEST_STEP_CYCLES);
+
+        // the coordinator's MainLoop()
+        medium.SelectNode(0);
+        struct YakIO_RADIOPACKET *packetPtr = coordinatorPtr->GetReceivedData();
+        while(packetPtr!=NULL)
+        {
+            unsigned int packetSequence = 0;
+            for(int j=0; j<4; j++) packetSequence = packetSequence | (packetPtr->payloadBytes[TDMA_DATA_OFFSET_PAYLOAD+j]<<(8*j));
+            if((packetPtr->lengthByte!=TDMA_DATA_OFFSET_PAYLOAD+4) || (packetSequence!=receivedCount)) sequenceErrorCount++;
+            lastDataSlot = packetPtr->payloadBytes[TDMA_DATA_OFFSET_SLOT];
+            receivedCount++;
+            coordinatorPtr->ReleaseData();
+            packetPtr = coordinatorPtr->GetReceivedData();
+        }
+
+        // the node's MainLoop()
+        medium.SelectNode(1);
+        enum TDMA_STATE stateWas = nodePtr->GetState();
+        nodePtr->GetReceivedData();
+        if((stateWas==TDMA_STATE_JOINED) && (nodePtr->GetState()!=TDMA_STATE_JOINED)) stateLostCount++;
+        if((nodePtr->GetState()==TDMA_STATE_JOINED) && (nodePtr->IsDataQueued()==0))
+        {
+            unsigned char dataBytes[4];
+            for(int j=0; j<4; j++) dataBytes[j] = (nextSequence>>(8*j)) & 0xFF;
+            if(nodePtr->QueueData(dataBytes, 4)!=0) nextSequence++;
+        }
+        if((stopWhenJoined!=0) && (nodePtr->GetState()==TDMA_STATE_JOINED)) return;
+    }
+}
+
+int main(void)
+{
+    medium.Reset();
+    medium.SetClockPpm(0, TEST_COORDINATOR_PPM);
+    medium.SetClockPpm(1, TEST_NODE_PPM);
+
+    medium.SelectNode(0);
+    YakIO_RADIO coordinatorRadio;
+    YakIO_TIMESYNC coordinatorSync {&coordinatorRadio};
+    YakIO_TDMA coordinatorTdma {&coordinatorRadio, &coordinatorSync};
+    coordinatorPtr = &coordinatorTdma;
+    coordinatorRadio.Start();
+    coordinatorTdma.Start(TDMA_ROLE_COORDINATOR, 0);
+    HOSTTEST_CHECK(coordinatorTdma.GetState()==TDMA_STATE_COORDINATING);
+    HOSTTEST_CHECK(coordinatorTdma.GetNodeCount()==0);
+
+    medium.SelectNode(1);
+    YakIO_RADIO nodeRadio;
+    YakIO_TIMESYNC nodeSync {&nodeRadio};
+    YakIO_TDMA nodeTdma {&nodeRadio, &nodeSync};
+    nodePtr = &nodeTdma;
+    nodeRadio.Start();
+    nodeTdma.Start(TDMA_ROLE_NODE, TEST_NODE_ID_A);
+    HOSTTEST_CHECK(nodeTdma.GetState()==TDMA_STATE_SEARCHING);
+
+    // the first node to join gets slot 0
+    RunNetwork(TEST_JOIN_MS, 1);
+    medium.SelectNode(1);
+    HOSTTEST_CHECK(nodeTdma.GetState()==TDMA_STATE_JOINED);
+    HOSTTEST_CHECK(nodeTdma.GetSlot()==0);
+    HOSTTEST_CHECK(nodeSync.IsSynchronized()!=0);
+
+    // its data arrives, every packet in order, from slot 0
+    RunNetwork(200, 0);
+    medium.SelectNode(0);
+    HOSTTEST_CHECK(coordinatorTdma.GetNodeCount()==1);
+    HOSTTEST_CHECK(receivedCount>50);
+    HOSTTEST_CHECK(sequenceErrorCount==0);
+    HOSTTEST_CHECK(lastDataSlot==0);
+    medium.SelectNode(1);
+    HOSTTEST_CHECK(nodeTdma.GetSentDataCount()>=receivedCount);
+    HOSTTEST_CHECK(nodeTdma.GetSentDataCount()<=receivedCount+1);
+
+    // a quarter of the beacons are lost. The node carries on regardless
+    unsigned int receivedBefore = receivedCount;
+    unsigned int lostBefore = medium.GetLostCount();
+    medium.SetPacketLoss(0, 4);
+    RunNetwork(500, 0);
+    medium.SetPacketLoss(0, 0);
+    unsigned int beaconsLost = medium.GetLostCount() - lostBefore;
+    HOSTTEST_CHECK(beaconsLost>50);
+    HOSTTEST_CHECK(stateLostCount==0);
+    medium.SelectNode(1);
+    HOSTTEST_CHECK(nodeTdma.GetState()==TDMA_STATE_JOINED);
+    HOSTTEST_CHECK(nodeTdma.GetSlot()==0);
+    HOSTTEST_CHECK(nodeSync.IsSynchronized()!=0);
+    HOSTTEST_CHECK((receivedCount-receivedBefore)>100);
+    HOSTTEST_CHECK(sequenceErrorCount==0);
+
+    // a second node id. Slot 0 is still held so it gets slot 1
+    medium.SelectNode(1);
+    nodeTdma.Start(TDMA_ROLE_NODE, TEST_NODE_ID_B);
+    receivedCount = 0;
+    nextSequence = 0;
+    RunNetwork(TEST_JOIN_MS, 1);
+    medium.SelectNode(1);
+    HOSTTEST_CHECK(nodeTdma.GetState()==TDMA_STATE_JOINED);
+    HOSTTEST_CHECK(nodeTdma.GetSlot()==1);
+    RunNetwork(20, 0);
+    HOSTTEST_CHECK(lastDataSlot==1);
+    HOSTTEST_CHECK(sequenceErrorCount==0);
+    medium.SelectNode(0);
+    HOSTTEST_CHECK(coordinatorTdma.GetNodeCount()==2);
+
+    // nothing is heard in slot 0 for TDMA_SLOT_TIMEOUT superframes, it is 
+    // freed and the next node id to join gets it
+    unsigned int superframesRun = coordinatorTdma.GetSuperframeCount();
+    while((coordinatorTdma.GetSuperframeCount()-superframesRun)<=TDMA_SLOT_TIMEOUT+2) RunNetwork(1, 0);
+    medium.SelectNode(1);
+    nodeTdma.Start(TDMA_ROLE_NODE, TEST_NODE_ID_C);
+    receivedCount = 0;
+    nextSequence = 0;
+    RunNetwork(TEST_JOIN_MS, 1);
+    medium.SelectNode(1);
+    HOSTTEST_CHECK(nodeTdma.GetState()==TDMA_STATE_JOINED);
+    HOSTTEST_CHECK(nodeTdma.GetSlot()==0);
+
+    // and slot 1 times out too, the superframe shrinks back to one slot
+    medium.SelectNode(0);
+    HOSTTEST_CHECK(coordinatorTdma.GetNodeCount()==2);
+    superframesRun = coordinatorTdma.GetSuperframeCount();
+    while((coordinatorTdma.GetSuperframeCount()-superframesRun)<=TDMA_SLOT_TIMEOUT+2) RunNetwork(1, 0);
+    medium.SelectNode(0);
+    HOSTTEST_CHECK(coordinatorTdma.GetNodeCount()==1);
+    HOSTTEST_CHECK(lastDataSlot==0);
+    HOSTTEST_CHECK(sequenceErrorCount==0);
+
+    // the RADIO always had somewhere to put a packet and every window was on time
+    HOSTTEST_CHECK(coordinatorRadio.GetDroppedPacketCount()==0);
+    HOSTTEST_CHECK(coordinatorTdma.GetMissedWindowCount()==0);
+    medium.SelectNode(1);
+    HOSTTEST_CHECK(nodeRadio.GetDroppedPacketCount()==0);
+    HOSTTEST_CHECK(nodeTdma.GetMissedWindowCount()==0);
+
+    return HostTestFinish("TDMA");
+}
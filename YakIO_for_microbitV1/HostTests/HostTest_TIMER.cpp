@@ -0,0 +1,90 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_TIMER.h"
+
+// QuickSetup() is how nearly every timer in YakIO is started, so it must leave
+// the registers exactly as the comments on it say: the prescaler and count 
+// level set, COMPARE0 clearing the count, the COMPARE0 interrupt enabled and 
+// the timer's IRQ enabled in the NVIC. The callback must then be called from
+// the IRQ handler once per period - not early, not late and not twice for one
+// compare. The handler's own register cost (clearing the event) is checked 
+// too because it is paid on every tick.
+
+/* TimerCounter - counts the callbacks the timer makes
+ * */
+class TimerCounter : public YakIO_CALLBACK
+{
+  public:
+      unsigned int tickCount =0;
+      void Callback0() override { tickCount++; }
+};
+
+int main(void)
+{
+    hostRegisters.Reset();
+    TimerCounter timerCounter;
+    YakIO_TIMER timerObj(Timer1);
+
+    // prescaler 4 is 1MHz, so a count of 1000 is every millisecond, 16000 cycles
+    hostRegisters.ResetCounters();
+    timerObj.QuickSetup(4, 1000, CALLBACK_0, &timerCounter);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==10);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==2);
+    HOSTTEST_CHECK(hostRegisters.GetUnmappedCount()==0);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_TIMER1+TIMERREG_OFFSET_PRESCALER)==4);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_TIMER1+TIMERREG_OFFSET_CC_0)==1000);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_TIMER1+TIMERREG_OFFSET_BITMODE)==TIMER_BITMODE_16Bit);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_TIMER1+TIMERREG_OFFSET_SHORTS) & TIMER_SHORT_COMPARE0_CLEAR)!=0);
+    HOSTTEST_CHECK((hostRegisters.Peek(REGISTER_NVIC+NVICREG_OFFSET_ISER) & (0x01u<<IRQ_TIMER1))!=0);
+    HOSTTEST_CHECK(timerCounter.tickCount==0);
+
+    // nothing until the compare
+    hostRegisters.Advance(15999);
+    HOSTTEST_CHECK(timerCounter.tickCount==0);
+    HOSTTEST_CHECK(hostRegisters.GetIRQCount()==0);
+
+    // one call at the compare and the handler clears the event
+    hostRegisters.ResetCounters();
+    hostRegisters.Advance(1);
+    HOSTTEST_CHECK(timerCounter.tickCount==1);
+    HOSTTEST_CHECK(hostRegisters.GetIRQCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetWriteCount()==1);
+    HOSTTEST_CHECK(hostRegisters.GetReadCount()==0);
+    HOSTTEST_CHECK(hostRegisters.Peek(REGISTER_TIMER1+TIMERREG_OFFSET_COMPARE_0)==0);
+
+    // and one a millisecond after that
+    hostRegisters.Advance(16000*10);
+    HOSTTEST_CHECK(timerCounter.tickCount==11);
+    HOSTTEST_CHECK(hostRegisters.GetIRQCount()==11);
+
+    // with the IRQ disabled in the NVIC the callback is not called
+    timerObj.DisableTimerIRQ();
+    hostRegisters.Advance(16000*5);
+    HOSTTEST_CHECK(timerCounter.tickCount==11);
+
+    // a stopped timer does not count. The compares made while the IRQ was 
+    // disabled left it pending in the NVIC so that has to be cleared too
+    timerObj.TimerStop();
+    timerObj.ClearCompareEvent();
+    ClearPendingIRQ(IRQ_TIMER1);
+    timerObj.EnableTimerIRQ();
+    hostRegisters.Advance(16000*5);
+    HOSTTEST_CHECK(timerCounter.tickCount==11);
+
+    return HostTestFinish("TIMER");
+}
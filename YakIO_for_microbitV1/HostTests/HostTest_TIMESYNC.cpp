@@ -0,0 +1,154 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "HostTest.h"
+#include "YakIO_HOSTMEDIUM.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_TIMESYNC.h"
+
+// Two micro:bits on the simulated medium (see YakIO_HOSTMEDIUM.h), a
+// reference and a follower, each running the real YakIO_RADIO and 
+// YakIO_TIMESYNC on its own register file. The reference's crystal is 
+// TEST_REFERENCE_PPM fast and the follower's TEST_FOLLOWER_PPM slow, so
+// their TIMER0s drift apart by the difference, and the follower's is 
+// started a few milliseconds late as well.
+//
+// The reference sends a beacon every second. Once the follower has three
+// it must say it is synchronized, its GetNetworkTime() must agree with 
+// the reference's TIMER0 to within TEST_MAX_ERROR_TICKS all the way to 
+// the next beacon and GetSkewPpb() must settle on the real difference.
+
+#define TEST_REFERENCE_PPM     20
+#define TEST_FOLLOWER_PPM      -15
+#define TEST_FOLLOWER_DELAY    59200     // 3.7ms, in 16MHz cycles
+#define TEST_BEACON_COUNT      12
+#define TEST_STEPS_PER_BEACON  1000      // one step of the MainLoop() is a millisecond ...
+#define TEST_STEP_CYCLES       16000     // ... of 16MHz cycles
+#define TEST_MAX_ERROR_TICKS   3
+#define TEST_MAX_SKEW_ERROR    1000      // ppb
+
+// the medium holds a register file for the second micro:bit, it is too 
+// big for the stack. The YakIO objects for each node are created after 
+// that node is selected, so they are made in main()
+YakIO_HOSTMEDIUM medium;
+
+int main(void)
+{
+    medium.Reset();
+    medium.SetClockPpm(0, TEST_REFERENCE_PPM);
+    medium.SetClockPpm(1, TEST_FOLLOWER_PPM);
+
+    medium.SelectNode(0);
+    YakIO_RADIO referenceRadio;
+    YakIO_TIMESYNC referenceSync {&referenceRadio};
+    referenceRadio.Start();
+    referenceSync.Start(TIMESYNC_ROLE_REFERENCE);
+
+    medium.Advance(TEST_FOLLOWER_DELAY);
+
+    medium.SelectNode(1);
+    YakIO_RADIO followerRadio;
+    YakIO_TIMESYNC followerSync {&followerRadio};
+    followerRadio.Start();
+    followerRadio.StartReceive();
+    followerSync.Start(TIMESYNC_ROLE_FOLLOWER);
+    HOSTTEST_CHECK(followerSync.IsSynchronized()==0);
+
+    // the real difference in the two clock rates, in ppb
+    long long expectedSkew = ((long long)(HOSTMEDIUM_PPM_SCALE+TEST_REFERENCE_PPM)*1000000000)/(HOSTMEDIUM_PPM_SCALE+TEST_FOLLOWER_PPM) - 1000000000;
+
+    int startOffset = 0;
+    int worstError = 0;
+    unsigned int errorCount = 0;
+    unsigned int beaconsSent = 0;
+    unsigned int beaconsHeard = 0;
+    unsigned int syncedAtBeacon = 0;
+    for(int beaconIndex=0; beaconIndex<TEST_BEACON_COUNT; beaconIndex++)
+    {
+        medium.SelectNode(0);
+        if(referenceSync.SendBeacon()!=0) beaconsSent = beaconsSent + 1;
+
+        for(int stepIndex=0; stepIndex<TEST_STEPS_PER_BEACON; stepIndex++)
+        {
+            medium.Advance(TEST_STEP_CYCLES);
+
+            // the follower's MainLoop()
+            medium.SelectNode(1);
+            struct YakIO_RADIOPACKET *packetPtr = followerRadio.GetReceivedPacket();
+            if(packetPtr!=NULL)
+            {
+                if(followerSync.ProcessPacket(packetPtr)!=0) beaconsHeard = beaconsHeard + 1;
+                followerRadio.ReleasePacket();
+                if((syncedAtBeacon==0) && (followerSync.IsSynchronized()!=0)) syncedAtBeacon = beaconsHeard;
+            }
+
+            // both clocks read at the same instant
+            unsigned int followerLocal = followerSync.GetLocalTime();
+            unsigned int followerNetwork = followerSync.GetNetworkTime();
+            medium.SelectNode(0);
+            unsigned int referenceLocal = referenceSync.GetLocalTime();
+            if((beaconIndex==0) && (stepIndex==0)) startOffset = (int)(referenceLocal - followerLocal);
+
+            // from the beacon after the one that synchronized us, the
+            // network time has to be right all the time
+            if((syncedAtBeacon==0) || (beaconsHeard<=syncedAtBeacon)) continue;
+            int syncError = (int)(referenceLocal - followerNetwork);
+            if(syncError<0) syncError = -syncError;
+            if(syncError>worstError) worstError = syncError;
+            if(syncError>TEST_MAX_ERROR_TICKS) errorCount = errorCount + 1;
+        }
+    }
+
+    // every beacon went out and was heard, through the medium
+    HOSTTEST_CHECK(beaconsSent==TEST_BEACON_COUNT);
+    HOSTTEST_CHECK(medium.GetDeliveredCount()==TEST_BEACON_COUNT);
+    HOSTTEST_CHECK(beaconsHeard==TEST_BEACON_COUNT);
+    HOSTTEST_CHECK(followerSync.GetBeaconCount()==TEST_BEACON_COUNT);
+    HOSTTEST_CHECK(followerRadio.GetDroppedPacketCount()==0);
+
+    // the two TIMER0s really are apart - the follower started 3.7ms
+    // late and the gap grows by the skew every second
+    medium.SelectNode(1);
+    unsigned int followerLocal = followerSync.GetLocalTime();
+    unsigned int followerNetwork = followerSync.GetNetworkTime();
+    medium.SelectNode(0);
+    unsigned int referenceLocal = referenceSync.GetLocalTime();
+    int endOffset = (int)(referenceLocal - followerLocal);
+    // ppb for a second is thousandths of a microsecond
+    int expectedDrift = (int)((expectedSkew*TEST_BEACON_COUNT)/1000);
+    HOSTTEST_CHECK((startOffset>3600) && (startOffset<3800));
+    HOSTTEST_CHECK((endOffset-startOffset)>(expectedDrift-10));
+    HOSTTEST_CHECK((endOffset-startOffset)<(expectedDrift+10));
+
+    // but the network time is the same on both
+    HOSTTEST_CHECK(syncedAtBeacon==3);
+    HOSTTEST_CHECK(followerSync.IsSynchronized()!=0);
+    HOSTTEST_CHECK(errorCount==0);
+    HOSTTEST_CHECK(worstError<=TEST_MAX_ERROR_TICKS);
+    int endError = (int)(referenceLocal - followerNetwork);
+    HOSTTEST_CHECK((endError>=-TEST_MAX_ERROR_TICKS) && (endError<=TEST_MAX_ERROR_TICKS));
+    HOSTTEST_CHECK((followerSync.GetLastSyncError()>=-TEST_MAX_ERROR_TICKS) && (followerSync.GetLastSyncError()<=TEST_MAX_ERROR_TICKS));
+
+    // and the skew has settled on the real one
+    long long skewError = followerSync.GetSkewPpb() - expectedSkew;
+    HOSTTEST_CHECK((skewError>-TEST_MAX_SKEW_ERROR) && (skewError<TEST_MAX_SKEW_ERROR));
+
+    // the reference is the network time
+    HOSTTEST_CHECK(referenceSync.IsSynchronized()!=0);
+    HOSTTEST_CHECK(referenceSync.GetNetworkTime()==referenceSync.GetLocalTime());
+
+    return HostTestFinish("TIMESYNC");
+}
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# +------------------------------------------------------------------------------------------------------------------------------+
+# ¦                                                   TERMS OF USE: MIT License                                                  ¦
+# +------------------------------------------------------------------------------------------------------------------------------¦
+# ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+# ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+# ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+# ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+# ¦                                                                                                                              ¦
+# ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+# ¦                                                                                                                              ¦
+# ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+# ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+# ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+# ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+# +------------------------------------------------------------------------------------------------------------------------------+
+
+# ProfileReport.py - turns the output of YakIO_PROFILER::Dump() back into function names so you can see where your program
+# spends its time. It needs the Main.elf the program was built from (the Makefile leaves it in _build/<PROFILE>/<EXAMPLE>/,
+# CompileProgram.bat leaves it in the example directory) and the arm-none-eabi-nm tool from the compiler.
+#
+# Usage:
+#
+#    python3 ProfileReport.py Main.elf capture.txt     - capture.txt is whatever the serial terminal saved
+#    python3 ProfileReport.py Main.elf < /dev/ttyACM0  - read straight from the microbit until the first PROFILE_END
+#
+# Set NM=path/to/arm-none-eabi-nm if it is not on the path. If a capture file holds more than one dump the last one is used.
+#
+# Each PROFILE_HIT line is a bucket - a small range of addresses - and a count. A bucket can hold the end of one function
+# and the start of the next. When that happens the count is shared out between them by the number of bytes each has in 
+# the bucket. That is a guess, so a small function next to a busy one can look busier than it really is. Use a smaller 
+# bucket (more PROFILER_NUM_BUCKETS) if that matters. The counts are shown with one decimal place because of the sharing.
+
+import os
+import subprocess
+import sys
+
+
+def ReadSymbols(elfFileName):
+    """Gets the code symbols from the elf file as a sorted list of (start, end, name)"""
+    nmTool = os.environ.get("NM", "arm-none-eabi-nm")
+    nmOutput = subprocess.run([nmTool, "-n", "-S", "-C", "--defined-only", elfFileName],
+                              check=True, capture_output=True, text=True).stdout
+    symbolList = []
+    for nmLine in nmOutput.splitlines():
+        nmFields = nmLine.split(None, 3)
+        # with a size:    address size type name
+        # without a size: address type name
+        if len(nmFields) == 4 and len(nmFields[2]) == 1:
+            startAddress, symbolSize, symbolType, symbolName = int(nmFields[0], 16), int(nmFields[1], 16), nmFields[2], nmFields[3]
+        elif len(nmFields) >= 3 and len(nmFields[1]) == 1:
+            startAddress, symbolSize, symbolType, symbolName = int(nmFields[0], 16), None, nmFields[1], nmFields[2]
+        else:
+            continue
+        if symbolType not in "tTwW":
+            continue
+        # the bottom bit of a Thumb function address is always set, it is not part of the address
+        startAddress = startAddress & ~1
+        symbolList.append([startAddress, symbolSize, symbolName])
+
+    symbolList.sort(key=lambda symbolEntry: symbolEntry[0])
+    # a symbol with no size runs until the next one
+    for i, symbolEntry in enumerate(symbolList):
+        if symbolEntry[1] is None or symbolEntry[1] == 0:
+            nextAddress = symbolList[i + 1][0] if i + 1 < len(symbolList) else symbolEntry[0] + 2
+            symbolEntry[1] = max(nextAddress - symbolEntry[0], 2)
+    return [(symbolEntry[0], symbolEntry[0] + symbolEntry[1], symbolEntry[2]) for symbolEntry in symbolList]
+
+
+def ReadProfile(captureFile, stopAtFirstDump):
+    """Gets the last complete dump from the capture (or the first if stopAtFirstDump) as a dictionary"""
+    profileDump = None
+    workingDump = None
+    for captureLine in captureFile:
+        captureFields = captureLine.strip().split()
+        if not captureFields:
+            continue
+        if captureFields[0] == "PROFILE_BEGIN":
+            workingDump = {"shift": 0, "samples": 0, "outside": 0, "hits": []}
+        elif workingDump is None:
+            continue
+        elif captureFields[0] == "PROFILE_BUCKET_SHIFT":
+            workingDump["shift"] = int(captureFields[1])
+        elif captureFields[0] == "PROFILE_SAMPLES":
+            workingDump["samples"] = int(captureFields[1])
+        elif captureFields[0] == "PROFILE_OUTSIDE":
+            workingDump["outside"] = int(captureFields[1])
+        elif captureFields[0] == "PROFILE_HIT":
+            workingDump["hits"].append((int(captureFields[1], 16), int(captureFields[2])))
+        elif captureFields[0] == "PROFILE_END":
+            profileDump = workingDump
+            workingDump = None
+            # reading from a serial port never ends by itself
+            if stopAtFirstDump:
+                break
+    return profileDump
+
+
+def Main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: ProfileReport.py Main.elf [capture.txt]\n")
+        return 2
+
+    symbolList = ReadSymbols(sys.argv[1])
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], errors="replace") as captureFile:
+            profileDump = ReadProfile(captureFile, False)
+    else:
+        profileDump = ReadProfile(sys.stdin, True)
+    if profileDump is None:
+        sys.stderr.write("ProfileReport.py: no PROFILE_BEGIN ... PROFILE_END found\n")
+        return 2
+
+    bucketSize = 1 << profileDump["shift"]
+    functionCounts = {}
+    for bucketAddress, bucketCount in profileDump["hits"]:
+        bucketEnd = bucketAddress + bucketSize
+        sharedBytes = 0
+        for startAddress, endAddress, symbolName in symbolList:
+            if endAddress <= bucketAddress:
+                continue
+            if startAddress >= bucketEnd:
+                break
+            overlapBytes = min(endAddress, bucketEnd) - max(startAddress, bucketAddress)
+            functionCounts[symbolName] = functionCounts.get(symbolName, 0.0) + (bucketCount * overlapBytes) / bucketSize
+            sharedBytes = sharedBytes + overlapBytes
+        # the part of the bucket no function covers (padding, constants)
+        if sharedBytes < bucketSize:
+            functionCounts["<no symbol>"] = functionCounts.get("<no symbol>", 0.0) + (bucketCount * (bucketSize - sharedBytes)) / bucketSize
+
+    totalSamples = profileDump["samples"]
+    if profileDump["outside"] > 0:
+        functionCounts["<outside code section>"] = float(profileDump["outside"])
+
+    print("%d samples, %d byte buckets" % (totalSamples, bucketSize))
+    print("%10s %7s  %s" % ("samples", "%", "function"))
+    for symbolName, symbolCount in sorted(functionCounts.items(), key=lambda countEntry: -countEntry[1]):
+        percentOfTotal = (100.0 * symbolCount / totalSamples) if totalSamples > 0 else 0.0
+        print("%10.1f %6.2f%%  %s" % (symbolCount, percentOfTotal, symbolName))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(Main())
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+# +------------------------------------------------------------------------------------------------------------------------------+
+# ¦                                                   TERMS OF USE: MIT License                                                  ¦
+# +------------------------------------------------------------------------------------------------------------------------------¦
+# ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+# ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+# ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+# ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+# ¦                                                                                                                              ¦
+# ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+# ¦                                                                                                                              ¦
+# ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+# ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+# ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+# ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+# +------------------------------------------------------------------------------------------------------------------------------+
+
+# TraceToJson.py - turns the binary output of YakIO_TRACE::Drain() into a JSON file that the Chrome trace viewer 
+# (chrome://tracing) and Perfetto (https://ui.perfetto.dev) can show as a timeline. See the note on the TRACE in
+# YakIO/Include/YakIO_TRACE.h for how to capture the output.
+#
+# Usage:
+#
+#    python3 TraceToJson.py trace.bin > trace.json
+#    python3 TraceToJson.py trace.bin names.txt > trace.json
+#
+# The optional names.txt gives names to your own event IDs, one per line - the ID (in decimal or 0x hex) then the name:
+#
+#    0x100 DoDivideWork
+#    0x101 ButtonPressed
+#
+# Interrupt handlers, callbacks and MarkBegin()/MarkEnd() pairs become bars. Mark() and TRACE_LOST become single points 
+# in time. Everything is on one timeline because the microbit has one CPU - an interrupt bar sits inside whatever bar it
+# interrupted.
+#
+# The timestamps are counts of a 16MHz timer. They wrap every 268 seconds and go back to zero when YakIO_TRACE::Start() is
+# called. Both are taken care of here as long as there are no gaps in the trace longer than 268 seconds.
+
+import json
+import sys
+
+TRACE_SYNC_BYTE = 0xA5
+TRACE_ENTRY_BYTES = 8
+TIMESTAMP_TICKS_PER_US = 16.0
+
+# see enum TRACE_EVENT_ID in YakIO_TRACE.h
+TRACE_IRQ_ENTRY = 1
+TRACE_IRQ_EXIT = 2
+TRACE_CALLBACK_ENTRY = 3
+TRACE_CALLBACK_EXIT = 4
+TRACE_USER_BEGIN = 5
+TRACE_USER_END = 6
+TRACE_LOST = 7
+TRACE_START = 8
+TRACE_USER_FIRST_ID = 0x100
+
+# see the IRQ_? defines in YakIO_NVIC.h
+IRQ_NAMES = {
+    0x00: "CLOCK", 0x01: "RADIO", 0x02: "UART0", 0x03: "SPI0/TWI0", 0x04: "SPI1/TWI1", 0x06: "GPIOTE", 0x07: "ADC",
+    0x08: "TIMER0", 0x09: "TIMER1", 0x0A: "TIMER2", 0x0B: "RTC0", 0x0C: "TEMP", 0x0D: "RNG", 0x0E: "ECB", 0x0F: "CCM/AAR",
+    0x10: "WDT", 0x11: "RTC1", 0x12: "QDEC", 0x13: "LPCOMP", 0x14: "SWI0", 0x15: "SWI1", 0x16: "SWI2", 0x17: "SWI3",
+    0x18: "SWI4", 0x19: "SWI5", 0x1E: "NVMC", 0x1F: "PPI",
+}
+
+# see enum CALLBACK_ID in YakIO_CALLBACK.h
+CALLBACK_NAMES = {1: "Callback0", 2: "Callback1", 3: "Callback2", 4: "Callback3", 5: "Heartbeat"}
+
+
+def ReadEntries(traceBytes):
+    """Gets the (timeStamp, eventID, eventArg) entries out of the raw serial capture"""
+    entryList = []
+    byteIndex = 0
+    while byteIndex + 1 + TRACE_ENTRY_BYTES <= len(traceBytes):
+        # anything that is not a sync byte is noise - the start of the capture, a 
+        # reset of the microbit, some text - so we just step over it
+        if traceBytes[byteIndex] != TRACE_SYNC_BYTE:
+            byteIndex = byteIndex + 1
+            continue
+        timeStamp = int.from_bytes(traceBytes[byteIndex + 1:byteIndex + 5], "little")
+        eventIDAndArg = int.from_bytes(traceBytes[byteIndex + 5:byteIndex + 9], "little")
+        entryList.append((timeStamp, eventIDAndArg & 0xFFFF, eventIDAndArg >> 16))
+        byteIndex = byteIndex + 1 + TRACE_ENTRY_BYTES
+    return entryList
+
+
+def ReadNames(namesFileName):
+    """Gets the users event names as a dictionary of ID to name"""
+    userNames = {}
+    with open(namesFileName) as namesFile:
+        for namesLine in namesFile:
+            namesFields = namesLine.split(None, 1)
+            if len(namesFields) == 2 and not namesFields[0].startswith("#"):
+                userNames[int(namesFields[0], 0)] = namesFields[1].strip()
+    return userNames
+
+
+def Main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: TraceToJson.py trace.bin [names.txt]\n")
+        return 2
+
+    with open(sys.argv[1], "rb") as traceFile:
+        entryList = ReadEntries(traceFile.read())
+    userNames = ReadNames(sys.argv[2]) if len(sys.argv) > 2 else {}
+
+    def UserName(userEventID):
+        return userNames.get(userEventID, "User 0x%X" % userEventID)
+
+    traceEvents = [{"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "microbit CPU"}}]
+    openBars = []
+    epochTicks = 0
+    lastTicks = 0
+    lastRawTicks = None
+    for timeStamp, eventID, eventArg in entryList:
+        # turn the 32 bit timer count into a time that always goes up
+        if eventID == TRACE_START and lastRawTicks is not None:
+            # the timer was cleared. Carry on from where we were
+            epochTicks = lastTicks - timeStamp
+        elif lastRawTicks is not None and timeStamp < lastRawTicks:
+            epochTicks = epochTicks + (1 << 32)
+        lastRawTicks = timeStamp
+        lastTicks = epochTicks + timeStamp
+        eventTime = lastTicks / TIMESTAMP_TICKS_PER_US
+
+        barName = None
+        barBegins = False
+        if eventID == TRACE_IRQ_ENTRY or eventID == TRACE_IRQ_EXIT:
+            barName = "IRQ " + IRQ_NAMES.get(eventArg, str(eventArg))
+            barBegins = (eventID == TRACE_IRQ_ENTRY)
+        elif eventID == TRACE_CALLBACK_ENTRY or eventID == TRACE_CALLBACK_EXIT:
+            barName = CALLBACK_NAMES.get(eventArg, "Callback " + str(eventArg))
+            barBegins = (eventID == TRACE_CALLBACK_ENTRY)
+        elif eventID == TRACE_USER_BEGIN or eventID == TRACE_USER_END:
+            barName = UserName(eventArg)
+            barBegins = (eventID == TRACE_USER_BEGIN)
+        elif eventID == TRACE_LOST:
+            traceEvents.append({"name": "TRACE_LOST", "ph": "i", "s": "g", "ts": eventTime, "pid": 1, "tid": 1,
+                                "args": {"entries": eventArg}})
+            # we do not know what happened in the gap so forget anything that was open
+            openBars = []
+        elif eventID == TRACE_START:
+            traceEvents.append({"name": "TRACE_START", "ph": "i", "s": "g", "ts": eventTime, "pid": 1, "tid": 1})
+            openBars = []
+        elif eventID >= TRACE_USER_FIRST_ID:
+            traceEvents.append({"name": UserName(eventID), "ph": "i", "s": "t", "ts": eventTime, "pid": 1, "tid": 1,
+                                "args": {"arg": eventArg}})
+
+        if barName is None:
+            continue
+        if barBegins:
+            openBars.append(barName)
+            traceEvents.append({"name": barName, "ph": "B", "ts": eventTime, "pid": 1, "tid": 1})
+        elif openBars and openBars[-1] == barName:
+            # only close what we saw open. The capture might start part way through a bar
+            openBars.pop()
+            traceEvents.append({"name": barName, "ph": "E", "ts": eventTime, "pid": 1, "tid": 1})
+
+    sys.stdout.write("{\"traceEvents\": [\n")
+    sys.stdout.write(",\n".join(EventToJson(traceEvent) for traceEvent in traceEvents))
+    sys.stdout.write("\n], \"displayTimeUnit\": \"ns\"}\n")
+    sys.stderr.write("TraceToJson.py: %d entries\n" % len(entryList))
+    return 0
+
+
+def EventToJson(traceEvent):
+    """One event as a compact line of JSON so the output has one event per line, which is easier to read"""
+    return json.dumps(traceEvent, separators=(",", ":"))
+
+
+if __name__ == "__main__":
+    sys.exit(Main())
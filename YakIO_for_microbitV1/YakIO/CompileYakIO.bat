@@ -29,7 +29,9 @@ REM do not put trailing slashes "\" on these directories
 set YAKIO_INCLUDE_DIR=.\Include
 set YAKIO_SOURCE_DIR=.\Source
 set YAKIO_OBJECT_DIR=.\Objects
-set YAKIO_COMPILE_FLAGS= -O -g -mcpu=cortex-m0 -std=c++11 -mthumb -Wall --specs=nosys.specs -fno-exceptions -fno-rtti
+set YAKIO_COMPILE_FLAGS= -O -g -mcpu=cortex-m0 -std=c++20 -fcoroutines -mthumb -Wall --specs=nosys.specs -fno-exceptions -fno-rtti -fno-tree-loop-distribute-patterns
+REM to compile the trace hooks into the library add -DYAKIO_TRACE to the end of 
+REM the line above. See the note on the TRACE in Include\YakIO_TRACE.h
 
 REM make sure our directories exist
 @if not exist %YAKIO_INCLUDE_DIR%\ (
@@ -63,6 +65,54 @@ arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_
 @if %errorlevel% neq 0 exit /b %errorlevel%
 arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_Utils.cpp -o %YAKIO_OBJECT_DIR%\YakIO_Utils.o
 @if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_EVENTLOOP.cpp -o %YAKIO_OBJECT_DIR%\YakIO_EVENTLOOP.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_KERNEL.cpp -o %YAKIO_OBJECT_DIR%\YakIO_KERNEL.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_SEMAPHORE.cpp -o %YAKIO_OBJECT_DIR%\YakIO_SEMAPHORE.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_MSGQUEUE.cpp -o %YAKIO_OBJECT_DIR%\YakIO_MSGQUEUE.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_TASK.cpp -o %YAKIO_OBJECT_DIR%\YakIO_TASK.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_POOL.cpp -o %YAKIO_OBJECT_DIR%\YakIO_POOL.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_HEAP.cpp -o %YAKIO_OBJECT_DIR%\YakIO_HEAP.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_STACKGUARD.cpp -o %YAKIO_OBJECT_DIR%\YakIO_STACKGUARD.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_MEMORY.cpp -o %YAKIO_OBJECT_DIR%\YakIO_MEMORY.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_UART.cpp -o %YAKIO_OBJECT_DIR%\YakIO_UART.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_PROFILER.cpp -o %YAKIO_OBJECT_DIR%\YakIO_PROFILER.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_TRACE.cpp -o %YAKIO_OBJECT_DIR%\YakIO_TRACE.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_PRNG.cpp -o %YAKIO_OBJECT_DIR%\YakIO_PRNG.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_SOFTAES.cpp -o %YAKIO_OBJECT_DIR%\YakIO_SOFTAES.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_ECB.cpp -o %YAKIO_OBJECT_DIR%\YakIO_ECB.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_DRBG.cpp -o %YAKIO_OBJECT_DIR%\YakIO_DRBG.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_AES.cpp -o %YAKIO_OBJECT_DIR%\YakIO_AES.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_PPI.cpp -o %YAKIO_OBJECT_DIR%\YakIO_PPI.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_CCM.cpp -o %YAKIO_OBJECT_DIR%\YakIO_CCM.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_SHA256.cpp -o %YAKIO_OBJECT_DIR%\YakIO_SHA256.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_HMAC.cpp -o %YAKIO_OBJECT_DIR%\YakIO_HMAC.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_RADIO.cpp -o %YAKIO_OBJECT_DIR%\YakIO_RADIO.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_TIMESYNC.cpp -o %YAKIO_OBJECT_DIR%\YakIO_TIMESYNC.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
+arm-none-eabi-gcc -I%YAKIO_INCLUDE_DIR% %YAKIO_COMPILE_FLAGS%  -c %YAKIO_SOURCE_DIR%\YakIO_TDMA.cpp -o %YAKIO_OBJECT_DIR%\YakIO_TDMA.o
+@if %errorlevel% neq 0 exit /b %errorlevel%
 
 @echo.
 @echo The build of the YakIO object files was successful
@@ -20,9 +20,54 @@
 #define YAKIO_MAJOR_VERSION 0
 #define YAKIO_MINOR_VERSION 91
 
-#define NULL 0
+// the host build (see YAKIO_HOST below) may already have a NULL from the C library
+#ifndef NULL
+  #define NULL 0
+#endif
 #define BYTES_IN_REGISTER 4         // we are a 32 bit system
 
+// put this in front of a global variable to have it placed in the .noinit 
+// section. The startup code does not zero it so it will contain whatever 
+// was in the RAM before. Useful for big buffers you fill before you use.
+// Example: 
+//      YAKIO_NOINIT unsigned char sampleBuffer[2048];
+#define YAKIO_NOINIT __attribute__ ((section(".noinit")))
+
+// A note on REGISTER ACCESS. Every peripheral register read or write in the 
+// YakIO library goes through the YAKIO_REGISTER() macro. On the microbit it 
+// is nothing more than the classic cast of an address to a pointer to a 
+// volatile unsigned int which is then dereferenced. 
+// Example: 
+//      YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTSET) = (0x01<<gpioPin);
+// is exactly the same code as 
+//      (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTSET)) = (0x01<<gpioPin);
+//
+// The reason it is a macro is that if YAKIO_HOST is defined (see the "host" 
+// target in the Makefile) the library can be compiled for the Linux PC you are
+// sitting at. There are no peripherals at those addresses on a PC so the macro 
+// sends each access to a simulated register file instead. This counts the reads
+// and writes and has simple working models of the GPIO, TIMER, RNG, NVIC and ECB. 
+// See YakIO_HOSTREGISTERS.h. None of that code is compiled for the microbit.
+#ifdef YAKIO_HOST
+  #define YAKIO_REGISTER(registerAddress) (YakIO_HOSTREGISTER(registerAddress))
+#else
+  #define YAKIO_REGISTER(registerAddress) (*(unsigned volatile *) (registerAddress))
+#endif
+
+// A few peripherals (the ECB, the CCM and the RADIO) are not given their data in registers.
+// Instead they are given the address of a buffer in RAM and read and write it themselves (the
+// data sheet calls this EasyDMA). YAKIO_RAM_ADDRESS() turns a pointer into the value to write
+// into one of those address registers. On the microbit it is just a cast. On the host a 
+// pointer is 64 bits and will not fit in a 32 bit register so the simulated register file 
+// swaps it for a small number it can turn back into the pointer later.
+// Example: 
+//      YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ECBDATAPTR) = YAKIO_RAM_ADDRESS(&ecbData);
+#ifdef YAKIO_HOST
+  #define YAKIO_RAM_ADDRESS(ramPtr) (activeHostRegisters->MapRamPointer((void *)(ramPtr)))
+#else
+  #define YAKIO_RAM_ADDRESS(ramPtr) ((unsigned int)(ramPtr))
+#endif
+
 // register defines, straight out of page 17 in the
 // nrf51822 reference guide
 #define REGISTER_CLOCK   0x40000000 // CLOCK Clock control
@@ -66,6 +111,11 @@
 // to the cortex-m0+ documentation from ARM for the register mappings
 #define REGISTER_NVIC    0xE000E000 // NVIC Nested Vectored Interrupt Controller base address
 
+// the simulated register file is only ever needed when compiled for the host
+#ifdef YAKIO_HOST
+  #include "YakIO_HOSTREGISTERS.h"
+#endif
+
 
 
 
@@ -0,0 +1,103 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_AES_H
+#define YAKIO_AES_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_ECB.h"
+
+// A note on AES. YakIO_AES encrypts a stream of bytes - sensor data, a log, a packet - 
+// with AES-128 in CTR (counter) mode, NIST SP 800-38A section 6.5. The ECB (see 
+// YakIO_ECB.h) encrypts a 16 byte counter block to make 16 bytes of "keystream" and the
+// data is xored with it. The counter is then incremented (as a 128 bit big endian number)
+// for the next 16 bytes. Decrypting is exactly the same thing so Decrypt() just calls 
+// Encrypt().
+//
+// The keystream does not depend on the data so it can be made before the data turns up.
+// Start() sets the ECB going and its interrupt keeps AES_KEYSTREAM_BYTES of keystream
+// waiting in a buffer. Encrypt() just xors the data with what is there and the interrupt
+// makes some more. While the buffer keeps up, encrypting costs about the same as a 
+// memcpy(). If the data comes faster than the ECB (about 7 microseconds a block) 
+// Encrypt() waits for it - GetStallCount() says how often that happened.
+//
+// The stream carries on from one call to the next. Encrypt(a, 5) then Encrypt(b, 11) gives
+// exactly the same result as Encrypt(ab, 16). Call Start() again to begin a new stream.
+//
+// NEVER use the same key and starting counter twice. Anyone with two messages made with 
+// the same keystream can xor them together and the keystream drops out. Use a new nonce 
+// in the counter block (a YakIO_DRBG is a good place to get one) for every stream.
+//
+// CTR mode keeps the data secret but does nothing to stop it being changed. If that 
+// matters look at CCM mode (YakIO_CCM) instead.
+//
+// Like YakIO_DRBG it uses the ECB callback, so nothing else should use the ECB until Stop()
+// is called. See the 21_AesBenchmark example for how it compares with YakIO_SOFTAES.
+//
+// Example:
+//      in the Main class:     YakIO_ECB ecbObj {};
+//                             YakIO_AES aesObj {};
+//      in MainLoop():         aesObj.Start(&ecbObj, keyBytes, counterBlock);
+//      anywhere:              aesObj.Encrypt(sensorBytes, cipherBytes, byteCount);
+
+// the number of bytes of keystream made ahead. It MUST be a power of two and a 
+// multiple of ECB_BLOCK_BYTES. Define it before this file is included to change it
+#ifndef AES_KEYSTREAM_BYTES
+#define AES_KEYSTREAM_BYTES     64
+#endif
+#define AES_KEYSTREAM_MASK      (AES_KEYSTREAM_BYTES-1)
+#define AES_KEY_BYTES           ECB_KEY_BYTES
+#define AES_BLOCK_BYTES         ECB_BLOCK_BYTES
+
+/* YakIO_AES - a class to encrypt streams of bytes with AES-128 in CTR 
+ *     mode on the ECB
+ * */
+class YakIO_AES : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_ECB *ecbPtr =NULL;
+      unsigned int isRunning =0;
+      // the ECB interrupt changes isGenerating and the keystream counts 
+      // while the code outside it polls them (see GetKeystreamCount()), so
+      // they must be volatile. Without it a wait for the keystream can be
+      // compiled down to nothing
+      volatile unsigned int isGenerating =0;
+      unsigned char counterBytes[AES_BLOCK_BYTES];
+      volatile unsigned int keystreamWriteCount =0;
+      volatile unsigned int keystreamReadCount =0;
+      unsigned char keystreamBytes[AES_KEYSTREAM_BYTES];
+      unsigned int blockCount =0;
+      unsigned int stallCount =0;
+      void IncrementCounter(void);
+      void StartNextBlock(void);
+      void KeepGenerating(void);
+
+  public:
+      // Constructor to initialize YakIO_AES object
+      YakIO_AES();
+      void Start(YakIO_ECB *ecbPtrIn, const unsigned char *keyBytes, const unsigned char *counterBlock);
+      void Stop(void);
+      unsigned int Encrypt(const unsigned char *inBuffer, unsigned char *outBuffer, unsigned int byteCount);
+      unsigned int Decrypt(const unsigned char *inBuffer, unsigned char *outBuffer, unsigned int byteCount);
+      unsigned int GetKeystreamCount(void);
+      unsigned int GetBlockCount(void);
+      unsigned int GetStallCount(void);
+      void Callback0(void) override;
+};
+
+#endif
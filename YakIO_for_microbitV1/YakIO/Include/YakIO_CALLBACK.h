@@ -48,6 +48,10 @@ class YakIO_CALLBACK
         virtual void Callback2() {};
         virtual void Callback3() {};
         virtual void Heartbeat() {};
+        // this one is different. It is called by the YakIO_EVENTLOOP to
+        // deliver an event and it is told which event and given the
+        // small payload that was posted with it
+        virtual void EventCallback(unsigned int eventType, unsigned int eventData) {};
 };
 
 #endif
@@ -0,0 +1,176 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_CCM_H
+#define YAKIO_CCM_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_NVIC.h"
+#include "YakIO_PPI.h"
+#include "YakIO_Utils.h"
+
+// CCM REGISTER SPECIFIC SECTION
+#define CCMREG_OFFSET_KSGEN         0x000 // Start generation of key-stream
+#define CCMREG_OFFSET_CRYPT         0x004 // Start encryption/decryption
+#define CCMREG_OFFSET_STOP          0x008 // Stop encryption/decryption
+#define CCMREG_OFFSET_ENDKSGEN      0x100 // Key-stream generation complete
+#define CCMREG_OFFSET_ENDCRYPT      0x104 // Encrypt/decrypt complete
+#define CCMREG_OFFSET_ERROR         0x108 // CCM error event
+#define CCMREG_OFFSET_SHORTS        0x200 // Shortcut register
+#define CCMREG_OFFSET_INTENSET      0x304 // Enable interrupt
+#define CCMREG_OFFSET_INTENCLR      0x308 // Disable interrupt
+#define CCMREG_OFFSET_MICSTATUS     0x400 // MIC check result
+#define CCMREG_OFFSET_ENABLE        0x500 // Enable
+#define CCMREG_OFFSET_MODE          0x504 // Operation mode
+#define CCMREG_OFFSET_CNFPTR        0x508 // Pointer to data structure holding AES key and NONCE vector
+#define CCMREG_OFFSET_INPTR         0x50C // Input pointer
+#define CCMREG_OFFSET_OUTPTR        0x510 // Output pointer
+#define CCMREG_OFFSET_SCRATCHPTR    0x514 // Pointer to data area used for temporary storage
+
+#define CCM_SHORT_ENDKSGEN_CRYPT    0x01
+#define CCM_INTEN_ENDKSGEN_BIT      0x01    // bit we set/clear
+#define CCM_INTEN_ENDCRYPT_BIT      0x02    // bit we set/clear
+#define CCM_INTEN_ERROR_BIT         0x04    // bit we set/clear
+#define CCM_ENABLE_DISABLED         0
+#define CCM_ENABLE_ENABLED          2
+
+#define CCM_KEY_BYTES               16
+#define CCM_IV_BYTES                8
+#define CCM_COUNTER_BYTES           8       // only 39 bits are used
+#define CCM_MIC_BYTES               4
+#define CCM_MAX_PAYLOAD_BYTES       27
+#define CCM_PACKET_HEADER_BYTES     3       // S0, LENGTH and S1. See the note below
+#define CCM_PACKET_BYTES            (CCM_PACKET_HEADER_BYTES+CCM_MAX_PAYLOAD_BYTES+CCM_MIC_BYTES)
+#define CCM_SCRATCH_BYTES           43      // 16 + the biggest packet, see SCRATCHPTR
+#define CCM_COUNTER_HIGH_MASK       0x7F    // bits 32 to 38 of the counter, in byte 4
+#define CCM_COUNTER_USED_BYTES      5
+#define CCM_PACKET_OFFSET_S0        0
+#define CCM_PACKET_OFFSET_LENGTH    1
+#define CCM_PACKET_OFFSET_PAYLOAD   CCM_PACKET_HEADER_BYTES
+
+// note the value here is carefully set to the value we have to 
+// stuff in the register to set the mode properly
+enum CCM_MODE {
+    CCM_MODE_ENCRYPT=0,
+    CCM_MODE_DECRYPT=1,
+};
+
+// note the value here is carefully set to the value we have to 
+// stuff in the DIRECTION byte. It is the top bit of the nonce
+enum CCM_DIRECTION {
+    CCM_DIRECTION_SLAVE_TO_MASTER=0,
+    CCM_DIRECTION_MASTER_TO_SLAVE=1,
+};
+
+// A note on the CCM. The CCM is AES-128 in CCM mode (counter with CBC-MAC, RFC 3610) done in 
+// hardware, exactly as the Bluetooth Low Energy link layer needs it (Core specification, 
+// volume 6 part E). It both encrypts a packet and adds a 4 byte MIC (message integrity 
+// check) so that a packet which has been changed on the way can be spotted and thrown away.
+// Compare that with YakIO_AES, which only keeps the data secret.
+//
+// It is built to sit between the RADIO and RAM. The packets are in the RADIO's format:
+//
+//    byte 0       S0, the header. Bits 2-4 (the 0x1C bits) are not covered by the MIC
+//    byte 1       LENGTH, the bytes of payload. Up to CCM_MAX_PAYLOAD_BYTES, plus the 
+//                 CCM_MIC_BYTES once encrypted
+//    byte 2       S1, not used and not copied
+//    byte 3...    the payload, then the MIC
+//
+// Each packet is encrypted with a 13 byte nonce made of a 39 bit packet counter, a 
+// direction bit and the 8 byte IV. The counter MUST be different for every packet sent 
+// with the same key - this class adds one to it after every packet that works (see 
+// SetPacketCounter()). Both ends must keep their counters in step.
+//
+// There are two steps. KSGEN makes the keystream for a packet into the scratch area (that 
+// does not need the packet itself) and CRYPT then does the encryption or decryption as 
+// the bytes go through. So there are two ways to use it:
+//
+//   1) EncryptPacket() and DecryptPacket() - do a packet in RAM and wait. It takes some 
+//      tens of microseconds, depending on the length.
+//   2) ArmRadioTx() and ArmRadioRx() - the PPI does it all as the packet goes through the
+//      RADIO. For sending, the RADIO READY event starts KSGEN (PPI channel 24) and a 
+//      shortcut starts CRYPT when that ends - the packet is encrypted into the RADIO's 
+//      buffer while the RADIO ramps up. For receiving, READY starts KSGEN and the RADIO 
+//      ADDRESS event starts CRYPT (PPI channel 25), which decrypts the packet as it 
+//      arrives a byte at a time. The CPU does nothing at all per packet. Point the RADIO 
+//      PACKETPTR at the out packet for sending and at the in packet for receiving.
+//
+// The ENDCRYPT interrupt is only used to move the counter on and call the callback (see 
+// SetCallback()). GetMicStatus() says if a received packet was genuine. 
+//
+// The CCM and the AAR share the same hardware (and the same interrupt). They also share 
+// the AES with the ECB and take priority over it - see the note in YakIO_ECB.h.
+//
+// Example:
+//      in the Main class:     YakIO_CCM ccmObj {};
+//      in MainLoop():         ccmObj.Start(keyBytes, ivBytes, CCM_DIRECTION_MASTER_TO_SLAVE);
+//      anywhere:              ccmObj.EncryptPacket(clearPacket, cipherPacket);
+
+// the block of RAM the CCM reads the key and nonce from. See CNFPTR in the nrf51 
+// reference manual. It is 33 bytes with no padding
+struct YakIO_CCMCONFIG
+{
+    unsigned char keyBytes[CCM_KEY_BYTES];
+    unsigned char counterBytes[CCM_COUNTER_BYTES];  // least significant byte first
+    unsigned char directionByte;
+    unsigned char ivBytes[CCM_IV_BYTES];
+} __attribute__ ((packed, aligned (4)));
+
+/* YakIO_CCM - a class to represent and encapsulate the CCM AES
+ *     authenticated encryption peripheral
+ * */
+class YakIO_CCM
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_CALLBACK *callbackInterfacePtr =0;
+      enum CALLBACK_ID callbackID = CALLBACK_NONE;
+      struct YakIO_CCMCONFIG ccmConfig;
+      unsigned char scratchBytes[CCM_SCRATCH_BYTES] __attribute__ ((aligned (4)));
+      enum CCM_MODE armedMode = CCM_MODE_ENCRYPT;
+      unsigned int isArmed =0;
+      unsigned int packetCount =0;
+      unsigned int micFailCount =0;
+      YakIO_PPI ppiObj;
+      void ClearEvents(void);
+      void SetPointers(enum CCM_MODE ccmMode, const unsigned char *inPacket, unsigned char *outPacket);
+      unsigned int WaitForCrypt(void);
+      void IncrementCounter(void);
+
+  public:
+      // Constructor to initialize YakIO_CCM object
+      YakIO_CCM();
+      void SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void CallCallback();
+      void ClearAllCallbacks(void);
+      void Start(const unsigned char *keyBytes, const unsigned char *ivBytes, enum CCM_DIRECTION ccmDirection);
+      void Stop(void);
+      void SetDirection(enum CCM_DIRECTION ccmDirection);
+      void SetPacketCounter(unsigned int counterLow, unsigned int counterHigh);
+      unsigned int GetPacketCounter(void);
+      unsigned int EncryptPacket(const unsigned char *clearPacket, unsigned char *cipherPacket);
+      unsigned int DecryptPacket(const unsigned char *cipherPacket, unsigned char *clearPacket);
+      void ArmRadioTx(const unsigned char *clearPacket, unsigned char *cipherPacket);
+      void ArmRadioRx(const unsigned char *cipherPacket, unsigned char *clearPacket);
+      void Disarm(void);
+      unsigned int GetMicStatus(void);
+      unsigned int GetPacketCount(void);
+      unsigned int GetMicFailCount(void);
+      void HandleCcmIRQ(void);
+};
+
+#endif
@@ -0,0 +1,174 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_DRBG_H
+#define YAKIO_DRBG_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_ECB.h"
+#include "YakIO_RNG.h"
+
+// A note on the DRBG. The RNG peripheral (see YakIO_RNG) is a true random number generator 
+// but it only makes about 10 kbytes a second and less than that once it has been 
+// conditioned. YakIO_PRNG is as quick as you like but anyone who sees a few outputs can 
+// work out all the rest. Keys, nonces and the like need numbers which are both quick to 
+// get and impossible to predict. That is what a DRBG (Deterministic Random Bit Generator) 
+// is for.
+//
+// This is the CTR_DRBG from NIST SP 800-90A (section 10.2) using AES-128 with the 
+// derivation function. The state is a 16 byte key K and a 16 byte counter V. Each 16 bytes 
+// of output is V+1 encrypted with K - and the ECB (see YakIO_ECB.h) does the encrypting, so 
+// it costs the CPU very little. The Update function scrambles K and V (optionally mixing in
+// 32 new bytes) by encrypting V+1 and V+2 and using the result as the new K and V:
+//
+//    Instantiate - K and V start at zero and are Updated with the seed material
+//    Key rotation - every keyRotationInterval blocks K and V are Updated with nothing 
+//                   mixed in. This is the Update SP 800-90A does at the end of every 
+//                   Generate request. Anyone who gets the state later can not work 
+//                   backwards to the output that came before
+//    Reseed      - every reseedInterval key rotations K and V are Updated with new seed
+//                   material. Anyone who got the state earlier can not work forwards 
+//                   past this point
+//
+// A note on the SEED MATERIAL. Without a derivation function SP 800-90A wants the 32 bytes
+// mixed in to be full entropy - every bit a coin toss. The raw RNG values are nothing like
+// that. The health tests (see YakIO_RNG.h) are set for a min-entropy of 2 bits in each 8 
+// bit value so 32 raw bytes are only about 64 bits of entropy. Instead the seed material 
+// is made by the Block_Cipher_df derivation function (SP 800-90A section 10.3.2) from 
+// DRBG_ENTROPY_BYTES from the RNG pool. That is 128 bytes, 4 times as many, which is 256 
+// bits even if every one of them is raw. That is the 128 bits of entropy AES-128 needs
+// plus the 64 bits of nonce SP 800-90A wants at instantiation - with some to spare. 
+//
+// The derivation function squeezes the 128 bytes into 32 with two CBC-MACs (BCC in the 
+// standard) under a fixed key and then encrypts with the result. It is all done on the 
+// ECB too, 22 blocks of it, and the pool bytes are taken 16 at a time as they are needed 
+// so the pool (only RNG_POOL_BYTES) never has to hold them all at once. The two CBC-MACs
+// run side by side so each 16 bytes of entropy is used twice as soon as it arrives and 
+// is then wiped.
+//
+// It all runs in the background. Start() seeds it and the ECB interrupt then keeps 
+// encrypting blocks into a buffer of DRBG_BUFFER_BYTES until it is full. TryGetBytes() and
+// GetU32() take bytes out of the buffer and set it going again. They never wait - like the
+// RNG pool, if there are not enough bytes they take none.
+//
+// If the RNG pool runs out of entropy part way through a (re)seed, nothing more is made 
+// until it has more. The part done so far is kept and the seed carries on from there. Reading the bytes that are already in the buffer tries again. Until the first 
+// seed IsSeeded() is zero and there are no bytes to read at all. If the RNG fails its 
+// health tests (see YakIO_RNG.h) no entropy comes out of the pool and so the output will
+// stop at the next reseed.
+//
+// The DRBG does not own the ECB or the RNG. It uses the ECB callback and the RNG pool 
+// while it runs so nothing else should use the ECB until Stop() is called. Stop() wipes 
+// the state and the buffer.
+//
+// Example:
+//      in the Main class:     YakIO_ECB ecbObj {};
+//                             YakIO_RNG rngObj {};
+//                             YakIO_DRBG drbgObj {};
+//      in MainLoop():         drbgObj.Start(&ecbObj, &rngObj);
+//      anywhere:              unsigned char nonceBytes[8];
+//                             if(drbgObj.TryGetBytes(nonceBytes, 8)!=0) ... use it
+
+// the number of bytes the output buffer holds. It MUST be a power of two and at 
+// least ECB_BLOCK_BYTES. Define it before this file is included to change it
+#ifndef DRBG_BUFFER_BYTES
+#define DRBG_BUFFER_BYTES           256
+#endif
+#define DRBG_BUFFER_MASK            (DRBG_BUFFER_BYTES-1)
+// the key and counter together. The size of the seed material (seedlen in SP 800-90A)
+#define DRBG_SEED_BYTES             (ECB_KEY_BYTES+ECB_BLOCK_BYTES)
+// the bytes taken from the RNG pool for each (re)seed. See the note on the SEED MATERIAL
+#define DRBG_ENTROPY_BYTES          (4*DRBG_SEED_BYTES)
+// the derivation function input S is a 4 byte length, a 4 byte output length, the 
+// entropy, a 0x80 byte and then zeros to the end of a block
+#define DRBG_DF_HEADER_BYTES        8
+#define DRBG_DF_S_BLOCKS            ((DRBG_DF_HEADER_BYTES+DRBG_ENTROPY_BYTES+1+ECB_BLOCK_BYTES-1)/ECB_BLOCK_BYTES)
+// two chains of the IV block and every block of S, then two blocks with the new key
+#define DRBG_DF_BCC_STEPS           (2*(1+DRBG_DF_S_BLOCKS))
+#define DRBG_DF_STEPS               (DRBG_DF_BCC_STEPS+2)
+#define DRBG_DEFAULT_ROTATION_BLOCKS    64      // 1 kbyte between key rotations
+#define DRBG_DEFAULT_RESEED_ROTATIONS   256     // 256 kbytes between reseeds
+
+// what the ECB is doing for us. See Callback0()
+enum DRBG_STATE {
+    DRBG_STATE_STOPPED=0,       // not started
+    DRBG_STATE_IDLE=1,          // the buffer is full
+    DRBG_STATE_WAITING_ENTROPY=2,// it is time to (re)seed and the RNG pool is empty
+    DRBG_STATE_GENERATING=3,    // encrypting a block of output
+    DRBG_STATE_UPDATING=4,      // encrypting a block for Update
+    DRBG_STATE_DERIVING=5,      // encrypting a block for the derivation function
+};
+
+/* YakIO_DRBG - a class to provide cryptographic random bytes from 
+ *     an AES-128 CTR_DRBG running on the ECB 
+ * */
+class YakIO_DRBG : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_ECB *ecbPtr =NULL;
+      YakIO_RNG *rngPtr =NULL;
+      // the ECB interrupt changes drbgState, isSeeded and the buffer counts 
+      // while the code outside it polls them, so they must be volatile
+      volatile enum DRBG_STATE drbgState = DRBG_STATE_STOPPED;
+      unsigned char keyBytes[ECB_KEY_BYTES];
+      unsigned char counterBytes[ECB_BLOCK_BYTES];
+      unsigned char updateInputBytes[DRBG_SEED_BYTES];
+      unsigned char updateOutputBytes[DRBG_SEED_BYTES];
+      unsigned int updateBlockIndex =0;
+      unsigned char dfChainBytes[DRBG_SEED_BYTES];
+      unsigned char dfBlockBytes[ECB_BLOCK_BYTES];
+      unsigned int dfStepCount =0;
+      unsigned int updateIsReseed =0;
+      volatile unsigned int isSeeded =0;
+      unsigned int reseedIsDue =0;
+      unsigned int keyRotationInterval =DRBG_DEFAULT_ROTATION_BLOCKS;
+      unsigned int reseedInterval =DRBG_DEFAULT_RESEED_ROTATIONS;
+      unsigned int blocksSinceRotation =0;
+      unsigned int rotationsSinceReseed =0;
+      unsigned int blockCount =0;
+      unsigned int keyRotationCount =0;
+      unsigned int reseedCount =0;
+      volatile unsigned int bufferWriteCount =0;
+      volatile unsigned int bufferReadCount =0;
+      unsigned char bufferBytes[DRBG_BUFFER_BYTES];
+      void IncrementCounter(void);
+      void StartNextBlock(void);
+      void StartUpdate(unsigned int isReseed);
+      void FinishUpdate(void);
+      void StartDeriveStep(void);
+      unsigned int LoadDfBlock(unsigned int sBlockIndex);
+      void WipeState(void);
+
+  public:
+      // Constructor to initialize YakIO_DRBG object
+      YakIO_DRBG();
+      void Start(YakIO_ECB *ecbPtrIn, YakIO_RNG *rngPtrIn);
+      void Stop(void);
+      unsigned int IsSeeded(void);
+      unsigned int GetCount(void);
+      unsigned int TryGetBytes(unsigned char *outBuffer, unsigned int byteCount);
+      unsigned int GetU32(unsigned int *randomValuePtr);
+      void SetKeyRotationInterval(unsigned int rotationBlocks);
+      void SetReseedInterval(unsigned int reseedRotations);
+      unsigned int GetBlockCount(void);
+      unsigned int GetKeyRotationCount(void);
+      unsigned int GetReseedCount(void);
+      void Callback0(void) override;
+};
+
+#endif
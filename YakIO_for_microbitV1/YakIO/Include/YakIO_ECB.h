@@ -0,0 +1,113 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_ECB_H
+#define YAKIO_ECB_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_NVIC.h"
+#include "YakIO_Utils.h"
+
+// ECB REGISTER SPECIFIC SECTION
+#define ECBREG_OFFSET_STARTECB      0x000 // Start ECB block encrypt
+#define ECBREG_OFFSET_STOPECB       0x004 // Abort a possible executing ECB operation
+#define ECBREG_OFFSET_ENDECB        0x100 // ECB block encrypt complete
+#define ECBREG_OFFSET_ERRORECB      0x104 // ECB block encrypt aborted because of a STOPECB task or due to an error
+#define ECBREG_OFFSET_INTENSET      0x304 // Enable interrupt
+#define ECBREG_OFFSET_INTENCLR      0x308 // Disable interrupt
+#define ECBREG_OFFSET_ECBDATAPTR    0x504 // ECB block encrypt memory pointer
+
+#define ECB_INTEN_ENDECB_BIT    0x01    // bit we set/clear
+#define ECB_INTEN_ERRORECB_BIT  0x02    // bit we set/clear
+#define ECB_KEY_BYTES           16
+#define ECB_BLOCK_BYTES         16
+
+// A note on the ECB. The ECB is the AES-128 encryption hardware. It encrypts one 16 byte 
+// block with a 16 byte key in about 7 microseconds (112 cycles) without the CPU doing 
+// anything at all. "ECB" (Electronic Code Book) is the name for encrypting each block on 
+// its own. That is only really useful as a building block for the other modes (CTR, CCM 
+// and the like) so see YakIO_DRBG and YakIO_AES for code that does something with it.
+//
+// The ECB does not have registers for the key and data. Instead it is given the address 
+// (ECBDATAPTR) of a 48 byte block of RAM - the key, then the clear text, then the cipher 
+// text - which it reads and writes itself. That block is the ecbData member of this class.
+// All the bytes are in the usual AES order, byte 0 first. The FIPS-197 test vectors work 
+// as they are printed.
+//
+// There are two ways to use it:
+//
+//   1) EncryptBlock() - starts it and waits for the result. Simple and, at 7 microseconds,
+//      waiting is usually fine.
+//   2) StartEncrypt() - starts it and returns at once. The interrupt calls your callback 
+//      (see SetCallback()) when the result is ready. GetCipherText() then gets it. The 
+//      callback is called in the interrupt so it can start the next block straight away.
+//      Code which has to wait for a block with the interrupts off (or on the host, where
+//      interrupts only happen in hostRegisters.Advance()) can call PollEvents() instead.
+//
+// The RADIO's CCM and AAR use the same AES hardware and take priority over the ECB. If they
+// need it while the ECB is running the ECB stops with an ERRORECB event. We just start the
+// block again - you never see it.
+//
+// There is only one ECB so there should only ever be one YakIO_ECB object.
+//
+// Example:
+//      in the Main class:     YakIO_ECB ecbObj {};
+//      anywhere:              ecbObj.SetKey(keyBytes);
+//                             ecbObj.EncryptBlock(clearBlock, cipherBlock);
+
+// the block of RAM the ECB reads and writes. See ECBDATAPTR in the nrf51 reference manual. 
+// It has to be word aligned.
+struct YakIO_ECBDATA
+{
+    unsigned char keyBytes[ECB_KEY_BYTES];
+    unsigned char clearText[ECB_BLOCK_BYTES];
+    unsigned char cipherText[ECB_BLOCK_BYTES];
+} __attribute__ ((aligned (4)));
+
+/* YakIO_ECB - a class to represent and encapsulate the ECB AES
+ *     encryption peripheral
+ * */
+class YakIO_ECB
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_CALLBACK *callbackInterfacePtr =0;
+      enum CALLBACK_ID callbackID = CALLBACK_NONE;
+      struct YakIO_ECBDATA ecbData;
+      unsigned int isBusy =0;
+      unsigned int restartCount =0;
+      void ClearEvents(void);
+      void StartBlock(void);
+
+  public:
+      // Constructor to initialize YakIO_ECB object
+      YakIO_ECB();
+      void SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void CallCallback();
+      void ClearAllCallbacks(void);
+      void SetKey(const unsigned char *keyBytes);
+      unsigned int EncryptBlock(const unsigned char *clearBlock, unsigned char *cipherBlock);
+      unsigned int StartEncrypt(const unsigned char *clearBlock);
+      unsigned int IsBusy(void);
+      void GetCipherText(unsigned char *cipherBlock);
+      void Stop(void);
+      unsigned int GetRestartCount(void);
+      void PollEvents(void);
+      void HandleEcbIRQ(void);
+};
+
+#endif
@@ -0,0 +1,114 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_EVENTLOOP_H
+#define YAKIO_EVENTLOOP_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_Utils.h"
+
+// A note on EVENT LOOPS.
+//
+// The examples up to now have a MainLoop() which spins around as fast as it can checking flags
+// (like buttonAHasBeenPressed in the 06_deBounce example) which are set by interrupt handlers.
+// This works but it does not scale well - every new flag is another check - and the CPU is 
+// running flat out all the time even when there is nothing at all to do.
+//
+// An event loop turns this around. Interrupt handlers "post" an event into a queue. An event is
+// just a number saying what happened (the eventType) and a small number to go with it (the 
+// eventData). The MainLoop() hands control over to the event loop and the event loop takes 
+// the events out of the queue one at a time and calls the EventCallback() function of whichever
+// object has registered to handle that eventType. When the queue is empty the CPU is put to 
+// sleep with the WFE (Wait For Event) instruction until the next interrupt comes along.
+//
+// Each event is handled completely before the next one is started. This is known as "run to 
+// completion" and it means the handlers never interrupt each other, so they can safely share
+// data between themselves without any locking. Of course, the handlers are still running in 
+// the MainLoop() so interrupt handlers can still interrupt them.
+//
+// Each eventType is given a priority when it is registered. There is a separate queue for each
+// priority and the event loop always empties the higher priority queues first. Events of the 
+// same priority are handled in the order they were posted.
+//
+// Example:
+//      in the Main class:     YakIO_EVENTLOOP eventLoop {};
+//      in the MainLoop():     eventLoop.RegisterHandler(MY_EVENT, EVENT_PRIORITY_NORMAL, this);
+//                             eventLoop.Run();    // never returns
+//      in an interrupt:       eventLoop.PostEvent(MY_EVENT, someValue);
+//      and in the Main class: void EventCallback(unsigned int eventType, unsigned int eventData) override;
+//
+// See the 09_EventLoop example.
+
+// the maximum number of different eventTypes. eventTypes are numbered 0 
+// to EVENTLOOP_MAX_EVENT_TYPES-1
+#define EVENTLOOP_MAX_EVENT_TYPES 16
+// the number of events each priority queue can hold. When a queue is 
+// full, further posts to it are dropped (and counted)
+#define EVENTLOOP_QUEUE_SIZE 16
+
+// the priority of an eventType. Higher priority events are always
+// dispatched before lower priority ones
+enum EVENT_PRIORITY {
+    EVENT_PRIORITY_LOW=0,
+    EVENT_PRIORITY_NORMAL=1,
+    EVENT_PRIORITY_HIGH=2,
+    EVENT_PRIORITY_URGENT=3
+};
+#define EVENTLOOP_NUM_PRIORITIES 4
+
+// a single entry in an event queue
+struct YakIO_EVENT
+{
+    unsigned int eventType;
+    unsigned int eventData;
+};
+
+/* YakIO_EVENTLOOP - a class to queue events posted by interrupt handlers 
+ *     and dispatch them, one at a time, in priority order, to registered
+ *     handlers.
+ * */
+class YakIO_EVENTLOOP
+{
+  private:
+      unsigned int isInitialized =0;
+      // who handles each eventType, NULL if nobody does
+      YakIO_CALLBACK *handlerPtrs[EVENTLOOP_MAX_EVENT_TYPES];
+      // the priority of each eventType
+      enum EVENT_PRIORITY handlerPriorities[EVENTLOOP_MAX_EVENT_TYPES];
+      // the queues, one per priority. These are circular buffers. 
+      // queueHead is where the next event is taken from, queueTail
+      // is where the next event is put. If they are equal the queue is empty.
+      YakIO_EVENT eventQueues[EVENTLOOP_NUM_PRIORITIES][EVENTLOOP_QUEUE_SIZE];
+      volatile unsigned int queueHead[EVENTLOOP_NUM_PRIORITIES];
+      volatile unsigned int queueTail[EVENTLOOP_NUM_PRIORITIES];
+      // the number of events we had to throw away because a queue was full
+      volatile unsigned int droppedEventCount =0;
+      unsigned int GetNextQueueIndex(unsigned int queueIndex);
+
+  public:
+      // Constructor to initialize YakIO_EVENTLOOP object
+      YakIO_EVENTLOOP();
+      void RegisterHandler(unsigned int eventType, enum EVENT_PRIORITY eventPriority, YakIO_CALLBACK *handlerPtrIn);
+      void UnregisterHandler(unsigned int eventType);
+      unsigned int PostEvent(unsigned int eventType, unsigned int eventData);
+      unsigned int DispatchOneEvent(void);
+      unsigned int GetDroppedEventCount(void);
+      void Run(void);
+
+};
+
+#endif
@@ -0,0 +1,183 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_HEAP_H
+#define YAKIO_HEAP_H
+
+#include "YakIO.h"
+#include "YakIO_Utils.h"
+
+// A note on the HEAP.
+//
+// YakIO_POOL (see YakIO_POOL.h) is the right answer when the things you allocate are all the 
+// same size. Sometimes they are not - a radio packet can be anything from a few bytes to a few
+// hundred, a batch of sensor readings grows as long as the sensor keeps talking. For those you
+// need a heap: allocate any size, free in any order.
+//
+// The usual heap (malloc() and free()) searches a list of free blocks for one big enough. How 
+// long that takes depends on how many free blocks there are, which is not acceptable anywhere 
+// near real time code. YakIO_HEAP uses the TLSF ("Two Level Segregated Fit") method instead. 
+// Every operation takes a fixed, small, number of steps however full or fragmented the heap is.
+//
+// How it works: the free blocks are kept in lots of separate lists, one per range of sizes. The
+// first level splits the sizes into powers of two (32-63 bytes, 64-127, 128-255 ...) and the 
+// second level splits each of those into HEAP_SL_INDEX_COUNT equal parts. Two bitmaps record 
+// which lists have anything in them. To allocate, the size asked for is rounded up to the next 
+// list boundary so that ANY block in that list (or any bigger list) is guaranteed to fit. Finding
+// the first non empty list at or above that is a couple of "find the lowest set bit" operations 
+// on the bitmaps - no searching. The block found is split if it is much too big and the left 
+// over piece goes back on the right list. Freeing a block merges it with its neighbours in memory
+// if they are free too (each block records the size of itself and where its neighbour starts) 
+// and puts the result back on the right list. No step in any of this ever loops over the blocks.
+//
+// The Cortex-M0 does not have the CLZ (count leading zeros) instruction most processors use for
+// the "find the highest set bit" step. YakIO_HEAP uses a five step binary search instead. That 
+// is still a fixed number of steps.
+//
+// WHERE IS IT? The memory comes from the linker script (microbit.ld). It is whatever RAM is left
+// between the end of the .bss section and the stack, less a reserve for the stack. See the notes
+// on __stackReserveSize__ in microbit.ld for how to change that reserve.
+//
+// Allocate() and Free() disable interrupts while they run, so they can be used from interrupt
+// handlers. Since they take a fixed time the interrupts are only held off for a fixed time.
+//
+// Every block costs 4 bytes of header and sizes are rounded up to a multiple of 4. The smallest
+// block is HEAP_BLOCK_SIZE_MIN bytes. Blocks bigger than HEAP_BLOCK_SIZE_MAX cannot be allocated.
+//
+// FRAGMENTATION: TLSF is good at keeping it down but cannot prevent it. GetStatistics() walks
+// the whole heap (so it is NOT a fixed time operation - do not call it from time critical code) 
+// and reports how much is free, the largest free block and a fragmentation percentage. 0% means
+// all of the free memory is in one block. 90% means the largest free block is only a tenth of 
+// the free memory. Note that since Allocate() rounds the size up to the start of the next list
+// you cannot quite get all of the largest free block - ask for a little less.
+//
+// Example:
+//      in the Main class:     YakIO_HEAP heap {};
+//      anywhere:              unsigned char *packetPtr = (unsigned char *)heap.Allocate(packetLength);
+//                             if(packetPtr!=NULL) ...
+//                             heap.Free(packetPtr);
+//
+// See the 14_Heap example.
+//
+// Credit:
+//   TLSF was designed by Miguel Masmano, Ismael Ripoll and Alfons Crespo. See:
+//      M. Masmano, I. Ripoll, A. Crespo, and J. Real. TLSF: a new dynamic memory allocator 
+//      for real-time systems. Proc. 16th Euromicro Conference on Real-Time Systems, 2004.
+//   The block layout used here follows Matthew Conte's public domain implementation at:
+//      https://github.com/mattconte/tlsf
+
+// the number of second level lists per first level, as a power of two (3 means 8)
+#define HEAP_SL_INDEX_COUNT_LOG2 3
+#define HEAP_SL_INDEX_COUNT (1<<HEAP_SL_INDEX_COUNT_LOG2)
+// everything is 4 byte aligned
+#define HEAP_ALIGN_SIZE_LOG2 2
+#define HEAP_ALIGN_SIZE (1<<HEAP_ALIGN_SIZE_LOG2)
+// the biggest block is less than 2^HEAP_FL_INDEX_MAX bytes. The nRF51822 only has 
+// 16K (2^14) of RAM in total so there is no point going any higher
+#define HEAP_FL_INDEX_MAX 14
+// blocks smaller than HEAP_SMALL_BLOCK_SIZE all go in the first first level list
+#define HEAP_FL_INDEX_SHIFT (HEAP_SL_INDEX_COUNT_LOG2+HEAP_ALIGN_SIZE_LOG2)
+#define HEAP_FL_INDEX_COUNT (HEAP_FL_INDEX_MAX-HEAP_FL_INDEX_SHIFT+1)
+#define HEAP_SMALL_BLOCK_SIZE (1<<HEAP_FL_INDEX_SHIFT)
+// the bytes of header every block carries
+#define HEAP_BLOCK_OVERHEAD 4
+// the smallest and largest blocks (the usable bytes, not counting the header)
+#define HEAP_BLOCK_SIZE_MIN 12
+#define HEAP_BLOCK_SIZE_MAX ((1<<HEAP_FL_INDEX_MAX)-HEAP_ALIGN_SIZE)
+// the two flags kept in the bottom bits of the blockSize. The size is always a 
+// multiple of 4 so these bits are otherwise always zero
+#define HEAP_BLOCK_FREE_BIT 0x01
+#define HEAP_BLOCK_PREV_FREE_BIT 0x02
+
+/* YakIO_HEAPBLOCK - the header of a block in the heap. 
+ *
+ *   This is a bit tricky. The pointer to a block points at prevPhysBlock, but 
+ *   prevPhysBlock is actually in the last word of the PREVIOUS block. It is 
+ *   only written when the previous block is free, so it does not matter that
+ *   the previous blocks owner could be using that word if it is not. The 
+ *   blockSize is the real start of the block and the memory handed to the 
+ *   user starts at nextFree. nextFree and prevFree are only used while the 
+ *   block is free. So a block in use only costs the 4 bytes of blockSize.
+ * */
+struct YakIO_HEAPBLOCK
+{
+    YakIO_HEAPBLOCK *prevPhysBlock;   // the block before this one in memory, only valid if that block is free
+    unsigned int blockSize;           // the usable size in bytes plus the two flag bits
+    YakIO_HEAPBLOCK *nextFree;        // the next block in this free list
+    YakIO_HEAPBLOCK *prevFree;        // the previous block in this free list
+};
+
+/* YakIO_HEAPSTATS - what GetStatistics() reports
+ * */
+struct YakIO_HEAPSTATS
+{
+    unsigned int totalBytes;          // the size of the whole heap
+    unsigned int freeBytes;           // the total usable bytes in all free blocks
+    unsigned int usedBytes;           // the total usable bytes in all allocated blocks
+    unsigned int largestFreeBytes;    // the biggest single free block
+    unsigned int freeBlockCount;
+    unsigned int usedBlockCount;
+    unsigned int fragmentationPercent;  // 100 - (largestFreeBytes*100/freeBytes)
+};
+
+/* YakIO_HEAP - a class to allocate and free variable sized blocks in a fixed
+ *     time using the TLSF method.
+ * */
+class YakIO_HEAP
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned int totalBytes =0;
+      // bit n is set if any list in firstLevel n has a block in it
+      unsigned int flBitmap =0;
+      // bit m of slBitmap[n] is set if freeLists[n][m] has a block in it
+      unsigned int slBitmap[HEAP_FL_INDEX_COUNT];
+      YakIO_HEAPBLOCK *freeLists[HEAP_FL_INDEX_COUNT][HEAP_SL_INDEX_COUNT];
+      // the first block in memory, for GetStatistics()
+      YakIO_HEAPBLOCK *firstBlock = NULL;
+      // the zero sized block that marks the end of the heap
+      YakIO_HEAPBLOCK *lastBlock = NULL;
+      // running totals. These are kept up to date in a fixed time
+      unsigned int usedBytes =0;
+      unsigned int peakUsedBytes =0;
+      unsigned int failedCount =0;
+
+      static int FindLastSet(unsigned int wordToTest);
+      static int FindFirstSet(unsigned int wordToTest);
+      static unsigned int GetBlockSize(YakIO_HEAPBLOCK *blockPtr);
+      static YakIO_HEAPBLOCK *GetNextPhysBlock(YakIO_HEAPBLOCK *blockPtr);
+      void MappingInsert(unsigned int blockSize, int *flPtr, int *slPtr);
+      void MappingSearch(unsigned int blockSize, int *flPtr, int *slPtr);
+      YakIO_HEAPBLOCK *SearchSuitableBlock(int *flPtr, int *slPtr);
+      void RemoveFreeBlock(YakIO_HEAPBLOCK *blockPtr);
+      void InsertFreeBlock(YakIO_HEAPBLOCK *blockPtr);
+      void MarkAsFree(YakIO_HEAPBLOCK *blockPtr);
+      void MarkAsUsed(YakIO_HEAPBLOCK *blockPtr);
+
+  public:
+      // Constructor to initialize YakIO_HEAP object
+      YakIO_HEAP();
+      void *Allocate(unsigned int bytesNeeded);
+      void Free(void *memPtr);
+      unsigned int GetTotalBytes(void);
+      unsigned int GetUsedBytes(void);
+      unsigned int GetPeakUsedBytes(void);
+      unsigned int GetFailedCount(void);
+      void GetStatistics(YakIO_HEAPSTATS *statsPtr);
+
+};
+
+#endif
@@ -0,0 +1,69 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_HMAC_H
+#define YAKIO_HMAC_H
+
+#include "YakIO.h"
+#include "YakIO_SHA256.h"
+
+// A note on HMAC. HMAC-SHA256 (RFC 2104) is a SHA-256 hash mixed with a secret key. Anyone
+// can work out a hash but only someone with the key can work out the HMAC, so a command 
+// that arrives with the right HMAC on it came from someone who has the key (or is an old 
+// message being played back - put a sequence number in the message to stop that).
+//
+// Every HMAC hashes the key, xored with a pad, before the message and again after it. Those
+// two blocks never change while the key is the same so Start() hashes them once and keeps
+// the two part done hashes. Each message after that costs two blocks less.
+//
+// Data is given with Update() in as many pieces as you like, just as with YakIO_SHA256. 
+// Finish() gives the HMAC and gets ready for the next message with the same key. 
+// FinishAndCheck() compares it with one that came with the message. It always looks at 
+// every byte so the time it takes does not give away how much of a forged HMAC was right.
+//
+// Example:
+//      YakIO_HMAC hmacObj;
+//      hmacObj.Start(keyBytes, 32);
+//      hmacObj.Update(commandBytes, commandLength);
+//      if(hmacObj.FinishAndCheck(receivedMac, HMAC_MAC_BYTES)==0) ... throw it away
+
+#define HMAC_MAC_BYTES         SHA256_HASH_BYTES
+#define HMAC_IPAD_BYTE         0x36
+#define HMAC_OPAD_BYTE         0x5C
+
+/* YakIO_HMAC - HMAC-SHA256 in software
+ * */
+class YakIO_HMAC
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned int hasKey =0;
+      YakIO_SHA256 innerHash {};
+      YakIO_SHA256 innerStartHash {};
+      YakIO_SHA256 outerStartHash {};
+
+  public:
+      // Constructor to initialize YakIO_HMAC object
+      YakIO_HMAC();
+      void Start(const unsigned char *keyBytes, unsigned int keyLength);
+      void Restart(void);
+      void Update(const unsigned char *dataBytes, unsigned int byteCount);
+      void Finish(unsigned char *macBytes);
+      unsigned int FinishAndCheck(const unsigned char *expectedMac, unsigned int macLength);
+      void Stop(void);
+};
+
+#endif
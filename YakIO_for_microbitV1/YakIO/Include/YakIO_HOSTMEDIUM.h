@@ -0,0 +1,115 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_HOSTMEDIUM_H
+#define YAKIO_HOSTMEDIUM_H
+
+#include "YakIO.h"
+#include "YakIO_HOSTREGISTERS.h"
+
+#define HOSTMEDIUM_NODE_COUNT       2        // node 0 is hostRegisters, the others are our own
+#define HOSTMEDIUM_STEP_CYCLES      256      // 16us. Must be less than the start of a packet to its ADDRESS, 384 cycles at 2Mbit
+#define HOSTMEDIUM_PPM_SCALE        1000000  // a clock SetClockPpm() ppm fast runs this many plus ppm cycles to our million
+
+class YakIO_TIMER;
+class YakIO_RADIO;
+class YakIO_RNG;
+class YakIO_ECB;
+class YakIO_CCM;
+class YakIO_UART;
+class YakIO_TRACE;
+
+// A note on the HOST MEDIUM. Like the HOST REGISTER FILE this is NEVER compiled for the 
+// microbit. It lets one test program be two micro:bits which can hear each other, each with
+// its own crystal, so things like YakIO_TIMESYNC can be tested on a PC.
+//
+// Every node has a register file of its own. Node 0 has hostRegisters, the others have
+// one each in here. SelectNode() points activeHostRegisters at that node's file and also
+// swaps the globals the interrupt handlers use to find the YakIO objects (radio_ptr, 
+// timer_ptr0 and the rest) for that node's. So select a node, create the YakIO objects for
+// it and from then on select it again before calling any of them. Create the objects for
+// each node after SelectNode() and never create two of the same peripheral for one node.
+//
+// Time. Advance() moves the medium on by a number of 16MHz cycles of "real" time and every
+// node on by its own number of cycles - SetClockPpm() makes a node's crystal that many 
+// parts per million fast (or slow, if negative). Two nodes set 20ppm apart have TIMERs 
+// which are 20 microseconds apart after a second, just like the real thing. The nodes are
+// moved on in steps of HOSTMEDIUM_STEP_CYCLES, one after the other.
+//
+// The air. After each step any node which has started sending a packet has it handed to 
+// every other node with InjectRadioPacket() - on the frequency and address it was sent to,
+// and late by however long ago, by that node's clock, it started. The ADDRESS event then 
+// happens on both nodes at the same real time, to within a cycle, so a TIMER captured by 
+// the ADDRESS on both (see YakIO_TIMESYNC) reads the two clocks at the same instant. There
+// is no range, no noise and no collisions. Every packet is good unless SetPacketLoss() says
+// some of a node's packets are lost - then nobody hears them at all.
+//
+// Example:
+//      YakIO_HOSTMEDIUM medium;               // a global, it is big
+//      medium.SetClockPpm(1, 25);
+//      medium.SelectNode(0);
+//      YakIO_RADIO radioA {};
+//      medium.SelectNode(1);
+//      YakIO_RADIO radioB {};
+//      ... start them, SelectNode(0) then radioA.Transmit() ...
+//      medium.Advance(16000);                 // a millisecond
+//      medium.SelectNode(1);
+//      radioB.GetReceivedPacket() ... it is there
+//
+// See HostTests/HostTest_TIMESYNC.cpp and HostTests/HostTest_TDMA.cpp.
+
+/* YakIO_HOSTMEDIUM - a class to run more than one micro:bit, with the 
+ *     air between them, when YakIO is compiled for the host
+ * */
+class YakIO_HOSTMEDIUM
+{
+  private:
+      YakIO_HOSTREGISTERS otherRegisters[HOSTMEDIUM_NODE_COUNT-1];
+      YakIO_HOSTREGISTERS *nodeRegistersPtr[HOSTMEDIUM_NODE_COUNT];
+      int clockPpm[HOSTMEDIUM_NODE_COUNT];
+      unsigned long long lastStartCycle[HOSTMEDIUM_NODE_COUNT];
+      unsigned int lossPeriod[HOSTMEDIUM_NODE_COUNT];
+      unsigned int sentCount[HOSTMEDIUM_NODE_COUNT];
+      YakIO_TIMER *nodeTimerPtrs[HOSTMEDIUM_NODE_COUNT][3];
+      YakIO_RADIO *nodeRadioPtr[HOSTMEDIUM_NODE_COUNT];
+      YakIO_RNG *nodeRngPtr[HOSTMEDIUM_NODE_COUNT];
+      YakIO_ECB *nodeEcbPtr[HOSTMEDIUM_NODE_COUNT];
+      YakIO_CCM *nodeCcmPtr[HOSTMEDIUM_NODE_COUNT];
+      YakIO_UART *nodeUartPtr[HOSTMEDIUM_NODE_COUNT];
+      YakIO_TRACE *nodeTracePtr[HOSTMEDIUM_NODE_COUNT];
+      unsigned int selectedNode =0;
+      unsigned long long cycleCount =0;
+      unsigned int deliveredCount =0;
+      unsigned int lostCount =0;
+      unsigned long long GetNodeCycle(unsigned int nodeIndex, unsigned long long mediumCycle);
+      unsigned long long GetMediumCycle(unsigned int nodeIndex, unsigned long long nodeCycle);
+      void SendPacket(unsigned int nodeIndex);
+
+  public:
+      // Constructor to initialize YakIO_HOSTMEDIUM object
+      YakIO_HOSTMEDIUM();
+      void Reset(void);
+      void SelectNode(unsigned int nodeIndex);
+      unsigned int GetSelectedNode(void);
+      void SetClockPpm(unsigned int nodeIndex, int clockPpmIn);
+      void SetPacketLoss(unsigned int nodeIndex, unsigned int lossPeriodIn);
+      void Advance(unsigned int cpuCycles);
+      unsigned long long GetCycleCount(void);
+      unsigned int GetDeliveredCount(void);
+      unsigned int GetLostCount(void);
+};
+
+#endif
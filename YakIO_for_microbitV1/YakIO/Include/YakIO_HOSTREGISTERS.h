@@ -0,0 +1,260 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_HOSTREGISTERS_H
+#define YAKIO_HOSTREGISTERS_H
+
+#include "YakIO.h"
+
+// A note on the HOST REGISTER FILE. This code is NEVER compiled for the microbit. It only
+// exists when YAKIO_HOST is defined - see the note on REGISTER ACCESS in YakIO.h and the
+// "host" target in the Makefile.
+//
+// On a PC there is nothing at address 0x50000508 (GPIO OUTSET) so when the library is built
+// for the host every YAKIO_REGISTER() read or write is sent here instead. The addresses are
+// mapped onto a block of ordinary memory - one 0x1000 byte "page" for each peripheral just
+// like the real chip - and most registers simply remember what was last written to them.
+// A few have a simple working model of what the hardware would do:
+//
+//    GPIO  - OUTSET/OUTCLR and DIRSET/DIRCLR change OUT and DIR. PIN_CNF[n] and DIR share the
+//            direction bit. IN returns OUT for output pins and whatever SetInputPins() was
+//            given for input pins (if the input buffer is connected in PIN_CNF[n]).
+//    TIMER - the START, STOP, CLEAR, COUNT, SHUTDOWN and CAPTURE tasks work. The counter runs
+//            as Advance() is called and honors the PRESCALER, BITMODE and MODE registers. A
+//            match with CC[n] sets COMPARE[n] and runs the CLEAR and STOP shortcuts.
+//    RNG   - the START and STOP tasks work. A new value appears in VALUE and VALRDY is set
+//            every HOSTREG_RNG_CYCLES_PER_VALUE cycles of Advance(). A read of VALRDY that
+//            finds it zero while the RNG is running makes a value there and then so that busy
+//            waits, like the one in YakIO_RNG::GetRngValue(), do not spin forever. The
+//            VALRDY_STOP shortcut works. The values are NOT random, they come from a simple
+//            xorshift generator so the tests get the same numbers every time. 
+//            SetRngStuckValue() makes it go wrong the way a real noise source can - some or
+//            all of the values replaced by one fixed value - to test the health tests.
+//    NVIC  - ISER/ICER and ISPR/ICPR set and clear the enabled and pending bits.
+//    CLOCK - HFCLKSTART sets HFCLKSTARTED
+//    UART  - a write to TXD sets TXDRDY straight away
+//    ECB   - STARTECB encrypts the block straight away with YakIO_SOFTAES and sets ENDECB.
+//            STOPECB sets ERRORECB. The ECBDATAPTR has to come from YAKIO_RAM_ADDRESS()
+//    PPI   - CHENSET/CHENCLR change CHEN. When a model sets an event (a TIMER COMPARE[n], 
+//            a CCM ENDKSGEN etc) SignalEvent() starts the task of every enabled channel
+//            whose EEP is that event, the pre-programmed channels 20 to 31 included. A 
+//            test can call SignalEvent() itself to stand in for a peripheral not modelled.
+//    CCM   - KSGEN sets ENDKSGEN (and runs CRYPT if the shortcut is set). CRYPT does the
+//            Bluetooth low energy AES-CCM on the packet at INPTR with YakIO_SOFTAES, 
+//            writes OUTPTR, sets MICSTATUS and then ENDCRYPT. All of it at once.
+//    RADIO - TXEN/RXEN ramp up for HOSTREG_RADIO_RAMPUP_CYCLES and set READY. START sends
+//            the packet at PACKETPTR, or listens. The ADDRESS and END events come as far 
+//            apart, in Advance() cycles, as the bytes would take on the air at the MODE 
+//            set. STOP, DISABLE (at once, no wait) and the shortcuts work and RSSISTART 
+//            sets RSSISAMPLE. There is no air - InjectRadioPacket() is the other end 
+//            sending to us and GetRadioTxPacket() is the other end hearing what we sent.
+//            Only the LENGTH byte packet YakIO_RADIO uses (no S0 or S1) is modelled and 
+//            the whitening and the CRC are not worked out, the packet says if it is good.
+//            GetRadioAddressCycle() says when the last ADDRESS was, in GetCycleCount() 
+//            time. YakIO_HOSTMEDIUM uses GetRadioAirPacket() and GetRadioStartCycle() to 
+//            carry a packet from one register file to another, see below.
+//
+// Interrupts are only ever taken inside Advance(). Think of it as the only time the CPU is not
+// busy running your test. Any interrupt which is both pending and enabled in the NVIC has its
+// IRQ_?_handler() called - lowest IRQ number first, the priorities are ignored. The TIMER and
+// RNG interrupt lines stay high while the event is set (just like the real thing) so a handler
+// that does not clear its event is called again. HOSTREG_MAX_IRQ_DISPATCH stops that going on
+// forever.
+//
+// The EasyDMA peripherals are given a RAM address in a register. A host pointer does not fit
+// in 32 bits so YAKIO_RAM_ADDRESS() calls MapRamPointer() which hands out a stand in address
+// in the 0x20000000 (RAM) range. There is one for each distinct pointer, up to
+// HOSTREG_RAM_POINTER_COUNT of them, and the low 16 bits are an offset from the pointer so a
+// little arithmetic on the address still works. GetRamPointer() turns it back again.
+//
+// More than one micro:bit. Normally there is just the one register file, hostRegisters. A
+// test can make more and point activeHostRegisters at the one YAKIO_REGISTER() and
+// YAKIO_RAM_ADDRESS() should use - each is then a micro:bit of its own. Do not do that by
+// hand, the interrupt handlers look for the YakIO objects in globals (radio_ptr and the 
+// like) which have to be switched too. YakIO_HOSTMEDIUM does all of it, see the note in
+// YakIO_HOSTMEDIUM.h.
+//
+// Every read and write is counted, both in total and for each peripheral. Zero the counts,
+// call one YakIO function and look at them again and you know exactly how many register
+// accesses that function costs. That makes it easy to write tests which run on any Linux box
+// and catch a change that makes something slower.
+//
+// Example:
+//      hostRegisters.Reset();
+//      YakIO_LEDARRAY ledArray;
+//      hostRegisters.ResetCounters();
+//      ledArray.RefreshLEDArray();
+//      if(hostRegisters.GetWriteCount()>2) ... the refresh has got slower
+//
+// The tests in HostTests do exactly this. See HostTests/HostTest_LEDARRAY.cpp.
+//
+// NOTE: the host is probably a 64 bit machine and the microbit is a 32 bit one. The peripheral
+// drivers are fine with that but code which keeps pointers in an unsigned int (the HEAP, the
+// KERNEL etc) is not compiled for the host. See the Makefile for the list of files.
+
+#define HOSTREG_PAGE_SIZE              0x1000   // every peripheral has 0x1000 bytes of address space
+#define HOSTREG_PAGE_WORDS             (HOSTREG_PAGE_SIZE/BYTES_IN_REGISTER)
+#define HOSTREG_PERIPHERAL_PAGE_COUNT  0x30     // 0x40000000 to 0x4002FFFF, see YakIO.h
+#define HOSTREG_PAGE_GPIO              (HOSTREG_PERIPHERAL_PAGE_COUNT+0)
+#define HOSTREG_PAGE_NVIC              (HOSTREG_PERIPHERAL_PAGE_COUNT+1)
+#define HOSTREG_PAGE_FICR              (HOSTREG_PERIPHERAL_PAGE_COUNT+2)
+#define HOSTREG_PAGE_UICR              (HOSTREG_PERIPHERAL_PAGE_COUNT+3)
+#define HOSTREG_PAGE_COUNT             (HOSTREG_PERIPHERAL_PAGE_COUNT+4)
+#define HOSTREG_PAGE_NONE              -1       // the address is not in any page we model
+#define HOSTREG_PAGE_OF(peripheralAddress) ((int)(((peripheralAddress)-REGISTER_CLOCK)/HOSTREG_PAGE_SIZE)) // only for 0x4000xxxx addresses
+
+#define HOSTREG_TIMER_COUNT            3        // TIMER0, TIMER1 and TIMER2
+#define HOSTREG_TIMER_CC_COUNT         4        // CC[0] to CC[3]
+#define HOSTREG_RNG_CYCLES_PER_VALUE   1600     // about 100us at 16MHz. Not the data sheet figure, just close enough
+#define HOSTREG_MAX_IRQ_DISPATCH       64       // most handler calls in one Advance()
+#define HOSTREG_RNG_DEFAULT_SEED       0x2545F491
+#define HOSTREG_RAM_POINTER_COUNT      16       // distinct pointers MapRamPointer() remembers
+#define HOSTREG_RAM_ADDRESS_BASE       0x20000000
+#define HOSTREG_RAM_BASE_MASK          0xFFF00000 // leaves 4 bits of index and 16 of offset
+#define HOSTREG_RAM_OFFSET_MASK        0x0000FFFF
+#define HOSTREG_RAM_INDEX_SHIFT        16
+#define HOSTREG_MAX_PPI_DEPTH          8        // an event starting a task which sets an event ...
+#define HOSTREG_RADIO_RAMPUP_CYCLES    2080     // 130us, TXEN or RXEN to READY
+#define HOSTREG_RADIO_BYTE_CYCLES_1MBIT 128     // 8us a byte at 1Mbit, half that at 2Mbit
+#define HOSTREG_RADIO_PREAMBLE_BYTES   1
+#define HOSTREG_RADIO_PACKET_BYTES     256      // a LENGTH byte and up to 255 payload bytes
+#define HOSTREG_RADIO_DEFAULT_RSSI     50       // -50dBm, a micro:bit on the next desk
+
+/* YakIO_HOSTREGISTER - stands in for a single peripheral register. The
+ *     YAKIO_REGISTER() macro creates one of these for the address given.
+ *     Reading it (using it as an unsigned int) calls hostRegisters.Read()
+ *     and assigning to it calls hostRegisters.Write(). You never need to
+ *     use this class directly.
+ * */
+class YakIO_HOSTREGISTER
+{
+  private:
+      unsigned int registerAddress =0;
+
+  public:
+      YakIO_HOSTREGISTER(unsigned int registerAddressIn);
+      operator unsigned int() const;
+      YakIO_HOSTREGISTER &operator=(unsigned int registerValue);
+      YakIO_HOSTREGISTER &operator=(const YakIO_HOSTREGISTER &otherRegister);
+};
+
+/* YakIO_HOSTREGISTERS - a class to simulate the nRF51822 peripheral
+ *     registers when YakIO is compiled for the host
+ * */
+class YakIO_HOSTREGISTERS
+{
+  private:
+      unsigned int pageWords[HOSTREG_PAGE_COUNT][HOSTREG_PAGE_WORDS];
+      unsigned int pageReadCount[HOSTREG_PAGE_COUNT];
+      unsigned int pageWriteCount[HOSTREG_PAGE_COUNT];
+      unsigned int readCount =0;
+      unsigned int writeCount =0;
+      unsigned int unmappedCount =0;
+      unsigned int irqCount =0;
+      unsigned int activeIRQBits =0;
+      unsigned int inputPins =0;
+      unsigned int timerCounter[HOSTREG_TIMER_COUNT];
+      unsigned int timerIsRunning[HOSTREG_TIMER_COUNT];
+      unsigned int timerCycleRemainder[HOSTREG_TIMER_COUNT];
+      unsigned int rngIsRunning =0;
+      unsigned int rngCycleRemainder =0;
+      unsigned int rngState =HOSTREG_RNG_DEFAULT_SEED;
+      unsigned int rngStuckValue =0;
+      unsigned int rngStuckPeriod =0;
+      unsigned int rngStuckCount =0;
+      void *ramPointers[HOSTREG_RAM_POINTER_COUNT];
+      unsigned int ramPointerNext =0;
+      unsigned int ppiDepth =0;
+      unsigned long long cycleCount =0;
+      unsigned long long radioAddressCycle =0;
+      unsigned int radioCyclesToEvent =0;        // zero when nothing is on its way
+      unsigned int radioNextEvent =0;
+      unsigned int radioPacketAddress =0;        // PACKETPTR as it was at START
+      unsigned long long radioStartCycle =0;     // when the packet on the air started
+      unsigned char radioAirBytes[HOSTREG_RADIO_PACKET_BYTES];
+      unsigned int radioAirCrcIsGood =0;
+      unsigned int radioTxCount =0;
+      unsigned int radioTxFrequency =0;
+      unsigned char radioTxBytes[HOSTREG_RADIO_PACKET_BYTES];
+      int GetPageIndex(unsigned int registerAddress);
+      unsigned int &GetWord(int pageIndex, unsigned int registerAddress);
+      int GetTimerIndex(int pageIndex);
+      unsigned int GetTimerMask(int timerIndex);
+      unsigned int IsTimerTicking(int timerIndex);
+      unsigned int GetTimerPrescaler(int timerIndex);
+      unsigned long long GetTicksToMatch(int timerIndex);
+      void AdvanceTimer(int timerIndex, unsigned int cpuCycles);
+      void CountTimer(int timerIndex);
+      void CompareTimer(int timerIndex);
+      void MakeRngValue(void);
+      void UpdateIRQLines(void);
+      void DispatchPendingIRQs(void);
+      void CallIRQHandler(int irqNum);
+      unsigned int ReadGPIO(unsigned int registerOffset);
+      void WriteGPIO(unsigned int registerOffset, unsigned int registerValue);
+      void WriteTimer(int timerIndex, unsigned int registerOffset, unsigned int registerValue);
+      void WriteRNG(unsigned int registerOffset, unsigned int registerValue);
+      void WriteNVIC(unsigned int registerOffset, unsigned int registerValue);
+      void WriteECB(unsigned int registerOffset, unsigned int registerValue);
+      void WritePPI(unsigned int registerOffset, unsigned int registerValue);
+      void WriteCCM(unsigned int registerOffset, unsigned int registerValue);
+      void RunCCM(void);
+      void WriteRadio(unsigned int registerOffset, unsigned int registerValue);
+      void RaiseRadioEvent(unsigned int eventOffset);
+      void FinishRadioStep(void);
+      unsigned int GetRadioByteCycles(void);
+      unsigned int GetRadioAddressCycles(void);
+      void DispatchWrite(int pageIndex, unsigned int registerAddress, unsigned int registerValue);
+
+  public:
+      // Constructor to initialize YakIO_HOSTREGISTERS object
+      YakIO_HOSTREGISTERS();
+      void Reset(void);
+      unsigned int Read(unsigned int registerAddress);
+      void Write(unsigned int registerAddress, unsigned int registerValue);
+      unsigned int Peek(unsigned int registerAddress);
+      void Poke(unsigned int registerAddress, unsigned int registerValue);
+      void Advance(unsigned int cpuCycles);
+      unsigned long long GetCycleCount(void);
+      void SetInputPins(unsigned int inputPinsIn);
+      void SetRngSeed(unsigned int rngSeed);
+      void SetRngStuckValue(unsigned int stuckValue, unsigned int stuckPeriod);
+      void SignalEvent(unsigned int eventAddress);
+      unsigned int MapRamPointer(void *ramPtr);
+      void *GetRamPointer(unsigned int ramAddress);
+      unsigned int InjectRadioPacket(unsigned int radioFrequency, unsigned int baseAddress, unsigned int prefixByte, const unsigned char *packetBytes, unsigned int crcIsGood);
+      unsigned int InjectRadioPacket(unsigned int radioFrequency, unsigned int baseAddress, unsigned int prefixByte, const unsigned char *packetBytes, unsigned int crcIsGood, unsigned int cyclesOnAir);
+      unsigned int GetRadioAirPacket(unsigned char *packetBytes);
+      unsigned long long GetRadioStartCycle(void);
+      unsigned int GetRadioTxCount(void);
+      unsigned int GetRadioTxFrequency(void);
+      unsigned int GetRadioTxPacket(unsigned char *packetBytes);
+      unsigned long long GetRadioAddressCycle(void);
+      void ResetCounters(void);
+      unsigned int GetReadCount(void);
+      unsigned int GetWriteCount(void);
+      unsigned int GetReadCount(unsigned int peripheralAddress);
+      unsigned int GetWriteCount(unsigned int peripheralAddress);
+      unsigned int GetUnmappedCount(void);
+      unsigned int GetIRQCount(void);
+};
+
+// the register file. All YAKIO_REGISTER() accesses end up here unless 
+// activeHostRegisters is pointed somewhere else, see the note above
+extern YakIO_HOSTREGISTERS hostRegisters;
+extern YakIO_HOSTREGISTERS *activeHostRegisters;
+
+#endif
@@ -0,0 +1,366 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_HSM_H
+#define YAKIO_HSM_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_EVENTLOOP.h"
+
+// A note on HIERARCHICAL STATE MACHINES.
+//
+// Look at the Heartbeat() in 06_deBounce. It counts heartbeats while the button is down and sets
+// a flag when it comes back up, provided the count was big enough. That is a state machine - 
+// the button is "up", "bouncing" or "held" - but the states are hidden in a counter and a flag.
+// Add a long-press or a double-click and it quickly becomes a mess.
+//
+// YakIO_HSM lets you write the states down explicitly. You give it two constant tables:
+//
+//   The STATE table. One entry per state: its parent state, the function to call when the state
+//   is entered and the function to call when it is left. 
+//
+//   The TRANSITION table. One entry for every state AND every event: the state to go to and the
+//   function to call on the way. An entry with a target of HSM_NO_STATE means "this state does
+//   not handle this event" and an entry with a target of HSM_INTERNAL means "run the function 
+//   but stay in the same state (do not exit or enter anything)".
+//
+// The "hierarchical" part is the parent state. If the current state does not handle an event 
+// then its parent is asked, then the parents parent and so on. So an event that should do the 
+// same thing in a group of states only needs to be handled once, in the parent of the group. 
+// When a transition happens the exit functions are called from the current state up to (but not
+// including) the nearest parent the old and new states have in common. The entry functions are 
+// then called from just below that common parent down to the new state. Transitions should 
+// always target a state with no children.
+//
+// Both tables are "static const" members of your class. Because they only contain numbers and
+// the addresses of (non virtual) member functions the compiler can work them out completely at
+// compile time and they are placed in flash. They use no RAM at all. 
+//
+// Handling an event is never a virtual function call and never a search. For each level of the
+// hierarchy it is one lookup in the transition table (row = state, column = event). A transition
+// then walks up and down the hierarchy at most HSM_MAX_DEPTH levels each way. There are no other
+// loops, so the time taken is bounded and does not depend on how big your tables are. With the 
+// hierarchy only two or three levels deep, as is usual, it is a few tens of instructions plus 
+// whatever your entry, exit and transition functions do.
+//
+// Events arrive through the YakIO_EVENTLOOP. Register your YakIO_HSM object as the handler of its
+// events and the event loop calls Dispatch() for you through EventCallback(). Timers (or anything
+// else that calls back through the YakIO_CALLBACK interface) can feed events in directly: use 
+// SetCallbackEvent() to say which event a Callback0() to Callback3() call turns into and give 
+// your YakIO_HSM object to the timer as its callback object. Events fed in this way are posted to
+// the event loop, they are never dispatched inside the interrupt handler.
+//
+// Since YakIO_HSM is a template its code has to live here in the header file. The compiler needs
+// to see all of it in order to generate a version for each class you use it with. This is the 
+// only reason it is not in a .cpp file like the other YakIO classes.
+//
+// Example:
+//      class MyMachine : public YakIO_HSM<MyMachine>
+//      {
+//          static const HSM_STATE stateTable[NUM_STATES];
+//          static const HSM_TRANSITION transitionTable[NUM_STATES][NUM_EVENTS];
+//          void OnEnterIdle(unsigned int eventData);
+//          ...
+//      };
+//
+// See the 12_StateMachine example.
+
+// a target state meaning "this state does not handle this event, ask the parent". Also
+// the parent of a state at the top of the hierarchy
+#define HSM_NO_STATE 0xFF
+// a target state meaning "run the transition function but do not change state"
+#define HSM_INTERNAL 0xFE
+// the deepest a hierarchy can be. A state with no parent is at depth 1
+#define HSM_MAX_DEPTH 8
+// the number of Callback functions (Callback0() to Callback3()) which can feed events
+#define HSM_NUM_CALLBACK_EVENTS 4
+
+/* YakIO_HSM - a hierarchical state machine driven by constant tables. 
+ *     MACHINE is the class which inherits from it and contains the tables 
+ *     and the entry, exit and transition functions.
+ * */
+template <class MACHINE>
+class YakIO_HSM : public YakIO_CALLBACK
+{
+  public:
+      // the entry, exit and transition functions all look like this. Entry and 
+      // exit functions get the eventData of the event which caused the transition
+      typedef void (MACHINE::*HSM_ACTION)(unsigned int eventData);
+
+      // one row of the state table
+      struct HSM_STATE
+      {
+          unsigned int parentState;      // HSM_NO_STATE if at the top
+          HSM_ACTION entryAction;        // may be NULL
+          HSM_ACTION exitAction;         // may be NULL
+      };
+
+      // one entry in the transition table
+      struct HSM_TRANSITION
+      {
+          unsigned int targetState;      // the new state, HSM_NO_STATE or HSM_INTERNAL
+          HSM_ACTION transitionAction;   // may be NULL
+      };
+
+  private:
+      unsigned int isInitialized =0;
+      const HSM_STATE *stateTable = NULL;
+      unsigned int numStates =0;
+      const HSM_TRANSITION *transitionTable = NULL;
+      unsigned int numEvents =0;
+      YakIO_EVENTLOOP *eventLoopPtr = NULL;
+      unsigned int currentState = HSM_NO_STATE;
+      unsigned int callbackEvents[HSM_NUM_CALLBACK_EVENTS];
+      unsigned int unhandledEventCount =0;
+
+    /* CallAction - calls one of the entry, exit or transition functions 
+     *    of the MACHINE
+     * */
+    void CallAction(HSM_ACTION actionToCall, unsigned int eventData)
+    {
+        if(actionToCall==NULL) return;
+        (static_cast<MACHINE *>(this)->*actionToCall)(eventData);
+    }
+
+    /* IsStrictAncestor - tests if one state is a parent (or a parents 
+     *    parent, etc) of another
+     *
+     * returns:
+     *    nz if ancestorState is above childState, z if not. A state is 
+     *    not its own ancestor
+     * */
+    unsigned int IsStrictAncestor(unsigned int ancestorState, unsigned int childState)
+    {
+        unsigned int state = stateTable[childState].parentState;
+        for(unsigned int i=0; (i<HSM_MAX_DEPTH) && (state!=HSM_NO_STATE); i++)
+        {
+            if(state==ancestorState) return 1;
+            state = stateTable[state].parentState;
+        }
+        return 0;
+    }
+
+    /* Transition - moves from the current state to a new one. 
+     *
+     * inputs:
+     *    sourceState - the state whose transition table entry we are using. 
+     *       This is the current state or one of its parents
+     *    targetState - the new state
+     *    transitionAction - the function to call on the way
+     *    eventData - passed to all of the functions
+     * */
+    void Transition(unsigned int sourceState, unsigned int targetState, HSM_ACTION transitionAction, unsigned int eventData)
+    {
+        // find the common parent. We do not exit or enter this. If the 
+        // target is the source itself (or one of its parents) we go one 
+        // level higher so it is exited and entered again
+        unsigned int commonState = sourceState;
+        for(unsigned int i=0; (i<HSM_MAX_DEPTH) && (commonState!=HSM_NO_STATE); i++)
+        {
+            if(IsStrictAncestor(commonState, targetState)!=0) break;
+            commonState = stateTable[commonState].parentState;
+        }
+
+        // exit from where we are up to the common parent
+        unsigned int state = currentState;
+        for(unsigned int i=0; (i<HSM_MAX_DEPTH) && (state!=commonState) && (state!=HSM_NO_STATE); i++)
+        {
+            CallAction(stateTable[state].exitAction, eventData);
+            state = stateTable[state].parentState;
+        }
+
+        CallAction(transitionAction, eventData);
+
+        // we have to enter from the top down but the table only links
+        // from the bottom up. So note the path first
+        unsigned int enterPath[HSM_MAX_DEPTH];
+        unsigned int pathLength = 0;
+        state = targetState;
+        while((pathLength<HSM_MAX_DEPTH) && (state!=commonState) && (state!=HSM_NO_STATE))
+        {
+            enterPath[pathLength++] = state;
+            state = stateTable[state].parentState;
+        }
+        currentState = targetState;
+        while(pathLength>0)
+        {
+            pathLength--;
+            CallAction(stateTable[enterPath[pathLength]].entryAction, eventData);
+        }
+    }
+
+  public:
+
+    /* constructor
+     *
+     * inputs:
+     *    stateTableIn - the state table
+     *    numStatesIn - the number of states in it
+     *    transitionTableIn - the transition table. This is numStatesIn rows 
+     *       of numEventsIn entries each
+     *    numEventsIn - the number of events
+     *    eventLoopPtrIn - the event loop events are posted to by FeedEvent(). 
+     *       This can be NULL if you only ever call Dispatch() yourself
+     * */
+    YakIO_HSM(const HSM_STATE *stateTableIn, unsigned int numStatesIn, const HSM_TRANSITION *transitionTableIn, unsigned int numEventsIn, YakIO_EVENTLOOP *eventLoopPtrIn)
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        stateTable = stateTableIn;
+        numStates = numStatesIn;
+        transitionTable = transitionTableIn;
+        numEvents = numEventsIn;
+        eventLoopPtr = eventLoopPtrIn;
+        currentState = HSM_NO_STATE;
+        for(unsigned int i=0; i<HSM_NUM_CALLBACK_EVENTS; i++) callbackEvents[i] = HSM_NO_STATE;
+    }
+
+    /* Start - puts the machine into its first state, calling the entry 
+     *    functions from the top of the hierarchy down.
+     *
+     * inputs:
+     *    initialState - the first state. It should have no children
+     * */
+    void Start(unsigned int initialState)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(initialState>=numStates) return;
+
+        // with no current state nothing is exited
+        currentState = HSM_NO_STATE;
+        Transition(HSM_NO_STATE, initialState, NULL, 0);
+    }
+
+    /* Dispatch - handles an event now. Usually the event loop calls this
+     *    for you.
+     *
+     * inputs:
+     *    eventType - the event
+     *    eventData - passed to the functions called
+     *
+     * returns:
+     *    1 if some state handled the event, 0 if it was ignored
+     * */
+    unsigned int Dispatch(unsigned int eventType, unsigned int eventData)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(eventType>=numEvents) return 0;
+
+        // ask the current state, then its parents
+        unsigned int state = currentState;
+        for(unsigned int i=0; (i<HSM_MAX_DEPTH) && (state!=HSM_NO_STATE); i++)
+        {
+            const HSM_TRANSITION *transitionPtr = &transitionTable[(state*numEvents)+eventType];
+            if(transitionPtr->targetState==HSM_INTERNAL)
+            {
+                CallAction(transitionPtr->transitionAction, eventData);
+                return 1;
+            }
+            if(transitionPtr->targetState!=HSM_NO_STATE)
+            {
+                Transition(state, transitionPtr->targetState, transitionPtr->transitionAction, eventData);
+                return 1;
+            }
+            state = stateTable[state].parentState;
+        }
+        unhandledEventCount++;
+        return 0;
+    }
+
+    /* FeedEvent - posts an event to the event loop. Safe to call from an
+     *    interrupt handler. The event loop calls Dispatch() later.
+     *
+     *    NOTE: the eventType must have been registered with the event 
+     *    loop with this object as its handler.
+     *
+     * inputs:
+     *    eventType - the event
+     *    eventData - passed to the functions called
+     * */
+    void FeedEvent(unsigned int eventType, unsigned int eventData)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(eventLoopPtr==NULL) return;
+        eventLoopPtr->PostEvent(eventType, eventData);
+    }
+
+    /* SetCallbackEvent - sets the event a Callback0() to Callback3() call 
+     *    is turned into. Use this to have a timer feed events directly.
+     *
+     * inputs:
+     *    callbackIDIn - which Callback. CALLBACK_0 to CALLBACK_3
+     *    eventType - the event to feed when it is called
+     * */
+    void SetCallbackEvent(enum CALLBACK_ID callbackIDIn, unsigned int eventType)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(callbackIDIn==CALLBACK_0) callbackEvents[0] = eventType;
+        else if(callbackIDIn==CALLBACK_1) callbackEvents[1] = eventType;
+        else if(callbackIDIn==CALLBACK_2) callbackEvents[2] = eventType;
+        else if(callbackIDIn==CALLBACK_3) callbackEvents[3] = eventType;
+    }
+
+    /* GetCurrentState - gets the current state. This is always a state
+     *    with no children
+     * */
+    unsigned int GetCurrentState(void)
+    {
+        return currentState;
+    }
+
+    /* IsInState - tests if we are in a state or any of its children 
+     *
+     * returns:
+     *    nz if we are, z if we are not
+     * */
+    unsigned int IsInState(unsigned int stateToTest)
+    {
+        if(currentState==HSM_NO_STATE) return 0;
+        if(currentState==stateToTest) return 1;
+        return IsStrictAncestor(stateToTest, currentState);
+    }
+
+    /* GetUnhandledEventCount - gets the number of events no state handled
+     * */
+    unsigned int GetUnhandledEventCount(void)
+    {
+        return unhandledEventCount;
+    }
+
+    /* EventCallback - the event loop delivers our events here 
+     * */
+    void EventCallback(unsigned int eventType, unsigned int eventData) override
+    {
+        Dispatch(eventType, eventData);
+    }
+
+    // timers (and other interrupt driven objects) arrive at these. We 
+    // turn them into events. See SetCallbackEvent()
+    void Callback0(void) override { if(callbackEvents[0]!=HSM_NO_STATE) FeedEvent(callbackEvents[0], 0); }
+    void Callback1(void) override { if(callbackEvents[1]!=HSM_NO_STATE) FeedEvent(callbackEvents[1], 0); }
+    void Callback2(void) override { if(callbackEvents[2]!=HSM_NO_STATE) FeedEvent(callbackEvents[2], 0); }
+    void Callback3(void) override { if(callbackEvents[3]!=HSM_NO_STATE) FeedEvent(callbackEvents[3], 0); }
+
+};
+
+#endif
@@ -0,0 +1,167 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_KERNEL_H
+#define YAKIO_KERNEL_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_Utils.h"
+
+// A note on THREADS.
+//
+// Normally a YakIO program has exactly one thing running - the MainLoop() - plus whatever interrupt
+// handlers happen to fire. YakIO_KERNEL lets you have several "threads" instead. Each thread is just
+// a function (one of the Callback0() to Callback3() functions of some object) with its own stack. 
+// The kernel switches the CPU between them so quickly they appear to run at the same time.
+//
+// Each thread has a priority. The kernel always runs the highest priority thread which is ready to
+// run. Threads of equal priority take turns, swapping every kernel tick (1 millisecond). A thread
+// which wants to wait for something - a period of time (Sleep()), a YakIO_SEMAPHORE or a 
+// YakIO_MSGQUEUE - is put to one side and uses no CPU at all until the thing it is waiting for 
+// happens. When no thread at all is ready the kernel runs its own idle thread which puts the CPU 
+// to sleep with the WFI instruction.
+//
+// The switching is "preemptive". If an interrupt handler gives a semaphore that a higher priority
+// thread is waiting on, that thread starts running as soon as the interrupt handler returns. The
+// lower priority thread that was running is simply frozen where it was and resumed later.
+//
+// How does the switching happen? The Cortex-M0 has a special low priority exception called PendSV
+// (Pended Service Call). The kernel decides which thread should run next and then "pends" PendSV. 
+// Because PendSV has the lowest priority of all the exceptions it only runs when every other 
+// interrupt handler has finished. When it runs the CPU has already saved half of the registers of
+// the old thread on its stack (that is what the CPU always does on entry to an exception). The
+// PendSV handler saves the other half, records the old threads stack pointer, loads the new threads
+// stack pointer, restores the new threads registers and returns. The CPU restores the other half of
+// the registers as it returns from the exception - and it is now running the new thread.
+//
+// The threads run on the Process Stack Pointer (PSP), each with their own stack. Interrupt handlers
+// always run on the Main Stack Pointer (MSP) which is the stack the MainLoop() was using. This means
+// each thread stack only has to be big enough for the thread itself and not for the interrupts too.
+//
+// THE COST OF A CONTEXT SWITCH: The PENDSVC_handler() in YakIO_KERNEL.cpp is 31 instructions. 
+// Adding up the instruction timings from the ARM Cortex-M0 Technical Reference Manual (and 
+// assuming, as is the case on the nRF51822 at 16MHz, no flash wait states) gives 60 cycles for 
+// the handler, 16 cycles for the CPU to enter the exception and 16 to return from it. That is 
+// about 92 cycles or 5.75 microseconds from the point PendSV is taken to the first instruction of
+// the new thread. Deciding which thread should run next (Schedule()) is extra and grows with the 
+// number of threads - it is a simple loop over KERNEL_MAX_THREADS entries.
+//
+// IMPORTANT: The nRF51822 does NOT have the SysTick timer that most Cortex-M0 chips use as the 
+// kernel tick. YakIO_KERNEL uses one of the YakIO_TIMERs instead. You choose which one when you 
+// create the kernel object. Do not use that timer for anything else.
+//
+// IMPORTANT: Start() never returns. Once it is called the MainLoop() is finished and the threads
+// take over. Create all your threads before you call it.
+//
+// IMPORTANT: Thread stacks must be big enough! There is no protection. If a thread overflows its
+// stack it will corrupt whatever is next to it in RAM. Each stack needs at least 
+// KERNEL_MIN_STACK_WORDS plus whatever the thread function itself uses.
+//
+// See the 10_Threads example.
+
+// the maximum number of threads, not counting the kernels own idle thread
+#define KERNEL_MAX_THREADS 4
+// the smallest stack (in 32 bit words) we will accept. 16 words are needed just to 
+// hold the registers of a thread that is not running
+#define KERNEL_MIN_STACK_WORDS 32
+// the size of the stack of the idle thread, in 32 bit words
+#define KERNEL_IDLE_STACK_WORDS 48
+// a timeout value meaning "wait forever"
+#define KERNEL_WAIT_FOREVER 0xFFFFFFFF
+
+// the System Control Block registers we need. These are not in the nRF51822 reference 
+// guide. You have to go to the ARMv6-M Architecture Reference Manual. They are offsets 
+// from the same base address as the NVIC (REGISTER_NVIC)
+#define SCBREG_OFFSET_ICSR      0xD04 // Interrupt Control and State Register
+#define SCBREG_OFFSET_SHPR3     0xD20 // System Handler Priority Register 3 (PendSV and SysTick)
+#define SCB_ICSR_PENDSVSET_BIT  0x10000000 // write a 1 here to pend PendSV
+#define SCB_SHPR3_PENDSV_LOWEST 0x00C00000 // the lowest priority (3) in the PendSV field
+
+// the states a thread can be in
+enum THREAD_STATE {
+    THREAD_STATE_UNUSED=0,     // this slot has no thread in it
+    THREAD_STATE_READY,        // the thread can run (and might be running right now)
+    THREAD_STATE_SLEEPING,     // the thread is in Sleep() 
+    THREAD_STATE_BLOCKED       // the thread is waiting on a semaphore or queue
+};
+
+// why a blocked thread was woken up
+enum THREAD_WAKE_REASON {
+    THREAD_WAKE_SIGNALLED=0,   // the thing it was waiting for happened
+    THREAD_WAKE_TIMEOUT=1      // it got tired of waiting
+};
+
+// everything the kernel knows about a thread. 
+//
+// NOTE: savedStackPointer MUST be the first member. The assembler code in 
+// PENDSVC_handler() reads and writes it at offset 0.
+struct YakIO_THREAD
+{
+    unsigned int *savedStackPointer;                   // where the registers were saved when it stopped running
+    unsigned int priority;                             // bigger is more important, 0 is reserved for the idle thread
+    volatile enum THREAD_STATE threadState;
+    volatile unsigned int wakeTick;                    // the tick count to wake up on if sleeping or waiting with a timeout
+    volatile unsigned int hasTimeout;                  // nz if wakeTick applies to a blocked thread
+    volatile enum THREAD_WAKE_REASON wakeReason;
+    volatile unsigned int *waitListPtr;                // the wait list of the semaphore we are blocked on
+    YakIO_CALLBACK *callbackInterfacePtr;              // the object with the thread function in it
+    enum CALLBACK_ID callbackID;                       // which of its functions is the thread
+};
+
+/* YakIO_KERNEL - a class to run several threads, each with their own 
+ *     stack, switching between them by priority.
+ * */
+class YakIO_KERNEL : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned int isRunning =0;
+      // the timer that generates the kernel tick
+      YakIO_TIMER tickTimerObj;
+      volatile unsigned int tickCount =0;
+      // the threads. The last slot is always the idle thread
+      YakIO_THREAD threads[KERNEL_MAX_THREADS+1];
+      unsigned int idleThreadStack[KERNEL_IDLE_STACK_WORDS];
+      unsigned int InitThread(unsigned int threadIndex, unsigned int priority, unsigned int *stackPtr, unsigned int stackWords, enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      static void ThreadEntry(YakIO_THREAD *threadPtr);
+
+  public:
+      // Constructor to initialize YakIO_KERNEL object
+      YakIO_KERNEL(enum TIMER tickTimerIDIn);
+      int CreateThread(unsigned int priority, unsigned int *stackPtr, unsigned int stackWords, enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void Start(void);
+      void Sleep(unsigned int ticksToSleep);
+      void Yield(void);
+      unsigned int GetTickCount(void);
+      unsigned int IsRunning(void);
+      int GetCurrentThreadIndex(void);
+      enum THREAD_WAKE_REASON BlockCurrentThread(volatile unsigned int *waitListPtr, unsigned int timeoutTicks);
+      void WakeHighestWaiter(volatile unsigned int *waitListPtr);
+      void Schedule(void);
+      // the kernel tick arrives here from the tick timer
+      void Callback0(void) override;
+      // the idle thread runs here
+      void Callback1(void) override;
+
+};
+
+// the kernel object. There can be only one. This is set in the kernel 
+// constructor so the YakIO_SEMAPHORE and YakIO_MSGQUEUE classes can find it.
+extern YakIO_KERNEL *kernel_ptr;
+
+#endif
@@ -0,0 +1,70 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_MEMORY_H
+#define YAKIO_MEMORY_H
+
+#include <cstddef>
+
+// A note on MEMCPY and friends. The linker script (microbit.ld) throws away all of the standard C
+// library (libc.a) - see the notes in there for why. That means the usual memcpy(), memset() and 
+// memmove() functions are not there either. The trouble is the compiler itself quietly calls them
+// when it needs to copy or clear a big struct or array, so they have to come from somewhere. They
+// come from here.
+//
+// These are written for the Cortex-M0. A byte at a time copy takes about 5 CPU cycles per byte. 
+// The Cortex-M0 can load or store a whole 32 bit word in the same time as a single byte and the
+// LDM/STM (load and store multiple) instructions can move four words in about half the time it 
+// takes to move them one at a time. So:
+//
+//    1) if the source and destination are both word aligned (or can be made word aligned by 
+//       copying a few bytes first) we copy 16 bytes at a time with LDM/STM, then a word at a
+//       time, then the last few bytes one at a time.
+//    2) if they can never both be aligned (the source starts one byte into a word and the 
+//       destination starts two bytes in for example) we have to go a byte at a time. The 
+//       Cortex-M0 faults on unaligned word accesses.
+//
+// Big aligned copies run at roughly 1.25 CPU cycles per byte. The 08_Benchmark example compares
+// them with a plain byte loop.
+//
+// IMPORTANT: The compiler is quite capable of spotting a plain byte copy or clear loop and 
+// replacing it with a call to memcpy() or memset(). If it did that inside memset() itself then
+// memset() would call itself forever. The -fno-tree-loop-distribute-patterns in the compile 
+// flags (see CompileYakIO.bat) stops it doing that.
+//
+// The ARM EABI also defines __aeabi_memcpy() and friends which the compiler and libgcc can call
+// instead. They are here too and just pass the call on.
+
+extern "C" {
+void *memcpy(void *destPtr, const void *srcPtr, size_t byteCount);
+void *memset(void *destPtr, int byteValue, size_t byteCount);
+void *memmove(void *destPtr, const void *srcPtr, size_t byteCount);
+
+void __aeabi_memcpy(void *destPtr, const void *srcPtr, size_t byteCount);
+void __aeabi_memcpy4(void *destPtr, const void *srcPtr, size_t byteCount);
+void __aeabi_memcpy8(void *destPtr, const void *srcPtr, size_t byteCount);
+void __aeabi_memmove(void *destPtr, const void *srcPtr, size_t byteCount);
+void __aeabi_memmove4(void *destPtr, const void *srcPtr, size_t byteCount);
+void __aeabi_memmove8(void *destPtr, const void *srcPtr, size_t byteCount);
+void __aeabi_memset(void *destPtr, size_t byteCount, int byteValue);
+void __aeabi_memset4(void *destPtr, size_t byteCount, int byteValue);
+void __aeabi_memset8(void *destPtr, size_t byteCount, int byteValue);
+void __aeabi_memclr(void *destPtr, size_t byteCount);
+void __aeabi_memclr4(void *destPtr, size_t byteCount);
+void __aeabi_memclr8(void *destPtr, size_t byteCount);
+}
+
+#endif
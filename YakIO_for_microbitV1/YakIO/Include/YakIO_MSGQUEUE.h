@@ -0,0 +1,62 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_MSGQUEUE_H
+#define YAKIO_MSGQUEUE_H
+
+#include "YakIO.h"
+#include "YakIO_KERNEL.h"
+#include "YakIO_SEMAPHORE.h"
+
+// A note on MESSAGE QUEUES.
+//
+// A message queue passes values from one thread (or interrupt handler) to another. Each message 
+// is a single 32 bit word - a number, or if you are careful, a pointer to something bigger. 
+// Send() puts a message in at one end and Receive() takes the oldest one out of the other end.
+//
+// If the queue is empty Receive() waits for a message to arrive. If the queue is full Send()
+// waits for a space. As with YakIO_SEMAPHORE, only threads can wait. Interrupt handlers must
+// use a timeout of 0 which means "do not wait, just tell me if it did not work".
+//
+// Internally it is just a circular buffer and two semaphores. One counts the messages waiting 
+// and the other counts the free spaces.
+
+// the number of messages a queue can hold
+#define MSGQUEUE_SIZE 8
+
+/* YakIO_MSGQUEUE - a class to pass 32 bit messages between YakIO_KERNEL 
+ *     threads and interrupt handlers
+ * */
+class YakIO_MSGQUEUE
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned int messages[MSGQUEUE_SIZE];
+      unsigned int queueHead =0;   // where the next message is taken from
+      unsigned int queueTail =0;   // where the next message is put
+      YakIO_SEMAPHORE messagesWaiting {0, MSGQUEUE_SIZE};
+      YakIO_SEMAPHORE spacesFree {MSGQUEUE_SIZE, MSGQUEUE_SIZE};
+
+  public:
+      // Constructor to initialize YakIO_MSGQUEUE object
+      YakIO_MSGQUEUE();
+      unsigned int Send(unsigned int message, unsigned int timeoutTicks);
+      unsigned int Receive(unsigned int *messagePtr, unsigned int timeoutTicks);
+      unsigned int GetMessageCount(void);
+
+};
+
+#endif
@@ -83,4 +83,24 @@
 #define IRQ_NVMC    0x1E // NVMC Non Volatile Memory Controller
 #define IRQ_PPI     0x1F // PPI PPI controller
 
+// A note on interrupt PRIORITIES. The Cortex-M0 has four interrupt priority levels. An
+// interrupt can only interrupt a handler of a lower priority (a bigger number) - two 
+// interrupts at the same priority just wait for each other. Every interrupt starts off at 
+// priority 0, the highest, so out of the box nothing ever interrupts a handler.
+//
+// Each PRIn register holds the priority of four IRQs, one per byte, and only the top two
+// bits of each byte are used. These registers can only be accessed a whole word at a time
+// on the Cortex-M0. See SetIRQPriority() in YakIO_Utils.
+#define NVIC_PRIORITY_BIT_SHIFT   6    // the two priority bits are the top two of each byte
+#define NVIC_PRIORITY_MASK        0x03
+
+// note the value here is carefully set to the value we have to 
+// stuff in the register to set the priority properly
+enum IRQ_PRIORITY {
+    IRQ_PRIORITY_Highest=0,  // the reset value of every IRQ
+    IRQ_PRIORITY_High=1,
+    IRQ_PRIORITY_Low=2,
+    IRQ_PRIORITY_Lowest=3
+};
+
 #endif
@@ -0,0 +1,227 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_POOL_H
+#define YAKIO_POOL_H
+
+// this is part of the compiler, not a library. It only provides "placement new"
+// which is an inline function that does nothing but hand back the address it was given
+#include <new>
+
+#include "YakIO.h"
+#include "YakIO_Utils.h"
+
+// A note on MEMORY POOLS.
+//
+// YakIO has no heap. The linker script throws away the C library (which is where malloc() lives)
+// and there is no "new". That is deliberate - a general purpose heap can take an unpredictable 
+// time to find a free block and, after a while, can fragment so badly that an allocation fails 
+// even though there is plenty of memory free. Neither is acceptable in a small real time system.
+//
+// Sometimes, though, you do need to create objects while the program is running - a message 
+// from an interrupt handler to the MainLoop(), a buffer for a packet. A memory pool is the 
+// usual answer. It is a fixed number of blocks, all the same size, set aside when the program is
+// compiled. The free blocks are kept in a linked list (the "free list") using the first word of
+// each free block as the link, so the list costs no extra RAM. Allocating takes the first block
+// off the list, freeing puts it back on the front. Both take the same small time however full 
+// the pool is and, since every block is the same size, a pool can never fragment. 
+//
+// Allocate() and Free() disable interrupts for the few instructions it takes to update the 
+// list, so they can be used from interrupt handlers and the MainLoop() at the same time.
+//
+// There are three classes in here:
+//
+//   YakIO_BLOCKPOOL - the pool itself. It manages blocks in memory that someone else provides.
+//
+//   YakIO_POOL<T, N> - a pool of N blocks, each big enough for a T, with the memory built in.
+//       Create() allocates a block and runs the constructor of T in it (using "placement new").
+//       Destroy() runs the destructor and frees the block.
+//
+//   YakIO_POOLSET - a set of pools of different block sizes (the "size classes") which the
+//       global new and delete operators use. Once a YakIO_POOLSET object exists you can use 
+//       "new" and "delete" on anything that fits in the largest size class. new picks the 
+//       smallest class big enough and, if that class is empty, the next one up. There can 
+//       be only one YakIO_POOLSET. If there is none, or it has run out, new spins forever - 
+//       size your pools using the high water marks and do not let that happen. 
+//
+// Every pool records its "high water mark" - the most blocks it has ever had in use at once. 
+// Run your program for a while, look at the high water marks and you will know how many blocks
+// each pool really needs.
+//
+// Since YakIO_POOL is a template its code has to live here in the header file. The compiler 
+// needs to see all of it in order to generate a version for each type you use it with. This is 
+// the only reason it is not in a .cpp file like the other YakIO classes. YakIO_BLOCKPOOL and 
+// YakIO_POOLSET are ordinary classes and live in YakIO_POOL.cpp.
+//
+// Example:
+//      in the Main class:     YakIO_POOL<MyMessage, 4> messagePool {};
+//      in an interrupt:       MyMessage *msgPtr = messagePool.Create(someValue);
+//                             if(msgPtr!=NULL) ... send it somewhere
+//      in the MainLoop():     messagePool.Destroy(msgPtr);
+//
+// See the 13_MemoryPools example.
+
+// the size classes used by YakIO_POOLSET and hence by new and delete. The block 
+// sizes are in bytes, must be multiples of 4 and must be in increasing order
+#define POOL_NUM_SIZE_CLASSES 4
+#define POOL_SIZE_CLASS0_BYTES 8
+#define POOL_SIZE_CLASS0_BLOCKS 8
+#define POOL_SIZE_CLASS1_BYTES 16
+#define POOL_SIZE_CLASS1_BLOCKS 8
+#define POOL_SIZE_CLASS2_BYTES 32
+#define POOL_SIZE_CLASS2_BLOCKS 8
+#define POOL_SIZE_CLASS3_BYTES 64
+#define POOL_SIZE_CLASS3_BLOCKS 4
+
+/* YakIO_BLOCKPOOL - a class to allocate and free fixed size blocks from a 
+ *     piece of memory in a fixed time. 
+ * */
+class YakIO_BLOCKPOOL
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned char *storageStart = NULL;
+      unsigned char *storageEnd = NULL;
+      unsigned int blockBytes =0;
+      unsigned int numBlocks =0;
+      // the first free block. Its first word points to the next
+      void *freeListHead = NULL;
+      unsigned int usedCount =0;
+      unsigned int highWaterCount =0;
+      unsigned int failedCount =0;
+
+  public:
+      void Init(void *storagePtr, unsigned int blockBytesIn, unsigned int numBlocksIn);
+      void *Allocate(void);
+      unsigned int Free(void *blockPtr);
+      unsigned int Owns(void *blockPtr);
+      unsigned int GetBlockBytes(void);
+      unsigned int GetNumBlocks(void);
+      unsigned int GetUsedCount(void);
+      unsigned int GetHighWaterCount(void);
+      unsigned int GetFailedCount(void);
+
+};
+
+/* YakIO_POOL - a pool of N blocks each able to hold a T
+ * */
+template <typename T, unsigned int N>
+class YakIO_POOL
+{
+  private:
+      // each block must hold a T and, while it is free, a pointer. It must 
+      // also keep the alignment of a T
+      static constexpr unsigned int blockAlign = (alignof(T)>4) ? alignof(T) : 4;
+      static constexpr unsigned int blockBytes = ((sizeof(T)+blockAlign-1)/blockAlign)*blockAlign;
+      alignas(blockAlign) unsigned char storage[blockBytes*N];
+      YakIO_BLOCKPOOL blockPool {};
+
+  public:
+
+    /* constructor
+     *
+     * */
+    YakIO_POOL()
+    {
+        blockPool.Init(storage, blockBytes, N);
+    }
+
+    /* Allocate - gets a block. The constructor of T is NOT run, use Create()
+     *    for that. Safe to call from an interrupt handler.
+     *
+     * returns:
+     *    the block or NULL if the pool is empty
+     * */
+    T *Allocate(void)
+    {
+        return (T *)blockPool.Allocate();
+    }
+
+    /* Free - gives back a block. The destructor of T is NOT run, use 
+     *    Destroy() for that. Safe to call from an interrupt handler.
+     *
+     * inputs:
+     *    blockPtr - the block. NULL is ignored
+     * */
+    void Free(T *blockPtr)
+    {
+        blockPool.Free(blockPtr);
+    }
+
+    /* Create - gets a block and runs the constructor of T in it. Safe to
+     *    call from an interrupt handler (as long as the constructor is).
+     *
+     * inputs:
+     *    constructorArgs - whatever the constructor of T wants
+     *
+     * returns:
+     *    the new T or NULL if the pool is empty
+     * */
+    template <typename... ARGS>
+    T *Create(ARGS... constructorArgs)
+    {
+        void *blockPtr = blockPool.Allocate();
+        if(blockPtr==NULL) return NULL;
+        // "placement new". This runs the constructor in the memory we give it
+        return new (blockPtr) T(constructorArgs...);
+    }
+
+    /* Destroy - runs the destructor of a T and gives its block back
+     *
+     * inputs:
+     *    objectPtr - the object. NULL is ignored
+     * */
+    void Destroy(T *objectPtr)
+    {
+        if(objectPtr==NULL) return;
+        objectPtr->~T();
+        blockPool.Free(objectPtr);
+    }
+
+    unsigned int GetUsedCount(void) { return blockPool.GetUsedCount(); }
+    unsigned int GetHighWaterCount(void) { return blockPool.GetHighWaterCount(); }
+    unsigned int GetFailedCount(void) { return blockPool.GetFailedCount(); }
+
+};
+
+/* YakIO_POOLSET - a set of pools in increasing block sizes used by the 
+ *     global new and delete operators
+ * */
+class YakIO_POOLSET
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_BLOCKPOOL sizeClassPools[POOL_NUM_SIZE_CLASSES];
+      // the memory. unsigned int makes sure it is word aligned
+      unsigned int class0Storage[(POOL_SIZE_CLASS0_BYTES/4)*POOL_SIZE_CLASS0_BLOCKS];
+      unsigned int class1Storage[(POOL_SIZE_CLASS1_BYTES/4)*POOL_SIZE_CLASS1_BLOCKS];
+      unsigned int class2Storage[(POOL_SIZE_CLASS2_BYTES/4)*POOL_SIZE_CLASS2_BLOCKS];
+      unsigned int class3Storage[(POOL_SIZE_CLASS3_BYTES/4)*POOL_SIZE_CLASS3_BLOCKS];
+
+  public:
+      // Constructor to initialize YakIO_POOLSET object
+      YakIO_POOLSET();
+      void *Allocate(unsigned int bytesNeeded);
+      unsigned int Free(void *blockPtr);
+      YakIO_BLOCKPOOL *GetSizeClassPool(unsigned int sizeClass);
+
+};
+
+// the pool set used by new and delete. There can be only one. This is set
+// in the YakIO_POOLSET constructor
+extern YakIO_POOLSET *poolSet_ptr;
+
+#endif
@@ -0,0 +1,87 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_PPI_H
+#define YAKIO_PPI_H
+
+#include "YakIO.h"
+
+// PPI REGISTER SPECIFIC SECTION
+#define PPIREG_OFFSET_CHEN          0x500 // Channel enable
+#define PPIREG_OFFSET_CHENSET       0x504 // Channel enable set
+#define PPIREG_OFFSET_CHENCLR       0x508 // Channel enable clear
+#define PPIREG_OFFSET_CH_EEP_BASE   0x510 // Channel n event end-point, CH[n].EEP is at 0x510+(n*8)
+#define PPIREG_OFFSET_CH_TEP_BASE   0x514 // Channel n task end-point, CH[n].TEP is at 0x514+(n*8)
+#define PPIREG_CH_STRIDE            8
+#define PPIREG_OFFSET_CHG_BASE      0x800 // Channel group n, CHG[n] is at 0x800+(n*4)
+
+// the channels we can set up ourselves are 0 to 15. The rest have their 
+// event and task fixed in the hardware, we can only enable them
+#define PPI_PROGRAMMABLE_CHANNELS   16
+#define PPI_NUM_CHANNELS            32
+
+// the pre-programmed channels. See the PPI chapter in the nrf51 reference manual
+#define PPI_CH_TIMER0_COMPARE0_RADIO_TXEN     20
+#define PPI_CH_TIMER0_COMPARE0_RADIO_RXEN     21
+#define PPI_CH_TIMER0_COMPARE1_RADIO_DISABLE  22
+#define PPI_CH_RADIO_BCMATCH_AAR_START        23
+#define PPI_CH_RADIO_READY_CCM_KSGEN          24
+#define PPI_CH_RADIO_ADDRESS_CCM_CRYPT        25
+#define PPI_CH_RADIO_ADDRESS_TIMER0_CAPTURE1  26
+#define PPI_CH_RADIO_END_TIMER0_CAPTURE2      27
+#define PPI_CH_RTC0_COMPARE0_RADIO_TXEN       28
+#define PPI_CH_RTC0_COMPARE0_RADIO_RXEN       29
+#define PPI_CH_RTC0_COMPARE0_TIMER0_CLEAR     30
+#define PPI_CH_RTC0_COMPARE0_TIMER0_START     31
+
+// A note on the PPI. The PPI (Programmable Peripheral Interconnect) wires an event in one
+// peripheral straight to a task in another. When the event happens the task is started by 
+// the hardware, a cycle or so later, without the CPU doing anything - not even taking an 
+// interrupt. A TIMER COMPARE event can start the RADIO at exactly the right moment, the 
+// RADIO ADDRESS event can capture a TIMER count with no interrupt jitter at all, and so on.
+//
+// Each channel is just the address of an event register (EEP) and the address of a task 
+// register (TEP). Channels 0 to 15 can be set to anything with ConnectChannel(). Channels
+// 20 to 31 are already wired to the commonly used pairs (see the PPI_CH_ defines above) 
+// and just need enabling.
+//
+// Nothing keeps track of who is using which channel. The PPI is just a bank of registers 
+// so any number of YakIO_PPI objects can be made, one in each class that needs it, but you
+// must make sure no two of them use the same channel number. 
+//
+// Example:
+//      in the Main class:     YakIO_PPI ppiObj {};
+//      in MainLoop():         ppiObj.ConnectChannel(0, REGISTER_TIMER1+TIMERREG_OFFSET_COMPARE_0, REGISTER_TIMER2+TIMERREG_OFFSET_CAPTURE_0);
+//                             ppiObj.EnableChannel(0);
+
+/* YakIO_PPI - a class to represent and encapsulate the programmable
+ *     peripheral interconnect
+ * */
+class YakIO_PPI
+{
+  private:
+      unsigned int isInitialized =0;
+
+  public:
+      // Constructor to initialize YakIO_PPI object
+      YakIO_PPI();
+      unsigned int ConnectChannel(unsigned int channelNum, unsigned int eventAddress, unsigned int taskAddress);
+      void EnableChannel(unsigned int channelNum);
+      void DisableChannel(unsigned int channelNum);
+      unsigned int IsChannelEnabled(unsigned int channelNum);
+};
+
+#endif
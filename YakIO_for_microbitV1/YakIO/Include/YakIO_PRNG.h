@@ -0,0 +1,109 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_PRNG_H
+#define YAKIO_PRNG_H
+
+#include "YakIO.h"
+#include "YakIO_RNG.h"
+
+// A note on the PRNG. The RNG peripheral makes truly random numbers but only one byte 
+// about every 100 microseconds. Simulations, dithering, shuffling and randomized 
+// scheduling want millions of numbers that only have to LOOK random. YakIO_PRNG is a 
+// pseudo random number generator - a bit of arithmetic that makes a new 32 bit number 
+// from the last one in a few tens of cycles. There are three to choose from:
+//
+//    PRNG_XORSHIFT32  - the quickest. 32 bits of state so it repeats after 2^32-1 values
+//    PRNG_XORSHIFT128 - nearly as quick with 128 bits of state, repeats after 2^128-1
+//    PRNG_PCG32       - the best quality, it passes all the usual statistical tests. It 
+//                       needs a 64 bit multiply which the Cortex-M0 does not have so it 
+//                       is the slowest. The library function __aeabi_lmul does it for us
+//
+// The 16_BenchmarkSuite example measures them all next to YakIO_RNG::GetRngValue().
+//
+// The numbers are only as unpredictable as the seed. SeedFromRng() takes the seed from 
+// the RNG peripheral. SetReseedRng() mixes a fresh 32 bit value from the RNG pool (see
+// the note on the RNG POOL in YakIO_RNG.h) into the state every so often. That never 
+// waits - if the pool is empty we try again a little later. None of this makes them 
+// suitable for keys or anything else that has to stay secret.
+//
+// GetRange() gives a value in a range with no bias and no divide. The usual 
+// "value % rangeSize" needs a divide (slow on the Cortex-M0) and makes small values a 
+// little more likely than big ones. Instead we keep only as many bits as the range needs
+// and, if the value is still too big, throw it away and take another. Less than half 
+// are ever thrown away so on average it takes less than two goes.
+//
+// Example:
+//      in the Main class:     YakIO_PRNG prngObj {PRNG_XORSHIFT128};
+//      in MainLoop():         prngObj.SeedFromRng(rngObj);
+//      anywhere:              unsigned int diceRoll = prngObj.GetBetween(1, 6);
+
+// the generator types. 
+enum PRNG_TYPE {
+    PRNG_XORSHIFT32=0,     // 32 bit Marsaglia xorshift
+    PRNG_XORSHIFT128=1,    // 128 bit Marsaglia xorshift
+    PRNG_PCG32=2,          // O'Neill PCG XSH RR 64/32
+};
+
+#define PRNG_XORSHIFT128_WORDS  4
+// the number of 32 bit words of seed every generator is given. Enough for the biggest
+#define PRNG_SEED_WORDS         4
+// if the RNG pool is empty when it is time to reseed we try again after this many values
+#define PRNG_RESEED_RETRY       64
+// the PCG32 constants. See https://www.pcg-random.org
+#define PRNG_PCG32_MULTIPLIER   6364136223846793005ULL
+#define PRNG_PCG32_DEFAULT_STATE     0x853c49e6748fea9bULL
+#define PRNG_PCG32_DEFAULT_INCREMENT 0xda3e39cb94b95bdbULL
+#define PRNG_XORSHIFT32_DEFAULT_STATE 2463534242u
+
+/* YakIO_PRNG - a class to provide fast pseudo random numbers
+ * */
+class YakIO_PRNG
+{
+  private:
+      unsigned int isInitialized =0;
+      enum PRNG_TYPE prngType = PRNG_XORSHIFT32;
+      unsigned int xorshift32State =0;
+      unsigned int xorshift128State[PRNG_XORSHIFT128_WORDS];
+      unsigned long long pcg32State =0;
+      unsigned long long pcg32Increment =0;
+      YakIO_RNG *reseedRngPtr =NULL;
+      unsigned int reseedInterval =0;
+      unsigned int valuesUntilReseed =0;
+      unsigned int reseedCount =0;
+      unsigned int NextXorshift32(void);
+      unsigned int NextXorshift128(void);
+      unsigned int NextPCG32(void);
+      void LoadSeedWords(unsigned int *seedWords);
+      void MixIntoState(unsigned int mixValue);
+      void Reseed(void);
+
+  public:
+      // Constructor to initialize YakIO_PRNG object
+      YakIO_PRNG(enum PRNG_TYPE prngTypeIn);
+      void SetSeed(unsigned int seedValue);
+      void SetSeedWords(unsigned int *seedWords);
+      void SeedFromRng(YakIO_RNG &rngObj);
+      void SetReseedRng(YakIO_RNG *rngPtrIn, unsigned int reseedIntervalIn);
+      unsigned int GetReseedCount(void);
+      unsigned int GetNext(void);
+      unsigned int GetRange(unsigned int rangeSize);
+      unsigned int GetBetween(unsigned int lowValue, unsigned int highValue);
+      void Fill(unsigned char *outBuffer, unsigned int byteCount);
+      enum PRNG_TYPE GetType(void);
+};
+
+#endif
@@ -0,0 +1,114 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_PROFILER_H
+#define YAKIO_PROFILER_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_UART.h"
+#include "YakIO_Utils.h"
+
+// A note on the PROFILER. YakIO_PROFILER is a "sampling" profiler. It uses one of the 
+// YakIO_TIMERs to interrupt the program every so often and looks at the address of the 
+// instruction it interrupted (see YakIO_TIMER::GetInterruptedPC()). After a few thousand 
+// samples the addresses it saw most often are where the program spends its time. Nothing
+// in the program being profiled has to change.
+//
+// Keeping every address would need far too much RAM so the code section (from 
+// __topOfCodeSection__ to __bottomOfCodeSection__, see microbit.ld) is split into 
+// PROFILER_NUM_BUCKETS equal sized "buckets" and we just count the samples in each. The 
+// bucket size is the smallest power of two that covers the whole code section so finding
+// the bucket is a subtract and a shift - the Cortex-M0 has no divide. A 16K program gets
+// 32 byte buckets. That is plenty to tell one function from another.
+//
+// Dump() prints the counts on the serial port. The ProfileReport.py script in the
+// directory above YakIO turns them back into function names using the Main.elf file. The
+// counts can also be read with GetBucketCount() or just looked at with a debugger.
+//
+// Some things to be aware of:
+//
+//   1) An interrupt can only interrupt a handler of a lower priority. Every IRQ starts off
+//      at the highest priority (see the PRIORITIES note in YakIO_NVIC.h) so, unless you 
+//      do something about it, the profiler never sees inside another interrupt handler - 
+//      that time shows up at the instruction after the handler returns. Use 
+//      SetIRQPriority() to move your other interrupts down to IRQ_PRIORITY_High or lower.
+//   2) For the same reason time spent with the interrupts disabled (EnterCritical()) 
+//      appears at the instruction after ExitCritical().
+//   3) Pick a sample interval that is not a multiple of any other timer in your program.
+//      If both tick every millisecond the profiler always samples at the same point of 
+//      the other one and sees a very strange picture. The example uses 997 microseconds.
+//   4) Each sample costs a few microseconds. At the default of about 1000 samples a second
+//      that is well under 1% of the CPU.
+//   5) If any bucket reaches PROFILER_MAX_BUCKET_COUNT the profiler stops itself rather 
+//      than lose counts. At 1000 samples a second that is over a minute in ONE bucket.
+//
+// Example:
+//      in the Main class:     YakIO_PROFILER profiler {Timer1};
+//                             YakIO_UART uart {};
+//      in MainLoop():         profiler.Start(997);
+//      later:                 profiler.Stop();
+//                             profiler.Dump(uart);
+
+// the number of buckets. Each one is an unsigned short so the histogram uses twice this
+// many bytes of RAM. Define it before this file is included to change it
+#ifndef PROFILER_NUM_BUCKETS
+#define PROFILER_NUM_BUCKETS           512
+#endif
+#define PROFILER_MIN_BUCKET_SHIFT      1        // Thumb instructions are 2 bytes, a smaller bucket is pointless
+#define PROFILER_MAX_BUCKET_COUNT      0xFFFF   // the most an unsigned short bucket can hold
+#define PROFILER_TIMER_PRESCALER       4        // 16MHz/(2^4) = 1MHz, the timer counts in microseconds
+#define PROFILER_DEFAULT_INTERVAL_US   997      // a prime, see note 3) above
+
+/* YakIO_PROFILER - a class to sample the interrupted PC from a timer 
+ *     interrupt and build a histogram of where the time goes
+ * */
+class YakIO_PROFILER : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_TIMER sampleTimerObj;
+      enum TIMER sampleTimerID;
+      unsigned int codeStartAddress =0;
+      unsigned int codeEndAddress =0;
+      unsigned int bucketShift =PROFILER_MIN_BUCKET_SHIFT;
+      unsigned int sampleCount =0;
+      unsigned int outsideCount =0;
+      unsigned int isRunning =0;
+      unsigned int isFull =0;
+      unsigned short bucketCounts[PROFILER_NUM_BUCKETS];
+
+  public:
+      // Constructor to initialize YakIO_PROFILER object
+      YakIO_PROFILER(enum TIMER sampleTimerIDIn);
+      void Start(unsigned int sampleIntervalUs);
+      void Stop(void);
+      void Clear(void);
+      unsigned int IsRunning(void);
+      unsigned int IsFull(void);
+      unsigned int GetSampleCount(void);
+      unsigned int GetOutsideCount(void);
+      unsigned int GetCodeStartAddress(void);
+      unsigned int GetBucketShift(void);
+      unsigned int GetBucketCount(unsigned int bucketIndex);
+      void Dump(YakIO_UART &uart);
+      // the sample timer tick. Do not call this
+      void Callback0(void) override;
+
+};
+
+#endif
@@ -0,0 +1,313 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_RADIO_H
+#define YAKIO_RADIO_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+
+// RADIO REGISTER SPECIFIC SECTION
+// Tasks
+#define RADIOREG_OFFSET_TXEN         0x000 // Enable radio in TX mode
+#define RADIOREG_OFFSET_RXEN         0x004 // Enable radio in RX mode
+#define RADIOREG_OFFSET_START        0x008 // Start radio
+#define RADIOREG_OFFSET_STOP         0x00C // Stop radio
+#define RADIOREG_OFFSET_DISABLE      0x010 // Disable radio
+#define RADIOREG_OFFSET_RSSISTART    0x014 // Start the RSSI and take one single sample of the receive signal strength
+#define RADIOREG_OFFSET_RSSISTOP     0x018 // Stop the RSSI measurement
+#define RADIOREG_OFFSET_BCSTART      0x01C // Start the bit counter
+#define RADIOREG_OFFSET_BCSTOP       0x020 // Stop the bit counter
+// Events
+#define RADIOREG_OFFSET_READY        0x100 // Radio has ramped up and is ready to be started
+#define RADIOREG_OFFSET_ADDRESS      0x104 // Address sent or received
+#define RADIOREG_OFFSET_PAYLOAD      0x108 // Packet payload sent or received
+#define RADIOREG_OFFSET_END          0x10C // Packet sent or received
+#define RADIOREG_OFFSET_DISABLED     0x110 // Radio has been disabled
+#define RADIOREG_OFFSET_DEVMATCH     0x114 // A device address match occurred on the last received packet
+#define RADIOREG_OFFSET_DEVMISS      0x118 // No device address match occurred on the last received packet
+#define RADIOREG_OFFSET_RSSIEND      0x11C // Sampling of receive signal strength complete
+#define RADIOREG_OFFSET_BCMATCH      0x128 // Bit counter reached bit count value
+// Registers
+#define RADIOREG_OFFSET_SHORTS       0x200 // Shortcut register
+#define RADIOREG_OFFSET_INTENSET     0x304 // Enable interrupt
+#define RADIOREG_OFFSET_INTENCLR     0x308 // Disable interrupt
+#define RADIOREG_OFFSET_CRCSTATUS    0x400 // CRC status
+#define RADIOREG_OFFSET_RXMATCH      0x408 // Received address
+#define RADIOREG_OFFSET_RXCRC        0x40C // CRC field of previously received packet
+#define RADIOREG_OFFSET_DAI          0x410 // Device address match index
+#define RADIOREG_OFFSET_PACKETPTR    0x504 // Packet pointer
+#define RADIOREG_OFFSET_FREQUENCY    0x508 // Frequency
+#define RADIOREG_OFFSET_TXPOWER      0x50C // Output power
+#define RADIOREG_OFFSET_MODE         0x510 // Data rate and modulation
+#define RADIOREG_OFFSET_PCNF0        0x514 // Packet configuration register 0
+#define RADIOREG_OFFSET_PCNF1        0x518 // Packet configuration register 1
+#define RADIOREG_OFFSET_BASE0        0x51C // Base address 0
+#define RADIOREG_OFFSET_BASE1        0x520 // Base address 1
+#define RADIOREG_OFFSET_PREFIX0      0x524 // Prefixes bytes for logical addresses 0-3
+#define RADIOREG_OFFSET_PREFIX1      0x528 // Prefixes bytes for logical addresses 4-7
+#define RADIOREG_OFFSET_TXADDRESS    0x52C // Transmit address select
+#define RADIOREG_OFFSET_RXADDRESSES  0x530 // Receive address select
+#define RADIOREG_OFFSET_CRCCNF       0x534 // CRC configuration
+#define RADIOREG_OFFSET_CRCPOLY      0x538 // CRC polynomial
+#define RADIOREG_OFFSET_CRCINIT      0x53C // CRC initial value
+#define RADIOREG_OFFSET_TIFS         0x544 // Inter Frame Spacing in us
+#define RADIOREG_OFFSET_RSSISAMPLE   0x548 // RSSI sample
+#define RADIOREG_OFFSET_STATE        0x550 // Current radio state
+#define RADIOREG_OFFSET_DATAWHITEIV  0x554 // Data whitening initial value
+#define RADIOREG_OFFSET_BCC          0x560 // Bit counter compare
+#define RADIOREG_OFFSET_POWER        0xFFC // Peripheral power control
+
+// the SHORTS bits
+#define RADIO_SHORT_READY_START       0x0001
+#define RADIO_SHORT_END_DISABLE       0x0002
+#define RADIO_SHORT_DISABLED_TXEN     0x0004
+#define RADIO_SHORT_DISABLED_RXEN     0x0008
+#define RADIO_SHORT_ADDRESS_RSSISTART 0x0010
+#define RADIO_SHORT_END_START         0x0020
+#define RADIO_SHORT_ADDRESS_BCSTART   0x0040
+#define RADIO_SHORT_DISABLED_RSSISTOP 0x0100
+
+// the INTENSET/INTENCLR bits. Bit n is the event at RADIOREG_OFFSET_READY+(n*4)
+#define RADIO_INTEN_READY_BIT         0x0001
+#define RADIO_INTEN_ADDRESS_BIT       0x0002
+#define RADIO_INTEN_PAYLOAD_BIT       0x0004
+#define RADIO_INTEN_END_BIT           0x0008
+#define RADIO_INTEN_DISABLED_BIT      0x0010
+#define RADIO_INTEN_DEVMATCH_BIT      0x0020
+#define RADIO_INTEN_DEVMISS_BIT       0x0040
+#define RADIO_INTEN_RSSIEND_BIT       0x0080
+#define RADIO_INTEN_BCMATCH_BIT       0x0400
+#define RADIO_INTEN_ALL_BITS          0x04FF
+
+// the STATE register values
+#define RADIO_HWSTATE_DISABLED        0
+#define RADIO_HWSTATE_RXRU            1
+#define RADIO_HWSTATE_RXIDLE          2
+#define RADIO_HWSTATE_RX              3
+#define RADIO_HWSTATE_RXDISABLE       4
+#define RADIO_HWSTATE_TXRU            9
+#define RADIO_HWSTATE_TXIDLE          10
+#define RADIO_HWSTATE_TX              11
+#define RADIO_HWSTATE_TXDISABLE       12
+
+// the packet configuration. See the note below
+#define RADIO_PCNF0_LFLEN_8BITS       0x00000008 // an 8 bit LENGTH field, no S0 or S1
+#define RADIO_PCNF1_STATLEN_SHIFT     8
+#define RADIO_PCNF1_BALEN_SHIFT       16
+#define RADIO_PCNF1_ENDIAN_BIG        0x01000000
+#define RADIO_PCNF1_WHITEEN           0x02000000
+#define RADIO_BASE_ADDRESS_BYTES      4          // BALEN, the address is this plus the prefix byte
+#define RADIO_CRCCNF_SKIPADDR         0x00000100
+#define RADIO_POWER_ON                1
+#define RADIO_MAX_FREQUENCY           100        // 2400MHz to 2500MHz in 1MHz steps
+#define RADIO_RX_BUFFERS              2          // the ping and the pong
+#define RADIO_RX_DISCARD              RADIO_RX_BUFFERS // the receive buffer index for "nowhere to put it"
+
+// the defaults Start() sets. These are what the micro:bit runtime uses so
+// the packets are at least the same shape as the ones other micro:bits send
+#define RADIO_DEFAULT_FREQUENCY       7
+#define RADIO_DEFAULT_BASE_ADDRESS    0x75626974 // "ubit"
+#define RADIO_DEFAULT_PREFIX          0
+#define RADIO_DEFAULT_CRC_POLY        0x00011021 // CRC-16-CCITT
+#define RADIO_DEFAULT_CRC_INIT        0x0000FFFF
+#define RADIO_DEFAULT_WHITE_IV        0x18
+
+// the most payload bytes a packet can have. The LENGTH field can say up 
+// to 255 but every receive buffer is this big, times RADIO_RX_BUFFERS+1. 
+// Define it before this file is included to change it
+#ifndef RADIO_MAX_PAYLOAD_BYTES
+#define RADIO_MAX_PAYLOAD_BYTES       32
+#endif
+
+// the data rates. These values are carefully set to the value we have to 
+// stuff in the MODE register
+enum RADIO_MODE {
+    RADIO_MODE_1MBIT=0,        // Nordic proprietary 1Mbit/s
+    RADIO_MODE_2MBIT=1,        // Nordic proprietary 2Mbit/s
+};
+
+// the transmit power. These values are carefully set to the value we 
+// have to stuff in the TXPOWER register
+enum RADIO_TXPOWER {
+    RADIO_TXPOWER_POS4DBM=0x04,
+    RADIO_TXPOWER_0DBM=0x00,
+    RADIO_TXPOWER_NEG4DBM=0xFC,
+    RADIO_TXPOWER_NEG8DBM=0xF8,
+    RADIO_TXPOWER_NEG12DBM=0xF4,
+    RADIO_TXPOWER_NEG16DBM=0xF0,
+    RADIO_TXPOWER_NEG20DBM=0xEC,
+    RADIO_TXPOWER_NEG30DBM=0xD8,
+};
+
+// the CRC length. These values are carefully set to the value we have to
+// stuff in the LEN field of the CRCCNF register
+enum RADIO_CRC {
+    RADIO_CRC_OFF=0,
+    RADIO_CRC_8BIT=1,
+    RADIO_CRC_16BIT=2,
+    RADIO_CRC_24BIT=3,
+};
+
+// what the driver is doing. Not the same thing as the STATE register
+enum RADIO_STATE {
+    RADIO_STATE_STOPPED=0,     // not started, or Stop() was called
+    RADIO_STATE_IDLE=1,        // started but neither sending nor listening
+    RADIO_STATE_RX=2,          // listening
+    RADIO_STATE_TX=3,          // sending a packet
+};
+
+// A note on the RADIO. The 2.4GHz radio is why most people put two micro:bits side by side.
+// This class does the Nordic proprietary 1Mbit and 2Mbit modes (not Bluetooth) with the 
+// simplest packet the RADIO can do:
+//
+//    preamble (1 byte) | address (5 bytes) | LENGTH (1 byte) | payload | CRC (2 bytes)
+//
+// In RAM a packet is just the LENGTH byte followed by the payload - struct YakIO_RADIOPACKET
+// below. The RADIO reads and writes it there itself (EasyDMA) through the PACKETPTR 
+// register so the CPU never touches a byte of it while it is on the air. The RADIO needs
+// the 16MHz crystal, which the startup code in YakIO.cpp has already started.
+//
+// Start() powers it up with the same frequency, address, CRC and whitening the micro:bit 
+// runtime uses. Change any of them with the Set functions - but only while the RADIO is 
+// idle, the nrf51 reference manual says the registers must not be changed while it is
+// sending or listening.
+//
+// Sending. Transmit() copies the payload and starts the RADIO. It does not wait. The 
+// READY_START and END_DISABLE shortcuts take it from ramped up to sending to switched off
+// with no help from the CPU and the DISABLED interrupt tells us it is done. Calling 
+// Transmit() while listening stops the listening (a packet half received is lost) and
+// the listening starts again by itself when the packet has gone.
+//
+// Listening. StartReceive() keeps the RADIO listening until StopReceive(). There are two
+// receive buffers, used in turn. While a packet is arriving in one the program can be
+// looking at the one before it in the other - GetReceivedPacket() gives a pointer to it 
+// in place, ReleasePacket() hands it back. When a packet ENDs the interrupt points 
+// PACKETPTR at whichever buffer is free and STARTs the RADIO again at once. It stays 
+// ramped up (RXIDLE) so that takes a few microseconds, not the 130 a ramp up would take.
+// If the program is still holding the other buffer there is nowhere to put the next
+// packet and it goes into a scrap buffer and is counted as dropped - see 
+// GetDroppedPacketCount(). So a program which releases each packet before the next one
+// has finished arriving never loses one. Packets with a bad CRC are counted and thrown 
+// away, the program never sees them.
+//
+// The callback, if set, is called from the interrupt when a good packet has arrived and
+// when a Transmit() has finished.
+//
+// Timestamps. If something has wired the ADDRESS event to a TIMER CAPTURE task through the
+// PPI (YakIO_TIMESYNC does) then the captured count is the exact moment the address went 
+// past, with no interrupt latency in it. Tell SetTimestampRegister() which CC[n] register
+// that is and it is read at the END of every packet, before the next one can overwrite it,
+// and kept with the packet. See GetPacketTimestamp() and GetTxTimestamp().
+//
+// Starting from the PPI. After SetExternalStart(1) Transmit() and StartReceive() get 
+// everything ready - PACKETPTR, the shortcuts, the interrupts - but do not start the TXEN
+// or RXEN task. Something wired through the PPI does that, a TIMER COMPARE event usually,
+// so the RADIO starts at exactly the right microsecond (YakIO_TDMA does this). If the PPI 
+// DISABLEs the RADIO while it is listening the listening simply stops, as if StopReceive() 
+// had been called. Cancel() forgets a Transmit() or StartReceive() the PPI never started.
+//
+// Example:
+//      in the Main class:     YakIO_RADIO radioObj {};
+//      in MainLoop():         radioObj.Start();
+//                             radioObj.SetFrequency(42);
+//                             radioObj.StartReceive();
+//                             radioObj.Transmit(helloBytes, 5);
+//      in the loop:           struct YakIO_RADIOPACKET *packetPtr = radioObj.GetReceivedPacket();
+//                             if(packetPtr!=NULL)
+//                             {
+//                                 ... packetPtr->lengthByte bytes in packetPtr->payloadBytes
+//                                 radioObj.ReleasePacket();
+//                             }
+
+/* YakIO_RADIOPACKET - a packet as the RADIO reads and writes it in RAM
+ * */
+struct YakIO_RADIOPACKET
+{
+    unsigned char lengthByte;
+    unsigned char payloadBytes[RADIO_MAX_PAYLOAD_BYTES];
+} __attribute__((aligned(4)));
+
+/* YakIO_RADIO - a class to represent and encapsulate the 2.4GHz radio
+ * */
+class YakIO_RADIO
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_CALLBACK *callbackInterfacePtr =NULL;
+      enum CALLBACK_ID callbackID = CALLBACK_NONE;
+      // the RADIO interrupt changes radioState, isListening, the buffer 
+      // flags and the buffer indexes while the code outside it polls them
+      // (IsTransmitting(), GetReceivedPacket()), so they must be volatile
+      volatile enum RADIO_STATE radioState = RADIO_STATE_STOPPED;
+      volatile unsigned int isListening =0;
+      unsigned int externalStart =0;
+      struct YakIO_RADIOPACKET txPacket;
+      struct YakIO_RADIOPACKET rxPackets[RADIO_RX_BUFFERS+1]; // the last one is the scrap buffer
+      volatile unsigned int rxBufferIsFull[RADIO_RX_BUFFERS];
+      unsigned int rxRssi[RADIO_RX_BUFFERS];
+      volatile unsigned int rxReceiveIndex =0;
+      volatile unsigned int rxReadIndex =0;
+      // the counts and the timestamps are written by the RADIO interrupt 
+      // too. YakIO_TIMESYNC polls GetTxPacketCount() and GetTxTimestamp() 
+      // to see if its beacon has gone, so these are volatile as well
+      volatile unsigned int rxPacketCount =0;
+      volatile unsigned int txPacketCount =0;
+      volatile unsigned int crcErrorCount =0;
+      volatile unsigned int droppedPacketCount =0;
+      unsigned int timestampRegister =0;
+      volatile unsigned int rxTimestamp[RADIO_RX_BUFFERS];
+      volatile unsigned int txTimestamp =0;
+      void ClearEvents(void);
+      void StartRx(void);
+      void DisableAndWait(void);
+      unsigned int GetFreeRxBuffer(void);
+      void HandleRxEnd(void);
+
+  public:
+      // Constructor to initialize YakIO_RADIO object
+      YakIO_RADIO();
+      void SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void CallCallback();
+      void ClearAllCallbacks(void);
+      void Start(void);
+      void Stop(void);
+      unsigned int SetMode(enum RADIO_MODE radioMode);
+      unsigned int SetFrequency(unsigned int radioFrequency);
+      unsigned int SetTxPower(enum RADIO_TXPOWER txPower);
+      unsigned int SetAddress(unsigned int baseAddress, unsigned int prefixByte);
+      unsigned int SetCrc(enum RADIO_CRC crcLength, unsigned int crcPoly, unsigned int crcInit);
+      unsigned int StartReceive(void);
+      void StopReceive(void);
+      void SetExternalStart(unsigned int externalStartIn);
+      void Cancel(void);
+      unsigned int Transmit(const unsigned char *payloadBytes, unsigned int payloadLength);
+      unsigned int IsTransmitting(void);
+      enum RADIO_STATE GetState(void);
+      struct YakIO_RADIOPACKET *GetReceivedPacket(void);
+      unsigned int GetPacketRssi(void);
+      void ReleasePacket(void);
+      void SetTimestampRegister(unsigned int registerAddress);
+      unsigned int GetPacketTimestamp(void);
+      unsigned int GetTxTimestamp(void);
+      unsigned int GetRxPacketCount(void);
+      unsigned int GetTxPacketCount(void);
+      unsigned int GetCrcErrorCount(void);
+      unsigned int GetDroppedPacketCount(void);
+      void HandleRadioIRQ(void);
+};
+
+#endif
@@ -43,6 +43,93 @@ enum RNG_DERCEN {
 #define RNG_INTEN_BIT 0x01                  // bit we set/clear
 #define RNG_INTEN_CLR_BIT 0x01                  // bit we set/clear
 
+// A note on the RNG POOL. GetRngValue() waits for the peripheral and a new 8 bit value 
+// only appears about every 100 microseconds. Code in a hurry cannot afford that. In 
+// pool mode the VALRDY interrupt puts every value into a circular buffer in RAM (the 
+// pool) and TryGetBytes() and GetU32() just take them out of there. They never wait. If 
+// there are not enough bytes in the pool they say so and return at once.
+//
+// The RNG uses power while it runs so it is stopped when the pool is full and started
+// again when a reader takes it down to RNG_POOL_REFILL_LEVEL bytes. That gap stops us 
+// starting and stopping it for every byte.
+//
+// While the pool is running the RNG interrupt is used to fill it and any callback set
+// with SetCallback() is NOT called. Do not call GetRngValue() either, it would take 
+// values the pool needs. Set the DERCEN (see SetDerCen()) before calling PoolStart().
+//
+// Example:
+//      in the Main class:     YakIO_RNG rngObj {};
+//      in MainLoop():         rngObj.PoolStart();
+//      anywhere:              unsigned int randomValue;
+//                             if(rngObj.GetU32(&randomValue)!=0) ... use it
+
+// A note on the HEALTH TESTS. A true random number generator can break - a stuck bit, a
+// failing noise source - and still make numbers that look fine at a glance. While the pool
+// runs every raw value from the RNG goes through the two continuous health tests from NIST 
+// SP 800-90B (section 4.4) before anything else is done with it:
+//
+//    Repetition Count Test - fails if the same value comes RNG_HEALTH_RCT_CUTOFF times
+//                            in a row
+//    Adaptive Proportion   - takes the first value of each window of RNG_HEALTH_APT_WINDOW 
+//    Test                    values and fails if it comes up RNG_HEALTH_APT_CUTOFF or more
+//                            times in that window
+//
+// The cutoffs are the SP 800-90B ones for a false alarm rate of 1 in 2^20 and a claimed
+// min-entropy of 2 bits in every 8 bit value. That is a very cautious claim - see 
+// 19_RngHealth for how to check what your RNG really does. 
+//
+// A failure is counted (see GetHealthFailureCount()) and latched. From then on NOTHING 
+// goes into the pool, and the RNG is stopped, until ClearHealthFailures() is called. The
+// readers just find the pool empty - better that than they get numbers which are not 
+// random.
+//
+// A note on CONDITIONING. The raw values can have a bias (more 1s than 0s). The DERCEN 
+// (see SetDerCen()) corrects that in the hardware but makes the RNG slower. Instead, or 
+// as well, the values can be conditioned in software before they go in the pool:
+//
+//    RNG_CONDITIONING_NONE       - the raw values go straight in
+//    RNG_CONDITIONING_VONNEUMANN - each pair of bits is looked at. 01 gives a 0, 10 gives
+//                                  a 1 and 00 and 11 are thrown away. This removes any 
+//                                  bias completely (if the bits are independent) but 
+//                                  throws away at least 3/4 of them
+//    RNG_CONDITIONING_HASH       - RNG_HASH_INPUT_BYTES raw values are mixed into a 32 bit
+//                                  hash and one byte comes out. Quicker than von Neumann 
+//                                  and it also spreads the entropy of correlated bits. It
+//                                  is NOT one of the SP 800-90B vetted conditioners
+//
+// The health tests always look at the raw values, before any conditioning. 
+// GetRawSampleCount() and GetPoolOutputCount() say how many values went in and how many 
+// bytes came out so the cost of each configuration can be seen.
+
+// the number of bytes the pool holds. It MUST be a power of two. Define 
+// it before this file is included to change it
+#ifndef RNG_POOL_BYTES
+#define RNG_POOL_BYTES          64
+#endif
+#define RNG_POOL_MASK           (RNG_POOL_BYTES-1)
+// the RNG is started again when the pool gets down to this many bytes
+#ifndef RNG_POOL_REFILL_LEVEL
+#define RNG_POOL_REFILL_LEVEL   (RNG_POOL_BYTES/2)
+#endif
+// the health test cutoffs. See the note on the HEALTH TESTS above
+#ifndef RNG_HEALTH_RCT_CUTOFF
+#define RNG_HEALTH_RCT_CUTOFF   11      // 1+(20/2)
+#endif
+#define RNG_HEALTH_APT_WINDOW   512
+#ifndef RNG_HEALTH_APT_CUTOFF
+#define RNG_HEALTH_APT_CUTOFF   177     // SP 800-90B table 2, H=2
+#endif
+// the raw values mixed for every byte that comes out of the hash conditioning
+#define RNG_HASH_INPUT_BYTES    4
+#define RNG_BITS_IN_BYTE        8
+
+// the software conditioning types. See the note on CONDITIONING above
+enum RNG_CONDITIONING {
+    RNG_CONDITIONING_NONE=0,
+    RNG_CONDITIONING_VONNEUMANN=1,
+    RNG_CONDITIONING_HASH=2,
+};
+
 /* YakIO_RNG - a class to represent and encapsulate the random number
  *     peripheral
  * */
@@ -56,6 +143,37 @@ class YakIO_RNG
       void ClearINTEN(void);
       void ResetAllShorts(void);
       void ClearValueReady(void);
+      unsigned int poolIsRunning =0;
+      // the RNG interrupt fills the pool and stops the RNG while the code 
+      // outside it polls these (GetPoolCount(), GetPoolOutputCount() and 
+      // TryGetBytes()), so they must be volatile
+      volatile unsigned int poolIsFilling =0;
+      volatile unsigned int poolWriteCount =0;
+      unsigned int poolReadCount =0;
+      unsigned char poolBytes[RNG_POOL_BYTES];
+      void FillPool(void);
+      void RefillPoolIfNeeded(unsigned int bytesWanted);
+      enum RNG_CONDITIONING conditioning = RNG_CONDITIONING_NONE;
+      // the health tests run in the interrupt and the code outside it polls
+      // the results (HasHealthFailed(), GetRawSampleCount() and the failure
+      // counts - see 19_RngHealth), so these must be volatile as well
+      volatile unsigned int rawSampleCount =0;
+      // counted by the interrupt too, see poolWriteCount
+      volatile unsigned int poolOutputCount =0;
+      volatile unsigned int healthFailed =0;
+      volatile unsigned int repetitionFailureCount =0;
+      volatile unsigned int proportionFailureCount =0;
+      unsigned int rctLastValue =0;
+      unsigned int rctRepeatCount =0;
+      unsigned int aptFirstValue =0;
+      unsigned int aptSampleCount =0;
+      unsigned int aptMatchCount =0;
+      unsigned int conditionBits =0;
+      unsigned int conditionCount =0;
+      unsigned int conditionHash =0;
+      void ResetHealthAndConditioning(void);
+      unsigned int RunHealthTests(unsigned int rngValue);
+      unsigned int ConditionValue(unsigned int rngValue, unsigned int *outValuePtr);
 
   public:
       // Constructor to initialize YakIO_RNG object
@@ -71,6 +189,22 @@ class YakIO_RNG
       void SetDerCen(enum RNG_DERCEN derCenValue);
       unsigned int GetRngValue(void);
       enum RNG_DERCEN GetDerCen(void);
+      void HandleRngIRQ(void);
+      void PoolStart(void);
+      void PoolStop(void);
+      unsigned int IsPoolRunning(void);
+      unsigned int GetPoolCount(void);
+      unsigned int TryGetBytes(unsigned char *outBuffer, unsigned int byteCount);
+      unsigned int GetU32(unsigned int *randomValuePtr);
+      void SetConditioning(enum RNG_CONDITIONING conditioningIn);
+      enum RNG_CONDITIONING GetConditioning(void);
+      unsigned int GetRawSampleCount(void);
+      unsigned int GetPoolOutputCount(void);
+      unsigned int HasHealthFailed(void);
+      unsigned int GetHealthFailureCount(void);
+      unsigned int GetRepetitionFailureCount(void);
+      unsigned int GetProportionFailureCount(void);
+      void ClearHealthFailures(void);
 
 };
 
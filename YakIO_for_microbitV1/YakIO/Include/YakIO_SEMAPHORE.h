@@ -0,0 +1,60 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_SEMAPHORE_H
+#define YAKIO_SEMAPHORE_H
+
+#include "YakIO.h"
+#include "YakIO_KERNEL.h"
+
+// A note on SEMAPHORES.
+//
+// A semaphore is a counter that threads can wait on. Give() adds one to the count. Take() subtracts
+// one from it - but if the count is already zero Take() makes the calling thread wait (using no CPU
+// at all) until somebody else calls Give(). If several threads are waiting, Give() wakes the one
+// with the highest priority.
+//
+// The most common use is to let an interrupt handler wake up a thread. For example the random 
+// number generator interrupt can Give() a semaphore that a thread is waiting on with Take(). The 
+// thread sleeps until the number is ready instead of spinning in a loop like GetRngValue() does. 
+// See the 10_Threads example.
+//
+// Give() can be called from anywhere - threads or interrupt handlers. Take() with a timeout can
+// only be called from a thread because only threads can wait. Interrupt handlers can call Take() 
+// with a timeout of 0 which never waits, it just returns 0 if the count was zero.
+
+/* YakIO_SEMAPHORE - a class to represent a counting semaphore that 
+ *     YakIO_KERNEL threads can wait on
+ * */
+class YakIO_SEMAPHORE
+{
+  private:
+      unsigned int isInitialized =0;
+      volatile unsigned int semaphoreCount =0;
+      unsigned int maxCount =0;
+      // a bit for each thread waiting on us
+      volatile unsigned int waitList =0;
+
+  public:
+      // Constructor to initialize YakIO_SEMAPHORE object
+      YakIO_SEMAPHORE(unsigned int initialCount, unsigned int maxCountIn);
+      unsigned int Take(unsigned int timeoutTicks);
+      void Give(void);
+      unsigned int GetCount(void);
+
+};
+
+#endif
@@ -0,0 +1,164 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_SEQLOCK_H
+#define YAKIO_SEQLOCK_H
+
+#include "YakIO.h"
+#include "YakIO_Utils.h"
+
+// A note on SEQUENCE LOCKS (seqlocks). 
+//
+// Frequently an interrupt handler produces some data which the MainLoop() consumes. If that data
+// is bigger than a single 32 bit word then the MainLoop() can be interrupted half way through 
+// reading it and end up with a "torn" copy - part old value and part new value. See the note
+// on CRITICAL SECTIONS in YakIO_Utils.h.
+//
+// Disabling interrupts around every read works but it means the interrupts get delayed every 
+// time the MainLoop() wants to look at the data. A seqlock is an alternative which never
+// disables interrupts at all. It works like this:
+//
+//   The writer (usually an interrupt handler) keeps a sequence counter next to the data. Before 
+//   it changes the data it adds one to the counter (making it odd). After it has finished 
+//   changing the data it adds one to the counter again (making it even).
+//
+//   The reader (usually the MainLoop()) reads the counter, copies the data and reads the counter
+//   again. If both counter values are the same, and even, then nothing changed while the copy 
+//   was being made and the copy is good. If not, the reader just goes around and tries again.
+//
+// The writer never waits for anything. The reader only repeats its copy in the rare case where an
+// interrupt actually arrived part way through.
+//
+// IMPORTANT: The reader retries until it gets a clean copy. This is only safe if the writer can
+// interrupt the reader and not the other way around. In other words, write from the interrupt
+// handler and read from the MainLoop() (or from a lower priority interrupt). If you read from 
+// an interrupt handler which has interrupted a half finished Write() in the MainLoop(), the 
+// sequence counter will never become even and the reader will spin forever. If you really need
+// to read from an interrupt handler use TryRead() which only makes one attempt.
+//
+// IMPORTANT: Only have one writer. Two interrupt handlers of different priorities both calling
+// Write() on the same seqlock can corrupt the data.
+//
+// Since YakIO_SEQLOCK is a template its code has to live here in the header file. The compiler
+// needs to see all of it in order to generate a version for each type you use it with. This is 
+// the only reason it is not in a .cpp file like the other YakIO classes.
+//
+// Keep T small and simple - a few words in a struct. Large types take longer to copy which makes 
+// a torn read (and hence a retry) more likely.
+//
+// Example:
+//      struct RowWords { unsigned int row[3]; };
+//      YakIO_SEQLOCK<RowWords> rowLock {};
+//
+//      in the interrupt handler:  rowLock.Write(newRows);
+//      in the MainLoop():         RowWords myCopy = rowLock.Read();
+//
+// Credit: 
+//   The seqlock is a well known technique originating in the Linux kernel. See:
+//      https://en.wikipedia.org/wiki/Seqlock
+
+/* YakIO_SEQLOCK - a class to share a multi word value between an interrupt 
+ *     handler (the writer) and the MainLoop() (the reader) without disabling
+ *     interrupts.
+ * */
+template <typename T>
+class YakIO_SEQLOCK
+{
+  private:
+      // odd while a write is in progress, even otherwise
+      volatile unsigned int sequence = 0;
+      // the protected value
+      T value {};
+
+  public:
+
+    /* Write - publishes a new value. Never blocks. 
+     *
+     *    Call this from the single writer only. Usually this is an interrupt
+     *    handler.
+     *
+     * inputs:
+     *    newValue - the value to publish
+     * */
+    void Write(const T &newValue)
+    {
+        // odd - a write is now in progress
+        sequence = sequence + 1;
+        // make sure the compiler does not move the data writes above this point
+        COMPILER_BARRIER();
+        value = newValue;
+        // make sure the compiler does not move the data writes below this point
+        COMPILER_BARRIER();
+        // even again - the write is finished
+        sequence = sequence + 1;
+    }
+
+    /* Read - gets a consistent copy of the value. Retries as long as the copy
+     *     was torn by a write arriving part way through.
+     *
+     *    Call this from the MainLoop() or from a lower priority context than
+     *    the writer. See the discussion at the top of this file.
+     *
+     * returns:
+     *    a consistent copy of the value
+     * */
+    T Read(void)
+    {
+        T valueCopy;
+        while(TryRead(valueCopy)==0) {}
+        return valueCopy;
+    }
+
+    /* TryRead - makes exactly one attempt at getting a consistent copy of 
+     *     the value.
+     *
+     * outputs:
+     *    valueCopy - receives the copy. If the return code is 0 the contents
+     *        are torn and must not be used
+     *
+     * returns:
+     *    1 if valueCopy is consistent, 0 if it is not
+     * */
+    unsigned int TryRead(T &valueCopy)
+    {
+        unsigned int startSequence = sequence;
+        // an odd sequence means we have interrupted the writer (or will be
+        // reading a half written value), no point in trying
+        if((startSequence & 0x01) != 0) return 0;
+        // make sure the compiler reads the sequence before the data
+        COMPILER_BARRIER();
+        valueCopy = value;
+        // make sure the compiler reads the data before the sequence
+        COMPILER_BARRIER();
+        // if nothing wrote while we copied the copy is good
+        if(sequence != startSequence) return 0;
+        return 1;
+    }
+
+    /* GetSequence - gets the current sequence count. Each Write() advances
+     *     this by two. Can be used to cheaply tell if anything has changed
+     *     since you last looked.
+     *
+     * returns:
+     *    the current sequence count
+     * */
+    unsigned int GetSequence(void)
+    {
+        return sequence;
+    }
+};
+
+#endif
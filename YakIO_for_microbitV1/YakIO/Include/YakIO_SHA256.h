@@ -0,0 +1,93 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_SHA256_H
+#define YAKIO_SHA256_H
+
+#include "YakIO.h"
+
+// A note on SHA256. There is no hash in the nRF51822 hardware so this is SHA-256 (FIPS 180-4)
+// done by the CPU. It is what you need to check a firmware image has not been damaged or 
+// changed and, with YakIO_HMAC, to check a command on the UART came from someone who knows
+// the key.
+//
+// The data can be given in pieces of any size with Update() - a flash page at a time as
+// it comes in, say - and the hash is only worked out when Finish() is called. Whole 64 byte
+// blocks are hashed straight from the caller's buffer, only the odd bytes left over are 
+// copied. So Update() with a multiple of 64 bytes is the quickest way to feed it.
+//
+// It is written for the Cortex-M0. Thumb-1 instructions can only do arithmetic in the 8 low
+// registers (r0 to r7) and SHA-256 has 8 working variables, a round constant, a schedule 
+// word and the temporaries. Something has to live on the stack. To keep that down:
+//
+//   1) the usual "h=g; g=f; f=e ..." shuffle at the end of every round is never done. The
+//      rounds are written out 8 at a time with the variables taking turns at each role, 
+//      so a round only changes two of them.
+//   2) the big sigma functions are done as ROTR(x ^ ROTR(x ^ ROTR(x,a),b),c). That is the
+//      same answer with only one value live at a time. The M0 has a RORS instruction so 
+//      each rotate is one cycle.
+//   3) the message schedule is kept in 16 words, not 64. Each new word overwrites the one
+//      it no longer needs.
+//
+// SHA256_UNROLL_SCHEDULE chooses how the rounds are written. 0 (the default) runs the 64 
+// rounds as a loop of 8 and works out the schedule index each time (W[(i+1)&15] etc). 1 
+// writes all 16 rounds of each pass of the schedule out in full so every index is a 
+// constant and the loop runs just 4 times. It is noticeably quicker and takes a couple of
+// K more flash. 22_HashBenchmark prints the cycles per byte, build it both ways and see.
+//
+// Example:
+//      YakIO_SHA256 sha256Obj;
+//      sha256Obj.Start();
+//      sha256Obj.Update(pagePtr, 1024);
+//      ... as many more Update() calls as you like
+//      sha256Obj.Finish(hashBytes);
+
+#define SHA256_BLOCK_BYTES     64
+#define SHA256_HASH_BYTES      32
+#define SHA256_STATE_WORDS     8
+#define SHA256_SCHEDULE_WORDS  16   // the 64 word schedule is made 16 words at a time
+#define SHA256_ROUNDS          64
+#define SHA256_LENGTH_BYTES    8    // the bit count at the end of the padding
+
+// 0 for the smaller rolled rounds, 1 for the faster unrolled ones. See the note above
+#ifndef SHA256_UNROLL_SCHEDULE
+#define SHA256_UNROLL_SCHEDULE 0
+#endif
+
+/* YakIO_SHA256 - the SHA-256 hash in software
+ * */
+class YakIO_SHA256
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned int stateWords[SHA256_STATE_WORDS];
+      unsigned char blockBytes[SHA256_BLOCK_BYTES];
+      unsigned int blockFill =0;
+      unsigned int byteCountLow =0;
+      unsigned int byteCountHigh =0;
+      void ProcessBlock(const unsigned char *blockPtr);
+
+  public:
+      // Constructor to initialize YakIO_SHA256 object
+      YakIO_SHA256();
+      void Start(void);
+      void Update(const unsigned char *dataBytes, unsigned int byteCount);
+      void Finish(unsigned char *hashBytes);
+      void Hash(const unsigned char *dataBytes, unsigned int byteCount, unsigned char *hashBytes);
+      unsigned int GetByteCount(void);
+};
+
+#endif
@@ -0,0 +1,61 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_SOFTAES_H
+#define YAKIO_SOFTAES_H
+
+#include "YakIO.h"
+
+// A note on SOFTAES. The nRF51822 has AES in hardware (see YakIO_ECB.h) and that is what you
+// should normally use. YakIO_SOFTAES is the same AES-128 encryption done by the CPU, one byte
+// at a time, straight out of FIPS-197. It is here for two reasons:
+//
+//   1) the host build. The simulated ECB (see YakIO_HOSTREGISTERS.h) uses it so code which 
+//      uses the ECB gives the right answers on a PC.
+//   2) as something to measure the hardware against.
+//
+// Only encryption is provided. CTR and CCM modes never need to decrypt a block.
+//
+// It is written to be small and easy to follow, not quick. The usual fast software AES 
+// uses 4K of lookup tables - that is a quarter of our RAM. This one has just the 256 byte 
+// S-box (in flash) and the 176 bytes of round keys SetKey() works out.
+//
+// Example:
+//      YakIO_SOFTAES softAes;
+//      softAes.SetKey(keyBytes);
+//      softAes.EncryptBlock(clearBlock, cipherBlock);
+
+#define SOFTAES_KEY_BYTES      16
+#define SOFTAES_BLOCK_BYTES    16
+#define SOFTAES_ROUNDS         10
+#define SOFTAES_ROUND_KEY_BYTES (SOFTAES_BLOCK_BYTES*(SOFTAES_ROUNDS+1))
+
+/* YakIO_SOFTAES - AES-128 encryption in software
+ * */
+class YakIO_SOFTAES
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned char roundKeys[SOFTAES_ROUND_KEY_BYTES];
+
+  public:
+      // Constructor to initialize YakIO_SOFTAES object
+      YakIO_SOFTAES();
+      void SetKey(const unsigned char *keyBytes);
+      void EncryptBlock(const unsigned char *clearBlock, unsigned char *cipherBlock);
+};
+
+#endif
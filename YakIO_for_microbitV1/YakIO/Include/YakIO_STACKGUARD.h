@@ -0,0 +1,70 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_STACKGUARD_H
+#define YAKIO_STACKGUARD_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_Utils.h"
+
+// A note on the STACKGUARD. See the STACK notes in YakIO_Utils.h first. IsStackCanaryIntact()
+// will tell you if the stack has reached its limit but only when you call it. YakIO_STACKGUARD
+// uses one of the YakIO_TIMERs to call it for you every so often. If the canary has been 
+// overwritten it calls a callback function of your choice, once, and stops checking.
+//
+// By the time the canary is overwritten the memory below the stack may already be damaged so
+// do as little as possible in the callback - light an LED, save a flag in a YAKIO_NOINIT 
+// variable and reset, that sort of thing. If you do not give a callback YakIO_STACKGUARD stops
+// dead in an endless loop rather than let the program carry on with damaged memory.
+//
+// The check runs in the timer interrupt. It only looks at STACK_CANARY_WORDS words so it is 
+// quick. 
+//
+// Example:
+//      in the Main class:     YakIO_STACKGUARD stackGuard {Timer1};
+//      in MainLoop():         stackGuard.Start(100, CALLBACK_3, this);  // check every 100ms
+//      and:                   void Callback3(void) override;           // the stack has overflowed
+
+/* YakIO_STACKGUARD - a class to check the stack canary from a timer
+ *     interrupt
+ * */
+class YakIO_STACKGUARD : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_TIMER checkTimerObj;
+      YakIO_CALLBACK *callbackInterfacePtr = NULL;
+      enum CALLBACK_ID callbackID = CALLBACK_NONE;
+      unsigned int checkIntervalMs =0;
+      unsigned int msSinceLastCheck =0;
+      unsigned int checkCount =0;
+      unsigned int overflowDetected =0;
+
+  public:
+      // Constructor to initialize YakIO_STACKGUARD object
+      YakIO_STACKGUARD(enum TIMER checkTimerIDIn);
+      void Start(unsigned int checkIntervalMsIn, enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void Stop(void);
+      unsigned int HasOverflowed(void);
+      unsigned int GetCheckCount(void);
+      // the timer tick. Do not call this
+      void Callback0(void) override;
+
+};
+
+#endif
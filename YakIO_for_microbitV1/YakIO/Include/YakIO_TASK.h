@@ -0,0 +1,327 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_TASK_H
+#define YAKIO_TASK_H
+
+// these two are part of the compiler, not a library. They contain no code
+// that needs linking, just the definitions the compiler needs to build
+// coroutines. Note that YakIO is compiled with -std=c++20 -fcoroutines for this.
+#include <cstddef>
+#include <coroutine>
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_EVENTLOOP.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_RNG.h"
+#include "YakIO_UART.h"
+#include "YakIO_Utils.h"
+
+// A note on TASKS (COROUTINES).
+//
+// Some device logic is naturally sequential - "wait for the button, wait 20ms, get a random number,
+// show it, wait half a second, go round again". With callbacks this has to be chopped up into 
+// pieces with flags and state variables remembering where we are up to. With the threads of 
+// YakIO_KERNEL it can be written in order but every thread needs its own stack and stacks 
+// cost RAM we do not really have in 16KB.
+//
+// C++20 coroutines are a middle way. A coroutine is a function that can stop part way through 
+// (at a "co_await") and be resumed later, right where it left off. Unlike a thread it does not 
+// keep a stack while it is stopped. The compiler works out exactly which local variables are 
+// needed after each co_await and keeps only those, in a small block of memory called a "frame".
+// When the coroutine is resumed it runs on the ordinary stack of whoever resumed it.
+//
+// In YakIO a coroutine is any function which returns a YakIO_TASK and uses co_await. For example
+//
+//       YakIO_TASK Main::BlinkTask(void)
+//       {
+//           while(1)
+//           {
+//               ledArray.SetBinaryImage(someImage);
+//               co_await taskScheduler.Delay(500);  // the code stops here for 500ms
+//               ledArray.ClearImage();
+//               co_await taskScheduler.Delay(500);
+//           }
+//       }
+//
+// Calling BlinkTask() does not run it. It just creates the frame and hands back a YakIO_TASK. 
+// Giving that to taskScheduler.Spawn() starts it running. The things you can co_await are
+//
+//       Delay(ticks)                  - wait for a number of 1 millisecond ticks
+//       WaitForEdge(gpioPtr, edge)    - wait for a GPIO to change (see TASK_EDGE below)
+//       GetRandom(rngPtr)             - wait for the RNG and get the value it produced
+//       ReadByte(uartPtr)             - wait for the UART to receive a byte and get it
+//       co_await someTaskSignal       - wait for some interrupt handler to call Signal() on
+//                                       a YakIO_TASKSIGNAL and get the value it sent. This
+//                                       is how your own interrupt handlers hand a value 
+//                                       to a task.
+//
+// WHERE DO THE FRAMES COME FROM? Normally the compiler would call "new" to get the memory for the
+// frame. There is no heap in YakIO (see 03_Danger) so the YakIO_TASK tells the compiler to get 
+// it from a fixed pool of TASK_FRAME_POOL_SLOTS slots, each TASK_FRAME_SLOT_WORDS words long, 
+// inside the YakIO_TASKSCHEDULER object. If the frame is too big, or all the slots are in use, 
+// the task is not created and Spawn() returns 0. The slot is given back when the task finishes.
+// Spawn() works before or after Start(). A task Spawn()ed before is held and starts when Start()
+// registers the scheduler with the event loop.
+//
+// WHERE DO THEY RUN? The scheduler does not have a loop of its own. It uses the YakIO_EVENTLOOP. 
+// When a task is ready to be resumed the scheduler posts an event (the eventData is the address
+// of the frame) and when the event loop dispatches it the scheduler resumes the task. This means
+// tasks are run to completion in exactly the same way as ordinary event handlers - a task runs 
+// until its next co_await and nothing else in the event loop runs until it gets there. Tasks and
+// event handlers can therefore share data without any locking.
+//
+// THE RAM COST: The frame size is decided by the compiler and depends on what locals the task 
+// keeps across its co_awaits. The scheduler records the size the compiler asks for. Call 
+// GetLargestFrameBytes() to see the biggest and compare it with TASK_FRAME_SLOT_WORDS*4. Every 
+// frame has at least two code pointers (resume and destroy), a word saying which co_await it 
+// is stopped at and a copy of "this" for a member function, plus the awaiter it is stopped in.
+// The 11_Coroutines example shows the measured size on the LED display. Compare that with the 
+// KERNEL_MIN_STACK_WORDS (32 words, 128 bytes) that is the very least a YakIO_KERNEL thread needs.
+//
+// IMPORTANT: There can be only one YakIO_TASKSCHEDULER. The compiler generated code has to be 
+// able to find the frame pool and it does that through taskScheduler_ptr.
+//
+// IMPORTANT: Register the resume eventType with a priority that nothing else posts to. A task 
+// can only be waiting for one thing at a time so there can never be more than TASK_FRAME_POOL_SLOTS 
+// resume events in the queue - which is less than EVENTLOOP_QUEUE_SIZE. If some other event 
+// shares the queue and fills it the resume event cannot be posted. The scheduler then holds 
+// the task and tries again on every tick so it is not lost, but it does run late.
+//
+// See the 11_Coroutines example.
+
+// the number of frames in the pool, this is the maximum number of tasks that can exist at once
+#define TASK_FRAME_POOL_SLOTS 4
+// the size of each frame slot in 32 bit words. 
+#define TASK_FRAME_SLOT_WORDS 32
+// the number of tasks that can be waiting in Delay() at once
+#define TASK_MAX_DELAY_WAITERS TASK_FRAME_POOL_SLOTS
+// the number of tasks that can be waiting in WaitForEdge() at once
+#define TASK_MAX_EDGE_WAITERS TASK_FRAME_POOL_SLOTS
+// the number of tasks that can be waiting in GetRandom() at once
+#define TASK_MAX_RNG_WAITERS TASK_FRAME_POOL_SLOTS
+// the number of tasks that can be waiting in ReadByte() at once
+#define TASK_MAX_UART_WAITERS TASK_FRAME_POOL_SLOTS
+
+// the GPIO changes WaitForEdge() can wait for. The GPIO is checked every 
+// tick (1 millisecond), it is not interrupt driven.
+enum TASK_EDGE {
+    TASK_EDGE_FALLING=0,       // the GPIO goes from 1 to 0. A button press
+    TASK_EDGE_RISING=1,        // the GPIO goes from 0 to 1. A button release
+    TASK_EDGE_ANY=2            // either
+};
+
+/* YakIO_TASK - the return type of a coroutine. The compiler looks inside
+ *     this for a class called promise_type and uses it to decide how the
+ *     coroutine starts, ends and gets its memory. 
+ *
+ *     NOTE: the names in here (promise_type, initial_suspend, etc) are fixed
+ *     by the C++ standard which is why they do not follow the YakIO naming rules.
+ * */
+class YakIO_TASK
+{
+  public:
+      struct promise_type
+      {
+          // the frame memory comes from here, not the heap
+          static void *operator new(std::size_t frameBytes) noexcept;
+          static void operator delete(void *framePtr);
+          // called if operator new returns NULL
+          static YakIO_TASK get_return_object_on_allocation_failure(void);
+          YakIO_TASK get_return_object(void);
+          // tasks do not run until they are Spawn()ed
+          std::suspend_always initial_suspend(void) noexcept;
+          // tasks free their frame as soon as they finish
+          std::suspend_never final_suspend(void) noexcept;
+          void return_void(void);
+          void unhandled_exception(void);
+      };
+
+      // the coroutine. This is empty (NULL) if the frame could not be allocated
+      std::coroutine_handle<promise_type> taskHandle;
+};
+
+class YakIO_TASKSCHEDULER;
+
+/* YakIO_DELAYAWAITER - what taskScheduler.Delay() returns. co_await it
+ *    to wait for a number of ticks
+ * */
+struct YakIO_DELAYAWAITER
+{
+    YakIO_TASKSCHEDULER *schedulerPtr;
+    unsigned int delayTicks;
+    bool await_ready(void);
+    bool await_suspend(std::coroutine_handle<> waitingHandle);
+    void await_resume(void);
+};
+
+/* YakIO_EDGEAWAITER - what taskScheduler.WaitForEdge() returns. co_await it
+ *    to wait for a GPIO to change
+ * */
+struct YakIO_EDGEAWAITER
+{
+    YakIO_TASKSCHEDULER *schedulerPtr;
+    YakIO_GPIO *gpioPtr;
+    enum TASK_EDGE edgeType;
+    bool await_ready(void);
+    bool await_suspend(std::coroutine_handle<> waitingHandle);
+    void await_resume(void);
+};
+
+/* YakIO_RNGAWAITER - what taskScheduler.GetRandom() returns. co_await it
+ *    to get a random number without spinning. The RNG interrupt puts the
+ *    value straight into rngValue, the awaiter lives in the task's frame
+ *    while it waits
+ * */
+struct YakIO_RNGAWAITER
+{
+    YakIO_TASKSCHEDULER *schedulerPtr;
+    YakIO_RNG *rngPtr;
+    volatile unsigned int rngValue;
+    bool await_ready(void);
+    bool await_suspend(std::coroutine_handle<> waitingHandle);
+    unsigned int await_resume(void);
+};
+
+/* YakIO_UARTAWAITER - what taskScheduler.ReadByte() returns. co_await it
+ *    to get the next byte the UART receives without spinning. As above, 
+ *    the UART interrupt puts the byte straight into byteValue
+ * */
+struct YakIO_UARTAWAITER
+{
+    YakIO_TASKSCHEDULER *schedulerPtr;
+    YakIO_UART *uartPtr;
+    volatile unsigned int byteValue;
+    bool await_ready(void);
+    bool await_suspend(std::coroutine_handle<> waitingHandle);
+    unsigned int await_resume(void);
+};
+
+/* YakIO_TASKSIGNAL - a one word mailbox an interrupt handler can use to
+ *    wake a task and hand it a value (a received byte, say). 
+ *
+ *    Only one task can wait on it at a time. If Signal() is called when 
+ *    nobody is waiting the value is kept and the next co_await returns it
+ *    immediately. If Signal() is called again before then the older value
+ *    is overwritten.
+ * */
+class YakIO_TASKSIGNAL
+{
+  private:
+      unsigned int isInitialized =0;
+      void * volatile waitingHandleAddress = NULL;
+      volatile unsigned int signalValue =0;
+      volatile unsigned int signalPending =0;
+
+  public:
+      // Constructor to initialize YakIO_TASKSIGNAL object
+      YakIO_TASKSIGNAL();
+      void Signal(unsigned int valueIn);
+      // these make the object itself co_await'able. The names are fixed by the C++ standard
+      bool await_ready(void);
+      bool await_suspend(std::coroutine_handle<> waitingHandle);
+      unsigned int await_resume(void);
+};
+
+/* YakIO_TASKSCHEDULER - a class to own the frame pool and the things tasks
+ *     wait for, and to resume tasks from the YakIO_EVENTLOOP.
+ * */
+class YakIO_TASKSCHEDULER : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      // where we post the resume events, and what eventType we use
+      YakIO_EVENTLOOP *eventLoopPtr = NULL;
+      unsigned int resumeEventType =0;
+      // the timer that generates the tick for Delay() and WaitForEdge()
+      YakIO_TIMER tickTimerObj;
+      volatile unsigned int tickCount =0;
+
+      // the frame pool
+      unsigned int framePool[TASK_FRAME_POOL_SLOTS][TASK_FRAME_SLOT_WORDS];
+      unsigned int frameInUse[TASK_FRAME_POOL_SLOTS];
+      unsigned int framesInUseCount =0;
+      unsigned int framesInUseHighWater =0;
+      unsigned int largestFrameBytes =0;
+      unsigned int failedAllocationCount =0;
+
+      // the tasks waiting in Delay(). NULL means the slot is free
+      void * volatile delayHandleAddresses[TASK_MAX_DELAY_WAITERS];
+      unsigned int delayWakeTicks[TASK_MAX_DELAY_WAITERS];
+      // the tasks waiting in WaitForEdge(). NULL means the slot is free
+      void * volatile edgeHandleAddresses[TASK_MAX_EDGE_WAITERS];
+      YakIO_GPIO *edgeGpioPtrs[TASK_MAX_EDGE_WAITERS];
+      enum TASK_EDGE edgeTypes[TASK_MAX_EDGE_WAITERS];
+      unsigned int edgeLastStates[TASK_MAX_EDGE_WAITERS];
+      // the tasks waiting in GetRandom(), oldest first. Each value the RNG 
+      // makes goes to the oldest, and where it goes is in the awaiter
+      void * volatile rngHandleAddresses[TASK_MAX_RNG_WAITERS];
+      volatile unsigned int *rngValuePtrs[TASK_MAX_RNG_WAITERS];
+      volatile unsigned int rngWaiterCount =0;
+      YakIO_RNG *rngWaitPtr = NULL;
+      // the tasks waiting in ReadByte(), oldest first. The same again
+      void * volatile uartHandleAddresses[TASK_MAX_UART_WAITERS];
+      volatile unsigned int *uartValuePtrs[TASK_MAX_UART_WAITERS];
+      volatile unsigned int uartWaiterCount =0;
+      YakIO_UART *uartWaitPtr = NULL;
+      // the tasks MakeReady() could not post. NULL means the slot is free
+      void * volatile heldHandleAddresses[TASK_FRAME_POOL_SLOTS];
+
+      void PostHeldTasks(void);
+
+  public:
+      // Constructor to initialize YakIO_TASKSCHEDULER object
+      YakIO_TASKSCHEDULER(YakIO_EVENTLOOP *eventLoopPtrIn, unsigned int resumeEventTypeIn, enum TIMER tickTimerIDIn);
+      void Start(enum EVENT_PRIORITY resumePriority);
+      unsigned int Spawn(YakIO_TASK newTask);
+      unsigned int MakeReady(void *handleAddress);
+      // the things a task can co_await
+      YakIO_DELAYAWAITER Delay(unsigned int delayTicks);
+      YakIO_EDGEAWAITER WaitForEdge(YakIO_GPIO *gpioPtr, enum TASK_EDGE edgeType);
+      YakIO_RNGAWAITER GetRandom(YakIO_RNG *rngPtr);
+      YakIO_UARTAWAITER ReadByte(YakIO_UART *uartPtr);
+      // used by the awaiters
+      unsigned int AddDelayWaiter(void *handleAddress, unsigned int delayTicks);
+      unsigned int AddEdgeWaiter(void *handleAddress, YakIO_GPIO *gpioPtr, enum TASK_EDGE edgeType);
+      unsigned int AddRngWaiter(void *handleAddress, YakIO_RNG *rngPtr, volatile unsigned int *valuePtr);
+      unsigned int AddUartWaiter(void *handleAddress, YakIO_UART *uartPtr, volatile unsigned int *valuePtr);
+      // used by YakIO_TASK::promise_type
+      void *AllocateFrame(unsigned int frameBytes);
+      void FreeFrame(void *framePtr);
+      // statistics
+      unsigned int GetTickCount(void);
+      unsigned int GetFramesInUse(void);
+      unsigned int GetFramesInUseHighWater(void);
+      unsigned int GetLargestFrameBytes(void);
+      unsigned int GetFailedAllocationCount(void);
+      // the event loop calls this to resume a task
+      void EventCallback(unsigned int eventType, unsigned int eventData) override;
+      // the tick arrives here from the tick timer
+      void Callback0(void) override;
+      // the RNG interrupt arrives here
+      void Callback1(void) override;
+      // the UART receive interrupt arrives here
+      void Callback2(void) override;
+
+};
+
+// the scheduler object. There can be only one. This is set in the constructor
+// so that the frame allocation in YakIO_TASK::promise_type can find the pool
+extern YakIO_TASKSCHEDULER *taskScheduler_ptr;
+
+#endif
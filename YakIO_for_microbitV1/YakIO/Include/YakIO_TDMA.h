@@ -0,0 +1,260 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_TDMA_H
+#define YAKIO_TDMA_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_PPI.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_TIMESYNC.h"
+
+// the shape of the superframe. See the note below
+#define TDMA_MAX_NODES              16         // data slots. No more than 16, the beacon has a 16 bit map of them
+#define TDMA_NO_SLOT                0xFF
+#define TDMA_BEACON_SLOT            0
+#define TDMA_JOIN_SLOT              1
+#define TDMA_FIRST_DATA_SLOT        2          // data slot n is superframe slot TDMA_FIRST_DATA_SLOT+n
+#define TDMA_MAX_ACTIVITIES         3          // the most times the RADIO is on in one superframe
+
+// the timing, in TIMER0 ticks (microseconds). TDMA_GUARD_TICKS is how far apart two 
+// boards' ideas of the time can be and still hear each other. Define it before this 
+// file is included to change it
+#ifndef TDMA_GUARD_TICKS
+#define TDMA_GUARD_TICKS            60
+#endif
+#define TDMA_RAMPUP_TICKS           130        // TXEN or RXEN to READY
+#define TDMA_PACKET_TICKS           ((1+5+1+RADIO_MAX_PAYLOAD_BYTES+2)*8)  // the longest packet at 1Mbit
+#define TDMA_WINDOW_TICKS           (TDMA_GUARD_TICKS+TDMA_RAMPUP_TICKS+TDMA_PACKET_TICKS+TDMA_GUARD_TICKS)
+#define TDMA_TURNAROUND_TICKS       100        // the end of every slot, time to get ready for the next
+#define TDMA_SLOT_TICKS             (TDMA_WINDOW_TICKS+TDMA_TURNAROUND_TICKS)
+#define TDMA_SETTLE_TICKS           10         // after a window closes before we look at the RADIO
+#define TDMA_MIN_LEAD_TICKS         40         // the least notice we need to get the RADIO ready
+
+// how long things are waited for, in superframes
+#define TDMA_SLOT_TIMEOUT           64         // the coordinator frees the slot of a node it has not heard for this long
+#define TDMA_BEACON_TIMEOUT         32         // a node with no beacon for this long goes back to searching
+#define TDMA_MIN_JOIN_WINDOW        2          // a join request is sent in a random one of the next this many superframes
+#define TDMA_MAX_JOIN_WINDOW        16         // it doubles after every try, up to this
+
+// TIMER0 COMPARE[2] -> RADIO DISABLE closes every window. Define the PPI channel 
+// before this file is included if 15 is already in use
+#ifndef TDMA_PPI_CHANNEL_DISABLE
+#define TDMA_PPI_CHANNEL_DISABLE    15
+#endif
+#define TDMA_CC_DISABLE             TIMERREG_OFFSET_CC_2
+#define TDMA_COMPARE_DISABLE        TIMERREG_OFFSET_COMPARE_2
+
+// the beacon is a YakIO_TIMESYNC beacon with these bytes after it
+#define TDMA_BEACON_OFFSET_START      (TIMESYNC_BEACON_BYTES+0)   // 4 bytes, the network time slot 0 started, LSB first
+#define TDMA_BEACON_OFFSET_SLOTS      (TIMESYNC_BEACON_BYTES+4)   // the number of data slots in this superframe
+#define TDMA_BEACON_OFFSET_MAP        (TIMESYNC_BEACON_BYTES+5)   // 2 bytes, bit n set if data slot n is taken, LSB first
+#define TDMA_BEACON_OFFSET_JOIN_ID    (TIMESYNC_BEACON_BYTES+7)   // 4 bytes, the node the last join was for, LSB first
+#define TDMA_BEACON_OFFSET_JOIN_SLOT  (TIMESYNC_BEACON_BYTES+11)  // and the data slot it was given
+#define TDMA_BEACON_EXTRA_BYTES       12
+#define TDMA_BEACON_BYTES             (TIMESYNC_BEACON_BYTES+TDMA_BEACON_EXTRA_BYTES)
+
+// the join request a node sends in the join slot
+#define TDMA_JOIN_TAG               0x4A       // 'J'
+#define TDMA_JOIN_OFFSET_TAG        0
+#define TDMA_JOIN_OFFSET_ID         1          // 4 bytes, LSB first
+#define TDMA_JOIN_BYTES             5
+
+// the data packet a node sends in its slot
+#define TDMA_DATA_TAG               0x44       // 'D'
+#define TDMA_DATA_OFFSET_TAG        0
+#define TDMA_DATA_OFFSET_SLOT       1
+#define TDMA_DATA_OFFSET_PAYLOAD    2
+#define TDMA_MAX_DATA_BYTES         (RADIO_MAX_PAYLOAD_BYTES-TDMA_DATA_OFFSET_PAYLOAD)
+
+// which part we play
+enum TDMA_ROLE {
+    TDMA_ROLE_NONE=0,          // not started
+    TDMA_ROLE_COORDINATOR=1,   // sends the beacons, hands out the slots and hears the data
+    TDMA_ROLE_NODE=2,          // asks for a slot and sends its data in it
+};
+
+// how far along we are
+enum TDMA_STATE {
+    TDMA_STATE_STOPPED=0,      // not started
+    TDMA_STATE_SEARCHING=1,    // a node listening all the time for beacons until it is synchronized
+    TDMA_STATE_JOINING=2,      // a node following the superframes and asking for a slot
+    TDMA_STATE_JOINED=3,       // a node with a slot
+    TDMA_STATE_COORDINATING=4, // the coordinator
+};
+
+// what the RADIO does in a window
+enum TDMA_ACTIVITY {
+    TDMA_ACTIVITY_LISTEN=0,
+    TDMA_ACTIVITY_SEND_BEACON=1,
+    TDMA_ACTIVITY_SEND_JOIN=2,
+    TDMA_ACTIVITY_SEND_DATA=3,
+};
+
+// A note on TDMA. When ten micro:bits all send whenever they like their packets run into 
+// each other and most are lost, more the more there are. TDMA (Time Division Multiple 
+// Access) gives each of them a time of its own to send in so nothing ever collides.
+//
+// Time is cut into superframes and each superframe into slots of TDMA_SLOT_TICKS:
+//
+//    | beacon | join | data 0 | data 1 | ... | data n-1 | beacon | join | data 0 | ...
+//
+// The COORDINATOR sends a beacon in slot 0 and listens for the rest. The beacon is a 
+// YakIO_TIMESYNC beacon so everyone keeps to the coordinator's clock. After the time sync
+// bytes it says when the superframe started, how many data slots it has, which are taken
+// and who the last join was for. Each NODE listens to the beacon and sends in its own data
+// slot - every superframe, with an empty packet if it has no data, so the coordinator 
+// knows it is still there. A node the coordinator has not heard for TDMA_SLOT_TIMEOUT 
+// superframes loses its slot.
+//
+// Joining. A node starts out SEARCHING, listening all the time. Once YakIO_TIMESYNC says
+// it is synchronized it follows the superframes and sends a join request with its node id
+// in the join slot. Two nodes could pick the same superframe and collide so each one 
+// waits a random number of superframes first, from a window which doubles every try 
+// (like Ethernet). The coordinator gives it the first free data slot and the next beacon
+// says so. If a beacon says its slot is not taken any more it joins again and if it does
+// not hear a beacon for TDMA_BEACON_TIMEOUT superframes it goes back to searching.
+//
+// The superframe is only as long as it needs to be - n is one more than the highest data 
+// slot taken - so with n nodes, at the default 1Mbit and 32 byte packets:
+//
+//    superframe      = (2+n) * TDMA_SLOT_TICKS = (2+n) * 678us
+//    each node       = TDMA_MAX_DATA_BYTES (30) bytes every superframe
+//    all nodes       = n*30 bytes every superframe, 39kbytes/s at n=16 and never more than 44
+//    latency         = QueueData() to on the air is under two superframes, 24ms at n=16
+//
+// and none of it changes with how busy the nodes are. Ten nodes get 3.6kbytes/s each, 
+// guaranteed, where ten sending at random would get a lot less.
+//
+// The timing is done by the hardware. In each slot the RADIO is on for one window:
+//
+//    | guard | ramp up | packet                  | guard | turnaround |
+//    ^ RXEN  ^ TXEN                                      ^ DISABLE
+//
+// The TIMER0 COMPARE[0] event starts the RADIO through the pre-programmed PPI channel 20
+// (TXEN) or 21 (RXEN) - see YakIO_TIMESYNC SetAlarm() - and COMPARE[2] stops it through
+// programmable channel TDMA_PPI_CHANNEL_DISABLE. The listener is ready a guard time before 
+// the sender starts and stays on a guard time after the longest packet would end, so the
+// two boards' clocks can be TDMA_GUARD_TICKS apart. YakIO_TIMESYNC keeps them within a 
+// couple. The interrupts only get the next window ready and are never on time critical 
+// paths. The coordinator listens in one long window from the join slot to the end.
+//
+// The slot times assume 1Mbit, at 2Mbit they are just more generous than they need to be.
+// Every board must be built with the same TDMA_ defines.
+// YakIO_TDMA uses the RADIO and YakIO_TIMESYNC on its own - do not Transmit(), 
+// StartReceive() or SendBeacon() yourself while it is running. Call GetReceivedData() 
+// often from the MainLoop(), it is how the beacons and join requests get looked at. On 
+// the coordinator it returns the data packets, release each one before the next slot 
+// ends or the RADIO has nowhere to put the one after.
+//
+// Example:
+//      in the Main class:     YakIO_RADIO radioObj {};
+//                             YakIO_TIMESYNC timeSyncObj {&radioObj};
+//                             YakIO_TDMA tdmaObj {&radioObj, &timeSyncObj};
+//      in MainLoop():         radioObj.Start();
+//                             tdmaObj.Start(TDMA_ROLE_NODE, myNodeId);
+//      in the loop:           struct YakIO_RADIOPACKET *packetPtr = tdmaObj.GetReceivedData();
+//                             if(packetPtr!=NULL)
+//                             {
+//                                 ... from slot packetPtr->payloadBytes[TDMA_DATA_OFFSET_SLOT]
+//                                 ... the data starts at packetPtr->payloadBytes[TDMA_DATA_OFFSET_PAYLOAD]
+//                                 tdmaObj.ReleaseData();
+//                             }
+//                             if(tdmaObj.IsDataQueued()==0) tdmaObj.QueueData(readingBytes, 4);
+
+/* YakIO_TDMA - a class to share the RADIO between micro:bits with 
+ *     time slots
+ * */
+class YakIO_TDMA : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_RADIO *radioObjPtr =NULL;
+      YakIO_TIMESYNC *timeSyncObjPtr =NULL;
+      YakIO_PPI ppiObj {};
+      enum TDMA_ROLE tdmaRole = TDMA_ROLE_NONE;
+      // the alarm (TIMER0 interrupt) plans the windows and changes the state, the 
+      // superframe, the slot and the counts while the MainLoop() polls them with 
+      // GetState(), IsDataQueued() and the rest outside a critical section, so they 
+      // must be volatile. Everything else is only shared inside EnterCritical()
+      volatile enum TDMA_STATE tdmaState = TDMA_STATE_STOPPED;
+      unsigned int nodeId =0;
+      unsigned int randomState =0;
+      // the superframe we are in, or about to be in. Network times
+      unsigned int superframeStart =0;
+      volatile unsigned int superframeSlots =0;
+      volatile unsigned int superframeCount =0;
+      enum TDMA_ACTIVITY activityType[TDMA_MAX_ACTIVITIES];
+      unsigned int activityFirstSlot[TDMA_MAX_ACTIVITIES];
+      unsigned int activityLastSlot[TDMA_MAX_ACTIVITIES];
+      unsigned int activityCount =0;
+      unsigned int activityIndex =0;
+      unsigned int activityHasData =0;
+      unsigned int windowIsOpen =0;
+      unsigned int windowEndTime =0;      // our TIMER0 count
+      // what the last beacon said, a node only
+      unsigned int beaconIsNew =0;
+      unsigned int beaconStart =0;
+      unsigned int beaconSlots =0;
+      unsigned int beaconSuperframe =0;
+      // our slot, a node only
+      volatile unsigned int dataSlot =TDMA_NO_SLOT;
+      unsigned int joinWindow =TDMA_MIN_JOIN_WINDOW;
+      unsigned int joinWait =0;
+      unsigned char dataBytes[TDMA_MAX_DATA_BYTES];
+      unsigned int dataLength =0;
+      volatile unsigned int dataIsQueued =0;
+      // the slots, the coordinator only
+      unsigned int slotOwner[TDMA_MAX_NODES];
+      volatile unsigned int slotLastHeard[TDMA_MAX_NODES]; // the MainLoop() writes these, the alarm reads them
+      unsigned int joinReplyId =0;
+      unsigned int joinReplySlot =TDMA_NO_SLOT;
+      volatile unsigned int missedWindowCount =0;
+      volatile unsigned int sentDataCount =0;
+      unsigned int GetTicksForSlots(unsigned int dataSlotCount);
+      unsigned int GetRandom(void);
+      void StartSearching(void);
+      void StopWindows(void);
+      void PlanNextWindow(void);
+      unsigned int BuildSuperframe(void);
+      unsigned int ArmWindow(void);
+      unsigned int ArmTransmit(void);
+      unsigned int HandleControlPacket(struct YakIO_RADIOPACKET *packetPtr);
+      void HandleBeacon(struct YakIO_RADIOPACKET *packetPtr);
+      void HandleJoin(unsigned int joinId);
+
+  public:
+      // Constructor to initialize YakIO_TDMA object
+      YakIO_TDMA(YakIO_RADIO *radioObjPtrIn, YakIO_TIMESYNC *timeSyncObjPtrIn);
+      void Start(enum TDMA_ROLE tdmaRoleIn, unsigned int nodeIdIn);
+      void Stop(void);
+      unsigned int QueueData(const unsigned char *dataBytesIn, unsigned int dataLengthIn);
+      unsigned int IsDataQueued(void);
+      struct YakIO_RADIOPACKET *GetReceivedData(void);
+      void ReleaseData(void);
+      enum TDMA_ROLE GetRole(void);
+      enum TDMA_STATE GetState(void);
+      unsigned int GetSlot(void);
+      unsigned int GetNodeCount(void);
+      unsigned int GetSuperframeTicks(void);
+      unsigned int GetSuperframeCount(void);
+      unsigned int GetMissedWindowCount(void);
+      unsigned int GetSentDataCount(void);
+      void Callback0(void) override;
+};
+
+#endif
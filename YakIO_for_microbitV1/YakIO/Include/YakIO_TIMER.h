@@ -98,6 +98,11 @@ enum TIMER_MODE {
 // See the link below: 
 //    https://devzone.nordicsemi.com/f/nordic-q-a/18237/timer-with-two-compared-values
 
+// When an interrupt is taken the CPU pushes eight registers onto the stack
+// of whatever code it interrupted. This is the "exception frame". The
+// interrupted code's PC is the seventh word in it. See GetInterruptedPC()
+#define TIMER_EXCEPTION_FRAME_PC_INDEX 6
+
 
 /* YakIO_TIMER - a class to represent and encapsulate Timer
  *     information and actions.
@@ -111,6 +116,7 @@ class YakIO_TIMER
       YakIO_CALLBACK *callbackInterfacePtr =0;
       enum CALLBACK_ID callbackID = CALLBACK_NONE;
       unsigned int timerRegisterAddress=0;
+      unsigned int *interruptedFramePtr =0;
       void ResetAllShorts();
       void ResetAllINTENs(void);
 
@@ -127,6 +133,7 @@ class YakIO_TIMER
       unsigned int GetPrescaler(void);
       void SetCountLevel(unsigned int countLevelValue);
       unsigned int GetCountLevel(void);
+      unsigned int GetCount(void);
       void TimerStart(void);
       void TimerStop(void);
       void TimerClear(void);
@@ -143,6 +150,8 @@ class YakIO_TIMER
       void ClearCallbackByID(enum CALLBACK_ID callbackIDIn);
       void EnableTimerIRQ(void);
       void DisableTimerIRQ(void);
+      void HandleTimerIRQ(unsigned int *exceptionFramePtr);
+      unsigned int GetInterruptedPC(void);
 
 };
 
@@ -0,0 +1,178 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_TIMESYNC_H
+#define YAKIO_TIMESYNC_H
+
+#include "YakIO.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_PPI.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_TIMER.h"
+
+#define TIMESYNC_TIMER_PRESCALER    4          // TIMER0 at 1MHz, a tick is a microsecond
+#define TIMESYNC_BEACON_TAG         0x54       // 'T', the first byte of every beacon
+#define TIMESYNC_BEACON_BYTES       7
+#define TIMESYNC_BEACON_OFFSET_TAG       0
+#define TIMESYNC_BEACON_OFFSET_SEQUENCE  1
+#define TIMESYNC_BEACON_OFFSET_FLAGS     2
+#define TIMESYNC_BEACON_OFFSET_TIME      3     // 4 bytes, least significant first
+#define TIMESYNC_FLAG_TIME_VALID    0x01       // the time is that of the beacon before this one
+#define TIMESYNC_SKEW_SHIFT         24         // the skew is in units of 2^-24, about 0.06ppm
+#define TIMESYNC_SKEW_FILTER_SHIFT  2          // each new estimate moves the skew a quarter of the way
+#define TIMESYNC_MIN_SAMPLE_TICKS   1000       // samples closer together than this tell us nothing about the skew
+#define TIMESYNC_MAX_SKEW           16777      // 1000ppm. Anything more is nonsense and we start again
+#define TIMESYNC_MIN_ALARM_TICKS    20         // an alarm closer than this might be missed, SetAlarm() refuses it
+
+// the TIMER0 CC[n] registers we use. CC[1] because the pre-programmed PPI channel 26 
+// captures into it, CC[3] to read the time now and CC[0] for SetAlarm() - the 
+// pre-programmed PPI channels 20 and 21 start the RADIO from its COMPARE event. CC[2]
+// is left for whoever wants to stop the RADIO at a given time (see YakIO_TDMA)
+#define TIMESYNC_CAPTURE_TASK_NOW   TIMERREG_OFFSET_CAPTURE_3
+#define TIMESYNC_CC_NOW             TIMERREG_OFFSET_CC_3
+#define TIMESYNC_CC_ADDRESS         TIMERREG_OFFSET_CC_1
+#define TIMESYNC_CC_ALARM           TIMERREG_OFFSET_CC_0
+
+// the receiving RADIO sets ADDRESS a little after the sending one does. It is the same 
+// every time so it can be taken off. Define it before this file is included if you 
+// have measured it for your boards
+#ifndef TIMESYNC_RX_DELAY_TICKS
+#define TIMESYNC_RX_DELAY_TICKS     0
+#endif
+
+// which end of the synchronization we are
+enum TIMESYNC_ROLE {
+    TIMESYNC_ROLE_NONE=0,      // not started
+    TIMESYNC_ROLE_REFERENCE=1, // our time is the network time, we send the beacons
+    TIMESYNC_ROLE_FOLLOWER=2,  // we listen to the beacons and follow the reference
+};
+
+// A note on TIME SYNC. Every micro:bit has its own 16MHz crystal and no two run at quite 
+// the same speed - 20 or 30 parts per million apart is normal, so two TIMERs started 
+// together are tens of microseconds apart after a second. This class gives a group of 
+// micro:bits one shared "network time", in microseconds, good to a microsecond or two.
+//
+// One micro:bit is the REFERENCE. Its TIMER0 simply is the network time and it sends a
+// small beacon every so often with SendBeacon(). The others are FOLLOWERs. They hand
+// every packet they receive to ProcessPacket() and GetNetworkTime() works out the 
+// reference's time from their own TIMER0.
+//
+// The trick is knowing exactly when a beacon was sent and when it arrived. Doing that 
+// in software (read the timer in an interrupt) would be out by however long the 
+// interrupt took to get going, which varies. Instead the pre-programmed PPI channel 26
+// wires the RADIO ADDRESS event to the TIMER0 CAPTURE[1] task. The address goes past
+// both RADIOs at the same moment and both TIMERs are captured then, by the hardware, 
+// with no jitter at all. YakIO_RADIO keeps the captured count with each packet.
+//
+// The reference only knows when a beacon went out after it has gone, so each beacon 
+// carries the time the PREVIOUS one was sent (this is the "two step" of IEEE 1588). A 
+// follower remembers when each beacon arrived by its own clock and when the next one 
+// arrives it has a pair - our time and the reference's time for the same instant. The 
+// latest pair gives the offset. The change between the last two pairs gives how much
+// faster or slower the reference is running (the skew) and GetNetworkTime() scales
+// the time since the latest pair by that. The skew is averaged over a few beacons
+// because each pair is only good to a tick.
+//
+// Beacon (TIMESYNC_BEACON_BYTES of payload):
+//
+//    tag 0x54 | sequence | flags | time of the previous beacon (4 bytes, LSB first)
+//
+// SendBeacon() can put more bytes after these for whoever else wants to use the beacon 
+// and ProcessPacket() takes any packet at least this long with the right tag.
+//
+// A lost beacon just means one pair is missed. A beacon every second or so is plenty,
+// a second at 30ppm is 30 microseconds so the skew matters far more than the rate.
+//
+// TIMER0 belongs to this class - do not make a YakIO_TIMER for it anywhere else. It runs
+// at 1MHz in 32 bit mode and wraps every 71 minutes. All of the times wrap with it so 
+// subtract them, never compare them. The YAKIO_RADIO must already be Start()ed. Call 
+// ProcessPacket() and GetNetworkTime() from the MainLoop(), not from an interrupt - a 
+// beacon changes several numbers GetNetworkTime() uses.
+//
+// Alarms. SetAlarm() calls the callback, from the TIMER0 interrupt, when TIMER0 reaches 
+// a given count. Use NetworkToLocalTime() to have it happen at a network time. Only one
+// alarm can be set and it goes off once.
+//
+// Example:
+//      in the Main class:     YakIO_RADIO radioObj {};
+//                             YakIO_TIMESYNC timeSyncObj {&radioObj};
+//      in MainLoop():         radioObj.Start();
+//                             radioObj.StartReceive();
+//                             timeSyncObj.Start(TIMESYNC_ROLE_FOLLOWER);
+//      in the loop:           struct YakIO_RADIOPACKET *packetPtr = radioObj.GetReceivedPacket();
+//                             if(packetPtr!=NULL)
+//                             {
+//                                 timeSyncObj.ProcessPacket(packetPtr);
+//                                 radioObj.ReleasePacket();
+//                             }
+//                             if(timeSyncObj.IsSynchronized()!=0) ... timeSyncObj.GetNetworkTime()
+
+/* YakIO_TIMESYNC - a class to keep a network time across micro:bits 
+ *     with RADIO beacons
+ * */
+class YakIO_TIMESYNC : public YakIO_CALLBACK
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_CALLBACK *callbackInterfacePtr =NULL;
+      enum CALLBACK_ID callbackID = CALLBACK_NONE;
+      YakIO_RADIO *radioObjPtr =NULL;
+      YakIO_TIMER timeBaseObj;
+      YakIO_PPI ppiObj {};
+      // everything below is only changed from the MainLoop() (Start(), SendBeacon() and 
+      // ProcessPacket()). The TIMER0 interrupt only calls the callback so, unlike the 
+      // YakIO_RADIO counts and timestamps we read, none of it needs to be volatile
+      enum TIMESYNC_ROLE syncRole = TIMESYNC_ROLE_NONE;
+      unsigned int beaconSequence =0;
+      unsigned int beaconTxCount =0;     // the RADIO TX count once our last beacon has gone
+      unsigned int beaconIsSent =0;
+      unsigned int lastRxSequence =0;
+      unsigned int lastRxLocalTime =0;
+      unsigned int lastRxIsValid =0;
+      unsigned int anchorLocalTime =0;
+      unsigned int anchorNetworkTime =0;
+      int skewValue =0;
+      unsigned int sampleCount =0;
+      int lastSyncError =0;
+      unsigned int beaconCount =0;
+      void AddSample(unsigned int localTime, unsigned int networkTime);
+
+  public:
+      // Constructor to initialize YakIO_TIMESYNC object
+      YakIO_TIMESYNC(YakIO_RADIO *radioObjPtrIn);
+      void SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void CallCallback();
+      void ClearAllCallbacks(void);
+      void Start(enum TIMESYNC_ROLE syncRoleIn);
+      void Stop(void);
+      unsigned int SendBeacon(void);
+      unsigned int SendBeacon(const unsigned char *extraBytes, unsigned int extraLength);
+      unsigned int ProcessPacket(struct YakIO_RADIOPACKET *packetPtr);
+      unsigned int IsSynchronized(void);
+      enum TIMESYNC_ROLE GetRole(void);
+      unsigned int GetLocalTime(void);
+      unsigned int GetNetworkTime(void);
+      unsigned int LocalToNetworkTime(unsigned int localTime);
+      unsigned int NetworkToLocalTime(unsigned int networkTime);
+      int GetSkewPpb(void);
+      int GetLastSyncError(void);
+      unsigned int GetBeaconCount(void);
+      unsigned int SetAlarm(unsigned int localTime);
+      void ClearAlarm(void);
+      void Callback0(void) override;
+};
+
+#endif
@@ -0,0 +1,171 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_TRACE_H
+#define YAKIO_TRACE_H
+
+#include "YakIO.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_UART.h"
+#include "YakIO_Utils.h"
+
+// A note on the TRACE. Some problems are about the ORDER things happen in - "the Heartbeat
+// ran late because the RNG Callback0() took too long" - and you cannot see that with a
+// debugger or a profiler. YakIO_TRACE records a timestamped entry every time something 
+// interesting happens into a circular buffer in RAM. Drain() sends them out of the serial 
+// port and the TraceToJson.py script in the directory above YakIO turns them into a file 
+// the Chrome (chrome://tracing) or Perfetto (ui.perfetto.dev) trace viewers can show as a 
+// timeline.
+//
+// Each entry is 8 bytes: the 32 bit count of a TIMER running at 16MHz, a 16 bit event ID and
+// a 16 bit argument. The events come from two places:
+//
+//   1) the YakIO library itself. The interrupt handlers record TRACE_IRQ_ENTRY and 
+//      TRACE_IRQ_EXIT (the argument is the IRQ number) and CallCallback() records 
+//      TRACE_CALLBACK_ENTRY and TRACE_CALLBACK_EXIT (the argument is the CALLBACK_ID). These
+//      are only compiled in if YAKIO_TRACE is defined when the library is built. Use 
+//      "make TRACE=1 ..." (see the Makefile) or add -DYAKIO_TRACE to the YAKIO_COMPILE_FLAGS 
+//      in CompileYakIO.bat and CompileProgram.bat. Without it they cost nothing at all.
+//   2) your own code. MarkBegin() and MarkEnd() record the start and end of something (the 
+//      viewer shows it as a bar) and Mark() records a single point in time with an argument.
+//      Your IDs must be TRACE_USER_FIRST_ID or more. These always work.
+//
+// Recording an entry is done with the interrupts disabled (it only takes a few instructions)
+// so any interrupt handler can record at any time. It costs about 16 cycles - most of that 
+// is the two TIMER register accesses, peripheral registers are slower than RAM. That is 
+// why Record() is defined here in the .h file rather than in the .cpp - so it is inlined 
+// and there is no function call on top.
+//
+// The buffer never fills up. New entries just overwrite the oldest ones. Drain() keeps track
+// of what it has sent and, if the entries it has not sent yet get overwritten, sends a 
+// TRACE_LOST entry saying how many went missing. At 115200 baud the serial port can only 
+// send about 1200 entries a second. A 1 millisecond Heartbeat alone makes 4000 so you 
+// usually want to Stop() the trace when something interesting has happened and then Drain()
+// what is in the buffer - like the "flight recorder" on an aircraft. 
+//
+// Drain() sends the entries in binary - each one is TRACE_SYNC_BYTE followed by the 8 bytes
+// of the entry, least significant byte first. Save the raw serial port output to a file 
+// (a terminal program that shows text will make a mess of it). On Linux:
+//
+//      stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > trace.bin
+//
+// Example:
+//      in the Main class:     YakIO_TRACE trace {Timer0};
+//      in MainLoop():         trace.Start();
+//      anywhere:              trace.MarkBegin(TRACE_USER_FIRST_ID);
+//                             ... something you want to see on the timeline
+//                             trace.MarkEnd(TRACE_USER_FIRST_ID);
+//      later:                 trace.Stop();
+//                             trace.Drain(uart, 0);
+
+// the number of entries in the buffer. Each one is 8 bytes. It MUST be a power 
+// of two. Define it before this file is included to change it
+#ifndef TRACE_BUFFER_ENTRIES
+#define TRACE_BUFFER_ENTRIES    128
+#endif
+#define TRACE_BUFFER_MASK       (TRACE_BUFFER_ENTRIES-1)
+#define TRACE_SYNC_BYTE         0xA5
+#define TRACE_ENTRY_BYTES       8
+
+// the event IDs the library records. Your own IDs start at TRACE_USER_FIRST_ID
+enum TRACE_EVENT_ID {
+    TRACE_NONE=0,
+    TRACE_IRQ_ENTRY=1,            // an interrupt handler has started, the argument is the IRQ number
+    TRACE_IRQ_EXIT=2,             // an interrupt handler has finished, the argument is the IRQ number
+    TRACE_CALLBACK_ENTRY=3,       // CallCallback() is calling a callback, the argument is the CALLBACK_ID
+    TRACE_CALLBACK_EXIT=4,        // the callback has returned, the argument is the CALLBACK_ID
+    TRACE_USER_BEGIN=5,           // MarkBegin(), the argument is your ID
+    TRACE_USER_END=6,             // MarkEnd(), the argument is your ID
+    TRACE_LOST=7,                 // made by Drain(), the argument is the number of entries lost (at most 0xFFFF)
+    TRACE_START=8,                // Start() was called
+    TRACE_USER_FIRST_ID=0x100     // Mark() IDs must be this or more
+};
+
+// one entry in the buffer
+struct YakIO_TRACEENTRY
+{
+    unsigned int timeStamp;       // the count of the trace TIMER, 16MHz
+    unsigned int eventIDAndArg;   // the event ID in the bottom 16 bits, the argument in the top 16
+};
+
+/* YakIO_TRACE - a class to record timestamped events into a circular
+ *     buffer and send them out of the serial port
+ * */
+class YakIO_TRACE
+{
+  private:
+      unsigned int isInitialized =0;
+      YakIO_TIMER timeStampTimerObj;
+      unsigned int timeStampRegisterAddress =0;
+      unsigned int writeCount =0;
+      unsigned int drainCount =0;
+      unsigned int lostCount =0;
+      YakIO_TRACEENTRY traceEntries[TRACE_BUFFER_ENTRIES];
+      void SendEntry(YakIO_UART &uart, unsigned int timeStamp, unsigned int eventIDAndArg);
+
+  public:
+      // Constructor to initialize YakIO_TRACE object
+      YakIO_TRACE(enum TIMER timeStampTimerIDIn);
+      void Start(void);
+      void Stop(void);
+      void Clear(void);
+      inline void Record(unsigned int eventID, unsigned int eventArg);
+      void Mark(unsigned int userEventID, unsigned int eventArg);
+      void MarkBegin(unsigned int userEventID);
+      void MarkEnd(unsigned int userEventID);
+      unsigned int Drain(YakIO_UART &uart, unsigned int maxEntries);
+      unsigned int GetWriteCount(void);
+      unsigned int GetLostCount(void);
+};
+
+// the trace the library hooks record to. Set by Start(), NULL when stopped.
+// There can only be one running at a time
+extern YakIO_TRACE *trace_ptr;
+
+    /* Record - adds an entry to the buffer. Called by the YAKIO_TRACE_EVENT()
+     *    hooks in the library and by Mark(), MarkBegin() and MarkEnd(). Safe
+     *    to call from anywhere, including interrupt handlers.
+     *
+     *    NOTE: this is here in the .h file, not in the .cpp, so it is 
+     *    inlined. See the note on the TRACE above
+     *
+     * inputs:
+     *    eventID - the event ID, see enum TRACE_EVENT_ID
+     *    eventArg - the argument, only the bottom 16 bits are kept
+     * */
+    inline void YakIO_TRACE::Record(unsigned int eventID, unsigned int eventArg)
+    {
+        // an interrupt could come in and record an entry between the time 
+        // we pick a slot and fill it. So we do not let one
+        unsigned int primaskState = EnterCritical();
+        YAKIO_REGISTER(timeStampRegisterAddress+TIMERREG_OFFSET_CAPTURE_3) = 1;
+        unsigned int writeIndex = writeCount;
+        YakIO_TRACEENTRY *entryPtr = &traceEntries[writeIndex & TRACE_BUFFER_MASK];
+        entryPtr->timeStamp = YAKIO_REGISTER(timeStampRegisterAddress+TIMERREG_OFFSET_CC_3);
+        entryPtr->eventIDAndArg = (eventArg<<16) | eventID;
+        writeCount = writeIndex + 1;
+        ExitCritical(primaskState);
+    }
+
+// the hook the library code uses. It is compiled out completely unless 
+// YAKIO_TRACE is defined. See the note on the TRACE above
+#ifdef YAKIO_TRACE
+  #define YAKIO_TRACE_EVENT(eventID, eventArg) do { YakIO_TRACE *tracePtr = trace_ptr; if(tracePtr!=NULL) tracePtr->Record((eventID), (eventArg)); } while(0)
+#else
+  #define YAKIO_TRACE_EVENT(eventID, eventArg) do { } while(0)
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#ifndef YAKIO_UART_H
+#define YAKIO_UART_H
+
+#include "YakIO.h"
+#include "YakIO_Utils.h"
+#include "YakIO_CALLBACK.h"
+#include "YakIO_NVIC.h"
+
+// UART REGISTER SPECIFIC SECTION
+#define UARTREG_OFFSET_STARTRX      0x000 // Start UART receiver
+#define UARTREG_OFFSET_STOPRX       0x004 // Stop UART receiver
+#define UARTREG_OFFSET_STARTTX      0x008 // Start UART transmitter
+#define UARTREG_OFFSET_STOPTX       0x00C // Stop UART transmitter
+#define UARTREG_OFFSET_SUSPEND      0x01C // Suspend UART
+#define UARTREG_OFFSET_CTS          0x100 // CTS is activated (set low). Clear To Send
+#define UARTREG_OFFSET_NCTS         0x104 // CTS is deactivated (set high). Not Clear To Send
+#define UARTREG_OFFSET_RXDRDY       0x108 // Data received in RXD
+#define UARTREG_OFFSET_TXDRDY       0x11C // Data sent from TXD
+#define UARTREG_OFFSET_ERROR        0x124 // Error detected
+#define UARTREG_OFFSET_RXTO         0x144 // Receiver timeout
+#define UARTREG_OFFSET_INTENSET     0x304 // Enable interrupt
+#define UARTREG_OFFSET_INTENCLR     0x308 // Disable interrupt
+#define UARTREG_OFFSET_ERRORSRC     0x480 // Error source
+#define UARTREG_OFFSET_ENABLE       0x500 // Enable UART
+#define UARTREG_OFFSET_PSELRTS      0x508 // Pin select for RTS
+#define UARTREG_OFFSET_PSELTXD      0x50C // Pin select for TXD
+#define UARTREG_OFFSET_PSELCTS      0x510 // Pin select for CTS
+#define UARTREG_OFFSET_PSELRXD      0x514 // Pin select for RXD
+#define UARTREG_OFFSET_RXD          0x518 // RXD register
+#define UARTREG_OFFSET_TXD          0x51C // TXD register
+#define UARTREG_OFFSET_BAUDRATE     0x524 // Baud rate
+#define UARTREG_OFFSET_CONFIG       0x56C // Configuration of parity and hardware flow control
+
+#define UART_ENABLE_VALUE       0x04       // the value in ENABLE that turns the UART on
+#define UART_INTEN_RXDRDY_BIT   0x04       // the RXDRDY bit in INTENSET and INTENCLR
+#define UART_PSEL_DISCONNECTED  0xFFFFFFFF // a PSEL??? value which connects nothing
+
+// On the microbit the UART is wired to the USB interface chip. Whatever
+// we send appears on the serial port the PC sees when you plug it in and
+// anything typed into that port arrives on the RX pin. These are GPIO
+// numbers, not edge connector pin numbers. See the enum GPIOPin in YakIO_GPIO.h
+#define UART_MICROBIT_TX_GPIO   24
+#define UART_MICROBIT_RX_GPIO   25
+
+// note the value here is carefully set to the value we have to
+// stuff in the register to set the baud rate properly. These come
+// from the BAUDRATE register description in the nrf51 reference manual
+enum UART_BAUDRATE {
+    UART_BAUDRATE_9600=0x00275000,
+    UART_BAUDRATE_19200=0x004EA000,
+    UART_BAUDRATE_38400=0x009D5000,
+    UART_BAUDRATE_57600=0x00EBF000,
+    UART_BAUDRATE_115200=0x01D7E000
+};
+
+// A note on the UART. The UART sends and receives bytes one bit at a time over a single
+// wire in each direction. 8 data bits, no parity and one stop bit ("8N1") is used here
+// which is what every serial terminal program defaults to. Set the terminal to the same
+// baud rate you give to Start().
+//
+// Sending is done one byte at a time and WriteByte() waits until each one has gone. At
+// 115200 baud a byte takes about 87 microseconds (about 1390 CPU cycles) so do NOT call
+// these from an interrupt handler and do not put them inside something you are timing.
+//
+// WriteUnsigned() prints a number in decimal. The Cortex-M0 has no divide instruction so
+// rather than divide by 10 over and over it counts how many times each power of ten can
+// be subtracted.
+//
+// Receiving can be polled with TryReadByte(), which never waits. Or SetCallback() can be 
+// used to have a function called from the UART interrupt when a byte arrives. That function
+// MUST take the byte with TryReadByte() - the interrupt keeps happening for as long as there
+// is a byte waiting. ClearAllCallbacks() turns the interrupt off again. This is how the 
+// ReadByte() awaiter in YakIO_TASK.h wakes a task.
+//
+// Example:
+//      in the Main class:     YakIO_UART uart {};
+//      in MainLoop():         uart.Start(UART_BAUDRATE_115200);
+//                             uart.WriteString("count=");
+//                             uart.WriteUnsigned(someCount);
+//                             uart.WriteNewLine();
+
+/* YakIO_UART - a class to represent and encapsulate the UART
+ *     peripheral
+ * */
+class YakIO_UART
+{
+  private:
+      unsigned int isInitialized =0;
+      unsigned int isStarted =0;
+      YakIO_CALLBACK *callbackInterfacePtr =0;
+      enum CALLBACK_ID callbackID = CALLBACK_NONE;
+
+  public:
+      // Constructor to initialize YakIO_UART object
+      YakIO_UART();
+      void Start(enum UART_BAUDRATE baudRate);
+      void Stop(void);
+      void WriteByte(unsigned char byteValue);
+      void WriteString(const char *stringPtr);
+      void WriteUnsigned(unsigned int numberValue);
+      void WriteHex(unsigned int numberValue);
+      void WriteNewLine(void);
+      unsigned int TryReadByte(unsigned char &byteValue);
+      void SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn);
+      void CallCallback();
+      void ClearAllCallbacks(void);
+      void HandleUartIRQ(void);
+};
+
+#endif
@@ -25,6 +25,95 @@
 void EnableIRQ(int irqNum);
 void DisableIRQ(int irqNum);
 void ClearPendingIRQ(int irqNum);
+void SetIRQPriority(int irqNum, enum IRQ_PRIORITY irqPriority);
+unsigned int GetBootCycles(void);
+unsigned int GetStackHighWater(void);
+unsigned int GetStackReserveSize(void);
+unsigned int IsStackCanaryIntact(void);
+
+// A note on the STACK. Every function call, every local variable and every object created
+// inside a function (including the Main object itself, see program.cpp) lives on the stack. 
+// The stack starts at the very top of the RAM and grows down towards the .bss section. Nothing
+// stops it - if it grows too far it silently overwrites your global variables (or the heap) 
+// and things go wrong in very strange ways.
+//
+// The linker script (microbit.ld) holds back __stackReserveSize__ bytes (4K by default) for 
+// the stack and refuses to link if there is not that much RAM left over. The bottom of the 
+// reserve is the "stack limit". Very early on, the startup code fills the unused part of the
+// reserve with the STACK_PAINT_PATTERN. Anything the stack touches gets overwritten so:
+//
+//    GetStackHighWater() - looks for the lowest word that no longer holds the pattern and 
+//       returns the most bytes of stack that have ever been used. Compare this with 
+//       GetStackReserveSize() to see your margin. It searches the reserve so it is not quick.
+//    IsStackCanaryIntact() - checks the STACK_CANARY_WORDS words at the stack limit. If any 
+//       of them has changed the stack has used the whole reserve and probably more. This is
+//       quick. See YakIO_STACKGUARD for a way to check it regularly from a timer.
+//
+// Note a function with a big local array might jump right over the canary without writing 
+// to it, so a good canary does not prove all is well. The high water mark tells you how 
+// close you have come.
+#define STACK_PAINT_PATTERN 0xC5C5C5C5
+#define STACK_CANARY_WORDS 8
+
+// A note on CRITICAL SECTIONS. Sometimes the MainLoop() needs to read or write something
+// that an interrupt handler also reads or writes. If that "something" is bigger than a single
+// 32 bit word (a struct, an array or a 64 bit value) then an interrupt can fire half way through
+// the access and the MainLoop() ends up with half old and half new data. This is called "tearing".
+//
+// The traditional cure is to turn off the interrupts while you touch the shared data. On the
+// Cortex-M0 this is done by setting the PRIMASK register with the "cpsid i" instruction and
+// turned back on again with "cpsie i". While PRIMASK is set no interrupts (other than NMI and 
+// HardFault) can run - they just wait until PRIMASK is cleared.
+//
+// EnterCritical() remembers the PRIMASK state as it found it and then disables interrupts. 
+// ExitCritical() puts it back the way it was. This means you can safely nest them.
+//
+// Example:
+//      unsigned int primaskState = EnterCritical();
+//      ... read or write the shared data ...
+//      ExitCritical(primaskState);
+//
+// Keep the code in between as short as you possibly can. Every cycle you spend in there is a 
+// cycle some interrupt is kept waiting. Also see YakIO_SEQLOCK.h for a way of sharing data with
+// an interrupt handler without disabling interrupts at all.
+//
+// These two are defined "inline" right here in the header rather than over in the .cpp file. 
+// This is deliberate. They are only two or three instructions long and the overhead of a 
+// normal function call would be several times bigger than the work they actually do.
+//
+// When compiled for the host (see YAKIO_HOST in YakIO.h) there is no PRIMASK and no 
+// interrupts to disable so these do nothing except act as compiler barriers.
+#ifndef YAKIO_HOST
+inline unsigned int EnterCritical(void)
+{
+    unsigned int primaskState;
+    // read the current PRIMASK value then disable interrupts. The "memory" clobber 
+    // stops the compiler moving any reads or writes of memory to before this point
+    asm volatile ("mrs %0, primask \n cpsid i" : "=r" (primaskState) : : "memory");
+    return primaskState;
+}
+inline void ExitCritical(unsigned int primaskState)
+{
+    // put PRIMASK back the way we found it. The "memory" clobber stops the compiler 
+    // moving any reads or writes of memory to after this point
+    asm volatile ("msr primask, %0" : : "r" (primaskState) : "memory");
+}
+#else
+inline unsigned int EnterCritical(void)
+{
+    asm volatile ("" : : : "memory");
+    return 0;
+}
+inline void ExitCritical(unsigned int primaskState)
+{
+    asm volatile ("" : : : "memory");
+}
+#endif
+
+// A compiler barrier. This emits no instructions at all but it tells the compiler it is not
+// permitted to move memory reads or writes from one side of it to the other. The Cortex-M0 
+// itself executes everything strictly in order so, on this CPU, this is all that is needed.
+#define COMPILER_BARRIER()      asm volatile ("" : : : "memory")
 
 // A note on DELAYS. Software "loop style" delays are tricky to time. The big problem
 // is that C++ function calls with parameters are slow (lots of state needs to be saved 
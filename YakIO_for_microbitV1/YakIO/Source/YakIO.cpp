@@ -37,11 +37,18 @@
 // processes are not available. Also, there is no memory management so things such as malloc() and free() are not available. Actually,
 // you can have all of the that functionality but you have to approach it differently.
 //
-// IMPORTANT NOTE: If you instantiate a class that uses a constructor on the heap (i.e. outside of a class) the constructor will NOT
-//    be run. The identification and execution of such constructors is a pretty intricate dance on the part of the C++ libraries and
-//    linker script and is just not available in bare metal programming. If you create objects as a class member variable then the 
-//    constructor will run. You might wish to review the "03_Danger" sample code to see the many bad things that happen if you create 
-//    classes with constructors on the heap.
+// A NOTE ON GLOBAL OBJECTS: Objects created outside of any class or function (global objects) DO have their constructors run. 
+//    The compiler puts the address of a little function which calls those constructors in a table in a section named .init_array
+//    and the RunStaticConstructors() function below calls each of them in turn before CreateMainObject() is called. Be aware that
+//    the order in which global objects in different .cpp files are created is not defined by C++ and that they are created before
+//    anything else in your program has run. It is still much better to create your objects as member variables of the Main class
+//    where they are created in the order you declare them. The "03_Danger" sample code has more on this.
+//
+// BOOT TIME: The time it takes to get from the first instruction in _StartYakIO() to the call to CreateMainObject() is measured 
+//    with TIMER0 and can be read with the GetBootCycles() function (see YakIO_Utils.h). This is mostly spent painting the stack
+//    (see the STACK notes in YakIO_Utils.h), copying the .data section, zeroing the .bss section and running the global 
+//    constructors. If you have big arrays which do not need to start off as zero you can put them in the .noinit section (see 
+//    the YAKIO_NOINIT notes in YakIO.h) and they will not be zeroed at all.
 // 
 // Credits:
 //   This startup code follows a predictable and fairly standard pattern. The bare bones of this code have been derived from 
@@ -54,6 +61,7 @@
 
 #include "YakIO.h"
 #include "YakIO_CLOCK.h"
+#include "YakIO_TIMER.h"
 
 extern "C" void _StartYakIO(void);
 extern "C" void CreateMainObject(void); 
@@ -66,6 +74,21 @@ extern unsigned char __topOfUnInitializedDataSection__[];
 extern unsigned char __bottomOfUnInitializedDataSection__[];
 extern unsigned char __bottomOfCodeSection__[];
 extern unsigned char __startOfStack__[];
+extern unsigned char __topOfInitArray__[];
+extern unsigned char __bottomOfInitArray__[];
+extern unsigned char __stackLimit__[];
+
+// the CPU cycles it took to boot. See GetBootCycles() in YakIO_Utils.cpp
+unsigned int bootCycles = 0;
+
+// global objects with destructors register them with this function so 
+// they can be run when the program exits. Our program never exits so we 
+// never run them and these exist only to keep the linker happy. 
+void *__dso_handle = NULL;
+extern "C" int __aeabi_atexit(void *objectPtr, void (*destructorPtr)(void *), void *dsoHandle)
+{
+    return 0;
+}
 
 /* startHFClock - start the High Frequency (HF) clock. This is the 16Mhz 
  *    crystal clock on the micobit
@@ -77,13 +100,13 @@ void startHFClock(void)
     // needed. Calling it does not seem to hurt anything. 
     
     // clear the HF Clock started event
-    (*(unsigned volatile *) (REGISTER_CLOCK+CLOCKREG_OFFSET_HFCLKSTARTED)) = 0;
+    YAKIO_REGISTER(REGISTER_CLOCK+CLOCKREG_OFFSET_HFCLKSTARTED) = 0;
     // start the HF Clock
-    (*(unsigned volatile *) (REGISTER_CLOCK+CLOCKREG_OFFSET_HFCLKSTART)) = 1;
+    YAKIO_REGISTER(REGISTER_CLOCK+CLOCKREG_OFFSET_HFCLKSTART) = 1;
     // wait for the clock to start
     while (1) 
     { 
-        if ((*(unsigned volatile *) (REGISTER_CLOCK+CLOCKREG_OFFSET_HFCLKSTARTED)) !=0) break;
+        if (YAKIO_REGISTER(REGISTER_CLOCK+CLOCKREG_OFFSET_HFCLKSTARTED) !=0) break;
     }
 }
 
@@ -104,13 +127,103 @@ void nRF51822Config(void)
     // Look up the differences between virtual memory address (VMA) and load memory address (LMA) 
     // if you want more information. https://mcyoung.xyz/2021/06/01/linker-script/ contains a good
     // summary
-    unsigned int dataSize = __bottomOfInitializedDataSection__ - __topOfInitializedDataSection__;
-    for (unsigned int i=0; i<dataSize; i++) __topOfInitializedDataSection__[i] = __bottomOfCodeSection__[i]; 
+    //
+    // The linker script makes sure both sections start and end on a 4 byte boundary so we can 
+    // copy and zero them a whole 32 bit word at a time. That is four times fewer loops than doing 
+    // it a byte at a time and, since a word access costs the same as a byte access, it is about 
+    // four times faster. The loops are also unrolled so that four words are done each time round.
+    unsigned int *srcPtr = (unsigned int *)__bottomOfCodeSection__;
+    unsigned int *destPtr = (unsigned int *)__topOfInitializedDataSection__;
+    unsigned int *endPtr = (unsigned int *)__bottomOfInitializedDataSection__;
+    while((endPtr-destPtr)>=4)
+    {
+        destPtr[0] = srcPtr[0];
+        destPtr[1] = srcPtr[1];
+        destPtr[2] = srcPtr[2];
+        destPtr[3] = srcPtr[3];
+        destPtr += 4;
+        srcPtr += 4;
+    }
+    while(destPtr<endPtr) *destPtr++ = *srcPtr++;
     
     // init our uninitialized variable space to 0. This is allocated in the RAM by the linker
-    // but the linker does nothing with it.
-    unsigned int bssSize = __bottomOfUnInitializedDataSection__ - __topOfUnInitializedDataSection__;
-    for (unsigned int i=0; i<bssSize; i++) __topOfUnInitializedDataSection__[i] = 0;     
+    // but the linker does nothing with it. Note that the .noinit section which follows it is 
+    // deliberately left alone.
+    destPtr = (unsigned int *)__topOfUnInitializedDataSection__;
+    endPtr = (unsigned int *)__bottomOfUnInitializedDataSection__;
+    while((endPtr-destPtr)>=4)
+    {
+        destPtr[0] = 0;
+        destPtr[1] = 0;
+        destPtr[2] = 0;
+        destPtr[3] = 0;
+        destPtr += 4;
+    }
+    while(destPtr<endPtr) *destPtr++ = 0;
+}
+
+/* RunStaticConstructors - runs the constructors of all of the global 
+ *    objects. The compiler puts a pointer to a function which does this 
+ *    for each .cpp file which has global objects in the .init_array section
+ *    and the linker gathers them all together between __topOfInitArray__ 
+ *    and __bottomOfInitArray__. We just call each one in order.
+ *
+ *    This must be called after nRF51822Config() since the constructors 
+ *    expect the .data and .bss sections to be set up already.
+ * */
+void RunStaticConstructors(void)
+{
+    typedef void (*INIT_FUNCTION)(void);
+    INIT_FUNCTION *functionPtr = (INIT_FUNCTION *)__topOfInitArray__;
+    INIT_FUNCTION *endPtr = (INIT_FUNCTION *)__bottomOfInitArray__;
+    for( ; functionPtr<endPtr; functionPtr++) (*functionPtr)();
+}
+
+/* PaintStack - fills the unused part of the stack reserve with the 
+ *    STACK_PAINT_PATTERN so GetStackHighWater() can see how far the stack
+ *    has grown. See the STACK notes in YakIO_Utils.h
+ *
+ *    We paint from the stack limit up to our own stack pointer. Everything
+ *    below the stack pointer is unused. This function calls nothing else 
+ *    so nothing below it will be used while we are in here.
+ * */
+void PaintStack(void)
+{
+    unsigned int *stackPointer;
+    asm volatile ("mov %0, sp" : "=r" (stackPointer));
+
+    unsigned int *wordPtr = (unsigned int *)__stackLimit__;
+    while(wordPtr<stackPointer) *wordPtr++ = STACK_PAINT_PATTERN;
+}
+
+/* StartBootTimer - starts TIMER0 counting every cycle of the 16MHz 
+ *    clock so we can see how long it takes to boot. Everything is still
+ *    at its reset value so we only have to set the parts we need
+ * */
+void StartBootTimer(void)
+{
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_BITMODE) = TIMER_BITMODE_32Bit;
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_PRESCALER) = 0;
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_START) = 1;
+}
+
+/* StopBootTimer - reads TIMER0 and then puts it back the way it came
+ *    out of reset so the user code never knows we borrowed it
+ * 
+ * returns:
+ *    the cycles counted since StartBootTimer()
+ * */
+unsigned int StopBootTimer(void)
+{
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_CAPTURE_0) = 1;
+    unsigned int cycleCount = YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_CC_0);
+
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_STOP) = 1;
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_CLEAR) = 1;
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_CC_0) = 0;
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_BITMODE) = TIMER_BITMODE_16Bit;
+    YAKIO_REGISTER(REGISTER_TIMER0+TIMERREG_OFFSET_PRESCALER) = 4;
+    return cycleCount;
 }
 
 /* _StartYakIO() - this gets called from the initial address set in the vector 
@@ -123,8 +236,20 @@ void nRF51822Config(void)
  * */
 void _StartYakIO(void)
 {    
+    // time the boot. See the BOOT TIME notes at the top of this file
+    StartBootTimer();
+
+    // so we can see how much stack we use. See the STACK notes in YakIO_Utils.h
+    PaintStack();
+
     // configure the microcontroller
     nRF51822Config();
+
+    // now the memory is set up we can create the global objects
+    RunStaticConstructors();
+
+    // this is set after the .bss section is zeroed or it would be lost
+    bootCycles = StopBootTimer();
     
     CreateMainObject();    
     
@@ -274,7 +399,10 @@ WEAK_ALIAS void IRQ_PPI_handler(void);
 //
 // NOTE: the order and names of these _REALLY_ matters. Do NOT mess with this code 
 //  unless you know what you are doing and why you are doing it
-void *__vectors[] __attribute((section(".vectors"))) = {
+//
+// The "used" tells the compiler to keep this even though nothing in the program refers 
+// to it. Only the CPU does. It matters for the link time optimized build in the Makefile.
+void *__vectors[] __attribute((section(".vectors"), used)) = {
     // first 16 slots are for system things 
     __startOfStack__,
     (void *)_StartYakIO,
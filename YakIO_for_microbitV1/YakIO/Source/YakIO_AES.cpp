@@ -0,0 +1,247 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_AES.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_AES - Constructor. Nothing happens until Start() is called
+     * */
+    YakIO_AES::YakIO_AES()
+    {
+        for(int i=0; i<AES_BLOCK_BYTES; i++) counterBytes[i] = 0;
+        for(int i=0; i<AES_KEYSTREAM_BYTES; i++) keystreamBytes[i] = 0;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts a new stream and sets the ECB making keystream for it
+     *     in the background. See the note on AES in YakIO_AES.h
+     *
+     * inputs:
+     *    ecbPtrIn - the ECB to encrypt with. Nothing else should use it 
+     *       until Stop() is called
+     *    keyBytes - the AES_KEY_BYTES byte key
+     *    counterBlock - the AES_BLOCK_BYTES byte counter block for the 
+     *       first 16 bytes of the stream. Usually a nonce followed by a 
+     *       block counter starting at zero
+     * */
+    void YakIO_AES::Start(YakIO_ECB *ecbPtrIn, const unsigned char *keyBytes, const unsigned char *counterBlock)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((ecbPtrIn==NULL) || (keyBytes==NULL) || (counterBlock==NULL)) return;
+
+        Stop();
+        ecbPtr = ecbPtrIn;
+        ecbPtr->Stop();
+        ecbPtr->SetKey(keyBytes);
+        ecbPtr->SetCallback(CALLBACK_0, this);
+        for(int i=0; i<AES_BLOCK_BYTES; i++) counterBytes[i] = counterBlock[i];
+        blockCount = 0;
+        stallCount = 0;
+
+        isRunning = 1;
+        KeepGenerating();
+    }
+
+    /* Stop - stops the stream and wipes the keystream and the counter. The
+     *     key is left in the ECB data block
+     * */
+    void YakIO_AES::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(ecbPtr!=NULL)
+        {
+            ecbPtr->Stop();
+            ecbPtr->ClearAllCallbacks();
+        }
+        isRunning = 0;
+        isGenerating = 0;
+        for(int i=0; i<AES_BLOCK_BYTES; i++) counterBytes[i] = 0;
+        for(int i=0; i<AES_KEYSTREAM_BYTES; i++) keystreamBytes[i] = 0;
+        keystreamWriteCount = 0;
+        keystreamReadCount = 0;
+    }
+
+    /* Encrypt - encrypts the next byteCount bytes of the stream. If the 
+     *     keystream runs out this waits for the ECB to make more.
+     *
+     *   NOTE: Do not call this from an interrupt with a higher priority 
+     *     than the ECB. See YakIO_ECB::PollEvents()
+     *
+     * inputs:
+     *    inBuffer - the bytes to encrypt
+     *    outBuffer - where to put the encrypted bytes. It can be the same 
+     *       as inBuffer
+     *    byteCount - the number of bytes. Any number, it does not have to
+     *       be a multiple of AES_BLOCK_BYTES
+     * returns:
+     *    nz if it worked, z if Start() has not been called
+     * */
+    unsigned int YakIO_AES::Encrypt(const unsigned char *inBuffer, unsigned char *outBuffer, unsigned int byteCount)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(isRunning==0) return 0;
+        if((inBuffer==NULL) || (outBuffer==NULL)) return 0;
+
+        unsigned int doneCount = 0;
+        while(doneCount<byteCount)
+        {
+            unsigned int readIndex = keystreamReadCount;
+            unsigned int readyCount = keystreamWriteCount - readIndex;
+            if(readyCount==0)
+            {
+                // the ECB has not kept up. Wait for the block it is working 
+                // on. We poll so this works with the interrupts disabled too
+                stallCount = stallCount + 1;
+                KeepGenerating();
+                while(keystreamWriteCount==keystreamReadCount) ecbPtr->PollEvents();
+                continue;
+            }
+            if(readyCount>(byteCount-doneCount)) readyCount = byteCount-doneCount;
+
+            // only we move keystreamReadCount so the interrupt never writes
+            // into the bytes between it and keystreamWriteCount. No need to
+            // disable the interrupts while we use them
+            for(unsigned int i=0; i<readyCount; i++)
+            {
+                outBuffer[doneCount+i] = inBuffer[doneCount+i] ^ keystreamBytes[(readIndex+i) & AES_KEYSTREAM_MASK];
+            }
+            keystreamReadCount = readIndex + readyCount;
+            doneCount = doneCount + readyCount;
+            KeepGenerating();
+        }
+        return 1;
+    }
+
+    /* Decrypt - decrypts the next byteCount bytes of the stream. In CTR 
+     *     mode this is exactly the same as Encrypt()
+     *
+     * inputs:
+     *    inBuffer - the bytes to decrypt
+     *    outBuffer - where to put the decrypted bytes. It can be the same 
+     *       as inBuffer
+     *    byteCount - the number of bytes
+     * returns:
+     *    nz if it worked, z if Start() has not been called
+     * */
+    unsigned int YakIO_AES::Decrypt(const unsigned char *inBuffer, unsigned char *outBuffer, unsigned int byteCount)
+    {
+        return Encrypt(inBuffer, outBuffer, byteCount);
+    }
+
+    /* GetKeystreamCount - gets the number of bytes of keystream ready and
+     *     waiting. Encrypt() will not wait for this many bytes
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_AES::GetKeystreamCount(void)
+    {
+        return keystreamWriteCount - keystreamReadCount;
+    }
+
+    /* GetBlockCount - gets the number of keystream blocks the ECB has made 
+     *     since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_AES::GetBlockCount(void)
+    {
+        return blockCount;
+    }
+
+    /* GetStallCount - gets the number of times Encrypt() found no keystream
+     *     ready and had to wait for the ECB since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_AES::GetStallCount(void)
+    {
+        return stallCount;
+    }
+
+    /* Callback0 - called from the ECB interrupt when a block of keystream
+     *     is done. Stores it and starts the next one if there is room
+     * */
+    void YakIO_AES::Callback0(void)
+    {
+        if(isGenerating==0) return;
+
+        // StartNextBlock() made sure there is room and a block never 
+        // wraps around the end of the buffer
+        ecbPtr->GetCipherText(&keystreamBytes[keystreamWriteCount & AES_KEYSTREAM_MASK]);
+        keystreamWriteCount = keystreamWriteCount + AES_BLOCK_BYTES;
+        blockCount = blockCount + 1;
+        isGenerating = 0;
+
+        if((AES_KEYSTREAM_BYTES-(keystreamWriteCount-keystreamReadCount))>=AES_BLOCK_BYTES) StartNextBlock();
+    }
+
+// #
+// # Private
+// #
+
+    /* IncrementCounter - adds one to the counter block. It is a 128 bit big
+     *     endian number
+     * */
+    void YakIO_AES::IncrementCounter(void)
+    {
+        for(int i=AES_BLOCK_BYTES-1; i>=0; i--)
+        {
+            counterBytes[i] = counterBytes[i] + 1;
+            if(counterBytes[i]!=0) break;
+        }
+    }
+
+    /* StartNextBlock - starts the ECB on the next counter block. Called 
+     *     from the ECB interrupt or with the interrupts disabled
+     * */
+    void YakIO_AES::StartNextBlock(void)
+    {
+        isGenerating = 1;
+        // StartEncrypt() takes a copy so we can move the counter on now
+        ecbPtr->StartEncrypt(counterBytes);
+        IncrementCounter();
+    }
+
+    /* KeepGenerating - starts the ECB again if it stopped because the 
+     *     keystream buffer was full and there is now room
+     * */
+    void YakIO_AES::KeepGenerating(void)
+    {
+        unsigned int primaskState = EnterCritical();
+        if((isRunning!=0) && (isGenerating==0))
+        {
+            if((AES_KEYSTREAM_BYTES-(keystreamWriteCount-keystreamReadCount))>=AES_BLOCK_BYTES) StartNextBlock();
+        }
+        ExitCritical(primaskState);
+    }
@@ -0,0 +1,461 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_CCM.h"
+#include "YakIO_TRACE.h"
+
+// the IRQ_AAR_CCM_handler is a non-member function. It has no idea of
+// what class it should work on. The pointer below is set in the
+// constructor of the CCM Object. See the same thing in YakIO_RNG.cpp
+YakIO_CCM *ccm_ptr = NULL;
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_CCM - Constructor. The CCM is not enabled until Start() is 
+     *     called
+     * */
+    YakIO_CCM::YakIO_CCM()
+    {
+        for(int i=0; i<CCM_KEY_BYTES; i++) ccmConfig.keyBytes[i] = 0;
+        for(int i=0; i<CCM_COUNTER_BYTES; i++) ccmConfig.counterBytes[i] = 0;
+        for(int i=0; i<CCM_IV_BYTES; i++) ccmConfig.ivBytes[i] = 0;
+        ccmConfig.directionByte = CCM_DIRECTION_SLAVE_TO_MASTER;
+
+        // remember our 'this' pointer
+        ccm_ptr = this;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* SetCallback - sets the callback object and function within that object.
+     *     It is called from the interrupt when a packet armed with 
+     *     ArmRadioTx() or ArmRadioRx() has been done. The callback object 
+     *     must inherit from YakIO_CALLBACK
+     *
+     * inputs:
+     *    callbackIDIn - the callback id to use. Essentially this identifies the function name within the
+     *       callback interface object
+     *    callbackInterfacePtrIn - the "this" pointer of the object to receive
+     *       the callback
+     * */
+    void YakIO_CCM::SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        callbackInterfacePtr = callbackInterfacePtrIn;
+        callbackID = callbackIDIn;
+    }
+
+    /* CallCallback - calls the callback function set on this object
+     * */
+    void YakIO_CCM::CallCallback()
+    {
+        if(isInitialized==0) return;
+        // we have to have this
+        if(callbackInterfacePtr==NULL) return;
+
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
+        // figure out what callback function to call and call it
+        if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
+        else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
+    }
+
+    /* ClearAllCallbacks - clear all callbacks
+     * */
+    void YakIO_CCM::ClearAllCallbacks(void)
+    {
+        callbackInterfacePtr=NULL;
+        callbackID=CALLBACK_NONE;
+    }
+
+    /* Start - enables the CCM with a key and IV. The packet counter starts 
+     *     at zero
+     *
+     * inputs:
+     *    keyBytes - the CCM_KEY_BYTES byte session key, in the usual AES 
+     *       order (the same as the ECB)
+     *    ivBytes - the CCM_IV_BYTES byte IV, least significant byte first
+     *    ccmDirection - which way the packets go. Each end uses the same 
+     *       direction for the packets the master sends and the other one for
+     *       the packets the slave sends
+     * */
+    void YakIO_CCM::Start(const unsigned char *keyBytes, const unsigned char *ivBytes, enum CCM_DIRECTION ccmDirection)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((keyBytes==NULL) || (ivBytes==NULL)) return;
+
+        Disarm();
+        for(int i=0; i<CCM_KEY_BYTES; i++) ccmConfig.keyBytes[i] = keyBytes[i];
+        for(int i=0; i<CCM_IV_BYTES; i++) ccmConfig.ivBytes[i] = ivBytes[i];
+        SetDirection(ccmDirection);
+        SetPacketCounter(0, 0);
+        packetCount = 0;
+        micFailCount = 0;
+
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENABLE) = CCM_ENABLE_ENABLED;
+        EnableIRQ(IRQ_CCM);
+    }
+
+    /* Stop - disarms and disables the CCM and wipes the key
+     * */
+    void YakIO_CCM::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        Disarm();
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENABLE) = CCM_ENABLE_DISABLED;
+        for(int i=0; i<CCM_KEY_BYTES; i++) ccmConfig.keyBytes[i] = 0;
+        for(int i=0; i<CCM_SCRATCH_BYTES; i++) scratchBytes[i] = 0;
+    }
+
+    /* SetDirection - sets the direction bit in the nonce
+     *
+     * inputs:
+     *    ccmDirection - the direction
+     * */
+    void YakIO_CCM::SetDirection(enum CCM_DIRECTION ccmDirection)
+    {
+        ccmConfig.directionByte = ccmDirection;
+    }
+
+    /* SetPacketCounter - sets the 39 bit packet counter for the next 
+     *     packet. It goes up by one after every packet done. Set it 
+     *     yourself if the link layer needs something else (a packet sent 
+     *     again, for example)
+     *
+     * inputs:
+     *    counterLow - the bottom 32 bits
+     *    counterHigh - the top 7 bits
+     * */
+    void YakIO_CCM::SetPacketCounter(unsigned int counterLow, unsigned int counterHigh)
+    {
+        ccmConfig.counterBytes[0] = counterLow & 0xFF;
+        ccmConfig.counterBytes[1] = (counterLow>>8) & 0xFF;
+        ccmConfig.counterBytes[2] = (counterLow>>16) & 0xFF;
+        ccmConfig.counterBytes[3] = (counterLow>>24) & 0xFF;
+        ccmConfig.counterBytes[4] = counterHigh & CCM_COUNTER_HIGH_MASK;
+        for(int i=CCM_COUNTER_USED_BYTES; i<CCM_COUNTER_BYTES; i++) ccmConfig.counterBytes[i] = 0;
+    }
+
+    /* GetPacketCounter - gets the bottom 32 bits of the packet counter 
+     *     which will be used for the next packet
+     *
+     * returns:
+     *    the counter
+     * */
+    unsigned int YakIO_CCM::GetPacketCounter(void)
+    {
+        return ccmConfig.counterBytes[0] | (ccmConfig.counterBytes[1]<<8) | (ccmConfig.counterBytes[2]<<16) | ((unsigned int)ccmConfig.counterBytes[3]<<24);
+    }
+
+    /* EncryptPacket - encrypts a packet in RAM and adds the MIC. Waits 
+     *     until it is done. See the note on the CCM in YakIO_CCM.h for the
+     *     packet format
+     *
+     * inputs:
+     *    clearPacket - the packet to encrypt. LENGTH must be no more than 
+     *       CCM_MAX_PAYLOAD_BYTES
+     *    cipherPacket - where to put the encrypted packet. It must have 
+     *       room for CCM_PACKET_BYTES. LENGTH goes up by CCM_MIC_BYTES 
+     *       unless it was zero - empty packets are not encrypted
+     * returns:
+     *    nz if it worked, z if the packet was too long, the CCM was not 
+     *    started or it is armed for the RADIO
+     * */
+    unsigned int YakIO_CCM::EncryptPacket(const unsigned char *clearPacket, unsigned char *cipherPacket)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((clearPacket==NULL) || (cipherPacket==NULL)) return 0;
+        if(isArmed!=0) return 0;
+        if(clearPacket[CCM_PACKET_OFFSET_LENGTH]>CCM_MAX_PAYLOAD_BYTES) return 0;
+
+        SetPointers(CCM_MODE_ENCRYPT, clearPacket, cipherPacket);
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_SHORTS) = CCM_SHORT_ENDKSGEN_CRYPT;
+        ClearEvents();
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_KSGEN) = 1;
+        if(WaitForCrypt()==0) return 0;
+
+        IncrementCounter();
+        packetCount = packetCount + 1;
+        return 1;
+    }
+
+    /* DecryptPacket - decrypts a packet in RAM and checks the MIC. Waits 
+     *     until it is done
+     *
+     * inputs:
+     *    cipherPacket - the packet to decrypt, MIC included
+     *    clearPacket - where to put the decrypted packet. LENGTH goes down 
+     *       by CCM_MIC_BYTES unless it was zero
+     * returns:
+     *    nz if it worked and the MIC was right, z if not. The packet 
+     *    counter is only moved on if it worked
+     * */
+    unsigned int YakIO_CCM::DecryptPacket(const unsigned char *cipherPacket, unsigned char *clearPacket)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((clearPacket==NULL) || (cipherPacket==NULL)) return 0;
+        if(isArmed!=0) return 0;
+        if(cipherPacket[CCM_PACKET_OFFSET_LENGTH]>(CCM_MAX_PAYLOAD_BYTES+CCM_MIC_BYTES)) return 0;
+
+        SetPointers(CCM_MODE_DECRYPT, cipherPacket, clearPacket);
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_SHORTS) = CCM_SHORT_ENDKSGEN_CRYPT;
+        ClearEvents();
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_KSGEN) = 1;
+        if(WaitForCrypt()==0) return 0;
+
+        if(GetMicStatus()==0)
+        {
+            micFailCount = micFailCount + 1;
+            return 0;
+        }
+        IncrementCounter();
+        packetCount = packetCount + 1;
+        return 1;
+    }
+
+    /* ArmRadioTx - sets the CCM to encrypt the next packet the RADIO sends
+     *     as the RADIO ramps up. Set the RADIO PACKETPTR to cipherPacket. 
+     *     It stays armed, for one packet after another, until Disarm() is 
+     *     called. Fill clearPacket for each one before the RADIO is started
+     *
+     * inputs:
+     *    clearPacket - the packet to encrypt
+     *    cipherPacket - the packet the RADIO sends
+     * */
+    void YakIO_CCM::ArmRadioTx(const unsigned char *clearPacket, unsigned char *cipherPacket)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((clearPacket==NULL) || (cipherPacket==NULL)) return;
+
+        Disarm();
+        SetPointers(CCM_MODE_ENCRYPT, clearPacket, cipherPacket);
+        // READY starts KSGEN, the end of that starts CRYPT
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_SHORTS) = CCM_SHORT_ENDKSGEN_CRYPT;
+        ClearEvents();
+        armedMode = CCM_MODE_ENCRYPT;
+        isArmed = 1;
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_INTENSET) = CCM_INTEN_ENDCRYPT_BIT | CCM_INTEN_ERROR_BIT;
+        ppiObj.EnableChannel(PPI_CH_RADIO_READY_CCM_KSGEN);
+    }
+
+    /* ArmRadioRx - sets the CCM to decrypt each packet the RADIO receives 
+     *     as it arrives. Set the RADIO PACKETPTR to cipherPacket. It stays 
+     *     armed until Disarm() is called. Check GetMicStatus() (or look at
+     *     the counts) in the callback before you believe clearPacket
+     *
+     * inputs:
+     *    cipherPacket - the packet the RADIO receives
+     *    clearPacket - where the decrypted packet goes
+     * */
+    void YakIO_CCM::ArmRadioRx(const unsigned char *cipherPacket, unsigned char *clearPacket)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((clearPacket==NULL) || (cipherPacket==NULL)) return;
+
+        Disarm();
+        SetPointers(CCM_MODE_DECRYPT, cipherPacket, clearPacket);
+        // READY starts KSGEN, ADDRESS starts CRYPT. No shortcut, the 
+        // packet is not there yet when KSGEN ends
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_SHORTS) = 0;
+        ClearEvents();
+        armedMode = CCM_MODE_DECRYPT;
+        isArmed = 1;
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_INTENSET) = CCM_INTEN_ENDCRYPT_BIT | CCM_INTEN_ERROR_BIT;
+        ppiObj.EnableChannel(PPI_CH_RADIO_READY_CCM_KSGEN);
+        ppiObj.EnableChannel(PPI_CH_RADIO_ADDRESS_CCM_CRYPT);
+    }
+
+    /* Disarm - stops the CCM following the RADIO
+     * */
+    void YakIO_CCM::Disarm(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        ppiObj.DisableChannel(PPI_CH_RADIO_READY_CCM_KSGEN);
+        ppiObj.DisableChannel(PPI_CH_RADIO_ADDRESS_CCM_CRYPT);
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_INTENCLR) = CCM_INTEN_ENDKSGEN_BIT | CCM_INTEN_ENDCRYPT_BIT | CCM_INTEN_ERROR_BIT;
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_SHORTS) = 0;
+        if(isArmed!=0) YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_STOP) = 1;
+        ClearEvents();
+        isArmed = 0;
+    }
+
+    /* GetMicStatus - gets the result of the MIC check on the last packet 
+     *     decrypted
+     *
+     * returns:
+     *    nz if the MIC was right, z if the packet has been tampered with
+     * */
+    unsigned int YakIO_CCM::GetMicStatus(void)
+    {
+        return YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_MICSTATUS);
+    }
+
+    /* GetPacketCount - gets the number of packets encrypted or decrypted 
+     *     (with a good MIC) since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_CCM::GetPacketCount(void)
+    {
+        return packetCount;
+    }
+
+    /* GetMicFailCount - gets the number of packets decrypted with a bad MIC
+     *     since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_CCM::GetMicFailCount(void)
+    {
+        return micFailCount;
+    }
+
+    /* HandleCcmIRQ - does the work for the IRQ_AAR_CCM_handler. Moves the 
+     *     packet counter on after an armed packet and calls the callback. 
+     *     You should never need to call this yourself.
+     * */
+    void YakIO_CCM::HandleCcmIRQ(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ERROR)!=0)
+        {
+            // the RADIO went faster than the CCM. The packet is lost
+            ClearEvents();
+            CallCallback();
+            return;
+        }
+        if(YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENDCRYPT)==0) return;
+        ClearEvents();
+
+        if((armedMode==CCM_MODE_DECRYPT) && (GetMicStatus()==0))
+        {
+            micFailCount = micFailCount + 1;
+        }
+        else
+        {
+            IncrementCounter();
+            packetCount = packetCount + 1;
+        }
+        CallCallback();
+    }
+
+// #
+// # Private
+// #
+
+    /* ClearEvents - clears the ENDKSGEN, ENDCRYPT and ERROR events
+     * */
+    void YakIO_CCM::ClearEvents(void)
+    {
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENDKSGEN) = 0;
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENDCRYPT) = 0;
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ERROR) = 0;
+    }
+
+    /* SetPointers - sets the mode and all four EasyDMA pointers
+     *
+     * inputs:
+     *    ccmMode - encrypt or decrypt
+     *    inPacket - the packet to read
+     *    outPacket - the packet to write
+     * */
+    void YakIO_CCM::SetPointers(enum CCM_MODE ccmMode, const unsigned char *inPacket, unsigned char *outPacket)
+    {
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_MODE) = ccmMode;
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_CNFPTR) = YAKIO_RAM_ADDRESS(&ccmConfig);
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_INPTR) = YAKIO_RAM_ADDRESS(inPacket);
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_OUTPTR) = YAKIO_RAM_ADDRESS(outPacket);
+        YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_SCRATCHPTR) = YAKIO_RAM_ADDRESS(scratchBytes);
+    }
+
+    /* WaitForCrypt - waits for the ENDCRYPT or ERROR event
+     *
+     * returns:
+     *    nz for ENDCRYPT, z for ERROR or if the CCM is not enabled
+     * */
+    unsigned int YakIO_CCM::WaitForCrypt(void)
+    {
+        if(YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENABLE)!=CCM_ENABLE_ENABLED) return 0;
+        while(1)
+        {
+            if(YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ENDCRYPT)!=0) break;
+            if(YAKIO_REGISTER(REGISTER_CCM+CCMREG_OFFSET_ERROR)!=0)
+            {
+                ClearEvents();
+                return 0;
+            }
+        }
+        ClearEvents();
+        return 1;
+    }
+
+    /* IncrementCounter - adds one to the 39 bit packet counter
+     * */
+    void YakIO_CCM::IncrementCounter(void)
+    {
+        for(int i=0; i<CCM_COUNTER_USED_BYTES; i++)
+        {
+            ccmConfig.counterBytes[i] = ccmConfig.counterBytes[i] + 1;
+            if(ccmConfig.counterBytes[i]!=0) break;
+        }
+        ccmConfig.counterBytes[4] = ccmConfig.counterBytes[4] & CCM_COUNTER_HIGH_MASK;
+    }
+
+    /* IRQ_AAR_CCM_handler
+     *
+     * Note: the address of this function is set in the flash by the linker.
+     *       See the discussion on the IRQ_RNG_handler in YakIO_RNG.cpp
+     *
+     *   Do NOT define this anywhere else. This class needs it here. The AAR
+     *   shares this interrupt, so a YakIO AAR class would have to share it too
+     * */
+    void IRQ_AAR_CCM_handler(void)
+    {
+        if(ccm_ptr==NULL) return;
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_IRQ_ENTRY, IRQ_CCM);
+        ccm_ptr->HandleCcmIRQ();
+        YAKIO_TRACE_EVENT(TRACE_IRQ_EXIT, IRQ_CCM);
+    }
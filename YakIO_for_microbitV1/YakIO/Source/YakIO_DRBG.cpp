@@ -0,0 +1,523 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_DRBG.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_DRBG - Constructor. Nothing happens until Start() is called
+     * */
+    YakIO_DRBG::YakIO_DRBG()
+    {
+        WipeState();
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts the DRBG. It is seeded from DRBG_ENTROPY_BYTES of the 
+     *     RNG pool as they arrive and then fills its buffer in the 
+     *     background. See the note on the DRBG in YakIO_DRBG.h
+     *
+     * inputs:
+     *    ecbPtrIn - the ECB to encrypt with. Nothing else should use it 
+     *       until Stop() is called
+     *    rngPtrIn - the RNG to seed from. Its pool is started if it is not 
+     *       already running
+     * */
+    void YakIO_DRBG::Start(YakIO_ECB *ecbPtrIn, YakIO_RNG *rngPtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((ecbPtrIn==NULL) || (rngPtrIn==NULL)) return;
+
+        Stop();
+        ecbPtr = ecbPtrIn;
+        rngPtr = rngPtrIn;
+        if(rngPtr->IsPoolRunning()==0) rngPtr->PoolStart();
+
+        // K and V start at zero. The first thing done is the seed
+        ecbPtr->Stop();
+        ecbPtr->SetKey(keyBytes);
+        ecbPtr->SetCallback(CALLBACK_0, this);
+
+        unsigned int primaskState = EnterCritical();
+        reseedIsDue = 1;
+        drbgState = DRBG_STATE_IDLE;
+        StartNextBlock();
+        ExitCritical(primaskState);
+    }
+
+    /* Stop - stops the DRBG and wipes the key, counter and buffer. Start()
+     *     has to be called, and the DRBG seeded again, before there is any 
+     *     more output
+     * */
+    void YakIO_DRBG::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(ecbPtr!=NULL)
+        {
+            ecbPtr->Stop();
+            ecbPtr->ClearAllCallbacks();
+        }
+        WipeState();
+        if(ecbPtr!=NULL)
+        {
+            // do not leave our key or the last block of output lying about 
+            // in the ECB data block. Encrypting zeros with a zero key does that
+            ecbPtr->SetKey(keyBytes);
+            ecbPtr->EncryptBlock(counterBytes, updateOutputBytes);
+            for(int i=0; i<ECB_BLOCK_BYTES; i++) updateOutputBytes[i] = 0;
+        }
+    }
+
+    /* IsSeeded - tests if the DRBG has been seeded from the RNG since 
+     *     Start() was called. There is no output until it has
+     *
+     * returns:
+     *    nz if it has, z if it has not
+     * */
+    unsigned int YakIO_DRBG::IsSeeded(void)
+    {
+        return isSeeded;
+    }
+
+    /* GetCount - gets the number of bytes waiting in the buffer
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_DRBG::GetCount(void)
+    {
+        return bufferWriteCount - bufferReadCount;
+    }
+
+    /* TryGetBytes - takes random bytes out of the buffer. This never waits, 
+     *     if there are not enough bytes it takes none and returns at once.
+     *
+     *   NOTE: The interrupts are disabled while the bytes are copied so 
+     *     this can be called from anywhere - including other interrupt 
+     *     handlers. Take the bytes you need in small pieces.
+     *
+     * inputs:
+     *    outBuffer - the buffer to put them in
+     *    byteCount - the number of bytes wanted. More than DRBG_BUFFER_BYTES 
+     *       can never succeed
+     * returns:
+     *    nz if the buffer was filled, z if there were not enough bytes
+     * */
+    unsigned int YakIO_DRBG::TryGetBytes(unsigned char *outBuffer, unsigned int byteCount)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(drbgState==DRBG_STATE_STOPPED) return 0;
+        if(outBuffer==NULL) return 0;
+
+        unsigned int gotBytes = 0;
+        unsigned int primaskState = EnterCritical();
+        if((bufferWriteCount-bufferReadCount)>=byteCount)
+        {
+            unsigned int readIndex = bufferReadCount;
+            for(unsigned int i=0; i<byteCount; i++)
+            {
+                // nobody else gets these bytes so do not leave them in the buffer
+                outBuffer[i] = bufferBytes[(readIndex+i) & DRBG_BUFFER_MASK];
+                bufferBytes[(readIndex+i) & DRBG_BUFFER_MASK] = 0;
+            }
+            bufferReadCount = readIndex + byteCount;
+            gotBytes = 1;
+        }
+        // the ECB only stops when the buffer is full or there was no 
+        // entropy. Either way, it is worth another go now
+        if((drbgState==DRBG_STATE_IDLE) || (drbgState==DRBG_STATE_WAITING_ENTROPY)) StartNextBlock();
+        ExitCritical(primaskState);
+
+        return gotBytes;
+    }
+
+    /* GetU32 - takes a 32 bit random value out of the buffer. This never 
+     *     waits. See TryGetBytes()
+     *
+     * inputs:
+     *    randomValuePtr - where to put the value. Untouched if there is 
+     *       not one
+     * returns:
+     *    nz if there was a value, z if there were not enough bytes
+     * */
+    unsigned int YakIO_DRBG::GetU32(unsigned int *randomValuePtr)
+    {
+        if(randomValuePtr==NULL) return 0;
+
+        unsigned char randomBytes[BYTES_IN_REGISTER];
+        if(TryGetBytes(randomBytes, BYTES_IN_REGISTER)==0) return 0;
+        *randomValuePtr = randomBytes[0] | (randomBytes[1]<<8) | (randomBytes[2]<<16) | ((unsigned int)randomBytes[3]<<24);
+        return 1;
+    }
+
+    /* SetKeyRotationInterval - sets how many blocks are made between the 
+     *     Updates of the key and counter. Smaller is safer and a little slower.
+     *     See the note on the DRBG in YakIO_DRBG.h
+     *
+     * inputs:
+     *    rotationBlocks - the interval in ECB_BLOCK_BYTES blocks. 0 is treated 
+     *       as 1
+     * */
+    void YakIO_DRBG::SetKeyRotationInterval(unsigned int rotationBlocks)
+    {
+        if(rotationBlocks==0) rotationBlocks = 1;
+        keyRotationInterval = rotationBlocks;
+    }
+
+    /* SetReseedInterval - sets how many key rotations there are between 
+     *     reseeds from the RNG. 
+     *
+     * inputs:
+     *    reseedRotations - the interval in key rotations. 0 is treated as 1
+     * */
+    void YakIO_DRBG::SetReseedInterval(unsigned int reseedRotations)
+    {
+        if(reseedRotations==0) reseedRotations = 1;
+        reseedInterval = reseedRotations;
+    }
+
+    /* GetBlockCount - gets the number of ECB_BLOCK_BYTES blocks of output 
+     *     made since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_DRBG::GetBlockCount(void)
+    {
+        return blockCount;
+    }
+
+    /* GetKeyRotationCount - gets the number of key rotations since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_DRBG::GetKeyRotationCount(void)
+    {
+        return keyRotationCount;
+    }
+
+    /* GetReseedCount - gets the number of times the DRBG has been seeded 
+     *     from the RNG since Start(). The first seed is included
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_DRBG::GetReseedCount(void)
+    {
+        return reseedCount;
+    }
+
+    /* Callback0 - called from the ECB interrupt when a block is done. 
+     *     Stores the output or the Update result and starts the next block
+     * */
+    void YakIO_DRBG::Callback0(void)
+    {
+        if(drbgState==DRBG_STATE_GENERATING)
+        {
+            // StartNextBlock() made sure there is room and a block never
+            // wraps around the end of the buffer
+            ecbPtr->GetCipherText(&bufferBytes[bufferWriteCount & DRBG_BUFFER_MASK]);
+            bufferWriteCount = bufferWriteCount + ECB_BLOCK_BYTES;
+            blockCount = blockCount + 1;
+            blocksSinceRotation = blocksSinceRotation + 1;
+        }
+        else if(drbgState==DRBG_STATE_DERIVING)
+        {
+            // the BCC steps build the two chains. The last two make 
+            // the seed material
+            if(dfStepCount<DRBG_DF_BCC_STEPS) ecbPtr->GetCipherText(&dfChainBytes[(dfStepCount & 0x01)*ECB_BLOCK_BYTES]);
+            else if(dfStepCount==DRBG_DF_BCC_STEPS) ecbPtr->GetCipherText(&updateInputBytes[0]);
+            else ecbPtr->GetCipherText(&updateInputBytes[ECB_BLOCK_BYTES]);
+            dfStepCount = dfStepCount + 1;
+            StartDeriveStep();
+            return;
+        }
+        else if(drbgState==DRBG_STATE_UPDATING)
+        {
+            ecbPtr->GetCipherText(&updateOutputBytes[updateBlockIndex*ECB_BLOCK_BYTES]);
+            updateBlockIndex = updateBlockIndex + 1;
+            if(updateBlockIndex<(DRBG_SEED_BYTES/ECB_BLOCK_BYTES))
+            {
+                IncrementCounter();
+                ecbPtr->StartEncrypt(counterBytes);
+                return;
+            }
+            FinishUpdate();
+        }
+        else return;
+
+        StartNextBlock();
+    }
+
+// #
+// # Private
+// #
+
+    /* IncrementCounter - adds one to V. It is a 128 bit big endian number
+     * */
+    void YakIO_DRBG::IncrementCounter(void)
+    {
+        for(int i=ECB_BLOCK_BYTES-1; i>=0; i--)
+        {
+            counterBytes[i] = counterBytes[i] + 1;
+            if(counterBytes[i]!=0) break;
+        }
+    }
+
+    /* StartNextBlock - decides what the ECB does next and starts it. Called
+     *     from the ECB interrupt or with the interrupts disabled
+     * */
+    void YakIO_DRBG::StartNextBlock(void)
+    {
+        if(reseedIsDue!=0)
+        {
+            // the derivation function makes the seed material and then 
+            // starts the Update. If it runs out of entropy it carries on 
+            // from the same place next time
+            StartDeriveStep();
+            return;
+        }
+        if(blocksSinceRotation>=keyRotationInterval)
+        {
+            for(int i=0; i<DRBG_SEED_BYTES; i++) updateInputBytes[i] = 0;
+            StartUpdate(0);
+            return;
+        }
+        if((DRBG_BUFFER_BYTES-(bufferWriteCount-bufferReadCount))<ECB_BLOCK_BYTES)
+        {
+            drbgState = DRBG_STATE_IDLE;
+            return;
+        }
+        drbgState = DRBG_STATE_GENERATING;
+        IncrementCounter();
+        ecbPtr->StartEncrypt(counterBytes);
+    }
+
+    /* StartUpdate - starts the CTR_DRBG Update function. The updateInputBytes
+     *     are mixed in when the two blocks are done. See FinishUpdate()
+     *
+     * inputs:
+     *    isReseed - nz if the updateInputBytes are entropy from the RNG, z 
+     *       for a key rotation
+     * */
+    void YakIO_DRBG::StartUpdate(unsigned int isReseed)
+    {
+        updateIsReseed = isReseed;
+        updateBlockIndex = 0;
+        drbgState = DRBG_STATE_UPDATING;
+        IncrementCounter();
+        ecbPtr->StartEncrypt(counterBytes);
+    }
+
+    /* FinishUpdate - the end of the CTR_DRBG Update function. The two 
+     *     encrypted blocks, xor the input, become the new K and V
+     * */
+    void YakIO_DRBG::FinishUpdate(void)
+    {
+        for(int i=0; i<DRBG_SEED_BYTES; i++) updateOutputBytes[i] = updateOutputBytes[i] ^ updateInputBytes[i];
+        for(int i=0; i<ECB_KEY_BYTES; i++) keyBytes[i] = updateOutputBytes[i];
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) counterBytes[i] = updateOutputBytes[ECB_KEY_BYTES+i];
+        ecbPtr->SetKey(keyBytes);
+
+        // do not leave copies of the state lying about
+        for(int i=0; i<DRBG_SEED_BYTES; i++)
+        {
+            updateOutputBytes[i] = 0;
+            updateInputBytes[i] = 0;
+        }
+
+        blocksSinceRotation = 0;
+        if(updateIsReseed!=0)
+        {
+            reseedCount = reseedCount + 1;
+            rotationsSinceReseed = 0;
+            reseedIsDue = 0;
+            isSeeded = 1;
+            return;
+        }
+        keyRotationCount = keyRotationCount + 1;
+        rotationsSinceReseed = rotationsSinceReseed + 1;
+        if(rotationsSinceReseed>=reseedInterval) reseedIsDue = 1;
+    }
+
+    /* StartDeriveStep - starts the next ECB block of the Block_Cipher_df
+     *     derivation function (SP 800-90A section 10.3.2) or, when it is 
+     *     done, the Update with the seed material it made. See the note on
+     *     the SEED MATERIAL in YakIO_DRBG.h. Called from the ECB interrupt 
+     *     or with the interrupts disabled
+     * */
+    void YakIO_DRBG::StartDeriveStep(void)
+    {
+        unsigned char clearBlock[ECB_BLOCK_BYTES];
+
+        if(dfStepCount>=DRBG_DF_STEPS)
+        {
+            // updateInputBytes holds the seed material. Put our own 
+            // key back and mix it in
+            dfStepCount = 0;
+            for(int i=0; i<DRBG_SEED_BYTES; i++) dfChainBytes[i] = 0;
+            ecbPtr->SetKey(keyBytes);
+            StartUpdate(1);
+            return;
+        }
+
+        if(dfStepCount<DRBG_DF_BCC_STEPS)
+        {
+            // the two chains take turns. Steps 0 and 1 are the IV blocks
+            // and after that each pair of steps is one block of S
+            unsigned int sBlockIndex = dfStepCount/2;
+            unsigned int chainIndex = dfStepCount & 0x01;
+            if(sBlockIndex==0)
+            {
+                // the BCC key is 00 01 02 ... 0F, always
+                if(chainIndex==0)
+                {
+                    unsigned char bccKey[ECB_KEY_BYTES];
+                    for(int i=0; i<ECB_KEY_BYTES; i++) bccKey[i] = (unsigned char)i;
+                    ecbPtr->SetKey(bccKey);
+                }
+                // the IV is the chain number as a 4 byte big endian value 
+                // padded with zeros. The chain starts at zero so there is 
+                // nothing to xor it with
+                for(int i=0; i<ECB_BLOCK_BYTES; i++) clearBlock[i] = 0;
+                clearBlock[3] = (unsigned char)chainIndex;
+            }
+            else
+            {
+                // the first chain loads the next block of S and the 
+                // second uses it again
+                if(chainIndex==0)
+                {
+                    if(LoadDfBlock(sBlockIndex-1)==0)
+                    {
+                        drbgState = DRBG_STATE_WAITING_ENTROPY;
+                        return;
+                    }
+                }
+                for(int i=0; i<ECB_BLOCK_BYTES; i++) clearBlock[i] = dfChainBytes[(chainIndex*ECB_BLOCK_BYTES)+i] ^ dfBlockBytes[i];
+                if(chainIndex!=0)
+                {
+                    for(int i=0; i<ECB_BLOCK_BYTES; i++) dfBlockBytes[i] = 0;
+                }
+            }
+        }
+        else if(dfStepCount==DRBG_DF_BCC_STEPS)
+        {
+            // the first chain is the key and the second is the first 
+            // block to encrypt with it
+            ecbPtr->SetKey(&dfChainBytes[0]);
+            for(int i=0; i<ECB_BLOCK_BYTES; i++) clearBlock[i] = dfChainBytes[ECB_BLOCK_BYTES+i];
+        }
+        else
+        {
+            // the second block is the first one encrypted again
+            for(int i=0; i<ECB_BLOCK_BYTES; i++) clearBlock[i] = updateInputBytes[i];
+        }
+
+        drbgState = DRBG_STATE_DERIVING;
+        ecbPtr->StartEncrypt(clearBlock);
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) clearBlock[i] = 0;
+    }
+
+    /* LoadDfBlock - puts one block of the derivation function input S in
+     *     dfBlockBytes. S is the entropy length and the seed material 
+     *     length as 4 byte big endian values, DRBG_ENTROPY_BYTES from the 
+     *     RNG pool, a 0x80 byte and zeros to the end of the last block
+     *
+     * inputs:
+     *    sBlockIndex - the block of S wanted, 0 to DRBG_DF_S_BLOCKS-1
+     * returns:
+     *    nz if the block was loaded, z if the RNG pool did not have the
+     *    entropy for it. Nothing is taken from the pool in that case
+     * */
+    unsigned int YakIO_DRBG::LoadDfBlock(unsigned int sBlockIndex)
+    {
+        unsigned int firstIndex = sBlockIndex*ECB_BLOCK_BYTES;
+
+        // count the entropy bytes in this block and take them all at once
+        unsigned char entropyBytes[ECB_BLOCK_BYTES];
+        unsigned int entropyCount = 0;
+        for(unsigned int i=0; i<ECB_BLOCK_BYTES; i++)
+        {
+            unsigned int sIndex = firstIndex+i;
+            if((sIndex>=DRBG_DF_HEADER_BYTES) && (sIndex<(DRBG_DF_HEADER_BYTES+DRBG_ENTROPY_BYTES))) entropyCount++;
+        }
+        if(entropyCount>0)
+        {
+            if(rngPtr->TryGetBytes(entropyBytes, entropyCount)==0) return 0;
+        }
+
+        unsigned int entropyIndex = 0;
+        for(unsigned int i=0; i<ECB_BLOCK_BYTES; i++)
+        {
+            unsigned int sIndex = firstIndex+i;
+            unsigned char sByte = 0;
+            if(sIndex<4) sByte = (unsigned char)(DRBG_ENTROPY_BYTES>>((3-sIndex)*8));
+            else if(sIndex<DRBG_DF_HEADER_BYTES) sByte = (unsigned char)(DRBG_SEED_BYTES>>((7-sIndex)*8));
+            else if(sIndex<(DRBG_DF_HEADER_BYTES+DRBG_ENTROPY_BYTES))
+            {
+                sByte = entropyBytes[entropyIndex];
+                entropyBytes[entropyIndex] = 0;
+                entropyIndex++;
+            }
+            else if(sIndex==(DRBG_DF_HEADER_BYTES+DRBG_ENTROPY_BYTES)) sByte = 0x80;
+            dfBlockBytes[i] = sByte;
+        }
+        return 1;
+    }
+
+    /* WipeState - zeros the key, counter, buffer and counts
+     * */
+    void YakIO_DRBG::WipeState(void)
+    {
+        drbgState = DRBG_STATE_STOPPED;
+        for(int i=0; i<ECB_KEY_BYTES; i++) keyBytes[i] = 0;
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) counterBytes[i] = 0;
+        for(int i=0; i<DRBG_SEED_BYTES; i++)
+        {
+            updateOutputBytes[i] = 0;
+            updateInputBytes[i] = 0;
+        }
+        for(int i=0; i<DRBG_SEED_BYTES; i++) dfChainBytes[i] = 0;
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) dfBlockBytes[i] = 0;
+        dfStepCount = 0;
+        for(int i=0; i<DRBG_BUFFER_BYTES; i++) bufferBytes[i] = 0;
+        bufferWriteCount = 0;
+        bufferReadCount = 0;
+        updateBlockIndex = 0;
+        isSeeded = 0;
+        reseedIsDue = 0;
+        blocksSinceRotation = 0;
+        rotationsSinceReseed = 0;
+        blockCount = 0;
+        keyRotationCount = 0;
+        reseedCount = 0;
+    }
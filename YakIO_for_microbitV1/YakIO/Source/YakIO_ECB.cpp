@@ -0,0 +1,300 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_ECB.h"
+#include "YakIO_TRACE.h"
+
+// the IRQ_ECB_handler is a non-member function. It has no idea of
+// what class it should work on. The pointer below is set in the
+// constructor of the ECB Object. See the same thing in YakIO_RNG.cpp
+YakIO_ECB *ecb_ptr = NULL;
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_ECB - Constructor. The key is all zeros until SetKey() is 
+     *     called
+     * */
+    YakIO_ECB::YakIO_ECB()
+    {
+        for(int i=0; i<ECB_KEY_BYTES; i++) ecbData.keyBytes[i] = 0;
+
+        // remember our 'this' pointer
+        ecb_ptr = this;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* SetCallback - sets the callback object and function within that object.
+     *     It is called from the interrupt when a block started with 
+     *     StartEncrypt() is done. The callback object must inherit from 
+     *     YakIO_CALLBACK
+     *
+     * inputs:
+     *    callbackIDIn - the callback id to use. Essentially this identifies the function name within the
+     *       callback interface object
+     *    callbackInterfacePtrIn - the "this" pointer of the object to receive
+     *       the callback
+     * */
+    void YakIO_ECB::SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        callbackInterfacePtr = callbackInterfacePtrIn;
+        callbackID = callbackIDIn;
+        // the interrupts themselves are enabled by StartEncrypt()
+        EnableIRQ(IRQ_ECB);
+    }
+
+    /* CallCallback - calls the callback function set on this object
+     * */
+    void YakIO_ECB::CallCallback()
+    {
+        if(isInitialized==0) return;
+        // we have to have this
+        if(callbackInterfacePtr==NULL) return;
+
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
+        // figure out what callback function to call and call it
+        if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
+        else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
+    }
+
+    /* ClearAllCallbacks - clear all callbacks
+     * */
+    void YakIO_ECB::ClearAllCallbacks(void)
+    {
+        callbackInterfacePtr=NULL;
+        callbackID=CALLBACK_NONE;
+    }
+
+    /* SetKey - sets the key used for every block from now on. Do not call
+     *     this while a block is being encrypted
+     *
+     * inputs:
+     *    keyBytes - the ECB_KEY_BYTES byte key
+     * */
+    void YakIO_ECB::SetKey(const unsigned char *keyBytes)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(keyBytes==NULL) return;
+
+        for(int i=0; i<ECB_KEY_BYTES; i++) ecbData.keyBytes[i] = keyBytes[i];
+    }
+
+    /* EncryptBlock - encrypts one block and waits for the result. This 
+     *     takes about 7 microseconds
+     *
+     * inputs:
+     *    clearBlock - the ECB_BLOCK_BYTES bytes to encrypt
+     *    cipherBlock - where to put the ECB_BLOCK_BYTES encrypted bytes. It
+     *       can be the same as clearBlock
+     * returns:
+     *    nz if it worked, z if StartEncrypt() has a block on the go
+     * */
+    unsigned int YakIO_ECB::EncryptBlock(const unsigned char *clearBlock, unsigned char *cipherBlock)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((clearBlock==NULL) || (cipherBlock==NULL)) return 0;
+        if(isBusy!=0) return 0;
+
+        // we are waiting here so we do not want the interrupt
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_INTENCLR) = ECB_INTEN_ENDECB_BIT | ECB_INTEN_ERRORECB_BIT;
+
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) ecbData.clearText[i] = clearBlock[i];
+        StartBlock();
+        while(1)
+        {
+            if(YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ENDECB)!=0) break;
+            if(YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ERRORECB)!=0)
+            {
+                // the CCM or AAR took the AES hardware. Again
+                restartCount = restartCount + 1;
+                StartBlock();
+            }
+        }
+        ClearEvents();
+
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) cipherBlock[i] = ecbData.cipherText[i];
+        return 1;
+    }
+
+    /* StartEncrypt - starts encrypting one block and returns at once. The 
+     *     callback (see SetCallback()) is called from the interrupt when 
+     *     it is done. It can be started again from inside the callback
+     *
+     * inputs:
+     *    clearBlock - the ECB_BLOCK_BYTES bytes to encrypt. They are copied
+     *       so the buffer can be reused at once
+     * returns:
+     *    nz if it was started, z if there is already a block on the go
+     * */
+    unsigned int YakIO_ECB::StartEncrypt(const unsigned char *clearBlock)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(clearBlock==NULL) return 0;
+        if(isBusy!=0) return 0;
+
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) ecbData.clearText[i] = clearBlock[i];
+        isBusy = 1;
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_INTENSET) = ECB_INTEN_ENDECB_BIT | ECB_INTEN_ERRORECB_BIT;
+        StartBlock();
+        return 1;
+    }
+
+    /* IsBusy - tests if a block started with StartEncrypt() is still
+     *     being encrypted
+     *
+     * returns:
+     *    nz if it is, z if it is not
+     * */
+    unsigned int YakIO_ECB::IsBusy(void)
+    {
+        return isBusy;
+    }
+
+    /* GetCipherText - gets the result of the last block
+     *
+     * inputs:
+     *    cipherBlock - where to put the ECB_BLOCK_BYTES encrypted bytes
+     * */
+    void YakIO_ECB::GetCipherText(unsigned char *cipherBlock)
+    {
+        if(cipherBlock==NULL) return;
+        for(int i=0; i<ECB_BLOCK_BYTES; i++) cipherBlock[i] = ecbData.cipherText[i];
+    }
+
+    /* Stop - abandons any block on the go and turns off the interrupts
+     * */
+    void YakIO_ECB::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_INTENCLR) = ECB_INTEN_ENDECB_BIT | ECB_INTEN_ERRORECB_BIT;
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_STOPECB) = 1;
+        ClearEvents();
+        isBusy = 0;
+    }
+
+    /* GetRestartCount - gets the number of times a block had to be 
+     *     started again because the CCM or AAR needed the AES hardware
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_ECB::GetRestartCount(void)
+    {
+        return restartCount;
+    }
+
+    /* PollEvents - does what the ECB interrupt would do if the block 
+     *     started with StartEncrypt() is done. Call this in a loop if you 
+     *     have to wait for the callback with the interrupts disabled. 
+     *
+     *   NOTE: Do not call this from an interrupt with a higher priority 
+     *     than the ECB. It could run in the middle of the ECB interrupt.
+     * */
+    void YakIO_ECB::PollEvents(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(isBusy==0) return;
+
+        // the interrupt might be pending as well. If so it finds the 
+        // events already cleared and does nothing
+        unsigned int primaskState = EnterCritical();
+        HandleEcbIRQ();
+        ExitCritical(primaskState);
+    }
+
+    /* HandleEcbIRQ - does the work for the IRQ_ECB_handler. You should 
+     *     never need to call this yourself.
+     * */
+    void YakIO_ECB::HandleEcbIRQ(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ERRORECB)!=0)
+        {
+            // the CCM or AAR took the AES hardware. Just go again
+            restartCount = restartCount + 1;
+            ClearEvents();
+            StartBlock();
+            return;
+        }
+        if(YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ENDECB)==0) return;
+
+        ClearEvents();
+        isBusy = 0;
+        CallCallback();
+    }
+
+// #
+// # Private
+// #
+
+    /* ClearEvents - clears the ENDECB and ERRORECB events
+     * */
+    void YakIO_ECB::ClearEvents(void)
+    {
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ENDECB) = 0;
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ERRORECB) = 0;
+    }
+
+    /* StartBlock - points the ECB at our data block and starts it
+     * */
+    void YakIO_ECB::StartBlock(void)
+    {
+        ClearEvents();
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_ECBDATAPTR) = YAKIO_RAM_ADDRESS(&ecbData);
+        YAKIO_REGISTER(REGISTER_ECB+ECBREG_OFFSET_STARTECB) = 1;
+    }
+
+    /* IRQ_ECB_handler
+     *
+     * Note: the address of this function is set in the flash by the linker.
+     *       See the discussion on the IRQ_RNG_handler in YakIO_RNG.cpp
+     *
+     *   Do NOT define this anywhere else. This class needs it here.
+     * */
+    void IRQ_ECB_handler(void)
+    {
+        if(ecb_ptr==NULL) return;
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_IRQ_ENTRY, IRQ_ECB);
+        ecb_ptr->HandleEcbIRQ();
+        YAKIO_TRACE_EVENT(TRACE_IRQ_EXIT, IRQ_ECB);
+    }
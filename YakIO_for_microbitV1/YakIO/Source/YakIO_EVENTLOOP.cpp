@@ -0,0 +1,223 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_EVENTLOOP.h"
+
+    /* constructor
+     *
+     * */
+    YakIO_EVENTLOOP::YakIO_EVENTLOOP()
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        // nobody handles anything yet
+        for(unsigned int i=0; i<EVENTLOOP_MAX_EVENT_TYPES; i++)
+        {
+            handlerPtrs[i]=NULL;
+            handlerPriorities[i]=EVENT_PRIORITY_NORMAL;
+        }
+        // all queues are empty
+        for(unsigned int i=0; i<EVENTLOOP_NUM_PRIORITIES; i++)
+        {
+            queueHead[i]=0;
+            queueTail[i]=0;
+        }
+    }
+
+    /* RegisterHandler - sets the object which will handle an eventType and
+     *     the priority events of that type are dispatched with. The handler
+     *     object must inherit from YakIO_CALLBACK and its EventCallback() 
+     *     function is the one that gets called.
+     *
+     *   NOTE: Only one object can handle each eventType. Registering a second
+     *     one replaces the first.
+     *
+     * inputs:
+     *    eventType - the eventType, must be less than EVENTLOOP_MAX_EVENT_TYPES
+     *    eventPriority - the priority for events of this type
+     *    handlerPtrIn - the "this" pointer of the object to receive the events
+     * */
+    void YakIO_EVENTLOOP::RegisterHandler(unsigned int eventType, enum EVENT_PRIORITY eventPriority, YakIO_CALLBACK *handlerPtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(eventType>=EVENTLOOP_MAX_EVENT_TYPES) return;
+
+        handlerPriorities[eventType] = eventPriority;
+        handlerPtrs[eventType] = handlerPtrIn;
+    }
+
+    /* UnregisterHandler - stops an eventType from being handled. Any events 
+     *     of that type posted from now on are ignored. 
+     *
+     * inputs:
+     *    eventType - the eventType, must be less than EVENTLOOP_MAX_EVENT_TYPES
+     * */
+    void YakIO_EVENTLOOP::UnregisterHandler(unsigned int eventType)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(eventType>=EVENTLOOP_MAX_EVENT_TYPES) return;
+
+        handlerPtrs[eventType] = NULL;
+    }
+
+    /* GetNextQueueIndex - gets the next position in a circular queue
+     *
+     * inputs:
+     *    queueIndex - the current position
+     *
+     * returns:
+     *    the next position, wrapping around at the end of the queue
+     * */
+    unsigned int YakIO_EVENTLOOP::GetNextQueueIndex(unsigned int queueIndex)
+    {
+        queueIndex++;
+        if(queueIndex>=EVENTLOOP_QUEUE_SIZE) queueIndex=0;
+        return queueIndex;
+    }
+
+    /* PostEvent - puts an event in the queue for its priority. This is 
+     *     usually called from an interrupt handler but it can be called 
+     *     from anywhere - including from an EventCallback() handling some
+     *     other event.
+     *
+     *   NOTE: This never waits. If the queue is full the event is dropped 
+     *     and counted. See GetDroppedEventCount()
+     *
+     * inputs:
+     *    eventType - the eventType, must be less than EVENTLOOP_MAX_EVENT_TYPES
+     *    eventData - a value to pass along to the handler
+     *
+     * returns:
+     *    1 if the event was queued, 0 if it was not
+     * */
+    unsigned int YakIO_EVENTLOOP::PostEvent(unsigned int eventType, unsigned int eventData)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(eventType>=EVENTLOOP_MAX_EVENT_TYPES) return 0;
+        // no point queueing things nobody will handle
+        if(handlerPtrs[eventType]==NULL) return 0;
+
+        unsigned int priority = handlerPriorities[eventType];
+
+        // interrupt handlers of different priorities can all post events. We 
+        // have to stop them interrupting each other half way through updating
+        // the queue. This is only a handful of instructions.
+        unsigned int primaskState = EnterCritical();
+        unsigned int tail = queueTail[priority];
+        unsigned int nextTail = GetNextQueueIndex(tail);
+        if(nextTail==queueHead[priority])
+        {
+            // full, we have to drop it
+            droppedEventCount = droppedEventCount + 1;
+            ExitCritical(primaskState);
+            return 0;
+        }
+        eventQueues[priority][tail].eventType = eventType;
+        eventQueues[priority][tail].eventData = eventData;
+        queueTail[priority] = nextTail;
+        ExitCritical(primaskState);
+
+        return 1;
+    }
+
+    /* DispatchOneEvent - takes the oldest event out of the highest priority
+     *     queue which has anything in it and calls its handler. 
+     *
+     *   NOTE: The handler is called with interrupts enabled. We only keep 
+     *     them off for as long as it takes to get the event out of the queue.
+     *
+     * returns:
+     *    1 if an event was dispatched, 0 if all the queues were empty
+     * */
+    unsigned int YakIO_EVENTLOOP::DispatchOneEvent(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        // look at the queues from the highest priority down
+        for(int priority=EVENTLOOP_NUM_PRIORITIES-1; priority>=0; priority--)
+        {
+            // a quick check without disabling interrupts. Only we ever change
+            // queueHead and an interrupt can only make a queue fuller so if
+            // this says there is something there, there really is.
+            if(queueHead[priority]==queueTail[priority]) continue;
+
+            // copy the event out and free up its slot
+            unsigned int primaskState = EnterCritical();
+            unsigned int head = queueHead[priority];
+            unsigned int eventType = eventQueues[priority][head].eventType;
+            unsigned int eventData = eventQueues[priority][head].eventData;
+            queueHead[priority] = GetNextQueueIndex(head);
+            ExitCritical(primaskState);
+
+            // the handler might have been unregistered since the event was posted
+            YakIO_CALLBACK *handlerPtr = handlerPtrs[eventType];
+            if(handlerPtr!=NULL) handlerPtr->EventCallback(eventType, eventData);
+            return 1;
+        }
+        // nothing to do
+        return 0;
+    }
+
+    /* GetDroppedEventCount - gets the number of events which were thrown 
+     *     away because their queue was full. If this is not zero you might 
+     *     want to increase EVENTLOOP_QUEUE_SIZE or make your handlers quicker
+     *
+     * returns:
+     *    the number of events dropped
+     * */
+    unsigned int YakIO_EVENTLOOP::GetDroppedEventCount(void)
+    {
+        return droppedEventCount;
+    }
+
+    /* Run - dispatches events forever. Sleeps when there is nothing to do.
+     *
+     *   NOTE: This never returns. Call it at the end of your MainLoop()
+     *     after all the setup is done.
+     *
+     *   The sleeping is done with the WFE (Wait For Event) instruction. This 
+     *   stops the CPU until something happens. There is a subtle trap here. 
+     *   What if an interrupt posts an event just after we found the queues 
+     *   empty but just before we execute the WFE? We would go to sleep with 
+     *   an event waiting. Fortunately the Cortex-M0 sets its internal "event
+     *   register" whenever it returns from an interrupt handler and WFE will
+     *   not sleep if that register is set (it just clears it). So in the case
+     *   above WFE returns immediately, we go around the loop again and find 
+     *   the event. At worst, we go around the loop one extra time.
+     * */
+    void YakIO_EVENTLOOP::Run(void)
+    {
+        while(1)
+        {
+            if(DispatchOneEvent()==0)
+            {
+                // nothing to do, sleep until something happens. There
+                // is no WFE on the host (see YAKIO_HOST in YakIO.h)
+#ifndef YAKIO_HOST
+                asm volatile ("wfe");
+#else
+                COMPILER_BARRIER();
+#endif
+            }
+        }
+    }
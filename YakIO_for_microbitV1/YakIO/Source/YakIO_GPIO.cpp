@@ -66,7 +66,7 @@
         if(isInitialized!=1) return 0;
 
         // get the current register state
-        unsigned int registerState = (* (unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_IN));
+        unsigned int registerState = YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_IN);
         // detect the value
         if((registerState & (0x01<<gpioPin)) == 0) return 0;
         else return 1;
@@ -89,8 +89,8 @@
         if(isInitialized!=1) return;
 
         // set the output state
-        if(gpioState==0)(*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTCLR)) = (0x01<<gpioPin);
-        else (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTSET)) = (0x01<<gpioPin);
+        if(gpioState==0)YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTCLR) = (0x01<<gpioPin);
+        else YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTSET) = (0x01<<gpioPin);
     }
 
     /* SetGPIOStateHigh - sets the state of the GPIO Pin high
@@ -108,7 +108,7 @@
         if(isInitialized!=1) return;
 
         // set the output state
-        (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTSET)) = (0x01<<gpioPin);
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTSET) = (0x01<<gpioPin);
     }
 
     /* SetGPIOStateLow- sets the state of the GPIO pin low
@@ -126,7 +126,7 @@
         if(isInitialized!=1) return;
 
         // set the output state
-        (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTCLR)) = (0x01<<gpioPin);
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTCLR) = (0x01<<gpioPin);
     }
 
     /* ToggleGPIOState - toggles the state of the GPIO
@@ -157,8 +157,8 @@
         if(isInitialized!=1) return;
 
         // set the current register state
-        (* (unsigned volatile *) (cnfRegisterAddress)) &= GPIO_CNF_REGISTER_DRIVEMODE_MASK;  // clear them all to 0
-        (* (unsigned volatile *) (cnfRegisterAddress)) |= gpioDriveMode; // set them high where needed
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) & GPIO_CNF_REGISTER_DRIVEMODE_MASK;  // clear them all to 0
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) | gpioDriveMode; // set them high where needed
     }
 
     /* GetGPIODir - gets the drive mode of a GPIO.
@@ -176,7 +176,7 @@
         if(isInitialized!=1) return S0S1;
 
         // get the current register state
-        unsigned int registerState = (* (unsigned volatile *) (cnfRegisterAddress));  // Get register
+        unsigned int registerState = YAKIO_REGISTER(cnfRegisterAddress);  // Get register
         // conduct the test
         if((registerState & (~GPIO_CNF_REGISTER_DRIVEMODE_MASK)) == D0H1) return D0H1;
         else if((registerState & (~GPIO_CNF_REGISTER_DRIVEMODE_MASK)) == D0S1) return D0S1;
@@ -205,8 +205,8 @@
         if(gpioPin==Pin11) return;
 
         // set the current register state
-        (* (unsigned volatile *) (cnfRegisterAddress)) &= GPIO_CNF_REGISTER_PULLUPDOWN_MASK;  // clear them all to 0
-        (* (unsigned volatile *) (cnfRegisterAddress)) |= gpioPullUpDown; // set them high where needed
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) & GPIO_CNF_REGISTER_PULLUPDOWN_MASK;  // clear them all to 0
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) | gpioPullUpDown; // set them high where needed
     }
 
     /* GPIOPinPullUpDown - gets the pull up/down of a GPIO.
@@ -232,7 +232,7 @@
         if(gpioPin==Pin11) return PullUpDownPullup;
 
         // get the current register state
-        unsigned int registerState = (* (unsigned volatile *) (cnfRegisterAddress));  // Get register
+        unsigned int registerState = YAKIO_REGISTER(cnfRegisterAddress);  // Get register
         // conduct the test
         if((registerState & (~GPIO_CNF_REGISTER_PULLUPDOWN_MASK)) == PullUpDownPulldown) return PullUpDownPulldown;
         else if((registerState & (~GPIO_CNF_REGISTER_PULLUPDOWN_MASK)) == PullUpDownPullup) return PullUpDownPullup;
@@ -250,8 +250,8 @@
         if(isInitialized!=1) return;
 
         // set the current register state
-        (* (unsigned volatile *) (cnfRegisterAddress)) &= GPIO_CNF_REGISTER_DIRECTION_MASK;  // clear them all to 0
-        (* (unsigned volatile *) (cnfRegisterAddress)) |= gpioPinDir; // set them high where needed
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) & GPIO_CNF_REGISTER_DIRECTION_MASK;  // clear them all to 0
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) | gpioPinDir; // set them high where needed
 
         // since we are a dedicated GPIO port in this class set the input buffer connect mode appropriately
         SetGPIOInputConnect(PinInputBufferDis);
@@ -272,7 +272,7 @@
         if(isInitialized!=1) return PinDirInput;
 
         // get the current register state
-        unsigned int registerState = (* (unsigned volatile *) (cnfRegisterAddress));  // Get register
+        unsigned int registerState = YAKIO_REGISTER(cnfRegisterAddress);  // Get register
         // conduct the test
         if((registerState & (~GPIO_CNF_REGISTER_DIRECTION_MASK)) == 0) return PinDirInput;
         else return PinDirOutput;
@@ -289,8 +289,8 @@
         if(isInitialized!=1) return;
 
         // set the current register state
-        (* (unsigned volatile *) (cnfRegisterAddress)) &= GPIO_CNF_REGISTER_INPUTCONN_MASK;  // clear them all to 0
-        (* (unsigned volatile *) (cnfRegisterAddress)) |= gpioPinConnect; // set it high where needed
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) & GPIO_CNF_REGISTER_INPUTCONN_MASK;  // clear them all to 0
+        YAKIO_REGISTER(cnfRegisterAddress) = YAKIO_REGISTER(cnfRegisterAddress) | gpioPinConnect; // set it high where needed
     }
 
     /* GetGPIODir - gets the direction of a GPIO.
@@ -308,7 +308,7 @@
         if(isInitialized!=1) return PinInputBufferEna;
 
         // get the current register state
-        unsigned int registerState = (* (unsigned volatile *) (cnfRegisterAddress));  // Get register
+        unsigned int registerState = YAKIO_REGISTER(cnfRegisterAddress);  // Get register
         // conduct the test
         if((registerState & (~GPIO_CNF_REGISTER_INPUTCONN_MASK)) == 0) return PinInputBufferDis;
         else return PinInputBufferEna;
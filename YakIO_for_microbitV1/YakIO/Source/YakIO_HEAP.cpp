@@ -0,0 +1,473 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_HEAP.h"
+
+// these come from the linker script (microbit.ld). "top" is the lower address
+extern unsigned char __topOfHeap__[];
+extern unsigned char __bottomOfHeap__[];
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_HEAP - Constructor. Builds the heap over the memory the linker 
+     *     script leaves between the .bss section and the stack reserve. The
+     *     whole heap starts off as one big free block.
+     * */
+    YakIO_HEAP::YakIO_HEAP()
+    {
+        // start and end on a word boundary
+        unsigned int heapStart = ((unsigned int)__topOfHeap__ + (HEAP_ALIGN_SIZE-1)) & ~(HEAP_ALIGN_SIZE-1);
+        unsigned int heapEnd = ((unsigned int)__bottomOfHeap__) & ~(HEAP_ALIGN_SIZE-1);
+
+        flBitmap = 0;
+        for(int fl=0; fl<HEAP_FL_INDEX_COUNT; fl++)
+        {
+            slBitmap[fl] = 0;
+            for(int sl=0; sl<HEAP_SL_INDEX_COUNT; sl++) freeLists[fl][sl] = NULL;
+        }
+        usedBytes = 0;
+        peakUsedBytes = 0;
+        failedCount = 0;
+
+        // we need room for the prevPhysBlock and blockSize of the first block, 
+        // the smallest block and the blockSize of the zero sized end block. If 
+        // the stack reserve has eaten everything we leave isInitialized at 0 
+        // and every Allocate() will simply fail
+        if(heapEnd<=heapStart) return;
+        if((heapEnd-heapStart)<(HEAP_BLOCK_SIZE_MIN+12)) return;
+
+        // the usable part of the one big block
+        unsigned int blockSize = (heapEnd-heapStart) - 12;
+        if(blockSize>HEAP_BLOCK_SIZE_MAX) blockSize = HEAP_BLOCK_SIZE_MAX;
+        totalBytes = blockSize;
+
+        firstBlock = (YakIO_HEAPBLOCK *)heapStart;
+        firstBlock->prevPhysBlock = NULL;
+        firstBlock->blockSize = blockSize;
+        MarkAsFree(firstBlock);
+        InsertFreeBlock(firstBlock);
+
+        // the end block has a size of 0 and is never free so nothing 
+        // ever merges with it
+        lastBlock = GetNextPhysBlock(firstBlock);
+        lastBlock->blockSize = HEAP_BLOCK_PREV_FREE_BIT;
+        lastBlock->prevPhysBlock = firstBlock;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Allocate - gets a block of memory from the heap. Always takes the same
+     *    (short) time however full the heap is. Safe to call from an interrupt 
+     *    handler.
+     *
+     * inputs:
+     *    bytesNeeded - the number of bytes wanted
+     *
+     * returns:
+     *    a pointer to the memory (word aligned) or NULL if there is no free 
+     *    block big enough
+     * */
+    void *YakIO_HEAP::Allocate(unsigned int bytesNeeded)
+    {
+        // we must be initialized
+        if(isInitialized==0) return NULL;
+
+        if((bytesNeeded==0) || (bytesNeeded>HEAP_BLOCK_SIZE_MAX))
+        {
+            failedCount = failedCount + 1;
+            return NULL;
+        }
+
+        // round up to a whole number of words and at least the smallest block
+        unsigned int blockSize = (bytesNeeded + (HEAP_ALIGN_SIZE-1)) & ~(HEAP_ALIGN_SIZE-1);
+        if(blockSize<HEAP_BLOCK_SIZE_MIN) blockSize = HEAP_BLOCK_SIZE_MIN;
+
+        unsigned int primaskState = EnterCritical();
+
+        int fl;
+        int sl;
+        MappingSearch(blockSize, &fl, &sl);
+        YakIO_HEAPBLOCK *blockPtr = NULL;
+        if(fl<HEAP_FL_INDEX_COUNT) blockPtr = SearchSuitableBlock(&fl, &sl);
+        if(blockPtr==NULL)
+        {
+            failedCount = failedCount + 1;
+            ExitCritical(primaskState);
+            return NULL;
+        }
+        RemoveFreeBlock(blockPtr);
+
+        // if it is big enough split off the end and put it back as a new free block.
+        // The new block needs its own header and must be at least the smallest block
+        unsigned int foundSize = GetBlockSize(blockPtr);
+        if(foundSize>=(blockSize+HEAP_BLOCK_OVERHEAD+HEAP_BLOCK_SIZE_MIN))
+        {
+            blockPtr->blockSize = blockSize | (blockPtr->blockSize & (HEAP_BLOCK_FREE_BIT|HEAP_BLOCK_PREV_FREE_BIT));
+            YakIO_HEAPBLOCK *remainderPtr = GetNextPhysBlock(blockPtr);
+            remainderPtr->blockSize = foundSize - blockSize - HEAP_BLOCK_OVERHEAD;
+            MarkAsFree(remainderPtr);
+            InsertFreeBlock(remainderPtr);
+        }
+        MarkAsUsed(blockPtr);
+
+        usedBytes = usedBytes + GetBlockSize(blockPtr);
+        if(usedBytes>peakUsedBytes) peakUsedBytes = usedBytes;
+
+        ExitCritical(primaskState);
+
+        // the memory starts after the blockSize
+        return (void *)&blockPtr->nextFree;
+    }
+
+    /* Free - gives a block of memory back to the heap. It is merged with the
+     *    blocks either side of it if they are free. Always takes the same 
+     *    (short) time. Safe to call from an interrupt handler.
+     *
+     * inputs:
+     *    memPtr - a pointer returned by Allocate(). NULL, pointers which are
+     *       not in the heap and blocks that are already free are ignored
+     * */
+    void YakIO_HEAP::Free(void *memPtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(memPtr==NULL) return;
+
+        YakIO_HEAPBLOCK *blockPtr = (YakIO_HEAPBLOCK *)((unsigned char *)memPtr - 8);
+        if((blockPtr<firstBlock) || (blockPtr>=lastBlock)) return;
+
+        unsigned int primaskState = EnterCritical();
+
+        // freeing it twice would wreck the lists
+        if((blockPtr->blockSize & HEAP_BLOCK_FREE_BIT)!=0)
+        {
+            ExitCritical(primaskState);
+            return;
+        }
+        usedBytes = usedBytes - GetBlockSize(blockPtr);
+        MarkAsFree(blockPtr);
+
+        // merge with the block before it
+        if((blockPtr->blockSize & HEAP_BLOCK_PREV_FREE_BIT)!=0)
+        {
+            YakIO_HEAPBLOCK *prevPtr = blockPtr->prevPhysBlock;
+            RemoveFreeBlock(prevPtr);
+            prevPtr->blockSize = prevPtr->blockSize + GetBlockSize(blockPtr) + HEAP_BLOCK_OVERHEAD;
+            GetNextPhysBlock(prevPtr)->prevPhysBlock = prevPtr;
+            blockPtr = prevPtr;
+        }
+
+        // merge with the block after it. The end block is never free
+        YakIO_HEAPBLOCK *nextPtr = GetNextPhysBlock(blockPtr);
+        if((nextPtr->blockSize & HEAP_BLOCK_FREE_BIT)!=0)
+        {
+            RemoveFreeBlock(nextPtr);
+            blockPtr->blockSize = blockPtr->blockSize + GetBlockSize(nextPtr) + HEAP_BLOCK_OVERHEAD;
+            GetNextPhysBlock(blockPtr)->prevPhysBlock = blockPtr;
+        }
+
+        InsertFreeBlock(blockPtr);
+        ExitCritical(primaskState);
+    }
+
+    /* GetTotalBytes - gets the usable size of the heap when it is empty
+     *
+     * returns:
+     *    the size in bytes or 0 if there is no heap
+     * */
+    unsigned int YakIO_HEAP::GetTotalBytes(void)
+    {
+        return totalBytes;
+    }
+
+    /* GetUsedBytes - gets the bytes currently allocated. Includes the rounding
+     *    up of each block but not the block headers
+     *
+     * returns:
+     *    the bytes in use
+     * */
+    unsigned int YakIO_HEAP::GetUsedBytes(void)
+    {
+        return usedBytes;
+    }
+
+    /* GetPeakUsedBytes - gets the most bytes that have ever been in use at once
+     *
+     * returns:
+     *    the high water mark in bytes
+     * */
+    unsigned int YakIO_HEAP::GetPeakUsedBytes(void)
+    {
+        return peakUsedBytes;
+    }
+
+    /* GetFailedCount - gets the number of times Allocate() returned NULL
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_HEAP::GetFailedCount(void)
+    {
+        return failedCount;
+    }
+
+    /* GetStatistics - walks every block in the heap and works out how much is
+     *    free and how fragmented it is. 
+     *
+     *    NOTE: unlike everything else here this takes longer the more blocks
+     *    there are. Interrupts are disabled while it runs. Do not call it from
+     *    time critical code.
+     *
+     * inputs:
+     *    statsPtr - the structure to fill in
+     * */
+    void YakIO_HEAP::GetStatistics(YakIO_HEAPSTATS *statsPtr)
+    {
+        if(statsPtr==NULL) return;
+        statsPtr->totalBytes = totalBytes;
+        statsPtr->freeBytes = 0;
+        statsPtr->usedBytes = 0;
+        statsPtr->largestFreeBytes = 0;
+        statsPtr->freeBlockCount = 0;
+        statsPtr->usedBlockCount = 0;
+        statsPtr->fragmentationPercent = 0;
+
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        unsigned int primaskState = EnterCritical();
+        for(YakIO_HEAPBLOCK *blockPtr=firstBlock; blockPtr!=lastBlock; blockPtr=GetNextPhysBlock(blockPtr))
+        {
+            unsigned int blockSize = GetBlockSize(blockPtr);
+            if((blockPtr->blockSize & HEAP_BLOCK_FREE_BIT)!=0)
+            {
+                statsPtr->freeBytes += blockSize;
+                statsPtr->freeBlockCount++;
+                if(blockSize>statsPtr->largestFreeBytes) statsPtr->largestFreeBytes = blockSize;
+            }
+            else
+            {
+                statsPtr->usedBytes += blockSize;
+                statsPtr->usedBlockCount++;
+            }
+        }
+        ExitCritical(primaskState);
+
+        if(statsPtr->freeBytes!=0)
+        {
+            statsPtr->fragmentationPercent = 100 - ((statsPtr->largestFreeBytes*100)/statsPtr->freeBytes);
+        }
+    }
+
+// #
+// # Private
+// #
+
+    /* FindLastSet - finds the highest set bit. The Cortex-M0 has no CLZ 
+     *    instruction so this is a binary search. Always 5 steps.
+     *
+     * inputs:
+     *    wordToTest - the word
+     *
+     * returns:
+     *    the bit number 0-31 or -1 if no bits are set
+     * */
+    int YakIO_HEAP::FindLastSet(unsigned int wordToTest)
+    {
+        if(wordToTest==0) return -1;
+        int bitNum = 0;
+        if((wordToTest & 0xFFFF0000)!=0) { wordToTest = wordToTest >> 16; bitNum += 16; }
+        if((wordToTest & 0x0000FF00)!=0) { wordToTest = wordToTest >> 8; bitNum += 8; }
+        if((wordToTest & 0x000000F0)!=0) { wordToTest = wordToTest >> 4; bitNum += 4; }
+        if((wordToTest & 0x0000000C)!=0) { wordToTest = wordToTest >> 2; bitNum += 2; }
+        if((wordToTest & 0x00000002)!=0) { bitNum += 1; }
+        return bitNum;
+    }
+
+    /* FindFirstSet - finds the lowest set bit. x & -x leaves only the lowest
+     *    set bit so the lowest is also the highest
+     *
+     * inputs:
+     *    wordToTest - the word
+     *
+     * returns:
+     *    the bit number 0-31 or -1 if no bits are set
+     * */
+    int YakIO_HEAP::FindFirstSet(unsigned int wordToTest)
+    {
+        return FindLastSet(wordToTest & (0-wordToTest));
+    }
+
+    /* GetBlockSize - gets the usable size of a block without the flag bits
+     * */
+    unsigned int YakIO_HEAP::GetBlockSize(YakIO_HEAPBLOCK *blockPtr)
+    {
+        return blockPtr->blockSize & ~(HEAP_BLOCK_FREE_BIT|HEAP_BLOCK_PREV_FREE_BIT);
+    }
+
+    /* GetNextPhysBlock - gets the block after this one in memory. The usable 
+     *    memory starts at nextFree, so the next block starts blockSize bytes 
+     *    after that less the 4 bytes of its prevPhysBlock which live in the 
+     *    last word of this block
+     * */
+    YakIO_HEAPBLOCK *YakIO_HEAP::GetNextPhysBlock(YakIO_HEAPBLOCK *blockPtr)
+    {
+        return (YakIO_HEAPBLOCK *)((unsigned char *)&blockPtr->nextFree + GetBlockSize(blockPtr) - HEAP_BLOCK_OVERHEAD);
+    }
+
+    /* MappingInsert - works out which free list a block of a given size
+     *    belongs in
+     *
+     * inputs:
+     *    blockSize - the usable size of the block
+     *    flPtr, slPtr - the first and second level indexes are returned here
+     * */
+    void YakIO_HEAP::MappingInsert(unsigned int blockSize, int *flPtr, int *slPtr)
+    {
+        if(blockSize<HEAP_SMALL_BLOCK_SIZE)
+        {
+            // the small blocks all go in the first row, one list per 4 bytes
+            *flPtr = 0;
+            *slPtr = blockSize / (HEAP_SMALL_BLOCK_SIZE/HEAP_SL_INDEX_COUNT);
+            return;
+        }
+        int fl = FindLastSet(blockSize);
+        // the HEAP_SL_INDEX_COUNT_LOG2 bits below the top bit pick the second level
+        *slPtr = (blockSize >> (fl-HEAP_SL_INDEX_COUNT_LOG2)) ^ (1<<HEAP_SL_INDEX_COUNT_LOG2);
+        *flPtr = fl - (HEAP_FL_INDEX_SHIFT-1);
+    }
+
+    /* MappingSearch - works out the first free list in which EVERY block is 
+     *    at least a given size. That means rounding the size up to the start
+     *    of the next list so we never have to look at more than the first 
+     *    block in a list.
+     *
+     * inputs:
+     *    blockSize - the usable size wanted
+     *    flPtr, slPtr - the first and second level indexes are returned here. 
+     *       The fl can be HEAP_FL_INDEX_COUNT if the size is too big
+     * */
+    void YakIO_HEAP::MappingSearch(unsigned int blockSize, int *flPtr, int *slPtr)
+    {
+        if(blockSize>=HEAP_SMALL_BLOCK_SIZE)
+        {
+            blockSize = blockSize + (1<<(FindLastSet(blockSize)-HEAP_SL_INDEX_COUNT_LOG2)) - 1;
+        }
+        MappingInsert(blockSize, flPtr, slPtr);
+    }
+
+    /* SearchSuitableBlock - finds the first non empty free list at or after 
+     *    a given one using the bitmaps
+     *
+     * inputs:
+     *    flPtr, slPtr - the list to start at. The list actually used is
+     *       returned here
+     *
+     * returns:
+     *    the first block in that list or NULL if there is nothing big enough
+     * */
+    YakIO_HEAPBLOCK *YakIO_HEAP::SearchSuitableBlock(int *flPtr, int *slPtr)
+    {
+        int fl = *flPtr;
+
+        // anything in this row at or after the second level we want?
+        unsigned int slMap = slBitmap[fl] & (0xFFFFFFFF << *slPtr);
+        if(slMap==0)
+        {
+            // no, so take the first list in the next non empty row
+            unsigned int flMap = flBitmap & (0xFFFFFFFF << (fl+1));
+            if(flMap==0) return NULL;
+            fl = FindFirstSet(flMap);
+            slMap = slBitmap[fl];
+        }
+        int sl = FindFirstSet(slMap);
+        *flPtr = fl;
+        *slPtr = sl;
+        return freeLists[fl][sl];
+    }
+
+    /* RemoveFreeBlock - takes a free block off its free list
+     * */
+    void YakIO_HEAP::RemoveFreeBlock(YakIO_HEAPBLOCK *blockPtr)
+    {
+        int fl;
+        int sl;
+        MappingInsert(GetBlockSize(blockPtr), &fl, &sl);
+
+        YakIO_HEAPBLOCK *prevPtr = blockPtr->prevFree;
+        YakIO_HEAPBLOCK *nextPtr = blockPtr->nextFree;
+        if(nextPtr!=NULL) nextPtr->prevFree = prevPtr;
+        if(prevPtr!=NULL) prevPtr->nextFree = nextPtr;
+
+        // if it was at the front of the list the list now starts at the next one
+        if(freeLists[fl][sl]==blockPtr)
+        {
+            freeLists[fl][sl] = nextPtr;
+            if(nextPtr==NULL)
+            {
+                // the list is empty, and maybe the whole row is too
+                slBitmap[fl] = slBitmap[fl] & ~(1U<<sl);
+                if(slBitmap[fl]==0) flBitmap = flBitmap & ~(1U<<fl);
+            }
+        }
+    }
+
+    /* InsertFreeBlock - puts a free block on the front of its free list
+     * */
+    void YakIO_HEAP::InsertFreeBlock(YakIO_HEAPBLOCK *blockPtr)
+    {
+        int fl;
+        int sl;
+        MappingInsert(GetBlockSize(blockPtr), &fl, &sl);
+
+        YakIO_HEAPBLOCK *headPtr = freeLists[fl][sl];
+        blockPtr->nextFree = headPtr;
+        blockPtr->prevFree = NULL;
+        if(headPtr!=NULL) headPtr->prevFree = blockPtr;
+        freeLists[fl][sl] = blockPtr;
+
+        flBitmap = flBitmap | (1U<<fl);
+        slBitmap[fl] = slBitmap[fl] | (1U<<sl);
+    }
+
+    /* MarkAsFree - flags a block as free and tells the next block in memory
+     *    where it is so they can be merged later
+     * */
+    void YakIO_HEAP::MarkAsFree(YakIO_HEAPBLOCK *blockPtr)
+    {
+        blockPtr->blockSize = blockPtr->blockSize | HEAP_BLOCK_FREE_BIT;
+        YakIO_HEAPBLOCK *nextPtr = GetNextPhysBlock(blockPtr);
+        nextPtr->prevPhysBlock = blockPtr;
+        nextPtr->blockSize = nextPtr->blockSize | HEAP_BLOCK_PREV_FREE_BIT;
+    }
+
+    /* MarkAsUsed - flags a block as in use and tells the next block in memory
+     * */
+    void YakIO_HEAP::MarkAsUsed(YakIO_HEAPBLOCK *blockPtr)
+    {
+        blockPtr->blockSize = blockPtr->blockSize & ~HEAP_BLOCK_FREE_BIT;
+        YakIO_HEAPBLOCK *nextPtr = GetNextPhysBlock(blockPtr);
+        nextPtr->blockSize = nextPtr->blockSize & ~HEAP_BLOCK_PREV_FREE_BIT;
+    }
@@ -0,0 +1,160 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_HMAC.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_HMAC - Constructor. Start() must be called with a key
+     * */
+    YakIO_HMAC::YakIO_HMAC()
+    {
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - sets the key and gets ready for the first message
+     *
+     * inputs:
+     *    keyBytes - the key
+     *    keyLength - the key length in bytes. Keys longer than 
+     *       SHA256_BLOCK_BYTES are hashed first, as RFC 2104 says. 32 bytes 
+     *       from the RNG is a good key
+     * */
+    void YakIO_HMAC::Start(const unsigned char *keyBytes, unsigned int keyLength)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((keyBytes==NULL) && (keyLength!=0)) return;
+
+        // the key is zero padded to a block
+        unsigned char padBytes[SHA256_BLOCK_BYTES];
+        for(int i=0; i<SHA256_BLOCK_BYTES; i++) padBytes[i] = 0;
+        if(keyLength>SHA256_BLOCK_BYTES)
+        {
+            innerHash.Hash(keyBytes, keyLength, padBytes);
+        }
+        else
+        {
+            for(unsigned int i=0; i<keyLength; i++) padBytes[i] = keyBytes[i];
+        }
+
+        // hash the two padded keys once. Every message starts from these
+        for(int i=0; i<SHA256_BLOCK_BYTES; i++) padBytes[i] = padBytes[i] ^ HMAC_IPAD_BYTE;
+        innerStartHash.Start();
+        innerStartHash.Update(padBytes, SHA256_BLOCK_BYTES);
+        for(int i=0; i<SHA256_BLOCK_BYTES; i++) padBytes[i] = padBytes[i] ^ (HMAC_IPAD_BYTE ^ HMAC_OPAD_BYTE);
+        outerStartHash.Start();
+        outerStartHash.Update(padBytes, SHA256_BLOCK_BYTES);
+
+        // do not leave the key on the stack
+        for(int i=0; i<SHA256_BLOCK_BYTES; i++) padBytes[i] = 0;
+        hasKey = 1;
+        Restart();
+    }
+
+    /* Restart - forgets any message given to Update() and starts a new 
+     *     one with the same key. Finish() does this itself
+     * */
+    void YakIO_HMAC::Restart(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        innerHash = innerStartHash;
+    }
+
+    /* Update - adds some bytes of the message
+     *
+     * inputs:
+     *    dataBytes - the bytes
+     *    byteCount - the number of bytes
+     * */
+    void YakIO_HMAC::Update(const unsigned char *dataBytes, unsigned int byteCount)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(hasKey==0) return;
+
+        innerHash.Update(dataBytes, byteCount);
+    }
+
+    /* Finish - works out the HMAC of the message and gets ready for the 
+     *     next one
+     *
+     * inputs:
+     *    macBytes - where to put the HMAC_MAC_BYTES byte HMAC
+     * */
+    void YakIO_HMAC::Finish(unsigned char *macBytes)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((hasKey==0) || (macBytes==NULL)) return;
+
+        unsigned char innerBytes[SHA256_HASH_BYTES];
+        innerHash.Finish(innerBytes);
+        innerHash = outerStartHash;
+        innerHash.Update(innerBytes, SHA256_HASH_BYTES);
+        innerHash.Finish(macBytes);
+        Restart();
+    }
+
+    /* FinishAndCheck - works out the HMAC of the message and compares it 
+     *     with the one given. Takes the same time whether it matches or not
+     *
+     * inputs:
+     *    expectedMac - the HMAC that came with the message
+     *    macLength - the number of bytes of it to check. An HMAC can be 
+     *       cut short to save space, 16 bytes is the least that makes sense
+     * returns:
+     *    nz if it matches, z if it does not
+     * */
+    unsigned int YakIO_HMAC::FinishAndCheck(const unsigned char *expectedMac, unsigned int macLength)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((hasKey==0) || (expectedMac==NULL) || (macLength==0) || (macLength>HMAC_MAC_BYTES)) return 0;
+
+        unsigned char macBytes[HMAC_MAC_BYTES];
+        Finish(macBytes);
+
+        // no early exit, see the note in YakIO_HMAC.h
+        unsigned int differentBits = 0;
+        for(unsigned int i=0; i<macLength; i++) differentBits = differentBits | (macBytes[i] ^ expectedMac[i]);
+        return (differentBits==0);
+    }
+
+    /* Stop - wipes the key. Start() must be called again before the next
+     *     message
+     * */
+    void YakIO_HMAC::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        hasKey = 0;
+        innerHash.Start();
+        innerStartHash.Start();
+        outerStartHash.Start();
+    }
@@ -0,0 +1,321 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+// NOTE: this whole file is only compiled when YAKIO_HOST is defined. See 
+//       the note on the HOST MEDIUM in YakIO_HOSTMEDIUM.h
+#ifdef YAKIO_HOST
+
+#include "YakIO.h"
+#include "YakIO_HOSTMEDIUM.h"
+#include "YakIO_CCM.h"
+#include "YakIO_ECB.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_RNG.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_TRACE.h"
+#include "YakIO_UART.h"
+
+// the globals the interrupt handlers find the YakIO objects with. Each 
+// is set by the constructor of its class. Nothing else needs to see them
+// so they are not in the headers
+extern YakIO_TIMER *timer_ptr0;
+extern YakIO_TIMER *timer_ptr1;
+extern YakIO_TIMER *timer_ptr2;
+extern YakIO_RADIO *radio_ptr;
+extern YakIO_RNG *rng_ptr;
+extern YakIO_ECB *ecb_ptr;
+extern YakIO_CCM *ccm_ptr;
+extern YakIO_UART *uart_ptr;
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_HOSTMEDIUM - Constructor. Node 0 is selected and every clock
+     *     is exact
+     * */
+    YakIO_HOSTMEDIUM::YakIO_HOSTMEDIUM()
+    {
+        nodeRegistersPtr[0] = &hostRegisters;
+        for(int i=1; i<HOSTMEDIUM_NODE_COUNT; i++) nodeRegistersPtr[i] = &otherRegisters[i-1];
+        for(int i=0; i<HOSTMEDIUM_NODE_COUNT; i++)
+        {
+            clockPpm[i] = 0;
+            lastStartCycle[i] = 0;
+            lossPeriod[i] = 0;
+            sentCount[i] = 0;
+            for(int j=0; j<3; j++) nodeTimerPtrs[i][j] = NULL;
+            nodeRadioPtr[i] = NULL;
+            nodeRngPtr[i] = NULL;
+            nodeEcbPtr[i] = NULL;
+            nodeCcmPtr[i] = NULL;
+            nodeUartPtr[i] = NULL;
+            nodeTracePtr[i] = NULL;
+        }
+    }
+
+// #
+// # Public
+// #
+
+    /* Reset - puts every node back to power on. Any YakIO objects already 
+     *     created are forgotten, create them again after this. The clocks
+     *     keep the ppm and the packet loss they were set to
+     * */
+    void YakIO_HOSTMEDIUM::Reset(void)
+    {
+        for(int i=0; i<HOSTMEDIUM_NODE_COUNT; i++)
+        {
+            nodeRegistersPtr[i]->Reset();
+            lastStartCycle[i] = 0;
+            sentCount[i] = 0;
+            for(int j=0; j<3; j++) nodeTimerPtrs[i][j] = NULL;
+            nodeRadioPtr[i] = NULL;
+            nodeRngPtr[i] = NULL;
+            nodeEcbPtr[i] = NULL;
+            nodeCcmPtr[i] = NULL;
+            nodeUartPtr[i] = NULL;
+            nodeTracePtr[i] = NULL;
+        }
+        cycleCount = 0;
+        deliveredCount = 0;
+        lostCount = 0;
+
+        // node 0, with nothing created yet
+        selectedNode = 0;
+        activeHostRegisters = nodeRegistersPtr[0];
+        timer_ptr0 = NULL;
+        timer_ptr1 = NULL;
+        timer_ptr2 = NULL;
+        radio_ptr = NULL;
+        rng_ptr = NULL;
+        ecb_ptr = NULL;
+        ccm_ptr = NULL;
+        uart_ptr = NULL;
+        trace_ptr = NULL;
+    }
+
+    /* SelectNode - makes a node the micro:bit YAKIO_REGISTER() and the
+     *     interrupt handlers work with. The globals of the node selected 
+     *     before are kept for it
+     *
+     * inputs:
+     *    nodeIndex - 0 to HOSTMEDIUM_NODE_COUNT-1
+     * */
+    void YakIO_HOSTMEDIUM::SelectNode(unsigned int nodeIndex)
+    {
+        if(nodeIndex>=HOSTMEDIUM_NODE_COUNT) return;
+
+        // keep the ones we have
+        nodeTimerPtrs[selectedNode][0] = timer_ptr0;
+        nodeTimerPtrs[selectedNode][1] = timer_ptr1;
+        nodeTimerPtrs[selectedNode][2] = timer_ptr2;
+        nodeRadioPtr[selectedNode] = radio_ptr;
+        nodeRngPtr[selectedNode] = rng_ptr;
+        nodeEcbPtr[selectedNode] = ecb_ptr;
+        nodeCcmPtr[selectedNode] = ccm_ptr;
+        nodeUartPtr[selectedNode] = uart_ptr;
+        nodeTracePtr[selectedNode] = trace_ptr;
+
+        // and put the new node's in their place
+        selectedNode = nodeIndex;
+        activeHostRegisters = nodeRegistersPtr[nodeIndex];
+        timer_ptr0 = nodeTimerPtrs[nodeIndex][0];
+        timer_ptr1 = nodeTimerPtrs[nodeIndex][1];
+        timer_ptr2 = nodeTimerPtrs[nodeIndex][2];
+        radio_ptr = nodeRadioPtr[nodeIndex];
+        rng_ptr = nodeRngPtr[nodeIndex];
+        ecb_ptr = nodeEcbPtr[nodeIndex];
+        ccm_ptr = nodeCcmPtr[nodeIndex];
+        uart_ptr = nodeUartPtr[nodeIndex];
+        trace_ptr = nodeTracePtr[nodeIndex];
+    }
+
+    /* GetSelectedNode - gets the node SelectNode() last selected
+     *
+     * returns:
+     *    the node index
+     * */
+    unsigned int YakIO_HOSTMEDIUM::GetSelectedNode(void)
+    {
+        return selectedNode;
+    }
+
+    /* SetClockPpm - sets how far out a node's crystal is. Set it before
+     *     the first Advance(), changing it later makes the node's clock jump
+     *
+     * inputs:
+     *    nodeIndex - 0 to HOSTMEDIUM_NODE_COUNT-1
+     *    clockPpmIn - parts per million fast, negative for slow
+     * */
+    void YakIO_HOSTMEDIUM::SetClockPpm(unsigned int nodeIndex, int clockPpmIn)
+    {
+        if(nodeIndex>=HOSTMEDIUM_NODE_COUNT) return;
+        clockPpm[nodeIndex] = clockPpmIn;
+    }
+
+    /* SetPacketLoss - makes some of the packets a node sends get lost on
+     *     the way. Nobody hears them
+     *
+     * inputs:
+     *    nodeIndex - 0 to HOSTMEDIUM_NODE_COUNT-1
+     *    lossPeriodIn - every this many'th packet it sends is lost, 4 loses
+     *       a quarter of them. 0 loses none
+     * */
+    void YakIO_HOSTMEDIUM::SetPacketLoss(unsigned int nodeIndex, unsigned int lossPeriodIn)
+    {
+        if(nodeIndex>=HOSTMEDIUM_NODE_COUNT) return;
+        lossPeriod[nodeIndex] = lossPeriodIn;
+        sentCount[nodeIndex] = 0;
+    }
+
+    /* Advance - moves every node on, and carries the packets between them.
+     *     The node selected beforehand is selected again afterwards
+     *
+     * inputs:
+     *    cpuCycles - the number of 16MHz cycles of real time
+     * */
+    void YakIO_HOSTMEDIUM::Advance(unsigned int cpuCycles)
+    {
+        unsigned int nodeWasSelected = selectedNode;
+        while(cpuCycles>0)
+        {
+            unsigned int stepCycles = cpuCycles;
+            if(stepCycles>HOSTMEDIUM_STEP_CYCLES) stepCycles = HOSTMEDIUM_STEP_CYCLES;
+            cycleCount = cycleCount + stepCycles;
+
+            // every node gets as far as its own clock says it should
+            for(unsigned int i=0; i<HOSTMEDIUM_NODE_COUNT; i++)
+            {
+                unsigned long long nodeCycle = GetNodeCycle(i, cycleCount);
+                unsigned long long nowCycle = nodeRegistersPtr[i]->GetCycleCount();
+                if(nodeCycle<=nowCycle) continue;
+                SelectNode(i);
+                nodeRegistersPtr[i]->Advance((unsigned int)(nodeCycle - nowCycle));
+            }
+
+            // only now are they all at the same time, so a packet can go
+            // from any of them to any other
+            for(unsigned int i=0; i<HOSTMEDIUM_NODE_COUNT; i++) SendPacket(i);
+            cpuCycles = cpuCycles - stepCycles;
+        }
+        SelectNode(nodeWasSelected);
+    }
+
+    /* GetCycleCount - gets the real time
+     *
+     * returns:
+     *    the number of 16MHz cycles Advance() has been given since Reset()
+     * */
+    unsigned long long YakIO_HOSTMEDIUM::GetCycleCount(void)
+    {
+        return cycleCount;
+    }
+
+    /* GetDeliveredCount - gets the number of packets one node heard from
+     *     another since Reset()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_HOSTMEDIUM::GetDeliveredCount(void)
+    {
+        return deliveredCount;
+    }
+
+    /* GetLostCount - gets the number of packets SetPacketLoss() has lost 
+     *     since Reset()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_HOSTMEDIUM::GetLostCount(void)
+    {
+        return lostCount;
+    }
+
+// #
+// # Private
+// #
+
+    /* GetNodeCycle - turns real time into a node's time
+     *
+     * inputs:
+     *    nodeIndex - the node
+     *    mediumCycle - the real time
+     * returns:
+     *    the GetCycleCount() the node has then
+     * */
+    unsigned long long YakIO_HOSTMEDIUM::GetNodeCycle(unsigned int nodeIndex, unsigned long long mediumCycle)
+    {
+        return (mediumCycle * (unsigned long long)(HOSTMEDIUM_PPM_SCALE + clockPpm[nodeIndex])) / HOSTMEDIUM_PPM_SCALE;
+    }
+
+    /* GetMediumCycle - turns a node's time into real time
+     *
+     * inputs:
+     *    nodeIndex - the node
+     *    nodeCycle - the node's GetCycleCount()
+     * returns:
+     *    the real time
+     * */
+    unsigned long long YakIO_HOSTMEDIUM::GetMediumCycle(unsigned int nodeIndex, unsigned long long nodeCycle)
+    {
+        return (nodeCycle * HOSTMEDIUM_PPM_SCALE) / (unsigned long long)(HOSTMEDIUM_PPM_SCALE + clockPpm[nodeIndex]);
+    }
+
+    /* SendPacket - if a node has started sending a packet since we last
+     *     looked, hands it to every other node
+     *
+     * inputs:
+     *    nodeIndex - the node that might be sending
+     * */
+    void YakIO_HOSTMEDIUM::SendPacket(unsigned int nodeIndex)
+    {
+        YakIO_HOSTREGISTERS *senderPtr = nodeRegistersPtr[nodeIndex];
+        if(senderPtr->Peek(REGISTER_RADIO+RADIOREG_OFFSET_STATE)!=RADIO_HWSTATE_TX) return;
+        unsigned long long startCycle = senderPtr->GetRadioStartCycle();
+        if(startCycle==lastStartCycle[nodeIndex]) return;
+        unsigned char packetBytes[HOSTREG_RADIO_PACKET_BYTES];
+        if(senderPtr->GetRadioAirPacket(packetBytes)==0) return;
+        lastStartCycle[nodeIndex] = startCycle;
+        sentCount[nodeIndex] = sentCount[nodeIndex] + 1;
+        if((lossPeriod[nodeIndex]!=0) && ((sentCount[nodeIndex] % lossPeriod[nodeIndex])==0))
+        {
+            lostCount = lostCount + 1;
+            return;
+        }
+
+        unsigned int radioFrequency = senderPtr->Peek(REGISTER_RADIO+RADIOREG_OFFSET_FREQUENCY);
+        unsigned int baseAddress = senderPtr->Peek(REGISTER_RADIO+RADIOREG_OFFSET_BASE0);
+        unsigned int prefixByte = senderPtr->Peek(REGISTER_RADIO+RADIOREG_OFFSET_PREFIX0) & 0xFF;
+        unsigned long long mediumStartCycle = GetMediumCycle(nodeIndex, startCycle);
+        for(unsigned int i=0; i<HOSTMEDIUM_NODE_COUNT; i++)
+        {
+            if(i==nodeIndex) continue;
+
+            // when it started by this node's clock. Rounding can put that 
+            // a cycle after now
+            YakIO_HOSTREGISTERS *receiverPtr = nodeRegistersPtr[i];
+            unsigned long long receiverStartCycle = GetNodeCycle(i, mediumStartCycle);
+            unsigned long long receiverNowCycle = receiverPtr->GetCycleCount();
+            unsigned int cyclesOnAir = 0;
+            if(receiverNowCycle>receiverStartCycle) cyclesOnAir = (unsigned int)(receiverNowCycle - receiverStartCycle);
+            if(receiverPtr->InjectRadioPacket(radioFrequency, baseAddress, prefixByte, packetBytes, 1, cyclesOnAir)!=0) deliveredCount = deliveredCount + 1;
+        }
+    }
+
+#endif
@@ -0,0 +1,1550 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+// NOTE: this whole file is only compiled when YAKIO_HOST is defined. See 
+//       the note on the HOST REGISTER FILE in YakIO_HOSTREGISTERS.h
+#ifdef YAKIO_HOST
+
+#include "YakIO.h"
+#include "YakIO_HOSTREGISTERS.h"
+#include "YakIO_CCM.h"
+#include "YakIO_CLOCK.h"
+#include "YakIO_ECB.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_NVIC.h"
+#include "YakIO_PPI.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_RNG.h"
+#include "YakIO_SOFTAES.h"
+#include "YakIO_TIMER.h"
+#include "YakIO_UART.h"
+
+// the interrupt handlers we can call. They are declared weak so that if 
+// the program being built does not include (say) YakIO_RNG then there is 
+// no IRQ_RNG_handler and its address is just zero. See CallIRQHandler()
+void IRQ_RADIO_handler(void) __attribute__ ((weak));
+void IRQ_TIMER0_handler(void) __attribute__ ((weak));
+void IRQ_TIMER1_handler(void) __attribute__ ((weak));
+void IRQ_TIMER2_handler(void) __attribute__ ((weak));
+void IRQ_RNG_handler(void) __attribute__ ((weak));
+void IRQ_ECB_handler(void) __attribute__ ((weak));
+void IRQ_AAR_CCM_handler(void) __attribute__ ((weak));
+
+// the event and task of the pre-programmed PPI channels 20 to 31, in 
+// order. The RTC0 offset is from the nrf51 reference manual
+static const unsigned int fixedPpiEvents[PPI_NUM_CHANNELS-PPI_CH_TIMER0_COMPARE0_RADIO_TXEN] =
+{
+    REGISTER_TIMER0+TIMERREG_OFFSET_COMPARE_0,  // 20
+    REGISTER_TIMER0+TIMERREG_OFFSET_COMPARE_0,  // 21
+    REGISTER_TIMER0+TIMERREG_OFFSET_COMPARE_1,  // 22
+    REGISTER_RADIO+RADIOREG_OFFSET_BCMATCH,     // 23
+    REGISTER_RADIO+RADIOREG_OFFSET_READY,       // 24
+    REGISTER_RADIO+RADIOREG_OFFSET_ADDRESS,     // 25
+    REGISTER_RADIO+RADIOREG_OFFSET_ADDRESS,     // 26
+    REGISTER_RADIO+RADIOREG_OFFSET_END,         // 27
+    REGISTER_RTC0+0x140,                        // 28 COMPARE[0]
+    REGISTER_RTC0+0x140,                        // 29 COMPARE[0]
+    REGISTER_RTC0+0x140,                        // 30 COMPARE[0]
+    REGISTER_RTC0+0x140                         // 31 COMPARE[0]
+};
+static const unsigned int fixedPpiTasks[PPI_NUM_CHANNELS-PPI_CH_TIMER0_COMPARE0_RADIO_TXEN] =
+{
+    REGISTER_RADIO+RADIOREG_OFFSET_TXEN,        // 20
+    REGISTER_RADIO+RADIOREG_OFFSET_RXEN,        // 21
+    REGISTER_RADIO+RADIOREG_OFFSET_DISABLE,     // 22
+    REGISTER_AAR+0x000,                         // 23 START
+    REGISTER_CCM+CCMREG_OFFSET_KSGEN,           // 24
+    REGISTER_CCM+CCMREG_OFFSET_CRYPT,           // 25
+    REGISTER_TIMER0+TIMERREG_OFFSET_CAPTURE_1,  // 26
+    REGISTER_TIMER0+TIMERREG_OFFSET_CAPTURE_2,  // 27
+    REGISTER_RADIO+RADIOREG_OFFSET_TXEN,        // 28
+    REGISTER_RADIO+RADIOREG_OFFSET_RXEN,        // 29
+    REGISTER_TIMER0+TIMERREG_OFFSET_CLEAR,      // 30
+    REGISTER_TIMER0+TIMERREG_OFFSET_START       // 31
+};
+
+// the register file and the one YAKIO_REGISTER() uses. They are the same 
+// thing unless YakIO_HOSTMEDIUM is running more than one micro:bit
+YakIO_HOSTREGISTERS hostRegisters;
+YakIO_HOSTREGISTERS *activeHostRegisters = &hostRegisters;
+
+// #
+// # YakIO_HOSTREGISTER - a single register. These are what the 
+// # YAKIO_REGISTER() macro turns into
+// #
+
+    /* YakIO_HOSTREGISTER - Constructor
+     *
+     * inputs:
+     *    registerAddressIn - the address of the register on the microbit
+     * */
+    YakIO_HOSTREGISTER::YakIO_HOSTREGISTER(unsigned int registerAddressIn)
+    {
+        registerAddress = registerAddressIn;
+    }
+
+    /* operator unsigned int - a read of the register
+     * */
+    YakIO_HOSTREGISTER::operator unsigned int() const
+    {
+        return activeHostRegisters->Read(registerAddress);
+    }
+
+    /* operator= - a write to the register
+     *
+     * inputs:
+     *    registerValue - the value to write
+     * */
+    YakIO_HOSTREGISTER &YakIO_HOSTREGISTER::operator=(unsigned int registerValue)
+    {
+        activeHostRegisters->Write(registerAddress, registerValue);
+        return *this;
+    }
+
+    /* operator= - a read of one register and a write of the value to this
+     *    one. This has to exist or the compiler will just copy the address
+     *
+     * inputs:
+     *    otherRegister - the register to read
+     * */
+    YakIO_HOSTREGISTER &YakIO_HOSTREGISTER::operator=(const YakIO_HOSTREGISTER &otherRegister)
+    {
+        activeHostRegisters->Write(registerAddress, (unsigned int)otherRegister);
+        return *this;
+    }
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_HOSTREGISTERS - Constructor
+     * */
+    YakIO_HOSTREGISTERS::YakIO_HOSTREGISTERS()
+    {
+        Reset();
+    }
+
+// #
+// # Public
+// #
+
+    /* Reset - puts every register back to its reset value, stops the models 
+     *    and zeros all of the counts. Do this at the start of every test
+     * */
+    void YakIO_HOSTREGISTERS::Reset(void)
+    {
+        for(int i=0; i<HOSTREG_PAGE_COUNT; i++)
+        {
+            for(int j=0; j<HOSTREG_PAGE_WORDS; j++) pageWords[i][j] = 0;
+        }
+        // the PIN_CNF[n] registers reset with the input buffer disconnected
+        for(int i=0; i<32; i++)
+        {
+            GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_PIN_CNF_BASE+(i*BYTES_IN_REGISTER)) = 0x00000002;
+        }
+        for(int i=0; i<HOSTREG_TIMER_COUNT; i++)
+        {
+            timerCounter[i] = 0;
+            timerIsRunning[i] = 0;
+            timerCycleRemainder[i] = 0;
+        }
+        inputPins = 0;
+        rngIsRunning = 0;
+        activeIRQBits = 0;
+        rngCycleRemainder = 0;
+        rngState = HOSTREG_RNG_DEFAULT_SEED;
+        rngStuckPeriod = 0;
+        rngStuckCount = 0;
+        cycleCount = 0;
+        for(int i=0; i<HOSTREG_RAM_POINTER_COUNT; i++) ramPointers[i] = NULL;
+        ramPointerNext = 0;
+        // the RADIO is the one peripheral that resets powered up
+        GetWord(HOSTREG_PAGE_OF(REGISTER_RADIO), RADIOREG_OFFSET_POWER) = RADIO_POWER_ON;
+        radioCyclesToEvent = 0;
+        radioAddressCycle = 0;
+        radioStartCycle = 0;
+        radioTxCount = 0;
+        radioTxFrequency = 0;
+        ResetCounters();
+    }
+
+    /* Read - reads a register, this is what YAKIO_REGISTER() calls
+     *
+     * inputs:
+     *    registerAddress - the address of the register on the microbit
+     * returns:
+     *    the register value. Unmapped addresses read as zero
+     * */
+    unsigned int YakIO_HOSTREGISTERS::Read(unsigned int registerAddress)
+    {
+        readCount = readCount + 1;
+        int pageIndex = GetPageIndex(registerAddress);
+        if(pageIndex==HOSTREG_PAGE_NONE)
+        {
+            unmappedCount = unmappedCount + 1;
+            return 0;
+        }
+        pageReadCount[pageIndex] = pageReadCount[pageIndex] + 1;
+        unsigned int registerOffset = registerAddress & (HOSTREG_PAGE_SIZE-1);
+
+        if(pageIndex==HOSTREG_PAGE_GPIO) return ReadGPIO(registerOffset);
+        if(pageIndex==HOSTREG_PAGE_NVIC)
+        {
+            // the set and clear registers both read back the current state
+            if(registerOffset==NVICREG_OFFSET_ICER) registerOffset = NVICREG_OFFSET_ISER;
+            if(registerOffset==NVICREG_OFFSET_ICPR) registerOffset = NVICREG_OFFSET_ISPR;
+            return GetWord(pageIndex, registerOffset);
+        }
+        if(pageIndex==HOSTREG_PAGE_OF(REGISTER_PPI))
+        {
+            // the set and clear registers both read back CHEN
+            if((registerOffset==PPIREG_OFFSET_CHENSET) || (registerOffset==PPIREG_OFFSET_CHENCLR)) registerOffset = PPIREG_OFFSET_CHEN;
+        }
+        if((GetTimerIndex(pageIndex)>=0) || (pageIndex==HOSTREG_PAGE_OF(REGISTER_RNG)) || (pageIndex==HOSTREG_PAGE_OF(REGISTER_ECB)) || (pageIndex==HOSTREG_PAGE_OF(REGISTER_CCM)) || (pageIndex==HOSTREG_PAGE_OF(REGISTER_RADIO)))
+        {
+            // INTENSET and INTENCLR both read back INTEN, which we keep at 0x300
+            if((registerOffset==TIMERREG_OFFSET_INTENSET) || (registerOffset==TIMERREG_OFFSET_INTENCLR)) registerOffset = RNGREG_OFFSET_ITEN;
+        }
+        if(pageIndex==HOSTREG_PAGE_OF(REGISTER_RNG))
+        {
+            // a busy wait on VALRDY never spins. See the header
+            if((registerOffset==RNGREG_OFFSET_VALRDY) && (rngIsRunning!=0) && (GetWord(pageIndex, registerOffset)==0)) MakeRngValue();
+        }
+        return GetWord(pageIndex, registerOffset);
+    }
+
+    /* Write - writes a register, this is what YAKIO_REGISTER() calls
+     *
+     * inputs:
+     *    registerAddress - the address of the register on the microbit
+     *    registerValue - the value to write. Writes to unmapped addresses
+     *       are counted and ignored
+     * */
+    void YakIO_HOSTREGISTERS::Write(unsigned int registerAddress, unsigned int registerValue)
+    {
+        writeCount = writeCount + 1;
+        int pageIndex = GetPageIndex(registerAddress);
+        if(pageIndex==HOSTREG_PAGE_NONE)
+        {
+            unmappedCount = unmappedCount + 1;
+            return;
+        }
+        pageWriteCount[pageIndex] = pageWriteCount[pageIndex] + 1;
+        DispatchWrite(pageIndex, registerAddress, registerValue);
+
+        // a write can easily raise or lower an interrupt line
+        UpdateIRQLines();
+    }
+
+    /* Peek - reads a register without counting it and without any of the 
+     *    models getting involved. For use by the tests
+     *
+     * inputs:
+     *    registerAddress - the address of the register on the microbit
+     * returns:
+     *    the value stored there, zero if unmapped
+     * */
+    unsigned int YakIO_HOSTREGISTERS::Peek(unsigned int registerAddress)
+    {
+        int pageIndex = GetPageIndex(registerAddress);
+        if(pageIndex==HOSTREG_PAGE_NONE) return 0;
+        return GetWord(pageIndex, registerAddress);
+    }
+
+    /* Poke - writes a register without counting it and without any of the 
+     *    models getting involved. For use by the tests
+     *
+     * inputs:
+     *    registerAddress - the address of the register on the microbit
+     *    registerValue - the value to store there
+     * */
+    void YakIO_HOSTREGISTERS::Poke(unsigned int registerAddress, unsigned int registerValue)
+    {
+        int pageIndex = GetPageIndex(registerAddress);
+        if(pageIndex==HOSTREG_PAGE_NONE) return;
+        GetWord(pageIndex, registerAddress) = registerValue;
+    }
+
+    /* Advance - lets simulated time pass. The timers count, the RNG makes 
+     *    values, the RADIO gets on with its packet and any interrupts which 
+     *    are pending and enabled are taken. Time is moved on in steps which 
+     *    stop at every timer match, RNG value and RADIO event so a handler 
+     *    runs for each one, however big cpuCycles is
+     *
+     * inputs:
+     *    cpuCycles - the number of 16MHz cycles to pass
+     * */
+    void YakIO_HOSTREGISTERS::Advance(unsigned int cpuCycles)
+    {
+        while(cpuCycles>0)
+        {
+            // find the cycles to the next thing that will happen
+            unsigned long long stepCycles = cpuCycles;
+            for(int i=0; i<HOSTREG_TIMER_COUNT; i++)
+            {
+                if(IsTimerTicking(i)==0) continue;
+                unsigned long long matchCycles = (GetTicksToMatch(i)<<GetTimerPrescaler(i)) - timerCycleRemainder[i];
+                if(matchCycles<stepCycles) stepCycles = matchCycles;
+            }
+            if((rngIsRunning!=0) && ((HOSTREG_RNG_CYCLES_PER_VALUE-rngCycleRemainder)<stepCycles))
+            {
+                stepCycles = HOSTREG_RNG_CYCLES_PER_VALUE-rngCycleRemainder;
+            }
+            if((radioCyclesToEvent!=0) && (radioCyclesToEvent<stepCycles)) stepCycles = radioCyclesToEvent;
+
+            // a timer match at the end of this step can start a RADIO task
+            // through the PPI. That countdown starts now, not at the beginning
+            // of the step, so we must only count down the one we had before
+            unsigned int radioCountdown = radioCyclesToEvent;
+
+            // move everything on by that much
+            for(int i=0; i<HOSTREG_TIMER_COUNT; i++)
+            {
+                if(IsTimerTicking(i)!=0) AdvanceTimer(i, (unsigned int)stepCycles);
+            }
+            if(rngIsRunning!=0)
+            {
+                rngCycleRemainder = rngCycleRemainder + (unsigned int)stepCycles;
+                if(rngCycleRemainder>=HOSTREG_RNG_CYCLES_PER_VALUE)
+                {
+                    rngCycleRemainder = 0;
+                    MakeRngValue();
+                }
+            }
+            cpuCycles = cpuCycles - (unsigned int)stepCycles;
+            cycleCount = cycleCount + stepCycles;
+            if((radioCyclesToEvent!=0) && (radioCyclesToEvent==radioCountdown))
+            {
+                radioCyclesToEvent = radioCyclesToEvent - (unsigned int)stepCycles;
+                if(radioCyclesToEvent==0) FinishRadioStep();
+            }
+
+            // and take any interrupts that raised
+            UpdateIRQLines();
+            DispatchPendingIRQs();
+        }
+    }
+
+    /* GetCycleCount - gets the simulated time
+     *
+     * returns:
+     *    the number of 16MHz cycles Advance() has passed since Reset()
+     * */
+    unsigned long long YakIO_HOSTREGISTERS::GetCycleCount(void)
+    {
+        return cycleCount;
+    }
+
+    /* SetInputPins - sets the level the outside world is driving onto the 
+     *    GPIO pins. Only pins set as inputs with a connected input buffer 
+     *    will see it in the IN register
+     *
+     * inputs:
+     *    inputPinsIn - one bit per GPIO, 1 for high
+     * */
+    void YakIO_HOSTREGISTERS::SetInputPins(unsigned int inputPinsIn)
+    {
+        inputPins = inputPinsIn;
+    }
+
+    /* SetRngSeed - seeds the generator the simulated RNG uses
+     *
+     * inputs:
+     *    rngSeed - the seed. Zero is not allowed and is ignored
+     * */
+    void YakIO_HOSTREGISTERS::SetRngSeed(unsigned int rngSeed)
+    {
+        if(rngSeed==0) return;
+        rngState = rngSeed;
+    }
+
+    /* SetRngStuckValue - makes the simulated RNG give a fixed value instead 
+     *    of some or all of its values, like a broken noise source. The first
+     *    value made after this call is the stuck one
+     *
+     * inputs:
+     *    stuckValue - the 8 bit value it gets stuck on
+     *    stuckPeriod - 1 for every value, 2 for every other value and so on.
+     *       0 makes it work properly again
+     * */
+    void YakIO_HOSTREGISTERS::SetRngStuckValue(unsigned int stuckValue, unsigned int stuckPeriod)
+    {
+        rngStuckValue = stuckValue & 0xFF;
+        rngStuckPeriod = stuckPeriod;
+        rngStuckCount = 0;
+    }
+
+    /* SignalEvent - an event register has just been set. Starts the task 
+     *    of every enabled PPI channel connected to it. The models call this
+     *    themselves, a test can call it for a peripheral that is not 
+     *    modelled. The task writes are not counted, the CPU did not do them
+     *
+     * inputs:
+     *    eventAddress - the full address of the event register
+     * */
+    void YakIO_HOSTREGISTERS::SignalEvent(unsigned int eventAddress)
+    {
+        // stop a loop of channels going round forever
+        if(ppiDepth>=HOSTREG_MAX_PPI_DEPTH) return;
+        ppiDepth = ppiDepth + 1;
+
+        int ppiPageIndex = HOSTREG_PAGE_OF(REGISTER_PPI);
+        unsigned int enabledChannels = GetWord(ppiPageIndex, PPIREG_OFFSET_CHEN);
+        for(unsigned int i=0; i<PPI_NUM_CHANNELS; i++)
+        {
+            if(((enabledChannels>>i) & 0x01)==0) continue;
+            unsigned int channelEvent = 0;
+            unsigned int channelTask = 0;
+            if(i<PPI_PROGRAMMABLE_CHANNELS)
+            {
+                channelEvent = GetWord(ppiPageIndex, PPIREG_OFFSET_CH_EEP_BASE+(i*PPIREG_CH_STRIDE));
+                channelTask = GetWord(ppiPageIndex, PPIREG_OFFSET_CH_TEP_BASE+(i*PPIREG_CH_STRIDE));
+            }
+            else if(i>=PPI_CH_TIMER0_COMPARE0_RADIO_TXEN)
+            {
+                channelEvent = fixedPpiEvents[i-PPI_CH_TIMER0_COMPARE0_RADIO_TXEN];
+                channelTask = fixedPpiTasks[i-PPI_CH_TIMER0_COMPARE0_RADIO_TXEN];
+            }
+            if(channelEvent!=eventAddress) continue;
+            int taskPageIndex = GetPageIndex(channelTask);
+            if(taskPageIndex==HOSTREG_PAGE_NONE) continue;
+            DispatchWrite(taskPageIndex, channelTask, 1);
+        }
+        ppiDepth = ppiDepth - 1;
+    }
+
+    /* MapRamPointer - turns a host pointer into a 32 bit address that can 
+     *    be written into an EasyDMA register. This is what YAKIO_RAM_ADDRESS()
+     *    calls. See the note in the header
+     *
+     * inputs:
+     *    ramPtr - the pointer
+     * returns:
+     *    the stand in address. The same pointer always gets the same one 
+     *    unless more than HOSTREG_RAM_POINTER_COUNT others have been mapped
+     *    since. NULL maps to 0
+     * */
+    unsigned int YakIO_HOSTREGISTERS::MapRamPointer(void *ramPtr)
+    {
+        if(ramPtr==NULL) return 0;
+        int ramIndex = -1;
+        for(int i=0; i<HOSTREG_RAM_POINTER_COUNT; i++)
+        {
+            if(ramPointers[i]==ramPtr) ramIndex = i;
+        }
+        if(ramIndex<0)
+        {
+            // not seen it before, the oldest one makes way
+            ramIndex = (int)ramPointerNext;
+            ramPointers[ramIndex] = ramPtr;
+            ramPointerNext = (ramPointerNext + 1) % HOSTREG_RAM_POINTER_COUNT;
+        }
+        return HOSTREG_RAM_ADDRESS_BASE | ((unsigned int)ramIndex<<HOSTREG_RAM_INDEX_SHIFT);
+    }
+
+    /* GetRamPointer - turns an address made by MapRamPointer() back into 
+     *    the host pointer. Any offset added to the address is added to the
+     *    pointer
+     *
+     * inputs:
+     *    ramAddress - the address
+     * returns:
+     *    the pointer or NULL if the address was never handed out
+     * */
+    void *YakIO_HOSTREGISTERS::GetRamPointer(unsigned int ramAddress)
+    {
+        if((ramAddress & HOSTREG_RAM_BASE_MASK)!=HOSTREG_RAM_ADDRESS_BASE) return NULL;
+        unsigned int ramIndex = (ramAddress>>HOSTREG_RAM_INDEX_SHIFT) & (HOSTREG_RAM_POINTER_COUNT-1);
+        if(ramPointers[ramIndex]==NULL) return NULL;
+        return (unsigned char *)ramPointers[ramIndex] + (ramAddress & HOSTREG_RAM_OFFSET_MASK);
+    }
+
+    /* InjectRadioPacket - the other end of the air. A packet starts to 
+     *    arrive at the RADIO now. It is only heard if the RADIO is listening
+     *    (STATE is RX, after a START) on logical address 0 with the same 
+     *    frequency and address and is not already hearing another one. The
+     *    ADDRESS and END events follow as Advance() is called, as far apart
+     *    as the bytes would take on the air
+     *
+     * inputs:
+     *    radioFrequency - the FREQUENCY it is sent on
+     *    baseAddress - the BASE0 it is sent to
+     *    prefixByte - the PREFIX0 byte it is sent to
+     *    packetBytes - the LENGTH byte followed by the payload
+     *    crcIsGood - nz for a good packet, z for one damaged on the way. If
+     *       the CRC is off every packet is good
+     * returns:
+     *    nz if the RADIO will hear it, z if not
+     * */
+    unsigned int YakIO_HOSTREGISTERS::InjectRadioPacket(unsigned int radioFrequency, unsigned int baseAddress, unsigned int prefixByte, const unsigned char *packetBytes, unsigned int crcIsGood)
+    {
+        return InjectRadioPacket(radioFrequency, baseAddress, prefixByte, packetBytes, crcIsGood, 0);
+    }
+
+    /* InjectRadioPacket - as above but the packet started a little while 
+     *    ago. YakIO_HOSTMEDIUM only finds out another node is sending after
+     *    it has moved that node on, so the start is always a little behind
+     *
+     * inputs:
+     *    radioFrequency, baseAddress, prefixByte, packetBytes, crcIsGood - 
+     *       as above
+     *    cyclesOnAir - how long ago it started. The ADDRESS comes this much
+     *       sooner than it otherwise would
+     * returns:
+     *    nz if the RADIO will hear it, z if not or if the address has
+     *    already gone by
+     * */
+    unsigned int YakIO_HOSTREGISTERS::InjectRadioPacket(unsigned int radioFrequency, unsigned int baseAddress, unsigned int prefixByte, const unsigned char *packetBytes, unsigned int crcIsGood, unsigned int cyclesOnAir)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_RADIO);
+        if(packetBytes==NULL) return 0;
+        if(GetWord(pageIndex, RADIOREG_OFFSET_STATE)!=RADIO_HWSTATE_RX) return 0;
+        if(radioCyclesToEvent!=0) return 0;
+        if(GetWord(pageIndex, RADIOREG_OFFSET_FREQUENCY)!=radioFrequency) return 0;
+        if((GetWord(pageIndex, RADIOREG_OFFSET_RXADDRESSES) & 0x01)==0) return 0;
+        if(GetWord(pageIndex, RADIOREG_OFFSET_BASE0)!=baseAddress) return 0;
+        if((GetWord(pageIndex, RADIOREG_OFFSET_PREFIX0) & 0xFF)!=(prefixByte & 0xFF)) return 0;
+        if(cyclesOnAir>=GetRadioAddressCycles()) return 0;
+
+        for(unsigned int i=0; i<=packetBytes[0]; i++) radioAirBytes[i] = packetBytes[i];
+        radioAirCrcIsGood = (crcIsGood!=0) || ((GetWord(pageIndex, RADIOREG_OFFSET_CRCCNF) & 0x03)==0);
+        radioNextEvent = RADIOREG_OFFSET_ADDRESS;
+        radioCyclesToEvent = GetRadioAddressCycles() - cyclesOnAir;
+        radioStartCycle = cycleCount - cyclesOnAir;
+        return 1;
+    }
+
+    /* GetRadioTxCount - gets the number of packets the RADIO has sent 
+     *    since Reset()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetRadioTxCount(void)
+    {
+        return radioTxCount;
+    }
+
+    /* GetRadioTxFrequency - gets the FREQUENCY the last packet was sent on
+     *
+     * returns:
+     *    the frequency, zero if nothing has been sent
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetRadioTxFrequency(void)
+    {
+        return radioTxFrequency;
+    }
+
+    /* GetRadioAddressCycle - gets when the RADIO last set ADDRESS, sending
+     *    or receiving. See the note in the header
+     *
+     * returns:
+     *    the GetCycleCount() it happened at
+     * */
+    unsigned long long YakIO_HOSTREGISTERS::GetRadioAddressCycle(void)
+    {
+        return radioAddressCycle;
+    }
+
+    /* GetRadioAirPacket - gets the packet the RADIO is sending, or hearing,
+     *    right now. STATE says which
+     *
+     * inputs:
+     *    packetBytes - where to put the LENGTH byte and the payload. Must 
+     *       have room for HOSTREG_RADIO_PACKET_BYTES
+     * returns:
+     *    the number of bytes copied, zero if nothing is on the air
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetRadioAirPacket(unsigned char *packetBytes)
+    {
+        if(packetBytes==NULL) return 0;
+        unsigned int hwState = GetWord(HOSTREG_PAGE_OF(REGISTER_RADIO), RADIOREG_OFFSET_STATE);
+        if((hwState!=RADIO_HWSTATE_TX) && (hwState!=RADIO_HWSTATE_RX)) return 0;
+        if(radioCyclesToEvent==0) return 0;
+        for(unsigned int i=0; i<=radioAirBytes[0]; i++) packetBytes[i] = radioAirBytes[i];
+        return radioAirBytes[0] + 1;
+    }
+
+    /* GetRadioStartCycle - gets when the packet GetRadioAirPacket() gets 
+     *    started, the START of one being sent or the first bit of one 
+     *    being heard
+     *
+     * returns:
+     *    the GetCycleCount() it happened at
+     * */
+    unsigned long long YakIO_HOSTREGISTERS::GetRadioStartCycle(void)
+    {
+        return radioStartCycle;
+    }
+
+    /* GetRadioTxPacket - gets the last packet the RADIO sent, as it went
+     *    out on the air
+     *
+     * inputs:
+     *    packetBytes - where to put the LENGTH byte and the payload. Must 
+     *       have room for HOSTREG_RADIO_PACKET_BYTES
+     * returns:
+     *    the number of bytes copied, zero if nothing has been sent
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetRadioTxPacket(unsigned char *packetBytes)
+    {
+        if((radioTxCount==0) || (packetBytes==NULL)) return 0;
+        for(unsigned int i=0; i<=radioTxBytes[0]; i++) packetBytes[i] = radioTxBytes[i];
+        return radioTxBytes[0] + 1;
+    }
+
+    /* ResetCounters - zeros the read, write, unmapped and IRQ counts
+     * */
+    void YakIO_HOSTREGISTERS::ResetCounters(void)
+    {
+        for(int i=0; i<HOSTREG_PAGE_COUNT; i++)
+        {
+            pageReadCount[i] = 0;
+            pageWriteCount[i] = 0;
+        }
+        readCount = 0;
+        writeCount = 0;
+        unmappedCount = 0;
+        irqCount = 0;
+    }
+
+    /* GetReadCount - gets the number of register reads since ResetCounters()
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetReadCount(void)
+    {
+        return readCount;
+    }
+
+    /* GetWriteCount - gets the number of register writes since ResetCounters()
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetWriteCount(void)
+    {
+        return writeCount;
+    }
+
+    /* GetReadCount - gets the number of reads of one peripheral since 
+     *    ResetCounters()
+     *
+     * inputs:
+     *    peripheralAddress - the base address, REGISTER_GPIO for example. 
+     *       Any address inside the peripheral will do
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetReadCount(unsigned int peripheralAddress)
+    {
+        int pageIndex = GetPageIndex(peripheralAddress);
+        if(pageIndex==HOSTREG_PAGE_NONE) return 0;
+        return pageReadCount[pageIndex];
+    }
+
+    /* GetWriteCount - gets the number of writes to one peripheral since 
+     *    ResetCounters()
+     *
+     * inputs:
+     *    peripheralAddress - the base address, REGISTER_GPIO for example. 
+     *       Any address inside the peripheral will do
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetWriteCount(unsigned int peripheralAddress)
+    {
+        int pageIndex = GetPageIndex(peripheralAddress);
+        if(pageIndex==HOSTREG_PAGE_NONE) return 0;
+        return pageWriteCount[pageIndex];
+    }
+
+    /* GetUnmappedCount - gets the number of reads and writes of addresses
+     *    which are not in any page we model. Usually this means a bug
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetUnmappedCount(void)
+    {
+        return unmappedCount;
+    }
+
+    /* GetIRQCount - gets the number of interrupt handlers called by 
+     *    Advance() since ResetCounters()
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetIRQCount(void)
+    {
+        return irqCount;
+    }
+
+// #
+// # Private
+// #
+
+    /* GetPageIndex - finds the page which holds a register
+     *
+     * inputs:
+     *    registerAddress - the address of the register on the microbit
+     * returns:
+     *    the page index or HOSTREG_PAGE_NONE
+     * */
+    int YakIO_HOSTREGISTERS::GetPageIndex(unsigned int registerAddress)
+    {
+        if((registerAddress>=REGISTER_CLOCK) && (registerAddress<(REGISTER_CLOCK+(HOSTREG_PERIPHERAL_PAGE_COUNT*HOSTREG_PAGE_SIZE))))
+        {
+            return HOSTREG_PAGE_OF(registerAddress);
+        }
+        unsigned int pageAddress = registerAddress & ~(HOSTREG_PAGE_SIZE-1);
+        if(pageAddress==REGISTER_GPIO) return HOSTREG_PAGE_GPIO;
+        if(pageAddress==REGISTER_NVIC) return HOSTREG_PAGE_NVIC;
+        if(pageAddress==REGISTER_FICR) return HOSTREG_PAGE_FICR;
+        if(pageAddress==REGISTER_UICR) return HOSTREG_PAGE_UICR;
+        return HOSTREG_PAGE_NONE;
+    }
+
+    /* GetWord - gets the memory behind a register
+     *
+     * inputs:
+     *    pageIndex - the page, must be valid
+     *    registerAddress - the address or just the offset into the page
+     * returns:
+     *    a reference to the word
+     * */
+    unsigned int &YakIO_HOSTREGISTERS::GetWord(int pageIndex, unsigned int registerAddress)
+    {
+        return pageWords[pageIndex][(registerAddress & (HOSTREG_PAGE_SIZE-1))/BYTES_IN_REGISTER];
+    }
+
+    /* GetTimerIndex - works out if a page is one of the timers
+     *
+     * inputs:
+     *    pageIndex - the page
+     * returns:
+     *    0, 1 or 2 for TIMER0, TIMER1 or TIMER2. -1 if it is not a timer
+     * */
+    int YakIO_HOSTREGISTERS::GetTimerIndex(int pageIndex)
+    {
+        int timerIndex = pageIndex - HOSTREG_PAGE_OF(REGISTER_TIMER0);
+        if((timerIndex<0) || (timerIndex>=HOSTREG_TIMER_COUNT)) return -1;
+        return timerIndex;
+    }
+
+    /* GetTimerMask - gets the counter mask for the timer BITMODE
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetTimerMask(int timerIndex)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + timerIndex;
+        unsigned int bitMode = GetWord(pageIndex, TIMERREG_OFFSET_BITMODE) & 0x03;
+        if(bitMode==TIMER_BITMODE_08Bit) return 0x000000FF;
+        if(bitMode==TIMER_BITMODE_24Bit) return 0x00FFFFFF;
+        if(bitMode==TIMER_BITMODE_32Bit) return 0xFFFFFFFF;
+        return 0x0000FFFF;
+    }
+
+    /* IsTimerTicking - works out if a timer is counting the clock
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     * returns:
+     *    nz if it is started and in timer mode, z if not. Counter mode
+     *    timers only count on the COUNT task
+     * */
+    unsigned int YakIO_HOSTREGISTERS::IsTimerTicking(int timerIndex)
+    {
+        if(timerIsRunning[timerIndex]==0) return 0;
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + timerIndex;
+        if(GetWord(pageIndex, TIMERREG_OFFSET_MODE)==TIMER_MODE_Counter) return 0;
+        return 1;
+    }
+
+    /* GetTimerPrescaler - gets the timer PRESCALER. The timer clock is 
+     *    16MHz divided by 2^prescaler
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     * returns:
+     *    the prescaler, 0 to 9
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetTimerPrescaler(int timerIndex)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + timerIndex;
+        unsigned int prescaler = GetWord(pageIndex, TIMERREG_OFFSET_PRESCALER) & 0x0F;
+        if(prescaler>9) prescaler = 9;
+        return prescaler;
+    }
+
+    /* GetTicksToMatch - finds the timer ticks until the counter next 
+     *    matches one of the CC[n] registers
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     * returns:
+     *    the ticks. Never zero, a CC[n] equal to the counter right now
+     *    is a whole wrap of the counter away
+     * */
+    unsigned long long YakIO_HOSTREGISTERS::GetTicksToMatch(int timerIndex)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + timerIndex;
+        unsigned int timerMask = GetTimerMask(timerIndex);
+        unsigned long long tickCount = (unsigned long long)timerMask + 1;
+        for(int n=0; n<HOSTREG_TIMER_CC_COUNT; n++)
+        {
+            unsigned int ccValue = GetWord(pageIndex, TIMERREG_OFFSET_CC_0+(n*BYTES_IN_REGISTER)) & timerMask;
+            unsigned long long distance = (ccValue - timerCounter[timerIndex]) & timerMask;
+            if(distance==0) distance = (unsigned long long)timerMask + 1;
+            if(distance<tickCount) tickCount = distance;
+        }
+        return tickCount;
+    }
+
+    /* AdvanceTimer - moves a timer counter on. Rather than step one tick 
+     *    at a time we jump straight to the next CC[n] match
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     *    cpuCycles - the number of 16MHz cycles to pass
+     * */
+    void YakIO_HOSTREGISTERS::AdvanceTimer(int timerIndex, unsigned int cpuCycles)
+    {
+        // keep the cycles left over from the prescaler for next time
+        unsigned int prescaler = GetTimerPrescaler(timerIndex);
+        unsigned long long cycleTotal = (unsigned long long)timerCycleRemainder[timerIndex] + cpuCycles;
+        timerCycleRemainder[timerIndex] = (unsigned int)(cycleTotal & ((1u<<prescaler)-1));
+        unsigned long long tickCount = cycleTotal>>prescaler;
+
+        unsigned int timerMask = GetTimerMask(timerIndex);
+        while((tickCount>0) && (timerIsRunning[timerIndex]!=0))
+        {
+            unsigned long long matchTicks = GetTicksToMatch(timerIndex);
+            if(matchTicks>tickCount)
+            {
+                // we do not get as far as the next match
+                timerCounter[timerIndex] = (unsigned int)((timerCounter[timerIndex] + tickCount) & timerMask);
+                return;
+            }
+            timerCounter[timerIndex] = (unsigned int)((timerCounter[timerIndex] + matchTicks) & timerMask);
+            tickCount = tickCount - matchTicks;
+            CompareTimer(timerIndex);
+        }
+    }
+
+    /* CountTimer - the COUNT task for a timer in counter mode
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     * */
+    void YakIO_HOSTREGISTERS::CountTimer(int timerIndex)
+    {
+        timerCounter[timerIndex] = (timerCounter[timerIndex] + 1) & GetTimerMask(timerIndex);
+        CompareTimer(timerIndex);
+    }
+
+    /* CompareTimer - sets the COMPARE[n] event for every CC[n] which 
+     *    matches the counter and runs the shortcuts
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     * */
+    void YakIO_HOSTREGISTERS::CompareTimer(int timerIndex)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + timerIndex;
+        unsigned int timerMask = GetTimerMask(timerIndex);
+        unsigned int shortCuts = GetWord(pageIndex, TIMERREG_OFFSET_SHORTS);
+        unsigned int matchedValue = timerCounter[timerIndex];
+        for(int n=0; n<HOSTREG_TIMER_CC_COUNT; n++)
+        {
+            if((GetWord(pageIndex, TIMERREG_OFFSET_CC_0+(n*BYTES_IN_REGISTER)) & timerMask)!=matchedValue) continue;
+            GetWord(pageIndex, TIMERREG_OFFSET_COMPARE_0+(n*BYTES_IN_REGISTER)) = 1;
+            if((shortCuts & (TIMER_SHORT_COMPARE0_CLEAR<<n))!=0) timerCounter[timerIndex] = 0;
+            if((shortCuts & (TIMER_SHORT_COMPARE0_STOP<<n))!=0) timerIsRunning[timerIndex] = 0;
+            SignalEvent(REGISTER_TIMER0+(timerIndex*HOSTREG_PAGE_SIZE)+TIMERREG_OFFSET_COMPARE_0+(n*BYTES_IN_REGISTER));
+        }
+    }
+
+    /* MakeRngValue - puts a new value in the RNG VALUE register, sets
+     *    VALRDY and runs the VALRDY_STOP shortcut. This is xorshift32, 
+     *    see the note in the header. A stuck value still steps the 
+     *    generator so the others are the same as they would have been
+     * */
+    void YakIO_HOSTREGISTERS::MakeRngValue(void)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_RNG);
+        rngState = rngState ^ (rngState<<13);
+        rngState = rngState ^ (rngState>>17);
+        rngState = rngState ^ (rngState<<5);
+        unsigned int rngValue = rngState & 0xFF;
+        if(rngStuckPeriod!=0)
+        {
+            if((rngStuckCount % rngStuckPeriod)==0) rngValue = rngStuckValue;
+            rngStuckCount++;
+        }
+        GetWord(pageIndex, RNGREG_OFFSET_VALUE) = rngValue;
+        GetWord(pageIndex, RNGREG_OFFSET_VALRDY) = 1;
+        if((GetWord(pageIndex, RNGREG_OFFSET_SHORTS) & RNG_SHORT_VALRDY_STOP_BIT)!=0) rngIsRunning = 0;
+    }
+
+    /* UpdateIRQLines - sets the NVIC pending bit for every peripheral which 
+     *    has an event set with its interrupt enabled. Like the real thing, 
+     *    the line stays high until the event is cleared. Also like the real
+     *    thing, a line that is high while its own handler is running does 
+     *    not make it pending again - that only happens if the line is still
+     *    high when the handler returns
+     * */
+    void YakIO_HOSTREGISTERS::UpdateIRQLines(void)
+    {
+        unsigned int &pendingBits = GetWord(HOSTREG_PAGE_NVIC, NVICREG_OFFSET_ISPR);
+        unsigned int pendingBitsWere = pendingBits;
+        for(int i=0; i<HOSTREG_TIMER_COUNT; i++)
+        {
+            int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + i;
+            unsigned int intenBits = GetWord(pageIndex, RNGREG_OFFSET_ITEN);
+            for(int n=0; n<HOSTREG_TIMER_CC_COUNT; n++)
+            {
+                if(GetWord(pageIndex, TIMERREG_OFFSET_COMPARE_0+(n*BYTES_IN_REGISTER))==0) continue;
+                if((intenBits & (TIMER_INTEN_COMPARE0_BIT<<n))==0) continue;
+                pendingBits = pendingBits | (0x01<<(IRQ_TIMER0+i));
+            }
+        }
+        int rngPageIndex = HOSTREG_PAGE_OF(REGISTER_RNG);
+        if((GetWord(rngPageIndex, RNGREG_OFFSET_VALRDY)!=0) && ((GetWord(rngPageIndex, RNGREG_OFFSET_ITEN) & RNG_INTEN_BIT)!=0))
+        {
+            pendingBits = pendingBits | (0x01<<IRQ_RNG);
+        }
+        int ecbPageIndex = HOSTREG_PAGE_OF(REGISTER_ECB);
+        unsigned int ecbIntenBits = GetWord(ecbPageIndex, RNGREG_OFFSET_ITEN);
+        if(((GetWord(ecbPageIndex, ECBREG_OFFSET_ENDECB)!=0) && ((ecbIntenBits & ECB_INTEN_ENDECB_BIT)!=0)) ||
+           ((GetWord(ecbPageIndex, ECBREG_OFFSET_ERRORECB)!=0) && ((ecbIntenBits & ECB_INTEN_ERRORECB_BIT)!=0)))
+        {
+            pendingBits = pendingBits | (0x01<<IRQ_ECB);
+        }
+        int ccmPageIndex = HOSTREG_PAGE_OF(REGISTER_CCM);
+        unsigned int ccmIntenBits = GetWord(ccmPageIndex, RNGREG_OFFSET_ITEN);
+        if(((GetWord(ccmPageIndex, CCMREG_OFFSET_ENDKSGEN)!=0) && ((ccmIntenBits & CCM_INTEN_ENDKSGEN_BIT)!=0)) ||
+           ((GetWord(ccmPageIndex, CCMREG_OFFSET_ENDCRYPT)!=0) && ((ccmIntenBits & CCM_INTEN_ENDCRYPT_BIT)!=0)) ||
+           ((GetWord(ccmPageIndex, CCMREG_OFFSET_ERROR)!=0) && ((ccmIntenBits & CCM_INTEN_ERROR_BIT)!=0)))
+        {
+            pendingBits = pendingBits | (0x01<<IRQ_CCM);
+        }
+        // RADIO INTEN bit n is the event at RADIOREG_OFFSET_READY+(n*4)
+        int radioPageIndex = HOSTREG_PAGE_OF(REGISTER_RADIO);
+        unsigned int radioIntenBits = GetWord(radioPageIndex, RNGREG_OFFSET_ITEN);
+        for(int n=0; n<=(RADIOREG_OFFSET_BCMATCH-RADIOREG_OFFSET_READY)/BYTES_IN_REGISTER; n++)
+        {
+            if((radioIntenBits & (0x01u<<n))==0) continue;
+            if(GetWord(radioPageIndex, RADIOREG_OFFSET_READY+(n*BYTES_IN_REGISTER))==0) continue;
+            pendingBits = pendingBits | (0x01<<IRQ_RADIO);
+        }
+        // a handler that is running is not made pending by its own line
+        pendingBits = pendingBitsWere | (pendingBits & ~activeIRQBits);
+    }
+
+    /* DispatchPendingIRQs - calls the handler of every interrupt which is
+     *    pending and enabled, lowest IRQ number first. The pending bit is 
+     *    cleared as the handler is entered, just like the real NVIC
+     * */
+    void YakIO_HOSTREGISTERS::DispatchPendingIRQs(void)
+    {
+        for(int dispatchCount=0; dispatchCount<HOSTREG_MAX_IRQ_DISPATCH; dispatchCount++)
+        {
+            unsigned int &pendingBits = GetWord(HOSTREG_PAGE_NVIC, NVICREG_OFFSET_ISPR);
+            unsigned int activeBits = pendingBits & GetWord(HOSTREG_PAGE_NVIC, NVICREG_OFFSET_ISER);
+            if(activeBits==0) return;
+            int irqNum = 0;
+            while((activeBits & (0x01u<<irqNum))==0) irqNum++;
+            pendingBits = pendingBits & ~(0x01u<<irqNum);
+            irqCount = irqCount + 1;
+            activeIRQBits = activeIRQBits | (0x01u<<irqNum);
+            CallIRQHandler(irqNum);
+            activeIRQBits = activeIRQBits & ~(0x01u<<irqNum);
+            UpdateIRQLines();
+        }
+    }
+
+    /* CallIRQHandler - calls the interrupt handler for an IRQ number, if 
+     *    it exists
+     *
+     * inputs:
+     *    irqNum - the IRQ number. See YakIO_NVIC.h
+     * */
+    void YakIO_HOSTREGISTERS::CallIRQHandler(int irqNum)
+    {
+        void (*handlerPtr)(void) = NULL;
+        if(irqNum==IRQ_RADIO) handlerPtr = IRQ_RADIO_handler;
+        else if(irqNum==IRQ_TIMER0) handlerPtr = IRQ_TIMER0_handler;
+        else if(irqNum==IRQ_TIMER1) handlerPtr = IRQ_TIMER1_handler;
+        else if(irqNum==IRQ_TIMER2) handlerPtr = IRQ_TIMER2_handler;
+        else if(irqNum==IRQ_RNG) handlerPtr = IRQ_RNG_handler;
+        else if(irqNum==IRQ_ECB) handlerPtr = IRQ_ECB_handler;
+        else if(irqNum==IRQ_CCM) handlerPtr = IRQ_AAR_CCM_handler;
+        if(handlerPtr==NULL) return;
+        handlerPtr();
+    }
+
+    /* DispatchWrite - sends a write to the model for its page. Write() 
+     *    counts it first, the PPI tasks in SignalEvent() come straight here
+     *
+     * inputs:
+     *    pageIndex - the page, must be valid
+     *    registerAddress - the address of the register on the microbit
+     *    registerValue - the value to write
+     * */
+    void YakIO_HOSTREGISTERS::DispatchWrite(int pageIndex, unsigned int registerAddress, unsigned int registerValue)
+    {
+        unsigned int registerOffset = registerAddress & (HOSTREG_PAGE_SIZE-1);
+
+        int timerIndex = GetTimerIndex(pageIndex);
+        if(pageIndex==HOSTREG_PAGE_GPIO) WriteGPIO(registerOffset, registerValue);
+        else if(pageIndex==HOSTREG_PAGE_NVIC) WriteNVIC(registerOffset, registerValue);
+        else if(timerIndex>=0) WriteTimer(timerIndex, registerOffset, registerValue);
+        else if(pageIndex==HOSTREG_PAGE_OF(REGISTER_RNG)) WriteRNG(registerOffset, registerValue);
+        else if(pageIndex==HOSTREG_PAGE_OF(REGISTER_ECB)) WriteECB(registerOffset, registerValue);
+        else if(pageIndex==HOSTREG_PAGE_OF(REGISTER_PPI)) WritePPI(registerOffset, registerValue);
+        else if(pageIndex==HOSTREG_PAGE_OF(REGISTER_CCM)) WriteCCM(registerOffset, registerValue);
+        else if(pageIndex==HOSTREG_PAGE_OF(REGISTER_RADIO)) WriteRadio(registerOffset, registerValue);
+        else if((pageIndex==HOSTREG_PAGE_OF(REGISTER_UART0)) && (registerOffset==UARTREG_OFFSET_TXD))
+        {
+            // the byte goes instantly on the host
+            GetWord(pageIndex, registerOffset) = registerValue;
+            GetWord(pageIndex, UARTREG_OFFSET_TXDRDY) = 1;
+        }
+        else if((pageIndex==HOSTREG_PAGE_OF(REGISTER_CLOCK)) && (registerOffset==CLOCKREG_OFFSET_HFCLKSTART))
+        {
+            // the crystal starts instantly on the host
+            GetWord(pageIndex, CLOCKREG_OFFSET_HFCLKSTARTED) = 1;
+        }
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* ReadGPIO - a read of a GPIO register
+     *
+     * inputs:
+     *    registerOffset - the offset into the GPIO page
+     * */
+    unsigned int YakIO_HOSTREGISTERS::ReadGPIO(unsigned int registerOffset)
+    {
+        unsigned int outBits = GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_OUT);
+        unsigned int dirBits = GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_DIR);
+        if((registerOffset==GPIOREG_OFFSET_OUTSET) || (registerOffset==GPIOREG_OFFSET_OUTCLR)) return outBits;
+        if((registerOffset==GPIOREG_OFFSET_DIRSET) || (registerOffset==GPIOREG_OFFSET_DIRCLR)) return dirBits;
+        if(registerOffset==GPIOREG_OFFSET_IN)
+        {
+            unsigned int inBits = 0;
+            for(int i=0; i<32; i++)
+            {
+                // bit 1 of PIN_CNF[n] set means the input buffer is disconnected
+                if((GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_PIN_CNF_BASE+(i*BYTES_IN_REGISTER)) & 0x02)!=0) continue;
+                unsigned int pinBit = 0x01u<<i;
+                if((dirBits & pinBit)!=0) inBits = inBits | (outBits & pinBit);
+                else inBits = inBits | (inputPins & pinBit);
+            }
+            return inBits;
+        }
+        return GetWord(HOSTREG_PAGE_GPIO, registerOffset);
+    }
+
+    /* WriteGPIO - a write of a GPIO register
+     *
+     * inputs:
+     *    registerOffset - the offset into the GPIO page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteGPIO(unsigned int registerOffset, unsigned int registerValue)
+    {
+        unsigned int &outBits = GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_OUT);
+        unsigned int &dirBits = GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_DIR);
+        if(registerOffset==GPIOREG_OFFSET_IN) return; // read only
+        else if(registerOffset==GPIOREG_OFFSET_OUTSET) outBits = outBits | registerValue;
+        else if(registerOffset==GPIOREG_OFFSET_OUTCLR) outBits = outBits & ~registerValue;
+        else if(registerOffset==GPIOREG_OFFSET_DIRSET) dirBits = dirBits | registerValue;
+        else if(registerOffset==GPIOREG_OFFSET_DIRCLR) dirBits = dirBits & ~registerValue;
+        else if((registerOffset>=GPIOREG_OFFSET_PIN_CNF0) && (registerOffset<=GPIOREG_OFFSET_PIN_CNF31))
+        {
+            // bit 0 of PIN_CNF[n] is the same bit as bit n in DIR
+            GetWord(HOSTREG_PAGE_GPIO, registerOffset) = registerValue;
+            unsigned int pinBit = 0x01u<<((registerOffset-GPIOREG_OFFSET_PIN_CNF_BASE)/BYTES_IN_REGISTER);
+            if((registerValue & 0x01)!=0) dirBits = dirBits | pinBit;
+            else dirBits = dirBits & ~pinBit;
+            return;
+        }
+        else GetWord(HOSTREG_PAGE_GPIO, registerOffset) = registerValue;
+
+        // and the other way. Put the DIR bits back into the PIN_CNF[n] registers
+        for(int i=0; i<32; i++)
+        {
+            unsigned int &cnfWord = GetWord(HOSTREG_PAGE_GPIO, GPIOREG_OFFSET_PIN_CNF_BASE+(i*BYTES_IN_REGISTER));
+            cnfWord = (cnfWord & GPIO_CNF_REGISTER_DIRECTION_MASK) | ((dirBits>>i) & 0x01);
+        }
+    }
+
+    /* WriteTimer - a write of a TIMER register
+     *
+     * inputs:
+     *    timerIndex - 0, 1 or 2
+     *    registerOffset - the offset into the TIMER page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteTimer(int timerIndex, unsigned int registerOffset, unsigned int registerValue)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_TIMER0) + timerIndex;
+        unsigned int &intenBits = GetWord(pageIndex, RNGREG_OFFSET_ITEN);
+
+        // the tasks only do something when a 1 is written and never store anything
+        if(registerOffset<=TIMERREG_OFFSET_CAPTURE_3)
+        {
+            if(registerValue==0) return;
+            if(registerOffset==TIMERREG_OFFSET_START) timerIsRunning[timerIndex] = 1;
+            else if(registerOffset==TIMERREG_OFFSET_STOP) timerIsRunning[timerIndex] = 0;
+            else if(registerOffset==TIMERREG_OFFSET_CLEAR) timerCounter[timerIndex] = 0;
+            else if(registerOffset==TIMERREG_OFFSET_SHUTDOWN)
+            {
+                timerIsRunning[timerIndex] = 0;
+                timerCounter[timerIndex] = 0;
+            }
+            else if(registerOffset==TIMERREG_OFFSET_COUNT)
+            {
+                if(GetWord(pageIndex, TIMERREG_OFFSET_MODE)==TIMER_MODE_Counter) CountTimer(timerIndex);
+            }
+            else if(registerOffset>=TIMERREG_OFFSET_CAPTURE_0)
+            {
+                unsigned int ccOffset = TIMERREG_OFFSET_CC_0 + (registerOffset-TIMERREG_OFFSET_CAPTURE_0);
+                GetWord(pageIndex, ccOffset) = timerCounter[timerIndex];
+            }
+            return;
+        }
+        if(registerOffset==TIMERREG_OFFSET_INTENSET) intenBits = intenBits | registerValue;
+        else if(registerOffset==TIMERREG_OFFSET_INTENCLR) intenBits = intenBits & ~registerValue;
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* WriteRNG - a write of an RNG register
+     *
+     * inputs:
+     *    registerOffset - the offset into the RNG page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteRNG(unsigned int registerOffset, unsigned int registerValue)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_RNG);
+        unsigned int &intenBits = GetWord(pageIndex, RNGREG_OFFSET_ITEN);
+        if(registerOffset==RNGREG_OFFSET_START)
+        {
+            if(registerValue!=0) rngIsRunning = 1;
+        }
+        else if(registerOffset==RNGREG_OFFSET_STOP)
+        {
+            if(registerValue!=0) rngIsRunning = 0;
+        }
+        else if(registerOffset==RNGREG_OFFSET_VALUE) return; // read only
+        else if(registerOffset==RNGREG_OFFSET_ITENSET) intenBits = intenBits | registerValue;
+        else if(registerOffset==RNGREG_OFFSET_ITENCLR) intenBits = intenBits & ~registerValue;
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* WriteNVIC - a write of an NVIC register
+     *
+     * inputs:
+     *    registerOffset - the offset into the NVIC page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteNVIC(unsigned int registerOffset, unsigned int registerValue)
+    {
+        unsigned int &enabledBits = GetWord(HOSTREG_PAGE_NVIC, NVICREG_OFFSET_ISER);
+        unsigned int &pendingBits = GetWord(HOSTREG_PAGE_NVIC, NVICREG_OFFSET_ISPR);
+        if(registerOffset==NVICREG_OFFSET_ISER) enabledBits = enabledBits | registerValue;
+        else if(registerOffset==NVICREG_OFFSET_ICER) enabledBits = enabledBits & ~registerValue;
+        else if(registerOffset==NVICREG_OFFSET_ISPR) pendingBits = pendingBits | registerValue;
+        else if(registerOffset==NVICREG_OFFSET_ICPR) pendingBits = pendingBits & ~registerValue;
+        else GetWord(HOSTREG_PAGE_NVIC, registerOffset) = registerValue;
+    }
+
+    /* WriteECB - a write of an ECB register. The encryption happens at 
+     *    once, there is no 7 microsecond wait on the host
+     *
+     * inputs:
+     *    registerOffset - the offset into the ECB page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteECB(unsigned int registerOffset, unsigned int registerValue)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_ECB);
+        unsigned int &intenBits = GetWord(pageIndex, RNGREG_OFFSET_ITEN);
+        if(registerOffset==ECBREG_OFFSET_STARTECB)
+        {
+            if(registerValue==0) return;
+            struct YakIO_ECBDATA *dataPtr = (struct YakIO_ECBDATA *)GetRamPointer(GetWord(pageIndex, ECBREG_OFFSET_ECBDATAPTR));
+            if(dataPtr==NULL)
+            {
+                // the real thing would read whatever is there. Call it an error
+                GetWord(pageIndex, ECBREG_OFFSET_ERRORECB) = 1;
+                return;
+            }
+            YakIO_SOFTAES softAes;
+            softAes.SetKey(dataPtr->keyBytes);
+            softAes.EncryptBlock(dataPtr->clearText, dataPtr->cipherText);
+            GetWord(pageIndex, ECBREG_OFFSET_ENDECB) = 1;
+        }
+        else if(registerOffset==ECBREG_OFFSET_STOPECB)
+        {
+            if(registerValue!=0) GetWord(pageIndex, ECBREG_OFFSET_ERRORECB) = 1;
+        }
+        else if(registerOffset==ECBREG_OFFSET_INTENSET) intenBits = intenBits | registerValue;
+        else if(registerOffset==ECBREG_OFFSET_INTENCLR) intenBits = intenBits & ~registerValue;
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* WritePPI - a write of a PPI register
+     *
+     * inputs:
+     *    registerOffset - the offset into the PPI page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WritePPI(unsigned int registerOffset, unsigned int registerValue)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_PPI);
+        unsigned int &enabledChannels = GetWord(pageIndex, PPIREG_OFFSET_CHEN);
+        if(registerOffset==PPIREG_OFFSET_CHENSET) enabledChannels = enabledChannels | registerValue;
+        else if(registerOffset==PPIREG_OFFSET_CHENCLR) enabledChannels = enabledChannels & ~registerValue;
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* WriteCCM - a write of a CCM register. The tasks do nothing unless
+     *    the CCM is enabled
+     *
+     * inputs:
+     *    registerOffset - the offset into the CCM page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteCCM(unsigned int registerOffset, unsigned int registerValue)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_CCM);
+        unsigned int &intenBits = GetWord(pageIndex, RNGREG_OFFSET_ITEN);
+        unsigned int isEnabled = (GetWord(pageIndex, CCMREG_OFFSET_ENABLE)==CCM_ENABLE_ENABLED);
+        if(registerOffset==CCMREG_OFFSET_KSGEN)
+        {
+            if((registerValue==0) || (isEnabled==0)) return;
+            // the key stream is made at once
+            GetWord(pageIndex, CCMREG_OFFSET_ENDKSGEN) = 1;
+            SignalEvent(REGISTER_CCM+CCMREG_OFFSET_ENDKSGEN);
+            if((GetWord(pageIndex, CCMREG_OFFSET_SHORTS) & CCM_SHORT_ENDKSGEN_CRYPT)!=0) RunCCM();
+        }
+        else if(registerOffset==CCMREG_OFFSET_CRYPT)
+        {
+            if((registerValue==0) || (isEnabled==0)) return;
+            RunCCM();
+        }
+        else if(registerOffset==CCMREG_OFFSET_STOP) return;
+        else if(registerOffset==CCMREG_OFFSET_MICSTATUS) return; // read only
+        else if(registerOffset==CCMREG_OFFSET_INTENSET) intenBits = intenBits | registerValue;
+        else if(registerOffset==CCMREG_OFFSET_INTENCLR) intenBits = intenBits & ~registerValue;
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* RunCCM - does the CRYPT task. This is the Bluetooth low energy flavor
+     *    of AES-CCM (RFC 3610 with a 2 byte length and a 4 byte MIC). See 
+     *    the note on the CCM in YakIO_CCM.h for the packet and nonce layout
+     * */
+    void YakIO_HOSTREGISTERS::RunCCM(void)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_CCM);
+        struct YakIO_CCMCONFIG *configPtr = (struct YakIO_CCMCONFIG *)GetRamPointer(GetWord(pageIndex, CCMREG_OFFSET_CNFPTR));
+        unsigned char *inPtr = (unsigned char *)GetRamPointer(GetWord(pageIndex, CCMREG_OFFSET_INPTR));
+        unsigned char *outPtr = (unsigned char *)GetRamPointer(GetWord(pageIndex, CCMREG_OFFSET_OUTPTR));
+        unsigned int isDecrypt = (GetWord(pageIndex, CCMREG_OFFSET_MODE)==CCM_MODE_DECRYPT);
+        unsigned int packetLength = 0;
+        if(inPtr!=NULL) packetLength = inPtr[CCM_PACKET_OFFSET_LENGTH];
+        unsigned int maxLength = CCM_MAX_PAYLOAD_BYTES;
+        if(isDecrypt!=0) maxLength = CCM_MAX_PAYLOAD_BYTES + CCM_MIC_BYTES;
+        if((configPtr==NULL) || (inPtr==NULL) || (outPtr==NULL) || (packetLength>maxLength))
+        {
+            // the real thing would read whatever is there. Call it an error
+            GetWord(pageIndex, CCMREG_OFFSET_ERROR) = 1;
+            return;
+        }
+
+        // work on a copy, INPTR and OUTPTR might be the same packet
+        unsigned char packetIn[CCM_PACKET_BYTES];
+        for(unsigned int i=0; i<(CCM_PACKET_HEADER_BYTES+packetLength); i++) packetIn[i] = inPtr[i];
+        outPtr[CCM_PACKET_OFFSET_S0] = packetIn[CCM_PACKET_OFFSET_S0];
+        outPtr[CCM_PACKET_OFFSET_S0+2] = packetIn[CCM_PACKET_OFFSET_S0+2];
+        unsigned int micIsGood = 1;
+        if(packetLength==0)
+        {
+            // empty packets are not encrypted and have no MIC
+            outPtr[CCM_PACKET_OFFSET_LENGTH] = 0;
+        }
+        else if((isDecrypt!=0) && (packetLength<CCM_MIC_BYTES))
+        {
+            // too short to have a MIC at all
+            outPtr[CCM_PACKET_OFFSET_LENGTH] = 0;
+            micIsGood = 0;
+        }
+        else
+        {
+            unsigned int payloadLength = packetLength;
+            if(isDecrypt!=0) payloadLength = packetLength - CCM_MIC_BYTES;
+
+            // the nonce: the 39 bit counter, the direction bit and the IV
+            unsigned char nonceBytes[13];
+            for(int i=0; i<CCM_COUNTER_USED_BYTES; i++) nonceBytes[i] = configPtr->counterBytes[i];
+            nonceBytes[4] = (nonceBytes[4] & CCM_COUNTER_HIGH_MASK) | ((configPtr->directionByte & 0x01)<<7);
+            for(int i=0; i<CCM_IV_BYTES; i++) nonceBytes[CCM_COUNTER_USED_BYTES+i] = configPtr->ivBytes[i];
+
+            YakIO_SOFTAES softAes;
+            softAes.SetKey(configPtr->keyBytes);
+            unsigned char blockBytes[SOFTAES_BLOCK_BYTES];
+            unsigned char macBytes[SOFTAES_BLOCK_BYTES];
+            unsigned char streamBytes[SOFTAES_BLOCK_BYTES];
+
+            // decrypt first so the MIC is worked out on the clear text. The 
+            // counter blocks A1, A2 ... give the key stream, A0 hides the MIC
+            unsigned char clearBytes[CCM_MAX_PAYLOAD_BYTES];
+            for(unsigned int blockNum=0; (blockNum*SOFTAES_BLOCK_BYTES)<payloadLength; blockNum++)
+            {
+                blockBytes[0] = 0x01;
+                for(int i=0; i<13; i++) blockBytes[1+i] = nonceBytes[i];
+                blockBytes[14] = 0;
+                blockBytes[15] = blockNum + 1;
+                softAes.EncryptBlock(blockBytes, streamBytes);
+                for(unsigned int i=0; (i<SOFTAES_BLOCK_BYTES) && (((blockNum*SOFTAES_BLOCK_BYTES)+i)<payloadLength); i++)
+                {
+                    unsigned int byteNum = (blockNum*SOFTAES_BLOCK_BYTES) + i;
+                    unsigned char outByte = packetIn[CCM_PACKET_OFFSET_PAYLOAD+byteNum] ^ streamBytes[i];
+                    outPtr[CCM_PACKET_OFFSET_PAYLOAD+byteNum] = outByte;
+                    if(isDecrypt!=0) clearBytes[byteNum] = outByte;
+                    else clearBytes[byteNum] = packetIn[CCM_PACKET_OFFSET_PAYLOAD+byteNum];
+                }
+            }
+
+            // the CBC-MAC over B0, the header block B1 and the clear text
+            macBytes[0] = 0x49;
+            for(int i=0; i<13; i++) macBytes[1+i] = nonceBytes[i];
+            macBytes[14] = 0;
+            macBytes[15] = payloadLength;
+            softAes.EncryptBlock(macBytes, macBytes);
+            blockBytes[0] = 0x00;
+            blockBytes[1] = 0x01;
+            blockBytes[2] = packetIn[CCM_PACKET_OFFSET_S0] & 0xE3; // NESN, SN and MD are not covered
+            for(int i=3; i<SOFTAES_BLOCK_BYTES; i++) blockBytes[i] = 0;
+            for(int i=0; i<SOFTAES_BLOCK_BYTES; i++) macBytes[i] = macBytes[i] ^ blockBytes[i];
+            softAes.EncryptBlock(macBytes, macBytes);
+            for(unsigned int blockNum=0; (blockNum*SOFTAES_BLOCK_BYTES)<payloadLength; blockNum++)
+            {
+                for(unsigned int i=0; (i<SOFTAES_BLOCK_BYTES) && (((blockNum*SOFTAES_BLOCK_BYTES)+i)<payloadLength); i++)
+                {
+                    macBytes[i] = macBytes[i] ^ clearBytes[(blockNum*SOFTAES_BLOCK_BYTES)+i];
+                }
+                softAes.EncryptBlock(macBytes, macBytes);
+            }
+            blockBytes[0] = 0x01;
+            for(int i=0; i<13; i++) blockBytes[1+i] = nonceBytes[i];
+            blockBytes[14] = 0;
+            blockBytes[15] = 0;
+            softAes.EncryptBlock(blockBytes, streamBytes);
+
+            unsigned char *micPtr = &packetIn[CCM_PACKET_OFFSET_PAYLOAD+payloadLength];
+            for(int i=0; i<CCM_MIC_BYTES; i++)
+            {
+                unsigned char micByte = macBytes[i] ^ streamBytes[i];
+                if(isDecrypt==0) outPtr[CCM_PACKET_OFFSET_PAYLOAD+payloadLength+i] = micByte;
+                else if(micPtr[i]!=micByte) micIsGood = 0;
+            }
+            if(isDecrypt==0) outPtr[CCM_PACKET_OFFSET_LENGTH] = payloadLength + CCM_MIC_BYTES;
+            else outPtr[CCM_PACKET_OFFSET_LENGTH] = payloadLength;
+        }
+        GetWord(pageIndex, CCMREG_OFFSET_MICSTATUS) = micIsGood;
+        GetWord(pageIndex, CCMREG_OFFSET_ENDCRYPT) = 1;
+        SignalEvent(REGISTER_CCM+CCMREG_OFFSET_ENDCRYPT);
+    }
+
+    /* WriteRadio - a write of a RADIO register. Switching the power off 
+     *    puts the whole RADIO back to its reset state
+     *
+     * inputs:
+     *    registerOffset - the offset into the RADIO page
+     *    registerValue - the value written
+     * */
+    void YakIO_HOSTREGISTERS::WriteRadio(unsigned int registerOffset, unsigned int registerValue)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_RADIO);
+        unsigned int &intenBits = GetWord(pageIndex, RNGREG_OFFSET_ITEN);
+        unsigned int &hwState = GetWord(pageIndex, RADIOREG_OFFSET_STATE);
+        if(registerOffset==RADIOREG_OFFSET_POWER)
+        {
+            if(registerValue==0)
+            {
+                for(int j=0; j<HOSTREG_PAGE_WORDS; j++) pageWords[pageIndex][j] = 0;
+                radioCyclesToEvent = 0;
+            }
+            GetWord(pageIndex, registerOffset) = registerValue & RADIO_POWER_ON;
+            return;
+        }
+
+        // the tasks only do something when a 1 is written and the power is on
+        if(registerOffset<=RADIOREG_OFFSET_BCSTOP)
+        {
+            if(registerValue==0) return;
+            if(GetWord(pageIndex, RADIOREG_OFFSET_POWER)==0) return;
+            if((registerOffset==RADIOREG_OFFSET_TXEN) || (registerOffset==RADIOREG_OFFSET_RXEN))
+            {
+                if(hwState!=RADIO_HWSTATE_DISABLED) return;
+                if(registerOffset==RADIOREG_OFFSET_TXEN) hwState = RADIO_HWSTATE_TXRU;
+                else hwState = RADIO_HWSTATE_RXRU;
+                radioNextEvent = RADIOREG_OFFSET_READY;
+                radioCyclesToEvent = HOSTREG_RADIO_RAMPUP_CYCLES;
+            }
+            else if(registerOffset==RADIOREG_OFFSET_START)
+            {
+                radioPacketAddress = GetWord(pageIndex, RADIOREG_OFFSET_PACKETPTR);
+                if(hwState==RADIO_HWSTATE_RXIDLE) hwState = RADIO_HWSTATE_RX;
+                else if(hwState==RADIO_HWSTATE_TXIDLE)
+                {
+                    // no more than MAXLEN payload bytes go out
+                    unsigned char *packetPtr = (unsigned char *)GetRamPointer(radioPacketAddress);
+                    unsigned int maxLength = GetWord(pageIndex, RADIOREG_OFFSET_PCNF1) & 0xFF;
+                    radioAirBytes[0] = 0;
+                    if(packetPtr!=NULL) radioAirBytes[0] = packetPtr[0];
+                    if(radioAirBytes[0]>maxLength) radioAirBytes[0] = maxLength;
+                    for(unsigned int i=1; i<=radioAirBytes[0]; i++) radioAirBytes[i] = packetPtr[i];
+                    hwState = RADIO_HWSTATE_TX;
+                    radioNextEvent = RADIOREG_OFFSET_ADDRESS;
+                    radioCyclesToEvent = GetRadioAddressCycles();
+                    radioStartCycle = cycleCount;
+                }
+            }
+            else if(registerOffset==RADIOREG_OFFSET_STOP)
+            {
+                // whatever was on the air is lost, the RADIO stays ramped up
+                if(hwState==RADIO_HWSTATE_TX) hwState = RADIO_HWSTATE_TXIDLE;
+                else if(hwState==RADIO_HWSTATE_RX) hwState = RADIO_HWSTATE_RXIDLE;
+                else return;
+                radioCyclesToEvent = 0;
+            }
+            else if(registerOffset==RADIOREG_OFFSET_DISABLE)
+            {
+                if(hwState==RADIO_HWSTATE_DISABLED) return;
+                hwState = RADIO_HWSTATE_DISABLED;
+                radioCyclesToEvent = 0;
+                RaiseRadioEvent(RADIOREG_OFFSET_DISABLED);
+            }
+            else if(registerOffset==RADIOREG_OFFSET_RSSISTART)
+            {
+                GetWord(pageIndex, RADIOREG_OFFSET_RSSISAMPLE) = HOSTREG_RADIO_DEFAULT_RSSI;
+                RaiseRadioEvent(RADIOREG_OFFSET_RSSIEND);
+            }
+            return;
+        }
+        if(registerOffset==RADIOREG_OFFSET_INTENSET) intenBits = intenBits | registerValue;
+        else if(registerOffset==RADIOREG_OFFSET_INTENCLR) intenBits = intenBits & ~registerValue;
+        else if(registerOffset==RADIOREG_OFFSET_STATE) return; // read only
+        else if(registerOffset==RADIOREG_OFFSET_CRCSTATUS) return; // read only
+        else if(registerOffset==RADIOREG_OFFSET_RSSISAMPLE) return; // read only
+        else GetWord(pageIndex, registerOffset) = registerValue;
+    }
+
+    /* RaiseRadioEvent - sets a RADIO event, starts any PPI tasks on it and
+     *    runs the shortcuts
+     *
+     * inputs:
+     *    eventOffset - the offset of the event in the RADIO page
+     * */
+    void YakIO_HOSTREGISTERS::RaiseRadioEvent(unsigned int eventOffset)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_RADIO);
+        GetWord(pageIndex, eventOffset) = 1;
+        SignalEvent(REGISTER_RADIO+eventOffset);
+
+        unsigned int shortBits = GetWord(pageIndex, RADIOREG_OFFSET_SHORTS);
+        if(eventOffset==RADIOREG_OFFSET_READY)
+        {
+            if((shortBits & RADIO_SHORT_READY_START)!=0) WriteRadio(RADIOREG_OFFSET_START, 1);
+        }
+        else if(eventOffset==RADIOREG_OFFSET_ADDRESS)
+        {
+            if((shortBits & RADIO_SHORT_ADDRESS_RSSISTART)!=0) WriteRadio(RADIOREG_OFFSET_RSSISTART, 1);
+        }
+        else if(eventOffset==RADIOREG_OFFSET_END)
+        {
+            if((shortBits & RADIO_SHORT_END_DISABLE)!=0) WriteRadio(RADIOREG_OFFSET_DISABLE, 1);
+            else if((shortBits & RADIO_SHORT_END_START)!=0) WriteRadio(RADIOREG_OFFSET_START, 1);
+        }
+        else if(eventOffset==RADIOREG_OFFSET_DISABLED)
+        {
+            if((shortBits & RADIO_SHORT_DISABLED_TXEN)!=0) WriteRadio(RADIOREG_OFFSET_TXEN, 1);
+            else if((shortBits & RADIO_SHORT_DISABLED_RXEN)!=0) WriteRadio(RADIOREG_OFFSET_RXEN, 1);
+        }
+    }
+
+    /* FinishRadioStep - the RADIO countdown has run out. Does whatever the
+     *    RADIO was waiting to do - finish ramping up, get to the end of the 
+     *    address or to the end of the packet - and raises the event for it
+     * */
+    void YakIO_HOSTREGISTERS::FinishRadioStep(void)
+    {
+        int pageIndex = HOSTREG_PAGE_OF(REGISTER_RADIO);
+        unsigned int &hwState = GetWord(pageIndex, RADIOREG_OFFSET_STATE);
+        unsigned int eventOffset = radioNextEvent;
+        if(eventOffset==RADIOREG_OFFSET_READY)
+        {
+            if(hwState==RADIO_HWSTATE_TXRU) hwState = RADIO_HWSTATE_TXIDLE;
+            else hwState = RADIO_HWSTATE_RXIDLE;
+        }
+        else if(eventOffset==RADIOREG_OFFSET_ADDRESS)
+        {
+            radioAddressCycle = cycleCount;
+            // the LENGTH byte, the payload and the CRC are still to come
+            unsigned int crcBytes = GetWord(pageIndex, RADIOREG_OFFSET_CRCCNF) & 0x03;
+            radioNextEvent = RADIOREG_OFFSET_END;
+            radioCyclesToEvent = (1 + radioAirBytes[0] + crcBytes) * GetRadioByteCycles();
+        }
+        else if(hwState==RADIO_HWSTATE_TX)
+        {
+            for(unsigned int i=0; i<=radioAirBytes[0]; i++) radioTxBytes[i] = radioAirBytes[i];
+            radioTxCount = radioTxCount + 1;
+            radioTxFrequency = GetWord(pageIndex, RADIOREG_OFFSET_FREQUENCY);
+            hwState = RADIO_HWSTATE_TXIDLE;
+        }
+        else
+        {
+            // into RAM, but no more than MAXLEN payload bytes
+            unsigned char *packetPtr = (unsigned char *)GetRamPointer(radioPacketAddress);
+            unsigned int maxLength = GetWord(pageIndex, RADIOREG_OFFSET_PCNF1) & 0xFF;
+            if(packetPtr!=NULL)
+            {
+                packetPtr[0] = radioAirBytes[0];
+                for(unsigned int i=1; (i<=radioAirBytes[0]) && (i<=maxLength); i++) packetPtr[i] = radioAirBytes[i];
+            }
+            GetWord(pageIndex, RADIOREG_OFFSET_CRCSTATUS) = radioAirCrcIsGood;
+            GetWord(pageIndex, RADIOREG_OFFSET_RXMATCH) = 0;
+            hwState = RADIO_HWSTATE_RXIDLE;
+        }
+        RaiseRadioEvent(eventOffset);
+    }
+
+    /* GetRadioByteCycles - gets the time one byte takes on the air
+     *
+     * returns:
+     *    the number of 16MHz cycles at the data rate in MODE
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetRadioByteCycles(void)
+    {
+        return HOSTREG_RADIO_BYTE_CYCLES_1MBIT >> (GetWord(HOSTREG_PAGE_OF(REGISTER_RADIO), RADIOREG_OFFSET_MODE) & 0x01);
+    }
+
+    /* GetRadioAddressCycles - gets the time from the start of a packet to
+     *    the end of its address, which is when ADDRESS is set
+     *
+     * returns:
+     *    the number of 16MHz cycles
+     * */
+    unsigned int YakIO_HOSTREGISTERS::GetRadioAddressCycles(void)
+    {
+        unsigned int baseBytes = (GetWord(HOSTREG_PAGE_OF(REGISTER_RADIO), RADIOREG_OFFSET_PCNF1)>>RADIO_PCNF1_BALEN_SHIFT) & 0x07;
+        return (HOSTREG_RADIO_PREAMBLE_BYTES + baseBytes + 1) * GetRadioByteCycles();
+    }
+
+#endif
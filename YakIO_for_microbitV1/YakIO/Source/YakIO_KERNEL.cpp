@@ -0,0 +1,518 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_NVIC.h"
+#include "YakIO_KERNEL.h"
+
+// the PENDSVC_handler() is a non-member function. It has no idea of what 
+// kernel object it should work on. It is also written in assembler and so 
+// it cannot easily look inside a class. These two pointers are the only 
+// things it needs. They are declared extern "C" so that their names are 
+// not "mangled" by the C++ compiler and the assembler can find them.
+//
+// kernelCurrentThread - the thread that is running now (NULL before Start())
+// kernelNextThread    - the thread Schedule() has decided should run next
+//
+// These values are exclusively local in scope and should not be messed with by
+// external operations, or by anything really.
+//
+// They are marked "used" because the compiler cannot see inside the assembler. 
+// Without it a link time optimized build (see the Makefile) might decide 
+// nothing uses them and throw them away or rename them.
+extern "C" 
+{
+    __attribute__ ((used)) YakIO_THREAD * volatile kernelCurrentThread = NULL;
+    __attribute__ ((used)) YakIO_THREAD * volatile kernelNextThread = NULL;
+}
+
+// set in the constructor so the YakIO_SEMAPHORE and YakIO_MSGQUEUE can find us
+YakIO_KERNEL *kernel_ptr = NULL;
+
+    /* constructor
+     *
+     * inputs:
+     *    tickTimerIDIn - the timer to use for the kernel tick. Do not use
+     *        this timer for anything else.
+     * */
+    YakIO_KERNEL::YakIO_KERNEL(enum TIMER tickTimerIDIn) : tickTimerObj {tickTimerIDIn}
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        // all thread slots are empty
+        for(unsigned int i=0; i<(KERNEL_MAX_THREADS+1); i++)
+        {
+            threads[i].savedStackPointer = NULL;
+            threads[i].threadState = THREAD_STATE_UNUSED;
+            threads[i].priority = 0;
+            threads[i].wakeTick = 0;
+            threads[i].hasTimeout = 0;
+            threads[i].wakeReason = THREAD_WAKE_SIGNALLED;
+            threads[i].waitListPtr = NULL;
+            threads[i].callbackInterfacePtr = NULL;
+            threads[i].callbackID = CALLBACK_NONE;
+        }
+
+        // remember our 'this' pointer
+        kernel_ptr = this;
+    }
+
+    /* InitThread - sets up a thread slot and builds the initial stack frame
+     *    for the thread so that the PENDSVC_handler() can "return" into it 
+     *    exactly as if it had been running before and was switched out
+     *
+     * inputs:
+     *    threadIndex - the slot to use
+     *    priority - the thread priority
+     *    stackPtr - the lowest address of the stack memory
+     *    stackWords - the size of the stack memory in 32 bit words
+     *    callbackIDIn - which of the callback functions is the thread function
+     *    callbackInterfacePtrIn - the object with the thread function in it
+     *
+     * returns:
+     *    1 if the thread was set up, 0 if it was not
+     * */
+    unsigned int YakIO_KERNEL::InitThread(unsigned int threadIndex, unsigned int priority, unsigned int *stackPtr, unsigned int stackWords, enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        if(stackPtr==NULL) return 0;
+        if(stackWords<KERNEL_MIN_STACK_WORDS) return 0;
+
+        // stacks grow downwards so we start at the top. The ARM calling 
+        // convention requires the stack to be 8 byte aligned so we round
+        // down to an even number of words
+        unsigned int *stackTop = stackPtr + (stackWords & 0xFFFFFFFE);
+
+        // this is what the CPU itself pushes on entry to an exception. The
+        // PENDSVC_handler() will pop it on the way out, so this is where the
+        // thread "returns" to the first time it runs
+        *(--stackTop) = 0x01000000;                                         // xPSR, just the Thumb bit set
+        *(--stackTop) = ((unsigned int)&YakIO_KERNEL::ThreadEntry) & 0xFFFFFFFE; // PC, bit 0 must be clear here
+        *(--stackTop) = 0;                                                  // LR, ThreadEntry() never returns
+        *(--stackTop) = 0;                                                  // R12
+        *(--stackTop) = 0;                                                  // R3
+        *(--stackTop) = 0;                                                  // R2
+        *(--stackTop) = 0;                                                  // R1
+        *(--stackTop) = (unsigned int)&threads[threadIndex];                // R0, the argument to ThreadEntry()
+        // this is what the PENDSVC_handler() pushes itself. R4 to R11
+        for(int i=0; i<8; i++) *(--stackTop) = 0;
+
+        threads[threadIndex].savedStackPointer = stackTop;
+        threads[threadIndex].priority = priority;
+        threads[threadIndex].wakeTick = 0;
+        threads[threadIndex].hasTimeout = 0;
+        threads[threadIndex].wakeReason = THREAD_WAKE_SIGNALLED;
+        threads[threadIndex].waitListPtr = NULL;
+        threads[threadIndex].callbackInterfacePtr = callbackInterfacePtrIn;
+        threads[threadIndex].callbackID = callbackIDIn;
+        // do this last, it makes the thread visible to Schedule()
+        threads[threadIndex].threadState = THREAD_STATE_READY;
+        return 1;
+    }
+
+    /* CreateThread - creates a thread. The thread function is one of the
+     *    Callback0() to Callback3() functions of the callback object. The
+     *    callback object must inherit from YakIO_CALLBACK.
+     *
+     *    Threads can be created before or after Start() is called.
+     *
+     *    If the thread function ever returns the thread is deleted and its
+     *    slot can be reused.
+     *
+     * inputs:
+     *    priority - the priority, bigger numbers are more important. 0 is 
+     *       reserved for the idle thread so it will be changed to 1
+     *    stackPtr - the stack memory, usually an array of unsigned int in
+     *       the object creating the thread
+     *    stackWords - the size of the stack memory in 32 bit words. Must be at
+     *       least KERNEL_MIN_STACK_WORDS
+     *    callbackIDIn - which of the callback functions is the thread function.
+     *       Must be CALLBACK_0 to CALLBACK_3
+     *    callbackInterfacePtrIn - the "this" pointer of the object with the
+     *       thread function in it
+     *
+     * returns:
+     *    the index of the new thread or -1 if it could not be created
+     * */
+    int YakIO_KERNEL::CreateThread(unsigned int priority, unsigned int *stackPtr, unsigned int stackWords, enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return -1;
+        if(callbackInterfacePtrIn==NULL) return -1;
+        if((callbackIDIn!=CALLBACK_0) && (callbackIDIn!=CALLBACK_1) && (callbackIDIn!=CALLBACK_2) && (callbackIDIn!=CALLBACK_3)) return -1;
+        // the idle thread has priority 0 all to itself
+        if(priority==0) priority=1;
+
+        int newIndex = -1;
+        unsigned int primaskState = EnterCritical();
+        // find a free slot. The last one is reserved for the idle thread
+        for(unsigned int i=0; i<KERNEL_MAX_THREADS; i++)
+        {
+            if(threads[i].threadState!=THREAD_STATE_UNUSED) continue;
+            if(InitThread(i, priority, stackPtr, stackWords, callbackIDIn, callbackInterfacePtrIn)!=0) newIndex = i;
+            break;
+        }
+        // a new thread might be more important than the one running now
+        if((newIndex>=0) && (isRunning!=0)) Schedule();
+        ExitCritical(primaskState);
+        return newIndex;
+    }
+
+    /* ThreadEntry - every thread starts here. This calls the thread function
+     *    and tidies up if the thread function ever returns.
+     *
+     *    NOTE: this is a static member so that we can take its address and
+     *    put it in the initial stack frame. It gets its thread pointer in R0
+     *    which is where the first argument of a function is always passed.
+     *
+     * inputs:
+     *    threadPtr - the thread we are running
+     * */
+    void YakIO_KERNEL::ThreadEntry(YakIO_THREAD *threadPtr)
+    {
+        // figure out what callback function to call and call it
+        if(threadPtr->callbackID == CALLBACK_0) threadPtr->callbackInterfacePtr->Callback0();
+        else if(threadPtr->callbackID == CALLBACK_1) threadPtr->callbackInterfacePtr->Callback1();
+        else if(threadPtr->callbackID == CALLBACK_2) threadPtr->callbackInterfacePtr->Callback2();
+        else if(threadPtr->callbackID == CALLBACK_3) threadPtr->callbackInterfacePtr->Callback3();
+
+        // the thread function returned. This thread is finished. 
+        EnterCritical();
+        threadPtr->threadState = THREAD_STATE_UNUSED;
+        kernel_ptr->Schedule();
+        // interrupts back on, the PendSV happens and we never come back here
+        asm volatile ("cpsie i" : : : "memory");
+        while(1) {}
+    }
+
+    /* Start - starts the kernel. The highest priority thread starts running.
+     *
+     *    NOTE: This never returns. The code that called it (usually the 
+     *      MainLoop()) is finished. Create at least one thread first.
+     * */
+    void YakIO_KERNEL::Start(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(isRunning!=0) return;
+
+        // set up our idle thread in the last slot. It runs Callback1() on us
+        InitThread(KERNEL_MAX_THREADS, 0, idleThreadStack, KERNEL_IDLE_STACK_WORDS, CALLBACK_1, this);
+
+        // PendSV must have the lowest priority of all. It must never interrupt
+        // an interrupt handler - only threads. The other field in this register 
+        // belongs to SysTick which the nRF51822 does not have.
+        YAKIO_REGISTER(REGISTER_NVIC+SCBREG_OFFSET_SHPR3) = YAKIO_REGISTER(REGISTER_NVIC+SCBREG_OFFSET_SHPR3) | SCB_SHPR3_PENDSV_LOWEST;
+
+        // start the tick, 16MHz/2^4 = 1MHz and we count to 1000 so 1 millisecond
+        tickTimerObj.QuickSetup(4, 1000, CALLBACK_0, this);
+
+        isRunning=1;
+
+        // pick the first thread. Since kernelCurrentThread is NULL the 
+        // PENDSVC_handler() knows there is nothing to save
+        Schedule();
+
+        // the PendSV happens right about here and we never come back. The 
+        // stack we were running on becomes the stack for the interrupt handlers
+        while(1) {}
+    }
+
+    /* Schedule - decides which thread should be running and, if it is not 
+     *    the one which is running now, pends a PendSV to switch to it.
+     *
+     *    NOTE: the switch does not happen in here. It happens once this
+     *    returns and any interrupt handler that called this has finished.
+     *
+     *    Threads of equal priority take turns. We start looking just after 
+     *    the current thread and only a strictly higher priority replaces the 
+     *    best found so far, so the next equal priority thread in line wins.
+     * */
+    void YakIO_KERNEL::Schedule(void)
+    {
+        if(isRunning==0) return;
+
+        unsigned int primaskState = EnterCritical();
+
+        // where are we now? 
+        unsigned int searchIndex = 0;
+        if(kernelCurrentThread!=NULL) searchIndex = GetCurrentThreadIndex() + 1;
+
+        int bestIndex = -1;
+        for(unsigned int n=0; n<(KERNEL_MAX_THREADS+1); n++)
+        {
+            if(searchIndex>=(KERNEL_MAX_THREADS+1)) searchIndex=0;
+            if(threads[searchIndex].threadState==THREAD_STATE_READY)
+            {
+                if((bestIndex<0) || (threads[searchIndex].priority > threads[bestIndex].priority)) bestIndex = searchIndex;
+            }
+            searchIndex++;
+        }
+
+        // the idle thread is always ready so this should never happen
+        if(bestIndex>=0)
+        {
+            kernelNextThread = &threads[bestIndex];
+            // pend the PendSV to do the switch
+            if(kernelNextThread!=kernelCurrentThread) YAKIO_REGISTER(REGISTER_NVIC+SCBREG_OFFSET_ICSR) = SCB_ICSR_PENDSVSET_BIT;
+        }
+
+        ExitCritical(primaskState);
+    }
+
+    /* Sleep - stops the current thread for a number of kernel ticks. Other
+     *    threads run while it sleeps. The CPU is not spinning in here.
+     *
+     *    NOTE: Call this only from a thread, never from an interrupt handler
+     *
+     * inputs:
+     *    ticksToSleep - the number of ticks (milliseconds) to sleep. 0 just
+     *       gives the other threads of the same priority a turn
+     * */
+    void YakIO_KERNEL::Sleep(unsigned int ticksToSleep)
+    {
+        if(isRunning==0) return;
+        if(ticksToSleep==0)
+        {
+            Yield();
+            return;
+        }
+
+        EnterCritical();
+        kernelCurrentThread->wakeTick = tickCount + ticksToSleep;
+        kernelCurrentThread->threadState = THREAD_STATE_SLEEPING;
+        Schedule();
+        // interrupts back on, the PendSV happens now and we continue
+        // from here when we wake up
+        asm volatile ("cpsie i" : : : "memory");
+    }
+
+    /* Yield - gives any other ready thread of the same priority a turn.
+     *
+     *    NOTE: Call this only from a thread, never from an interrupt handler
+     * */
+    void YakIO_KERNEL::Yield(void)
+    {
+        Schedule();
+    }
+
+    /* BlockCurrentThread - puts the current thread on a wait list and 
+     *    switches away from it. Used by YakIO_SEMAPHORE and YakIO_MSGQUEUE.
+     *
+     *    NOTE: This MUST be called with the interrupts disabled and it returns
+     *      with them disabled. It turns them on briefly in the middle to let
+     *      the switch happen.
+     *
+     * inputs:
+     *    waitListPtr - the wait list. Each bit is a thread index
+     *    timeoutTicks - the maximum number of ticks to wait or KERNEL_WAIT_FOREVER
+     *
+     * returns:
+     *    THREAD_WAKE_SIGNALLED if woken by WakeHighestWaiter(), THREAD_WAKE_TIMEOUT
+     *    if the timeout expired first
+     * */
+    enum THREAD_WAKE_REASON YakIO_KERNEL::BlockCurrentThread(volatile unsigned int *waitListPtr, unsigned int timeoutTicks)
+    {
+        if(isRunning==0) return THREAD_WAKE_TIMEOUT;
+
+        YakIO_THREAD *threadPtr = kernelCurrentThread;
+        threadPtr->waitListPtr = waitListPtr;
+        threadPtr->hasTimeout = 0;
+        if(timeoutTicks!=KERNEL_WAIT_FOREVER)
+        {
+            threadPtr->hasTimeout = 1;
+            threadPtr->wakeTick = tickCount + timeoutTicks;
+        }
+        threadPtr->wakeReason = THREAD_WAKE_SIGNALLED;
+        threadPtr->threadState = THREAD_STATE_BLOCKED;
+        *waitListPtr = *waitListPtr | (0x01 << GetCurrentThreadIndex());
+        Schedule();
+
+        // interrupts back on, the PendSV happens now. We continue from 
+        // here when we are woken up
+        asm volatile ("cpsie i" : : : "memory");
+        asm volatile ("cpsid i" : : : "memory");
+
+        return threadPtr->wakeReason;
+    }
+
+    /* WakeHighestWaiter - takes the highest priority thread off a wait list
+     *    and makes it ready. Used by YakIO_SEMAPHORE and YakIO_MSGQUEUE.
+     *
+     *    NOTE: Call this with the interrupts disabled. Can be called from an
+     *      interrupt handler.
+     *
+     * inputs:
+     *    waitListPtr - the wait list. Each bit is a thread index
+     * */
+    void YakIO_KERNEL::WakeHighestWaiter(volatile unsigned int *waitListPtr)
+    {
+        int bestIndex = -1;
+        for(unsigned int i=0; i<KERNEL_MAX_THREADS; i++)
+        {
+            if(((*waitListPtr) & (0x01<<i)) == 0) continue;
+            if((bestIndex<0) || (threads[i].priority > threads[bestIndex].priority)) bestIndex = i;
+        }
+        if(bestIndex<0) return;
+
+        *waitListPtr = *waitListPtr & ~(0x01<<bestIndex);
+        threads[bestIndex].waitListPtr = NULL;
+        threads[bestIndex].hasTimeout = 0;
+        threads[bestIndex].wakeReason = THREAD_WAKE_SIGNALLED;
+        threads[bestIndex].threadState = THREAD_STATE_READY;
+        Schedule();
+    }
+
+    /* GetTickCount - gets the number of kernel ticks (milliseconds) since
+     *    Start() was called. Wraps after about 49 days.
+     *
+     * returns:
+     *    the tick count
+     * */
+    unsigned int YakIO_KERNEL::GetTickCount(void)
+    {
+        return tickCount;
+    }
+
+    /* IsRunning - tells if Start() has been called
+     *
+     * returns:
+     *    1 if the kernel is running, 0 if not
+     * */
+    unsigned int YakIO_KERNEL::IsRunning(void)
+    {
+        return isRunning;
+    }
+
+    /* GetCurrentThreadIndex - gets the index of the running thread
+     *
+     * returns:
+     *    the index of the running thread, -1 if the kernel is not running.
+     *    The idle thread has the index KERNEL_MAX_THREADS
+     * */
+    int YakIO_KERNEL::GetCurrentThreadIndex(void)
+    {
+        if(kernelCurrentThread==NULL) return -1;
+        return kernelCurrentThread - threads;
+    }
+
+    /* Callback0 - the kernel tick. Called from the tick timer interrupt every
+     *    millisecond. Wakes any thread whose sleep or timeout has expired and
+     *    gives threads of equal priority their turn.
+     * */
+    void YakIO_KERNEL::Callback0(void)
+    {
+        unsigned int primaskState = EnterCritical();
+        tickCount = tickCount + 1;
+
+        for(unsigned int i=0; i<KERNEL_MAX_THREADS; i++)
+        {
+            YakIO_THREAD *threadPtr = &threads[i];
+            // the subtraction and the cast to int makes this work even
+            // when tickCount wraps around
+            unsigned int isDue = ((int)(tickCount - threadPtr->wakeTick) >= 0);
+            if((threadPtr->threadState==THREAD_STATE_SLEEPING) && (isDue!=0))
+            {
+                threadPtr->threadState = THREAD_STATE_READY;
+            }
+            else if((threadPtr->threadState==THREAD_STATE_BLOCKED) && (threadPtr->hasTimeout!=0) && (isDue!=0))
+            {
+                // take it off the wait list it was on
+                *(threadPtr->waitListPtr) = *(threadPtr->waitListPtr) & ~(0x01<<i);
+                threadPtr->waitListPtr = NULL;
+                threadPtr->hasTimeout = 0;
+                threadPtr->wakeReason = THREAD_WAKE_TIMEOUT;
+                threadPtr->threadState = THREAD_STATE_READY;
+            }
+        }
+
+        Schedule();
+        ExitCritical(primaskState);
+    }
+
+    /* Callback1 - the idle thread. Runs when no other thread is ready. 
+     *    Just sleeps until the next interrupt.
+     * */
+    void YakIO_KERNEL::Callback1(void)
+    {
+        while(1)
+        {
+            asm volatile ("wfi");
+        }
+    }
+
+    /* PENDSVC_handler
+     *
+     * Note: the address of this function is set in the flash by the linker.
+     *       If this function exists then this functions address will be used,
+     *       if it does not exist then the interrupt will be directed to a
+     *       default handler which spins forever. The flash address is not
+     *       runtime settable.
+     *
+     *       The name really matters here. See the discussion in YakIO.cpp
+     *
+     *   Do NOT define this anywhere else. This class needs it here.
+     *
+     * This is the context switch. It is "naked" which means the compiler adds
+     * no code of its own to the start and end of it - it is entirely the 
+     * assembler below. By the time we get here the CPU has already pushed 
+     * R0-R3, R12, LR, PC and xPSR of the old thread onto the old threads stack.
+     *
+     * The Cortex-M0 can only use the STM and LDM instructions on the low 
+     * registers R0-R7 so R8-R11 have to be moved into low registers first. 
+     * This is why it looks more complicated than the versions for bigger CPUs.
+     *
+     * The cycle counts on the right are from the ARM Cortex-M0 Technical 
+     * Reference Manual. They add up to 60.
+     * */
+    __attribute__ ((naked)) void PENDSVC_handler(void)
+    {
+        asm volatile (
+            "    cpsid i                        \n"   // 1  no interrupts while we juggle the stacks
+            "    mrs   r0, psp                  \n"   // 3  r0 = old threads stack pointer
+            "    ldr   r3, =kernelCurrentThread \n"   // 2
+            "    ldr   r2, [r3]                 \n"   // 2  r2 = old thread
+            "    cmp   r2, #0                   \n"   // 1  no old thread the first time
+            "    beq   1f                       \n"   // 1  (not taken)
+            "    subs  r0, #32                  \n"   // 1  room for R4-R11
+            "    str   r0, [r2]                 \n"   // 2  old thread->savedStackPointer = r0
+            "    stmia r0!, {r4-r7}             \n"   // 5  save R4-R7
+            "    mov   r4, r8                   \n"   // 1
+            "    mov   r5, r9                   \n"   // 1
+            "    mov   r6, r10                  \n"   // 1
+            "    mov   r7, r11                  \n"   // 1
+            "    stmia r0!, {r4-r7}             \n"   // 5  save R8-R11
+            "1:                                 \n"
+            "    ldr   r1, =kernelNextThread    \n"   // 2
+            "    ldr   r2, [r1]                 \n"   // 2  r2 = new thread
+            "    str   r2, [r3]                 \n"   // 2  kernelCurrentThread = new thread
+            "    ldr   r0, [r2]                 \n"   // 2  r0 = new thread->savedStackPointer
+            "    adds  r0, #16                  \n"   // 1  R8-R11 are the second four
+            "    ldmia r0!, {r4-r7}             \n"   // 5
+            "    mov   r8, r4                   \n"   // 1
+            "    mov   r9, r5                   \n"   // 1
+            "    mov   r10, r6                  \n"   // 1
+            "    mov   r11, r7                  \n"   // 1  R8-R11 restored
+            "    msr   psp, r0                  \n"   // 3  the CPU pops the rest from here
+            "    subs  r0, #32                  \n"   // 1
+            "    ldmia r0!, {r4-r7}             \n"   // 5  R4-R7 restored
+            "    cpsie i                        \n"   // 1
+            "    ldr   r0, =0xFFFFFFFD          \n"   // 2  "return to thread mode using the PSP"
+            "    bx    r0                       \n"   // 3
+            "    .ltorg                         \n"   //    the constants for the ldr r?,= instructions go here
+        );
+    }
@@ -15,6 +15,7 @@
 /// +------------------------------------------------------------------------------------------------------------------------------+
 
 #include "YakIO_LEDARRAY.h"
+#include "YakIO_MEMORY.h"
 
     /* constructor
      * */
@@ -36,7 +37,7 @@
         unsigned int bitVal = LEDROW1 | LEDROW2 | LEDROW3;
                                
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_DIRSET)) = bitVal;
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_DIRSET) = bitVal;
     }
     
     /* ClearImage -- immediately set image to blank 
@@ -126,8 +127,8 @@
      * */
     void YakIO_LEDARRAY::SetBinaryImage(const unsigned char bImage[])
     {
-        // copy the data into place
-        for (unsigned int i=0; i<sizeof(backingStore); i++) backingStore[i] =  bImage[i]; 
+        // copy the data into place. See the MEMCPY notes in YakIO_MEMORY.h
+        memcpy(backingStore, bImage, sizeof(backingStore));
         // move it into the register words
         ProcessBackingStore();
     }
@@ -145,9 +146,9 @@
         // we take care to just operate on the bits we are interested in, set them to 0 
         // and leave the others there is a special CLR register where writing a 1 to 
         // the appropriate positon will clear the bit
-        (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTCLR)) = GPIO_LED_MASK;
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTCLR) = GPIO_LED_MASK;
         // now if the bits we are interested in are to be 1 we set them using the special SET register
-        (*(unsigned volatile *) (REGISTER_GPIO+GPIOREG_OFFSET_OUTSET)) =  backingStoreRegisterSettings[currentRow];
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTSET) =  backingStoreRegisterSettings[currentRow];
         currentRow++;
         if (currentRow >= NUM_GPIOROWS_IN_LED_IMAGE) currentRow=0;
     }
@@ -0,0 +1,232 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_MEMORY.h"
+
+// See the MEMCPY notes in YakIO_MEMORY.h
+//
+// NOTE: these are all non-member C functions. The compiler expects to find them by these exact names
+
+// #
+// # memcpy, memset and memmove
+// #
+
+/* memcpy - copies memory. The two areas must not overlap - use memmove() 
+ *    if they might.
+ *
+ * inputs:
+ *    destPtr - where to copy to
+ *    srcPtr - where to copy from
+ *    byteCount - the number of bytes to copy
+ *
+ * returns:
+ *    destPtr
+ * */
+void *memcpy(void *destPtr, const void *srcPtr, size_t byteCount)
+{
+    unsigned char *destBytePtr = (unsigned char *)destPtr;
+    const unsigned char *srcBytePtr = (const unsigned char *)srcPtr;
+
+    // can they both be word aligned at the same time?
+    if((byteCount>=8) && ((((unsigned int)destBytePtr ^ (unsigned int)srcBytePtr) & 0x03)==0))
+    {
+        // yes, a few bytes at the start gets us there
+        while(((unsigned int)destBytePtr & 0x03)!=0)
+        {
+            *destBytePtr++ = *srcBytePtr++;
+            byteCount--;
+        }
+
+        unsigned int *destWordPtr = (unsigned int *)destBytePtr;
+        const unsigned int *srcWordPtr = (const unsigned int *)srcBytePtr;
+
+        // 16 bytes at a time with LDM/STM. These update the pointers as they go
+        unsigned int blockCount = byteCount >> 4;
+        if(blockCount!=0)
+        {
+            asm volatile (
+                "1: \n"
+                "   ldmia %[src]!, {r3, r4, r5, r6} \n"
+                "   stmia %[dest]!, {r3, r4, r5, r6} \n"
+                "   subs %[count], #1 \n"
+                "   bne 1b \n"
+                : [dest] "+l" (destWordPtr), [src] "+l" (srcWordPtr), [count] "+l" (blockCount)
+                : 
+                : "r3", "r4", "r5", "r6", "cc", "memory");
+        }
+
+        // then a word at a time
+        unsigned int wordCount = (byteCount >> 2) & 0x03;
+        while(wordCount!=0)
+        {
+            *destWordPtr++ = *srcWordPtr++;
+            wordCount--;
+        }
+
+        destBytePtr = (unsigned char *)destWordPtr;
+        srcBytePtr = (const unsigned char *)srcWordPtr;
+        byteCount = byteCount & 0x03;
+    }
+
+    // whatever is left, or everything if they could not be aligned
+    while(byteCount!=0)
+    {
+        *destBytePtr++ = *srcBytePtr++;
+        byteCount--;
+    }
+    return destPtr;
+}
+
+/* memset - sets memory to a value
+ *
+ * inputs:
+ *    destPtr - the memory to set
+ *    byteValue - the value. Only the bottom 8 bits are used
+ *    byteCount - the number of bytes to set
+ *
+ * returns:
+ *    destPtr
+ * */
+void *memset(void *destPtr, int byteValue, size_t byteCount)
+{
+    unsigned char *destBytePtr = (unsigned char *)destPtr;
+    unsigned char fillByte = (unsigned char)byteValue;
+
+    if(byteCount>=8)
+    {
+        // a few bytes at the start gets us word aligned
+        while(((unsigned int)destBytePtr & 0x03)!=0)
+        {
+            *destBytePtr++ = fillByte;
+            byteCount--;
+        }
+
+        // the byte in all four places in the word
+        unsigned int fillWord = fillByte * 0x01010101;
+        unsigned int *destWordPtr = (unsigned int *)destBytePtr;
+
+        // 16 bytes at a time with STM
+        unsigned int blockCount = byteCount >> 4;
+        if(blockCount!=0)
+        {
+            asm volatile (
+                "   mov r3, %[fill] \n"
+                "   mov r4, r3 \n"
+                "   mov r5, r3 \n"
+                "   mov r6, r3 \n"
+                "1: \n"
+                "   stmia %[dest]!, {r3, r4, r5, r6} \n"
+                "   subs %[count], #1 \n"
+                "   bne 1b \n"
+                : [dest] "+l" (destWordPtr), [count] "+l" (blockCount)
+                : [fill] "l" (fillWord)
+                : "r3", "r4", "r5", "r6", "cc", "memory");
+        }
+
+        // then a word at a time
+        unsigned int wordCount = (byteCount >> 2) & 0x03;
+        while(wordCount!=0)
+        {
+            *destWordPtr++ = fillWord;
+            wordCount--;
+        }
+
+        destBytePtr = (unsigned char *)destWordPtr;
+        byteCount = byteCount & 0x03;
+    }
+
+    while(byteCount!=0)
+    {
+        *destBytePtr++ = fillByte;
+        byteCount--;
+    }
+    return destPtr;
+}
+
+/* memmove - copies memory. Unlike memcpy() the two areas can overlap
+ *
+ * inputs:
+ *    destPtr - where to copy to
+ *    srcPtr - where to copy from
+ *    byteCount - the number of bytes to copy
+ *
+ * returns:
+ *    destPtr
+ * */
+void *memmove(void *destPtr, const void *srcPtr, size_t byteCount)
+{
+    unsigned char *destBytePtr = (unsigned char *)destPtr;
+    const unsigned char *srcBytePtr = (const unsigned char *)srcPtr;
+
+    // if the destination is below the source, or they do not overlap at 
+    // all, memcpy() is fine. It always works from the start forwards and 
+    // LDM reads all 16 bytes before STM writes any of them
+    if((destBytePtr<=srcBytePtr) || (destBytePtr>=(srcBytePtr+byteCount))) return memcpy(destPtr, srcPtr, byteCount);
+
+    // otherwise we have to work backwards from the end
+    destBytePtr += byteCount;
+    srcBytePtr += byteCount;
+
+    if((byteCount>=8) && ((((unsigned int)destBytePtr ^ (unsigned int)srcBytePtr) & 0x03)==0))
+    {
+        while(((unsigned int)destBytePtr & 0x03)!=0)
+        {
+            *--destBytePtr = *--srcBytePtr;
+            byteCount--;
+        }
+
+        // the Cortex-M0 has no LDMDB/STMDB so this is a word at a time
+        unsigned int *destWordPtr = (unsigned int *)destBytePtr;
+        const unsigned int *srcWordPtr = (const unsigned int *)srcBytePtr;
+        unsigned int wordCount = byteCount >> 2;
+        while(wordCount!=0)
+        {
+            *--destWordPtr = *--srcWordPtr;
+            wordCount--;
+        }
+
+        destBytePtr = (unsigned char *)destWordPtr;
+        srcBytePtr = (const unsigned char *)srcWordPtr;
+        byteCount = byteCount & 0x03;
+    }
+
+    while(byteCount!=0)
+    {
+        *--destBytePtr = *--srcBytePtr;
+        byteCount--;
+    }
+    return destPtr;
+}
+
+// #
+// # The ARM EABI versions. The 4 and 8 versions promise the pointers are 
+// # aligned to 4 or 8 bytes but memcpy() works that out for itself anyway.
+// # Note the order of the parameters in __aeabi_memset() is different
+// #
+
+void __aeabi_memcpy(void *destPtr, const void *srcPtr, size_t byteCount) { memcpy(destPtr, srcPtr, byteCount); }
+void __aeabi_memcpy4(void *destPtr, const void *srcPtr, size_t byteCount) { memcpy(destPtr, srcPtr, byteCount); }
+void __aeabi_memcpy8(void *destPtr, const void *srcPtr, size_t byteCount) { memcpy(destPtr, srcPtr, byteCount); }
+void __aeabi_memmove(void *destPtr, const void *srcPtr, size_t byteCount) { memmove(destPtr, srcPtr, byteCount); }
+void __aeabi_memmove4(void *destPtr, const void *srcPtr, size_t byteCount) { memmove(destPtr, srcPtr, byteCount); }
+void __aeabi_memmove8(void *destPtr, const void *srcPtr, size_t byteCount) { memmove(destPtr, srcPtr, byteCount); }
+void __aeabi_memset(void *destPtr, size_t byteCount, int byteValue) { memset(destPtr, byteValue, byteCount); }
+void __aeabi_memset4(void *destPtr, size_t byteCount, int byteValue) { memset(destPtr, byteValue, byteCount); }
+void __aeabi_memset8(void *destPtr, size_t byteCount, int byteValue) { memset(destPtr, byteValue, byteCount); }
+void __aeabi_memclr(void *destPtr, size_t byteCount) { memset(destPtr, 0, byteCount); }
+void __aeabi_memclr4(void *destPtr, size_t byteCount) { memset(destPtr, 0, byteCount); }
+void __aeabi_memclr8(void *destPtr, size_t byteCount) { memset(destPtr, 0, byteCount); }
@@ -0,0 +1,110 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_MSGQUEUE.h"
+
+    /* constructor
+     *
+     * */
+    YakIO_MSGQUEUE::YakIO_MSGQUEUE()
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        queueHead = 0;
+        queueTail = 0;
+    }
+
+    /* Send - puts a message on the end of the queue. If the queue is full 
+     *    waits for a space.
+     *
+     *    NOTE: Only a thread can wait. From an interrupt handler always use
+     *      a timeoutTicks of 0.
+     *
+     * inputs:
+     *    message - the message
+     *    timeoutTicks - the maximum number of ticks (milliseconds) to wait. 
+     *      0 means do not wait at all, KERNEL_WAIT_FOREVER means wait forever
+     *
+     * returns:
+     *    1 if the message was sent, 0 if it was not (the queue stayed full)
+     * */
+    unsigned int YakIO_MSGQUEUE::Send(unsigned int message, unsigned int timeoutTicks)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        // claim a space. Once we have it nobody else can take it
+        if(spacesFree.Take(timeoutTicks)==0) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        messages[queueTail] = message;
+        queueTail++;
+        if(queueTail>=MSGQUEUE_SIZE) queueTail=0;
+        ExitCritical(primaskState);
+
+        // and let a receiver know
+        messagesWaiting.Give();
+        return 1;
+    }
+
+    /* Receive - takes the oldest message off the queue. If the queue is 
+     *    empty waits for a message to arrive.
+     *
+     *    NOTE: Only a thread can wait. From an interrupt handler always use
+     *      a timeoutTicks of 0.
+     *
+     * inputs:
+     *    timeoutTicks - the maximum number of ticks (milliseconds) to wait. 
+     *      0 means do not wait at all, KERNEL_WAIT_FOREVER means wait forever
+     *
+     * outputs:
+     *    messagePtr - receives the message
+     *
+     * returns:
+     *    1 if a message was received, 0 if it was not (the queue stayed empty)
+     * */
+    unsigned int YakIO_MSGQUEUE::Receive(unsigned int *messagePtr, unsigned int timeoutTicks)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(messagePtr==NULL) return 0;
+
+        // claim a message. Once we have it nobody else can take it
+        if(messagesWaiting.Take(timeoutTicks)==0) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        *messagePtr = messages[queueHead];
+        queueHead++;
+        if(queueHead>=MSGQUEUE_SIZE) queueHead=0;
+        ExitCritical(primaskState);
+
+        // and let a sender know there is a space
+        spacesFree.Give();
+        return 1;
+    }
+
+    /* GetMessageCount - gets the number of messages waiting in the queue
+     *
+     * returns:
+     *    the number of messages waiting
+     * */
+    unsigned int YakIO_MSGQUEUE::GetMessageCount(void)
+    {
+        return messagesWaiting.GetCount();
+    }
@@ -0,0 +1,294 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_POOL.h"
+
+// set in the YakIO_POOLSET constructor so new and delete can find it
+YakIO_POOLSET *poolSet_ptr = NULL;
+
+// #
+// # YakIO_BLOCKPOOL
+// #
+
+    /* Init - sets up the pool. All blocks start off free.
+     *
+     *    NOTE: there is no constructor. Init() does the job of one so 
+     *    that the owner can hand over the memory when it is ready.
+     *
+     * inputs:
+     *    storagePtr - the memory, blockBytesIn*numBlocksIn bytes of it, 
+     *        word aligned
+     *    blockBytesIn - the size of each block. At least 4 and a multiple of 4
+     *    numBlocksIn - the number of blocks
+     * */
+    void YakIO_BLOCKPOOL::Init(void *storagePtr, unsigned int blockBytesIn, unsigned int numBlocksIn)
+    {
+        if(storagePtr==NULL) return;
+        if(blockBytesIn<sizeof(void *)) return;
+
+        storageStart = (unsigned char *)storagePtr;
+        storageEnd = storageStart + (blockBytesIn*numBlocksIn);
+        blockBytes = blockBytesIn;
+        numBlocks = numBlocksIn;
+        usedCount = 0;
+        highWaterCount = 0;
+        failedCount = 0;
+
+        // link every block to the next one. The last one points to NULL
+        freeListHead = NULL;
+        for(unsigned int i=numBlocks; i>0; i--)
+        {
+            void **blockPtr = (void **)(storageStart + ((i-1)*blockBytes));
+            *blockPtr = freeListHead;
+            freeListHead = blockPtr;
+        }
+
+        // set this so we know we have run through Init()
+        isInitialized =1;
+    }
+
+    /* Allocate - takes a block off the free list. Safe to call from an 
+     *    interrupt handler.
+     *
+     * returns:
+     *    the block or NULL if there are none left
+     * */
+    void *YakIO_BLOCKPOOL::Allocate(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return NULL;
+
+        unsigned int primaskState = EnterCritical();
+        void **blockPtr = (void **)freeListHead;
+        if(blockPtr==NULL)
+        {
+            failedCount++;
+            ExitCritical(primaskState);
+            return NULL;
+        }
+        freeListHead = *blockPtr;
+        usedCount++;
+        if(usedCount>highWaterCount) highWaterCount = usedCount;
+        ExitCritical(primaskState);
+
+        return blockPtr;
+    }
+
+    /* Free - puts a block back on the front of the free list. Safe to call
+     *    from an interrupt handler.
+     *
+     * inputs:
+     *    blockPtr - the block. NULL is ignored
+     *
+     * returns:
+     *    1 if the block was ours and has been freed, 0 if it was not ours
+     * */
+    unsigned int YakIO_BLOCKPOOL::Free(void *blockPtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(Owns(blockPtr)==0) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        *(void **)blockPtr = freeListHead;
+        freeListHead = blockPtr;
+        usedCount--;
+        ExitCritical(primaskState);
+        return 1;
+    }
+
+    /* Owns - tests if a block came from this pool
+     *
+     * inputs:
+     *    blockPtr - the block
+     *
+     * returns:
+     *    nz if it did, z if it did not
+     * */
+    unsigned int YakIO_BLOCKPOOL::Owns(void *blockPtr)
+    {
+        if(isInitialized==0) return 0;
+        if((unsigned char *)blockPtr<storageStart) return 0;
+        if((unsigned char *)blockPtr>=storageEnd) return 0;
+        return 1;
+    }
+
+    /* GetBlockBytes - the size of each block in bytes
+     * */
+    unsigned int YakIO_BLOCKPOOL::GetBlockBytes(void)
+    {
+        return blockBytes;
+    }
+
+    /* GetNumBlocks - the number of blocks in the pool
+     * */
+    unsigned int YakIO_BLOCKPOOL::GetNumBlocks(void)
+    {
+        return numBlocks;
+    }
+
+    /* GetUsedCount - the number of blocks allocated now
+     * */
+    unsigned int YakIO_BLOCKPOOL::GetUsedCount(void)
+    {
+        return usedCount;
+    }
+
+    /* GetHighWaterCount - the most blocks that have ever been allocated 
+     *    at once
+     * */
+    unsigned int YakIO_BLOCKPOOL::GetHighWaterCount(void)
+    {
+        return highWaterCount;
+    }
+
+    /* GetFailedCount - the number of times Allocate() found the pool empty
+     * */
+    unsigned int YakIO_BLOCKPOOL::GetFailedCount(void)
+    {
+        return failedCount;
+    }
+
+// #
+// # YakIO_POOLSET
+// #
+
+    /* constructor
+     *
+     * */
+    YakIO_POOLSET::YakIO_POOLSET()
+    {
+        sizeClassPools[0].Init(class0Storage, POOL_SIZE_CLASS0_BYTES, POOL_SIZE_CLASS0_BLOCKS);
+        sizeClassPools[1].Init(class1Storage, POOL_SIZE_CLASS1_BYTES, POOL_SIZE_CLASS1_BLOCKS);
+        sizeClassPools[2].Init(class2Storage, POOL_SIZE_CLASS2_BYTES, POOL_SIZE_CLASS2_BLOCKS);
+        sizeClassPools[3].Init(class3Storage, POOL_SIZE_CLASS3_BYTES, POOL_SIZE_CLASS3_BLOCKS);
+
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        // set this so new and delete can find us
+        poolSet_ptr = this;
+    }
+
+    /* Allocate - gets a block from the smallest size class that is big
+     *    enough. If that one is empty the next size up is tried.
+     *
+     * inputs:
+     *    bytesNeeded - the size wanted
+     *
+     * returns:
+     *    the block or NULL if nothing big enough is free
+     * */
+    void *YakIO_POOLSET::Allocate(unsigned int bytesNeeded)
+    {
+        // we must be initialized
+        if(isInitialized==0) return NULL;
+
+        for(unsigned int i=0; i<POOL_NUM_SIZE_CLASSES; i++)
+        {
+            if(sizeClassPools[i].GetBlockBytes()<bytesNeeded) continue;
+            void *blockPtr = sizeClassPools[i].Allocate();
+            if(blockPtr!=NULL) return blockPtr;
+        }
+        return NULL;
+    }
+
+    /* Free - gives a block back to whichever size class it came from
+     *
+     * inputs:
+     *    blockPtr - the block. NULL is ignored
+     *
+     * returns:
+     *    1 if it was freed, 0 if it did not come from us
+     * */
+    unsigned int YakIO_POOLSET::Free(void *blockPtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(blockPtr==NULL) return 0;
+
+        for(unsigned int i=0; i<POOL_NUM_SIZE_CLASSES; i++)
+        {
+            if(sizeClassPools[i].Free(blockPtr)!=0) return 1;
+        }
+        return 0;
+    }
+
+    /* GetSizeClassPool - gets one of the size class pools. Use this to
+     *    look at its statistics
+     *
+     * inputs:
+     *    sizeClass - 0 to POOL_NUM_SIZE_CLASSES-1
+     *
+     * returns:
+     *    the pool or NULL if sizeClass is out of range
+     * */
+    YakIO_BLOCKPOOL *YakIO_POOLSET::GetSizeClassPool(unsigned int sizeClass)
+    {
+        if(sizeClass>=POOL_NUM_SIZE_CLASSES) return NULL;
+        return &sizeClassPools[sizeClass];
+    }
+
+// #
+// # the global new and delete operators. These replace the ones that would
+// # normally come from the C++ library (which YakIO does not link with).
+// # They are not member functions and the names are fixed by the C++ standard.
+// #
+
+/* PoolAllocate - the common code of the new operators. If we cannot satisfy
+ *    the request we spin here forever. The C++ standard does not allow new
+ *    to return NULL and we have no exceptions to throw.
+ * */
+static void *PoolAllocate(unsigned int bytesNeeded)
+{
+    void *blockPtr = NULL;
+    if(poolSet_ptr!=NULL) blockPtr = poolSet_ptr->Allocate(bytesNeeded);
+    // out of memory. Look at the high water marks and make the pools bigger
+    if(blockPtr==NULL) while(1) {}
+    return blockPtr;
+}
+
+void *operator new(std::size_t bytesNeeded)
+{
+    return PoolAllocate(bytesNeeded);
+}
+
+void *operator new[](std::size_t bytesNeeded)
+{
+    return PoolAllocate(bytesNeeded);
+}
+
+void operator delete(void *blockPtr) noexcept
+{
+    if(poolSet_ptr!=NULL) poolSet_ptr->Free(blockPtr);
+}
+
+void operator delete[](void *blockPtr) noexcept
+{
+    if(poolSet_ptr!=NULL) poolSet_ptr->Free(blockPtr);
+}
+
+void operator delete(void *blockPtr, std::size_t blockBytes) noexcept
+{
+    if(poolSet_ptr!=NULL) poolSet_ptr->Free(blockPtr);
+}
+
+void operator delete[](void *blockPtr, std::size_t blockBytes) noexcept
+{
+    if(poolSet_ptr!=NULL) poolSet_ptr->Free(blockPtr);
+}
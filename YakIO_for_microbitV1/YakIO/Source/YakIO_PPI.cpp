@@ -0,0 +1,106 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_PPI.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_PPI - Constructor. Nothing is changed in the hardware, other 
+     *     YakIO_PPI objects may already have channels running
+     * */
+    YakIO_PPI::YakIO_PPI()
+    {
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* ConnectChannel - sets the event and task of a programmable channel. 
+     *     The channel is disabled while this is done and left disabled. 
+     *     Call EnableChannel() to start it
+     *
+     * inputs:
+     *    channelNum - the channel, 0 to PPI_PROGRAMMABLE_CHANNELS-1
+     *    eventAddress - the full address of the event register, for example
+     *       REGISTER_TIMER1+TIMERREG_OFFSET_COMPARE_0
+     *    taskAddress - the full address of the task register, for example
+     *       REGISTER_TIMER2+TIMERREG_OFFSET_CAPTURE_0
+     * returns:
+     *    nz if it worked, z if the channel is not a programmable one
+     * */
+    unsigned int YakIO_PPI::ConnectChannel(unsigned int channelNum, unsigned int eventAddress, unsigned int taskAddress)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(channelNum>=PPI_PROGRAMMABLE_CHANNELS) return 0;
+
+        DisableChannel(channelNum);
+        YAKIO_REGISTER(REGISTER_PPI+PPIREG_OFFSET_CH_EEP_BASE+(channelNum*PPIREG_CH_STRIDE)) = eventAddress;
+        YAKIO_REGISTER(REGISTER_PPI+PPIREG_OFFSET_CH_TEP_BASE+(channelNum*PPIREG_CH_STRIDE)) = taskAddress;
+        return 1;
+    }
+
+    /* EnableChannel - enables a channel. From now on its event starts its
+     *     task
+     *
+     * inputs:
+     *    channelNum - the channel, 0 to PPI_NUM_CHANNELS-1
+     * */
+    void YakIO_PPI::EnableChannel(unsigned int channelNum)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(channelNum>=PPI_NUM_CHANNELS) return;
+
+        YAKIO_REGISTER(REGISTER_PPI+PPIREG_OFFSET_CHENSET) = (0x01u<<channelNum);
+    }
+
+    /* DisableChannel - disables a channel
+     *
+     * inputs:
+     *    channelNum - the channel, 0 to PPI_NUM_CHANNELS-1
+     * */
+    void YakIO_PPI::DisableChannel(unsigned int channelNum)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(channelNum>=PPI_NUM_CHANNELS) return;
+
+        YAKIO_REGISTER(REGISTER_PPI+PPIREG_OFFSET_CHENCLR) = (0x01u<<channelNum);
+    }
+
+    /* IsChannelEnabled - tests if a channel is enabled
+     *
+     * inputs:
+     *    channelNum - the channel, 0 to PPI_NUM_CHANNELS-1
+     * returns:
+     *    nz if it is, z if it is not
+     * */
+    unsigned int YakIO_PPI::IsChannelEnabled(unsigned int channelNum)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(channelNum>=PPI_NUM_CHANNELS) return 0;
+
+        return (YAKIO_REGISTER(REGISTER_PPI+PPIREG_OFFSET_CHEN) >> channelNum) & 0x01;
+    }
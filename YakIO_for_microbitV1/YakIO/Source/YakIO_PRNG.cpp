@@ -0,0 +1,380 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_PRNG.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_PRNG - Constructor. The generator starts with a fixed seed so 
+     *     it makes the same numbers every time until you seed it
+     *
+     * inputs:
+     *    prngTypeIn - the generator to use. See the note on the PRNG in
+     *       YakIO_PRNG.h
+     * */
+    YakIO_PRNG::YakIO_PRNG(enum PRNG_TYPE prngTypeIn)
+    {
+        prngType = prngTypeIn;
+
+        // the seeds the authors of each generator used
+        xorshift32State = PRNG_XORSHIFT32_DEFAULT_STATE;
+        xorshift128State[0] = 123456789;
+        xorshift128State[1] = 362436069;
+        xorshift128State[2] = 521288629;
+        xorshift128State[3] = 88675123;
+        pcg32State = PRNG_PCG32_DEFAULT_STATE;
+        pcg32Increment = PRNG_PCG32_DEFAULT_INCREMENT;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* SetSeed - seeds the generator from a single value. The same seed 
+     *     always gives the same numbers which is handy for tests and 
+     *     simulations you want to repeat
+     *
+     * inputs:
+     *    seedValue - the seed, any value is fine
+     * */
+    void YakIO_PRNG::SetSeed(unsigned int seedValue)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        // spread the one value over all the seed words. Each one is a 
+        // different multiple of the golden ratio run through a hash so 
+        // seeds which differ in one bit give completely different words
+        unsigned int seedWords[PRNG_SEED_WORDS];
+        for(unsigned int i=0; i<PRNG_SEED_WORDS; i++)
+        {
+            unsigned int hashValue = seedValue + ((i+1)*0x9E3779B9);
+            hashValue = hashValue ^ (hashValue>>16);
+            hashValue = hashValue * 0x7FEB352D;
+            hashValue = hashValue ^ (hashValue>>15);
+            hashValue = hashValue * 0x846CA68B;
+            hashValue = hashValue ^ (hashValue>>16);
+            seedWords[i] = hashValue;
+        }
+        LoadSeedWords(seedWords);
+    }
+
+    /* SetSeedWords - seeds the generator with all of its seed words at 
+     *     once. For PRNG_PCG32 the words are the initstate (words 0 and 1) 
+     *     and the initseq (words 2 and 3) of pcg32_srandom_r() in the 
+     *     reference code, low word first, so its published values can be 
+     *     checked. See HostTests/HostTest_PRNG.cpp
+     *
+     * inputs:
+     *    seedWords - PRNG_SEED_WORDS words of seed
+     * */
+    void YakIO_PRNG::SetSeedWords(unsigned int *seedWords)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(seedWords==NULL) return;
+
+        LoadSeedWords(seedWords);
+    }
+
+    /* SeedFromRng - seeds the generator with truly random values from the
+     *     RNG peripheral. If the RNG pool is running the values come from 
+     *     there, otherwise from GetRngValue(). Either way this waits for 
+     *     the RNG so it can take a couple of milliseconds. Do it once at
+     *     the start
+     *
+     * inputs:
+     *    rngObj - the RNG. It must have been started
+     * */
+    void YakIO_PRNG::SeedFromRng(YakIO_RNG &rngObj)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        unsigned int seedWords[PRNG_SEED_WORDS];
+        for(unsigned int i=0; i<PRNG_SEED_WORDS; i++)
+        {
+            unsigned int seedWord = 0;
+            if(rngObj.IsPoolRunning()!=0)
+            {
+                // the pool refills itself, we just wait for it
+                while(rngObj.GetU32(&seedWord)==0) {}
+            }
+            else
+            {
+                for(int j=0; j<32; j=j+8) seedWord = seedWord | (rngObj.GetRngValue()<<j);
+            }
+            seedWords[i] = seedWord;
+        }
+        LoadSeedWords(seedWords);
+    }
+
+    /* SetReseedRng - sets the generator to mix in a fresh value from the 
+     *     RNG pool every so often. See the note on the PRNG in YakIO_PRNG.h
+     *
+     * inputs:
+     *    rngPtrIn - the RNG. PoolStart() must have been called on it. NULL 
+     *       stops the reseeding
+     *    reseedIntervalIn - reseed after this many values. 0 stops the 
+     *       reseeding
+     * */
+    void YakIO_PRNG::SetReseedRng(YakIO_RNG *rngPtrIn, unsigned int reseedIntervalIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(reseedIntervalIn==0) rngPtrIn = NULL;
+        reseedInterval = reseedIntervalIn;
+        valuesUntilReseed = reseedIntervalIn;
+        reseedRngPtr = rngPtrIn;
+    }
+
+    /* GetReseedCount - gets the number of times a fresh value from the RNG
+     *     has been mixed in
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_PRNG::GetReseedCount(void)
+    {
+        return reseedCount;
+    }
+
+    /* GetNext - gets the next pseudo random value
+     *
+     * returns:
+     *    a value, all 32 bits are random
+     * */
+    unsigned int YakIO_PRNG::GetNext(void)
+    {
+        // time to mix in something truly random?
+        if(reseedRngPtr!=NULL)
+        {
+            valuesUntilReseed = valuesUntilReseed - 1;
+            if(valuesUntilReseed==0) Reseed();
+        }
+
+        if(prngType==PRNG_XORSHIFT32) return NextXorshift32();
+        else if(prngType==PRNG_XORSHIFT128) return NextXorshift128();
+        else return NextPCG32();
+    }
+
+    /* GetRange - gets a pseudo random value less than rangeSize with no 
+     *     bias and no divide. See the note on the PRNG in YakIO_PRNG.h
+     *
+     * inputs:
+     *    rangeSize - the number of values wanted. 0 is treated as 2^32
+     * returns:
+     *    a value from 0 to rangeSize-1
+     * */
+    unsigned int YakIO_PRNG::GetRange(unsigned int rangeSize)
+    {
+        if(rangeSize==0) return GetNext();
+
+        // the smallest all ones mask which covers rangeSize-1
+        unsigned int rangeMask = rangeSize-1;
+        rangeMask = rangeMask | (rangeMask>>1);
+        rangeMask = rangeMask | (rangeMask>>2);
+        rangeMask = rangeMask | (rangeMask>>4);
+        rangeMask = rangeMask | (rangeMask>>8);
+        rangeMask = rangeMask | (rangeMask>>16);
+
+        // throw away anything too big. The mask means it is never more 
+        // than twice the size we need so this does not go round much
+        unsigned int rangeValue = GetNext() & rangeMask;
+        while(rangeValue>=rangeSize) rangeValue = GetNext() & rangeMask;
+        return rangeValue;
+    }
+
+    /* GetBetween - gets a pseudo random value between two values, 
+     *     including both of them. No bias and no divide
+     *
+     * inputs:
+     *    lowValue - the smallest value wanted
+     *    highValue - the biggest value wanted. Must be lowValue or more
+     * returns:
+     *    a value from lowValue to highValue
+     * */
+    unsigned int YakIO_PRNG::GetBetween(unsigned int lowValue, unsigned int highValue)
+    {
+        if(highValue<=lowValue) return lowValue;
+        // 0 to 0xFFFFFFFF wraps rangeSize to 0 which GetRange() takes as 2^32
+        return lowValue + GetRange((highValue-lowValue)+1);
+    }
+
+    /* Fill - fills a buffer with pseudo random bytes. A whole 32 bit 
+     *     value is used for every 4 bytes
+     *
+     * inputs:
+     *    outBuffer - the buffer to fill
+     *    byteCount - the number of bytes to put in it
+     * */
+    void YakIO_PRNG::Fill(unsigned char *outBuffer, unsigned int byteCount)
+    {
+        if(outBuffer==NULL) return;
+
+        while(byteCount>=BYTES_IN_REGISTER)
+        {
+            unsigned int randomValue = GetNext();
+            outBuffer[0] = (unsigned char)randomValue;
+            outBuffer[1] = (unsigned char)(randomValue>>8);
+            outBuffer[2] = (unsigned char)(randomValue>>16);
+            outBuffer[3] = (unsigned char)(randomValue>>24);
+            outBuffer = outBuffer + BYTES_IN_REGISTER;
+            byteCount = byteCount - BYTES_IN_REGISTER;
+        }
+        if(byteCount==0) return;
+
+        // the odd bytes at the end
+        unsigned int randomValue = GetNext();
+        for(unsigned int i=0; i<byteCount; i++)
+        {
+            outBuffer[i] = (unsigned char)randomValue;
+            randomValue = randomValue>>8;
+        }
+    }
+
+    /* GetType - gets the generator type
+     *
+     * returns:
+     *    a PRNG_TYPE value
+     * */
+    enum PRNG_TYPE YakIO_PRNG::GetType(void)
+    {
+        return prngType;
+    }
+
+// #
+// # Private
+// #
+
+    /* NextXorshift32 - the next value of the 32 bit xorshift generator.
+     *     Marsaglia, "Xorshift RNGs" 2003, the 13,17,5 triple
+     * */
+    unsigned int YakIO_PRNG::NextXorshift32(void)
+    {
+        unsigned int stateValue = xorshift32State;
+        stateValue = stateValue ^ (stateValue<<13);
+        stateValue = stateValue ^ (stateValue>>17);
+        stateValue = stateValue ^ (stateValue<<5);
+        xorshift32State = stateValue;
+        return stateValue;
+    }
+
+    /* NextXorshift128 - the next value of the 128 bit xorshift generator.
+     *     Marsaglia, "Xorshift RNGs" 2003
+     * */
+    unsigned int YakIO_PRNG::NextXorshift128(void)
+    {
+        unsigned int tValue = xorshift128State[0] ^ (xorshift128State[0]<<11);
+        unsigned int wValue = xorshift128State[3];
+        xorshift128State[0] = xorshift128State[1];
+        xorshift128State[1] = xorshift128State[2];
+        xorshift128State[2] = wValue;
+        wValue = (wValue ^ (wValue>>19)) ^ (tValue ^ (tValue>>8));
+        xorshift128State[3] = wValue;
+        return wValue;
+    }
+
+    /* NextPCG32 - the next value of the PCG32 generator (XSH RR variant). 
+     *     O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically 
+     *     Good Algorithms for Random Number Generation" 2014
+     * */
+    unsigned int YakIO_PRNG::NextPCG32(void)
+    {
+        unsigned long long oldState = pcg32State;
+        pcg32State = (oldState*PRNG_PCG32_MULTIPLIER) + pcg32Increment;
+        unsigned int xorShifted = (unsigned int)(((oldState>>18) ^ oldState)>>27);
+        unsigned int rotateBits = (unsigned int)(oldState>>59);
+        return (xorShifted>>rotateBits) | (xorShifted<<((32-rotateBits) & 31));
+    }
+
+    /* LoadSeedWords - sets the state of the generator from the seed words
+     *
+     * inputs:
+     *    seedWords - PRNG_SEED_WORDS words of seed
+     * */
+    void YakIO_PRNG::LoadSeedWords(unsigned int *seedWords)
+    {
+        // the xorshifts must never have an all zero state, they would 
+        // stay at zero for ever
+        xorshift32State = seedWords[0];
+        if(xorshift32State==0) xorshift32State = PRNG_XORSHIFT32_DEFAULT_STATE;
+        unsigned int anyBits = 0;
+        for(unsigned int i=0; i<PRNG_XORSHIFT128_WORDS; i++)
+        {
+            xorshift128State[i] = seedWords[i];
+            anyBits = anyBits | seedWords[i];
+        }
+        if(anyBits==0) xorshift128State[0] = PRNG_XORSHIFT32_DEFAULT_STATE;
+
+        // the PCG seeding procedure. The increment picks one of 2^63 
+        // different sequences and must be odd
+        pcg32Increment = (((((unsigned long long)seedWords[3])<<32) | seedWords[2])<<1) | 1;
+        pcg32State = 0;
+        NextPCG32();
+        pcg32State = pcg32State + ((((unsigned long long)seedWords[1])<<32) | seedWords[0]);
+        NextPCG32();
+    }
+
+    /* MixIntoState - mixes a new value into the state of the generator
+     *
+     * inputs:
+     *    mixValue - the value to mix in
+     * */
+    void YakIO_PRNG::MixIntoState(unsigned int mixValue)
+    {
+        if(prngType==PRNG_XORSHIFT32)
+        {
+            xorshift32State = xorshift32State ^ mixValue;
+            if(xorshift32State==0) xorshift32State = PRNG_XORSHIFT32_DEFAULT_STATE;
+        }
+        else if(prngType==PRNG_XORSHIFT128)
+        {
+            // a different word each time
+            xorshift128State[reseedCount & (PRNG_XORSHIFT128_WORDS-1)] = xorshift128State[reseedCount & (PRNG_XORSHIFT128_WORDS-1)] ^ mixValue;
+            unsigned int anyBits = xorshift128State[0] | xorshift128State[1] | xorshift128State[2] | xorshift128State[3];
+            if(anyBits==0) xorshift128State[0] = PRNG_XORSHIFT32_DEFAULT_STATE;
+        }
+        else
+        {
+            // any PCG state is fine
+            pcg32State = pcg32State ^ (((unsigned long long)mixValue)<<32);
+        }
+    }
+
+    /* Reseed - mixes a fresh value from the RNG pool into the state. If 
+     *     the pool is empty we try again a little later
+     * */
+    void YakIO_PRNG::Reseed(void)
+    {
+        unsigned int rngValue = 0;
+        if(reseedRngPtr->GetU32(&rngValue)==0)
+        {
+            valuesUntilReseed = PRNG_RESEED_RETRY;
+            return;
+        }
+        MixIntoState(rngValue);
+        reseedCount = reseedCount + 1;
+        valuesUntilReseed = reseedInterval;
+    }
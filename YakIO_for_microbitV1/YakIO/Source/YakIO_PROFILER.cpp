@@ -0,0 +1,278 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_PROFILER.h"
+
+#ifndef YAKIO_HOST
+// these come from the linker script (microbit.ld)
+extern unsigned char __topOfCodeSection__[];
+extern unsigned char __bottomOfCodeSection__[];
+#endif
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_PROFILER - Constructor
+     *
+     * inputs:
+     *    sampleTimerIDIn - the timer to use. Nothing else may use it 
+     * */
+    YakIO_PROFILER::YakIO_PROFILER(enum TIMER sampleTimerIDIn) : sampleTimerObj(sampleTimerIDIn)
+    {
+        sampleTimerID = sampleTimerIDIn;
+
+#ifndef YAKIO_HOST
+        codeStartAddress = (unsigned int)__topOfCodeSection__;
+        codeEndAddress = (unsigned int)__bottomOfCodeSection__;
+#else
+        // there is no linker script on the host (see YAKIO_HOST in YakIO.h)
+        // and no interrupted PC either. Every sample counts as outside
+        codeStartAddress = 0;
+        codeEndAddress = 0;
+#endif
+
+        // the smallest power of two sized bucket that lets PROFILER_NUM_BUCKETS 
+        // of them cover the whole code section
+        unsigned int codeSize = codeEndAddress-codeStartAddress;
+        bucketShift = PROFILER_MIN_BUCKET_SHIFT;
+        while((codeSize>>bucketShift)>=PROFILER_NUM_BUCKETS) bucketShift++;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+
+        Clear();
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts taking samples. Any samples already taken are kept, 
+     *    call Clear() first if you do not want them
+     *
+     * inputs:
+     *    sampleIntervalUs - the time between samples, in microseconds. 0
+     *       means use PROFILER_DEFAULT_INTERVAL_US. See the note on the 
+     *       PROFILER in YakIO_PROFILER.h before you pick one
+     * */
+    void YakIO_PROFILER::Start(unsigned int sampleIntervalUs)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        // it stopped itself, the counts would overflow
+        if(isFull!=0) return;
+
+        if(sampleIntervalUs==0) sampleIntervalUs = PROFILER_DEFAULT_INTERVAL_US;
+
+        // we want to see inside anything we can so the sample timer always 
+        // gets the highest priority. See the PRIORITIES note in YakIO_NVIC.h
+        SetIRQPriority(IRQ_TIMER0+sampleTimerID, IRQ_PRIORITY_Highest);
+
+        isRunning = 1;
+        sampleTimerObj.QuickSetup(PROFILER_TIMER_PRESCALER, sampleIntervalUs, CALLBACK_0, this);
+    }
+
+    /* Stop - stops taking samples. The counts are kept
+     * */
+    void YakIO_PROFILER::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        sampleTimerObj.TimerStop();
+        isRunning = 0;
+    }
+
+    /* Clear - throws away all the samples taken so far. Does not stop
+     *    or start the sampling
+     * */
+    void YakIO_PROFILER::Clear(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        // the sample timer must not add to a bucket while we are zeroing them
+        unsigned int primaskState = EnterCritical();
+        for(unsigned int i=0; i<PROFILER_NUM_BUCKETS; i++) bucketCounts[i]=0;
+        sampleCount = 0;
+        outsideCount = 0;
+        isFull = 0;
+        ExitCritical(primaskState);
+    }
+
+    /* IsRunning - tests if samples are being taken
+     *
+     * returns:
+     *    nz if they are, z if they are not
+     * */
+    unsigned int YakIO_PROFILER::IsRunning(void)
+    {
+        return isRunning;
+    }
+
+    /* IsFull - tests if the profiler stopped itself because a bucket 
+     *    was about to overflow
+     *
+     * returns:
+     *    nz if it did, z if it did not
+     * */
+    unsigned int YakIO_PROFILER::IsFull(void)
+    {
+        return isFull;
+    }
+
+    /* GetSampleCount - gets the number of samples taken, including the 
+     *    ones outside the code section
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_PROFILER::GetSampleCount(void)
+    {
+        return sampleCount;
+    }
+
+    /* GetOutsideCount - gets the number of samples which were not in the
+     *    code section. There should not be any unless you run code from RAM
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_PROFILER::GetOutsideCount(void)
+    {
+        return outsideCount;
+    }
+
+    /* GetCodeStartAddress - gets the address of the start of bucket 0
+     *
+     * returns:
+     *    the address
+     * */
+    unsigned int YakIO_PROFILER::GetCodeStartAddress(void)
+    {
+        return codeStartAddress;
+    }
+
+    /* GetBucketShift - gets the size of each bucket as a power of two.
+     *    Bucket n starts at GetCodeStartAddress()+(n<<GetBucketShift())
+     *
+     * returns:
+     *    the shift
+     * */
+    unsigned int YakIO_PROFILER::GetBucketShift(void)
+    {
+        return bucketShift;
+    }
+
+    /* GetBucketCount - gets the number of samples in a bucket
+     *
+     * inputs:
+     *    bucketIndex - the bucket, must be less than PROFILER_NUM_BUCKETS
+     * returns:
+     *    the count or 0 if bucketIndex is out of range
+     * */
+    unsigned int YakIO_PROFILER::GetBucketCount(unsigned int bucketIndex)
+    {
+        if(bucketIndex>=PROFILER_NUM_BUCKETS) return 0;
+        return bucketCounts[bucketIndex];
+    }
+
+    /* Dump - prints the samples on the serial port in a form the 
+     *    ProfileReport.py script understands. Only the buckets with 
+     *    something in them are printed. The format is
+     *
+     *       PROFILE_BEGIN
+     *       PROFILE_CODE <start address> <end address>
+     *       PROFILE_BUCKET_SHIFT <shift>
+     *       PROFILE_SAMPLES <total samples>
+     *       PROFILE_OUTSIDE <samples outside the code section>
+     *       PROFILE_HIT <bucket start address> <count>
+     *       ... one PROFILE_HIT per non empty bucket
+     *       PROFILE_END
+     *
+     *    This takes a while at 115200 baud. Stop() first if you do not 
+     *    want the time it takes to show up in the next dump.
+     *
+     * inputs:
+     *    uart - a started YakIO_UART to print on
+     * */
+    void YakIO_PROFILER::Dump(YakIO_UART &uart)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        uart.WriteString("PROFILE_BEGIN");
+        uart.WriteNewLine();
+        uart.WriteString("PROFILE_CODE ");
+        uart.WriteHex(codeStartAddress);
+        uart.WriteByte(' ');
+        uart.WriteHex(codeEndAddress);
+        uart.WriteNewLine();
+        uart.WriteString("PROFILE_BUCKET_SHIFT ");
+        uart.WriteUnsigned(bucketShift);
+        uart.WriteNewLine();
+        uart.WriteString("PROFILE_SAMPLES ");
+        uart.WriteUnsigned(sampleCount);
+        uart.WriteNewLine();
+        uart.WriteString("PROFILE_OUTSIDE ");
+        uart.WriteUnsigned(outsideCount);
+        uart.WriteNewLine();
+        for(unsigned int i=0; i<PROFILER_NUM_BUCKETS; i++)
+        {
+            unsigned int bucketCount = bucketCounts[i];
+            if(bucketCount==0) continue;
+            uart.WriteString("PROFILE_HIT ");
+            uart.WriteHex(codeStartAddress+(i<<bucketShift));
+            uart.WriteByte(' ');
+            uart.WriteUnsigned(bucketCount);
+            uart.WriteNewLine();
+        }
+        uart.WriteString("PROFILE_END");
+        uart.WriteNewLine();
+    }
+
+    /* Callback0 - the sample timer tick. Called from the timer interrupt
+     *    every sampleIntervalUs. Counts the interrupted PC in its bucket
+     * */
+    void YakIO_PROFILER::Callback0(void)
+    {
+        unsigned int interruptedPC = sampleTimerObj.GetInterruptedPC();
+        sampleCount = sampleCount + 1;
+
+        // the unsigned subtract makes anything below the start a huge 
+        // number so one compare does both ends
+        unsigned int codeOffset = interruptedPC-codeStartAddress;
+        if(codeOffset>=(codeEndAddress-codeStartAddress))
+        {
+            outsideCount = outsideCount + 1;
+            return;
+        }
+
+        unsigned int bucketIndex = codeOffset>>bucketShift;
+        unsigned int bucketCount = bucketCounts[bucketIndex] + 1;
+        bucketCounts[bucketIndex] = bucketCount;
+
+        // one more and it would wrap to zero. Stop while the counts are 
+        // still right
+        if(bucketCount>=PROFILER_MAX_BUCKET_COUNT)
+        {
+            isFull = 1;
+            Stop();
+        }
+    }
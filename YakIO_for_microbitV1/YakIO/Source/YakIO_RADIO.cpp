@@ -0,0 +1,655 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_RADIO.h"
+#include "YakIO_TRACE.h"
+
+// the IRQ_RADIO_handler is a non-member function. It has no idea of
+// what class it should work on. The pointer below is set in the
+// constructor of the RADIO Object. See the same thing in YakIO_RNG.cpp
+YakIO_RADIO *radio_ptr = NULL;
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_RADIO - Constructor. The RADIO is not powered up until Start() 
+     *     is called
+     * */
+    YakIO_RADIO::YakIO_RADIO()
+    {
+        for(int i=0; i<RADIO_RX_BUFFERS; i++)
+        {
+            rxBufferIsFull[i] = 0;
+            rxRssi[i] = 0;
+            rxTimestamp[i] = 0;
+        }
+
+        // remember our 'this' pointer
+        radio_ptr = this;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* SetCallback - sets the callback object and function within that object.
+     *     It is called from the interrupt when a good packet has arrived and
+     *     when a Transmit() has finished. The callback object must inherit 
+     *     from YakIO_CALLBACK
+     *
+     * inputs:
+     *    callbackIDIn - the callback id to use. Essentially this identifies the function name within the
+     *       callback interface object
+     *    callbackInterfacePtrIn - the "this" pointer of the object to receive
+     *       the callback
+     * */
+    void YakIO_RADIO::SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        callbackInterfacePtr = callbackInterfacePtrIn;
+        callbackID = callbackIDIn;
+    }
+
+    /* CallCallback - calls the callback function set on this object
+     * */
+    void YakIO_RADIO::CallCallback()
+    {
+        if(isInitialized==0) return;
+        // we have to have this
+        if(callbackInterfacePtr==NULL) return;
+
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
+        // figure out what callback function to call and call it
+        if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
+        else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
+    }
+
+    /* ClearAllCallbacks - clear all callbacks
+     * */
+    void YakIO_RADIO::ClearAllCallbacks(void)
+    {
+        callbackInterfacePtr=NULL;
+        callbackID=CALLBACK_NONE;
+    }
+
+    /* Start - powers up the RADIO and sets it up with the defaults. See the
+     *     note on the RADIO in YakIO_RADIO.h. It is left idle
+     * */
+    void YakIO_RADIO::Start(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        Stop();
+
+        // turning the power off and on again puts every register back to 
+        // its reset value
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_POWER) = 0;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_POWER) = RADIO_POWER_ON;
+
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_MODE) = RADIO_MODE_1MBIT;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_FREQUENCY) = RADIO_DEFAULT_FREQUENCY;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_TXPOWER) = RADIO_TXPOWER_0DBM;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_PCNF0) = RADIO_PCNF0_LFLEN_8BITS;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_PCNF1) = RADIO_MAX_PAYLOAD_BYTES | 
+                                                               (RADIO_BASE_ADDRESS_BYTES<<RADIO_PCNF1_BALEN_SHIFT) |
+                                                               RADIO_PCNF1_ENDIAN_BIG | RADIO_PCNF1_WHITEEN;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DATAWHITEIV) = RADIO_DEFAULT_WHITE_IV;
+        // we only ever send on, and listen to, logical address 0
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_TXADDRESS) = 0;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_RXADDRESSES) = 0x01;
+
+        radioState = RADIO_STATE_IDLE;
+        SetAddress(RADIO_DEFAULT_BASE_ADDRESS, RADIO_DEFAULT_PREFIX);
+        SetCrc(RADIO_CRC_16BIT, RADIO_DEFAULT_CRC_POLY, RADIO_DEFAULT_CRC_INIT);
+
+        // anything not yet released from before is thrown away
+        for(int i=0; i<RADIO_RX_BUFFERS; i++) rxBufferIsFull[i] = 0;
+        rxReceiveIndex = 0;
+        rxReadIndex = 0;
+        rxPacketCount = 0;
+        txPacketCount = 0;
+        crcErrorCount = 0;
+        droppedPacketCount = 0;
+        EnableIRQ(IRQ_RADIO);
+    }
+
+    /* Stop - switches the RADIO off. Anything being sent or received is 
+     *     lost
+     * */
+    void YakIO_RADIO::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        isListening = 0;
+        if(radioState!=RADIO_STATE_STOPPED) DisableAndWait();
+        radioState = RADIO_STATE_STOPPED;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_POWER) = 0;
+    }
+
+    /* SetMode - sets the data rate. The RADIO must be idle
+     *
+     * inputs:
+     *    radioMode - 1Mbit or 2Mbit. Both ends must use the same one
+     * returns:
+     *    nz if it was set, z if the RADIO is not idle
+     * */
+    unsigned int YakIO_RADIO::SetMode(enum RADIO_MODE radioMode)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(radioState!=RADIO_STATE_IDLE) return 0;
+
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_MODE) = radioMode;
+        return 1;
+    }
+
+    /* SetFrequency - sets the channel. The RADIO must be idle
+     *
+     * inputs:
+     *    radioFrequency - the frequency is 2400MHz plus this many MHz. 0 to 
+     *       RADIO_MAX_FREQUENCY. At 2Mbit leave at least 2MHz between channels
+     * returns:
+     *    nz if it was set, z if it is out of range or the RADIO is not idle
+     * */
+    unsigned int YakIO_RADIO::SetFrequency(unsigned int radioFrequency)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(radioState!=RADIO_STATE_IDLE) return 0;
+        if(radioFrequency>RADIO_MAX_FREQUENCY) return 0;
+
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_FREQUENCY) = radioFrequency;
+        return 1;
+    }
+
+    /* SetTxPower - sets the transmit power. The RADIO must be idle
+     *
+     * inputs:
+     *    txPower - the power
+     * returns:
+     *    nz if it was set, z if the RADIO is not idle
+     * */
+    unsigned int YakIO_RADIO::SetTxPower(enum RADIO_TXPOWER txPower)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(radioState!=RADIO_STATE_IDLE) return 0;
+
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_TXPOWER) = txPower;
+        return 1;
+    }
+
+    /* SetAddress - sets the 5 byte address packets are sent to and 
+     *     listened for. The RADIO must be idle
+     *
+     * inputs:
+     *    baseAddress - the 4 byte base address
+     *    prefixByte - the fifth byte. The micro:bit runtime uses this as
+     *       the radio "group"
+     * returns:
+     *    nz if it was set, z if the RADIO is not idle
+     * */
+    unsigned int YakIO_RADIO::SetAddress(unsigned int baseAddress, unsigned int prefixByte)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(radioState!=RADIO_STATE_IDLE) return 0;
+
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_BASE0) = baseAddress;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_PREFIX0) = prefixByte & 0xFF;
+        return 1;
+    }
+
+    /* SetCrc - sets the CRC. The address is included in it. The RADIO must
+     *     be idle
+     *
+     * inputs:
+     *    crcLength - the CRC length, or RADIO_CRC_OFF. With it off every
+     *       packet counts as good
+     *    crcPoly - the polynomial, the top bit is implied by the length
+     *    crcInit - the starting value
+     * returns:
+     *    nz if it was set, z if the RADIO is not idle
+     * */
+    unsigned int YakIO_RADIO::SetCrc(enum RADIO_CRC crcLength, unsigned int crcPoly, unsigned int crcInit)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(radioState!=RADIO_STATE_IDLE) return 0;
+
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_CRCCNF) = crcLength;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_CRCPOLY) = crcPoly;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_CRCINIT) = crcInit;
+        return 1;
+    }
+
+    /* StartReceive - starts listening. It carries on, packet after packet,
+     *     until StopReceive() or Stop() is called. Packets received before
+     *     and not yet released are kept
+     *
+     * returns:
+     *    nz if it started, z if the RADIO is not idle
+     * */
+    unsigned int YakIO_RADIO::StartReceive(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(radioState!=RADIO_STATE_IDLE) return 0;
+
+        isListening = 1;
+        StartRx();
+        return 1;
+    }
+
+    /* StopReceive - stops listening. A packet half received is lost. Any
+     *     packets already received can still be read. If a Transmit() is
+     *     going on it finishes, but the listening will not start again
+     * */
+    void YakIO_RADIO::StopReceive(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        isListening = 0;
+        if(radioState!=RADIO_STATE_RX) return;
+        DisableAndWait();
+        radioState = RADIO_STATE_IDLE;
+    }
+
+    /* SetExternalStart - sets whether Transmit() and StartReceive() start 
+     *     the RADIO themselves or leave it for the PPI. See the note on the 
+     *     RADIO in YakIO_RADIO.h. Only change it while the RADIO is idle
+     *
+     * inputs:
+     *    externalStartIn - nz to leave the TXEN or RXEN task to the PPI, z 
+     *       to start it straight away
+     * */
+    void YakIO_RADIO::SetExternalStart(unsigned int externalStartIn)
+    {
+        externalStart = externalStartIn;
+    }
+
+    /* Cancel - stops whatever the RADIO is doing, or is waiting for the 
+     *     PPI to start, and leaves it idle. A packet on the air is lost
+     * */
+    void YakIO_RADIO::Cancel(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        isListening = 0;
+        if(radioState==RADIO_STATE_STOPPED) return;
+        DisableAndWait();
+        radioState = RADIO_STATE_IDLE;
+    }
+
+    /* Transmit - sends a packet. It does not wait. IsTransmitting() says
+     *     when it has gone and the callback is called then as well. See the
+     *     note on the RADIO in YakIO_RADIO.h for what happens if it is 
+     *     listening
+     *
+     * inputs:
+     *    payloadBytes - the payload. It is copied, the buffer can be used
+     *       again straight away
+     *    payloadLength - the number of bytes, 0 to RADIO_MAX_PAYLOAD_BYTES
+     * returns:
+     *    nz if it was started, z if the RADIO is stopped or already 
+     *    sending or the payload is too long
+     * */
+    unsigned int YakIO_RADIO::Transmit(const unsigned char *payloadBytes, unsigned int payloadLength)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((radioState==RADIO_STATE_STOPPED) || (radioState==RADIO_STATE_TX)) return 0;
+        if(payloadLength>RADIO_MAX_PAYLOAD_BYTES) return 0;
+        if((payloadBytes==NULL) && (payloadLength!=0)) return 0;
+
+        // stop listening, the RADIO can only do one thing at a time
+        if(radioState==RADIO_STATE_RX) DisableAndWait();
+
+        txPacket.lengthByte = payloadLength;
+        for(unsigned int i=0; i<payloadLength; i++) txPacket.payloadBytes[i] = payloadBytes[i];
+
+        // ramp up, send and switch off all by itself. We only hear about 
+        // it at the end
+        ClearEvents();
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_PACKETPTR) = YAKIO_RAM_ADDRESS(&txPacket);
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_SHORTS) = RADIO_SHORT_READY_START | RADIO_SHORT_END_DISABLE;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_INTENSET) = RADIO_INTEN_DISABLED_BIT;
+        radioState = RADIO_STATE_TX;
+        if(externalStart==0) YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_TXEN) = 1;
+        return 1;
+    }
+
+    /* IsTransmitting - tests if a Transmit() is still going on
+     *
+     * returns:
+     *    nz if it is, z if not
+     * */
+    unsigned int YakIO_RADIO::IsTransmitting(void)
+    {
+        return (radioState==RADIO_STATE_TX);
+    }
+
+    /* GetState - gets what the driver is doing
+     *
+     * returns:
+     *    the state
+     * */
+    enum RADIO_STATE YakIO_RADIO::GetState(void)
+    {
+        return radioState;
+    }
+
+    /* GetReceivedPacket - gets the oldest packet received and not yet 
+     *     released. It stays where the RADIO put it, nothing is copied. 
+     *     The same packet is returned until ReleasePacket() is called
+     *
+     * returns:
+     *    a pointer to the packet or NULL if there is none
+     * */
+    struct YakIO_RADIOPACKET *YakIO_RADIO::GetReceivedPacket(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return NULL;
+
+        if(rxBufferIsFull[rxReadIndex]==0) return NULL;
+        return &rxPackets[rxReadIndex];
+    }
+
+    /* GetPacketRssi - gets the signal strength of the packet 
+     *     GetReceivedPacket() returns
+     *
+     * returns:
+     *    the strength as a positive number - 60 means -60dBm. Zero if 
+     *    there is no packet
+     * */
+    unsigned int YakIO_RADIO::GetPacketRssi(void)
+    {
+        if(rxBufferIsFull[rxReadIndex]==0) return 0;
+        return rxRssi[rxReadIndex];
+    }
+
+    /* ReleasePacket - hands the packet GetReceivedPacket() returned back to
+     *     the RADIO. Do not use the pointer after this
+     * */
+    void YakIO_RADIO::ReleasePacket(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        // the interrupt looks at both of these
+        unsigned int primaskState = EnterCritical();
+        if(rxBufferIsFull[rxReadIndex]!=0)
+        {
+            rxBufferIsFull[rxReadIndex] = 0;
+            // the other one, if it is full, arrived after this one
+            rxReadIndex = (rxReadIndex + 1) % RADIO_RX_BUFFERS;
+            if(rxBufferIsFull[rxReadIndex]==0) rxReadIndex = (rxReadIndex + 1) % RADIO_RX_BUFFERS;
+        }
+        ExitCritical(primaskState);
+    }
+
+    /* SetTimestampRegister - sets the register the RADIO ADDRESS event has 
+     *     been wired to capture a TIMER count into. See the note on the 
+     *     RADIO in YakIO_RADIO.h
+     *
+     * inputs:
+     *    registerAddress - the full address of the TIMER CC[n] register, 
+     *       or zero for no timestamps
+     * */
+    void YakIO_RADIO::SetTimestampRegister(unsigned int registerAddress)
+    {
+        timestampRegister = registerAddress;
+    }
+
+    /* GetPacketTimestamp - gets the timestamp of the packet 
+     *     GetReceivedPacket() returns. This is when its address arrived
+     *
+     * returns:
+     *    the TIMER count, zero if there is no packet or no timestamp 
+     *    register has been set
+     * */
+    unsigned int YakIO_RADIO::GetPacketTimestamp(void)
+    {
+        if(rxBufferIsFull[rxReadIndex]==0) return 0;
+        return rxTimestamp[rxReadIndex];
+    }
+
+    /* GetTxTimestamp - gets the timestamp of the last packet sent. This is
+     *     when its address went out
+     *
+     * returns:
+     *    the TIMER count, zero if no timestamp register has been set
+     * */
+    unsigned int YakIO_RADIO::GetTxTimestamp(void)
+    {
+        return txTimestamp;
+    }
+
+    /* GetRxPacketCount - gets the number of good packets received since 
+     *     Start(). Dropped ones are not included
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RADIO::GetRxPacketCount(void)
+    {
+        return rxPacketCount;
+    }
+
+    /* GetTxPacketCount - gets the number of packets sent since Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RADIO::GetTxPacketCount(void)
+    {
+        return txPacketCount;
+    }
+
+    /* GetCrcErrorCount - gets the number of packets thrown away since 
+     *     Start() because their CRC was wrong
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RADIO::GetCrcErrorCount(void)
+    {
+        return crcErrorCount;
+    }
+
+    /* GetDroppedPacketCount - gets the number of good packets thrown away 
+     *     since Start() because both receive buffers were full
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RADIO::GetDroppedPacketCount(void)
+    {
+        return droppedPacketCount;
+    }
+
+    /* HandleRadioIRQ - does the work for the IRQ_RADIO_handler. You should 
+     *     never need to call this yourself.
+     * */
+    void YakIO_RADIO::HandleRadioIRQ(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_END)!=0)
+        {
+            YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_END) = 0;
+            if(radioState==RADIO_STATE_RX) HandleRxEnd();
+        }
+        if(YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DISABLED)!=0)
+        {
+            YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DISABLED) = 0;
+            if(radioState==RADIO_STATE_TX)
+            {
+                // the packet has gone. Take the timestamp before the 
+                // listening starts and overwrites it
+                if(timestampRegister!=0) txTimestamp = YAKIO_REGISTER(timestampRegister);
+                txPacketCount = txPacketCount + 1;
+                radioState = RADIO_STATE_IDLE;
+                YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_INTENCLR) = RADIO_INTEN_ALL_BITS;
+                if(isListening!=0) StartRx();
+                CallCallback();
+            }
+            else if(radioState==RADIO_STATE_RX)
+            {
+                // the PPI has switched the listening off
+                isListening = 0;
+                radioState = RADIO_STATE_IDLE;
+                YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_INTENCLR) = RADIO_INTEN_ALL_BITS;
+            }
+        }
+    }
+
+// #
+// # Private
+// #
+
+    /* ClearEvents - clears all of the events we use
+     * */
+    void YakIO_RADIO::ClearEvents(void)
+    {
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_READY) = 0;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_ADDRESS) = 0;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_END) = 0;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DISABLED) = 0;
+    }
+
+    /* StartRx - ramps up the RADIO to listen into the next free buffer
+     * */
+    void YakIO_RADIO::StartRx(void)
+    {
+        rxReceiveIndex = GetFreeRxBuffer();
+        ClearEvents();
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_PACKETPTR) = YAKIO_RAM_ADDRESS(&rxPackets[rxReceiveIndex]);
+        // no END_START, the interrupt does that after it has moved PACKETPTR
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_SHORTS) = RADIO_SHORT_READY_START | RADIO_SHORT_ADDRESS_RSSISTART;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_INTENCLR) = RADIO_INTEN_ALL_BITS;
+        // DISABLED only happens if the PPI switches us off, DisableAndWait() 
+        // turns the interrupts off first
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_INTENSET) = RADIO_INTEN_END_BIT | RADIO_INTEN_DISABLED_BIT;
+        radioState = RADIO_STATE_RX;
+        if(externalStart==0) YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_RXEN) = 1;
+    }
+
+    /* DisableAndWait - disables the RADIO, whatever it is doing, and waits
+     *     until it is. Takes a few microseconds at most
+     * */
+    void YakIO_RADIO::DisableAndWait(void)
+    {
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_INTENCLR) = RADIO_INTEN_ALL_BITS;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_SHORTS) = 0;
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DISABLED) = 0;
+        if(YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_STATE)!=RADIO_HWSTATE_DISABLED)
+        {
+            YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DISABLE) = 1;
+            while(YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_DISABLED)==0);
+        }
+        ClearEvents();
+    }
+
+    /* GetFreeRxBuffer - finds a receive buffer nobody is using
+     *
+     * returns:
+     *    its index or RADIO_RX_DISCARD if both are full
+     * */
+    unsigned int YakIO_RADIO::GetFreeRxBuffer(void)
+    {
+        for(unsigned int i=0; i<RADIO_RX_BUFFERS; i++)
+        {
+            if(rxBufferIsFull[i]==0) return i;
+        }
+        return RADIO_RX_DISCARD;
+    }
+
+    /* HandleRxEnd - a packet has arrived. Starts listening for the next one
+     *     in a free buffer and then sorts out the one that came
+     * */
+    void YakIO_RADIO::HandleRxEnd(void)
+    {
+        unsigned int doneIndex = rxReceiveIndex;
+        unsigned int crcIsGood = YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_CRCSTATUS);
+        unsigned int packetTimestamp = 0;
+        if(timestampRegister!=0) packetTimestamp = YAKIO_REGISTER(timestampRegister);
+        if((crcIsGood!=0) && (doneIndex!=RADIO_RX_DISCARD))
+        {
+            // the RADIO stops writing at MAXLEN but the LENGTH byte is what
+            // was sent. Do not let it send anybody off the end of the buffer
+            if(rxPackets[doneIndex].lengthByte>RADIO_MAX_PAYLOAD_BYTES) rxPackets[doneIndex].lengthByte = RADIO_MAX_PAYLOAD_BYTES;
+            rxBufferIsFull[doneIndex] = 1;
+        }
+
+        // get going again as quickly as possible. The RADIO is still ramped 
+        // up, sitting in RXIDLE
+        rxReceiveIndex = GetFreeRxBuffer();
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_PACKETPTR) = YAKIO_RAM_ADDRESS(&rxPackets[rxReceiveIndex]);
+        YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_START) = 1;
+
+        if(crcIsGood==0)
+        {
+            crcErrorCount = crcErrorCount + 1;
+            return;
+        }
+        if(doneIndex==RADIO_RX_DISCARD)
+        {
+            droppedPacketCount = droppedPacketCount + 1;
+            return;
+        }
+        rxRssi[doneIndex] = YAKIO_REGISTER(REGISTER_RADIO+RADIOREG_OFFSET_RSSISAMPLE);
+        rxTimestamp[doneIndex] = packetTimestamp;
+        rxPacketCount = rxPacketCount + 1;
+        // it is the next to read unless the other one is still waiting
+        if(rxBufferIsFull[(doneIndex + 1) % RADIO_RX_BUFFERS]==0) rxReadIndex = doneIndex;
+        CallCallback();
+    }
+
+    /* IRQ_RADIO_handler
+     *
+     * Note: the address of this function is set in the flash by the linker.
+     *       See the discussion on the IRQ_RNG_handler in YakIO_RNG.cpp
+     *
+     *   Do NOT define this anywhere else. This class needs it here
+     * */
+    void IRQ_RADIO_handler(void)
+    {
+        if(radio_ptr==NULL) return;
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_IRQ_ENTRY, IRQ_RADIO);
+        radio_ptr->HandleRadioIRQ();
+        YAKIO_TRACE_EVENT(TRACE_IRQ_EXIT, IRQ_RADIO);
+    }
@@ -16,6 +16,7 @@
 
 #include "YakIO.h"
 #include "YakIO_RNG.h"
+#include "YakIO_TRACE.h"
 
 // the IRQ_RNG_handler is a non-member function. It has no idea of
 // what class it should work on. The pointer below is set in the
@@ -54,7 +55,7 @@ YakIO_RNG *rng_ptr = NULL;
         unsigned int bitVal = RNG_SHORT_VALRDY_STOP_BIT; // we only have one meaningful bit
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_SHORTS)) = (~bitVal);
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_SHORTS) = (~bitVal);
     }
 
     /* SetINTEN - sets the RNG_INTEN_BIT in the INTENSET register
@@ -67,7 +68,7 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_ITENSET)) |= RNG_INTEN_BIT;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_ITENSET) = YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_ITENSET) | RNG_INTEN_BIT;
     }
 
     /* ClearINTEN - Clears the RNG_INTEN_BIT in the INTENCLR register
@@ -80,7 +81,7 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return;
 
         // we use a CLR register so we can just set these bits directly
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_ITENCLR)) |= RNG_INTEN_BIT;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_ITENCLR) = YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_ITENCLR) | RNG_INTEN_BIT;
     }
 
     /* SetCallback - sets the callback object and function within that object.
@@ -121,14 +122,19 @@ YakIO_RNG *rng_ptr = NULL;
         // we have to have this
         if(callbackInterfacePtr==NULL) return;
 
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
         // figure out what callback function to call and call it
         if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
         else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
-        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback1();
-        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
         // we never permit callbacks to the heartbeat in here. That is a special
         // case TIMER thing
         //else if(callbackID == HEARTBEAT) callbackInterfacePtr->Heartbeat();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
     }
 
     /* ClearAllCallbacks - clear all callbacks
@@ -182,7 +188,7 @@ YakIO_RNG *rng_ptr = NULL;
         ClearValueReady();
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_START)) = 1;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_START) = 1;
     }
 
     /* RngStop - stops the random number generator peripheral.
@@ -198,7 +204,7 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_STOP)) = 1;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_STOP) = 1;
     }
 
     /* RngShutdown - shuts down the random nunber generator peripheral]
@@ -226,7 +232,7 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_CONFIG)) = derCenValue;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_CONFIG) = derCenValue;
     }
 
     /* GetDerCen - sets the digital error correction value
@@ -240,7 +246,7 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return RNG_DERCEN_DIS;
 
         // get the value from the appropriate register
-        unsigned int derCenValue = (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_CONFIG));
+        unsigned int derCenValue = YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_CONFIG);
         if(derCenValue==RNG_DERCEN_ENA) return RNG_DERCEN_ENA;
         else return RNG_DERCEN_DIS;
     }
@@ -266,13 +272,13 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return 0;
 
         // spin until a value is ready
-        while ( (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_VALRDY)) == 0) {}
+        while ( YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_VALRDY) == 0) {}
 
         // get the value from the appropriate register
-        unsigned int rngValue = (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_VALUE));
+        unsigned int rngValue = YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_VALUE);
 
         // clear this now or we will get duplicates if the user calls it fast enough
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_VALRDY)) = 0x00;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_VALRDY) = 0x00;
 
         return rngValue;
     }
@@ -287,9 +293,437 @@ YakIO_RNG *rng_ptr = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (REGISTER_RNG+RNGREG_OFFSET_VALRDY)) = 0x00;
+        YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_VALRDY) = 0x00;
      }
 
+    /* HandleRngIRQ - does the work for the IRQ_RNG_handler. Fills the pool
+     *     if it is running, otherwise calls the callback. You should never
+     *     need to call this yourself.
+     * */
+    void YakIO_RNG::HandleRngIRQ(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(poolIsRunning!=0) FillPool();
+        else CallCallback();
+    }
+
+    /* PoolStart - starts filling the pool. See the note on the RNG POOL in
+     *     YakIO_RNG.h. Anything already in the pool is thrown away
+     * */
+    void YakIO_RNG::PoolStart(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        unsigned int primaskState = EnterCritical();
+        poolWriteCount = 0;
+        poolReadCount = 0;
+        ResetHealthAndConditioning();
+        poolIsRunning = 1;
+        poolIsFilling = 1;
+        ExitCritical(primaskState);
+
+        // an interrupt for every value
+        SetINTEN();
+        EnableRngIRQ();
+        RngStart();
+    }
+
+    /* PoolStop - stops filling the pool and stops the RNG. Anything still 
+     *     in the pool is thrown away. If a callback was set with 
+     *     SetCallback() it is called again from now on once the RNG is 
+     *     started with RngStart()
+     * */
+    void YakIO_RNG::PoolStop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        RngStop();
+        unsigned int primaskState = EnterCritical();
+        poolIsRunning = 0;
+        poolIsFilling = 0;
+        poolReadCount = poolWriteCount;
+        ExitCritical(primaskState);
+
+        // leave the interrupt alone if the callback needs it
+        if(callbackInterfacePtr==NULL) ClearINTEN();
+    }
+
+    /* IsPoolRunning - tests if the pool has been started with PoolStart()
+     *
+     * returns:
+     *    nz if it has, z if it has not
+     * */
+    unsigned int YakIO_RNG::IsPoolRunning(void)
+    {
+        return poolIsRunning;
+    }
+
+    /* GetPoolCount - gets the number of random bytes waiting in the pool
+     *
+     * returns:
+     *    the count, 0 if the pool is not running
+     * */
+    unsigned int YakIO_RNG::GetPoolCount(void)
+    {
+        return poolWriteCount-poolReadCount;
+    }
+
+    /* TryGetBytes - takes random bytes out of the pool. This never waits, 
+     *     if there are not enough bytes it takes none and returns at once.
+     *
+     *   NOTE: The interrupts are disabled while the bytes are copied so 
+     *     this can be called from anywhere - including other interrupt 
+     *     handlers. Take the bytes you need in small pieces.
+     *
+     * inputs:
+     *    outBuffer - the buffer to put them in
+     *    byteCount - the number of bytes wanted. More than RNG_POOL_BYTES 
+     *       can never succeed
+     * returns:
+     *    nz if the buffer was filled, z if there were not enough bytes
+     * */
+    unsigned int YakIO_RNG::TryGetBytes(unsigned char *outBuffer, unsigned int byteCount)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(poolIsRunning==0) return 0;
+        if(outBuffer==NULL) return 0;
+
+        unsigned int gotBytes = 0;
+        unsigned int primaskState = EnterCritical();
+        if((poolWriteCount-poolReadCount)>=byteCount)
+        {
+            unsigned int readIndex = poolReadCount;
+            for(unsigned int i=0; i<byteCount; i++)
+            {
+                outBuffer[i] = poolBytes[(readIndex+i) & RNG_POOL_MASK];
+            }
+            poolReadCount = readIndex + byteCount;
+            gotBytes = 1;
+        }
+        RefillPoolIfNeeded(byteCount);
+        ExitCritical(primaskState);
+
+        return gotBytes;
+    }
+
+    /* GetU32 - takes a 32 bit random value out of the pool. This never 
+     *     waits. See TryGetBytes()
+     *
+     * inputs:
+     *    randomValuePtr - where to put the value. Untouched if there is 
+     *       not one
+     * returns:
+     *    nz if there was a value, z if there were not enough bytes
+     * */
+    unsigned int YakIO_RNG::GetU32(unsigned int *randomValuePtr)
+    {
+        if(randomValuePtr==NULL) return 0;
+
+        unsigned char randomBytes[BYTES_IN_REGISTER];
+        if(TryGetBytes(randomBytes, BYTES_IN_REGISTER)==0) return 0;
+        *randomValuePtr = randomBytes[0] | (randomBytes[1]<<8) | (randomBytes[2]<<16) | ((unsigned int)randomBytes[3]<<24);
+        return 1;
+    }
+
+    /* SetConditioning - sets the software conditioning applied to the 
+     *     values before they go in the pool. See the note on CONDITIONING
+     *     in YakIO_RNG.h. Call this before PoolStart()
+     *
+     * inputs:
+     *    conditioningIn - a RNG_CONDITIONING value
+     * */
+    void YakIO_RNG::SetConditioning(enum RNG_CONDITIONING conditioningIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        conditioning = conditioningIn;
+    }
+
+    /* GetConditioning - gets the software conditioning type
+     *
+     * returns:
+     *    a RNG_CONDITIONING value
+     * */
+    enum RNG_CONDITIONING YakIO_RNG::GetConditioning(void)
+    {
+        return conditioning;
+    }
+
+    /* GetRawSampleCount - gets the number of values the RNG has given the
+     *     pool since PoolStart(). Every one of them went through the 
+     *     health tests
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RNG::GetRawSampleCount(void)
+    {
+        return rawSampleCount;
+    }
+
+    /* GetPoolOutputCount - gets the number of bytes put in the pool since 
+     *     PoolStart(), after conditioning
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RNG::GetPoolOutputCount(void)
+    {
+        return poolOutputCount;
+    }
+
+    /* HasHealthFailed - tests if a health test has failed since 
+     *     PoolStart() or ClearHealthFailures(). If it has nothing is 
+     *     going in the pool
+     *
+     * returns:
+     *    nz if one has, z if not
+     * */
+    unsigned int YakIO_RNG::HasHealthFailed(void)
+    {
+        return healthFailed;
+    }
+
+    /* GetHealthFailureCount - gets the number of health test failures of
+     *     both kinds
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RNG::GetHealthFailureCount(void)
+    {
+        return repetitionFailureCount + proportionFailureCount;
+    }
+
+    /* GetRepetitionFailureCount - gets the number of Repetition Count Test
+     *     failures
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RNG::GetRepetitionFailureCount(void)
+    {
+        return repetitionFailureCount;
+    }
+
+    /* GetProportionFailureCount - gets the number of Adaptive Proportion 
+     *     Test failures
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_RNG::GetProportionFailureCount(void)
+    {
+        return proportionFailureCount;
+    }
+
+    /* ClearHealthFailures - clears the health test failure latch and the
+     *     counts. Values go in the pool again from now on and the RNG is 
+     *     started again if the pool needs them
+     * */
+    void YakIO_RNG::ClearHealthFailures(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        unsigned int primaskState = EnterCritical();
+        healthFailed = 0;
+        repetitionFailureCount = 0;
+        proportionFailureCount = 0;
+        rctRepeatCount = 0;
+        aptSampleCount = 0;
+        // the failure stopped the RNG
+        if(poolIsRunning!=0) RefillPoolIfNeeded(0);
+        ExitCritical(primaskState);
+    }
+
+    /* FillPool - puts the new random value into the pool. Called from the
+     *     interrupt. Stops the RNG when the pool is full to save power
+     * */
+    void YakIO_RNG::FillPool(void)
+    {
+        // take the value and clear the event so the interrupt goes away
+        unsigned int rngValue = YAKIO_REGISTER(REGISTER_RNG+RNGREG_OFFSET_VALUE);
+        ClearValueReady();
+        rawSampleCount = rawSampleCount + 1;
+
+        // nothing goes in the pool once a health test has failed so there 
+        // is no point running the RNG either. See the note on the HEALTH 
+        // TESTS in YakIO_RNG.h
+        if(RunHealthTests(rngValue)==0)
+        {
+            RngStop();
+            poolIsFilling = 0;
+            return;
+        }
+        unsigned int poolValue = 0;
+        if(ConditionValue(rngValue, &poolValue)==0) return;
+
+        // the value that was made as we stopped can arrive after we are full
+        if((poolWriteCount-poolReadCount)<RNG_POOL_BYTES)
+        {
+            poolBytes[poolWriteCount & RNG_POOL_MASK] = (unsigned char)poolValue;
+            poolWriteCount = poolWriteCount + 1;
+            poolOutputCount = poolOutputCount + 1;
+        }
+        if((poolWriteCount-poolReadCount)>=RNG_POOL_BYTES)
+        {
+            RngStop();
+            poolIsFilling = 0;
+        }
+    }
+
+    /* ResetHealthAndConditioning - starts the health tests and the 
+     *     conditioning again from scratch, failures and counts included
+     * */
+    void YakIO_RNG::ResetHealthAndConditioning(void)
+    {
+        rawSampleCount = 0;
+        poolOutputCount = 0;
+        healthFailed = 0;
+        repetitionFailureCount = 0;
+        proportionFailureCount = 0;
+        rctRepeatCount = 0;
+        aptSampleCount = 0;
+        conditionBits = 0;
+        conditionCount = 0;
+        conditionHash = 0;
+    }
+
+    /* RunHealthTests - runs the Repetition Count and Adaptive Proportion 
+     *     tests on a raw value. See the note on the HEALTH TESTS in 
+     *     YakIO_RNG.h. Called from the interrupt
+     *
+     * inputs:
+     *    rngValue - the raw value
+     * returns:
+     *    nz if the value can be used, z if a test has failed
+     * */
+    unsigned int YakIO_RNG::RunHealthTests(unsigned int rngValue)
+    {
+        // the Repetition Count Test. The same value too many times in a row
+        if((rctRepeatCount!=0) && (rngValue==rctLastValue))
+        {
+            rctRepeatCount = rctRepeatCount + 1;
+            if(rctRepeatCount>=RNG_HEALTH_RCT_CUTOFF)
+            {
+                repetitionFailureCount = repetitionFailureCount + 1;
+                healthFailed = 1;
+                // start counting again so one stuck run is one failure
+                rctRepeatCount = 0;
+            }
+        }
+        else
+        {
+            rctLastValue = rngValue;
+            rctRepeatCount = 1;
+        }
+
+        // the Adaptive Proportion Test. The first value of the window 
+        // seen too often in the rest of it
+        if(aptSampleCount==0)
+        {
+            aptFirstValue = rngValue;
+            aptMatchCount = 1;
+            aptSampleCount = 1;
+        }
+        else
+        {
+            if(rngValue==aptFirstValue) aptMatchCount = aptMatchCount + 1;
+            aptSampleCount = aptSampleCount + 1;
+            if(aptMatchCount>=RNG_HEALTH_APT_CUTOFF)
+            {
+                proportionFailureCount = proportionFailureCount + 1;
+                healthFailed = 1;
+                aptSampleCount = 0;
+            }
+            else if(aptSampleCount>=RNG_HEALTH_APT_WINDOW) aptSampleCount = 0;
+        }
+
+        return (healthFailed==0);
+    }
+
+    /* ConditionValue - runs a raw value through the software conditioning.
+     *     See the note on CONDITIONING in YakIO_RNG.h. Called from the 
+     *     interrupt
+     *
+     * inputs:
+     *    rngValue - the raw value
+     *    outValuePtr - where to put the byte for the pool, if there is one
+     * returns:
+     *    nz if there is a byte for the pool, z if more raw values are needed
+     * */
+    unsigned int YakIO_RNG::ConditionValue(unsigned int rngValue, unsigned int *outValuePtr)
+    {
+        if(conditioning==RNG_CONDITIONING_VONNEUMANN)
+        {
+            // four pairs of bits in each value, each gives one bit or none
+            for(int i=0; i<RNG_BITS_IN_BYTE; i=i+2)
+            {
+                unsigned int bitPair = (rngValue>>i) & 0x03;
+                if((bitPair==0x00) || (bitPair==0x03)) continue;
+                conditionBits = (conditionBits<<1) | (bitPair & 0x01);
+                conditionCount = conditionCount + 1;
+            }
+            if(conditionCount<RNG_BITS_IN_BYTE) return 0;
+            // there can be up to three bits over, they wait for next time
+            conditionCount = conditionCount - RNG_BITS_IN_BYTE;
+            *outValuePtr = (conditionBits>>conditionCount) & 0xFF;
+            conditionBits = conditionBits & ((0x01<<conditionCount)-1);
+            return 1;
+        }
+        else if(conditioning==RNG_CONDITIONING_HASH)
+        {
+            // fold the value in. The multiply spreads every input bit over
+            // the upper bits of the hash and the Cortex-M0 does it in one cycle
+            conditionHash = ((conditionHash<<5) | (conditionHash>>27)) ^ rngValue;
+            conditionHash = conditionHash * 0x9E3779B1;
+            conditionCount = conditionCount + 1;
+            if(conditionCount<RNG_HASH_INPUT_BYTES) return 0;
+            conditionCount = 0;
+            // the murmur3 finalizer, then the top byte which depends on all the bits
+            unsigned int hashValue = conditionHash;
+            hashValue = hashValue ^ (hashValue>>16);
+            hashValue = hashValue * 0x85EBCA6B;
+            hashValue = hashValue ^ (hashValue>>13);
+            hashValue = hashValue * 0xC2B2AE35;
+            hashValue = hashValue ^ (hashValue>>16);
+            *outValuePtr = hashValue>>24;
+            return 1;
+        }
+
+        // no conditioning
+        *outValuePtr = rngValue;
+        return 1;
+    }
+
+    /* RefillPoolIfNeeded - starts the RNG again if the pool has got low or
+     *     if someone wanted more than it has. Call with the interrupts 
+     *     disabled or the interrupt could stop the RNG under us
+     *
+     * inputs:
+     *    bytesWanted - the number of bytes the reader asked for
+     * */
+    void YakIO_RNG::RefillPoolIfNeeded(unsigned int bytesWanted)
+    {
+        if(poolIsFilling!=0) return;
+        // a failed health test keeps it stopped, see ClearHealthFailures()
+        if(healthFailed!=0) return;
+        unsigned int poolCount = poolWriteCount-poolReadCount;
+        if((poolCount>RNG_POOL_REFILL_LEVEL) && (poolCount>=bytesWanted)) return;
+        // it is already full, there is no room for more
+        if(poolCount>=RNG_POOL_BYTES) return;
+
+        poolIsFilling = 1;
+        RngStart();
+    }
+
     /* IRQ_RNG_handler
      *
      * Note: the address of this function is set in the flash by the linker.
@@ -305,6 +739,9 @@ YakIO_RNG *rng_ptr = NULL;
     void IRQ_RNG_handler(void)
     {
         if(rng_ptr==NULL) return;
-        // we have a pointer, call the callback
-        rng_ptr->CallCallback();
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_IRQ_ENTRY, IRQ_RNG);
+        // we have a pointer, fill the pool or call the callback
+        rng_ptr->HandleRngIRQ();
+        YAKIO_TRACE_EVENT(TRACE_IRQ_EXIT, IRQ_RNG);
     }
@@ -0,0 +1,112 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_SEMAPHORE.h"
+
+    /* constructor
+     *
+     * inputs:
+     *    initialCount - the count the semaphore starts with
+     *    maxCountIn - the count will never go above this. Use 1 for a 
+     *        semaphore which just signals "something happened"
+     * */
+    YakIO_SEMAPHORE::YakIO_SEMAPHORE(unsigned int initialCount, unsigned int maxCountIn)
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        maxCount = maxCountIn;
+        if(initialCount>maxCount) initialCount=maxCount;
+        semaphoreCount = initialCount;
+        waitList = 0;
+    }
+
+    /* Take - subtracts one from the count. If the count is zero, waits for
+     *    somebody to call Give().
+     *
+     *    NOTE: Only a thread can wait. From an interrupt handler, or if the 
+     *      kernel has not been started, always use a timeoutTicks of 0.
+     *
+     * inputs:
+     *    timeoutTicks - the maximum number of ticks (milliseconds) to wait. 
+     *      0 means do not wait at all, KERNEL_WAIT_FOREVER means wait forever
+     *
+     * returns:
+     *    1 if the semaphore was taken, 0 if it was not (timed out)
+     * */
+    unsigned int YakIO_SEMAPHORE::Take(unsigned int timeoutTicks)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        if(semaphoreCount>0)
+        {
+            // easy, just take it
+            semaphoreCount = semaphoreCount - 1;
+            ExitCritical(primaskState);
+            return 1;
+        }
+        // can we wait?
+        if((timeoutTicks==0) || (kernel_ptr==NULL) || (kernel_ptr->IsRunning()==0))
+        {
+            ExitCritical(primaskState);
+            return 0;
+        }
+
+        // wait. When a Give() wakes us it hands the count straight over to
+        // us rather than adding it to semaphoreCount, so there is nothing
+        // to subtract here
+        enum THREAD_WAKE_REASON wakeReason = kernel_ptr->BlockCurrentThread(&waitList, timeoutTicks);
+        ExitCritical(primaskState);
+
+        if(wakeReason==THREAD_WAKE_SIGNALLED) return 1;
+        else return 0;
+    }
+
+    /* Give - adds one to the count, or, if any thread is waiting, wakes the
+     *    highest priority one instead. Never waits. Can be called from 
+     *    interrupt handlers.
+     * */
+    void YakIO_SEMAPHORE::Give(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        unsigned int primaskState = EnterCritical();
+        if((waitList!=0) && (kernel_ptr!=NULL))
+        {
+            // somebody is waiting, give it directly to them
+            kernel_ptr->WakeHighestWaiter(&waitList);
+        }
+        else if(semaphoreCount<maxCount)
+        {
+            semaphoreCount = semaphoreCount + 1;
+        }
+        ExitCritical(primaskState);
+    }
+
+    /* GetCount - gets the current count
+     *
+     * returns:
+     *    the current count
+     * */
+    unsigned int YakIO_SEMAPHORE::GetCount(void)
+    {
+        return semaphoreCount;
+    }
@@ -0,0 +1,325 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_SHA256.h"
+
+// the round constants. The first 32 bits of the fractional parts of the 
+// cube roots of the first 64 primes. See FIPS 180-4 section 4.2.2
+static const unsigned int sha256RoundConstants[SHA256_ROUNDS] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// the starting hash value. The square roots of the first 8 primes
+static const unsigned int sha256InitialState[SHA256_STATE_WORDS] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// the functions of FIPS 180-4 section 4.1.2. The big sigmas are nested so 
+// only one value is live at a time, see the note in YakIO_SHA256.h
+#define SHA256_ROTR(x,n)       (((x)>>(n)) | ((x)<<(32-(n))))
+#define SHA256_BIGSIGMA0(x)    SHA256_ROTR((x) ^ SHA256_ROTR((x) ^ SHA256_ROTR((x),9),11),2)
+#define SHA256_BIGSIGMA1(x)    SHA256_ROTR((x) ^ SHA256_ROTR((x) ^ SHA256_ROTR((x),14),5),6)
+#define SHA256_SMALLSIGMA0(x)  (SHA256_ROTR((x),7) ^ SHA256_ROTR((x),18) ^ ((x)>>3))
+#define SHA256_SMALLSIGMA1(x)  (SHA256_ROTR((x),17) ^ SHA256_ROTR((x),19) ^ ((x)>>10))
+#define SHA256_CH(x,y,z)       ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA256_MAJ(x,y,z)      (((x) & (y)) | ((z) & ((x) | (y))))
+
+// one round. Only d and h change, the callers rotate the names instead 
+// of moving the values
+#define SHA256_ROUND(a,b,c,d,e,f,g,h,roundConstant,scheduleWord) \
+    { \
+        unsigned int temp1 = h + SHA256_BIGSIGMA1(e) + SHA256_CH(e,f,g) + (roundConstant) + (scheduleWord); \
+        d = d + temp1; \
+        h = temp1 + SHA256_BIGSIGMA0(a) + SHA256_MAJ(a,b,c); \
+    }
+
+// the next schedule word W[t] made in place of W[t-16]. The index n is 
+// t&15 and the others are t-2, t-7 and t-15, all modulo 16
+#define SHA256_NEXT_WORD(n) \
+    (scheduleWords[(n)] = scheduleWords[(n)] + SHA256_SMALLSIGMA1(scheduleWords[((n)+14)&15]) + \
+                          scheduleWords[((n)+9)&15] + SHA256_SMALLSIGMA0(scheduleWords[((n)+1)&15]))
+#define SHA256_FIRST_WORD(n)   scheduleWords[(n)]
+
+#if SHA256_UNROLL_SCHEDULE!=0
+// 16 rounds with every schedule index a constant. wordMacro is 
+// SHA256_FIRST_WORD for rounds 0 to 15 and SHA256_NEXT_WORD after that
+#define SHA256_16_ROUNDS(constantsPtr,wordMacro) \
+    { \
+        SHA256_ROUND(a,b,c,d,e,f,g,h,(constantsPtr)[0],wordMacro(0)); \
+        SHA256_ROUND(h,a,b,c,d,e,f,g,(constantsPtr)[1],wordMacro(1)); \
+        SHA256_ROUND(g,h,a,b,c,d,e,f,(constantsPtr)[2],wordMacro(2)); \
+        SHA256_ROUND(f,g,h,a,b,c,d,e,(constantsPtr)[3],wordMacro(3)); \
+        SHA256_ROUND(e,f,g,h,a,b,c,d,(constantsPtr)[4],wordMacro(4)); \
+        SHA256_ROUND(d,e,f,g,h,a,b,c,(constantsPtr)[5],wordMacro(5)); \
+        SHA256_ROUND(c,d,e,f,g,h,a,b,(constantsPtr)[6],wordMacro(6)); \
+        SHA256_ROUND(b,c,d,e,f,g,h,a,(constantsPtr)[7],wordMacro(7)); \
+        SHA256_ROUND(a,b,c,d,e,f,g,h,(constantsPtr)[8],wordMacro(8)); \
+        SHA256_ROUND(h,a,b,c,d,e,f,g,(constantsPtr)[9],wordMacro(9)); \
+        SHA256_ROUND(g,h,a,b,c,d,e,f,(constantsPtr)[10],wordMacro(10)); \
+        SHA256_ROUND(f,g,h,a,b,c,d,e,(constantsPtr)[11],wordMacro(11)); \
+        SHA256_ROUND(e,f,g,h,a,b,c,d,(constantsPtr)[12],wordMacro(12)); \
+        SHA256_ROUND(d,e,f,g,h,a,b,c,(constantsPtr)[13],wordMacro(13)); \
+        SHA256_ROUND(c,d,e,f,g,h,a,b,(constantsPtr)[14],wordMacro(14)); \
+        SHA256_ROUND(b,c,d,e,f,g,h,a,(constantsPtr)[15],wordMacro(15)); \
+    }
+#endif
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_SHA256 - Constructor. Ready for Update() straight away
+     * */
+    YakIO_SHA256::YakIO_SHA256()
+    {
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+
+        Start();
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts a new hash. Anything given to Update() since the last 
+     *     Finish() is forgotten
+     * */
+    void YakIO_SHA256::Start(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        for(int i=0; i<SHA256_STATE_WORDS; i++) stateWords[i] = sha256InitialState[i];
+        for(int i=0; i<SHA256_BLOCK_BYTES; i++) blockBytes[i] = 0;
+        blockFill = 0;
+        byteCountLow = 0;
+        byteCountHigh = 0;
+    }
+
+    /* Update - adds some bytes to the hash. Can be called any number of 
+     *     times with any number of bytes
+     *
+     * inputs:
+     *    dataBytes - the bytes, RAM or flash. No alignment is needed
+     *    byteCount - the number of bytes
+     * */
+    void YakIO_SHA256::Update(const unsigned char *dataBytes, unsigned int byteCount)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((dataBytes==NULL) || (byteCount==0)) return;
+
+        // the length is a 64 bit count at the end
+        byteCountLow = byteCountLow + byteCount;
+        if(byteCountLow<byteCount) byteCountHigh = byteCountHigh + 1;
+
+        // top up a part block left over from last time
+        if(blockFill>0)
+        {
+            while((blockFill<SHA256_BLOCK_BYTES) && (byteCount>0))
+            {
+                blockBytes[blockFill] = *dataBytes;
+                blockFill = blockFill + 1;
+                dataBytes = dataBytes + 1;
+                byteCount = byteCount - 1;
+            }
+            if(blockFill<SHA256_BLOCK_BYTES) return;
+            ProcessBlock(blockBytes);
+            blockFill = 0;
+        }
+
+        // whole blocks are hashed where they are
+        while(byteCount>=SHA256_BLOCK_BYTES)
+        {
+            ProcessBlock(dataBytes);
+            dataBytes = dataBytes + SHA256_BLOCK_BYTES;
+            byteCount = byteCount - SHA256_BLOCK_BYTES;
+        }
+
+        // and keep the rest for next time
+        for(unsigned int i=0; i<byteCount; i++) blockBytes[i] = dataBytes[i];
+        blockFill = byteCount;
+    }
+
+    /* Finish - pads the data, works out the hash and starts again ready 
+     *     for the next one
+     *
+     * inputs:
+     *    hashBytes - where to put the SHA256_HASH_BYTES byte hash
+     * */
+    void YakIO_SHA256::Finish(unsigned char *hashBytes)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(hashBytes==NULL) return;
+
+        // the length is in bits
+        unsigned int bitCountHigh = (byteCountHigh<<3) | (byteCountLow>>29);
+        unsigned int bitCountLow = byteCountLow<<3;
+
+        // a one bit, then zeros up to the length. If the length does not 
+        // fit in this block it goes in another one
+        blockBytes[blockFill] = 0x80;
+        blockFill = blockFill + 1;
+        if(blockFill>(SHA256_BLOCK_BYTES-SHA256_LENGTH_BYTES))
+        {
+            while(blockFill<SHA256_BLOCK_BYTES)
+            {
+                blockBytes[blockFill] = 0;
+                blockFill = blockFill + 1;
+            }
+            ProcessBlock(blockBytes);
+            blockFill = 0;
+        }
+        while(blockFill<(SHA256_BLOCK_BYTES-SHA256_LENGTH_BYTES))
+        {
+            blockBytes[blockFill] = 0;
+            blockFill = blockFill + 1;
+        }
+        for(int i=0; i<4; i++)
+        {
+            blockBytes[SHA256_BLOCK_BYTES-8+i] = (bitCountHigh>>(24-(8*i))) & 0xFF;
+            blockBytes[SHA256_BLOCK_BYTES-4+i] = (bitCountLow>>(24-(8*i))) & 0xFF;
+        }
+        ProcessBlock(blockBytes);
+
+        // the hash is the state, big endian
+        for(int i=0; i<SHA256_STATE_WORDS; i++)
+        {
+            hashBytes[(4*i)+0] = (stateWords[i]>>24) & 0xFF;
+            hashBytes[(4*i)+1] = (stateWords[i]>>16) & 0xFF;
+            hashBytes[(4*i)+2] = (stateWords[i]>>8) & 0xFF;
+            hashBytes[(4*i)+3] = stateWords[i] & 0xFF;
+        }
+
+        // this also wipes what was there
+        Start();
+    }
+
+    /* Hash - hashes a buffer in one go. Start(), Update() and Finish()
+     *
+     * inputs:
+     *    dataBytes - the bytes
+     *    byteCount - the number of bytes
+     *    hashBytes - where to put the SHA256_HASH_BYTES byte hash
+     * */
+    void YakIO_SHA256::Hash(const unsigned char *dataBytes, unsigned int byteCount, unsigned char *hashBytes)
+    {
+        Start();
+        Update(dataBytes, byteCount);
+        Finish(hashBytes);
+    }
+
+    /* GetByteCount - gets the number of bytes given to Update() since the
+     *     hash was started (modulo 2^32)
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_SHA256::GetByteCount(void)
+    {
+        return byteCountLow;
+    }
+
+// #
+// # Private
+// #
+
+    /* ProcessBlock - the compression function. Hashes one 64 byte block 
+     *     into the state. See the note in YakIO_SHA256.h for how it is laid
+     *     out
+     *
+     * inputs:
+     *    blockPtr - the block. Any alignment
+     * */
+    void YakIO_SHA256::ProcessBlock(const unsigned char *blockPtr)
+    {
+        // the message is big endian and might not be word aligned
+        unsigned int scheduleWords[SHA256_SCHEDULE_WORDS];
+        for(int i=0; i<SHA256_SCHEDULE_WORDS; i++)
+        {
+            scheduleWords[i] = (blockPtr[0]<<24) | (blockPtr[1]<<16) | (blockPtr[2]<<8) | blockPtr[3];
+            blockPtr = blockPtr + 4;
+        }
+
+        unsigned int a = stateWords[0];
+        unsigned int b = stateWords[1];
+        unsigned int c = stateWords[2];
+        unsigned int d = stateWords[3];
+        unsigned int e = stateWords[4];
+        unsigned int f = stateWords[5];
+        unsigned int g = stateWords[6];
+        unsigned int h = stateWords[7];
+
+#if SHA256_UNROLL_SCHEDULE!=0
+        // the first 16 rounds use the message as it is, the other 48 make 
+        // the schedule as they go
+        SHA256_16_ROUNDS(&sha256RoundConstants[0], SHA256_FIRST_WORD);
+        for(int roundNum=16; roundNum<SHA256_ROUNDS; roundNum=roundNum+16)
+        {
+            SHA256_16_ROUNDS(&sha256RoundConstants[roundNum], SHA256_NEXT_WORD);
+        }
+#else
+        // 8 rounds each time round so the names come back to where they 
+        // started. The schedule word is made as it is needed
+        for(int roundNum=0; roundNum<SHA256_ROUNDS; roundNum=roundNum+8)
+        {
+            const unsigned int *constantsPtr = &sha256RoundConstants[roundNum];
+            unsigned int wordNum = roundNum & 15;
+            if(roundNum<SHA256_SCHEDULE_WORDS)
+            {
+                SHA256_ROUND(a,b,c,d,e,f,g,h,constantsPtr[0],SHA256_FIRST_WORD(wordNum+0));
+                SHA256_ROUND(h,a,b,c,d,e,f,g,constantsPtr[1],SHA256_FIRST_WORD(wordNum+1));
+                SHA256_ROUND(g,h,a,b,c,d,e,f,constantsPtr[2],SHA256_FIRST_WORD(wordNum+2));
+                SHA256_ROUND(f,g,h,a,b,c,d,e,constantsPtr[3],SHA256_FIRST_WORD(wordNum+3));
+                SHA256_ROUND(e,f,g,h,a,b,c,d,constantsPtr[4],SHA256_FIRST_WORD(wordNum+4));
+                SHA256_ROUND(d,e,f,g,h,a,b,c,constantsPtr[5],SHA256_FIRST_WORD(wordNum+5));
+                SHA256_ROUND(c,d,e,f,g,h,a,b,constantsPtr[6],SHA256_FIRST_WORD(wordNum+6));
+                SHA256_ROUND(b,c,d,e,f,g,h,a,constantsPtr[7],SHA256_FIRST_WORD(wordNum+7));
+            }
+            else
+            {
+                SHA256_ROUND(a,b,c,d,e,f,g,h,constantsPtr[0],SHA256_NEXT_WORD(wordNum+0));
+                SHA256_ROUND(h,a,b,c,d,e,f,g,constantsPtr[1],SHA256_NEXT_WORD(wordNum+1));
+                SHA256_ROUND(g,h,a,b,c,d,e,f,constantsPtr[2],SHA256_NEXT_WORD(wordNum+2));
+                SHA256_ROUND(f,g,h,a,b,c,d,e,constantsPtr[3],SHA256_NEXT_WORD(wordNum+3));
+                SHA256_ROUND(e,f,g,h,a,b,c,d,constantsPtr[4],SHA256_NEXT_WORD(wordNum+4));
+                SHA256_ROUND(d,e,f,g,h,a,b,c,constantsPtr[5],SHA256_NEXT_WORD(wordNum+5));
+                SHA256_ROUND(c,d,e,f,g,h,a,b,constantsPtr[6],SHA256_NEXT_WORD(wordNum+6));
+                SHA256_ROUND(b,c,d,e,f,g,h,a,constantsPtr[7],SHA256_NEXT_WORD(wordNum+7));
+            }
+        }
+#endif
+
+        stateWords[0] = stateWords[0] + a;
+        stateWords[1] = stateWords[1] + b;
+        stateWords[2] = stateWords[2] + c;
+        stateWords[3] = stateWords[3] + d;
+        stateWords[4] = stateWords[4] + e;
+        stateWords[5] = stateWords[5] + f;
+        stateWords[6] = stateWords[6] + g;
+        stateWords[7] = stateWords[7] + h;
+    }
@@ -0,0 +1,148 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_SOFTAES.h"
+
+// the AES S-box. FIPS-197 figure 7. Const so it stays in the flash
+static const unsigned char softAesSBox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+// multiply by x (that is, 2) in GF(2^8). FIPS-197 section 4.2.1
+#define SOFTAES_XTIME(byteValue) ((unsigned char)(((byteValue)<<1) ^ ((((byteValue)>>7) & 0x01)*0x1b)))
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_SOFTAES - Constructor. The key is all zeros until SetKey() is
+     *     called
+     * */
+    YakIO_SOFTAES::YakIO_SOFTAES()
+    {
+        for(int i=0; i<SOFTAES_ROUND_KEY_BYTES; i++) roundKeys[i] = 0;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* SetKey - sets the key and works out the round keys from it. FIPS-197
+     *     section 5.2
+     *
+     * inputs:
+     *    keyBytes - the SOFTAES_KEY_BYTES byte key
+     * */
+    void YakIO_SOFTAES::SetKey(const unsigned char *keyBytes)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(keyBytes==NULL) return;
+
+        for(int i=0; i<SOFTAES_KEY_BYTES; i++) roundKeys[i] = keyBytes[i];
+
+        // each new word is the word before it xored with the word four back. 
+        // Every fourth word the word before is rotated, put through the 
+        // S-box and xored with the round constant first
+        unsigned char roundConstant = 0x01;
+        for(int i=SOFTAES_KEY_BYTES; i<SOFTAES_ROUND_KEY_BYTES; i=i+4)
+        {
+            unsigned char tempWord[4];
+            for(int j=0; j<4; j++) tempWord[j] = roundKeys[i-4+j];
+            if((i % SOFTAES_KEY_BYTES)==0)
+            {
+                unsigned char firstByte = tempWord[0];
+                tempWord[0] = softAesSBox[tempWord[1]] ^ roundConstant;
+                tempWord[1] = softAesSBox[tempWord[2]];
+                tempWord[2] = softAesSBox[tempWord[3]];
+                tempWord[3] = softAesSBox[firstByte];
+                roundConstant = SOFTAES_XTIME(roundConstant);
+            }
+            for(int j=0; j<4; j++) roundKeys[i+j] = roundKeys[i-SOFTAES_KEY_BYTES+j] ^ tempWord[j];
+        }
+    }
+
+    /* EncryptBlock - encrypts one block. FIPS-197 section 5.1. The input 
+     *     and output can be the same buffer
+     *
+     * inputs:
+     *    clearBlock - the SOFTAES_BLOCK_BYTES bytes to encrypt
+     *    cipherBlock - where to put the SOFTAES_BLOCK_BYTES encrypted bytes
+     * */
+    void YakIO_SOFTAES::EncryptBlock(const unsigned char *clearBlock, unsigned char *cipherBlock)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((clearBlock==NULL) || (cipherBlock==NULL)) return;
+
+        // the state is kept in column order, just like the input
+        unsigned char aesState[SOFTAES_BLOCK_BYTES];
+        for(int i=0; i<SOFTAES_BLOCK_BYTES; i++) aesState[i] = clearBlock[i] ^ roundKeys[i];
+
+        for(int round=1; round<=SOFTAES_ROUNDS; round++)
+        {
+            // SubBytes and ShiftRows together. Row r moves r columns left
+            unsigned char shiftedState[SOFTAES_BLOCK_BYTES];
+            for(int column=0; column<4; column++)
+            {
+                for(int row=0; row<4; row++)
+                {
+                    shiftedState[(column*4)+row] = softAesSBox[aesState[(((column+row) & 0x03)*4)+row]];
+                }
+            }
+
+            // MixColumns, but not in the last round
+            if(round<SOFTAES_ROUNDS)
+            {
+                for(int column=0; column<4; column++)
+                {
+                    unsigned char *columnPtr = &shiftedState[column*4];
+                    unsigned char allXor = columnPtr[0] ^ columnPtr[1] ^ columnPtr[2] ^ columnPtr[3];
+                    unsigned char firstByte = columnPtr[0];
+                    columnPtr[0] = columnPtr[0] ^ allXor ^ SOFTAES_XTIME(columnPtr[0] ^ columnPtr[1]);
+                    columnPtr[1] = columnPtr[1] ^ allXor ^ SOFTAES_XTIME(columnPtr[1] ^ columnPtr[2]);
+                    columnPtr[2] = columnPtr[2] ^ allXor ^ SOFTAES_XTIME(columnPtr[2] ^ columnPtr[3]);
+                    columnPtr[3] = columnPtr[3] ^ allXor ^ SOFTAES_XTIME(columnPtr[3] ^ firstByte);
+                }
+            }
+
+            // AddRoundKey
+            const unsigned char *roundKeyPtr = &roundKeys[round*SOFTAES_BLOCK_BYTES];
+            for(int i=0; i<SOFTAES_BLOCK_BYTES; i++) aesState[i] = shiftedState[i] ^ roundKeyPtr[i];
+        }
+
+        for(int i=0; i<SOFTAES_BLOCK_BYTES; i++) cipherBlock[i] = aesState[i];
+    }
@@ -0,0 +1,118 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_STACKGUARD.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_STACKGUARD - Constructor
+     *
+     * inputs:
+     *    checkTimerIDIn - the timer to use. It is set up for a 1 millisecond
+     *       tick when Start() is called
+     * */
+    YakIO_STACKGUARD::YakIO_STACKGUARD(enum TIMER checkTimerIDIn) : checkTimerObj(checkTimerIDIn)
+    {
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts checking the stack canary
+     *
+     * inputs:
+     *    checkIntervalMsIn - how often to check, in milliseconds. 0 is treated as 1
+     *    callbackIDIn - which Callback function to call if the canary is overwritten
+     *    callbackInterfacePtrIn - the object to call it on. If NULL we just stop 
+     *       dead if the canary is overwritten
+     * */
+    void YakIO_STACKGUARD::Start(unsigned int checkIntervalMsIn, enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(checkIntervalMsIn==0) checkIntervalMsIn = 1;
+        checkIntervalMs = checkIntervalMsIn;
+        msSinceLastCheck = 0;
+        callbackID = callbackIDIn;
+        callbackInterfacePtr = callbackInterfacePtrIn;
+
+        // a 1 millisecond tick. See 02_BetterBlinky
+        checkTimerObj.QuickSetup(4, 1000, CALLBACK_0, this);
+    }
+
+    /* Stop - stops checking the stack canary
+     * */
+    void YakIO_STACKGUARD::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        checkTimerObj.TimerStop();
+    }
+
+    /* HasOverflowed - tests if the check has ever found the canary overwritten
+     *
+     * returns:
+     *    nz if it has, z if it has not
+     * */
+    unsigned int YakIO_STACKGUARD::HasOverflowed(void)
+    {
+        return overflowDetected;
+    }
+
+    /* GetCheckCount - gets the number of times the canary has been checked
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_STACKGUARD::GetCheckCount(void)
+    {
+        return checkCount;
+    }
+
+    /* Callback0 - the timer tick. Called every millisecond from the timer 
+     *    interrupt. Checks the canary every checkIntervalMs ticks.
+     * */
+    void YakIO_STACKGUARD::Callback0(void)
+    {
+        msSinceLastCheck = msSinceLastCheck + 1;
+        if(msSinceLastCheck<checkIntervalMs) return;
+        msSinceLastCheck = 0;
+
+        checkCount = checkCount + 1;
+        if(IsStackCanaryIntact()!=0) return;
+
+        // it has gone. We only report it once
+        overflowDetected = 1;
+        checkTimerObj.TimerStop();
+
+        // no one to tell so we stop here rather than run on with damaged memory
+        if(callbackInterfacePtr==NULL) while(1);
+
+        if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
+        else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
+        else if(callbackID == HEARTBEAT) callbackInterfacePtr->Heartbeat();
+    }
@@ -0,0 +1,764 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_TASK.h"
+
+// set in the constructor so YakIO_TASK::promise_type can find the frame pool
+YakIO_TASKSCHEDULER *taskScheduler_ptr = NULL;
+
+// #
+// # YakIO_TASK::promise_type. The compiler calls these, you never do.
+// #
+
+    /* operator new - gets the memory for a coroutine frame. The compiler
+     *    calls this when a function returning a YakIO_TASK is called.
+     *
+     * inputs:
+     *    frameBytes - the size of frame the compiler needs
+     *
+     * returns:
+     *    a pointer to the frame or NULL if one is not available. The 
+     *    noexcept on the declaration tells the compiler to check for NULL
+     *    and call get_return_object_on_allocation_failure() if it is.
+     * */
+    void *YakIO_TASK::promise_type::operator new(std::size_t frameBytes) noexcept
+    {
+        if(taskScheduler_ptr==NULL) return NULL;
+        return taskScheduler_ptr->AllocateFrame(frameBytes);
+    }
+
+    /* operator delete - gives back the memory of a coroutine frame. The
+     *    compiler calls this when a task finishes.
+     *
+     * inputs:
+     *    framePtr - the frame
+     * */
+    void YakIO_TASK::promise_type::operator delete(void *framePtr)
+    {
+        if(taskScheduler_ptr==NULL) return;
+        taskScheduler_ptr->FreeFrame(framePtr);
+    }
+
+    /* get_return_object_on_allocation_failure - the YakIO_TASK returned
+     *    when there was no frame available. Its taskHandle is empty.
+     * */
+    YakIO_TASK YakIO_TASK::promise_type::get_return_object_on_allocation_failure(void)
+    {
+        return YakIO_TASK {};
+    }
+
+    /* get_return_object - the YakIO_TASK returned when a task is created
+     * */
+    YakIO_TASK YakIO_TASK::promise_type::get_return_object(void)
+    {
+        return YakIO_TASK { std::coroutine_handle<promise_type>::from_promise(*this) };
+    }
+
+    /* initial_suspend - tasks stop before the first line of code. They 
+     *    start running when they are given to Spawn()
+     * */
+    std::suspend_always YakIO_TASK::promise_type::initial_suspend(void) noexcept
+    {
+        return {};
+    }
+
+    /* final_suspend - tasks do not stop at the end. The frame is destroyed
+     *    (and given back to the pool) immediately
+     * */
+    std::suspend_never YakIO_TASK::promise_type::final_suspend(void) noexcept
+    {
+        return {};
+    }
+
+    /* return_void - called on co_return or falling off the end of a task
+     * */
+    void YakIO_TASK::promise_type::return_void(void)
+    {
+    }
+
+    /* unhandled_exception - YakIO is compiled with -fno-exceptions so this 
+     *    can never happen. The standard says we must have one though.
+     * */
+    void YakIO_TASK::promise_type::unhandled_exception(void)
+    {
+        while(1) {}
+    }
+
+// #
+// # the awaiters. The compiler calls await_ready() first. If that returns
+// # false the task is stopped and await_suspend() is called. If that 
+// # returns false the task carries on after all. Either way, when the task
+// # carries on the value returned by await_resume() is the result of the 
+// # co_await.
+// #
+
+    bool YakIO_DELAYAWAITER::await_ready(void)
+    {
+        // a delay of nothing is no delay at all
+        return (delayTicks==0);
+    }
+
+    bool YakIO_DELAYAWAITER::await_suspend(std::coroutine_handle<> waitingHandle)
+    {
+        // if the table is full we do not wait. This cannot happen unless 
+        // TASK_MAX_DELAY_WAITERS has been set below TASK_FRAME_POOL_SLOTS
+        return (schedulerPtr->AddDelayWaiter(waitingHandle.address(), delayTicks)!=0);
+    }
+
+    void YakIO_DELAYAWAITER::await_resume(void)
+    {
+    }
+
+    bool YakIO_EDGEAWAITER::await_ready(void)
+    {
+        return false;
+    }
+
+    bool YakIO_EDGEAWAITER::await_suspend(std::coroutine_handle<> waitingHandle)
+    {
+        return (schedulerPtr->AddEdgeWaiter(waitingHandle.address(), gpioPtr, edgeType)!=0);
+    }
+
+    void YakIO_EDGEAWAITER::await_resume(void)
+    {
+    }
+
+    bool YakIO_RNGAWAITER::await_ready(void)
+    {
+        return false;
+    }
+
+    bool YakIO_RNGAWAITER::await_suspend(std::coroutine_handle<> waitingHandle)
+    {
+        // if another task is already waiting we queue up behind it. If the
+        // table is full we do not wait and get zero. This cannot happen 
+        // unless TASK_MAX_RNG_WAITERS has been set below TASK_FRAME_POOL_SLOTS
+        rngValue = 0;
+        return (schedulerPtr->AddRngWaiter(waitingHandle.address(), rngPtr, &rngValue)!=0);
+    }
+
+    unsigned int YakIO_RNGAWAITER::await_resume(void)
+    {
+        return rngValue;
+    }
+
+    bool YakIO_UARTAWAITER::await_ready(void)
+    {
+        // if a byte is already waiting there is no need to stop. When 
+        // another task is waiting the interrupt is on and takes every 
+        // byte as it comes, so we cannot jump the queue
+        unsigned char readValue = 0;
+        if(uartPtr->TryReadByte(readValue)==0) return false;
+        byteValue = readValue;
+        return true;
+    }
+
+    bool YakIO_UARTAWAITER::await_suspend(std::coroutine_handle<> waitingHandle)
+    {
+        // queue up behind any other task. If the table is full we do not
+        // wait and get zero, as for the RNG above
+        byteValue = 0;
+        return (schedulerPtr->AddUartWaiter(waitingHandle.address(), uartPtr, &byteValue)!=0);
+    }
+
+    unsigned int YakIO_UARTAWAITER::await_resume(void)
+    {
+        return byteValue;
+    }
+
+// #
+// # YakIO_TASKSIGNAL
+// #
+
+    /* constructor
+     *
+     * */
+    YakIO_TASKSIGNAL::YakIO_TASKSIGNAL()
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        waitingHandleAddress = NULL;
+        signalValue = 0;
+        signalPending = 0;
+    }
+
+    /* Signal - sends a value to the waiting task. Safe to call from an 
+     *    interrupt handler.
+     *
+     * inputs:
+     *    valueIn - the value the co_await will return
+     * */
+    void YakIO_TASKSIGNAL::Signal(unsigned int valueIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(taskScheduler_ptr==NULL) return;
+
+        unsigned int primaskState = EnterCritical();
+        signalValue = valueIn;
+        void *handleAddress = waitingHandleAddress;
+        waitingHandleAddress = NULL;
+        // if nobody was waiting, keep it for later
+        if(handleAddress==NULL) signalPending = 1;
+        ExitCritical(primaskState);
+
+        if(handleAddress!=NULL) taskScheduler_ptr->MakeReady(handleAddress);
+    }
+
+    bool YakIO_TASKSIGNAL::await_ready(void)
+    {
+        // a value arrived while nobody was waiting, take it now
+        return (signalPending!=0);
+    }
+
+    bool YakIO_TASKSIGNAL::await_suspend(std::coroutine_handle<> waitingHandle)
+    {
+        unsigned int primaskState = EnterCritical();
+        // the interrupt might have happened since await_ready()
+        if(signalPending!=0)
+        {
+            ExitCritical(primaskState);
+            return false;
+        }
+        waitingHandleAddress = waitingHandle.address();
+        ExitCritical(primaskState);
+        return true;
+    }
+
+    unsigned int YakIO_TASKSIGNAL::await_resume(void)
+    {
+        unsigned int primaskState = EnterCritical();
+        unsigned int valueOut = signalValue;
+        signalPending = 0;
+        ExitCritical(primaskState);
+        return valueOut;
+    }
+
+// #
+// # YakIO_TASKSCHEDULER
+// #
+
+    /* constructor
+     *
+     * inputs:
+     *    eventLoopPtrIn - the event loop the tasks are resumed from
+     *    resumeEventTypeIn - the eventType we use for that. Nothing else 
+     *        should use it
+     *    tickTimerIDIn - the timer to use for the tick. Do not use this 
+     *        timer for anything else.
+     * */
+    YakIO_TASKSCHEDULER::YakIO_TASKSCHEDULER(YakIO_EVENTLOOP *eventLoopPtrIn, unsigned int resumeEventTypeIn, enum TIMER tickTimerIDIn) : tickTimerObj {tickTimerIDIn}
+    {
+        // set this so we know we have run through the constructor. Creating
+        // objects on the heap will NOT run the constructor
+        isInitialized =1;
+
+        eventLoopPtr = eventLoopPtrIn;
+        resumeEventType = resumeEventTypeIn;
+
+        for(unsigned int i=0; i<TASK_FRAME_POOL_SLOTS; i++) frameInUse[i]=0;
+        for(unsigned int i=0; i<TASK_MAX_DELAY_WAITERS; i++) delayHandleAddresses[i]=NULL;
+        for(unsigned int i=0; i<TASK_MAX_EDGE_WAITERS; i++) edgeHandleAddresses[i]=NULL;
+        for(unsigned int i=0; i<TASK_MAX_RNG_WAITERS; i++) rngHandleAddresses[i]=NULL;
+        for(unsigned int i=0; i<TASK_MAX_UART_WAITERS; i++) uartHandleAddresses[i]=NULL;
+        for(unsigned int i=0; i<TASK_FRAME_POOL_SLOTS; i++) heldHandleAddresses[i]=NULL;
+
+        // set this so the frame allocation can find us
+        taskScheduler_ptr = this;
+    }
+
+    /* Start - registers with the event loop and starts the tick. Call this
+     *    before eventLoop.Run(). Tasks can be Spawn()ed before or after. The
+     *    ones Spawn()ed before are held (see MakeReady()) and posted here.
+     *
+     * inputs:
+     *    resumePriority - the priority of the resume events. See the note 
+     *       in the header about not sharing it.
+     * */
+    void YakIO_TASKSCHEDULER::Start(enum EVENT_PRIORITY resumePriority)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(eventLoopPtr==NULL) return;
+
+        eventLoopPtr->RegisterHandler(resumeEventType, resumePriority, this);
+        // anything Spawn()ed before now could not be posted
+        PostHeldTasks();
+        // a 1 millisecond tick. See 02_BetterBlinky for how this works out
+        tickTimerObj.QuickSetup(4, 1000, CALLBACK_0, this);
+    }
+
+    /* Spawn - starts a task running. It runs, from the event loop, until 
+     *    its first co_await.
+     *
+     * inputs:
+     *    newTask - what calling the coroutine function returned
+     *
+     * returns:
+     *    1 if the task was started, 0 if there was no frame for it or it 
+     *    could not be made ready. In that case the frame is given back
+     * */
+    unsigned int YakIO_TASKSCHEDULER::Spawn(YakIO_TASK newTask)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(!newTask.taskHandle) return 0;
+
+        if(MakeReady(newTask.taskHandle.address())==0)
+        {
+            // it would never run, destroying it gives the frame back to the pool
+            newTask.taskHandle.destroy();
+            return 0;
+        }
+        return 1;
+    }
+
+    /* MakeReady - arranges for a stopped task to be resumed by the event 
+     *    loop. Safe to call from an interrupt handler.
+     *
+     *    If the resume event cannot be posted - because Start() has not 
+     *    registered us with the event loop yet or because the queue is full -
+     *    the task is held and the tick posts it again later. The task runs
+     *    late but it is never lost.
+     *
+     * inputs:
+     *    handleAddress - the address of the tasks frame
+     * returns:
+     *    1 if the task was posted or held, 0 if neither. A task can only be
+     *    waiting for one thing at a time so there is always room to hold it
+     *    and this should never happen
+     * */
+    unsigned int YakIO_TASKSCHEDULER::MakeReady(void *handleAddress)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(handleAddress==NULL) return 0;
+
+        // this only works because pointers are 32 bits on the nRF51822
+        if(eventLoopPtr->PostEvent(resumeEventType, (unsigned int)handleAddress)!=0) return 1;
+
+        unsigned int primaskState = EnterCritical();
+        for(unsigned int i=0; i<TASK_FRAME_POOL_SLOTS; i++)
+        {
+            if(heldHandleAddresses[i]!=NULL) continue;
+            heldHandleAddresses[i] = handleAddress;
+            ExitCritical(primaskState);
+            return 1;
+        }
+        ExitCritical(primaskState);
+        return 0;
+    }
+
+    /* PostHeldTasks - tries again to post the resume events MakeReady() 
+     *    could not. Stops at the first one that still will not go
+     * */
+    void YakIO_TASKSCHEDULER::PostHeldTasks(void)
+    {
+        for(unsigned int i=0; i<TASK_FRAME_POOL_SLOTS; i++)
+        {
+            // an interrupt might be holding another task at the same time
+            unsigned int primaskState = EnterCritical();
+            void *handleAddress = heldHandleAddresses[i];
+            if(handleAddress!=NULL)
+            {
+                if(eventLoopPtr->PostEvent(resumeEventType, (unsigned int)handleAddress)==0)
+                {
+                    ExitCritical(primaskState);
+                    return;
+                }
+                heldHandleAddresses[i] = NULL;
+            }
+            ExitCritical(primaskState);
+        }
+    }
+
+    /* EventCallback - the event loop calls this with a resume event. We 
+     *    resume the task. It runs until its next co_await (or until it ends)
+     *
+     * inputs:
+     *    eventType - always our resumeEventType
+     *    eventData - the address of the tasks frame
+     * */
+    void YakIO_TASKSCHEDULER::EventCallback(unsigned int eventType, unsigned int eventData)
+    {
+        if(eventType!=resumeEventType) return;
+        if(eventData==0) return;
+
+        std::coroutine_handle<>::from_address((void *)eventData).resume();
+    }
+
+    /* Delay - co_await the result of this to wait
+     *
+     * inputs:
+     *    delayTicks - the number of 1 millisecond ticks to wait
+     * */
+    YakIO_DELAYAWAITER YakIO_TASKSCHEDULER::Delay(unsigned int delayTicks)
+    {
+        return YakIO_DELAYAWAITER {this, delayTicks};
+    }
+
+    /* WaitForEdge - co_await the result of this to wait for a GPIO to change.
+     *    The GPIO is checked once per tick (1 millisecond) so very short
+     *    pulses can be missed. Switch bounce will not be filtered out.
+     *
+     * inputs:
+     *    gpioPtr - the GPIO, it should be an input
+     *    edgeType - the change to wait for
+     * */
+    YakIO_EDGEAWAITER YakIO_TASKSCHEDULER::WaitForEdge(YakIO_GPIO *gpioPtr, enum TASK_EDGE edgeType)
+    {
+        return YakIO_EDGEAWAITER {this, gpioPtr, edgeType};
+    }
+
+    /* GetRandom - co_await the result of this to get a random number (0-255).
+     *    The RNG is started, the task stops until the RNG interrupt, and 
+     *    the RNG is stopped again. 
+     *
+     *    NOTE: this uses the callback of the RNG object. Do not set your own.
+     *
+     * inputs:
+     *    rngPtr - the RNG
+     * */
+    YakIO_RNGAWAITER YakIO_TASKSCHEDULER::GetRandom(YakIO_RNG *rngPtr)
+    {
+        return YakIO_RNGAWAITER {this, rngPtr, 0};
+    }
+
+    /* ReadByte - co_await the result of this to get the next byte the UART
+     *    receives. The task stops until the UART receive interrupt.
+     *
+     *    NOTE: this uses the callback of the UART object. Do not set your own.
+     *
+     * inputs:
+     *    uartPtr - the UART, it must have been Start()ed
+     * */
+    YakIO_UARTAWAITER YakIO_TASKSCHEDULER::ReadByte(YakIO_UART *uartPtr)
+    {
+        return YakIO_UARTAWAITER {this, uartPtr, 0};
+    }
+
+    /* AddDelayWaiter - puts a task in the Delay() table
+     *
+     * inputs:
+     *    handleAddress - the address of the tasks frame
+     *    delayTicks - the number of ticks to wait
+     *
+     * returns:
+     *    1 if it was added, 0 if the table was full
+     * */
+    unsigned int YakIO_TASKSCHEDULER::AddDelayWaiter(void *handleAddress, unsigned int delayTicks)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        for(unsigned int i=0; i<TASK_MAX_DELAY_WAITERS; i++)
+        {
+            if(delayHandleAddresses[i]!=NULL) continue;
+            delayWakeTicks[i] = tickCount + delayTicks;
+            // do this last, it makes the entry visible to the tick
+            delayHandleAddresses[i] = handleAddress;
+            ExitCritical(primaskState);
+            return 1;
+        }
+        ExitCritical(primaskState);
+        return 0;
+    }
+
+    /* AddEdgeWaiter - puts a task in the WaitForEdge() table
+     *
+     * inputs:
+     *    handleAddress - the address of the tasks frame
+     *    gpioPtr - the GPIO to watch
+     *    edgeType - the change to wait for
+     *
+     * returns:
+     *    1 if it was added, 0 if the table was full
+     * */
+    unsigned int YakIO_TASKSCHEDULER::AddEdgeWaiter(void *handleAddress, YakIO_GPIO *gpioPtr, enum TASK_EDGE edgeType)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(gpioPtr==NULL) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        for(unsigned int i=0; i<TASK_MAX_EDGE_WAITERS; i++)
+        {
+            if(edgeHandleAddresses[i]!=NULL) continue;
+            edgeGpioPtrs[i] = gpioPtr;
+            edgeTypes[i] = edgeType;
+            // the edge is measured from the state now
+            edgeLastStates[i] = gpioPtr->GetGPIOState();
+            edgeHandleAddresses[i] = handleAddress;
+            ExitCritical(primaskState);
+            return 1;
+        }
+        ExitCritical(primaskState);
+        return 0;
+    }
+
+    /* AddRngWaiter - puts a task at the back of the GetRandom() queue. The
+     *    first one starts the RNG
+     *
+     * inputs:
+     *    handleAddress - the address of the tasks frame
+     *    rngPtr - the RNG. There is only one so every task must use the same
+     *    valuePtr - where the RNG interrupt puts the value for this task
+     *
+     * returns:
+     *    1 if it was added, 0 if the queue was full
+     * */
+    unsigned int YakIO_TASKSCHEDULER::AddRngWaiter(void *handleAddress, YakIO_RNG *rngPtr, volatile unsigned int *valuePtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((rngPtr==NULL) || (valuePtr==NULL)) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        if(rngWaiterCount>=TASK_MAX_RNG_WAITERS)
+        {
+            ExitCritical(primaskState);
+            return 0;
+        }
+        rngHandleAddresses[rngWaiterCount] = handleAddress;
+        rngValuePtrs[rngWaiterCount] = valuePtr;
+        rngWaiterCount = rngWaiterCount + 1;
+        if(rngWaiterCount==1)
+        {
+            rngWaitPtr = rngPtr;
+            rngPtr->SetCallback(CALLBACK_1, this);
+            rngPtr->RngStart();
+        }
+        ExitCritical(primaskState);
+        return 1;
+    }
+
+    /* AddUartWaiter - puts a task at the back of the ReadByte() queue. The
+     *    first one turns on the receive interrupt
+     *
+     * inputs:
+     *    handleAddress - the address of the tasks frame
+     *    uartPtr - the UART. Every task must use the same one
+     *    valuePtr - where the UART interrupt puts the byte for this task
+     *
+     * returns:
+     *    1 if it was added, 0 if the queue was full
+     * */
+    unsigned int YakIO_TASKSCHEDULER::AddUartWaiter(void *handleAddress, YakIO_UART *uartPtr, volatile unsigned int *valuePtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if((uartPtr==NULL) || (valuePtr==NULL)) return 0;
+
+        unsigned int primaskState = EnterCritical();
+        if(uartWaiterCount>=TASK_MAX_UART_WAITERS)
+        {
+            ExitCritical(primaskState);
+            return 0;
+        }
+        uartHandleAddresses[uartWaiterCount] = handleAddress;
+        uartValuePtrs[uartWaiterCount] = valuePtr;
+        uartWaiterCount = uartWaiterCount + 1;
+        if(uartWaiterCount==1)
+        {
+            uartWaitPtr = uartPtr;
+            // a byte which arrived since await_ready() interrupts as soon
+            // as we leave the critical section
+            uartPtr->SetCallback(CALLBACK_2, this);
+        }
+        ExitCritical(primaskState);
+        return 1;
+    }
+
+    /* AllocateFrame - takes a slot from the frame pool. The size asked for
+     *    is recorded - this is how the RAM cost of a task is measured.
+     *
+     * inputs:
+     *    frameBytes - the size the compiler wants
+     *
+     * returns:
+     *    the frame or NULL if it is too big or there is no slot free
+     * */
+    void *YakIO_TASKSCHEDULER::AllocateFrame(unsigned int frameBytes)
+    {
+        // we must be initialized
+        if(isInitialized==0) return NULL;
+
+        if(frameBytes>largestFrameBytes) largestFrameBytes = frameBytes;
+        if(frameBytes>(TASK_FRAME_SLOT_WORDS*4))
+        {
+            failedAllocationCount++;
+            return NULL;
+        }
+
+        // tasks are only ever created from the MainLoop() or the event 
+        // loop, never from an interrupt. So we do not need to lock this
+        for(unsigned int i=0; i<TASK_FRAME_POOL_SLOTS; i++)
+        {
+            if(frameInUse[i]!=0) continue;
+            frameInUse[i] = 1;
+            framesInUseCount++;
+            if(framesInUseCount>framesInUseHighWater) framesInUseHighWater = framesInUseCount;
+            return &framePool[i][0];
+        }
+        failedAllocationCount++;
+        return NULL;
+    }
+
+    /* FreeFrame - gives a slot back to the frame pool
+     *
+     * inputs:
+     *    framePtr - the frame
+     * */
+    void YakIO_TASKSCHEDULER::FreeFrame(void *framePtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        for(unsigned int i=0; i<TASK_FRAME_POOL_SLOTS; i++)
+        {
+            if(framePtr!=&framePool[i][0]) continue;
+            frameInUse[i] = 0;
+            framesInUseCount--;
+            return;
+        }
+    }
+
+    /* GetTickCount - the number of ticks since Start()
+     * */
+    unsigned int YakIO_TASKSCHEDULER::GetTickCount(void)
+    {
+        return tickCount;
+    }
+
+    /* GetFramesInUse - the number of tasks that exist now
+     * */
+    unsigned int YakIO_TASKSCHEDULER::GetFramesInUse(void)
+    {
+        return framesInUseCount;
+    }
+
+    /* GetFramesInUseHighWater - the most tasks that have ever existed at once
+     * */
+    unsigned int YakIO_TASKSCHEDULER::GetFramesInUseHighWater(void)
+    {
+        return framesInUseHighWater;
+    }
+
+    /* GetLargestFrameBytes - the biggest frame the compiler has asked for. 
+     *    This is the RAM cost of the largest task.
+     * */
+    unsigned int YakIO_TASKSCHEDULER::GetLargestFrameBytes(void)
+    {
+        return largestFrameBytes;
+    }
+
+    /* GetFailedAllocationCount - the number of tasks that could not be 
+     *    created, either because the pool was empty or the frame too big
+     * */
+    unsigned int YakIO_TASKSCHEDULER::GetFailedAllocationCount(void)
+    {
+        return failedAllocationCount;
+    }
+
+    /* Callback0 - the tick. Wakes any tasks whose Delay() is up or whose
+     *    GPIO has changed and retries any held ones.
+     *
+     *    NOTE: You are in an INTERRUPT in here. We do not resume the tasks
+     *    here, we just post the events that will resume them.
+     * */
+    void YakIO_TASKSCHEDULER::Callback0(void)
+    {
+        tickCount = tickCount + 1;
+
+        // anything MakeReady() could not post last time
+        PostHeldTasks();
+
+        for(unsigned int i=0; i<TASK_MAX_DELAY_WAITERS; i++)
+        {
+            void *handleAddress = delayHandleAddresses[i];
+            if(handleAddress==NULL) continue;
+            // this comparison still works when tickCount wraps round
+            if((int)(tickCount-delayWakeTicks[i])<0) continue;
+            delayHandleAddresses[i] = NULL;
+            MakeReady(handleAddress);
+        }
+
+        for(unsigned int i=0; i<TASK_MAX_EDGE_WAITERS; i++)
+        {
+            void *handleAddress = edgeHandleAddresses[i];
+            if(handleAddress==NULL) continue;
+            unsigned int gpioState = edgeGpioPtrs[i]->GetGPIOState();
+            unsigned int lastState = edgeLastStates[i];
+            edgeLastStates[i] = gpioState;
+            if(gpioState==lastState) continue;
+            if((edgeTypes[i]==TASK_EDGE_FALLING) && (gpioState!=0)) continue;
+            if((edgeTypes[i]==TASK_EDGE_RISING) && (gpioState==0)) continue;
+            edgeHandleAddresses[i] = NULL;
+            MakeReady(handleAddress);
+        }
+    }
+
+    /* Callback1 - the RNG interrupt. Gives the value to the oldest waiting 
+     *    task and wakes it. The RNG is stopped once nobody is waiting
+     *
+     *    NOTE: You are in an INTERRUPT in here. 
+     * */
+    void YakIO_TASKSCHEDULER::Callback1(void)
+    {
+        if((rngWaitPtr==NULL) || (rngWaiterCount==0)) return;
+
+        // a value is ready so this will not spin
+        *rngValuePtrs[0] = rngWaitPtr->GetRngValue();
+        void *handleAddress = rngHandleAddresses[0];
+        rngWaiterCount = rngWaiterCount - 1;
+        for(unsigned int i=0; i<rngWaiterCount; i++)
+        {
+            rngHandleAddresses[i] = rngHandleAddresses[i+1];
+            rngValuePtrs[i] = rngValuePtrs[i+1];
+        }
+        if(rngWaiterCount==0) rngWaitPtr->RngStop();
+        MakeReady(handleAddress);
+    }
+
+    /* Callback2 - the UART receive interrupt. Gives the byte to the oldest
+     *    waiting task and wakes it. The interrupt is turned off once nobody 
+     *    is waiting
+     *
+     *    NOTE: You are in an INTERRUPT in here. 
+     * */
+    void YakIO_TASKSCHEDULER::Callback2(void)
+    {
+        if((uartWaitPtr==NULL) || (uartWaiterCount==0)) return;
+
+        // a byte is waiting so this will get it
+        unsigned char byteValue = 0;
+        if(uartWaitPtr->TryReadByte(byteValue)==0) return;
+        *uartValuePtrs[0] = byteValue;
+        void *handleAddress = uartHandleAddresses[0];
+        uartWaiterCount = uartWaiterCount - 1;
+        for(unsigned int i=0; i<uartWaiterCount; i++)
+        {
+            uartHandleAddresses[i] = uartHandleAddresses[i+1];
+            uartValuePtrs[i] = uartValuePtrs[i+1];
+        }
+        // the UART keeps up to 6 more bytes until the next ReadByte()
+        if(uartWaiterCount==0) uartWaitPtr->ClearAllCallbacks();
+        MakeReady(handleAddress);
+    }
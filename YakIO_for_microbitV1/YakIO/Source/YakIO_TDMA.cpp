@@ -0,0 +1,750 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_TDMA.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_TDMA - Constructor. Nothing happens until Start() is called
+     *
+     * inputs:
+     *    radioObjPtrIn - the RADIO to share out
+     *    timeSyncObjPtrIn - the time sync on that RADIO. This class starts
+     *       and stops it
+     * */
+    YakIO_TDMA::YakIO_TDMA(YakIO_RADIO *radioObjPtrIn, YakIO_TIMESYNC *timeSyncObjPtrIn)
+    {
+        radioObjPtr = radioObjPtrIn;
+        timeSyncObjPtr = timeSyncObjPtrIn;
+        for(int i=0; i<TDMA_MAX_NODES; i++)
+        {
+            slotOwner[i] = 0;
+            slotLastHeard[i] = 0;
+        }
+        for(int i=0; i<TDMA_MAX_ACTIVITIES; i++)
+        {
+            activityType[i] = TDMA_ACTIVITY_LISTEN;
+            activityFirstSlot[i] = 0;
+            activityLastSlot[i] = 0;
+        }
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts the time sync and the superframes. The RADIO must 
+     *     already be Start()ed. See the note on TDMA in YakIO_TDMA.h
+     *
+     * inputs:
+     *    tdmaRoleIn - the coordinator or a node. Only one board should be
+     *       the coordinator
+     *    nodeIdIn - who we are, a node only. Must not be zero and must be 
+     *       different on every board. The FICR DEVICEID is a good choice
+     * */
+    void YakIO_TDMA::Start(enum TDMA_ROLE tdmaRoleIn, unsigned int nodeIdIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((radioObjPtr==NULL) || (timeSyncObjPtr==NULL)) return;
+
+        Stop();
+        if(tdmaRoleIn==TDMA_ROLE_NONE) return;
+        if((tdmaRoleIn==TDMA_ROLE_NODE) && (nodeIdIn==0)) return;
+
+        tdmaRole = tdmaRoleIn;
+        nodeId = nodeIdIn;
+        // every node must wait a different random time to join
+        randomState = nodeIdIn ^ 0x2545F491;
+        if(randomState==0) randomState = 1;
+        superframeCount = 0;
+        beaconIsNew = 0;
+        dataSlot = TDMA_NO_SLOT;
+        joinWindow = TDMA_MIN_JOIN_WINDOW;
+        joinWait = 0;
+        dataIsQueued = 0;
+        activityHasData = 0;
+        for(int i=0; i<TDMA_MAX_NODES; i++) slotOwner[i] = 0;
+        joinReplyId = 0;
+        joinReplySlot = TDMA_NO_SLOT;
+        missedWindowCount = 0;
+        sentDataCount = 0;
+
+        // COMPARE[2] closes the windows
+        ppiObj.ConnectChannel(TDMA_PPI_CHANNEL_DISABLE, REGISTER_TIMER0+TDMA_COMPARE_DISABLE, REGISTER_RADIO+RADIOREG_OFFSET_DISABLE);
+        timeSyncObjPtr->SetCallback(CALLBACK_0, this);
+
+        if(tdmaRole==TDMA_ROLE_NODE)
+        {
+            timeSyncObjPtr->Start(TIMESYNC_ROLE_FOLLOWER);
+            StartSearching();
+            return;
+        }
+
+        // the coordinator's clock is the network time, it can start at once
+        timeSyncObjPtr->Start(TIMESYNC_ROLE_REFERENCE);
+        radioObjPtr->Cancel();
+        radioObjPtr->SetExternalStart(1);
+        ppiObj.EnableChannel(TDMA_PPI_CHANNEL_DISABLE);
+        superframeStart = timeSyncObjPtr->GetNetworkTime();
+        superframeSlots = 0;
+        tdmaState = TDMA_STATE_COORDINATING;
+        unsigned int primaskState = EnterCritical();
+        PlanNextWindow();
+        ExitCritical(primaskState);
+    }
+
+    /* Stop - stops the superframes and the time sync. The RADIO is left
+     *     idle
+     * */
+    void YakIO_TDMA::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if((radioObjPtr==NULL) || (timeSyncObjPtr==NULL)) return;
+
+        unsigned int primaskState = EnterCritical();
+        StopWindows();
+        tdmaState = TDMA_STATE_STOPPED;
+        tdmaRole = TDMA_ROLE_NONE;
+        ExitCritical(primaskState);
+        timeSyncObjPtr->Stop();
+    }
+
+    /* QueueData - gives a node some data to send in its next slot. Only 
+     *     one lot can be waiting, IsDataQueued() says when it has gone
+     *
+     * inputs:
+     *    dataBytesIn - the data. It is copied
+     *    dataLengthIn - the number of bytes, 0 to TDMA_MAX_DATA_BYTES
+     * returns:
+     *    nz if it was queued, z if there is already some waiting or there
+     *    is too much
+     * */
+    unsigned int YakIO_TDMA::QueueData(const unsigned char *dataBytesIn, unsigned int dataLengthIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(dataLengthIn>TDMA_MAX_DATA_BYTES) return 0;
+        if((dataBytesIn==NULL) && (dataLengthIn!=0)) return 0;
+        if(dataIsQueued!=0) return 0;
+
+        // the interrupt must not see half of it
+        unsigned int primaskState = EnterCritical();
+        for(unsigned int i=0; i<dataLengthIn; i++) dataBytes[i] = dataBytesIn[i];
+        dataLength = dataLengthIn;
+        dataIsQueued = 1;
+        ExitCritical(primaskState);
+        return 1;
+    }
+
+    /* IsDataQueued - tests if the data QueueData() was given is still 
+     *     waiting for our slot
+     *
+     * returns:
+     *    nz if it is, z if it has gone
+     * */
+    unsigned int YakIO_TDMA::IsDataQueued(void)
+    {
+        return dataIsQueued;
+    }
+
+    /* GetReceivedData - looks at everything the RADIO has received. The 
+     *     beacons and join requests are dealt with here. Call it often
+     *     from the MainLoop(), never from an interrupt
+     *
+     * returns:
+     *    the oldest data packet not yet released, or NULL if there is 
+     *    none. Only the coordinator ever gets one. The data starts at 
+     *    payloadBytes[TDMA_DATA_OFFSET_PAYLOAD]. The same packet is 
+     *    returned until ReleaseData() is called
+     * */
+    struct YakIO_RADIOPACKET *YakIO_TDMA::GetReceivedData(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return NULL;
+        if(radioObjPtr==NULL) return NULL;
+
+        while(1)
+        {
+            struct YakIO_RADIOPACKET *packetPtr = radioObjPtr->GetReceivedPacket();
+            if(packetPtr==NULL) return NULL;
+            if(HandleControlPacket(packetPtr)==0) return packetPtr;
+            radioObjPtr->ReleasePacket();
+        }
+    }
+
+    /* ReleaseData - hands the packet GetReceivedData() returned back to
+     *     the RADIO. Do not use the pointer after this
+     * */
+    void YakIO_TDMA::ReleaseData(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(radioObjPtr==NULL) return;
+
+        radioObjPtr->ReleasePacket();
+    }
+
+    /* GetRole - gets which part we play
+     *
+     * returns:
+     *    the role, TDMA_ROLE_NONE if not started
+     * */
+    enum TDMA_ROLE YakIO_TDMA::GetRole(void)
+    {
+        return tdmaRole;
+    }
+
+    /* GetState - gets how far along we are
+     *
+     * returns:
+     *    the state
+     * */
+    enum TDMA_STATE YakIO_TDMA::GetState(void)
+    {
+        return tdmaState;
+    }
+
+    /* GetSlot - gets the data slot a node has been given
+     *
+     * returns:
+     *    the slot, TDMA_NO_SLOT if it has none
+     * */
+    unsigned int YakIO_TDMA::GetSlot(void)
+    {
+        return dataSlot;
+    }
+
+    /* GetNodeCount - gets the number of data slots in the superframe. This
+     *     is how many nodes there is room for right now, it grows as they
+     *     join
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TDMA::GetNodeCount(void)
+    {
+        return superframeSlots;
+    }
+
+    /* GetSuperframeTicks - gets how long the superframe is right now. No
+     *     node waits longer than this for its slot
+     *
+     * returns:
+     *    the length in microseconds
+     * */
+    unsigned int YakIO_TDMA::GetSuperframeTicks(void)
+    {
+        return GetTicksForSlots(superframeSlots);
+    }
+
+    /* GetSuperframeCount - gets the number of superframes since Start(),
+     *     or since a node last stopped searching
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TDMA::GetSuperframeCount(void)
+    {
+        return superframeCount;
+    }
+
+    /* GetMissedWindowCount - gets the number of windows the RADIO could not
+     *     be got ready for in time. Something kept the interrupts off for 
+     *     too long
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TDMA::GetMissedWindowCount(void)
+    {
+        return missedWindowCount;
+    }
+
+    /* GetSentDataCount - gets the number of QueueData()s which have gone
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TDMA::GetSentDataCount(void)
+    {
+        return sentDataCount;
+    }
+
+    /* Callback0 - the YakIO_TIMESYNC alarm, from the TIMER0 interrupt. It 
+     *     goes off twice a window. Once at the start, just after the PPI has 
+     *     started the RADIO, and once just after the end, when the RADIO is
+     *     idle again and the next window can be got ready
+     * */
+    void YakIO_TDMA::Callback0(void)
+    {
+        if((tdmaState==TDMA_STATE_STOPPED) || (tdmaState==TDMA_STATE_SEARCHING)) return;
+
+        if(windowIsOpen==0)
+        {
+            // nothing else must start the RADIO off COMPARE[0]
+            ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_TXEN);
+            ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_RXEN);
+            windowIsOpen = 1;
+            if(activityHasData!=0)
+            {
+                activityHasData = 0;
+                dataIsQueued = 0;
+                sentDataCount = sentDataCount + 1;
+            }
+            if(timeSyncObjPtr->SetAlarm(windowEndTime+TDMA_SETTLE_TICKS)!=0) return;
+            // we were held up until after the window closed, carry on
+        }
+
+        windowIsOpen = 0;
+        // the DISABLE has left the RADIO idle, unless it came before the 
+        // RADIO interrupt could see it
+        if(radioObjPtr->GetState()!=RADIO_STATE_IDLE) radioObjPtr->Cancel();
+        activityIndex = activityIndex + 1;
+        PlanNextWindow();
+    }
+
+// #
+// # Private
+// #
+
+    /* GetTicksForSlots - gets the length of a superframe
+     *
+     * inputs:
+     *    dataSlotCount - the number of data slots in it
+     * returns:
+     *    the length in microseconds
+     * */
+    unsigned int YakIO_TDMA::GetTicksForSlots(unsigned int dataSlotCount)
+    {
+        return (TDMA_FIRST_DATA_SLOT + dataSlotCount) * TDMA_SLOT_TICKS;
+    }
+
+    /* GetRandom - gets a pseudo random number, for the join waits. This is
+     *     xorshift32, it only has to be different on every node
+     *
+     * returns:
+     *    the number
+     * */
+    unsigned int YakIO_TDMA::GetRandom(void)
+    {
+        randomState = randomState ^ (randomState<<13);
+        randomState = randomState ^ (randomState>>17);
+        randomState = randomState ^ (randomState<<5);
+        return randomState;
+    }
+
+    /* StartSearching - a node listens all the time, with no windows, until
+     *     the time sync is good enough to follow the superframes
+     * */
+    void YakIO_TDMA::StartSearching(void)
+    {
+        StopWindows();
+        dataSlot = TDMA_NO_SLOT;
+        joinWindow = TDMA_MIN_JOIN_WINDOW;
+        joinWait = 0;
+        beaconIsNew = 0;
+        tdmaState = TDMA_STATE_SEARCHING;
+        radioObjPtr->StartReceive();
+    }
+
+    /* StopWindows - stops the alarm and the PPI and leaves the RADIO idle,
+     *     starting itself again
+     * */
+    void YakIO_TDMA::StopWindows(void)
+    {
+        timeSyncObjPtr->ClearAlarm();
+        ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_TXEN);
+        ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_RXEN);
+        ppiObj.DisableChannel(TDMA_PPI_CHANNEL_DISABLE);
+        radioObjPtr->Cancel();
+        radioObjPtr->SetExternalStart(0);
+        windowIsOpen = 0;
+        activityCount = 0;
+        activityIndex = 0;
+        activityHasData = 0;
+    }
+
+    /* PlanNextWindow - gets the RADIO and the PPI ready for the next window
+     *     and sets the alarm for the start of it. Windows there is no 
+     *     longer time for are skipped
+     * */
+    void YakIO_TDMA::PlanNextWindow(void)
+    {
+        while(1)
+        {
+            if(activityIndex>=activityCount)
+            {
+                if(BuildSuperframe()==0) return;
+            }
+            if(ArmWindow()!=0) return;
+            missedWindowCount = missedWindowCount + 1;
+            activityIndex = activityIndex + 1;
+        }
+    }
+
+    /* BuildSuperframe - moves on to the next superframe and works out what
+     *     the RADIO does in it
+     *
+     * returns:
+     *    nz if there are windows to plan, z if a node has lost the beacons
+     *    and gone back to searching
+     * */
+    unsigned int YakIO_TDMA::BuildSuperframe(void)
+    {
+        unsigned int nextStart = superframeStart + GetTicksForSlots(superframeSlots);
+        unsigned int nextSlots = superframeSlots;
+
+        if(tdmaRole==TDMA_ROLE_NODE)
+        {
+            // the beacon says where the coordinator thinks the superframes are.
+            // We may already be past the one it was for
+            if(beaconIsNew!=0)
+            {
+                unsigned int beaconNext = beaconStart + GetTicksForSlots(beaconSlots);
+                if((int)(beaconNext - superframeStart)>0)
+                {
+                    nextStart = beaconNext;
+                    nextSlots = beaconSlots;
+                }
+                beaconIsNew = 0;
+            }
+            if((superframeCount - beaconSuperframe)>TDMA_BEACON_TIMEOUT)
+            {
+                StartSearching();
+                return 0;
+            }
+        }
+        else
+        {
+            // free the slots of the nodes which have gone quiet and make the 
+            // superframe just long enough for the rest
+            nextSlots = 0;
+            for(unsigned int i=0; i<TDMA_MAX_NODES; i++)
+            {
+                if((slotOwner[i]!=0) && ((superframeCount - slotLastHeard[i])>TDMA_SLOT_TIMEOUT)) slotOwner[i] = 0;
+                if(slotOwner[i]!=0) nextSlots = i + 1;
+            }
+        }
+
+        // never plan a superframe which is already under way
+        unsigned int networkTime = timeSyncObjPtr->GetNetworkTime();
+        while((int)(nextStart - networkTime)<TDMA_MIN_LEAD_TICKS)
+        {
+            nextStart = nextStart + GetTicksForSlots(nextSlots);
+            superframeCount = superframeCount + 1;
+        }
+        superframeStart = nextStart;
+        superframeSlots = nextSlots;
+        superframeCount = superframeCount + 1;
+
+        // the windows, in slot order
+        activityCount = 0;
+        activityIndex = 0;
+        if(tdmaRole==TDMA_ROLE_COORDINATOR)
+        {
+            activityType[0] = TDMA_ACTIVITY_SEND_BEACON;
+            activityFirstSlot[0] = TDMA_BEACON_SLOT;
+            activityLastSlot[0] = TDMA_BEACON_SLOT;
+            // one long window for the join slot and all the data slots
+            activityType[1] = TDMA_ACTIVITY_LISTEN;
+            activityFirstSlot[1] = TDMA_JOIN_SLOT;
+            activityLastSlot[1] = TDMA_FIRST_DATA_SLOT + superframeSlots - 1;
+            activityCount = 2;
+            return 1;
+        }
+
+        activityType[0] = TDMA_ACTIVITY_LISTEN;
+        activityFirstSlot[0] = TDMA_BEACON_SLOT;
+        activityLastSlot[0] = TDMA_BEACON_SLOT;
+        activityCount = 1;
+        if((tdmaState==TDMA_STATE_JOINED) && (dataSlot<superframeSlots))
+        {
+            activityType[1] = TDMA_ACTIVITY_SEND_DATA;
+            activityFirstSlot[1] = TDMA_FIRST_DATA_SLOT + dataSlot;
+            activityLastSlot[1] = TDMA_FIRST_DATA_SLOT + dataSlot;
+            activityCount = 2;
+        }
+        else if(tdmaState==TDMA_STATE_JOINING)
+        {
+            if(joinWait==0)
+            {
+                activityType[1] = TDMA_ACTIVITY_SEND_JOIN;
+                activityFirstSlot[1] = TDMA_JOIN_SLOT;
+                activityLastSlot[1] = TDMA_JOIN_SLOT;
+                activityCount = 2;
+                // if that collides the next try is further off, on average
+                joinWait = GetRandom() % joinWindow;
+                if(joinWindow<TDMA_MAX_JOIN_WINDOW) joinWindow = joinWindow * 2;
+            }
+            else joinWait = joinWait - 1;
+        }
+        return 1;
+    }
+
+    /* ArmWindow - gets the RADIO ready for the window activityIndex and 
+     *     sets the PPI and the alarm to start it and stop it on time
+     *
+     * returns:
+     *    nz if it is all set, z if there is not enough time left
+     * */
+    unsigned int YakIO_TDMA::ArmWindow(void)
+    {
+        enum TDMA_ACTIVITY windowActivity = activityType[activityIndex];
+        // the listener is ready a guard time before the sender starts
+        unsigned int startTime = superframeStart + (activityFirstSlot[activityIndex] * TDMA_SLOT_TICKS);
+        if(windowActivity!=TDMA_ACTIVITY_LISTEN) startTime = startTime + TDMA_GUARD_TICKS;
+        unsigned int endTime = superframeStart + (activityLastSlot[activityIndex] * TDMA_SLOT_TICKS) + TDMA_WINDOW_TICKS;
+        unsigned int startLocalTime = timeSyncObjPtr->NetworkToLocalTime(startTime);
+        unsigned int endLocalTime = timeSyncObjPtr->NetworkToLocalTime(endTime);
+
+        unsigned int primaskState = EnterCritical();
+        if((int)(startLocalTime - timeSyncObjPtr->GetLocalTime())<TDMA_MIN_LEAD_TICKS)
+        {
+            ExitCritical(primaskState);
+            return 0;
+        }
+
+        // the RADIO waits for the PPI
+        unsigned int isReady = 0;
+        if(windowActivity==TDMA_ACTIVITY_LISTEN) isReady = radioObjPtr->StartReceive();
+        else isReady = ArmTransmit();
+        if(isReady==0)
+        {
+            activityHasData = 0;
+            ExitCritical(primaskState);
+            return 0;
+        }
+        YAKIO_REGISTER(REGISTER_TIMER0+TDMA_CC_DISABLE) = endLocalTime;
+        if(windowActivity==TDMA_ACTIVITY_LISTEN)
+        {
+            ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_TXEN);
+            ppiObj.EnableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_RXEN);
+        }
+        else
+        {
+            ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_RXEN);
+            ppiObj.EnableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_TXEN);
+        }
+        if(timeSyncObjPtr->SetAlarm(startLocalTime)==0)
+        {
+            // cannot happen, we checked above with the interrupts off
+            ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_TXEN);
+            ppiObj.DisableChannel(PPI_CH_TIMER0_COMPARE0_RADIO_RXEN);
+            radioObjPtr->Cancel();
+            activityHasData = 0;
+            ExitCritical(primaskState);
+            return 0;
+        }
+        windowEndTime = endLocalTime;
+        ExitCritical(primaskState);
+        return 1;
+    }
+
+    /* ArmTransmit - puts the packet for a sending window in the RADIO
+     *
+     * returns:
+     *    nz if the RADIO took it, z if not
+     * */
+    unsigned int YakIO_TDMA::ArmTransmit(void)
+    {
+        unsigned char packetBytes[RADIO_MAX_PAYLOAD_BYTES];
+        enum TDMA_ACTIVITY windowActivity = activityType[activityIndex];
+
+        if(windowActivity==TDMA_ACTIVITY_SEND_BEACON)
+        {
+            // the time sync beacon goes first, this is what comes after it
+            unsigned int slotMap = 0;
+            for(unsigned int i=0; i<TDMA_MAX_NODES; i++)
+            {
+                if(slotOwner[i]!=0) slotMap = slotMap | (1<<i);
+            }
+            for(int i=0; i<4; i++)
+            {
+                packetBytes[TDMA_BEACON_OFFSET_START-TIMESYNC_BEACON_BYTES+i] = (superframeStart>>(8*i)) & 0xFF;
+                packetBytes[TDMA_BEACON_OFFSET_JOIN_ID-TIMESYNC_BEACON_BYTES+i] = (joinReplyId>>(8*i)) & 0xFF;
+            }
+            packetBytes[TDMA_BEACON_OFFSET_SLOTS-TIMESYNC_BEACON_BYTES] = superframeSlots;
+            packetBytes[TDMA_BEACON_OFFSET_MAP-TIMESYNC_BEACON_BYTES] = slotMap & 0xFF;
+            packetBytes[TDMA_BEACON_OFFSET_MAP-TIMESYNC_BEACON_BYTES+1] = (slotMap>>8) & 0xFF;
+            packetBytes[TDMA_BEACON_OFFSET_JOIN_SLOT-TIMESYNC_BEACON_BYTES] = joinReplySlot;
+            return timeSyncObjPtr->SendBeacon(packetBytes, TDMA_BEACON_EXTRA_BYTES);
+        }
+        if(windowActivity==TDMA_ACTIVITY_SEND_JOIN)
+        {
+            packetBytes[TDMA_JOIN_OFFSET_TAG] = TDMA_JOIN_TAG;
+            for(int i=0; i<4; i++) packetBytes[TDMA_JOIN_OFFSET_ID+i] = (nodeId>>(8*i)) & 0xFF;
+            return radioObjPtr->Transmit(packetBytes, TDMA_JOIN_BYTES);
+        }
+
+        // our data slot. With no data it just says we are still here
+        unsigned int packetLength = TDMA_DATA_OFFSET_PAYLOAD;
+        packetBytes[TDMA_DATA_OFFSET_TAG] = TDMA_DATA_TAG;
+        packetBytes[TDMA_DATA_OFFSET_SLOT] = dataSlot;
+        if(dataIsQueued!=0)
+        {
+            for(unsigned int i=0; i<dataLength; i++) packetBytes[TDMA_DATA_OFFSET_PAYLOAD+i] = dataBytes[i];
+            packetLength = packetLength + dataLength;
+            activityHasData = 1;
+        }
+        return radioObjPtr->Transmit(packetBytes, packetLength);
+    }
+
+    /* HandleControlPacket - deals with a packet if it is one of ours
+     *
+     * inputs:
+     *    packetPtr - the packet GetReceivedPacket() returned
+     * returns:
+     *    nz if it has been dealt with, z if it is data for the program
+     * */
+    unsigned int YakIO_TDMA::HandleControlPacket(struct YakIO_RADIOPACKET *packetPtr)
+    {
+        if(packetPtr->lengthByte==0) return 1;
+        unsigned int packetTag = packetPtr->payloadBytes[0];
+
+        if(packetTag==TIMESYNC_BEACON_TAG)
+        {
+            // the interrupt uses the time sync and what the beacon tells us
+            // to plan the windows. It must not see half of either
+            unsigned int primaskState = EnterCritical();
+            timeSyncObjPtr->ProcessPacket(packetPtr);
+            if(tdmaRole==TDMA_ROLE_NODE) HandleBeacon(packetPtr);
+            ExitCritical(primaskState);
+            return 1;
+        }
+
+        // a node only listens to the beacons
+        if(tdmaRole!=TDMA_ROLE_COORDINATOR) return 1;
+
+        if((packetTag==TDMA_JOIN_TAG) && (packetPtr->lengthByte==TDMA_JOIN_BYTES))
+        {
+            unsigned int joinId = 0;
+            for(int i=0; i<4; i++) joinId = joinId | (packetPtr->payloadBytes[TDMA_JOIN_OFFSET_ID+i]<<(8*i));
+            HandleJoin(joinId);
+            return 1;
+        }
+        if((packetTag==TDMA_DATA_TAG) && (packetPtr->lengthByte>=TDMA_DATA_OFFSET_PAYLOAD))
+        {
+            unsigned int packetSlot = packetPtr->payloadBytes[TDMA_DATA_OFFSET_SLOT];
+            if(packetSlot>=TDMA_MAX_NODES) return 1;
+            slotLastHeard[packetSlot] = superframeCount;
+            // an empty one just says the node is still there
+            if(packetPtr->lengthByte==TDMA_DATA_OFFSET_PAYLOAD) return 1;
+            return 0;
+        }
+        return 1;
+    }
+
+    /* HandleBeacon - a node learns where the superframes are, and about 
+     *     its slot, from a beacon. Called with the interrupts off
+     *
+     * inputs:
+     *    packetPtr - the beacon
+     * */
+    void YakIO_TDMA::HandleBeacon(struct YakIO_RADIOPACKET *packetPtr)
+    {
+        if(packetPtr->lengthByte<TDMA_BEACON_BYTES) return;
+
+        unsigned int joinId = 0;
+        beaconStart = 0;
+        for(int i=0; i<4; i++)
+        {
+            beaconStart = beaconStart | (packetPtr->payloadBytes[TDMA_BEACON_OFFSET_START+i]<<(8*i));
+            joinId = joinId | (packetPtr->payloadBytes[TDMA_BEACON_OFFSET_JOIN_ID+i]<<(8*i));
+        }
+        beaconSlots = packetPtr->payloadBytes[TDMA_BEACON_OFFSET_SLOTS];
+        if(beaconSlots>TDMA_MAX_NODES) beaconSlots = TDMA_MAX_NODES;
+        unsigned int slotMap = packetPtr->payloadBytes[TDMA_BEACON_OFFSET_MAP] | (packetPtr->payloadBytes[TDMA_BEACON_OFFSET_MAP+1]<<8);
+        unsigned int joinSlot = packetPtr->payloadBytes[TDMA_BEACON_OFFSET_JOIN_SLOT];
+        beaconIsNew = 1;
+        beaconSuperframe = superframeCount;
+
+        if(tdmaState==TDMA_STATE_JOINED)
+        {
+            // our slot has timed out or gone to someone else
+            if((((slotMap>>dataSlot) & 1)==0) || ((joinSlot==dataSlot) && (joinId!=nodeId)))
+            {
+                dataSlot = TDMA_NO_SLOT;
+                joinWindow = TDMA_MIN_JOIN_WINDOW;
+                joinWait = 0;
+                tdmaState = TDMA_STATE_JOINING;
+            }
+        }
+        else if(tdmaState==TDMA_STATE_JOINING)
+        {
+            // the beacon keeps saying who the last join was for, make sure 
+            // it is still true
+            if((joinId==nodeId) && (joinSlot<TDMA_MAX_NODES) && (((slotMap>>joinSlot) & 1)!=0))
+            {
+                dataSlot = joinSlot;
+                tdmaState = TDMA_STATE_JOINED;
+            }
+        }
+        else if((tdmaState==TDMA_STATE_SEARCHING) && (timeSyncObjPtr->IsSynchronized()!=0))
+        {
+            // we know the time well enough now, follow the superframes
+            radioObjPtr->Cancel();
+            radioObjPtr->SetExternalStart(1);
+            ppiObj.EnableChannel(TDMA_PPI_CHANNEL_DISABLE);
+            superframeStart = beaconStart;
+            superframeSlots = beaconSlots;
+            activityCount = 0;
+            activityIndex = 0;
+            windowIsOpen = 0;
+            tdmaState = TDMA_STATE_JOINING;
+            PlanNextWindow();
+        }
+    }
+
+    /* HandleJoin - the coordinator gives a node a slot. The next beacon 
+     *     tells it which
+     *
+     * inputs:
+     *    joinId - the node id from the join request
+     * */
+    void YakIO_TDMA::HandleJoin(unsigned int joinId)
+    {
+        if(joinId==0) return;
+
+        unsigned int primaskState = EnterCritical();
+        // it might have asked before and not heard the answer
+        unsigned int joinSlot = TDMA_NO_SLOT;
+        for(unsigned int i=0; i<TDMA_MAX_NODES; i++)
+        {
+            if(slotOwner[i]==joinId) joinSlot = i;
+        }
+        for(unsigned int i=0; (i<TDMA_MAX_NODES) && (joinSlot==TDMA_NO_SLOT); i++)
+        {
+            if(slotOwner[i]==0) joinSlot = i;
+        }
+        // no room, it will keep asking
+        if(joinSlot!=TDMA_NO_SLOT)
+        {
+            slotOwner[joinSlot] = joinId;
+            slotLastHeard[joinSlot] = superframeCount;
+            joinReplyId = joinId;
+            joinReplySlot = joinSlot;
+        }
+        ExitCritical(primaskState);
+    }
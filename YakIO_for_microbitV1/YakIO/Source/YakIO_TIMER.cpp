@@ -16,6 +16,7 @@
 
 #include "YakIO.h"
 #include "YakIO_TIMER.h"
+#include "YakIO_TRACE.h"
 
 // the IRQ_TIMER?_handler's are non-member functions. They have no idea of
 // what class they should work on. The pointers below are set in the
@@ -30,10 +31,14 @@
 //
 // NOTE: also see the discussion of the IRQ_TIMER?_handlers in the comments on
 // those functions for additional information
+//
+// The "used" stops the link time optimizer (see the release profile in the
+// Makefile) throwing them away. Only the assembler in the handlers reads them
+// and the optimizer cannot see inside that.
 
-YakIO_TIMER *timer_ptr0 = NULL;
-YakIO_TIMER *timer_ptr1 = NULL;
-YakIO_TIMER *timer_ptr2 = NULL;
+__attribute__ ((used)) YakIO_TIMER *timer_ptr0 = NULL;
+__attribute__ ((used)) YakIO_TIMER *timer_ptr1 = NULL;
+__attribute__ ((used)) YakIO_TIMER *timer_ptr2 = NULL;
 
     /* Constructor - initializes the object
      *
@@ -56,7 +61,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         // set the address of the base register for this timer
         if(timerIDIn==Timer1) timerRegisterAddress = REGISTER_TIMER1;
         else if(timerIDIn==Timer2) timerRegisterAddress = REGISTER_TIMER2;
-        else timerRegisterAddress = REGISTER_TIMER1;
+        else timerRegisterAddress = REGISTER_TIMER0;
 
         // make sure the timer is stopped
         TimerStop();
@@ -78,7 +83,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
                                TIMER_SHORT_COMPARE2_STOP | TIMER_SHORT_COMPARE3_STOP;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_SHORTS)) = (~bitVal);
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_SHORTS) = (~bitVal);
     }
 
     /* SetShortCut - sets the TIMER_SHORT_COMPARE0_CLEAR in the SHORTS register
@@ -96,7 +101,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_SHORTS)) |= TIMER_SHORT_COMPARE0_CLEAR;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_SHORTS) = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_SHORTS) | TIMER_SHORT_COMPARE0_CLEAR;
     }
 
     /* GetShortCut - gets the TIMER_SHORT_COMPARE0_CLEAR value of the SHORTS register
@@ -110,7 +115,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return 0;
 
         // get the value from the appropriate register
-        unsigned int bitVal = (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_SHORTS));
+        unsigned int bitVal = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_SHORTS);
 
         bitVal &= TIMER_SHORT_COMPARE0_CLEAR;
         if(bitVal!=0) return 1;
@@ -128,7 +133,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
 
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_INTENCLR)) = bitVal;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_INTENCLR) = bitVal;
     }
 
     /* SetINTEN - sets the TIMER_INTEN_COMPARE0_BIT in the INTENSET register
@@ -145,7 +150,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_INTENSET)) |= TIMER_INTEN_COMPARE0_BIT;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_INTENSET) = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_INTENSET) | TIMER_INTEN_COMPARE0_BIT;
     }
 
     /* ClearINTEN - Clears the TIMER_INTEN_COMPARE0_BIT in the INTENCLR register
@@ -162,7 +167,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // we use a CLR register so we can just set these bits directly
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_INTENCLR)) |= TIMER_INTEN_COMPARE0_BIT;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_INTENCLR) = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_INTENCLR) | TIMER_INTEN_COMPARE0_BIT;
     }
 
     /* SetCallback - sets the callback object and function within that object.
@@ -196,12 +201,17 @@ YakIO_TIMER *timer_ptr2 = NULL;
         // we have to have this
         if(callbackInterfacePtr==NULL) return;
 
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
         // figure out what callback function to call and call it
         if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
         else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
-        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback1();
-        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
         else if(callbackID == HEARTBEAT) callbackInterfacePtr->Heartbeat();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
     }
 
     /* ClearAllCallbacks - clear all callbacks
@@ -358,7 +368,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_START)) = 1;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_START) = 1;
     }
 
     /* TimerStop - stops the timer.
@@ -374,7 +384,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_STOP)) = 1;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_STOP) = 1;
     }
 
    /* TimerClear - clears down the timers counter
@@ -386,7 +396,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_CLEAR)) = 1;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_CLEAR) = 1;
     }
 
     /* SetPrescaler - sets the prescaler value to divide down the clock
@@ -406,7 +416,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_PRESCALER)) = precalerValue;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_PRESCALER) = precalerValue;
     }
 
     /* GetPrescaler - gets the prescaler value which divides down the clock
@@ -421,7 +431,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return 0;
 
         // get the value from the appropriate register
-        unsigned int prescalerVal = (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_PRESCALER));
+        unsigned int prescalerVal = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_PRESCALER);
         return prescalerVal;
     }
 
@@ -441,7 +451,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_BITMODE)) = bitModeValue;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_BITMODE) = bitModeValue;
     }
 
     /* GetBitMode - gets the bit mode state
@@ -455,7 +465,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return TIMER_BITMODE_16Bit;
 
         // get the value from the appropriate register
-        unsigned int modeVal = (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_BITMODE));
+        unsigned int modeVal = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_BITMODE);
         if(modeVal==TIMER_BITMODE_32Bit) return TIMER_BITMODE_32Bit;
         else if(modeVal==TIMER_BITMODE_24Bit) return TIMER_BITMODE_24Bit;
         else if(modeVal==TIMER_BITMODE_08Bit) return TIMER_BITMODE_08Bit;
@@ -474,7 +484,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_MODE)) = modeValue;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_MODE) = modeValue;
     }
 
     /* GetMode - gets the mode state
@@ -488,7 +498,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return TIMER_MODE_Timer;
 
         // get the value from the appropriate register
-        unsigned int modeVal = (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_MODE));
+        unsigned int modeVal = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_MODE);
         if(modeVal==TIMER_MODE_Counter) return TIMER_MODE_Counter;
         else return TIMER_MODE_Timer;
     }
@@ -514,7 +524,7 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // set the value in the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_CC_0)) = countLevelValue;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_CC_0) = countLevelValue;
     }
 
     /* GetCountLevel - gets the CountLevel value. This is the value the timer
@@ -533,10 +543,36 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return 0;
 
         // get the value from the appropriate register
-        unsigned int CountLevelVal = (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_CC_0));
+        unsigned int CountLevelVal = YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_CC_0);
         return CountLevelVal;
     }
 
+    /* GetCount - gets the current value of the timers internal counter
+     *
+     *    The counter cannot be read directly. Instead we trigger the CAPTURE_1
+     *    task which copies the counter into the CC_1 register and then read it
+     *    from there. This class only ever uses CC_0 for the count level so CC_1
+     *    is otherwise unused and we can borrow it for this.
+     *
+     *    If you set the timer up with a prescaler of 0 and a 32 bit bit mode
+     *    (and no interrupts) then this counts every single one of the 16MHz CPU
+     *    clock cycles. This makes a very handy stopwatch for measuring how long
+     *    a piece of code takes to run. See the 08_Benchmark example.
+     *
+     * returns
+     *        returns the current count value
+     * */
+    unsigned int YakIO_TIMER::GetCount(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        // copy the counter into CC_1
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_CAPTURE_1) = 1;
+        // and read it back out
+        return YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_CC_1);
+    }
+
     /* ClearCompareEvent() - We call this in the interrupt handler to clear it
      *      if we do not we can never receive another
      * */
@@ -546,7 +582,64 @@ YakIO_TIMER *timer_ptr2 = NULL;
         if(isInitialized==0) return;
 
         // get the value from the appropriate register
-        (*(unsigned volatile *) (timerRegisterAddress+TIMERREG_OFFSET_COMPARE_0)) = 0;
+        YAKIO_REGISTER(timerRegisterAddress+TIMERREG_OFFSET_COMPARE_0) = 0;
+    }
+
+    /* HandleTimerIRQ - does the work for the IRQ_TIMER?_handler of this
+     *     timer. Calls the callback and clears the compare event. You 
+     *     should never need to call this yourself.
+     *
+     * inputs:
+     *    exceptionFramePtr - the exception frame of the interrupted code.
+     *       See GetInterruptedPC(). Can be NULL
+     * */
+    void YakIO_TIMER::HandleTimerIRQ(unsigned int *exceptionFramePtr)
+    {
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_IRQ_ENTRY, IRQ_TIMER0+timerID);
+
+        // keep this for the duration of the callback
+        interruptedFramePtr = exceptionFramePtr;
+        // call the callback
+        CallCallback();
+        // reset the timer, we MUST do this or we never get another
+        ClearCompareEvent();
+        // it is not valid any more
+        interruptedFramePtr = NULL;
+
+        YAKIO_TRACE_EVENT(TRACE_IRQ_EXIT, IRQ_TIMER0+timerID);
+    }
+
+    /* GetInterruptedPC - gets the address of the instruction the CPU was
+     *     about to execute when this timer interrupted it. This is read out
+     *     of the exception frame the CPU pushed onto the interrupted stack.
+     *     See YakIO_PROFILER for a use of this.
+     *
+     *   NOTE: this only means anything when called from inside the 
+     *     callback. Anywhere else it returns 0.
+     *
+     * returns:
+     *    the interrupted PC or 0 if we are not in this timers callback
+     * */
+    unsigned int YakIO_TIMER::GetInterruptedPC(void)
+    {
+        if(interruptedFramePtr==NULL) return 0;
+        return interruptedFramePtr[TIMER_EXCEPTION_FRAME_PC_INDEX];
+    }
+
+    /* TimerIRQDispatch - the IRQ_TIMER?_handlers below all come here 
+     *     with the timer object they are for. It is extern "C" so the 
+     *     assembler in the handlers can call it by name
+     *
+     * inputs:
+     *    exceptionFramePtr - the exception frame of the interrupted code
+     *    timerPtr - the timer object, one of the timer_ptr? values
+     * */
+    extern "C" __attribute__ ((used)) void TimerIRQDispatch(unsigned int *exceptionFramePtr, YakIO_TIMER *timerPtr)
+    {
+        if(timerPtr==NULL) return;
+        // we have a pointer, handle it
+        timerPtr->HandleTimerIRQ(exceptionFramePtr);
     }
 
     /* IRQ_TIMER?_handlers
@@ -560,28 +653,61 @@ YakIO_TIMER *timer_ptr2 = NULL;
      *       The name really matters here. See the discussion in YakIO.cpp
      *
      *   Do NOT define these anywhere else. This class needs them here.
+     *
+     * These are "naked" - the compiler adds no code of its own (see the
+     * PENDSVC_handler() in YakIO_KERNEL.cpp). Before anything else is 
+     * pushed we work out where the CPU put the exception frame. Bit 2 of
+     * the EXC_RETURN value in LR tells us if the interrupted code was using
+     * the main stack (MSP) or, if it was a YakIO_KERNEL thread, the process
+     * stack (PSP). The frame is at the top of that stack. Then we call 
+     * TimerIRQDispatch() and the POP of the saved LR (EXC_RETURN) into the
+     * PC makes the CPU return from the interrupt. This costs about 12 
+     * cycles more than an ordinary handler.
+     *
+     * When compiled for the host (YAKIO_HOST) there is no exception frame
+     * so these are ordinary functions and GetInterruptedPC() returns 0.
      * */
+#ifndef YAKIO_HOST
+    #define TIMER_IRQ_HANDLER_ASM(timerPtrName) \
+        asm volatile ( \
+            "    movs  r0, #4                   \n" /* 1  the "was it the PSP" bit of EXC_RETURN */ \
+            "    mov   r1, lr                   \n" /* 1 */ \
+            "    tst   r0, r1                   \n" /* 1 */ \
+            "    mrs   r0, msp                  \n" /* 3  MRS does not change the flags */ \
+            "    beq   1f                       \n" /* 1 or 3 */ \
+            "    mrs   r0, psp                  \n" /* 3 */ \
+            "1:                                 \n" \
+            "    ldr   r1, =" timerPtrName "    \n" /* 2 */ \
+            "    ldr   r1, [r1]                 \n" /* 2  r1 = timer_ptr? */ \
+            "    push  {lr}                     \n" /* 2  EXC_RETURN */ \
+            "    bl    TimerIRQDispatch         \n" /* 4 */ \
+            "    pop   {pc}                     \n" /* 4  return from the interrupt */ \
+            "    .ltorg                         \n" /*    the constant for the ldr r1,= goes here */ \
+        )
+
+    __attribute__ ((naked)) void IRQ_TIMER0_handler(void)
+    {
+        TIMER_IRQ_HANDLER_ASM("timer_ptr0");
+    }
+    __attribute__ ((naked)) void IRQ_TIMER1_handler(void)
+    {
+        TIMER_IRQ_HANDLER_ASM("timer_ptr1");
+    }
+    __attribute__ ((naked)) void IRQ_TIMER2_handler(void)
+    {
+        TIMER_IRQ_HANDLER_ASM("timer_ptr2");
+    }
+#else
     void IRQ_TIMER0_handler(void)
     {
-        if(timer_ptr0==NULL) return;
-        // we have a pointer, call the callback
-        timer_ptr0->CallCallback();
-        // reset the timer, we MUST do this or we never get another
-        timer_ptr0->ClearCompareEvent();
+        TimerIRQDispatch(NULL, timer_ptr0);
     }
     void IRQ_TIMER1_handler(void)
     {
-        if(timer_ptr1==NULL) return;
-        // we have a pointer, call the callback
-        timer_ptr1->CallCallback();
-        // reset the timer, we MUST do this or we never get another
-        timer_ptr1->ClearCompareEvent();
+        TimerIRQDispatch(NULL, timer_ptr1);
     }
     void IRQ_TIMER2_handler(void)
     {
-        if(timer_ptr2==NULL) return;
-        // we have a pointer, call the callback
-        timer_ptr2->CallCallback();
-        // reset the timer, we MUST do this or we never get another
-        timer_ptr2->ClearCompareEvent();
+        TimerIRQDispatch(NULL, timer_ptr2);
     }
+#endif
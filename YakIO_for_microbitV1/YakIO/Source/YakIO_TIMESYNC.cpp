@@ -0,0 +1,442 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_TIMESYNC.h"
+#include "YakIO_TRACE.h"
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_TIMESYNC - Constructor. Nothing happens until Start() is called
+     *
+     * inputs:
+     *    radioObjPtrIn - the RADIO the beacons go out and come in on
+     * */
+    YakIO_TIMESYNC::YakIO_TIMESYNC(YakIO_RADIO *radioObjPtrIn) : timeBaseObj(Timer0)
+    {
+        radioObjPtr = radioObjPtrIn;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* SetCallback - sets the callback object and function within that object.
+     *     It is called from the TIMER0 interrupt when the alarm goes off. 
+     *     The callback object must inherit from YakIO_CALLBACK
+     *
+     * inputs:
+     *    callbackIDIn - the callback id to use. Essentially this identifies the function name within the
+     *       callback interface object
+     *    callbackInterfacePtrIn - the "this" pointer of the object to receive
+     *       the callback
+     * */
+    void YakIO_TIMESYNC::SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        callbackInterfacePtr = callbackInterfacePtrIn;
+        callbackID = callbackIDIn;
+    }
+
+    /* CallCallback - calls the callback function set on this object
+     * */
+    void YakIO_TIMESYNC::CallCallback()
+    {
+        if(isInitialized==0) return;
+        // we have to have this
+        if(callbackInterfacePtr==NULL) return;
+
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
+        // figure out what callback function to call and call it
+        if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
+        else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
+    }
+
+    /* ClearAllCallbacks - clear all callbacks
+     * */
+    void YakIO_TIMESYNC::ClearAllCallbacks(void)
+    {
+        callbackInterfacePtr=NULL;
+        callbackID=CALLBACK_NONE;
+    }
+
+    /* Start - starts TIMER0 from zero and the hardware timestamping of
+     *     every packet. A follower forgets anything it knew about the 
+     *     reference
+     *
+     * inputs:
+     *    syncRoleIn - the reference or a follower. See the note on TIME 
+     *       SYNC in YakIO_TIMESYNC.h
+     * */
+    void YakIO_TIMESYNC::Start(enum TIMESYNC_ROLE syncRoleIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(radioObjPtr==NULL) return;
+
+        timeBaseObj.TimerStop();
+        ClearAlarm();
+        timeBaseObj.SetMode(TIMER_MODE_Timer);
+        timeBaseObj.SetBitMode(TIMER_BITMODE_32Bit);
+        timeBaseObj.SetPrescaler(TIMESYNC_TIMER_PRESCALER);
+        timeBaseObj.TimerClear();
+        timeBaseObj.SetCallback(CALLBACK_0, this);
+        timeBaseObj.EnableTimerIRQ();
+        timeBaseObj.TimerStart();
+
+        // every ADDRESS, sent or received, captures TIMER0 into CC[1]
+        radioObjPtr->SetTimestampRegister(REGISTER_TIMER0+TIMESYNC_CC_ADDRESS);
+        ppiObj.EnableChannel(PPI_CH_RADIO_ADDRESS_TIMER0_CAPTURE1);
+
+        beaconSequence = 0;
+        beaconIsSent = 0;
+        lastRxIsValid = 0;
+        sampleCount = 0;
+        skewValue = 0;
+        lastSyncError = 0;
+        beaconCount = 0;
+        syncRole = syncRoleIn;
+    }
+
+    /* Stop - stops the timestamping and TIMER0. GetNetworkTime() means 
+     *     nothing after this
+     * */
+    void YakIO_TIMESYNC::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+        if(radioObjPtr==NULL) return;
+
+        ppiObj.DisableChannel(PPI_CH_RADIO_ADDRESS_TIMER0_CAPTURE1);
+        radioObjPtr->SetTimestampRegister(0);
+        ClearAlarm();
+        timeBaseObj.TimerStop();
+        syncRole = TIMESYNC_ROLE_NONE;
+    }
+
+    /* SendBeacon - sends a beacon with the time the last one went out. 
+     *     Only the reference does this. Call it every second or so
+     *
+     * returns:
+     *    nz if it was sent, z if we are not the reference or the RADIO is
+     *    still sending something else
+     * */
+    unsigned int YakIO_TIMESYNC::SendBeacon(void)
+    {
+        return SendBeacon(NULL, 0);
+    }
+
+    /* SendBeacon - sends a beacon, as above, with some more bytes after it
+     *
+     * inputs:
+     *    extraBytes - the bytes to go after the beacon. They are copied
+     *    extraLength - the number of them. No more than 
+     *       RADIO_MAX_PAYLOAD_BYTES-TIMESYNC_BEACON_BYTES
+     * returns:
+     *    nz if it was sent, z if we are not the reference, the RADIO is
+     *    still sending something else or there are too many extra bytes
+     * */
+    unsigned int YakIO_TIMESYNC::SendBeacon(const unsigned char *extraBytes, unsigned int extraLength)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(syncRole!=TIMESYNC_ROLE_REFERENCE) return 0;
+        if(radioObjPtr->IsTransmitting()!=0) return 0;
+        if(extraLength>(RADIO_MAX_PAYLOAD_BYTES-TIMESYNC_BEACON_BYTES)) return 0;
+        if((extraBytes==NULL) && (extraLength!=0)) return 0;
+
+        // the last packet to go is only our last beacon if nothing else 
+        // has been sent since
+        unsigned int flagsByte = 0;
+        unsigned int lastTxTime = radioObjPtr->GetTxTimestamp();
+        if((beaconIsSent!=0) && (radioObjPtr->GetTxPacketCount()==beaconTxCount)) flagsByte = TIMESYNC_FLAG_TIME_VALID;
+
+        unsigned char beaconBytes[RADIO_MAX_PAYLOAD_BYTES];
+        beaconBytes[TIMESYNC_BEACON_OFFSET_TAG] = TIMESYNC_BEACON_TAG;
+        beaconBytes[TIMESYNC_BEACON_OFFSET_SEQUENCE] = beaconSequence;
+        beaconBytes[TIMESYNC_BEACON_OFFSET_FLAGS] = flagsByte;
+        for(int i=0; i<4; i++) beaconBytes[TIMESYNC_BEACON_OFFSET_TIME+i] = (lastTxTime>>(8*i)) & 0xFF;
+        for(unsigned int i=0; i<extraLength; i++) beaconBytes[TIMESYNC_BEACON_BYTES+i] = extraBytes[i];
+
+        if(radioObjPtr->Transmit(beaconBytes, TIMESYNC_BEACON_BYTES+extraLength)==0) return 0;
+        beaconTxCount = radioObjPtr->GetTxPacketCount() + 1;
+        beaconIsSent = 1;
+        beaconSequence = (beaconSequence + 1) & 0xFF;
+        beaconCount = beaconCount + 1;
+        return 1;
+    }
+
+    /* ProcessPacket - looks at a received packet and, if it is a beacon
+     *     and we are a follower, learns from it. Call it with every packet 
+     *     between GetReceivedPacket() and ReleasePacket() - it needs the 
+     *     timestamp the RADIO kept with the packet
+     *
+     * inputs:
+     *    packetPtr - the packet GetReceivedPacket() returned
+     * returns:
+     *    nz if it was a beacon, z if it is something else for the program
+     * */
+    unsigned int YakIO_TIMESYNC::ProcessPacket(struct YakIO_RADIOPACKET *packetPtr)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+        if(packetPtr==NULL) return 0;
+        if(packetPtr->lengthByte<TIMESYNC_BEACON_BYTES) return 0;
+        if(packetPtr->payloadBytes[TIMESYNC_BEACON_OFFSET_TAG]!=TIMESYNC_BEACON_TAG) return 0;
+        if(syncRole!=TIMESYNC_ROLE_FOLLOWER) return 1;
+
+        unsigned int localTime = radioObjPtr->GetPacketTimestamp() - TIMESYNC_RX_DELAY_TICKS;
+        unsigned int rxSequence = packetPtr->payloadBytes[TIMESYNC_BEACON_OFFSET_SEQUENCE];
+        unsigned int referenceTime = 0;
+        for(int i=0; i<4; i++) referenceTime = referenceTime | (packetPtr->payloadBytes[TIMESYNC_BEACON_OFFSET_TIME+i]<<(8*i));
+
+        // the time in this one is for the last one. Did we hear that?
+        if(((packetPtr->payloadBytes[TIMESYNC_BEACON_OFFSET_FLAGS] & TIMESYNC_FLAG_TIME_VALID)!=0) && 
+           (lastRxIsValid!=0) && (((lastRxSequence + 1) & 0xFF)==rxSequence))
+        {
+            AddSample(lastRxLocalTime, referenceTime);
+        }
+        lastRxSequence = rxSequence;
+        lastRxLocalTime = localTime;
+        lastRxIsValid = 1;
+        beaconCount = beaconCount + 1;
+        return 1;
+    }
+
+    /* IsSynchronized - tests if GetNetworkTime() can be believed. The 
+     *     reference always is, a follower needs two pairs (three beacons) 
+     *     before it knows the skew
+     *
+     * returns:
+     *    nz if it is, z if not
+     * */
+    unsigned int YakIO_TIMESYNC::IsSynchronized(void)
+    {
+        if(syncRole==TIMESYNC_ROLE_REFERENCE) return 1;
+        if(syncRole==TIMESYNC_ROLE_FOLLOWER) return (sampleCount>=2);
+        return 0;
+    }
+
+    /* GetRole - gets which end of the synchronization we are
+     *
+     * returns:
+     *    the role, TIMESYNC_ROLE_NONE if not started
+     * */
+    enum TIMESYNC_ROLE YakIO_TIMESYNC::GetRole(void)
+    {
+        return syncRole;
+    }
+
+    /* GetLocalTime - gets our own TIMER0 count
+     *
+     * returns:
+     *    the count in microseconds since Start()
+     * */
+    unsigned int YakIO_TIMESYNC::GetLocalTime(void)
+    {
+        // CC[1] is not ours to use, see the defines in YakIO_TIMESYNC.h
+        YAKIO_REGISTER(REGISTER_TIMER0+TIMESYNC_CAPTURE_TASK_NOW) = 1;
+        return YAKIO_REGISTER(REGISTER_TIMER0+TIMESYNC_CC_NOW);
+    }
+
+    /* GetNetworkTime - gets the network time, which is the reference's 
+     *     TIMER0 count
+     *
+     * returns:
+     *    the time in microseconds
+     * */
+    unsigned int YakIO_TIMESYNC::GetNetworkTime(void)
+    {
+        return LocalToNetworkTime(GetLocalTime());
+    }
+
+    /* LocalToNetworkTime - turns one of our TIMER0 counts into network 
+     *     time. Handy for a RADIO timestamp
+     *
+     * inputs:
+     *    localTime - our TIMER0 count. Should be within half a wrap 
+     *       (35 minutes) of the last beacon
+     * returns:
+     *    the network time
+     * */
+    unsigned int YakIO_TIMESYNC::LocalToNetworkTime(unsigned int localTime)
+    {
+        if(syncRole==TIMESYNC_ROLE_REFERENCE) return localTime;
+        if(sampleCount==0) return localTime;
+
+        int elapsedTicks = (int)(localTime - anchorLocalTime);
+        int skewTicks = (int)(((long long)elapsedTicks * skewValue)>>TIMESYNC_SKEW_SHIFT);
+        return anchorNetworkTime + elapsedTicks + skewTicks;
+    }
+
+    /* NetworkToLocalTime - turns a network time into the TIMER0 count we
+     *     will have then. Handy for setting a TIMER0 CC[n] to do something
+     *     at a network time
+     *
+     * inputs:
+     *    networkTime - the network time. Should be within half a wrap 
+     *       (35 minutes) of the last beacon
+     * returns:
+     *    our TIMER0 count
+     * */
+    unsigned int YakIO_TIMESYNC::NetworkToLocalTime(unsigned int networkTime)
+    {
+        if(syncRole==TIMESYNC_ROLE_REFERENCE) return networkTime;
+        if(sampleCount==0) return networkTime;
+
+        // the skew is tiny, scaling by it on this side is close enough
+        int elapsedTicks = (int)(networkTime - anchorNetworkTime);
+        int skewTicks = (int)(((long long)elapsedTicks * skewValue)>>TIMESYNC_SKEW_SHIFT);
+        return anchorLocalTime + elapsedTicks - skewTicks;
+    }
+
+    /* GetSkewPpb - gets how much faster the reference runs than we do
+     *
+     * returns:
+     *    the skew in parts per billion, negative if the reference is slower
+     * */
+    int YakIO_TIMESYNC::GetSkewPpb(void)
+    {
+        return (int)(((long long)skewValue * 1000000000)>>TIMESYNC_SKEW_SHIFT);
+    }
+
+    /* GetLastSyncError - gets how far out GetNetworkTime() was when the 
+     *     latest pair arrived, just before it was corrected. This is how 
+     *     well we are keeping up
+     *
+     * returns:
+     *    the error in microseconds, positive if we were behind
+     * */
+    int YakIO_TIMESYNC::GetLastSyncError(void)
+    {
+        return lastSyncError;
+    }
+
+    /* GetBeaconCount - gets the number of beacons sent, or heard, since 
+     *     Start()
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TIMESYNC::GetBeaconCount(void)
+    {
+        return beaconCount;
+    }
+
+    /* SetAlarm - sets the alarm. The callback is called from the TIMER0 
+     *     interrupt when TIMER0 gets to localTime. Any alarm already set is
+     *     replaced. The COMPARE[0] event happens at the same moment so the
+     *     PPI can start something exactly on time as well
+     *
+     * inputs:
+     *    localTime - the TIMER0 count. At least TIMESYNC_MIN_ALARM_TICKS 
+     *       and less than half a wrap (35 minutes) from now
+     * returns:
+     *    nz if it is set, z if it is too soon or already gone
+     * */
+    unsigned int YakIO_TIMESYNC::SetAlarm(unsigned int localTime)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        // nothing must hold us up between looking at the time and setting
+        // the CC[0], or the count could go past it
+        unsigned int primaskState = EnterCritical();
+        int ticksToGo = (int)(localTime - GetLocalTime());
+        if(ticksToGo<TIMESYNC_MIN_ALARM_TICKS)
+        {
+            ExitCritical(primaskState);
+            return 0;
+        }
+        timeBaseObj.SetCountLevel(localTime);
+        timeBaseObj.ClearCompareEvent();
+        timeBaseObj.SetINTEN();
+        ExitCritical(primaskState);
+        return 1;
+    }
+
+    /* ClearAlarm - clears the alarm, if it is set, so it does not go off
+     * */
+    void YakIO_TIMESYNC::ClearAlarm(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        timeBaseObj.ClearINTEN();
+        timeBaseObj.ClearCompareEvent();
+    }
+
+    /* Callback0 - the TIMER0 COMPARE[0] interrupt. The alarm has gone off.
+     *     It only goes off once so the interrupt is turned off before the 
+     *     callback, which is free to set another
+     * */
+    void YakIO_TIMESYNC::Callback0(void)
+    {
+        timeBaseObj.ClearINTEN();
+        CallCallback();
+    }
+
+// #
+// # Private
+// #
+
+    /* AddSample - learns from a pair of times for the same instant, our 
+     *     own and the reference's
+     *
+     * inputs:
+     *    localTime - our TIMER0 count
+     *    networkTime - the reference's TIMER0 count
+     * */
+    void YakIO_TIMESYNC::AddSample(unsigned int localTime, unsigned int networkTime)
+    {
+        if(sampleCount>0)
+        {
+            lastSyncError = (int)(networkTime - LocalToNetworkTime(localTime));
+
+            // the reference gained this many ticks on us since the last pair
+            unsigned int localTicks = localTime - anchorLocalTime;
+            int gainedTicks = (int)((networkTime - anchorNetworkTime) - localTicks);
+            if((localTicks>=TIMESYNC_MIN_SAMPLE_TICKS) && (localTicks<0x80000000))
+            {
+                int newSkew = (int)(((long long)gainedTicks<<TIMESYNC_SKEW_SHIFT) / (long long)localTicks);
+                if((newSkew>TIMESYNC_MAX_SKEW) || (newSkew<-TIMESYNC_MAX_SKEW))
+                {
+                    // the reference restarted, or something is badly wrong
+                    sampleCount = 0;
+                    skewValue = 0;
+                }
+                else if(sampleCount==1) skewValue = newSkew;
+                else skewValue = skewValue + ((newSkew - skewValue)>>TIMESYNC_SKEW_FILTER_SHIFT);
+            }
+        }
+        anchorLocalTime = localTime;
+        anchorNetworkTime = networkTime;
+        sampleCount = sampleCount + 1;
+    }
@@ -0,0 +1,238 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_TRACE.h"
+
+// the running trace. The YAKIO_TRACE_EVENT() hooks in the library use
+// this to find it. See the note on the TRACE in YakIO_TRACE.h
+YakIO_TRACE *trace_ptr = NULL;
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_TRACE - Constructor
+     *
+     * inputs:
+     *    timeStampTimerIDIn - the timer to use for the timestamps. It is 
+     *       set up as a free running 16MHz counter when Start() is called.
+     *       Nothing else may use it
+     * */
+    YakIO_TRACE::YakIO_TRACE(enum TIMER timeStampTimerIDIn) : timeStampTimerObj(timeStampTimerIDIn)
+    {
+        // the Record() function needs to get at the registers directly
+        if(timeStampTimerIDIn==Timer1) timeStampRegisterAddress = REGISTER_TIMER1;
+        else if(timeStampTimerIDIn==Timer2) timeStampRegisterAddress = REGISTER_TIMER2;
+        else timeStampRegisterAddress = REGISTER_TIMER0;
+
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - starts the timestamp timer and makes this the trace the 
+     *    library records to. Anything already in the buffer is kept
+     * */
+    void YakIO_TRACE::Start(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        // a free running 32 bit counter at the full 16MHz. See the 
+        // 08_Benchmark example. It wraps about every 268 seconds
+        timeStampTimerObj.TimerStop();
+        timeStampTimerObj.SetMode(TIMER_MODE_Timer);
+        timeStampTimerObj.SetBitMode(TIMER_BITMODE_32Bit);
+        timeStampTimerObj.SetPrescaler(0);
+        timeStampTimerObj.TimerClear();
+        timeStampTimerObj.TimerStart();
+
+        trace_ptr = this;
+        Record(TRACE_START, 0);
+    }
+
+    /* Stop - stops recording. The library hooks and the Mark() functions 
+     *    do nothing until Start() is called again. Drain() still works
+     * */
+    void YakIO_TRACE::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        if(trace_ptr==this) trace_ptr = NULL;
+        timeStampTimerObj.TimerStop();
+    }
+
+    /* Clear - throws away everything in the buffer, sent or not
+     * */
+    void YakIO_TRACE::Clear(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        unsigned int primaskState = EnterCritical();
+        writeCount = 0;
+        drainCount = 0;
+        lostCount = 0;
+        ExitCritical(primaskState);
+    }
+
+    /* Mark - records a single point in time with an argument
+     *
+     * inputs:
+     *    userEventID - your event ID. Must be TRACE_USER_FIRST_ID or more
+     *    eventArg - anything you like, only the bottom 16 bits are kept
+     * */
+    void YakIO_TRACE::Mark(unsigned int userEventID, unsigned int eventArg)
+    {
+        // only when we are the running trace
+        if(trace_ptr!=this) return;
+        if(userEventID<TRACE_USER_FIRST_ID) return;
+
+        Record(userEventID, eventArg);
+    }
+
+    /* MarkBegin - records the start of something. The trace viewer shows 
+     *    it as a bar from here to the matching MarkEnd()
+     *
+     * inputs:
+     *    userEventID - your event ID. Must be TRACE_USER_FIRST_ID or more
+     * */
+    void YakIO_TRACE::MarkBegin(unsigned int userEventID)
+    {
+        // only when we are the running trace
+        if(trace_ptr!=this) return;
+        if(userEventID<TRACE_USER_FIRST_ID) return;
+
+        Record(TRACE_USER_BEGIN, userEventID);
+    }
+
+    /* MarkEnd - records the end of something started with MarkBegin()
+     *
+     * inputs:
+     *    userEventID - the same event ID given to MarkBegin()
+     * */
+    void YakIO_TRACE::MarkEnd(unsigned int userEventID)
+    {
+        // only when we are the running trace
+        if(trace_ptr!=this) return;
+        if(userEventID<TRACE_USER_FIRST_ID) return;
+
+        Record(TRACE_USER_END, userEventID);
+    }
+
+    /* Drain - sends the entries not yet sent out of the serial port, oldest
+     *    first. See the note on the TRACE in YakIO_TRACE.h for the format.
+     *    If some of them were overwritten before we got to them a 
+     *    TRACE_LOST entry is sent in their place. 
+     *
+     *    This can be called while the trace is running. Entries recorded
+     *    while we are sending are sent too, up to maxEntries.
+     *
+     *   NOTE: each entry takes about 0.8 milliseconds to send at 115200
+     *    baud. Do NOT call this from an interrupt handler.
+     *
+     * inputs:
+     *    uart - a started YakIO_UART to send on
+     *    maxEntries - the most entries to send. 0 means keep going until 
+     *       there are none left
+     * returns:
+     *    the number of entries sent
+     * */
+    unsigned int YakIO_TRACE::Drain(YakIO_UART &uart, unsigned int maxEntries)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        unsigned int sentCount = 0;
+        while((maxEntries==0) || (sentCount<maxEntries))
+        {
+            // copy the entry out with the interrupts off so it cannot be 
+            // overwritten half way through. Then send it with them on
+            unsigned int primaskState = EnterCritical();
+            if(drainCount==writeCount)
+            {
+                ExitCritical(primaskState);
+                break;
+            }
+            unsigned int lostEntries = 0;
+            if((writeCount-drainCount)>TRACE_BUFFER_ENTRIES)
+            {
+                // the writer has lapped us. Skip to the oldest one still there
+                lostEntries = (writeCount-drainCount)-TRACE_BUFFER_ENTRIES;
+                drainCount = writeCount-TRACE_BUFFER_ENTRIES;
+            }
+            YakIO_TRACEENTRY entryCopy = traceEntries[drainCount & TRACE_BUFFER_MASK];
+            drainCount = drainCount + 1;
+            ExitCritical(primaskState);
+
+            if(lostEntries!=0)
+            {
+                lostCount = lostCount + lostEntries;
+                if(lostEntries>0xFFFF) lostEntries = 0xFFFF;
+                // it goes just before the oldest one we still have
+                SendEntry(uart, entryCopy.timeStamp, (lostEntries<<16) | TRACE_LOST);
+            }
+            SendEntry(uart, entryCopy.timeStamp, entryCopy.eventIDAndArg);
+            sentCount = sentCount + 1;
+        }
+        return sentCount;
+    }
+
+    /* GetWriteCount - gets the number of entries recorded since the last
+     *    Clear(). Only the last TRACE_BUFFER_ENTRIES are still in the buffer
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TRACE::GetWriteCount(void)
+    {
+        return writeCount;
+    }
+
+    /* GetLostCount - gets the number of entries which were overwritten 
+     *    before Drain() could send them
+     *
+     * returns:
+     *    the count
+     * */
+    unsigned int YakIO_TRACE::GetLostCount(void)
+    {
+        return lostCount;
+    }
+
+// #
+// # Private
+// #
+
+    /* SendEntry - sends one entry out of the serial port
+     *
+     * inputs:
+     *    uart - a started YakIO_UART to send on
+     *    timeStamp - the entry timestamp
+     *    eventIDAndArg - the entry ID and argument
+     * */
+    void YakIO_TRACE::SendEntry(YakIO_UART &uart, unsigned int timeStamp, unsigned int eventIDAndArg)
+    {
+        uart.WriteByte(TRACE_SYNC_BYTE);
+        for(int i=0; i<32; i=i+8) uart.WriteByte((unsigned char)(timeStamp>>i));
+        for(int i=0; i<32; i=i+8) uart.WriteByte((unsigned char)(eventIDAndArg>>i));
+    }
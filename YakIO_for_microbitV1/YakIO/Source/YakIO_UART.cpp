@@ -0,0 +1,284 @@
+/// +------------------------------------------------------------------------------------------------------------------------------+
+/// ¦                                                   TERMS OF USE: MIT License                                                  ¦
+/// +------------------------------------------------------------------------------------------------------------------------------¦
+/// ¦Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation    ¦
+/// ¦files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,    ¦
+/// ¦modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software¦
+/// ¦is furnished to do so, subject to the following conditions:                                                                   ¦
+/// ¦                                                                                                                              ¦
+/// ¦The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.¦
+/// ¦                                                                                                                              ¦
+/// ¦THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE          ¦
+/// ¦WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR         ¦
+/// ¦COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,   ¦
+/// ¦ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                         ¦
+/// +------------------------------------------------------------------------------------------------------------------------------+
+
+#include "YakIO.h"
+#include "YakIO_UART.h"
+#include "YakIO_GPIO.h"
+#include "YakIO_TRACE.h"
+
+// the IRQ_UART0_handler is a non-member function. The pointer below is 
+// set in the constructor so it can find the UART object. See the 
+// discussion of the IRQ_RNG_handler in YakIO_RNG.cpp
+YakIO_UART *uart_ptr = NULL;
+
+// the powers of ten WriteUnsigned() subtracts. See the note in YakIO_UART.h
+static const unsigned int powersOfTen[10] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+
+// #
+// # Constructor
+// #
+
+    /* YakIO_UART - Constructor
+     * */
+    YakIO_UART::YakIO_UART()
+    {
+        // set this so we know we have run through the constructor. Creating objects on the heap
+        // will NOT run the constructor
+        isInitialized =1;
+
+        // remember our 'this' pointer
+        uart_ptr = this;
+    }
+
+// #
+// # Public
+// #
+
+    /* Start - connects the UART to the microbit TX and RX pins and starts 
+     *    the transmitter and receiver
+     *
+     * inputs:
+     *    baudRate - the baud rate, 8N1 is always used
+     * */
+    void YakIO_UART::Start(enum UART_BAUDRATE baudRate)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        // the TX pin is an output which idles high, the RX pin is an input
+        // with its input buffer connected. See the GPIO registers in YakIO_GPIO.h
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_OUTSET) = (0x01<<UART_MICROBIT_TX_GPIO);
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_DIRSET) = (0x01<<UART_MICROBIT_TX_GPIO);
+        YAKIO_REGISTER(REGISTER_GPIO+GPIOREG_OFFSET_PIN_CNF_BASE+(UART_MICROBIT_RX_GPIO*BYTES_IN_REGISTER)) = PinInputBufferEna;
+
+        // no flow control, so no RTS or CTS
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_PSELRTS) = UART_PSEL_DISCONNECTED;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_PSELCTS) = UART_PSEL_DISCONNECTED;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_PSELTXD) = UART_MICROBIT_TX_GPIO;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_PSELRXD) = UART_MICROBIT_RX_GPIO;
+        // no parity, no hardware flow control
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_CONFIG) = 0;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_BAUDRATE) = baudRate;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_ENABLE) = UART_ENABLE_VALUE;
+
+        // clear any old events and start both directions
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_TXDRDY) = 0;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_RXDRDY) = 0;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_STARTTX) = 1;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_STARTRX) = 1;
+        isStarted = 1;
+    }
+
+    /* Stop - stops the transmitter and receiver and disables the UART
+     * */
+    void YakIO_UART::Stop(void)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        ClearAllCallbacks();
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_STOPTX) = 1;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_STOPRX) = 1;
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_ENABLE) = 0;
+        isStarted = 0;
+    }
+
+    /* WriteByte - sends one byte and waits until it has gone
+     *
+     * inputs:
+     *    byteValue - the byte to send
+     * */
+    void YakIO_UART::WriteByte(unsigned char byteValue)
+    {
+        // we must be initialized and started or we would wait forever
+        if(isInitialized==0) return;
+        if(isStarted==0) return;
+
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_TXD) = byteValue;
+        // TXDRDY is set when the byte has been sent
+        while(YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_TXDRDY)==0) {}
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_TXDRDY) = 0;
+    }
+
+    /* WriteString - sends a zero terminated string
+     *
+     * inputs:
+     *    stringPtr - the string to send
+     * */
+    void YakIO_UART::WriteString(const char *stringPtr)
+    {
+        if(stringPtr==NULL) return;
+        while(*stringPtr!=0)
+        {
+            WriteByte((unsigned char)*stringPtr);
+            stringPtr++;
+        }
+    }
+
+    /* WriteUnsigned - sends a number in decimal with no leading zeros
+     *
+     * inputs:
+     *    numberValue - the number to send
+     * */
+    void YakIO_UART::WriteUnsigned(unsigned int numberValue)
+    {
+        unsigned int haveStarted = 0;
+        for(int i=0; i<10; i++)
+        {
+            // count how many times this power of ten goes in
+            unsigned char digitValue = 0;
+            while(numberValue>=powersOfTen[i])
+            {
+                numberValue = numberValue - powersOfTen[i];
+                digitValue++;
+            }
+            // skip the leading zeros but always send the last digit
+            if((digitValue!=0) || (haveStarted!=0) || (i==9))
+            {
+                WriteByte('0'+digitValue);
+                haveStarted = 1;
+            }
+        }
+    }
+
+    /* WriteHex - sends a number as 8 hex digits with a leading 0x
+     *
+     * inputs:
+     *    numberValue - the number to send
+     * */
+    void YakIO_UART::WriteHex(unsigned int numberValue)
+    {
+        WriteString("0x");
+        for(int i=28; i>=0; i=i-4)
+        {
+            unsigned char nibbleValue = (numberValue>>i) & 0x0F;
+            if(nibbleValue<10) WriteByte('0'+nibbleValue);
+            else WriteByte('A'+(nibbleValue-10));
+        }
+    }
+
+    /* WriteNewLine - sends a carriage return and line feed. Most terminal
+     *    programs want both
+     * */
+    void YakIO_UART::WriteNewLine(void)
+    {
+        WriteByte('\r');
+        WriteByte('\n');
+    }
+
+    /* TryReadByte - gets a received byte if there is one. Never waits
+     *
+     * inputs:
+     *    byteValue - the byte is returned in here
+     * returns:
+     *    nz if a byte was received, z if not
+     * */
+    unsigned int YakIO_UART::TryReadByte(unsigned char &byteValue)
+    {
+        // we must be initialized
+        if(isInitialized==0) return 0;
+
+        if(YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_RXDRDY)==0) return 0;
+        // clear the event before reading RXD so we do not miss the next one
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_RXDRDY) = 0;
+        byteValue = (unsigned char)YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_RXD);
+        return 1;
+    }
+
+    /* SetCallback - sets the callback object and function within that object.
+     *     The callback object must inherit from YakIO_CALLBACK. It is called 
+     *     from the UART interrupt whenever a byte has been received and it
+     *     must take that byte with TryReadByte()
+     *
+     * inputs:
+     *    callbackIDIn - the callback id to use. Essentially this identifies the function name within the
+     *       callback interface object
+     *    callbackInterfacePtrIn - the "this" pointer of the object to receive
+     *       the callback
+     * */
+    void YakIO_UART::SetCallback(enum CALLBACK_ID callbackIDIn, YakIO_CALLBACK *callbackInterfacePtrIn)
+    {
+        // we must be initialized
+        if(isInitialized==0) return;
+
+        callbackInterfacePtr = callbackInterfacePtrIn;
+        callbackID = callbackIDIn;
+        // if a byte is already waiting the interrupt happens straight away
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_INTENSET) = UART_INTEN_RXDRDY_BIT;
+        EnableIRQ(IRQ_UART0);
+    }
+
+    /* CallCallback - calls the callback function set on this object
+     *
+     * */
+    void YakIO_UART::CallCallback()
+    {
+        if(isInitialized==0) return;
+        // we have to have this
+        if(callbackInterfacePtr==NULL) return;
+
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_ENTRY, callbackID);
+
+        // figure out what callback function to call and call it
+        if(callbackID == CALLBACK_0) callbackInterfacePtr->Callback0();
+        else if(callbackID == CALLBACK_1) callbackInterfacePtr->Callback1();
+        else if(callbackID == CALLBACK_2) callbackInterfacePtr->Callback2();
+        else if(callbackID == CALLBACK_3) callbackInterfacePtr->Callback3();
+
+        YAKIO_TRACE_EVENT(TRACE_CALLBACK_EXIT, callbackID);
+    }
+
+    /* ClearAllCallbacks - clear all callbacks and turn off the receive 
+     *    interrupt
+     *
+     * */
+    void YakIO_UART::ClearAllCallbacks(void)
+    {
+        YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_INTENCLR) = UART_INTEN_RXDRDY_BIT;
+        callbackInterfacePtr=NULL;
+        callbackID=CALLBACK_NONE;
+    }
+
+    /* HandleUartIRQ - does the work for the IRQ_UART0_handler. You should 
+     *     never call this yourself
+     * */
+    void YakIO_UART::HandleUartIRQ(void)
+    {
+        // nobody wants it. Turn the interrupt off or it would never stop
+        if(callbackInterfacePtr==NULL)
+        {
+            YAKIO_REGISTER(REGISTER_UART0+UARTREG_OFFSET_INTENCLR) = UART_INTEN_RXDRDY_BIT;
+            return;
+        }
+        CallCallback();
+    }
+
+    /* IRQ_UART0_handler
+     *
+     * Note: the address of this function is set in the flash by the linker.
+     *       See the discussion on the IRQ_RNG_handler in YakIO_RNG.cpp
+     *
+     *   Do NOT define this anywhere else. This class needs it here.
+     * */
+    void IRQ_UART0_handler(void)
+    {
+        if(uart_ptr==NULL) return;
+        // see the note on the TRACE in YakIO_TRACE.h
+        YAKIO_TRACE_EVENT(TRACE_IRQ_ENTRY, IRQ_UART0);
+        uart_ptr->HandleUartIRQ();
+        YAKIO_TRACE_EVENT(TRACE_IRQ_EXIT, IRQ_UART0);
+    }
@@ -16,6 +16,19 @@
 
 #include "YakIO_Utils.h"
 
+#ifndef YAKIO_HOST
+// set by the startup code in YakIO.cpp
+extern unsigned int bootCycles;
+// these come from the linker script (microbit.ld)
+extern unsigned char __stackLimit__[];
+extern unsigned char __startOfStack__[];
+#else
+// when compiled for the host (see YAKIO_HOST in YakIO.h) there is no 
+// startup code and no linker script so there is no boot time and no 
+// stack reserve to look at. The stack functions below report nothing
+unsigned int bootCycles = 0;
+#endif
+
 /* EnableIRQ - enables an IRQ in the NVIC
  * 
  * inputs:
@@ -26,7 +39,7 @@ void EnableIRQ(int irqNum)
     if(irqNum <0) return;
     if(irqNum>31) return;
     // the NVIC ISER is a set register so we can just set these bits directly
-    (*(unsigned volatile *) (REGISTER_NVIC+NVICREG_OFFSET_ISER)) = (0x01<<irqNum);            
+    YAKIO_REGISTER(REGISTER_NVIC+NVICREG_OFFSET_ISER) = (0x01<<irqNum);            
 }
 
 /* DisableIRQ - disables an IRQ in the NVIC
@@ -39,7 +52,7 @@ void DisableIRQ(int irqNum)
     if(irqNum <0) return;
     if(irqNum>31) return;
     // the NVIC ICER is a CLR register so we can just set these bits directly to clear them
-    (*(unsigned volatile *) (REGISTER_NVIC+NVICREG_OFFSET_ICER)) = (0x01<<irqNum);            
+    YAKIO_REGISTER(REGISTER_NVIC+NVICREG_OFFSET_ICER) = (0x01<<irqNum);            
 }
 
 /* ClearPendingIRQ - clears a pending IRQ in the NVIC
@@ -52,5 +65,101 @@ void ClearPendingIRQ(int irqNum)
     if(irqNum <0) return;
     if(irqNum>31) return;
     // the NVIC ICPR is a CLR register so we can just set these bits directly to clear the IRQ
-    (*(unsigned volatile *) (REGISTER_NVIC+NVICREG_OFFSET_ICPR)) = (0x01<<irqNum);            
+    YAKIO_REGISTER(REGISTER_NVIC+NVICREG_OFFSET_ICPR) = (0x01<<irqNum);            
+}
+
+/* SetIRQPriority - sets the priority of an IRQ in the NVIC. See the
+ *    note on PRIORITIES in YakIO_NVIC.h
+ * 
+ * inputs:
+ *         irqNum - the irq number to set, cannot be <0 or > 31
+ *         irqPriority - the priority
+ * */
+void SetIRQPriority(int irqNum, enum IRQ_PRIORITY irqPriority)
+{
+    if(irqNum <0) return;
+    if(irqNum>31) return;
+    // four IRQs to a register, one byte each
+    unsigned int registerAddress = REGISTER_NVIC+NVICREG_OFFSET_PRI0+((irqNum>>2)<<2);
+    unsigned int bitShift = ((irqNum&0x03)<<3)+NVIC_PRIORITY_BIT_SHIFT;
+
+    // the register has to be read, changed and written back a whole word 
+    // at a time so nothing else can be allowed to change it in the middle
+    unsigned int primaskState = EnterCritical();
+    unsigned int registerValue = YAKIO_REGISTER(registerAddress);
+    registerValue = registerValue & ~(NVIC_PRIORITY_MASK<<bitShift);
+    registerValue = registerValue | ((irqPriority&NVIC_PRIORITY_MASK)<<bitShift);
+    YAKIO_REGISTER(registerAddress) = registerValue;
+    ExitCritical(primaskState);
+}
+
+/* GetBootCycles - gets how long the startup code took to run. This is from
+ *    the first instruction of _StartYakIO() to just before CreateMainObject()
+ *    is called and includes setting up the .data and .bss sections and
+ *    running the constructors of any global objects. The time the chip 
+ *    itself takes to come out of reset is not included.
+ * 
+ * returns:
+ *    the time in 16MHz CPU cycles. Divide by 16 for microseconds
+ * */
+unsigned int GetBootCycles(void)
+{
+    return bootCycles;
+}
+
+/* GetStackHighWater - finds the most stack that has ever been used. The
+ *    startup code filled the stack reserve with STACK_PAINT_PATTERN so we 
+ *    look up from the stack limit for the first word that has changed. 
+ *    See the STACK notes in YakIO_Utils.h
+ * 
+ * returns:
+ *    the bytes of stack used. If this is GetStackReserveSize() then the 
+ *    whole reserve has been used and the stack has probably gone further
+ * */
+unsigned int GetStackHighWater(void)
+{
+#ifdef YAKIO_HOST
+    return 0;
+#else
+    unsigned int *wordPtr = (unsigned int *)__stackLimit__;
+    unsigned int *endPtr = (unsigned int *)__startOfStack__;
+    while((wordPtr<endPtr) && (*wordPtr==STACK_PAINT_PATTERN)) wordPtr++;
+    return (unsigned int)(__startOfStack__ - (unsigned char *)wordPtr);
+#endif
+}
+
+/* GetStackReserveSize - gets the bytes the linker script has held back
+ *    for the stack. See __stackReserveSize__ in microbit.ld
+ * 
+ * returns:
+ *    the size of the stack reserve in bytes
+ * */
+unsigned int GetStackReserveSize(void)
+{
+#ifdef YAKIO_HOST
+    return 0;
+#else
+    return (unsigned int)(__startOfStack__ - __stackLimit__);
+#endif
+}
+
+/* IsStackCanaryIntact - checks the STACK_CANARY_WORDS at the stack limit
+ *    still hold the STACK_PAINT_PATTERN. Quick enough to call from an 
+ *    interrupt handler.
+ * 
+ * returns:
+ *    nz if they do, z if the stack has reached the limit
+ * */
+unsigned int IsStackCanaryIntact(void)
+{
+#ifdef YAKIO_HOST
+    return 1;
+#else
+    unsigned int *wordPtr = (unsigned int *)__stackLimit__;
+    for(int i=0; i<STACK_CANARY_WORDS; i++)
+    {
+        if(wordPtr[i]!=STACK_PAINT_PATTERN) return 0;
+    }
+    return 1;
+#endif
 }